@@ -117,6 +117,26 @@ WSAPoll(
 #undef select
 #endif
 
+/*
+ * Where sendmmsg() and recvmmsg() are available, data packets are sent and
+ * received in batches of up to UDPIC_MMSG_BATCH_SIZE packets per system call.
+ *
+ * The fault injection test mode wraps sendto() and recvfrom() to drop and
+ * corrupt packets, so it keeps to one packet per system call.
+ */
+#if defined(MSG_WAITFORONE) && !defined(WIN32)
+#define USE_UDPIC_MMSG
+#define UDPIC_MMSG_BATCH_SIZE (32)
+#else
+#define UDPIC_MMSG_BATCH_SIZE (1)
+#endif
+
+#ifdef USE_ASSERT_CHECKING
+#define UDPIC_MMSG_ENABLED() (!udp_testmode)
+#else
+#define UDPIC_MMSG_ENABLED() (true)
+#endif
+
 #define MAX_TRY (11)
 int
 			timeoutArray[] =
@@ -327,10 +347,11 @@ struct RxBufferPool
 /*
  * The buffer pool used for keeping data packets.
  *
- * maxCount is set to 1 to make sure there is always a buffer
- * for picking packets from OS buffer.
+ * maxCount is set to UDPIC_MMSG_BATCH_SIZE to make sure there is always a
+ * batch of buffers for picking packets from OS buffer.  InitMotionUDPIFC()
+ * sets it again for every new interconnect.
  */
-static RxBufferPool rx_buffer_pool = {1, 0, NULL};
+static RxBufferPool rx_buffer_pool = {UDPIC_MMSG_BATCH_SIZE, 0, NULL};
 
 /*
  * SendBufferPool
@@ -621,6 +642,9 @@ typedef struct AckSendParam
  * duplicatedPktNum          - duplicate packet number.
  * recvAckNum                - the number of Acks received.
  * statusQueryMsgNum         - the number of status query messages sent.
+ * sndSyscallNum             - the number of system calls sending the packets counted by sndPktNum.
+ * recvSyscallNum            - the number of system calls returning packets to the receiver.
+ * recvSyscallPktNum         - the number of packets returned by those system calls.
  *
  */
 typedef struct ICStatistics
@@ -642,6 +666,9 @@ typedef struct ICStatistics
 	int32		duplicatedPktNum;
 	int32		recvAckNum;
 	int32		statusQueryMsgNum;
+	int32		sndSyscallNum;
+	int32		recvSyscallNum;
+	int32		recvSyscallPktNum;
 } ICStatistics;
 
 /* Statistics for UDP interconnect. */
@@ -1462,9 +1489,12 @@ InitMotionUDPIFC(int *listenerSocketFd, int32 *listenerPort)
 	rx_control_info.lastTornIcId = 0;
 	initCursorICHistoryTable(&rx_control_info.cursorHistoryTable);
 
-	/* Initialize receive buffer pool */
+	/*
+	 * Initialize receive buffer pool, the rx thread keeps up to a batch of
+	 * buffers to read packets into.
+	 */
 	rx_buffer_pool.count = 0;
-	rx_buffer_pool.maxCount = 1;
+	rx_buffer_pool.maxCount = UDPIC_MMSG_BATCH_SIZE;
 	rx_buffer_pool.freeList = NULL;
 
 	/* Initialize send control data */
@@ -3714,7 +3744,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 " freebuf_avg %f "
 		 "mismatch_pkt_num %d disordered_pkt_num %d duplicated_pkt_num %d"
 		 " rtt/dev [" UINT64_FORMAT "/" UINT64_FORMAT ", %f/%f, " UINT64_FORMAT "/" UINT64_FORMAT "] "
-		 " cwnd %f status_query_msg_num %d",
+		 " cwnd %f status_query_msg_num %d"
+		 " snd_pkts_per_syscall %f recv_pkts_per_syscall %f",
 		 ic_control_info.isSender, isReceiver,
 		 Gp_interconnect_snd_queue_depth, Gp_interconnect_queue_depth, Gp_max_packet_size,
 		 UNACK_QUEUE_RING_SLOTS_NUM, TIMER_SPAN, DEFAULT_RTT,
@@ -3727,7 +3758,11 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 (double) ((double) ic_statistics.totalBuffers) / ((double) ic_statistics.bufferCountingTime),
 		 ic_statistics.mismatchNum, ic_statistics.disorderedPktNum, ic_statistics.duplicatedPktNum,
 		 (minRtt == ~((uint64) 0) ? 0 : minRtt), (minDev == ~((uint64) 0) ? 0 : minDev), avgRtt, avgDev, maxRtt, maxDev,
-		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum);
+		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum,
+		 (ic_statistics.sndSyscallNum == 0 ? 0 :
+		  (double) ((double) ic_statistics.sndPktNum) / ((double) ic_statistics.sndSyscallNum)),
+		 (ic_statistics.recvSyscallNum == 0 ? 0 :
+		  (double) ((double) ic_statistics.recvSyscallPktNum) / ((double) ic_statistics.recvSyscallNum)));
 
 	ic_control_info.isSender = false;
 	memset(&ic_statistics, 0, sizeof(ICStatistics));
@@ -4843,6 +4878,62 @@ prepareXmit(MotionConn *mConn)
 	}
 }
 
+/*
+ * reportSendError
+ * 		Report a failure to transmit a packet.
+ *
+ * The packet stays in the unack queue, so it is retransmitted like a lost
+ * one. EINTR and EAGAIN must be handled by the caller.
+ */
+static void
+reportSendError(MotionConnUDP *conn, int save_errno, const char *syscall)
+{
+	errno = save_errno;
+
+	/*
+	 * If Linux iptables (nf_conntrack?) drops an outgoing packet, it may
+	 * return an EPERM to the application. This might be simply because of
+	 * traffic shaping or congestion, so ignore it.
+	 */
+	if (save_errno == EPERM)
+	{
+		ereport(LOG,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("Interconnect error writing an outgoing packet: %m"),
+				 errdetail("error during %s() for Remote Connection: contentId=%d at %s",
+						   syscall, conn->mConn.remoteContentId, conn->mConn.remoteHostAndPort)));
+		return;
+	}
+
+	ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+					errmsg("Interconnect error writing an outgoing packet: %m"),
+					errdetail("error during %s() call (error:%d).\n"
+							  "For Remote Connection: contentId=%d at %s",
+							  syscall, save_errno, conn->mConn.remoteContentId,
+							  conn->mConn.remoteHostAndPort)));
+	/* not reached */
+}
+
+/*
+ * checkShortTransmit
+ * 		Log a packet that was only partially transmitted.
+ */
+static inline void
+checkShortTransmit(MotionConnUDP *conn, ICBuffer *buf, int32 n, const char *syscall)
+{
+	if (n != buf->pkt->len)
+	{
+		if (DEBUG1 >= log_min_messages)
+			write_log("Interconnect error writing an outgoing packet [seq %d]: short transmit (given %d sent %d) during %s() call."
+					  "For Remote Connection: contentId=%d at %s", buf->pkt->seq, buf->pkt->len, n, syscall,
+					  conn->mConn.remoteContentId,
+					  conn->mConn.remoteHostAndPort);
+#ifdef AMS_VERBOSE_LOGGING
+		logPkt("PKT DETAILS ", buf->pkt);
+#endif
+	}
+}
+
 /*
  * sendOnce
  * 		Send a packet.
@@ -4874,54 +4965,118 @@ xmit_retry:
 			   (struct sockaddr *) &conn->peer, conn->peer_len);
 	if (n < 0)
 	{
-		int			save_errno = errno;
-
 		if (errno == EINTR)
 			goto xmit_retry;
 
 		if (errno == EAGAIN)	/* no space ? not an error. */
 			return;
 
-		/*
-		 * If Linux iptables (nf_conntrack?) drops an outgoing packet, it may
-		 * return an EPERM to the application. This might be simply because of
-		 * traffic shaping or congestion, so ignore it.
-		 */
-		if (errno == EPERM)
+		reportSendError(conn, errno, "sendto");
+		return;
+	}
+
+	checkShortTransmit(conn, buf, n, "sendto");
+}
+
+/*
+ * sendBatch
+ * 		Send packets of a connection, as few system calls as possible.
+ *
+ * Like sendOnce(), a packet that cannot be sent is left to the retransmission
+ * logic. If the socket buffer is full, none of the remaining packets are sent.
+ */
+static void
+sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pChunkEntry,
+		  MotionConnUDP *conn, ICBuffer **bufs, int nbufs)
+{
+	int			i;
+
+#ifdef USE_UDPIC_MMSG
+	ChunkTransportStateEntryUDP *pEntry = NULL;
+	struct mmsghdr msgs[UDPIC_MMSG_BATCH_SIZE];
+	struct iovec iovs[UDPIC_MMSG_BATCH_SIZE];
+	int			nsent = 0;
+
+	Assert(nbufs <= UDPIC_MMSG_BATCH_SIZE);
+
+	if (nbufs > 1 && UDPIC_MMSG_ENABLED())
+	{
+		pEntry = CONTAINER_OF(pChunkEntry, ChunkTransportStateEntryUDP, entry);
+
+		memset(msgs, 0, sizeof(struct mmsghdr) * nbufs);
+		for (i = 0; i < nbufs; i++)
 		{
-			ereport(LOG,
-					(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-					 errmsg("Interconnect error writing an outgoing packet: %m"),
-					 errdetail("error during sendto() for Remote Connection: contentId=%d at %s",
-							   conn->mConn.remoteContentId, conn->mConn.remoteHostAndPort)));
-			return;
+			iovs[i].iov_base = bufs[i]->pkt;
+			iovs[i].iov_len = bufs[i]->pkt->len;
+			msgs[i].msg_hdr.msg_name = &conn->peer;
+			msgs[i].msg_hdr.msg_namelen = conn->peer_len;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
 		}
 
-		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-						errmsg("Interconnect error writing an outgoing packet: %m"),
-						errdetail("error during sendto() call (error:%d).\n"
-								  "For Remote Connection: contentId=%d at %s",
-								  save_errno, conn->mConn.remoteContentId,
-								  conn->mConn.remoteHostAndPort)));
-		/* not reached */
-	}
+		while (nsent < nbufs)
+		{
+			int			n;
+			int			vlen = nbufs - nsent;
+			bool		sendNone = false;
 
-	if (n != buf->pkt->len)
-	{
-		if (DEBUG1 >= log_min_messages)
-			write_log("Interconnect error writing an outgoing packet [seq %d]: short transmit (given %d sent %d) during sendto() call."
-					  "For Remote Connection: contentId=%d at %s", buf->pkt->seq, buf->pkt->len, n,
-					  conn->mConn.remoteContentId,
-					  conn->mConn.remoteHostAndPort);
-#ifdef AMS_VERBOSE_LOGGING
-		logPkt("PKT DETAILS ", buf->pkt);
+#ifdef FAULT_INJECTOR
+			/* Hand over only part of the batch to the kernel. */
+			if (vlen > 1 &&
+				FaultInjector_InjectFaultIfSet("interconnect_sendmmsg_partial",
+											   DDLNotSpecified,
+											   "" /* databaseName */ ,
+											   "" /* tableName */ ) == FaultInjectorTypeSkip)
+				vlen = (vlen + 1) / 2;
+
+			/* Act as if the kernel sent none of the batch. */
+			if (FaultInjector_InjectFaultIfSet("interconnect_sendmmsg_none",
+											   DDLNotSpecified,
+											   "" /* databaseName */ ,
+											   "" /* tableName */ ) == FaultInjectorTypeSkip)
+				sendNone = true;
 #endif
+
+			n = sendNone ? 0 : sendmmsg(pEntry->txfd, &msgs[nsent], vlen, 0);
+
+			/*
+			 * Nothing sent is not an error either, but trying again at once
+			 * could spin forever.
+			 */
+			if (n == 0)
+				return;
+
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+
+				if (errno == EAGAIN)	/* no space ? not an error. */
+					return;
+
+				/* The error is about the first packet, skip it */
+				reportSendError(conn, errno, "sendmmsg");
+				nsent++;
+				continue;
+			}
+
+			ic_statistics.sndSyscallNum++;
+			for (i = nsent; i < nsent + n; i++)
+				checkShortTransmit(conn, bufs[i], msgs[i].msg_len, "sendmmsg");
+			nsent += n;
+		}
+
+		return;
 	}
+#endif
 
-	return;
+	for (i = 0; i < nbufs; i++)
+	{
+		sendOnce(transportStates, pChunkEntry, bufs[i], &conn->mConn);
+		ic_statistics.sndSyscallNum++;
+	}
 }
 
-
 /*
  * handleStopMsgs
  *		handle stop messages.
@@ -5036,7 +5191,8 @@ static void
 sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *mConn)
 {
 	MotionConnUDP *conn = NULL;
-	MotionConnUDP *buffConn = NULL;
+	ICBuffer   *batch[UDPIC_MMSG_BATCH_SIZE];
+	int			nbatch = 0;
 
 	conn = CONTAINER_OF(mConn, MotionConnUDP, mConn);
 
@@ -5078,9 +5234,9 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		}
 
 		/*
-		 * Note the place of sendOnce here. If we send before appending it to
+		 * Note the place of sendBatch here. If we send before appending it to
 		 * the unack queue and putting it into unack queue ring, and there is
-		 * a network error occurred in the sendOnce function, error message
+		 * a network error occurred in the sendBatch function, error message
 		 * will be output. In the time of error message output, interrupts is
 		 * potentially checked, if there is a pending query cancel, it will
 		 * lead to a dangled buffer (memory leak).
@@ -5089,14 +5245,25 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		updateStats(TPE_DATA_PKT_SEND, conn, buf->pkt);
 #endif
 
-		sendOnce(transportStates, pEntry, buf, &conn->mConn);
+		batch[nbatch++] = buf;
 		ic_statistics.sndPktNum++;
 
 #ifdef AMS_VERBOSE_LOGGING
 		logPkt("SEND PKT DETAIL", buf->pkt);
 #endif
-		buffConn = CONTAINER_OF(buf->conn, MotionConnUDP, mConn);
-		buffConn->sentSeq = buf->pkt->seq;
+
+		if (nbatch == UDPIC_MMSG_BATCH_SIZE)
+		{
+			sendBatch(transportStates, pEntry, conn, batch, nbatch);
+			conn->sentSeq = buf->pkt->seq;
+			nbatch = 0;
+		}
+	}
+
+	if (nbatch > 0)
+	{
+		sendBatch(transportStates, pEntry, conn, batch, nbatch);
+		conn->sentSeq = batch[nbatch - 1]->pkt->seq;
 	}
 }
 
@@ -6474,10 +6641,190 @@ handleDataPacket(MotionConn *mConn, icpkthdr *pkt, struct sockaddr_storage *peer
 	return true;
 }
 
+/*
+ * receivePackets
+ * 		Read up to npkts packets from the listener socket.
+ *
+ * Return the number of packets read, and set their lengths and senders, or
+ * return -1 with errno set.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ */
+static int
+receivePackets(icpkthdr **pkts, int npkts, struct sockaddr_storage *peers,
+			   socklen_t *peerlens, int *lens)
+{
+#ifdef USE_UDPIC_MMSG
+	if (npkts > 1)
+	{
+		struct mmsghdr msgs[UDPIC_MMSG_BATCH_SIZE];
+		struct iovec iovs[UDPIC_MMSG_BATCH_SIZE];
+		int			n;
+		int			i;
+
+		Assert(npkts <= UDPIC_MMSG_BATCH_SIZE);
+
+		memset(msgs, 0, sizeof(struct mmsghdr) * npkts);
+		for (i = 0; i < npkts; i++)
+		{
+			iovs[i].iov_base = pkts[i];
+			iovs[i].iov_len = Gp_max_packet_size;
+			msgs[i].msg_hdr.msg_name = &peers[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(peers[i]);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		/*
+		 * The socket is non-blocking, MSG_WAITFORONE makes sure of that
+		 * anyway once the first packet is read.
+		 */
+		n = recvmmsg(UDP_listenerFd, msgs, npkts, MSG_WAITFORONE, NULL);
+
+		for (i = 0; i < n; i++)
+		{
+			lens[i] = msgs[i].msg_len;
+			peerlens[i] = msgs[i].msg_hdr.msg_namelen;
+		}
+
+		return n;
+	}
+#endif
+
+	peerlens[0] = sizeof(peers[0]);
+	lens[0] = recvfrom(UDP_listenerFd, (char *) pkts[0], Gp_max_packet_size, 0,
+					   (struct sockaddr *) &peers[0], &peerlens[0]);
+
+	return lens[0] < 0 ? -1 : 1;
+}
+
+/*
+ * handleRxPacket
+ * 		Called by rx thread to handle a packet read from the listener socket.
+ *
+ * Return true if the packet buffer is kept by the interconnect, false if it
+ * can be reused.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ */
+static bool
+handleRxPacket(icpkthdr *pkt, int read_count, struct sockaddr_storage *peer,
+			   socklen_t peerlen)
+{
+	MotionConn *conn = NULL;
+	bool		consumed = false;
+	bool		wakeup_mainthread = false;
+	AckSendParam param;
+
+	if (DEBUG5 >= log_min_messages)
+		write_log("received inbound len %d", read_count);
+
+	if (read_count < sizeof(icpkthdr))
+	{
+		if (DEBUG1 >= log_min_messages)
+			write_log("Interconnect error: short conn receive (%d)", read_count);
+		return false;
+	}
+
+	/* length must be >= 0 */
+	if (pkt->len < 0)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound with negative length");
+		return false;
+	}
+
+	if (pkt->len != read_count)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
+		return false;
+	}
+
+	/*
+	 * check the CRC of the payload.
+	 */
+	if (gp_interconnect_full_crc)
+	{
+		if (!checkCRC(pkt))
+		{
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
+			if (DEBUG2 >= log_min_messages)
+				write_log("received network data error, dropping bad packet, user data unaffected.");
+			return false;
+		}
+	}
+
+#ifdef AMS_VERBOSE_LOGGING
+	logPkt("GOT MESSAGE", pkt);
+#endif
+
+	memset(&param, 0, sizeof(AckSendParam));
+
+	/*
+	 * Get the connection for the pkt.
+	 *
+	 * The connection hash table should be locked until finishing the
+	 * processing of the packet to avoid the connection addition/removal from
+	 * the hash table during the mean time.
+	 */
+
+	pthread_mutex_lock(&ic_control_info.lock);
+	conn = findConnByHeader(&ic_control_info.connHtab, pkt);
+
+	if (conn != NULL)
+	{
+		/* Handling a regular packet */
+		if (handleDataPacket(conn, pkt, peer, &peerlen, &param, &wakeup_mainthread))
+			consumed = true;
+		ic_statistics.recvPktNum++;
+	}
+	else
+	{
+		/*
+		 * There may have two kinds of Mismatched packets: a) Past packets
+		 * from previous command after I was torn down b) Future packets from
+		 * current command before my connections are built.
+		 *
+		 * The handling logic is to "Ack the past and Nak the future".
+		 */
+		if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
+		{
+			if (DEBUG1 >= log_min_messages)
+				write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+
+#ifdef AMS_VERBOSE_LOGGING
+			logPkt("Got a Mismatched Packet", pkt);
+#endif
+
+			if (handleMismatch(pkt, peer, peerlen))
+				consumed = true;
+			ic_statistics.mismatchNum++;
+		}
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	if (wakeup_mainthread)
+		SetLatch(&ic_control_info.latch);
+
+	/*
+	 * real ack sending is after lock release to decrease the lock holding
+	 * time.
+	 */
+	if (param.msg.len != 0)
+		sendAckWithParam(&param);
+
+	return consumed;
+}
+
 /*
  * rxThreadFunc
  * 		Main function of the receive background thread.
  *
+ * The thread keeps up to UDPIC_MMSG_BATCH_SIZE receive buffers, so that it
+ * can drain the socket with one system call when packets arrive in bursts.
+ * The buffers kept by data packets are replaced from the rx buffer pool.
+ *
  * NOTE: This function MUST NOT contain elog or ereport statements.
  * elog is NOT thread-safe.  Developers should instead use something like:
  *
@@ -6489,13 +6836,19 @@ handleDataPacket(MotionConn *mConn, icpkthdr *pkt, struct sockaddr_storage *peer
 static void *
 rxThreadFunc(void *arg)
 {
-	icpkthdr   *pkt = NULL;
+	icpkthdr   *pkts[UDPIC_MMSG_BATCH_SIZE];
+	struct sockaddr_storage peers[UDPIC_MMSG_BATCH_SIZE];
+	socklen_t	peerlens[UDPIC_MMSG_BATCH_SIZE];
+	int			lens[UDPIC_MMSG_BATCH_SIZE];
+	int			npkts = 0;
 	bool		skip_poll = false;
+	int			i;
 
 	for (;;)
 	{
 		struct pollfd nfd;
 		int			n;
+		int			batch_size;
 
 		/* check shutdown condition */
 		if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
@@ -6507,14 +6860,23 @@ rxThreadFunc(void *arg)
 			break;
 		}
 
-		/* Try to get a buffer */
-		if (pkt == NULL)
+		batch_size = UDPIC_MMSG_ENABLED() ? UDPIC_MMSG_BATCH_SIZE : 1;
+
+		/* Try to get buffers, it's enough to get one */
+		if (npkts < batch_size)
 		{
 			pthread_mutex_lock(&ic_control_info.lock);
-			pkt = getRxBuffer(&rx_buffer_pool);
+			while (npkts < batch_size)
+			{
+				icpkthdr   *pkt = getRxBuffer(&rx_buffer_pool);
+
+				if (pkt == NULL)
+					break;
+				pkts[npkts++] = pkt;
+			}
 			pthread_mutex_unlock(&ic_control_info.lock);
 
-			if (pkt == NULL)
+			if (npkts == 0)
 			{
 				setRxThreadError(ENOMEM);
 				continue;
@@ -6564,15 +6926,10 @@ rxThreadFunc(void *arg)
 			/* we've got something interesting to read */
 			/* handle incoming */
 			/* ready to read on our socket */
-			MotionConn *conn = NULL;
-			int			read_count = 0;
+			int			nrecv;
 
-			struct sockaddr_storage peer;
-			socklen_t	peerlen;
-
-			peerlen = sizeof(peer);
-			read_count = recvfrom(UDP_listenerFd, (char *) pkt, Gp_max_packet_size, 0,
-								  (struct sockaddr *) &peer, &peerlen);
+			nrecv = receivePackets(pkts, Min(npkts, batch_size),
+								   peers, peerlens, lens);
 
 			if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
 			{
@@ -6583,10 +6940,7 @@ rxThreadFunc(void *arg)
 				break;
 			}
 
-			if (DEBUG5 >= log_min_messages)
-				write_log("received inbound len %d", read_count);
-
-			if (read_count < 0)
+			if (nrecv < 0)
 			{
 				skip_poll = false;
 
@@ -6607,121 +6961,41 @@ rxThreadFunc(void *arg)
 				continue;
 			}
 
-			if (read_count < sizeof(icpkthdr))
-			{
-				if (DEBUG1 >= log_min_messages)
-					write_log("Interconnect error: short conn receive (%d)", read_count);
-				continue;
-			}
-
 			/*
 			 * when we get a "good" recvfrom() result, we can skip poll()
 			 * until we get a bad one.
 			 */
 			skip_poll = true;
 
-			/* length must be >= 0 */
-			if (pkt->len < 0)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound with negative length");
-				continue;
-			}
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.recvSyscallNum, 1);
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.recvSyscallPktNum, nrecv);
 
-			if (pkt->len != read_count)
+			for (i = 0; i < nrecv; i++)
 			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
-				continue;
+				if (handleRxPacket(pkts[i], lens[i], &peers[i], peerlens[i]))
+					pkts[i] = NULL;
 			}
 
-			/*
-			 * check the CRC of the payload.
-			 */
-			if (gp_interconnect_full_crc)
+			/* Keep the buffers that can be reused at the front */
+			n = 0;
+			for (i = 0; i < npkts; i++)
 			{
-				if (!checkCRC(pkt))
-				{
-					pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
-					if (DEBUG2 >= log_min_messages)
-						write_log("received network data error, dropping bad packet, user data unaffected.");
-					continue;
-				}
+				if (pkts[i] != NULL)
+					pkts[n++] = pkts[i];
 			}
-
-#ifdef AMS_VERBOSE_LOGGING
-			logPkt("GOT MESSAGE", pkt);
-#endif
-
-			bool		wakeup_mainthread = false;
-			AckSendParam param;
-
-			memset(&param, 0, sizeof(AckSendParam));
-
-			/*
-			 * Get the connection for the pkt.
-			 *
-			 * The connection hash table should be locked until finishing the
-			 * processing of the packet to avoid the connection
-			 * addition/removal from the hash table during the mean time.
-			 */
-
-			pthread_mutex_lock(&ic_control_info.lock);
-			conn = findConnByHeader(&ic_control_info.connHtab, pkt);
-
-			if (conn != NULL)
-			{
-				/* Handling a regular packet */
-				if (handleDataPacket(conn, pkt, &peer, &peerlen, &param, &wakeup_mainthread))
-					pkt = NULL;
-				ic_statistics.recvPktNum++;
-			}
-			else
-			{
-				/*
-				 * There may have two kinds of Mismatched packets: a) Past
-				 * packets from previous command after I was torn down b)
-				 * Future packets from current command before my connections
-				 * are built.
-				 *
-				 * The handling logic is to "Ack the past and Nak the future".
-				 */
-				if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
-				{
-					if (DEBUG1 >= log_min_messages)
-						write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
-
-#ifdef AMS_VERBOSE_LOGGING
-					logPkt("Got a Mismatched Packet", pkt);
-#endif
-
-					if (handleMismatch(pkt, &peer, peerlen))
-						pkt = NULL;
-					ic_statistics.mismatchNum++;
-				}
-			}
-			pthread_mutex_unlock(&ic_control_info.lock);
-
-			if (wakeup_mainthread)
-				SetLatch(&ic_control_info.latch);
-
-			/*
-			 * real ack sending is after lock release to decrease the lock
-			 * holding time.
-			 */
-			if (param.msg.len != 0)
-				sendAckWithParam(&param);
+			npkts = n;
 		}
 
 		/* pthread_yield(); */
 	}
 
-	/* Before return, we release the packet. */
-	if (pkt)
+	/* Before return, we release the packets. */
+	if (npkts > 0)
 	{
 		pthread_mutex_lock(&ic_control_info.lock);
-		freeRxBuffer(&rx_buffer_pool, pkt);
-		pkt = NULL;
+		for (i = 0; i < npkts; i++)
+			freeRxBuffer(&rx_buffer_pool, pkts[i]);
+		npkts = 0;
 		pthread_mutex_unlock(&ic_control_info.lock);
 	}
 
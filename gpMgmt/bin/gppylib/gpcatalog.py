@@ -39,6 +39,7 @@ COORDINATOR_ONLY_TABLES = [
 # Hard coded tables that have different values on every segment
 SEGMENT_LOCAL_TABLES = [
     'gp_fastsequence', # AO segment row id allocations
+    'gp_zstd_dictionary', # trained from the data of each segment
     'gp_id',
     'pg_shdepend', # (not if we fix oid inconsistencies)
     'pg_statistic',
@@ -144,10 +144,12 @@ static void printTemplate() {
         "chunksize = 67108864\n"
         "low_speed_limit = 10240\n"
         "low_speed_time = 60\n"
+        "keepalive_idle_time = 60\n"
         "encryption = true\n"
         "version = 1\n"
         "proxy = \"\"\n"
         "autocompress = true\n"
+        "compress_member_size = 0\n"
         "verifycert = true\n"
         "server_side_encryption = \"\"\n"
         "# gpcheckcloud config\n"
@@ -29,6 +29,8 @@ class CompressWriter : public Writer {
    private:
     void flush();
     uint64_t writeOneChunk(const char *buf, uint64_t count);
+    void finishMember();
+    void setMemberHeader();
 
     Writer *writer;
 
@@ -36,6 +38,17 @@ class CompressWriter : public Writer {
     z_stream zstream;
     char *out;  // Output buffer for compression.
 
+    // Data is written as gzip members of memberSize bytes of uncompressed data each, so they can
+    // be decompressed in parallel. 0 to write a single member.
+    uint64_t memberSize;
+    uint64_t memberInLen;  // uncompressed bytes in current member
+
+    // Each member has its compressed size in the size subfield of its gzip header, for readers to
+    // find members without decompressing them. The member is kept until its size is known.
+    gz_header memberHeader;
+    Byte memberHeaderExtra[4 + S3_GZIP_SIZE_SUBFIELD_LEN];
+    string member;
+
     // add this flag to make close() reentrant
     bool isClosed;
 };
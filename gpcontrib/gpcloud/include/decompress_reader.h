@@ -10,6 +10,9 @@
 // 2MB by default
 extern uint64_t S3_ZIP_DECOMPRESS_CHUNKSIZE;
 
+// Whether data, of len bytes, might be the beginning of a gzip member.
+bool IsGzipMemberHead(const Byte *data, uint64_t len);
+
 class DecompressReader : public Reader {
    public:
     DecompressReader();
@@ -29,7 +32,7 @@ class DecompressReader : public Reader {
     void resizeDecompressReaderBuffer(uint64_t size);
 
    private:
-    void decompress();
+    bool decompress();
 
     uint64_t getDecompressedBytesNum() {
         return S3_ZIP_DECOMPRESS_CHUNKSIZE - this->zstream.avail_out;
@@ -43,6 +46,8 @@ class DecompressReader : public Reader {
     char *out;           // Output buffer for decompression.
     uint64_t outOffset;  // Next position to read in out buffer.
 
+    bool isStreamEnd;  // the last inflate() finished a stream, a next gzip member may follow
+
     bool isClosed;
 };
 
@@ -1,6 +1,7 @@
 #ifndef __GP_READER_H__
 #define __GP_READER_H__
 
+#include "parquet_reader.h"
 #include "reader.h"
 #include "s3bucket_reader.h"
 #include "s3common_headers.h"
@@ -34,10 +35,24 @@ class GPReader : public Reader {
         return params;
     }
 
+    // Read keys as Parquet files, into the rows of ParquetReader, instead of text.
+    void setParquetScanDesc(const ParquetScanDesc &scanDesc) {
+        this->isParquet = true;
+        this->parquetReader.setScanDesc(scanDesc);
+    }
+
+    // Split large keys into ranges read by different segments, only for text format.
+    void setSplitKeys(bool splitKeys) {
+        this->splitKeys = splitKeys;
+    }
+
    protected:
     S3Params params;
     S3BucketReader bucketReader;
     S3CommonReader commonReader;
+    ParquetReader parquetReader;
+    bool isParquet;
+    bool splitKeys;
     S3RESTfulService restfulService;
 
     S3InterfaceService s3InterfaceService;
@@ -48,7 +63,8 @@ class GPReader : public Reader {
 };
 
 // Following 3 functions are invoked by s3_import(), need to be exception safe
-GPReader *reader_init(const char *url_with_options);
+GPReader *reader_init(const char *url_with_options, const ParquetScanDesc *parquetScanDesc = NULL,
+                      bool splitKeys = false);
 bool reader_transfer_data(GPReader *reader, char *data_buf, int &data_len);
 bool reader_cleanup(GPReader **reader);
 
@@ -0,0 +1,166 @@
+#ifndef INCLUDE_PARALLEL_DECOMPRESS_READER_H_
+#define INCLUDE_PARALLEL_DECOMPRESS_READER_H_
+
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+#include "decompress_reader.h"
+#include "reader.h"
+#include "s3common_headers.h"
+#include "s3exception.h"
+#include "s3interface.h"
+#include "s3macros.h"
+#include "s3params.h"
+
+// Compressed size of the gzip member at data, given by the size subfield of CompressWriter or by
+// the BGZF subfield of bgzip. Return 0 if the header has neither, or is not complete in len bytes.
+uint64_t GetGzipMemberSize(const Byte *data, uint64_t len);
+
+// A gzip member or a zstd frame of known size, decompressed by a worker.
+struct CompressedMember {
+    // TooLarge if the member has more output than its gzip trailer tells, ISIZE is modulo 2^32.
+    enum Status { Pending, Complete, TooLarge, Invalid };
+
+    uint64_t offset;      // where the member starts in input
+    uint64_t size;        // compressed bytes
+    uint64_t outputSize;  // decompressed bytes, from the gzip trailer or the zstd frame header
+    Status status;
+    string data;  // decompressed data
+};
+
+// Hand over data already read from a reader, followed by the rest of that reader. The reader is
+// opened and closed by the owner.
+class PrefixedReader : public Reader {
+   public:
+    PrefixedReader() : offset(0), reader(NULL) {
+    }
+
+    virtual void open(const S3Params &params) {
+    }
+
+    virtual uint64_t read(char *buf, uint64_t count);
+
+    virtual void close() {
+        this->prefix.clear();
+        this->offset = 0;
+    }
+
+    void setPrefix(string &prefix, Reader *reader) {
+        this->prefix.swap(prefix);
+        this->offset = 0;
+        this->reader = reader;
+    }
+
+   private:
+    string prefix;
+    uint64_t offset;  // next position to read in prefix
+    Reader *reader;
+};
+
+// ParallelDecompressReader decompresses the members of gzip data written by CompressWriter with
+// compress_member_size or by bgzip, and the frames of zstd data, on a pool of worker threads.
+//
+// The compressed size of each member is known before it is decompressed: gzip members carry it in
+// an extra subfield of their header, zstd frames are delimited by their block headers. Compressed
+// data is read in batches, the complete members of a batch are decompressed by the workers and
+// returned in order. A member larger than a batch, or with more than memberOutputLimit bytes of
+// output, is decompressed as a stream in the calling thread instead.
+//
+// Gzip data without member sizes, like single-member files or those written by gzip or pigz, is
+// handed over to DecompressReader, from the first member without a size on.
+class ParallelDecompressReader : public Reader {
+   public:
+    ParallelDecompressReader();
+    virtual ~ParallelDecompressReader();
+
+    virtual void open(const S3Params &params);
+
+    // read() attempts to read up to count bytes into the buffer.
+    // Return 0 if EOF. Throw exception if encounters errors.
+    virtual uint64_t read(char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setReader(Reader *reader) {
+        this->reader = reader;
+    }
+
+    // S3_COMPRESSION_GZIP by default, or S3_COMPRESSION_ZSTD if built with libzstd.
+    void setCompressionType(S3CompressionType type) {
+        this->compressionType = type;
+    }
+
+    // Whether the rest of data is decompressed by DecompressReader.
+    bool isSequential() const {
+        return this->isFallback;
+    }
+
+    // Run by the worker threads.
+    void runWorker();
+
+   private:
+    // What is at an offset of input.
+    enum MemberLayout {
+        MemberInBatch,   // a member a worker can decompress
+        MemberInStream,  // a member to decompress as a stream
+        MemberUnsized,   // a gzip member without size
+        MemberNone,      // trailing data
+    };
+
+    void startWorkers(uint64_t num);
+    void stopWorkers();
+    void decompressMember(CompressedMember &member);
+    void decompressMembers(vector<CompressedMember> &members);
+
+    void fillInput();
+    bool decompressBatch();
+    MemberLayout findMember(uint64_t offset, CompressedMember &member);
+    void startStream();
+    void decompressStream();
+    void endStream();
+    void fallback();
+
+    Reader *reader;
+    S3CompressionType compressionType;
+    S3Params params;
+
+    uint64_t numOfThreads;
+    uint64_t batchSize;          // compressed bytes decompressed in parallel at a time
+    uint64_t memberOutputLimit;  // output of a member decompressed by a worker
+
+    string input;     // compressed data, starting at a member boundary
+    bool isInputEOF;  // all data of underlying reader is in input
+
+    vector<string> outputs;  // decompressed data, in order
+    uint64_t outputIndex;    // next output to read
+    uint64_t outputOffset;   // next position to read in outputs[outputIndex]
+
+    // a member decompressed in the calling thread
+    bool isStreaming;
+    z_stream zstream;
+#ifdef HAVE_LIBZSTD
+    ZSTD_DStream *zstdStream;
+    ZSTD_inBuffer zstdIn;
+#endif
+
+    // data without member sizes, decompressed by DecompressReader
+    bool isFallback;
+    PrefixedReader prefixedReader;
+    DecompressReader decompressReader;
+
+    // worker pool, kept over keys until the reader is destroyed
+    vector<pthread_t> workers;
+    pthread_mutex_t poolMutex;
+    pthread_cond_t memberCond;  // workers wait for members
+    pthread_cond_t batchCond;   // the reader waits for the batch to be done
+    vector<CompressedMember> *batch;
+    uint64_t nextMember;   // next member of batch for a worker
+    uint64_t doneMembers;  // members of batch decompressed
+    bool isStopping;
+
+    bool isClosed;
+};
+
+#endif /* INCLUDE_PARALLEL_DECOMPRESS_READER_H_ */
@@ -0,0 +1,250 @@
+#ifndef __PARQUET_READER_H__
+#define __PARQUET_READER_H__
+
+#include "reader.h"
+#include "s3common_headers.h"
+#include "s3exception.h"
+#include "s3interface.h"
+
+// Physical types, codecs, encodings and page types, numbered as in parquet.thrift.
+enum ParquetType {
+    PARQUET_BOOLEAN = 0,
+    PARQUET_INT32 = 1,
+    PARQUET_INT64 = 2,
+    PARQUET_INT96 = 3,
+    PARQUET_FLOAT = 4,
+    PARQUET_DOUBLE = 5,
+    PARQUET_BYTE_ARRAY = 6,
+    PARQUET_FIXED_LEN_BYTE_ARRAY = 7,
+};
+
+enum ParquetCodec {
+    PARQUET_UNCOMPRESSED = 0,
+    PARQUET_SNAPPY = 1,
+    PARQUET_GZIP = 2,
+};
+
+enum ParquetEncoding {
+    PARQUET_PLAIN = 0,
+    PARQUET_PLAIN_DICTIONARY = 2,
+    PARQUET_RLE = 3,
+    PARQUET_RLE_DICTIONARY = 8,
+};
+
+enum ParquetPageType {
+    PARQUET_DATA_PAGE = 0,
+    PARQUET_INDEX_PAGE = 1,
+    PARQUET_DICTIONARY_PAGE = 2,
+    PARQUET_DATA_PAGE_V2 = 3,
+};
+
+// What a value means beyond its physical type, from ConvertedType or LogicalType.
+enum ParquetLogicalType {
+    PARQUET_LOGICAL_NONE,
+    PARQUET_LOGICAL_STRING,
+    PARQUET_LOGICAL_DATE,
+    PARQUET_LOGICAL_TIMESTAMP_MILLIS,
+    PARQUET_LOGICAL_TIMESTAMP_MICROS,
+    PARQUET_LOGICAL_TIMESTAMP_NANOS,
+    PARQUET_LOGICAL_OTHER,
+};
+
+struct ParquetStatistics {
+    ParquetStatistics() : hasMinMax(false), hasNullCount(false), nullCount(0) {
+    }
+
+    bool hasMinMax;
+    string min;  // PLAIN encoded, without length for BYTE_ARRAY
+    string max;
+    bool hasNullCount;
+    int64_t nullCount;
+};
+
+struct ParquetColumnChunk {
+    ParquetColumnChunk()
+        : codec(0), numValues(0), dataPageOffset(0), dictionaryPageOffset(0),
+          totalCompressedSize(0) {
+    }
+
+    // Pages of the chunk start with the dictionary page if any.
+    uint64_t getStartOffset() const {
+        if (dictionaryPageOffset > 0 && dictionaryPageOffset < dataPageOffset) {
+            return dictionaryPageOffset;
+        }
+        return dataPageOffset;
+    }
+
+    int32_t codec;
+    int64_t numValues;
+    int64_t dataPageOffset;
+    int64_t dictionaryPageOffset;  // 0 if none
+    int64_t totalCompressedSize;
+    ParquetStatistics stats;
+};
+
+struct ParquetRowGroup {
+    ParquetRowGroup() : numRows(0) {
+    }
+
+    int64_t numRows;
+    vector<ParquetColumnChunk> columns;  // one for each leaf column
+};
+
+// A leaf of the schema, in the order of column chunks.
+struct ParquetSchemaColumn {
+    ParquetSchemaColumn()
+        : type(PARQUET_BYTE_ARRAY), logicalType(PARQUET_LOGICAL_NONE), typeLength(0),
+          maxDefinitionLevel(0), isTopLevel(true) {
+    }
+
+    string name;
+    int32_t type;
+    ParquetLogicalType logicalType;
+    int32_t typeLength;
+    int32_t maxDefinitionLevel;
+    bool isTopLevel;  // neither nested nor repeated, the only ones we can read
+};
+
+struct ParquetFileMetaData {
+    ParquetFileMetaData() : numRows(0) {
+    }
+
+    int64_t numRows;
+    vector<ParquetSchemaColumn> columns;
+    vector<ParquetRowGroup> rowGroups;
+};
+
+// Parse the Thrift compact encoded FileMetaData in the footer of Parquet file.
+ParquetFileMetaData ParseParquetFileMetaData(const uint8_t *data, uint64_t len);
+
+// How values of a table column are passed to gpcloud_parquet_import(), decided by the column
+// type. Columns that the scan doesn't need are PARQUET_KIND_SKIP, and are always NULL.
+enum ParquetValueKind {
+    PARQUET_KIND_SKIP,
+    PARQUET_KIND_BOOL,
+    PARQUET_KIND_INT16,
+    PARQUET_KIND_INT32,
+    PARQUET_KIND_INT64,
+    PARQUET_KIND_FLOAT4,
+    PARQUET_KIND_FLOAT8,
+    PARQUET_KIND_TEXT,
+    PARQUET_KIND_DATE,       // days since 2000-01-01
+    PARQUET_KIND_TIMESTAMP,  // microseconds since 2000-01-01
+};
+
+struct ParquetTableColumn {
+    ParquetTableColumn(const string &name, ParquetValueKind kind) : name(name), kind(kind) {
+    }
+
+    string name;
+    ParquetValueKind kind;
+};
+
+enum ParquetQualOp {
+    PARQUET_QUAL_EQ,
+    PARQUET_QUAL_LT,
+    PARQUET_QUAL_LE,
+    PARQUET_QUAL_GT,
+    PARQUET_QUAL_GE,
+};
+
+// "column op constant" of the scan, row groups whose statistics show no row can match are
+// skipped. The constant is in intValue, floatValue or textValue depending on the column kind.
+struct ParquetQual {
+    ParquetQual() : column(0), op(PARQUET_QUAL_EQ), intValue(0), floatValue(0) {
+    }
+
+    uint64_t column;  // index of table column
+    ParquetQualOp op;
+    int64_t intValue;
+    double floatValue;
+    string textValue;
+};
+
+struct ParquetScanDesc {
+    vector<ParquetTableColumn> columns;
+    vector<ParquetQual> quals;
+};
+
+// Values of a table column in a row group, in the row format below.
+struct ParquetColumnValues {
+    ParquetColumnValues() : cursor(0) {
+    }
+
+    void clear() {
+        nulls.clear();
+        data.clear();
+        cursor = 0;
+    }
+
+    vector<bool> nulls;
+    string data;  // values of non NULL rows
+    uint64_t cursor;
+};
+
+// ParquetReader reads the rows of a Parquet key for gpcloud_parquet_import(), which forms the
+// tuples out of them without the input functions of text format. Only the byte ranges of needed
+// columns are fetched, one row group at a time. A row is:
+//   uint32 length of the rest of row
+//   for each table column, uint8 1 for NULL, otherwise 0 followed by the value:
+//     BOOL 1 byte, INT16 2 bytes, INT32, FLOAT4 and DATE 4 bytes,
+//     INT64, FLOAT8 and TIMESTAMP 8 bytes, TEXT uint32 length and the bytes.
+// in host byte order, as rows never leave the segment.
+class ParquetReader : public Reader {
+   public:
+    ParquetReader();
+    virtual ~ParquetReader() {
+        this->close();
+    }
+
+    void open(const S3Params &params);
+    uint64_t read(char *buf, uint64_t count);
+    void close();
+
+    void setS3InterfaceService(S3Interface *s3) {
+        this->s3Interface = s3;
+    }
+
+    void setScanDesc(const ParquetScanDesc &scanDesc) {
+        this->scanDesc = scanDesc;
+    }
+
+    const ParquetFileMetaData &getMetaData() const {
+        return metaData;
+    }
+
+    uint64_t getSkippedRowGroups() const {
+        return skippedRowGroups;
+    }
+
+   private:
+    void fetch(uint64_t offset, uint64_t len, S3VectorUInt8 &data);
+    void readMetaData();
+    void mapColumns();
+
+    bool canSkipRowGroup(const ParquetRowGroup &rowGroup);
+    bool nextRowGroup();
+    void readColumnChunk(const ParquetColumnChunk &chunk, const ParquetSchemaColumn &column,
+                         ParquetValueKind kind, ParquetColumnValues &values);
+    void fillRows(uint64_t count);
+
+    S3Interface *s3Interface;
+    S3Url s3Url;
+    uint64_t keySize;
+
+    ParquetScanDesc scanDesc;
+    ParquetFileMetaData metaData;
+    vector<int64_t> columnIndexes;  // leaf column of each table column, -1 if not read
+
+    uint64_t rowGroupIndex;  // next row group to read
+    uint64_t numRows;        // rows of current row group
+    uint64_t rowIndex;
+    vector<ParquetColumnValues> values;  // of each table column
+
+    string rowBuffer;  // rows not returned by read() yet
+    uint64_t rowBufferOffset;
+
+    uint64_t skippedRowGroups;
+};
+
+#endif
@@ -6,6 +6,14 @@
 #include "s3exception.h"
 #include "s3interface.h"
 
+// A piece of work in a bucket: a whole key, or a byte range of a large key.
+struct BucketReadItem {
+    uint64_t keyIndex;  // index of keyList.contents
+    uint64_t offset;
+    uint64_t length;
+    bool isRange;  // read lines starting in [offset, offset + length) only
+};
+
 // S3BucketReader read multiple files in a bucket.
 class S3BucketReader : public Reader {
    public:
@@ -24,10 +32,20 @@ class S3BucketReader : public Reader {
         this->upstreamReader = reader;
     }
 
+    // Only keys of text format are split, CSV may quote newlines and Parquet can't be read from
+    // the middle.
+    void setSplitKeys(bool splitKeys) {
+        this->splitKeys = splitKeys;
+    }
+
     const ListBucketResult &getKeyList() {
         return keyList;
     }
 
+    const vector<BucketReadItem> &getReadItems() {
+        return readItems;
+    }
+
    private:
     S3Params params;
 
@@ -37,6 +55,12 @@ class S3BucketReader : public Reader {
     Reader *upstreamReader;
     bool needNewReader;
 
+    // whether large keys are split into line-aligned ranges
+    bool splitKeys;
+
+    // whether the listing has been compared with the bucket after reading
+    bool isKeyListChecked;
+
     // when load multiple files on one segment and each of them has a header line,
     // we should read header line only for the 1st file and ignore remainings.
     bool isFirstFile;
@@ -46,10 +70,16 @@ class S3BucketReader : public Reader {
     uint64_t readWithoutHeaderLine(char *buf, uint64_t count);
 
     ListBucketResult keyList;  // List of matched keys/files.
-    uint64_t keyIndex;         // BucketContent index of keylist->contents.
 
-    BucketContent &getNextKey();
-    S3Params constructReaderParams(BucketContent &key);
+    vector<BucketReadItem> readItems;  // Items of this segment, in listing order.
+    uint64_t itemIndex;                // Index of readItems.
+
+    void planReadItems();
+    void checkKeyList();
+    bool isPlainKey(const BucketContent &key);
+
+    const BucketReadItem &getNextItem();
+    S3Params constructReaderParams(const BucketReadItem &item);
 };
 
 #endif
@@ -180,6 +180,22 @@ class S3ConfigError : public S3Exception {
     string message;
 };
 
+class S3ParquetError : public S3Exception {
+   public:
+    S3ParquetError(const string& msg) : message(msg) {
+    }
+    virtual ~S3ParquetError() {
+    }
+    virtual string getMessage() {
+        return message;
+    }
+    virtual string getType() {
+        return "S3ParquetError";
+    }
+
+    string message;
+};
+
 class S3MemoryOverLimit : public S3Exception {
    public:
     S3MemoryOverLimit(uint64_t limit, uint64_t allocSize) : limit(limit), allocSize(allocSize) {
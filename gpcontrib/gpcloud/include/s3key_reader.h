@@ -75,7 +75,13 @@ class S3KeyReader : public Reader {
           transferredKeyLen(0),
           s3Interface(NULL),
           hasEol(false),
-          eolAppended(false) {
+          eolAppended(false),
+          s3Url(""),
+          keySize(0),
+          fetchStart(0),
+          tailOffset(0),
+          lineSkipPending(false),
+          tailPending(false) {
         pthread_mutex_init(&this->mutexErrorMessage, NULL);
     }
     virtual ~S3KeyReader() {
@@ -162,8 +168,22 @@ class S3KeyReader : public Reader {
 
     void reset();
 
+    uint64_t readChunks(char* buf, uint64_t count);
+    uint64_t readPastRangeEnd(char* buf, uint64_t count);
+
     bool hasEol;
     bool eolAppended;
+
+    // When reading a key range, offsetMgr covers [fetchStart, end of range), fetchStart being
+    // one byte before the range to tell whether a line starts at the range beginning. The
+    // partial line at the beginning is skipped (lineSkipPending), the last line is read up to
+    // its end past the range (tailPending) like Hadoop's LineRecordReader does.
+    S3Url s3Url;
+    uint64_t keySize;
+    uint64_t fetchStart;
+    uint64_t tailOffset;
+    bool lineSkipPending;
+    bool tailPending;
 };
 
 class ChunkBuffer {
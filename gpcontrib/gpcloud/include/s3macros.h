@@ -35,4 +35,23 @@ extern uint64_t S3_ZIP_COMPRESS_CHUNKSIZE;
 // to enable zlib and gzip decoding with automatic header detection.
 #define S3_INFLATE_WINDOWSBITS (MAX_WBITS + 16 + 16)
 
+// Gzip extra subfield written by CompressWriter in the header of every member with
+// compress_member_size, its 4 bytes of data are the compressed size of the member, little-endian.
+#define S3_GZIP_SIZE_SUBFIELD_ID1 'S'
+#define S3_GZIP_SIZE_SUBFIELD_ID2 'Z'
+#define S3_GZIP_SIZE_SUBFIELD_LEN 4
+
+// Max number of idle curl handles kept in the per-process pool. Readers use up to
+// 8 threads each, so this leaves room for a few external tables in one query.
+#define S3_CURL_POOL_MAX_IDLE 64
+
+// Size of each request reading the last line of a key range past the end of the range.
+#define S3_KEY_RANGE_TAIL_SIZE (64 * 1024)
+
+// Keys are split into ranges only when larger than this, to keep the number of requests sane.
+#define S3_KEY_SPLIT_MIN_SIZE (64 * 1024 * 1024)
+
+// Tail of a Parquet key fetched at first, which covers the footer of most files.
+#define S3_PARQUET_FOOTER_FETCH_SIZE (64 * 1024)
+
 #endif
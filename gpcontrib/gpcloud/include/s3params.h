@@ -13,14 +13,18 @@ class S3Params {
              const string& region = "")
         : s3Url(sourceUrl, useHttps, version, region),
           keySize(0),
+          keyRangeOffset(0),
+          keyRangeLength(0),
           chunkSize(0),
           numOfChunks(0),
           lowSpeedLimit(0),
           lowSpeedTime(0),
+          keepAliveIdleTime(0),
           proxy(""),
           debugCurl(false),
           autoCompress(false),
           verifyCert(false),
+          compressMemberSize(0),
           sseType(SSE_NONE),
           gpcheckcloud_newline("") {
     }
@@ -72,6 +76,23 @@ class S3Params {
         this->keySize = size;
     }
 
+    uint64_t getKeyRangeOffset() const {
+        return keyRangeOffset;
+    }
+
+    uint64_t getKeyRangeLength() const {
+        return keyRangeLength;
+    }
+
+    bool hasKeyRange() const {
+        return keyRangeLength != 0;
+    }
+
+    void setKeyRange(uint64_t offset, uint64_t length) {
+        this->keyRangeOffset = offset;
+        this->keyRangeLength = length;
+    }
+
     uint64_t getLowSpeedLimit() const {
         return lowSpeedLimit;
     }
@@ -88,6 +109,14 @@ class S3Params {
         this->lowSpeedTime = lowSpeedTime;
     }
 
+    uint64_t getKeepAliveIdleTime() const {
+        return keepAliveIdleTime;
+    }
+
+    void setKeepAliveIdleTime(uint64_t keepAliveIdleTime) {
+        this->keepAliveIdleTime = keepAliveIdleTime;
+    }
+
     bool isDebugCurl() const {
         return debugCurl;
     }
@@ -111,6 +140,14 @@ class S3Params {
         this->autoCompress = autoCompress;
     }
 
+    uint64_t getCompressMemberSize() const {
+        return compressMemberSize;
+    }
+
+    void setCompressMemberSize(uint64_t compressMemberSize) {
+        this->compressMemberSize = compressMemberSize;
+    }
+
     const S3MemoryContext& getMemoryContext() const {
         return memoryContext;
     }
@@ -152,6 +189,11 @@ class S3Params {
 
     uint64_t keySize;  // key/file size.
 
+    // byte range of the key to read, lines starting in it are read entirely.
+    // keyRangeLength is 0 to read the whole key.
+    uint64_t keyRangeOffset;
+    uint64_t keyRangeLength;
+
     S3Credential cred;  // S3 credential.
 
     uint64_t chunkSize;    // chunk size
@@ -160,6 +202,8 @@ class S3Params {
     uint64_t lowSpeedLimit;  // low speed limit
     uint64_t lowSpeedTime;   // low speed timeout
 
+    uint64_t keepAliveIdleTime;  // seconds an idle connection is kept for reuse, 0 to disable
+
     string proxy;  // proxy
 
     bool debugCurl;     // debug curl or not
@@ -167,6 +211,8 @@ class S3Params {
     bool verifyCert;  // This option determines whether curl verifies the authenticity of the peer's
                       // certificate.
 
+    uint64_t compressMemberSize;  // data bytes per gzip member when compressing, 0 for one member
+
     S3SSEType sseType;
 
     S3MemoryContext memoryContext;
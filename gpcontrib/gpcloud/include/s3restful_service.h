@@ -10,6 +10,42 @@
 #include "s3macros.h"
 #include "s3params.h"
 
+// Per-process pool of curl easy handles. A handle keeps its connection cache
+// after curl_easy_reset(), so taking it back from the pool lets the next
+// request reuse the TCP/TLS connection instead of doing a new handshake.
+class S3CurlHandlePool {
+   public:
+    static S3CurlHandlePool& getInstance();
+
+    // Returns an idle handle released less than idleTime seconds ago, or a
+    // new one. Idle handles older than that are cleaned up.
+    CURL* acquire(uint64_t idleTime);
+
+    // Resets the handle and keeps it for reuse.
+    void release(CURL* curl);
+
+    void clear();
+
+    uint64_t getIdleNum();
+    uint64_t getCreatedNum();
+    uint64_t getReusedNum();
+
+   private:
+    S3CurlHandlePool();
+    ~S3CurlHandlePool();
+
+    struct IdleHandle {
+        CURL* curl;
+        time_t releasedAt;
+    };
+
+    pthread_mutex_t mutex;
+    vector<IdleHandle> idleHandles;
+
+    uint64_t createdNum;
+    uint64_t reusedNum;
+};
+
 class S3RESTfulService : public RESTfulService {
    public:
     S3RESTfulService();
@@ -30,6 +66,7 @@ class S3RESTfulService : public RESTfulService {
    private:
     uint64_t lowSpeedLimit;
     uint64_t lowSpeedTime;
+    uint64_t keepAliveIdleTime;
 
     string proxy;
 
@@ -2,7 +2,10 @@
 
 uint64_t S3_ZIP_COMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
 
-CompressWriter::CompressWriter() : writer(NULL), isClosed(true) {
+// Data of the size subfield follows the gzip header, XLEN, SI1, SI2 and LEN, 16 bytes in all.
+#define S3_GZIP_SIZE_OFFSET 16
+
+CompressWriter::CompressWriter() : writer(NULL), memberSize(0), memberInLen(0), isClosed(true) {
     this->out = new char[S3_ZIP_COMPRESS_CHUNKSIZE];
 }
 
@@ -23,6 +26,10 @@ void CompressWriter::open(const S3Params& params) {
     int ret = deflateInit2(&this->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
                            S3_DEFLATE_WINDOWSBITS, 8, Z_DEFAULT_STRATEGY);
 
+    this->memberSize = params.getCompressMemberSize();
+    this->memberInLen = 0;
+    this->member.clear();
+
     this->isClosed = false;
 
     // init them here to get ready for both writer() and close()
@@ -34,6 +41,10 @@ void CompressWriter::open(const S3Params& params) {
     S3_CHECK_OR_DIE(ret == Z_OK, S3RuntimeError,
                     string("Failed to initialize zlib library: ") + this->zstream.msg);
 
+    if (this->memberSize > 0) {
+        this->setMemberHeader();
+    }
+
     this->writer->open(params);
 }
 
@@ -76,36 +87,77 @@ uint64_t CompressWriter::write(const char* buf, uint64_t count) {
 
     uint64_t writtenLen = 0;
 
-    for (uint64_t i = 0; i < (count / S3_ZIP_COMPRESS_CHUNKSIZE); i++) {
-        writtenLen += this->writeOneChunk(buf + writtenLen, S3_ZIP_COMPRESS_CHUNKSIZE);
-    }
+    while (writtenLen < count) {
+        uint64_t len = std::min(count - writtenLen, S3_ZIP_COMPRESS_CHUNKSIZE);
+
+        // start a new gzip member when the current one has memberSize bytes of data.
+        if (this->memberSize > 0) {
+            if (this->memberInLen >= this->memberSize) {
+                this->finishMember();
+                deflateReset(&this->zstream);
+                this->setMemberHeader();
+            }
+            len = std::min(len, this->memberSize - this->memberInLen);
+        }
 
-    if (writtenLen < count) {
-        writtenLen += this->writeOneChunk(buf + writtenLen, count - writtenLen);
+        writtenLen += this->writeOneChunk(buf + writtenLen, len);
+        this->memberInLen += len;
     }
 
     return writtenLen;
 }
 
-void CompressWriter::close() {
-    if (this->isClosed) {
-        return;
-    }
-
+// Write the rest of compressed data and the trailer of current gzip member.
+void CompressWriter::finishMember() {
     int status;
     do {
         status = deflate(&this->zstream, Z_FINISH);
         this->flush();
     } while (status == Z_OK);
 
-    deflateEnd(&this->zstream);
-
     if (status != Z_STREAM_END) {
+        deflateEnd(&this->zstream);
         S3_CHECK_OR_DIE(false, S3RuntimeError,
                         string("Failed to compress data: ") +
                             std::to_string((unsigned long long)status) + ", " + this->zstream.msg);
     }
 
+    if (this->memberSize > 0) {
+        uint64_t size = this->member.size();
+        for (uint64_t i = 0; i < S3_GZIP_SIZE_SUBFIELD_LEN; i++) {
+            this->member[S3_GZIP_SIZE_OFFSET + i] = (char)(size >> (8 * i));
+        }
+
+        this->writer->write(this->member.data(), size);
+        this->member.clear();
+    }
+
+    this->memberInLen = 0;
+}
+
+// Let the gzip header of next member have the size subfield, filled in by finishMember().
+void CompressWriter::setMemberHeader() {
+    static const Byte extra[] = {S3_GZIP_SIZE_SUBFIELD_ID1, S3_GZIP_SIZE_SUBFIELD_ID2,
+                                 S3_GZIP_SIZE_SUBFIELD_LEN, 0, 0, 0, 0, 0};
+    memcpy(this->memberHeaderExtra, extra, sizeof(extra));
+
+    memset(&this->memberHeader, 0, sizeof(this->memberHeader));
+    this->memberHeader.extra = this->memberHeaderExtra;
+    this->memberHeader.extra_len = sizeof(extra);
+    this->memberHeader.os = 3;  // Unix, as zlib writes without a header set
+
+    int ret = deflateSetHeader(&this->zstream, &this->memberHeader);
+    S3_CHECK_OR_DIE(ret == Z_OK, S3RuntimeError, "Failed to set gzip header");
+}
+
+void CompressWriter::close() {
+    if (this->isClosed) {
+        return;
+    }
+
+    this->finishMember();
+    deflateEnd(&this->zstream);
+
     S3DEBUG("Compression finished: Z_STREAM_END.");
 
     this->writer->close();
@@ -118,7 +170,12 @@ void CompressWriter::setWriter(Writer* writer) {
 
 void CompressWriter::flush() {
     if (this->zstream.avail_out < S3_ZIP_COMPRESS_CHUNKSIZE) {
-        this->writer->write(this->out, S3_ZIP_COMPRESS_CHUNKSIZE - this->zstream.avail_out);
+        uint64_t len = S3_ZIP_COMPRESS_CHUNKSIZE - this->zstream.avail_out;
+        if (this->memberSize > 0) {
+            this->member.append(this->out, len);
+        } else {
+            this->writer->write(this->out, len);
+        }
         this->zstream.next_out = (Byte*)this->out;
         this->zstream.avail_out = S3_ZIP_COMPRESS_CHUNKSIZE;
     }
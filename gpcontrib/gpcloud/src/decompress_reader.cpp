@@ -2,7 +2,19 @@
 
 uint64_t S3_ZIP_DECOMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
 
-DecompressReader::DecompressReader() : isClosed(true) {
+// A gzip member starts with ID1, ID2 and CM (deflate), followed by FLG with its reserved bits
+// unset. Fewer bytes than that are accepted as long as they match.
+bool IsGzipMemberHead(const Byte *data, uint64_t len) {
+    static const Byte head[] = {0x1f, 0x8b, Z_DEFLATED};
+    for (uint64_t i = 0; i < len && i < sizeof(head); i++) {
+        if (data[i] != head[i]) {
+            return false;
+        }
+    }
+    return len <= sizeof(head) || (data[sizeof(head)] & 0xe0) == 0;
+}
+
+DecompressReader::DecompressReader() : isStreamEnd(false), isClosed(true) {
     this->reader = NULL;
     this->in = new char[S3_ZIP_DECOMPRESS_CHUNKSIZE];
     this->out = new char[S3_ZIP_DECOMPRESS_CHUNKSIZE];
@@ -42,6 +54,7 @@ void DecompressReader::open(const S3Params &params) {
     zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
 
     this->outOffset = 0;
+    this->isStreamEnd = false;
 
     // with S3_INFLATE_WINDOWSBITS, it could recognize and decode both zlib and gzip stream.
     int ret = inflateInit2(&zstream, S3_INFLATE_WINDOWSBITS);
@@ -55,8 +68,10 @@ void DecompressReader::open(const S3Params &params) {
 uint64_t DecompressReader::read(char *buf, uint64_t bufSize) {
     uint64_t remainingOutLen = this->getDecompressedBytesNum() - this->outOffset;
 
-    if (remainingOutLen == 0) {
-        this->decompress();
+    // a member may end without output, e.g. an empty one, go on until output or EOF.
+    bool hasMore = true;
+    while (remainingOutLen == 0 && hasMore) {
+        hasMore = this->decompress();
         this->outOffset = 0;  // reset cursor for out buffer to read from beginning.
         remainingOutLen = this->getDecompressedBytesNum();
     }
@@ -70,8 +85,9 @@ uint64_t DecompressReader::read(char *buf, uint64_t bufSize) {
 }
 
 // Read compressed data from underlying reader and decompress to this->out buffer.
-// If no more data to consume, this->zstream.avail_out == S3_ZIP_DECOMPRESS_CHUNKSIZE;
-void DecompressReader::decompress() {
+// If no more data to consume, this->zstream.avail_out == S3_ZIP_DECOMPRESS_CHUNKSIZE and return
+// false.
+bool DecompressReader::decompress() {
     if (this->zstream.avail_in == 0) {
         this->zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
         this->zstream.next_out = (Byte *)this->out;
@@ -88,7 +104,7 @@ void DecompressReader::decompress() {
                 "total_out = %u",
                 zstream.avail_in, zstream.avail_out,
 		(unsigned int) zstream.total_in, (unsigned int) zstream.total_out);
-            return;
+            return false;
         }
 
         // Fill this->in as possible as it could, otherwise data in this->in might not be able to be
@@ -112,15 +128,32 @@ void DecompressReader::decompress() {
         this->zstream.next_out = (Byte *)this->out;
     }
 
+    // A gzip file may consist of several members, e.g. written by 'cat a.gz b.gz' or by
+    // CompressWriter with compress_member_size, decompress them one after another.
+    if (this->isStreamEnd) {
+        if (!IsGzipMemberHead(this->zstream.next_in, this->zstream.avail_in)) {
+            S3WARN("Ignored %u bytes of trailing data after compressed stream",
+                   this->zstream.avail_in);
+            this->zstream.avail_in = 0;
+            return false;
+        }
+
+        inflateReset(&this->zstream);
+        this->isStreamEnd = false;
+    }
+
     int status = inflate(&this->zstream, Z_NO_FLUSH);
     if (status == Z_STREAM_END) {
         S3DEBUG("Decompression finished: Z_STREAM_END.");
+        this->isStreamEnd = true;
     } else if (status < 0 || status == Z_NEED_DICT) {
         inflateEnd(&this->zstream);
         S3_CHECK_OR_DIE(
             false, S3RuntimeError,
             string("Failed to decompress data: ") + std::to_string((unsigned long long)status));
     }
+
+    return true;
 }
 
 void DecompressReader::close() {
@@ -13,15 +13,27 @@ extern "C" {
 
 #include "access/external.h"
 #include "access/extprotocol.h"
+#include "access/formatter.h"
+#include "access/stratnum.h"
 #include "access/xact.h"
+#include "catalog/pg_am.h"
 #include "catalog/pg_proc.h"
+#include "catalog/pg_type.h"
 #include "commands/defrem.h"
+#include "extaccess.h"
 #include "fmgr.h"
 #include "funcapi.h"
+#include "mb/pg_wchar.h"
+#include "optimizer/optimizer.h"
+#include "parser/parse_func.h"
 #include "utils/array.h"
 #include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/guc.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/resowner.h"
+#include "utils/timestamp.h"
 
 #ifdef __clang__
 #pragma clang diagnostic pop
@@ -31,9 +43,11 @@ extern "C" {
 PG_MODULE_MAGIC;
 PG_FUNCTION_INFO_V1(s3_export);
 PG_FUNCTION_INFO_V1(s3_import);
+PG_FUNCTION_INFO_V1(gpcloud_parquet_import);
 
 Datum s3_export(PG_FUNCTION_ARGS);
 Datum s3_import(PG_FUNCTION_ARGS);
+Datum gpcloud_parquet_import(PG_FUNCTION_ARGS);
 }
 
 #include "gpreader.h"
@@ -169,6 +183,248 @@ static void parseFormatOpts(FunctionCallInfo fcinfo) {
     }
 }
 
+/*
+ * Kind of the values of a column in the rows of ParquetReader, PARQUET_KIND_SKIP if the type
+ * can't be read from Parquet.
+ */
+static ParquetValueKind getParquetValueKind(Form_pg_attribute attr) {
+    switch (attr->atttypid) {
+        case BOOLOID:
+            return PARQUET_KIND_BOOL;
+        case INT2OID:
+            return PARQUET_KIND_INT16;
+        case INT4OID:
+            return PARQUET_KIND_INT32;
+        case INT8OID:
+            return PARQUET_KIND_INT64;
+        case FLOAT4OID:
+            return PARQUET_KIND_FLOAT4;
+        case FLOAT8OID:
+            return PARQUET_KIND_FLOAT8;
+        case TEXTOID:
+            return PARQUET_KIND_TEXT;
+        case VARCHAROID:
+            /* varchar(n) would need its length checked */
+            return (attr->atttypmod < 0) ? PARQUET_KIND_TEXT : PARQUET_KIND_SKIP;
+        case DATEOID:
+            return PARQUET_KIND_DATE;
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+            return PARQUET_KIND_TIMESTAMP;
+        default:
+            return PARQUET_KIND_SKIP;
+    }
+}
+
+/*
+ * Whether the formatter of table is gpcloud_parquet_import(), then keys are read as Parquet files.
+ */
+static bool isParquetFormat(FunctionCallInfo fcinfo) {
+    Relation rel = EXTPROTOCOL_GET_RELATION(fcinfo);
+    ExtTableEntry *exttbl = GetExtTableEntry(rel->rd_id);
+    ListCell *option;
+
+    if (!fmttype_is_custom(exttbl->fmtcode)) return false;
+
+    foreach (option, exttbl->options) {
+        DefElem *defel = (DefElem *)lfirst(option);
+
+        if (strcmp(defel->defname, "formatter") == 0) {
+            Oid argList[1];
+            Oid procOid = LookupFuncName(list_make1(makeString(defGetString(defel))), 0, argList,
+                                         true);
+            FmgrInfo finfo;
+
+            if (!OidIsValid(procOid)) return false;
+
+            fmgr_info(procOid, &finfo);
+            return finfo.fn_addr == gpcloud_parquet_import;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Mark the columns referenced in node. Whole-row references need all of them.
+ */
+static void collectNeededColumns(Node *node, vector<bool> &needed, bool &needAll) {
+    List *vars = pull_var_clause(
+        node, PVC_RECURSE_AGGREGATES | PVC_RECURSE_WINDOWFUNCS | PVC_RECURSE_PLACEHOLDERS);
+    ListCell *lc;
+
+    foreach (lc, vars) {
+        Var *var = (Var *)lfirst(lc);
+
+        if (var->varattno == 0) {
+            needAll = true;
+        } else if (var->varattno > 0 && (size_t)var->varattno <= needed.size()) {
+            needed[var->varattno - 1] = true;
+        }
+    }
+
+    list_free(vars);
+}
+
+/*
+ * Turn a "column op constant" qual into a ParquetQual, return false if it is of other forms or
+ * can't be checked with the statistics of Parquet.
+ */
+static bool getParquetQual(Expr *expr, const vector<ParquetTableColumn> &columns,
+                           ParquetQual &qual) {
+    if (!IsA(expr, OpExpr) || list_length(((OpExpr *)expr)->args) != 2) return false;
+
+    OpExpr *opexpr = (OpExpr *)expr;
+    Node *left = (Node *)linitial(opexpr->args);
+    Node *right = (Node *)lsecond(opexpr->args);
+    bool commuted = false;
+
+    while (IsA(left, RelabelType)) left = (Node *)((RelabelType *)left)->arg;
+    while (IsA(right, RelabelType)) right = (Node *)((RelabelType *)right)->arg;
+
+    if (IsA(left, Const) && IsA(right, Var)) {
+        std::swap(left, right);
+        commuted = true;
+    }
+
+    if (!IsA(left, Var) || !IsA(right, Const)) return false;
+
+    Var *var = (Var *)left;
+    Const *con = (Const *)right;
+
+    if (var->varlevelsup != 0 || var->varattno <= 0 || (size_t)var->varattno > columns.size() ||
+        con->constisnull)
+        return false;
+
+    Oid opclass = GetDefaultOpClass(var->vartype, BTREE_AM_OID);
+    if (!OidIsValid(opclass)) return false;
+
+    switch (get_op_opfamily_strategy(opexpr->opno, get_opclass_family(opclass))) {
+        case BTLessStrategyNumber:
+            qual.op = commuted ? PARQUET_QUAL_GT : PARQUET_QUAL_LT;
+            break;
+        case BTLessEqualStrategyNumber:
+            qual.op = commuted ? PARQUET_QUAL_GE : PARQUET_QUAL_LE;
+            break;
+        case BTEqualStrategyNumber:
+            qual.op = PARQUET_QUAL_EQ;
+            break;
+        case BTGreaterEqualStrategyNumber:
+            qual.op = commuted ? PARQUET_QUAL_LE : PARQUET_QUAL_GE;
+            break;
+        case BTGreaterStrategyNumber:
+            qual.op = commuted ? PARQUET_QUAL_LT : PARQUET_QUAL_GT;
+            break;
+        default:
+            return false;
+    }
+
+    qual.column = var->varattno - 1;
+
+    switch (columns[qual.column].kind) {
+        case PARQUET_KIND_INT16:
+        case PARQUET_KIND_INT32:
+        case PARQUET_KIND_INT64:
+            if (con->consttype == INT2OID)
+                qual.intValue = DatumGetInt16(con->constvalue);
+            else if (con->consttype == INT4OID)
+                qual.intValue = DatumGetInt32(con->constvalue);
+            else if (con->consttype == INT8OID)
+                qual.intValue = DatumGetInt64(con->constvalue);
+            else
+                return false;
+            return true;
+
+        case PARQUET_KIND_FLOAT4:
+        case PARQUET_KIND_FLOAT8:
+            if (con->consttype == FLOAT4OID)
+                qual.floatValue = DatumGetFloat4(con->constvalue);
+            else if (con->consttype == FLOAT8OID)
+                qual.floatValue = DatumGetFloat8(con->constvalue);
+            else
+                return false;
+            return true;
+
+        case PARQUET_KIND_TEXT: {
+            /* statistics are compared byte by byte, which is right only for equality */
+            if (qual.op != PARQUET_QUAL_EQ || GetDatabaseEncoding() != PG_UTF8 ||
+                (con->consttype != TEXTOID && con->consttype != VARCHAROID) ||
+                (OidIsValid(opexpr->inputcollid) &&
+                 !get_collation_isdeterministic(opexpr->inputcollid)))
+                return false;
+
+            text *value = DatumGetTextPP(con->constvalue);
+            qual.textValue.assign(VARDATA_ANY(value), VARSIZE_ANY_EXHDR(value));
+            return true;
+        }
+
+        case PARQUET_KIND_DATE:
+            if (con->consttype != DATEOID) return false;
+            qual.intValue = DatumGetDateADT(con->constvalue);
+            return true;
+
+        case PARQUET_KIND_TIMESTAMP:
+            if (con->consttype != var->vartype) return false;
+            qual.intValue = DatumGetTimestamp(con->constvalue);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/*
+ * Build the scan of ParquetReader from the table: its columns, those needed by the query, and
+ * the quals pushed down to prune row groups.
+ */
+static void buildParquetScanDesc(FunctionCallInfo fcinfo, ParquetScanDesc &scanDesc) {
+    Relation rel = EXTPROTOCOL_GET_RELATION(fcinfo);
+    TupleDesc tupdesc = RelationGetDescr(rel);
+    ExternalSelectDesc desc = EXTPROTOCOL_GET_EXTERNAL_SELECT_DESC(fcinfo);
+    ListCell *lc;
+
+    for (int i = 0; i < tupdesc->natts; i++) {
+        Form_pg_attribute attr = TupleDescAttr(tupdesc, i);
+
+        if (!attr->attisdropped && getParquetValueKind(attr) == PARQUET_KIND_SKIP)
+            ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                            errmsg("type %s of column \"%s\" is not supported by "
+                                   "gpcloud_parquet_import",
+                                   format_type_be(attr->atttypid), NameStr(attr->attname))));
+    }
+
+    vector<bool> needed(tupdesc->natts, false);
+    bool needAll = true;
+
+    /* columns only referenced by quals are unknown, unless the quals are pushed down */
+    if (desc != NULL && desc->projInfo != NULL && gp_external_enable_filter_pushdown) {
+        needAll = false;
+        collectNeededColumns((Node *)desc->projInfo->pi_state.expr, needed, needAll);
+        collectNeededColumns((Node *)desc->filter_quals, needed, needAll);
+    }
+
+    for (int i = 0; i < tupdesc->natts; i++) {
+        Form_pg_attribute attr = TupleDescAttr(tupdesc, i);
+        ParquetValueKind kind = PARQUET_KIND_SKIP;
+
+        if (!attr->attisdropped && (needAll || needed[i])) {
+            kind = getParquetValueKind(attr);
+        }
+
+        scanDesc.columns.push_back(ParquetTableColumn(NameStr(attr->attname), kind));
+    }
+
+    if (desc != NULL) {
+        foreach (lc, desc->filter_quals) {
+            ParquetQual qual;
+
+            if (getParquetQual((Expr *)lfirst(lc), scanDesc.columns, qual)) {
+                scanDesc.quals.push_back(qual);
+            }
+        }
+    }
+}
+
 typedef struct gpcloudResHandle {
     GPReader *gpreader;
     GPWriter *gpwriter;
@@ -292,9 +548,19 @@ Datum s3_import(PG_FUNCTION_ARGS) {
         // has HEADER? and newline EOL?
         parseFormatOpts(fcinfo);
 
+        bool isParquet = isParquetFormat(fcinfo);
+        ParquetScanDesc parquetScanDesc;
+        if (isParquet) {
+            buildParquetScanDesc(fcinfo, parquetScanDesc);
+        }
+
         thread_setup();
 
-        resHandle->gpreader = reader_init(url_with_options);
+        // a newline may be quoted in CSV, so only text can be read from the middle of a key
+        bool splitKeys = strcmp(getFormatStr(fcinfo), "txt") == 0;
+
+        resHandle->gpreader =
+            reader_init(url_with_options, isParquet ? &parquetScanDesc : NULL, splitKeys);
         if (!resHandle->gpreader) {
             ereport(ERROR, errmsg("Failed to init gpcloud extension (segid = %d, "
 				  "segnum = %d), please check your "
@@ -370,3 +636,113 @@ Datum s3_export(PG_FUNCTION_ARGS) {
 
     PG_RETURN_INT32(data_len);
 }
+
+/*
+ * Form tuples out of the rows of ParquetReader, see parquet_reader.h for their format. Values are
+ * already in their binary form, no input functions are called.
+ */
+Datum gpcloud_parquet_import(PG_FUNCTION_ARGS) {
+    /* Must be called via the external table format manager */
+    if (!CALLED_AS_FORMATTER(fcinfo))
+        elog(ERROR, "gpcloud_parquet_import: not called by format manager");
+
+    TupleDesc tupdesc = FORMATTER_GET_TUPDESC(fcinfo);
+    char *data_buf = FORMATTER_GET_DATABUF(fcinfo);
+    int data_len = FORMATTER_GET_DATALEN(fcinfo);
+    int data_cur = FORMATTER_GET_DATACURSOR(fcinfo);
+    uint32 row_len;
+
+    /* wait for a whole row */
+    if (data_len - data_cur < (int)sizeof(row_len))
+        FORMATTER_RETURN_NOTIFICATION(fcinfo, FMT_NEED_MORE_DATA);
+
+    memcpy(&row_len, data_buf + data_cur, sizeof(row_len));
+    if ((uint32)(data_len - data_cur) - sizeof(row_len) < row_len)
+        FORMATTER_RETURN_NOTIFICATION(fcinfo, FMT_NEED_MORE_DATA);
+
+    FORMATTER_SET_BAD_ROW_DATA(fcinfo, data_buf + data_cur, sizeof(row_len) + row_len);
+
+    MemoryContext oldcontext = MemoryContextSwitchTo(FORMATTER_GET_PER_ROW_MEM_CTX(fcinfo));
+
+    Datum *values = (Datum *)palloc(sizeof(Datum) * tupdesc->natts);
+    bool *nulls = (bool *)palloc(sizeof(bool) * tupdesc->natts);
+    char *p = data_buf + data_cur + sizeof(row_len);
+    char *end = p + row_len;
+
+    for (int i = 0; i < tupdesc->natts; i++) {
+        Form_pg_attribute attr = TupleDescAttr(tupdesc, i);
+
+        if (p >= end) elog(ERROR, "gpcloud_parquet_import: row is truncated");
+
+        nulls[i] = (*p++ != 0);
+        values[i] = (Datum)0;
+        if (nulls[i]) continue;
+
+        switch (attr->attisdropped ? PARQUET_KIND_SKIP : getParquetValueKind(attr)) {
+            case PARQUET_KIND_BOOL:
+                values[i] = BoolGetDatum(*p != 0);
+                p += 1;
+                break;
+            case PARQUET_KIND_INT16: {
+                int16 value;
+                memcpy(&value, p, sizeof(value));
+                values[i] = Int16GetDatum(value);
+                p += sizeof(value);
+                break;
+            }
+            case PARQUET_KIND_INT32:
+            case PARQUET_KIND_DATE: {
+                int32 value;
+                memcpy(&value, p, sizeof(value));
+                values[i] = Int32GetDatum(value);
+                p += sizeof(value);
+                break;
+            }
+            case PARQUET_KIND_INT64:
+            case PARQUET_KIND_TIMESTAMP: {
+                int64 value;
+                memcpy(&value, p, sizeof(value));
+                values[i] = Int64GetDatum(value);
+                p += sizeof(value);
+                break;
+            }
+            case PARQUET_KIND_FLOAT4: {
+                float4 value;
+                memcpy(&value, p, sizeof(value));
+                values[i] = Float4GetDatum(value);
+                p += sizeof(value);
+                break;
+            }
+            case PARQUET_KIND_FLOAT8: {
+                float8 value;
+                memcpy(&value, p, sizeof(value));
+                values[i] = Float8GetDatum(value);
+                p += sizeof(value);
+                break;
+            }
+            case PARQUET_KIND_TEXT: {
+                uint32 len;
+                memcpy(&len, p, sizeof(len));
+                p += sizeof(len);
+
+                /* strings of Parquet are UTF-8 */
+                char *cvt = pg_any_to_server(p, len, PG_UTF8);
+                values[i] = PointerGetDatum(
+                    cstring_to_text_with_len(cvt, (cvt == p) ? (int)len : (int)strlen(cvt)));
+                p += len;
+                break;
+            }
+            default:
+                elog(ERROR, "gpcloud_parquet_import: unsupported type of column \"%s\"",
+                     NameStr(attr->attname));
+        }
+    }
+
+    MemoryContextSwitchTo(oldcontext);
+
+    FORMATTER_SET_DATACURSOR(fcinfo, data_cur + sizeof(row_len) + row_len);
+
+    HeapTuple tuple = heap_form_tuple(tupdesc, values, nulls);
+    FORMATTER_SET_TUPLE(fcinfo, tuple);
+    FORMATTER_RETURN_TUPLE(tuple);
+}
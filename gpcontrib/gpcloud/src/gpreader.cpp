@@ -59,15 +59,25 @@ int thread_cleanup(void) {
 }
 
 GPReader::GPReader(const S3Params& params)
-    : params(params), restfulService(this->params), s3InterfaceService(this->params) {
+    : params(params),
+      isParquet(false),
+      splitKeys(false),
+      restfulService(this->params),
+      s3InterfaceService(this->params) {
     restfulServicePtr = &restfulService;
 }
 
 void GPReader::open(const S3Params& params) {
     this->s3InterfaceService.setRESTfulService(this->restfulServicePtr);
     this->bucketReader.setS3InterfaceService(&this->s3InterfaceService);
-    this->bucketReader.setUpstreamReader(&this->commonReader);
-    this->commonReader.setS3InterfaceService(&this->s3InterfaceService);
+    this->bucketReader.setSplitKeys(this->splitKeys && !this->isParquet);
+    if (this->isParquet) {
+        this->bucketReader.setUpstreamReader(&this->parquetReader);
+        this->parquetReader.setS3InterfaceService(&this->s3InterfaceService);
+    } else {
+        this->bucketReader.setUpstreamReader(&this->commonReader);
+        this->commonReader.setS3InterfaceService(&this->s3InterfaceService);
+    }
     this->bucketReader.open(this->params);
 }
 
@@ -83,7 +93,8 @@ void GPReader::close() {
 }
 
 // invoked by s3_import(), need to be exception safe
-GPReader* reader_init(const char* url_with_options) {
+GPReader* reader_init(const char* url_with_options, const ParquetScanDesc* parquetScanDesc,
+                      bool splitKeys) {
     GPReader* reader = NULL;
     s3extErrorMessage.clear();
 
@@ -106,6 +117,11 @@ GPReader* reader_init(const char* url_with_options) {
             return NULL;
         }
 
+        if (parquetScanDesc != NULL) {
+            reader->setParquetScanDesc(*parquetScanDesc);
+        }
+        reader->setSplitKeys(splitKeys);
+
         reader->open(params);
         return reader;
     } catch (S3Exception& e) {
@@ -0,0 +1,599 @@
+#include "parallel_decompress_reader.h"
+
+// windowBits for gzip decoding only, a member is never in zlib format.
+#define S3_GZIP_INFLATE_WINDOWSBITS (MAX_WBITS + 16)
+
+// A gzip member header is ID1, ID2, CM, FLG, MTIME (4 bytes), XFL and OS. With FEXTRA in FLG, it
+// is followed by XLEN (2 bytes) and XLEN bytes of subfields, each is SI1, SI2, LEN (2 bytes) and
+// LEN bytes of data. The member ends with CRC32 and ISIZE (4 bytes each).
+#define S3_GZIP_HEADER_LEN 10
+#define S3_GZIP_FLG_FEXTRA 0x04
+#define S3_GZIP_TRAILER_LEN 8
+
+#define S3_BGZF_SUBFIELD_ID1 'B'
+#define S3_BGZF_SUBFIELD_ID2 'C'
+#define S3_BGZF_SUBFIELD_LEN 2
+
+static uint64_t GetLittleEndian(const Byte *data, uint64_t len) {
+    uint64_t value = 0;
+    for (uint64_t i = len; i > 0; i--) {
+        value = (value << 8) | data[i - 1];
+    }
+    return value;
+}
+
+uint64_t GetGzipMemberSize(const Byte *data, uint64_t len) {
+    if (len < S3_GZIP_HEADER_LEN + 2 || !IsGzipMemberHead(data, len) ||
+        !(data[3] & S3_GZIP_FLG_FEXTRA)) {
+        return 0;
+    }
+
+    uint64_t extraEnd = S3_GZIP_HEADER_LEN + 2 + GetLittleEndian(data + S3_GZIP_HEADER_LEN, 2);
+    if (len < extraEnd) {
+        return 0;
+    }
+
+    for (uint64_t p = S3_GZIP_HEADER_LEN + 2; p + 4 <= extraEnd;) {
+        uint64_t subLen = GetLittleEndian(data + p + 2, 2);
+        if (p + 4 + subLen > extraEnd) {
+            break;
+        }
+
+        if (data[p] == S3_GZIP_SIZE_SUBFIELD_ID1 && data[p + 1] == S3_GZIP_SIZE_SUBFIELD_ID2 &&
+            subLen == S3_GZIP_SIZE_SUBFIELD_LEN) {
+            return GetLittleEndian(data + p + 4, subLen);
+        }
+
+        // BSIZE of BGZF is the member size minus 1.
+        if (data[p] == S3_BGZF_SUBFIELD_ID1 && data[p + 1] == S3_BGZF_SUBFIELD_ID2 &&
+            subLen == S3_BGZF_SUBFIELD_LEN) {
+            return GetLittleEndian(data + p + 4, subLen) + 1;
+        }
+
+        p += 4 + subLen;
+    }
+
+    return 0;
+}
+
+uint64_t PrefixedReader::read(char *buf, uint64_t count) {
+    if (this->offset < this->prefix.size()) {
+        uint64_t len = std::min(this->prefix.size() - this->offset, count);
+        memcpy(buf, this->prefix.data() + this->offset, len);
+        this->offset += len;
+        return len;
+    }
+
+    return this->reader->read(buf, count);
+}
+
+static void *DecompressWorkerThreadFunc(void *data) {
+    MaskThreadSignals();
+
+    static_cast<ParallelDecompressReader *>(data)->runWorker();
+
+    return NULL;
+}
+
+ParallelDecompressReader::ParallelDecompressReader()
+    : reader(NULL),
+      compressionType(S3_COMPRESSION_GZIP),
+      numOfThreads(1),
+      batchSize(0),
+      memberOutputLimit(0),
+      isInputEOF(false),
+      outputIndex(0),
+      outputOffset(0),
+      isStreaming(false),
+      isFallback(false),
+      batch(NULL),
+      nextMember(0),
+      doneMembers(0),
+      isStopping(false),
+      isClosed(true) {
+    memset(&this->zstream, 0, sizeof(this->zstream));
+#ifdef HAVE_LIBZSTD
+    this->zstdStream = NULL;
+    memset(&this->zstdIn, 0, sizeof(this->zstdIn));
+#endif
+
+    pthread_mutex_init(&this->poolMutex, NULL);
+    pthread_cond_init(&this->memberCond, NULL);
+    pthread_cond_init(&this->batchCond, NULL);
+}
+
+ParallelDecompressReader::~ParallelDecompressReader() {
+    this->close();
+    this->stopWorkers();
+
+#ifdef HAVE_LIBZSTD
+    if (this->zstdStream != NULL) {
+        ZSTD_freeDStream(this->zstdStream);
+    }
+#endif
+
+    pthread_cond_destroy(&this->batchCond);
+    pthread_cond_destroy(&this->memberCond);
+    pthread_mutex_destroy(&this->poolMutex);
+}
+
+void ParallelDecompressReader::open(const S3Params &params) {
+    this->params = params;
+
+    this->numOfThreads = std::max(params.getNumOfChunks(), (uint64_t)1);
+    this->batchSize = this->numOfThreads * 2 * S3_ZIP_DECOMPRESS_CHUNKSIZE;
+    this->memberOutputLimit = 4 * S3_ZIP_DECOMPRESS_CHUNKSIZE;
+
+    this->input.clear();
+    this->isInputEOF = false;
+    this->outputs.clear();
+    this->outputIndex = 0;
+    this->outputOffset = 0;
+    this->isStreaming = false;
+    this->isFallback = false;
+
+    // the calling thread decompresses members too if there is only one thread.
+    uint64_t numOfWorkers = this->numOfThreads > 1 ? this->numOfThreads : 0;
+    if (this->workers.size() != numOfWorkers) {
+        this->stopWorkers();
+        this->startWorkers(numOfWorkers);
+    }
+
+    this->isClosed = false;
+
+    this->reader->open(params);
+}
+
+uint64_t ParallelDecompressReader::read(char *buf, uint64_t count) {
+    while (true) {
+        if (this->outputIndex < this->outputs.size()) {
+            if (this->outputOffset < this->outputs[this->outputIndex].size()) {
+                break;
+            }
+
+            this->outputIndex++;
+            this->outputOffset = 0;
+            continue;
+        }
+
+        this->outputs.clear();
+        this->outputIndex = 0;
+        this->outputOffset = 0;
+
+        if (this->isStreaming) {
+            this->decompressStream();
+        } else if (this->isFallback) {
+            return this->decompressReader.read(buf, count);
+        } else if (!this->decompressBatch()) {
+            return 0;
+        }
+    }
+
+    const string &output = this->outputs[this->outputIndex];
+    uint64_t len = std::min(output.size() - this->outputOffset, count);
+    memcpy(buf, output.data() + this->outputOffset, len);
+    this->outputOffset += len;
+
+    return len;
+}
+
+void ParallelDecompressReader::startWorkers(uint64_t num) {
+    this->isStopping = false;
+
+    for (uint64_t i = 0; i < num; i++) {
+        pthread_t thread;
+        int ret = pthread_create(&thread, NULL, DecompressWorkerThreadFunc, this);
+        if (ret != 0) {
+            this->stopWorkers();
+            S3_DIE(S3RuntimeError, "Failed to create decompression thread: " + std::to_string(ret));
+        }
+        this->workers.push_back(thread);
+    }
+}
+
+void ParallelDecompressReader::stopWorkers() {
+    pthread_mutex_lock(&this->poolMutex);
+    this->isStopping = true;
+    pthread_cond_broadcast(&this->memberCond);
+    pthread_mutex_unlock(&this->poolMutex);
+
+    for (uint64_t i = 0; i < this->workers.size(); i++) {
+        pthread_join(this->workers[i], NULL);
+    }
+    this->workers.clear();
+}
+
+void ParallelDecompressReader::runWorker() {
+    pthread_mutex_lock(&this->poolMutex);
+
+    while (true) {
+        while (!this->isStopping &&
+               (this->batch == NULL || this->nextMember >= this->batch->size())) {
+            pthread_cond_wait(&this->memberCond, &this->poolMutex);
+        }
+
+        if (this->isStopping) {
+            break;
+        }
+
+        CompressedMember &member = (*this->batch)[this->nextMember++];
+
+        pthread_mutex_unlock(&this->poolMutex);
+        this->decompressMember(member);
+        pthread_mutex_lock(&this->poolMutex);
+
+        if (++this->doneMembers == this->batch->size()) {
+            pthread_cond_signal(&this->batchCond);
+        }
+    }
+
+    pthread_mutex_unlock(&this->poolMutex);
+}
+
+// Decompress a member of input into member.data, which is outputSize bytes if it is Complete.
+void ParallelDecompressReader::decompressMember(CompressedMember &member) {
+    const Byte *data = (const Byte *)this->input.data() + member.offset;
+    member.status = CompressedMember::Invalid;
+
+#ifdef HAVE_LIBZSTD
+    if (this->compressionType == S3_COMPRESSION_ZSTD) {
+        member.data.resize(member.outputSize);
+
+        size_t ret = ZSTD_decompress(&member.data[0], member.outputSize, data, member.size);
+        if (!ZSTD_isError(ret) && ret == member.outputSize) {
+            member.status = CompressedMember::Complete;
+        }
+        return;
+    }
+#endif
+
+    z_stream zstream;
+    memset(&zstream, 0, sizeof(zstream));
+
+    if (inflateInit2(&zstream, S3_GZIP_INFLATE_WINDOWSBITS) != Z_OK) {
+        return;
+    }
+
+    // one more byte to tell a member with more output than outputSize.
+    member.data.resize(member.outputSize + 1);
+
+    zstream.next_in = (Byte *)data;
+    zstream.avail_in = member.size;
+    zstream.next_out = (Byte *)&member.data[0];
+    zstream.avail_out = member.data.size();
+
+    // inflate() checks CRC32 and ISIZE of the trailer.
+    int status = inflate(&zstream, Z_FINISH);
+    if (zstream.total_out > member.outputSize) {
+        member.status = CompressedMember::TooLarge;
+    } else if (status == Z_STREAM_END && zstream.avail_in == 0) {
+        member.status = CompressedMember::Complete;
+    }
+
+    member.data.resize(zstream.total_out);
+    inflateEnd(&zstream);
+}
+
+// Decompress members by the workers, input must not change until they are done.
+void ParallelDecompressReader::decompressMembers(vector<CompressedMember> &members) {
+    if (this->workers.empty()) {
+        for (uint64_t i = 0; i < members.size(); i++) {
+            this->decompressMember(members[i]);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&this->poolMutex);
+
+    this->batch = &members;
+    this->nextMember = 0;
+    this->doneMembers = 0;
+    pthread_cond_broadcast(&this->memberCond);
+
+    while (this->doneMembers < members.size()) {
+        pthread_cond_wait(&this->batchCond, &this->poolMutex);
+    }
+    this->batch = NULL;
+
+    pthread_mutex_unlock(&this->poolMutex);
+}
+
+// Read from underlying reader until input has batchSize bytes or reaches EOF.
+void ParallelDecompressReader::fillInput() {
+    while (!this->isInputEOF && this->input.size() < this->batchSize) {
+        uint64_t offset = this->input.size();
+        this->input.resize(this->batchSize);
+
+        uint64_t hasRead = this->reader->read(&this->input[offset], this->batchSize - offset);
+        this->input.resize(offset + hasRead);
+
+        if (hasRead == 0) {
+            this->isInputEOF = true;
+        }
+    }
+}
+
+// Tell the member at offset of input. offset, size and outputSize of member are set for
+// MemberInBatch.
+ParallelDecompressReader::MemberLayout ParallelDecompressReader::findMember(
+    uint64_t offset, CompressedMember &member) {
+    const Byte *data = (const Byte *)this->input.data() + offset;
+    uint64_t len = this->input.size() - offset;
+
+    member.offset = offset;
+    member.status = CompressedMember::Pending;
+
+#ifdef HAVE_LIBZSTD
+    if (this->compressionType == S3_COMPRESSION_ZSTD) {
+        if (len < 4) {
+            return len > 0 && !this->isInputEOF ? MemberInStream : MemberNone;
+        }
+
+        uint64_t magic = GetLittleEndian(data, 4);
+        if (magic != ZSTD_MAGICNUMBER &&
+            (magic & ZSTD_MAGIC_SKIPPABLE_MASK) != ZSTD_MAGIC_SKIPPABLE_START) {
+            return MemberNone;
+        }
+
+        // an incomplete or corrupted frame fails, decompressing it as a stream tells which.
+        size_t size = ZSTD_findFrameCompressedSize(data, len);
+        if (ZSTD_isError(size)) {
+            return MemberInStream;
+        }
+
+        // 0 for a skippable frame.
+        unsigned long long outputSize = ZSTD_getFrameContentSize(data, len);
+        if (outputSize == ZSTD_CONTENTSIZE_UNKNOWN || outputSize == ZSTD_CONTENTSIZE_ERROR ||
+            outputSize > this->memberOutputLimit) {
+            return MemberInStream;
+        }
+
+        member.size = size;
+        member.outputSize = outputSize;
+        return MemberInBatch;
+    }
+#endif
+
+    if (len == 0 || !IsGzipMemberHead(data, len)) {
+        return MemberNone;
+    }
+
+    uint64_t size = GetGzipMemberSize(data, len);
+    if (size == 0) {
+        return MemberUnsized;
+    }
+
+    if (size < S3_GZIP_HEADER_LEN + S3_GZIP_TRAILER_LEN || size > len) {
+        return MemberInStream;
+    }
+
+    uint64_t outputSize = GetLittleEndian(data + size - 4, 4);
+    if (outputSize > this->memberOutputLimit) {
+        return MemberInStream;
+    }
+
+    member.size = size;
+    member.outputSize = outputSize;
+    return MemberInBatch;
+}
+
+// Decompress the members at the start of input in parallel and put their data into outputs, up to
+// numOfThreads * memberOutputLimit bytes. Return false if no more data to decompress.
+bool ParallelDecompressReader::decompressBatch() {
+    this->fillInput();
+
+    if (this->input.empty()) {
+        return false;
+    }
+
+    vector<CompressedMember> members;
+    uint64_t outputLimit = this->numOfThreads * this->memberOutputLimit;
+    uint64_t outputSize = 0;
+    uint64_t cur = 0;
+
+    MemberLayout layout;
+    while (true) {
+        members.emplace_back();
+        layout = this->findMember(cur, members.back());
+
+        if (layout != MemberInBatch ||
+            (members.size() > 1 && outputSize + members.back().outputSize > outputLimit)) {
+            members.pop_back();
+            break;
+        }
+
+        outputSize += members.back().outputSize;
+        cur += members.back().size;
+    }
+
+    // the first member is not for the workers, the members after it are left to next batch.
+    if (members.empty()) {
+        switch (layout) {
+            case MemberInStream:
+                this->startStream();
+                return true;
+            case MemberUnsized:
+                this->fallback();
+                return true;
+            default:
+                S3WARN("Ignored %" PRIu64 " bytes of trailing data after compressed stream",
+                       (uint64_t)this->input.size());
+                this->input.clear();
+                this->isInputEOF = true;
+                return false;
+        }
+    }
+
+    this->decompressMembers(members);
+
+    for (uint64_t i = 0; i < members.size(); i++) {
+        CompressedMember &member = members[i];
+
+        if (member.status != CompressedMember::Complete) {
+            this->input.erase(0, member.offset);
+
+            // the member size might not be what its header tells, let DecompressReader tell
+            // whether the data is corrupted.
+            if (this->compressionType == S3_COMPRESSION_GZIP &&
+                member.status == CompressedMember::Invalid) {
+                this->fallback();
+            } else {
+                this->startStream();
+            }
+            return true;
+        }
+
+        this->outputs.emplace_back();
+        this->outputs.back().swap(member.data);
+    }
+
+    this->input.erase(0, cur);
+    return true;
+}
+
+// Start to decompress the member at the start of input as a stream.
+void ParallelDecompressReader::startStream() {
+#ifdef HAVE_LIBZSTD
+    if (this->compressionType == S3_COMPRESSION_ZSTD) {
+        if (this->zstdStream == NULL) {
+            this->zstdStream = ZSTD_createDStream();
+            S3_CHECK_OR_DIE(this->zstdStream != NULL, S3RuntimeError,
+                            "failed to initialize zstd library");
+        }
+
+        size_t ret = ZSTD_initDStream(this->zstdStream);
+        S3_CHECK_OR_DIE(!ZSTD_isError(ret), S3RuntimeError, "failed to initialize zstd library");
+
+        this->zstdIn.src = this->input.data();
+        this->zstdIn.size = this->input.size();
+        this->zstdIn.pos = 0;
+
+        this->isStreaming = true;
+        return;
+    }
+#endif
+
+    memset(&this->zstream, 0, sizeof(this->zstream));
+    int ret = inflateInit2(&this->zstream, S3_GZIP_INFLATE_WINDOWSBITS);
+    S3_CHECK_OR_DIE(ret == Z_OK, S3RuntimeError, "failed to initialize zlib library");
+
+    this->zstream.next_in = (Byte *)this->input.data();
+    this->zstream.avail_in = this->input.size();
+
+    this->isStreaming = true;
+}
+
+// Decompress a chunk of the member started in startStream(), the rest of input after its end is
+// left for the next batch.
+void ParallelDecompressReader::decompressStream() {
+    uint64_t availIn = this->zstream.avail_in;
+#ifdef HAVE_LIBZSTD
+    if (this->compressionType == S3_COMPRESSION_ZSTD) {
+        availIn = this->zstdIn.size - this->zstdIn.pos;
+    }
+#endif
+
+    if (availIn == 0 && !this->isInputEOF) {
+        this->input.resize(S3_ZIP_DECOMPRESS_CHUNKSIZE);
+        uint64_t hasRead = this->reader->read(&this->input[0], S3_ZIP_DECOMPRESS_CHUNKSIZE);
+        this->input.resize(hasRead);
+
+        this->isInputEOF = (hasRead == 0);
+
+        this->zstream.next_in = (Byte *)this->input.data();
+        this->zstream.avail_in = hasRead;
+#ifdef HAVE_LIBZSTD
+        this->zstdIn.src = this->input.data();
+        this->zstdIn.size = hasRead;
+        this->zstdIn.pos = 0;
+#endif
+    }
+
+    this->outputs.emplace_back(S3_ZIP_DECOMPRESS_CHUNKSIZE, '\0');
+    string &output = this->outputs.back();
+
+    bool isMemberEnd = false;
+
+#ifdef HAVE_LIBZSTD
+    if (this->compressionType == S3_COMPRESSION_ZSTD) {
+        ZSTD_outBuffer out = {&output[0], output.size(), 0};
+
+        size_t ret = ZSTD_decompressStream(this->zstdStream, &out, &this->zstdIn);
+        output.resize(out.pos);
+
+        if (ZSTD_isError(ret)) {
+            this->isStreaming = false;
+            S3_CHECK_OR_DIE(false, S3RuntimeError,
+                            string("Failed to decompress data: ") + ZSTD_getErrorName(ret));
+        }
+
+        isMemberEnd = (ret == 0);
+        availIn = this->zstdIn.size - this->zstdIn.pos;
+    } else
+#endif
+    {
+        this->zstream.next_out = (Byte *)&output[0];
+        this->zstream.avail_out = output.size();
+
+        int status = inflate(&this->zstream, Z_NO_FLUSH);
+        output.resize(output.size() - this->zstream.avail_out);
+
+        if ((status < 0 && status != Z_BUF_ERROR) || status == Z_NEED_DICT) {
+            this->endStream();
+            S3_CHECK_OR_DIE(
+                false, S3RuntimeError,
+                string("Failed to decompress data: ") + std::to_string((unsigned long long)status));
+        }
+
+        isMemberEnd = (status == Z_STREAM_END);
+        availIn = this->zstream.avail_in;
+    }
+
+    if (isMemberEnd) {
+        this->input.erase(0, this->input.size() - availIn);
+        this->endStream();
+    } else if (output.empty() && availIn == 0 && this->isInputEOF) {
+        S3WARN("Compressed stream is truncated");
+        this->input.clear();
+        this->endStream();
+    }
+}
+
+void ParallelDecompressReader::endStream() {
+    if (this->isStreaming) {
+        if (this->compressionType == S3_COMPRESSION_GZIP) {
+            inflateEnd(&this->zstream);
+        }
+        this->isStreaming = false;
+    }
+}
+
+// Hand the rest of data, from the start of input, over to DecompressReader.
+void ParallelDecompressReader::fallback() {
+    S3DEBUG("Gzip members without size, decompress the rest of data sequentially");
+
+    this->prefixedReader.setPrefix(this->input, this->reader);
+    this->input.clear();
+
+    this->decompressReader.setReader(&this->prefixedReader);
+    this->decompressReader.open(this->params);
+
+    this->isFallback = true;
+}
+
+void ParallelDecompressReader::close() {
+    if (!this->isClosed) {
+        this->endStream();
+
+        if (this->isFallback) {
+            this->decompressReader.close();
+            this->isFallback = false;
+        }
+
+        this->input.clear();
+        this->outputs.clear();
+
+        this->reader->close();
+        this->isClosed = true;
+    }
+}
@@ -0,0 +1,1499 @@
+#include "parquet_reader.h"
+
+#include <cmath>
+
+// days and microseconds from 1970-01-01 (Parquet) to 2000-01-01 (GPDB)
+static const int64_t UNIX_EPOCH_TO_GPDB_EPOCH_DAYS = 10957;
+static const int64_t UNIX_EPOCH_TO_GPDB_EPOCH_USECS = 10957LL * 86400 * 1000000;
+
+static const char PARQUET_MAGIC[] = "PAR1";
+static const uint64_t PARQUET_MAGIC_LEN = 4;
+
+static uint32_t ReadLE32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t ReadLE64(const uint8_t *p) {
+    return (uint64_t)ReadLE32(p) | ((uint64_t)ReadLE32(p + 4) << 32);
+}
+
+template <typename T>
+static void AppendRaw(string &out, T value) {
+    out.append((const char *)&value, sizeof(value));
+}
+
+// ================== Thrift compact protocol ===================
+
+enum ThriftCompactType {
+    THRIFT_STOP = 0,
+    THRIFT_TRUE = 1,
+    THRIFT_FALSE = 2,
+    THRIFT_BYTE = 3,
+    THRIFT_I16 = 4,
+    THRIFT_I32 = 5,
+    THRIFT_I64 = 6,
+    THRIFT_DOUBLE = 7,
+    THRIFT_BINARY = 8,
+    THRIFT_LIST = 9,
+    THRIFT_SET = 10,
+    THRIFT_MAP = 11,
+    THRIFT_STRUCT = 12,
+};
+
+// Just enough of Thrift compact protocol to read the metadata of Parquet, fields we don't know
+// are skipped.
+class ThriftCompactReader {
+   public:
+    ThriftCompactReader(const uint8_t *data, uint64_t len)
+        : begin(data), cur(data), end(data + len), lastFieldId(0) {
+    }
+
+    uint64_t getPosition() const {
+        return cur - begin;
+    }
+
+    uint8_t readByte() {
+        S3_CHECK_OR_DIE(cur < end, S3ParquetError, "Parquet metadata is truncated");
+        return *cur++;
+    }
+
+    uint64_t readVarint() {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = readByte();
+            result |= (uint64_t)(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) {
+                return result;
+            }
+        }
+        S3_DIE(S3ParquetError, "Invalid varint in Parquet metadata");
+    }
+
+    int64_t readI64() {
+        uint64_t n = readVarint();
+        return (int64_t)(n >> 1) ^ -(int64_t)(n & 1);
+    }
+
+    int32_t readI32() {
+        return (int32_t)readI64();
+    }
+
+    string readBinary() {
+        uint64_t len = readVarint();
+        S3_CHECK_OR_DIE(len <= (uint64_t)(end - cur), S3ParquetError,
+                        "Parquet metadata is truncated");
+        string result((const char *)cur, len);
+        cur += len;
+        return result;
+    }
+
+    void readStructBegin() {
+        S3_CHECK_OR_DIE(fieldIdStack.size() < 64, S3ParquetError,
+                        "Parquet metadata is nested too deeply");
+        fieldIdStack.push_back(lastFieldId);
+        lastFieldId = 0;
+    }
+
+    void readStructEnd() {
+        lastFieldId = fieldIdStack.back();
+        fieldIdStack.pop_back();
+    }
+
+    // Read the header of next field, return false at the end of struct.
+    bool readFieldBegin(int16_t &id, uint8_t &type) {
+        uint8_t b = readByte();
+        if (b == THRIFT_STOP) {
+            return false;
+        }
+
+        type = b & 0x0f;
+        uint8_t delta = b >> 4;
+        id = (delta != 0) ? lastFieldId + delta : (int16_t)readI64();
+        lastFieldId = id;
+        return true;
+    }
+
+    uint64_t readListBegin(uint8_t &elemType) {
+        uint8_t b = readByte();
+        uint64_t size = b >> 4;
+        elemType = b & 0x0f;
+        if (size == 15) {
+            size = readVarint();
+        }
+        return size;
+    }
+
+    // Booleans of fields are in the field type.
+    bool readBool(uint8_t type) {
+        return type == THRIFT_TRUE;
+    }
+
+    void skip(uint8_t type) {
+        switch (type) {
+            case THRIFT_TRUE:
+            case THRIFT_FALSE:
+                break;
+            case THRIFT_BYTE:
+                readByte();
+                break;
+            case THRIFT_I16:
+            case THRIFT_I32:
+            case THRIFT_I64:
+                readVarint();
+                break;
+            case THRIFT_DOUBLE:
+                skipBytes(8);
+                break;
+            case THRIFT_BINARY:
+                skipBytes(readVarint());
+                break;
+            case THRIFT_LIST:
+            case THRIFT_SET: {
+                uint8_t elemType;
+                uint64_t size = readListBegin(elemType);
+                for (uint64_t i = 0; i < size; i++) {
+                    skipElement(elemType);
+                }
+                break;
+            }
+            case THRIFT_MAP: {
+                uint64_t size = readVarint();
+                if (size > 0) {
+                    uint8_t types = readByte();
+                    for (uint64_t i = 0; i < size; i++) {
+                        skipElement(types >> 4);
+                        skipElement(types & 0x0f);
+                    }
+                }
+                break;
+            }
+            case THRIFT_STRUCT: {
+                int16_t id;
+                uint8_t fieldType;
+                readStructBegin();
+                while (readFieldBegin(id, fieldType)) {
+                    skip(fieldType);
+                }
+                readStructEnd();
+                break;
+            }
+            default:
+                S3_DIE(S3ParquetError, "Invalid type in Parquet metadata");
+        }
+    }
+
+   private:
+    // Booleans of list elements take a byte.
+    void skipElement(uint8_t type) {
+        if (type == THRIFT_TRUE || type == THRIFT_FALSE) {
+            readByte();
+        } else {
+            skip(type);
+        }
+    }
+
+    void skipBytes(uint64_t len) {
+        S3_CHECK_OR_DIE(len <= (uint64_t)(end - cur), S3ParquetError,
+                        "Parquet metadata is truncated");
+        cur += len;
+    }
+
+    const uint8_t *begin;
+    const uint8_t *cur;
+    const uint8_t *end;
+
+    int16_t lastFieldId;
+    vector<int16_t> fieldIdStack;
+};
+
+// ================== Metadata ===================
+
+enum ParquetRepetition {
+    PARQUET_REQUIRED = 0,
+    PARQUET_OPTIONAL = 1,
+    PARQUET_REPEATED = 2,
+};
+
+struct ParquetSchemaElement {
+    ParquetSchemaElement()
+        : type(PARQUET_BYTE_ARRAY), typeLength(0), repetition(PARQUET_REQUIRED), numChildren(0),
+          logicalType(PARQUET_LOGICAL_NONE), hasLogicalType(false) {
+    }
+
+    string name;
+    int32_t type;
+    int32_t typeLength;
+    int32_t repetition;
+    int32_t numChildren;
+    ParquetLogicalType logicalType;  // from ConvertedType
+    bool hasLogicalType;             // LogicalType is there and overrides ConvertedType
+};
+
+static ParquetLogicalType ConvertedTypeToLogicalType(int32_t convertedType) {
+    switch (convertedType) {
+        case 0:   // UTF8
+        case 4:   // ENUM
+        case 19:  // JSON
+            return PARQUET_LOGICAL_STRING;
+        case 6:
+            return PARQUET_LOGICAL_DATE;
+        case 9:
+            return PARQUET_LOGICAL_TIMESTAMP_MILLIS;
+        case 10:
+            return PARQUET_LOGICAL_TIMESTAMP_MICROS;
+        case 15:  // INT_8
+        case 16:  // INT_16
+        case 17:  // INT_32
+        case 18:  // INT_64
+            return PARQUET_LOGICAL_NONE;
+        default:
+            return PARQUET_LOGICAL_OTHER;
+    }
+}
+
+static ParquetLogicalType ParseTimestampType(ThriftCompactReader &reader) {
+    ParquetLogicalType result = PARQUET_LOGICAL_OTHER;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 2 && type == THRIFT_STRUCT) {  // unit
+            int16_t unitId;
+            uint8_t unitType;
+
+            reader.readStructBegin();
+            while (reader.readFieldBegin(unitId, unitType)) {
+                if (unitId == 1) {
+                    result = PARQUET_LOGICAL_TIMESTAMP_MILLIS;
+                } else if (unitId == 2) {
+                    result = PARQUET_LOGICAL_TIMESTAMP_MICROS;
+                } else if (unitId == 3) {
+                    result = PARQUET_LOGICAL_TIMESTAMP_NANOS;
+                }
+                reader.skip(unitType);
+            }
+            reader.readStructEnd();
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    return result;
+}
+
+static ParquetLogicalType ParseIntType(ThriftCompactReader &reader) {
+    bool isSigned = false;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 2 && (type == THRIFT_TRUE || type == THRIFT_FALSE)) {
+            isSigned = reader.readBool(type);
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    return isSigned ? PARQUET_LOGICAL_NONE : PARQUET_LOGICAL_OTHER;
+}
+
+static ParquetLogicalType ParseLogicalType(ThriftCompactReader &reader) {
+    ParquetLogicalType result = PARQUET_LOGICAL_OTHER;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 8 && type == THRIFT_STRUCT) {
+            result = ParseTimestampType(reader);
+        } else if (id == 10 && type == THRIFT_STRUCT) {
+            result = ParseIntType(reader);
+        } else {
+            if (id == 1 || id == 4 || id == 12) {  // STRING, ENUM, JSON
+                result = PARQUET_LOGICAL_STRING;
+            } else if (id == 6) {
+                result = PARQUET_LOGICAL_DATE;
+            } else {
+                result = PARQUET_LOGICAL_OTHER;
+            }
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    return result;
+}
+
+static ParquetSchemaElement ParseSchemaElement(ThriftCompactReader &reader) {
+    ParquetSchemaElement element;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 1 && type == THRIFT_I32) {
+            element.type = reader.readI32();
+        } else if (id == 2 && type == THRIFT_I32) {
+            element.typeLength = reader.readI32();
+        } else if (id == 3 && type == THRIFT_I32) {
+            element.repetition = reader.readI32();
+        } else if (id == 4 && type == THRIFT_BINARY) {
+            element.name = reader.readBinary();
+        } else if (id == 5 && type == THRIFT_I32) {
+            element.numChildren = reader.readI32();
+        } else if (id == 6 && type == THRIFT_I32) {
+            if (!element.hasLogicalType) {
+                element.logicalType = ConvertedTypeToLogicalType(reader.readI32());
+            } else {
+                reader.readI32();
+            }
+        } else if (id == 10 && type == THRIFT_STRUCT) {
+            element.logicalType = ParseLogicalType(reader);
+            element.hasLogicalType = true;
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    return element;
+}
+
+struct ParquetThriftStatistics {
+    ParquetThriftStatistics()
+        : hasMin(false), hasMax(false), hasOldMin(false), hasOldMax(false) {
+    }
+
+    string min, max;        // min_value and max_value
+    string oldMin, oldMax;  // deprecated min and max, signed order
+    bool hasMin, hasMax, hasOldMin, hasOldMax;
+    ParquetStatistics stats;
+};
+
+static ParquetThriftStatistics ParseStatistics(ThriftCompactReader &reader) {
+    ParquetThriftStatistics result;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 1 && type == THRIFT_BINARY) {
+            result.oldMax = reader.readBinary();
+            result.hasOldMax = true;
+        } else if (id == 2 && type == THRIFT_BINARY) {
+            result.oldMin = reader.readBinary();
+            result.hasOldMin = true;
+        } else if (id == 3 && type == THRIFT_I64) {
+            result.stats.nullCount = reader.readI64();
+            result.stats.hasNullCount = true;
+        } else if (id == 5 && type == THRIFT_BINARY) {
+            result.max = reader.readBinary();
+            result.hasMax = true;
+        } else if (id == 6 && type == THRIFT_BINARY) {
+            result.min = reader.readBinary();
+            result.hasMin = true;
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    return result;
+}
+
+static ParquetColumnChunk ParseColumnMetaData(ThriftCompactReader &reader) {
+    ParquetColumnChunk chunk;
+    ParquetThriftStatistics statistics;
+    int32_t physicalType = PARQUET_BYTE_ARRAY;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 1 && type == THRIFT_I32) {
+            physicalType = reader.readI32();
+        } else if (id == 4 && type == THRIFT_I32) {
+            chunk.codec = reader.readI32();
+        } else if (id == 5 && type == THRIFT_I64) {
+            chunk.numValues = reader.readI64();
+        } else if (id == 7 && type == THRIFT_I64) {
+            chunk.totalCompressedSize = reader.readI64();
+        } else if (id == 9 && type == THRIFT_I64) {
+            chunk.dataPageOffset = reader.readI64();
+        } else if (id == 11 && type == THRIFT_I64) {
+            chunk.dictionaryPageOffset = reader.readI64();
+        } else if (id == 12 && type == THRIFT_STRUCT) {
+            statistics = ParseStatistics(reader);
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    chunk.stats = statistics.stats;
+    if (statistics.hasMin && statistics.hasMax) {
+        chunk.stats.hasMinMax = true;
+        chunk.stats.min = statistics.min;
+        chunk.stats.max = statistics.max;
+    } else if (statistics.hasOldMin && statistics.hasOldMax && physicalType != PARQUET_BYTE_ARRAY &&
+               physicalType != PARQUET_FIXED_LEN_BYTE_ARRAY) {
+        // the deprecated ones are in signed order, which is wrong for byte arrays only.
+        chunk.stats.hasMinMax = true;
+        chunk.stats.min = statistics.oldMin;
+        chunk.stats.max = statistics.oldMax;
+    }
+
+    return chunk;
+}
+
+static ParquetColumnChunk ParseColumnChunk(ThriftCompactReader &reader) {
+    ParquetColumnChunk chunk;
+    bool hasMetaData = false;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 1 && type == THRIFT_BINARY) {
+            S3_DIE(S3ParquetError, "Parquet column chunks in other files are not supported");
+        } else if (id == 3 && type == THRIFT_STRUCT) {
+            chunk = ParseColumnMetaData(reader);
+            hasMetaData = true;
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    S3_CHECK_OR_DIE(hasMetaData, S3ParquetError, "Parquet column chunk has no metadata");
+    return chunk;
+}
+
+static ParquetRowGroup ParseRowGroup(ThriftCompactReader &reader) {
+    ParquetRowGroup rowGroup;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 1 && type == THRIFT_LIST) {
+            uint8_t elemType;
+            uint64_t size = reader.readListBegin(elemType);
+            for (uint64_t i = 0; i < size; i++) {
+                rowGroup.columns.push_back(ParseColumnChunk(reader));
+            }
+        } else if (id == 3 && type == THRIFT_I64) {
+            rowGroup.numRows = reader.readI64();
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    return rowGroup;
+}
+
+// Flatten the schema tree into its leaves, which are in the order of column chunks.
+static void CollectSchemaColumns(const vector<ParquetSchemaElement> &elements, uint64_t &index,
+                                 int32_t depth, int32_t maxDefinitionLevel, bool isTopLevel,
+                                 vector<ParquetSchemaColumn> &columns) {
+    S3_CHECK_OR_DIE(index < elements.size() && depth < 64, S3ParquetError,
+                    "Invalid schema in Parquet metadata");
+
+    const ParquetSchemaElement &element = elements[index++];
+
+    if (depth > 0) {
+        if (element.repetition != PARQUET_REQUIRED) {
+            maxDefinitionLevel++;
+        }
+        isTopLevel = (depth == 1) && (element.repetition != PARQUET_REPEATED);
+    }
+
+    if (depth > 0 && element.numChildren == 0) {
+        ParquetSchemaColumn column;
+        column.name = element.name;
+        column.type = element.type;
+        column.logicalType = element.logicalType;
+        column.typeLength = element.typeLength;
+        column.maxDefinitionLevel = maxDefinitionLevel;
+        column.isTopLevel = isTopLevel;
+        columns.push_back(column);
+        return;
+    }
+
+    for (int32_t i = 0; i < element.numChildren; i++) {
+        CollectSchemaColumns(elements, index, depth + 1, maxDefinitionLevel, false, columns);
+    }
+}
+
+ParquetFileMetaData ParseParquetFileMetaData(const uint8_t *data, uint64_t len) {
+    ThriftCompactReader reader(data, len);
+    ParquetFileMetaData metaData;
+    vector<ParquetSchemaElement> elements;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 2 && type == THRIFT_LIST) {
+            uint8_t elemType;
+            uint64_t size = reader.readListBegin(elemType);
+            for (uint64_t i = 0; i < size; i++) {
+                elements.push_back(ParseSchemaElement(reader));
+            }
+        } else if (id == 3 && type == THRIFT_I64) {
+            metaData.numRows = reader.readI64();
+        } else if (id == 4 && type == THRIFT_LIST) {
+            uint8_t elemType;
+            uint64_t size = reader.readListBegin(elemType);
+            for (uint64_t i = 0; i < size; i++) {
+                metaData.rowGroups.push_back(ParseRowGroup(reader));
+            }
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    S3_CHECK_OR_DIE(!elements.empty(), S3ParquetError, "Parquet metadata has no schema");
+
+    uint64_t index = 0;
+    CollectSchemaColumns(elements, index, 0, 0, false, metaData.columns);
+
+    for (uint64_t i = 0; i < metaData.rowGroups.size(); i++) {
+        S3_CHECK_OR_DIE(metaData.rowGroups[i].columns.size() == metaData.columns.size(),
+                        S3ParquetError, "Parquet row group doesn't match the schema");
+    }
+
+    return metaData;
+}
+
+struct ParquetPageHeader {
+    ParquetPageHeader()
+        : type(0), uncompressedSize(0), compressedSize(0), numValues(0), encoding(PARQUET_PLAIN),
+          definitionLevelsLength(0), repetitionLevelsLength(0), isCompressed(true) {
+    }
+
+    int32_t type;
+    int32_t uncompressedSize;
+    int32_t compressedSize;
+
+    // of data page, data page v2 and dictionary page
+    int32_t numValues;
+    int32_t encoding;
+
+    // of data page v2, levels are not compressed
+    int32_t definitionLevelsLength;
+    int32_t repetitionLevelsLength;
+    bool isCompressed;
+};
+
+static void ParsePageHeaderBody(ThriftCompactReader &reader, ParquetPageHeader &header) {
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (header.type == PARQUET_DATA_PAGE_V2) {
+            if (id == 1 && type == THRIFT_I32) {
+                header.numValues = reader.readI32();
+            } else if (id == 4 && type == THRIFT_I32) {
+                header.encoding = reader.readI32();
+            } else if (id == 5 && type == THRIFT_I32) {
+                header.definitionLevelsLength = reader.readI32();
+            } else if (id == 6 && type == THRIFT_I32) {
+                header.repetitionLevelsLength = reader.readI32();
+            } else if (id == 7 && (type == THRIFT_TRUE || type == THRIFT_FALSE)) {
+                header.isCompressed = reader.readBool(type);
+            } else {
+                reader.skip(type);
+            }
+        } else {
+            if (id == 1 && type == THRIFT_I32) {
+                header.numValues = reader.readI32();
+            } else if (id == 2 && type == THRIFT_I32) {
+                header.encoding = reader.readI32();
+            } else {
+                reader.skip(type);
+            }
+        }
+    }
+    reader.readStructEnd();
+}
+
+static ParquetPageHeader ParsePageHeader(ThriftCompactReader &reader) {
+    ParquetPageHeader header;
+    int16_t id;
+    uint8_t type;
+
+    reader.readStructBegin();
+    while (reader.readFieldBegin(id, type)) {
+        if (id == 1 && type == THRIFT_I32) {
+            header.type = reader.readI32();
+        } else if (id == 2 && type == THRIFT_I32) {
+            header.uncompressedSize = reader.readI32();
+        } else if (id == 3 && type == THRIFT_I32) {
+            header.compressedSize = reader.readI32();
+        } else if ((id == 5 || id == 7 || id == 8) && type == THRIFT_STRUCT) {
+            ParsePageHeaderBody(reader, header);
+        } else {
+            reader.skip(type);
+        }
+    }
+    reader.readStructEnd();
+
+    S3_CHECK_OR_DIE(header.compressedSize >= 0 && header.uncompressedSize >= 0 &&
+                        header.numValues >= 0 && header.definitionLevelsLength >= 0 &&
+                        header.repetitionLevelsLength >= 0,
+                    S3ParquetError, "Invalid Parquet page header");
+    return header;
+}
+
+// ================== Page decoding ===================
+
+static void SnappyUncompress(const uint8_t *src, uint64_t srcLen, uint8_t *dst, uint64_t dstLen) {
+    const uint8_t *end = src + srcLen;
+    uint64_t pos = 0;
+
+    // uncompressed length as varint
+    uint64_t len = 0;
+    for (int shift = 0;; shift += 7) {
+        S3_CHECK_OR_DIE(src < end && shift < 64, S3ParquetError, "Invalid snappy data");
+        len |= (uint64_t)(*src & 0x7f) << shift;
+        if ((*src++ & 0x80) == 0) {
+            break;
+        }
+    }
+    S3_CHECK_OR_DIE(len == dstLen, S3ParquetError, "Invalid snappy data");
+
+    while (src < end) {
+        uint8_t tag = *src++;
+        uint64_t length;
+        uint64_t offset;
+
+        switch (tag & 0x03) {
+            case 0: {  // literal
+                length = tag >> 2;
+                if (length >= 60) {
+                    uint64_t bytes = length - 59;
+                    S3_CHECK_OR_DIE(bytes <= (uint64_t)(end - src), S3ParquetError,
+                                    "Invalid snappy data");
+                    length = 0;
+                    for (uint64_t i = 0; i < bytes; i++) {
+                        length |= (uint64_t)src[i] << (8 * i);
+                    }
+                    src += bytes;
+                }
+                length++;
+
+                S3_CHECK_OR_DIE(length <= (uint64_t)(end - src) && length <= dstLen - pos,
+                                S3ParquetError, "Invalid snappy data");
+                memcpy(dst + pos, src, length);
+                src += length;
+                pos += length;
+                continue;
+            }
+            case 1:
+                S3_CHECK_OR_DIE(src < end, S3ParquetError, "Invalid snappy data");
+                length = ((tag >> 2) & 0x07) + 4;
+                offset = ((uint64_t)(tag >> 5) << 8) | *src++;
+                break;
+            case 2:
+                S3_CHECK_OR_DIE(end - src >= 2, S3ParquetError, "Invalid snappy data");
+                length = (tag >> 2) + 1;
+                offset = (uint64_t)src[0] | ((uint64_t)src[1] << 8);
+                src += 2;
+                break;
+            default:
+                S3_CHECK_OR_DIE(end - src >= 4, S3ParquetError, "Invalid snappy data");
+                length = (tag >> 2) + 1;
+                offset = ReadLE32(src);
+                src += 4;
+                break;
+        }
+
+        // copies may overlap with their own output
+        S3_CHECK_OR_DIE(offset > 0 && offset <= pos && length <= dstLen - pos, S3ParquetError,
+                        "Invalid snappy data");
+        for (uint64_t i = 0; i < length; i++, pos++) {
+            dst[pos] = dst[pos - offset];
+        }
+    }
+
+    S3_CHECK_OR_DIE(pos == dstLen, S3ParquetError, "Invalid snappy data");
+}
+
+static void GzipUncompress(const uint8_t *src, uint64_t srcLen, uint8_t *dst, uint64_t dstLen) {
+    z_stream zstream;
+    memset(&zstream, 0, sizeof(zstream));
+
+    S3_CHECK_OR_DIE(inflateInit2(&zstream, S3_INFLATE_WINDOWSBITS) == Z_OK, S3ParquetError,
+                    "Failed to initialize zlib library");
+
+    zstream.next_in = (Bytef *)src;
+    zstream.avail_in = srcLen;
+    zstream.next_out = (Bytef *)dst;
+    zstream.avail_out = dstLen;
+
+    int status = inflate(&zstream, Z_FINISH);
+    uint64_t totalOut = zstream.total_out;
+    inflateEnd(&zstream);
+
+    S3_CHECK_OR_DIE(status == Z_STREAM_END && totalOut == dstLen, S3ParquetError,
+                    "Invalid gzip data in Parquet page");
+}
+
+// Return the uncompressed data of page, which is in buffer unless the page is not compressed.
+static const uint8_t *UncompressPage(int32_t codec, const uint8_t *src, uint64_t srcLen,
+                                     uint64_t dstLen, vector<uint8_t> &buffer) {
+    if (codec == PARQUET_UNCOMPRESSED) {
+        S3_CHECK_OR_DIE(srcLen == dstLen, S3ParquetError, "Invalid Parquet page size");
+        return src;
+    }
+
+    buffer.resize(dstLen);
+    if (codec == PARQUET_SNAPPY) {
+        SnappyUncompress(src, srcLen, buffer.data(), dstLen);
+    } else if (codec == PARQUET_GZIP) {
+        GzipUncompress(src, srcLen, buffer.data(), dstLen);
+    } else {
+        S3_DIE(S3ParquetError, "Parquet compression codec " + std::to_string(codec) +
+                                   " is not supported, only SNAPPY and GZIP are");
+    }
+    return buffer.data();
+}
+
+// Decoder of the RLE/bit-packing hybrid encoding, for levels and dictionary indexes.
+class RleBitPackedDecoder {
+   public:
+    RleBitPackedDecoder(const uint8_t *data, uint64_t len, uint32_t bitWidth)
+        : cur(data), end(data + len), bitWidth(bitWidth), repeatCount(0), literalCount(0),
+          currentValue(0), literalBits(NULL), literalBitsLen(0), bitOffset(0) {
+        S3_CHECK_OR_DIE(bitWidth <= 32, S3ParquetError, "Invalid bit width in Parquet page");
+    }
+
+    uint32_t next() {
+        if (repeatCount == 0 && literalCount == 0) {
+            readRunHeader();
+        }
+
+        if (repeatCount > 0) {
+            repeatCount--;
+            return currentValue;
+        }
+
+        literalCount--;
+
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bitWidth; i++, bitOffset++) {
+            S3_CHECK_OR_DIE(bitOffset / 8 < literalBitsLen, S3ParquetError,
+                            "Parquet page is truncated");
+            value |= (uint32_t)((literalBits[bitOffset / 8] >> (bitOffset % 8)) & 1) << i;
+        }
+        return value;
+    }
+
+   private:
+    void readRunHeader() {
+        uint64_t header = 0;
+        for (int shift = 0;; shift += 7) {
+            S3_CHECK_OR_DIE(cur < end && shift < 64, S3ParquetError, "Parquet page is truncated");
+            header |= (uint64_t)(*cur & 0x7f) << shift;
+            if ((*cur++ & 0x80) == 0) {
+                break;
+            }
+        }
+
+        if (header & 1) {
+            // groups of 8 values, the last group may be cut at the end of page
+            uint64_t groups = header >> 1;
+            literalCount = groups * 8;
+            literalBits = cur;
+            literalBitsLen = std::min(groups * bitWidth, (uint64_t)(end - cur));
+            bitOffset = 0;
+            cur += literalBitsLen;
+        } else {
+            repeatCount = header >> 1;
+            uint32_t bytes = (bitWidth + 7) / 8;
+            S3_CHECK_OR_DIE(bytes <= (uint64_t)(end - cur), S3ParquetError,
+                            "Parquet page is truncated");
+            currentValue = 0;
+            for (uint32_t i = 0; i < bytes; i++) {
+                currentValue |= (uint32_t)cur[i] << (8 * i);
+            }
+            cur += bytes;
+        }
+
+        S3_CHECK_OR_DIE(repeatCount > 0 || literalCount > 0, S3ParquetError,
+                        "Invalid run in Parquet page");
+    }
+
+    const uint8_t *cur;
+    const uint8_t *end;
+    uint32_t bitWidth;
+
+    uint64_t repeatCount;
+    uint64_t literalCount;
+    uint32_t currentValue;
+
+    const uint8_t *literalBits;
+    uint64_t literalBitsLen;
+    uint64_t bitOffset;
+};
+
+static uint32_t BitWidth(uint32_t maxValue) {
+    uint32_t width = 0;
+    while (maxValue != 0) {
+        width++;
+        maxValue >>= 1;
+    }
+    return width;
+}
+
+static bool CanReadAs(const ParquetSchemaColumn &column, ParquetValueKind kind) {
+    switch (kind) {
+        case PARQUET_KIND_BOOL:
+            return column.type == PARQUET_BOOLEAN;
+        case PARQUET_KIND_INT16:
+        case PARQUET_KIND_INT32:
+        case PARQUET_KIND_INT64:
+            return (column.type == PARQUET_INT32 || column.type == PARQUET_INT64) &&
+                   column.logicalType == PARQUET_LOGICAL_NONE;
+        case PARQUET_KIND_FLOAT4:
+            return column.type == PARQUET_FLOAT;
+        case PARQUET_KIND_FLOAT8:
+            return column.type == PARQUET_FLOAT || column.type == PARQUET_DOUBLE;
+        case PARQUET_KIND_TEXT:
+            return (column.type == PARQUET_BYTE_ARRAY ||
+                    column.type == PARQUET_FIXED_LEN_BYTE_ARRAY) &&
+                   (column.logicalType == PARQUET_LOGICAL_NONE ||
+                    column.logicalType == PARQUET_LOGICAL_STRING);
+        case PARQUET_KIND_DATE:
+            return column.type == PARQUET_INT32 && column.logicalType == PARQUET_LOGICAL_DATE;
+        case PARQUET_KIND_TIMESTAMP:
+            return column.type == PARQUET_INT64 &&
+                   (column.logicalType == PARQUET_LOGICAL_TIMESTAMP_MILLIS ||
+                    column.logicalType == PARQUET_LOGICAL_TIMESTAMP_MICROS ||
+                    column.logicalType == PARQUET_LOGICAL_TIMESTAMP_NANOS);
+        default:
+            return false;
+    }
+}
+
+// Integers of Parquet column in the unit and epoch of table column.
+static int64_t ToTableInteger(const ParquetSchemaColumn &column, ParquetValueKind kind,
+                              int64_t value) {
+    if (kind == PARQUET_KIND_DATE) {
+        return value - UNIX_EPOCH_TO_GPDB_EPOCH_DAYS;
+    }
+
+    if (kind == PARQUET_KIND_TIMESTAMP) {
+        if (column.logicalType == PARQUET_LOGICAL_TIMESTAMP_MILLIS) {
+            value *= 1000;
+        } else if (column.logicalType == PARQUET_LOGICAL_TIMESTAMP_NANOS) {
+            // round toward negative infinity, like times before 1970 are
+            value = (value >= 0) ? value / 1000 : -((-value + 999) / 1000);
+        }
+        return value - UNIX_EPOCH_TO_GPDB_EPOCH_USECS;
+    }
+
+    return value;
+}
+
+static void AppendInteger(string &out, const ParquetSchemaColumn &column, ParquetValueKind kind,
+                          int64_t value) {
+    value = ToTableInteger(column, kind, value);
+
+    switch (kind) {
+        case PARQUET_KIND_INT16:
+            S3_CHECK_OR_DIE(value >= INT16_MIN && value <= INT16_MAX, S3ParquetError,
+                            "value " + std::to_string((long long)value) + " of column \"" +
+                                column.name + "\" is out of range for type smallint");
+            AppendRaw<int16_t>(out, value);
+            break;
+        case PARQUET_KIND_INT32:
+        case PARQUET_KIND_DATE:
+            S3_CHECK_OR_DIE(value >= INT32_MIN && value <= INT32_MAX, S3ParquetError,
+                            "value " + std::to_string((long long)value) + " of column \"" +
+                                column.name + "\" is out of range");
+            AppendRaw<int32_t>(out, value);
+            break;
+        default:
+            AppendRaw<int64_t>(out, value);
+            break;
+    }
+}
+
+static void AppendDouble(string &out, ParquetValueKind kind, double value) {
+    if (kind == PARQUET_KIND_FLOAT4) {
+        AppendRaw<float>(out, (float)value);
+    } else {
+        AppendRaw<double>(out, value);
+    }
+}
+
+// Decode count PLAIN encoded values, and append them to out as values of table column. When
+// offsets is given, the offset of each value in out is pushed to it, for dictionaries.
+static void DecodePlain(const uint8_t *cur, const uint8_t *end, uint64_t count,
+                        const ParquetSchemaColumn &column, ParquetValueKind kind, string &out,
+                        vector<uint64_t> *offsets) {
+    uint64_t available = end - cur;
+
+    for (uint64_t i = 0; i < count; i++) {
+        if (offsets != NULL) {
+            offsets->push_back(out.size());
+        }
+
+        switch (column.type) {
+            case PARQUET_BOOLEAN:
+                S3_CHECK_OR_DIE(i / 8 < available, S3ParquetError, "Parquet page is truncated");
+                AppendRaw<uint8_t>(out, (cur[i / 8] >> (i % 8)) & 1);
+                break;
+            case PARQUET_INT32:
+                S3_CHECK_OR_DIE(end - cur >= 4, S3ParquetError, "Parquet page is truncated");
+                AppendInteger(out, column, kind, (int32_t)ReadLE32(cur));
+                cur += 4;
+                break;
+            case PARQUET_INT64:
+                S3_CHECK_OR_DIE(end - cur >= 8, S3ParquetError, "Parquet page is truncated");
+                AppendInteger(out, column, kind, (int64_t)ReadLE64(cur));
+                cur += 8;
+                break;
+            case PARQUET_FLOAT: {
+                S3_CHECK_OR_DIE(end - cur >= 4, S3ParquetError, "Parquet page is truncated");
+                uint32_t bits = ReadLE32(cur);
+                float value;
+                memcpy(&value, &bits, sizeof(value));
+                AppendDouble(out, kind, value);
+                cur += 4;
+                break;
+            }
+            case PARQUET_DOUBLE: {
+                S3_CHECK_OR_DIE(end - cur >= 8, S3ParquetError, "Parquet page is truncated");
+                uint64_t bits = ReadLE64(cur);
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                AppendDouble(out, kind, value);
+                cur += 8;
+                break;
+            }
+            case PARQUET_BYTE_ARRAY: {
+                S3_CHECK_OR_DIE(end - cur >= 4, S3ParquetError, "Parquet page is truncated");
+                uint32_t len = ReadLE32(cur);
+                cur += 4;
+                S3_CHECK_OR_DIE(len <= (uint64_t)(end - cur), S3ParquetError,
+                                "Parquet page is truncated");
+                AppendRaw<uint32_t>(out, len);
+                out.append((const char *)cur, len);
+                cur += len;
+                break;
+            }
+            case PARQUET_FIXED_LEN_BYTE_ARRAY: {
+                uint32_t len = column.typeLength;
+                S3_CHECK_OR_DIE(len <= (uint64_t)(end - cur), S3ParquetError,
+                                "Parquet page is truncated");
+                AppendRaw<uint32_t>(out, len);
+                out.append((const char *)cur, len);
+                cur += len;
+                break;
+            }
+            default:
+                S3_DIE(S3ParquetError, "Parquet type " + std::to_string(column.type) +
+                                           " of column \"" + column.name + "\" is not supported");
+        }
+    }
+}
+
+// Length of the value at offset of the values of table column.
+static uint64_t ValueLength(ParquetValueKind kind, const string &data, uint64_t offset) {
+    switch (kind) {
+        case PARQUET_KIND_BOOL:
+            return 1;
+        case PARQUET_KIND_INT16:
+            return 2;
+        case PARQUET_KIND_INT32:
+        case PARQUET_KIND_FLOAT4:
+        case PARQUET_KIND_DATE:
+            return 4;
+        case PARQUET_KIND_TEXT: {
+            uint32_t len;
+            memcpy(&len, data.data() + offset, sizeof(len));
+            return sizeof(len) + len;
+        }
+        default:
+            return 8;
+    }
+}
+
+// ================== ParquetReader ===================
+
+ParquetReader::ParquetReader()
+    : s3Interface(NULL),
+      s3Url(""),
+      keySize(0),
+      rowGroupIndex(0),
+      numRows(0),
+      rowIndex(0),
+      rowBufferOffset(0),
+      skippedRowGroups(0) {
+}
+
+void ParquetReader::fetch(uint64_t offset, uint64_t len, S3VectorUInt8 &data) {
+    S3_CHECK_OR_DIE(offset <= this->keySize && len <= this->keySize - offset, S3ParquetError,
+                    "Parquet metadata of " + this->s3Url.getFullUrlForCurl() +
+                        " points beyond the end of file");
+
+    if (len == 0) {
+        data.clear();
+        return;
+    }
+
+    uint64_t readLen = this->s3Interface->fetchData(offset, data, len, this->s3Url);
+    S3_CHECK_OR_DIE(readLen == len, S3PartialResponseError, len, readLen);
+}
+
+void ParquetReader::readMetaData() {
+    S3_CHECK_OR_DIE(this->keySize >= PARQUET_MAGIC_LEN * 2 + 4, S3ParquetError,
+                    this->s3Url.getFullUrlForCurl() + " is not a Parquet file");
+
+    // Footers are usually small, fetch the tail of file once to get both the footer and its
+    // length.
+    uint64_t tailLen = std::min(this->keySize, (uint64_t)S3_PARQUET_FOOTER_FETCH_SIZE);
+    S3VectorUInt8 tail;
+    this->fetch(this->keySize - tailLen, tailLen, tail);
+
+    const uint8_t *tailEnd = tail.data() + tailLen;
+    S3_CHECK_OR_DIE(memcmp(tailEnd - PARQUET_MAGIC_LEN, PARQUET_MAGIC, PARQUET_MAGIC_LEN) == 0,
+                    S3ParquetError, this->s3Url.getFullUrlForCurl() + " is not a Parquet file");
+
+    uint64_t footerLen = ReadLE32(tailEnd - PARQUET_MAGIC_LEN - 4);
+    S3_CHECK_OR_DIE(footerLen + PARQUET_MAGIC_LEN * 2 + 4 <= this->keySize, S3ParquetError,
+                    this->s3Url.getFullUrlForCurl() + " is not a Parquet file");
+
+    if (footerLen + PARQUET_MAGIC_LEN + 4 <= tailLen) {
+        this->metaData = ParseParquetFileMetaData(tailEnd - PARQUET_MAGIC_LEN - 4 - footerLen,
+                                                  footerLen);
+    } else {
+        S3VectorUInt8 footer;
+        this->fetch(this->keySize - PARQUET_MAGIC_LEN - 4 - footerLen, footerLen, footer);
+        this->metaData = ParseParquetFileMetaData(footer.data(), footerLen);
+    }
+
+    S3DEBUG("Parquet file %s has %" PRIu64 " rows in %zu row groups",
+            this->s3Url.getFullUrlForCurl().c_str(), (uint64_t)this->metaData.numRows,
+            this->metaData.rowGroups.size());
+}
+
+// Match table columns to leaf columns of Parquet by name, exact match first.
+void ParquetReader::mapColumns() {
+    const vector<ParquetSchemaColumn> &columns = this->metaData.columns;
+
+    this->columnIndexes.assign(this->scanDesc.columns.size(), -1);
+
+    for (uint64_t i = 0; i < this->scanDesc.columns.size(); i++) {
+        const ParquetTableColumn &tableColumn = this->scanDesc.columns[i];
+        if (tableColumn.kind == PARQUET_KIND_SKIP) {
+            continue;
+        }
+
+        int64_t index = -1;
+        for (uint64_t j = 0; j < columns.size() && index < 0; j++) {
+            if (columns[j].isTopLevel && columns[j].name == tableColumn.name) {
+                index = j;
+            }
+        }
+        for (uint64_t j = 0; j < columns.size() && index < 0; j++) {
+            if (columns[j].isTopLevel &&
+                strcasecmp(columns[j].name.c_str(), tableColumn.name.c_str()) == 0) {
+                index = j;
+            }
+        }
+
+        S3_CHECK_OR_DIE(index >= 0, S3ParquetError,
+                        "column \"" + tableColumn.name + "\" is not found in Parquet file " +
+                            this->s3Url.getFullUrlForCurl());
+        S3_CHECK_OR_DIE(CanReadAs(columns[index], tableColumn.kind), S3ParquetError,
+                        "column \"" + tableColumn.name +
+                            "\" doesn't match the type of its Parquet column in " +
+                            this->s3Url.getFullUrlForCurl());
+
+        this->columnIndexes[i] = index;
+    }
+}
+
+void ParquetReader::open(const S3Params &params) {
+    S3_CHECK_OR_DIE(this->s3Interface != NULL, S3RuntimeError, "s3Interface must not be NULL");
+
+    this->s3Url = params.getS3Url();
+    this->keySize = params.getKeySize();
+
+    this->readMetaData();
+    this->mapColumns();
+
+    this->values.resize(this->scanDesc.columns.size());
+    this->rowGroupIndex = 0;
+    this->numRows = 0;
+    this->rowIndex = 0;
+}
+
+template <typename T>
+static bool QualCannotMatch(ParquetQualOp op, const T &min, const T &max, const T &value) {
+    switch (op) {
+        case PARQUET_QUAL_EQ:
+            return value < min || max < value;
+        case PARQUET_QUAL_LT:
+            return !(min < value);
+        case PARQUET_QUAL_LE:
+            return value < min;
+        case PARQUET_QUAL_GT:
+            return !(value < max);
+        case PARQUET_QUAL_GE:
+            return max < value;
+        default:
+            return false;
+    }
+}
+
+static bool DecodeStatInteger(const ParquetSchemaColumn &column, const string &stat,
+                              int64_t &value) {
+    if (column.type == PARQUET_INT32 && stat.size() == 4) {
+        value = (int32_t)ReadLE32((const uint8_t *)stat.data());
+        return true;
+    } else if (column.type == PARQUET_INT64 && stat.size() == 8) {
+        value = (int64_t)ReadLE64((const uint8_t *)stat.data());
+        return true;
+    }
+    return false;
+}
+
+static bool DecodeStatDouble(const ParquetSchemaColumn &column, const string &stat,
+                             double &value) {
+    if (column.type == PARQUET_FLOAT && stat.size() == 4) {
+        uint32_t bits = ReadLE32((const uint8_t *)stat.data());
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        value = f;
+        return true;
+    } else if (column.type == PARQUET_DOUBLE && stat.size() == 8) {
+        uint64_t bits = ReadLE64((const uint8_t *)stat.data());
+        memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+    return false;
+}
+
+// Whether statistics of the row group show that no row satisfies all the quals.
+bool ParquetReader::canSkipRowGroup(const ParquetRowGroup &rowGroup) {
+    for (uint64_t i = 0; i < this->scanDesc.quals.size(); i++) {
+        const ParquetQual &qual = this->scanDesc.quals[i];
+        if (qual.column >= this->columnIndexes.size() || this->columnIndexes[qual.column] < 0) {
+            continue;
+        }
+
+        const ParquetSchemaColumn &column = this->metaData.columns[this->columnIndexes[qual.column]];
+        const ParquetColumnChunk &chunk = rowGroup.columns[this->columnIndexes[qual.column]];
+        const ParquetStatistics &stats = chunk.stats;
+        ParquetValueKind kind = this->scanDesc.columns[qual.column].kind;
+
+        // comparisons with NULL are never true
+        if (stats.hasNullCount && chunk.numValues > 0 && stats.nullCount == chunk.numValues) {
+            return true;
+        }
+
+        if (!stats.hasMinMax) {
+            continue;
+        }
+
+        switch (kind) {
+            case PARQUET_KIND_INT16:
+            case PARQUET_KIND_INT32:
+            case PARQUET_KIND_INT64:
+            case PARQUET_KIND_DATE:
+            case PARQUET_KIND_TIMESTAMP: {
+                int64_t min, max;
+                if (DecodeStatInteger(column, stats.min, min) &&
+                    DecodeStatInteger(column, stats.max, max) &&
+                    QualCannotMatch(qual.op, ToTableInteger(column, kind, min),
+                                    ToTableInteger(column, kind, max), qual.intValue)) {
+                    return true;
+                }
+                break;
+            }
+            case PARQUET_KIND_FLOAT4:
+            case PARQUET_KIND_FLOAT8: {
+                // NaN is not in the statistics but is larger than any other value.
+                double min, max;
+                if (qual.op != PARQUET_QUAL_GT && qual.op != PARQUET_QUAL_GE &&
+                    !std::isnan(qual.floatValue) && DecodeStatDouble(column, stats.min, min) &&
+                    DecodeStatDouble(column, stats.max, max) && !std::isnan(min) &&
+                    !std::isnan(max) && QualCannotMatch(qual.op, min, max, qual.floatValue)) {
+                    return true;
+                }
+                break;
+            }
+            case PARQUET_KIND_TEXT:
+                // statistics are in byte order, which is not the order of collations.
+                if (qual.op == PARQUET_QUAL_EQ &&
+                    QualCannotMatch(qual.op, stats.min, stats.max, qual.textValue)) {
+                    return true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return false;
+}
+
+// Decode all pages of a column chunk into the values of table column.
+void ParquetReader::readColumnChunk(const ParquetColumnChunk &chunk,
+                                    const ParquetSchemaColumn &column, ParquetValueKind kind,
+                                    ParquetColumnValues &values) {
+    S3_CHECK_OR_DIE(chunk.totalCompressedSize >= 0 && chunk.dataPageOffset > 0, S3ParquetError,
+                    "Invalid metadata of Parquet column \"" + column.name + "\"");
+
+    S3VectorUInt8 data;
+    this->fetch(chunk.getStartOffset(), chunk.totalCompressedSize, data);
+
+    const uint8_t *cur = data.data();
+    const uint8_t *end = cur + chunk.totalCompressedSize;
+
+    string dictionary;
+    vector<uint64_t> dictionaryOffsets;
+    bool hasDictionary = false;
+
+    vector<uint8_t> buffer;
+    uint32_t definitionBitWidth = BitWidth(column.maxDefinitionLevel);
+    int64_t numValues = 0;
+
+    while (numValues < chunk.numValues) {
+        S3_CHECK_OR_DIE(cur < end, S3ParquetError,
+                        "Parquet column \"" + column.name + "\" is truncated");
+
+        ThriftCompactReader headerReader(cur, end - cur);
+        ParquetPageHeader header = ParsePageHeader(headerReader);
+        cur += headerReader.getPosition();
+
+        S3_CHECK_OR_DIE(header.compressedSize <= end - cur, S3ParquetError,
+                        "Parquet column \"" + column.name + "\" is truncated");
+        const uint8_t *page = cur;
+        cur += header.compressedSize;
+
+        if (header.type == PARQUET_DICTIONARY_PAGE) {
+            S3_CHECK_OR_DIE(header.encoding == PARQUET_PLAIN ||
+                                header.encoding == PARQUET_PLAIN_DICTIONARY,
+                            S3ParquetError, "Invalid encoding of Parquet dictionary page");
+
+            const uint8_t *p = UncompressPage(chunk.codec, page, header.compressedSize,
+                                              header.uncompressedSize, buffer);
+
+            dictionary.clear();
+            dictionaryOffsets.clear();
+            DecodePlain(p, p + header.uncompressedSize, header.numValues, column, kind, dictionary,
+                        &dictionaryOffsets);
+            dictionaryOffsets.push_back(dictionary.size());
+            hasDictionary = true;
+            continue;
+        }
+
+        if (header.type != PARQUET_DATA_PAGE && header.type != PARQUET_DATA_PAGE_V2) {
+            continue;  // index pages
+        }
+
+        const uint8_t *levels;
+        uint64_t levelsLen;
+        const uint8_t *p;
+        const uint8_t *pEnd;
+
+        if (header.type == PARQUET_DATA_PAGE) {
+            p = UncompressPage(chunk.codec, page, header.compressedSize, header.uncompressedSize,
+                               buffer);
+            pEnd = p + header.uncompressedSize;
+
+            // definition levels with their length, no repetition levels for top level columns
+            levels = p;
+            levelsLen = 0;
+            if (column.maxDefinitionLevel > 0) {
+                S3_CHECK_OR_DIE(pEnd - p >= 4, S3ParquetError, "Parquet page is truncated");
+                levelsLen = ReadLE32(p);
+                levels = p + 4;
+                S3_CHECK_OR_DIE(levelsLen <= (uint64_t)(pEnd - levels), S3ParquetError,
+                                "Parquet page is truncated");
+                p = levels + levelsLen;
+            }
+        } else {
+            // levels are not compressed in v2 pages
+            uint64_t levelsTotal = header.repetitionLevelsLength + header.definitionLevelsLength;
+            S3_CHECK_OR_DIE(levelsTotal <= (uint64_t)header.compressedSize &&
+                                levelsTotal <= (uint64_t)header.uncompressedSize,
+                            S3ParquetError, "Invalid Parquet page header");
+
+            levels = page + header.repetitionLevelsLength;
+            levelsLen = header.definitionLevelsLength;
+
+            uint64_t valuesLen = header.uncompressedSize - levelsTotal;
+            if (header.isCompressed) {
+                p = UncompressPage(chunk.codec, page + levelsTotal,
+                                   header.compressedSize - levelsTotal, valuesLen, buffer);
+            } else {
+                S3_CHECK_OR_DIE(header.compressedSize == header.uncompressedSize, S3ParquetError,
+                                "Invalid Parquet page header");
+                p = page + levelsTotal;
+            }
+            pEnd = p + valuesLen;
+        }
+
+        RleBitPackedDecoder definitionLevels(levels, levelsLen, definitionBitWidth);
+        uint64_t numNonNull = 0;
+        for (int32_t i = 0; i < header.numValues; i++) {
+            bool isNull = (column.maxDefinitionLevel > 0) &&
+                          (definitionLevels.next() < (uint32_t)column.maxDefinitionLevel);
+            values.nulls.push_back(isNull);
+            if (!isNull) {
+                numNonNull++;
+            }
+        }
+
+        switch (header.encoding) {
+            case PARQUET_PLAIN:
+                DecodePlain(p, pEnd, numNonNull, column, kind, values.data, NULL);
+                break;
+            case PARQUET_PLAIN_DICTIONARY:
+            case PARQUET_RLE_DICTIONARY: {
+                S3_CHECK_OR_DIE(hasDictionary, S3ParquetError,
+                                "Parquet column \"" + column.name + "\" has no dictionary page");
+                if (numNonNull == 0) {
+                    break;
+                }
+
+                S3_CHECK_OR_DIE(p < pEnd, S3ParquetError, "Parquet page is truncated");
+                RleBitPackedDecoder indexes(p + 1, pEnd - p - 1, *p);
+                for (uint64_t i = 0; i < numNonNull; i++) {
+                    uint32_t index = indexes.next();
+                    S3_CHECK_OR_DIE(index + 1 < dictionaryOffsets.size(), S3ParquetError,
+                                    "Invalid dictionary index in Parquet page");
+                    values.data.append(dictionary, dictionaryOffsets[index],
+                                       dictionaryOffsets[index + 1] - dictionaryOffsets[index]);
+                }
+                break;
+            }
+            case PARQUET_RLE: {
+                S3_CHECK_OR_DIE(column.type == PARQUET_BOOLEAN && pEnd - p >= 4, S3ParquetError,
+                                "Invalid RLE encoded Parquet page");
+                uint64_t len = ReadLE32(p);
+                S3_CHECK_OR_DIE(len <= (uint64_t)(pEnd - p - 4), S3ParquetError,
+                                "Parquet page is truncated");
+                RleBitPackedDecoder booleans(p + 4, len, 1);
+                for (uint64_t i = 0; i < numNonNull; i++) {
+                    AppendRaw<uint8_t>(values.data, booleans.next());
+                }
+                break;
+            }
+            default:
+                S3_DIE(S3ParquetError, "Parquet encoding " + std::to_string(header.encoding) +
+                                           " of column \"" + column.name + "\" is not supported");
+        }
+
+        numValues += header.numValues;
+    }
+}
+
+// Load next row group that can't be skipped, return false if there is none.
+bool ParquetReader::nextRowGroup() {
+    while (this->rowGroupIndex < this->metaData.rowGroups.size()) {
+        const ParquetRowGroup &rowGroup = this->metaData.rowGroups[this->rowGroupIndex++];
+
+        if (this->canSkipRowGroup(rowGroup)) {
+            S3DEBUG("Skip row group %" PRIu64 " of %s", this->rowGroupIndex - 1,
+                    this->s3Url.getFullUrlForCurl().c_str());
+            this->skippedRowGroups++;
+            continue;
+        }
+
+        for (uint64_t i = 0; i < this->values.size(); i++) {
+            this->values[i].clear();
+
+            int64_t index = this->columnIndexes[i];
+            if (index < 0) {
+                continue;
+            }
+
+            this->readColumnChunk(rowGroup.columns[index], this->metaData.columns[index],
+                                  this->scanDesc.columns[i].kind, this->values[i]);
+            S3_CHECK_OR_DIE(this->values[i].nulls.size() == (uint64_t)rowGroup.numRows,
+                            S3ParquetError, "Parquet column \"" + this->scanDesc.columns[i].name +
+                                                "\" doesn't match the rows of row group");
+        }
+
+        this->numRows = rowGroup.numRows;
+        this->rowIndex = 0;
+        return true;
+    }
+
+    return false;
+}
+
+// Put rows of current row group into rowBuffer, until it has at least count bytes.
+void ParquetReader::fillRows(uint64_t count) {
+    while (this->rowIndex < this->numRows && this->rowBuffer.size() < count) {
+        uint64_t rowStart = this->rowBuffer.size();
+        AppendRaw<uint32_t>(this->rowBuffer, 0);  // length, set below
+
+        for (uint64_t i = 0; i < this->values.size(); i++) {
+            ParquetValueKind kind = this->scanDesc.columns[i].kind;
+            ParquetColumnValues &columnValues = this->values[i];
+
+            if (this->columnIndexes[i] < 0 || columnValues.nulls[this->rowIndex]) {
+                this->rowBuffer.push_back(1);
+                continue;
+            }
+
+            uint64_t len = ValueLength(kind, columnValues.data, columnValues.cursor);
+            this->rowBuffer.push_back(0);
+            this->rowBuffer.append(columnValues.data, columnValues.cursor, len);
+            columnValues.cursor += len;
+        }
+
+        uint32_t rowLen = this->rowBuffer.size() - rowStart - sizeof(uint32_t);
+        memcpy(&this->rowBuffer[rowStart], &rowLen, sizeof(rowLen));
+
+        this->rowIndex++;
+    }
+}
+
+uint64_t ParquetReader::read(char *buf, uint64_t count) {
+    while (this->rowBufferOffset == this->rowBuffer.size()) {
+        this->rowBuffer.clear();
+        this->rowBufferOffset = 0;
+
+        if (this->rowIndex == this->numRows && !this->nextRowGroup()) {
+            return 0;
+        }
+
+        this->fillRows(count);
+    }
+
+    uint64_t len = std::min(count, this->rowBuffer.size() - this->rowBufferOffset);
+    memcpy(buf, this->rowBuffer.data() + this->rowBufferOffset, len);
+    this->rowBufferOffset += len;
+
+    return len;
+}
+
+void ParquetReader::close() {
+    this->metaData = ParquetFileMetaData();
+    this->columnIndexes.clear();
+    this->values.clear();
+
+    this->rowGroupIndex = 0;
+    this->numRows = 0;
+    this->rowIndex = 0;
+
+    this->rowBuffer.clear();
+    this->rowBufferOffset = 0;
+}
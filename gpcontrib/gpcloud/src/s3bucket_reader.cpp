@@ -1,13 +1,15 @@
 #include "s3bucket_reader.h"
 
 S3BucketReader::S3BucketReader() : Reader() {
-    this->keyIndex = 0;  // doesn't matter, be set in open()
+    this->itemIndex = 0;
 
     this->s3Interface = NULL;
     this->upstreamReader = NULL;
 
     this->needNewReader = true;
     this->isFirstFile = true;
+    this->splitKeys = true;
+    this->isKeyListChecked = false;
 }
 
 S3BucketReader::~S3BucketReader() {
@@ -17,7 +19,8 @@ S3BucketReader::~S3BucketReader() {
 void S3BucketReader::open(const S3Params& params) {
     this->params = params;
 
-    this->keyIndex = s3ext_segid;  // we may change it in unit tests
+    this->itemIndex = 0;
+    this->isKeyListChecked = false;
 
     S3_CHECK_OR_DIE(this->s3Interface != NULL, S3RuntimeError, "s3Interface is NULL");
 
@@ -27,26 +30,138 @@ void S3BucketReader::open(const S3Params& params) {
                     s3Url.getFullUrlForCurl());
 
     this->keyList = this->s3Interface->listBucket(s3Url);
-}
 
-BucketContent& S3BucketReader::getNextKey() {
-    BucketContent& key = this->keyList.contents[this->keyIndex];
-    this->keyIndex += s3ext_segnum;
-    return key;
+    this->planReadItems();
 }
 
-S3Params S3BucketReader::constructReaderParams(BucketContent& key) {
-    // encode the key name but leave the "/"
-    // "/encoded_path/encoded_name"
-    string keyEncoded = UriEncode(key.getName());
+// "/encoded_path/encoded_name", encode the key name but leave the "/"
+static string EncodeKeyName(const string& name) {
+    string keyEncoded = UriEncode(name);
     FindAndReplace(keyEncoded, "%2F", "/");
+    return keyEncoded;
+}
+
+// Decided by the name alone, probing every large key would cost a GET per key on every segment. A
+// compressed key without such an extension is still read whole, see S3CommonReader::open().
+bool S3BucketReader::isPlainKey(const BucketContent& key) {
+    S3Url keyUrl = this->params.setPrefix(EncodeKeyName(key.getName())).getS3Url();
+    string ext = keyUrl.getExtension();
+    return ext != ".gz" && ext != ".deflate" && ext != ".zst";
+}
+
+// Distribute keys to segments by size instead of by number. Large uncompressed keys are split into
+// line-aligned ranges, then items are assigned largest first to the least loaded segment. Every
+// segment computes the same plan from the same listing, and keeps its own items. Segments can't
+// share one listing, checkKeyList() tells whether theirs may have differed.
+void S3BucketReader::planReadItems() {
+    const vector<BucketContent>& contents = this->keyList.contents;
+    uint64_t segNum = std::max(s3ext_segnum, 1);
+
+    uint64_t totalSize = 0;
+    for (uint64_t i = 0; i < contents.size(); i++) {
+        totalSize += contents[i].getSize();
+    }
+
+    uint64_t splitSize = std::max(this->params.getChunkSize(), (uint64_t)S3_KEY_SPLIT_MIN_SIZE);
+    splitSize = std::max(splitSize, (totalSize + segNum - 1) / segNum);
+
+    vector<BucketReadItem> items;
+    for (uint64_t i = 0; i < contents.size(); i++) {
+        uint64_t size = contents[i].getSize();
+
+        // Header line is only in the first range of key, so don't split it.
+        if (!this->splitKeys || segNum == 1 || hasHeader || size <= splitSize ||
+            !this->isPlainKey(contents[i])) {
+            items.push_back({i, 0, size, false});
+            continue;
+        }
+
+        uint64_t numOfRanges = (size + splitSize - 1) / splitSize;
+        uint64_t rangeSize = size / numOfRanges;
+        for (uint64_t r = 0; r < numOfRanges; r++) {
+            uint64_t offset = r * rangeSize;
+            uint64_t length = (r == numOfRanges - 1) ? size - offset : rangeSize;
+            items.push_back({i, offset, length, true});
+        }
+    }
+
+    // Largest first, in listing order on ties.
+    vector<uint64_t> order(items.size());
+    for (uint64_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&items](uint64_t a, uint64_t b) {
+        return items[a].length > items[b].length;
+    });
+
+    // (bytes assigned, segment id), the lowest segment id on ties.
+    typedef std::pair<uint64_t, uint64_t> SegmentLoad;
+    std::priority_queue<SegmentLoad, vector<SegmentLoad>, std::greater<SegmentLoad>> loads;
+    for (uint64_t seg = 0; seg < segNum; seg++) {
+        loads.push(SegmentLoad(0, seg));
+    }
+
+    vector<bool> isMine(items.size(), false);
+    for (uint64_t i = 0; i < order.size(); i++) {
+        SegmentLoad load = loads.top();
+        loads.pop();
 
-    S3Params readerParams = this->params.setPrefix(keyEncoded);
+        isMine[order[i]] = (load.second == (uint64_t)s3ext_segid);
+        load.first += items[order[i]].length;
+        loads.push(load);
+    }
+
+    this->readItems.clear();
+    for (uint64_t i = 0; i < items.size(); i++) {
+        if (isMine[i]) {
+            this->readItems.push_back(items[i]);
+        }
+    }
+
+    S3DEBUG("Segment %d reads %zu of %zu items, split size is %" PRIu64, s3ext_segid,
+            this->readItems.size(), items.size(), splitSize);
+}
+
+// A segment that listed the bucket before a key was added, removed or resized plans differently
+// from one that listed it after, and keys would be read twice or not at all. So once this segment
+// has read its items, list the bucket again and fail if it is no longer what the plan came from.
+// A change made after every segment has listed the bucket changes no plan, but is still reported.
+void S3BucketReader::checkKeyList() {
+    if (this->isKeyListChecked || s3ext_segnum <= 1) {
+        return;
+    }
+    this->isKeyListChecked = true;
+
+    ListBucketResult current = this->s3Interface->listBucket(this->params.getS3Url());
+
+    bool isSame = (current.contents.size() == this->keyList.contents.size());
+    for (uint64_t i = 0; isSame && i < current.contents.size(); i++) {
+        isSame = (current.contents[i].getName() == this->keyList.contents[i].getName()) &&
+                 (current.contents[i].getSize() == this->keyList.contents[i].getSize());
+    }
+
+    S3_CHECK_OR_DIE(isSame, S3RuntimeError,
+                    "keys of " + this->params.getS3Url().getFullUrlForCurl() +
+                        " changed while reading, segments may have read different keys");
+}
+
+const BucketReadItem& S3BucketReader::getNextItem() {
+    return this->readItems[this->itemIndex++];
+}
+
+S3Params S3BucketReader::constructReaderParams(const BucketReadItem& item) {
+    const BucketContent& key = this->keyList.contents[item.keyIndex];
+
+    S3Params readerParams = this->params.setPrefix(EncodeKeyName(key.getName()));
 
     readerParams.setKeySize(key.getSize());
+    if (item.isRange) {
+        readerParams.setKeyRange(item.offset, item.length);
+    }
 
-    S3DEBUG("key: %s, size: %" PRIu64, readerParams.getS3Url().getFullUrlForCurl().c_str(),
-            readerParams.getKeySize());
+    S3DEBUG("key: %s, size: %" PRIu64 ", range: %" PRIu64 "+%" PRIu64,
+            readerParams.getS3Url().getFullUrlForCurl().c_str(), readerParams.getKeySize(),
+            item.offset, item.length);
     return readerParams;
 }
 
@@ -98,13 +213,14 @@ uint64_t S3BucketReader::read(char* buf, uint64_t count) {
     uint64_t readCount = 0;
     while (true) {
         if (this->needNewReader) {
-            if (this->keyIndex >= this->keyList.contents.size()) {
+            if (this->itemIndex >= this->readItems.size()) {
+                this->checkKeyList();
                 S3DEBUG("Read finished for segment: %d", s3ext_segid);
                 return 0;
             }
-            BucketContent& key = this->getNextKey();
+            const BucketReadItem& item = this->getNextItem();
 
-            this->upstreamReader->open(constructReaderParams(key));
+            this->upstreamReader->open(constructReaderParams(item));
             this->needNewReader = false;
 
             // ignore header line if it is not the first file
@@ -137,4 +253,6 @@ void S3BucketReader::close() {
     if (!this->keyList.contents.empty()) {
         this->keyList.contents.clear();
     }
+
+    this->readItems.clear();
 }
\ No newline at end of file
@@ -5,11 +5,41 @@ void S3CommonReader::open(const S3Params &params) {
 
     S3CompressionType compressionType = s3InterfaceService->checkCompressionType(params.getS3Url());
 
+    // A compressed key can't be decoded from the middle. The bucket reader only splits keys by
+    // their names, so the reader of the first range reads the whole key and the others skip it.
+    S3Params keyParams = params;
+    if (params.hasKeyRange() && compressionType != S3_COMPRESSION_PLAIN) {
+        if (params.getKeyRangeOffset() != 0) {
+            S3DEBUG("Skipped range of compressed key %s",
+                    params.getS3Url().getFullUrlForCurl().c_str());
+            this->upstreamReader = NULL;
+            return;
+        }
+        keyParams.setKeyRange(0, 0);
+    }
+
     switch (compressionType) {
         case S3_COMPRESSION_DEFLATE:
         case S3_COMPRESSION_GZIP:
-            this->upstreamReader = &this->decompressReader;
-            this->decompressReader.setReader(&this->keyReader);
+            // gzip members are independent, they can be decompressed in parallel.
+            if (compressionType == S3_COMPRESSION_GZIP && params.getNumOfChunks() > 1) {
+                this->upstreamReader = &this->parallelDecompressReader;
+                this->parallelDecompressReader.setReader(&this->keyReader);
+                this->parallelDecompressReader.setCompressionType(S3_COMPRESSION_GZIP);
+            } else {
+                this->upstreamReader = &this->decompressReader;
+                this->decompressReader.setReader(&this->keyReader);
+            }
+            break;
+        case S3_COMPRESSION_ZSTD:
+#ifdef HAVE_LIBZSTD
+            // zstd frames are independent, they are decompressed in parallel as gzip members.
+            this->upstreamReader = &this->parallelDecompressReader;
+            this->parallelDecompressReader.setReader(&this->keyReader);
+            this->parallelDecompressReader.setCompressionType(S3_COMPRESSION_ZSTD);
+#else
+            S3_DIE(S3RuntimeError, "zstd compressed data is not supported: built without libzstd");
+#endif
             break;
         case S3_COMPRESSION_PLAIN:
             this->upstreamReader = &this->keyReader;
@@ -18,12 +48,15 @@ void S3CommonReader::open(const S3Params &params) {
             S3_CHECK_OR_DIE(false, S3RuntimeError, "unknown file type");
     };
 
-    this->upstreamReader->open(params);
+    this->upstreamReader->open(keyParams);
 }
 
 // read() attempts to read up to count bytes into the buffer.
 // Return 0 if EOF. Throw exception if encounters errors.
 uint64_t S3CommonReader::read(char *buf, uint64_t count) {
+    if (this->upstreamReader == NULL) {
+        return 0;
+    }
     return this->upstreamReader->read(buf, count);
 }
 
@@ -113,10 +113,18 @@ S3Params InitConfig(const string& urlWithOptions) {
     int64_t lowSpeedTime = s3Cfg.SafeScan("low_speed_time", configSection, 60, 0, INT_MAX);
     params.setLowSpeedTime(lowSpeedTime);
 
+    int64_t keepAliveIdleTime =
+        s3Cfg.SafeScan("keepalive_idle_time", configSection, 60, 0, INT_MAX);
+    params.setKeepAliveIdleTime(keepAliveIdleTime);
+
     params.setProxy(s3Cfg.Get(configSection, "proxy", ""));
 
     params.setAutoCompress(s3Cfg.GetBool(configSection, "autocompress", "true"));
 
+    int64_t compressMemberSize =
+        s3Cfg.SafeScan("compress_member_size", configSection, 0, 0, INT_MAX);
+    params.setCompressMemberSize(compressMemberSize);
+
     params.setVerifyCert(s3Cfg.GetBool(configSection, "verifycert", "true"));
 
     string sse_type = s3Cfg.Get(configSection, "server_side_encryption", "");
@@ -189,9 +189,30 @@ void S3KeyReader::open(const S3Params& params) {
     this->numOfChunks = params.getNumOfChunks();
     S3_CHECK_OR_DIE(this->numOfChunks > 0, S3RuntimeError, "numOfChunks must not be zero");
 
-    this->offsetMgr.setKeySize(params.getKeySize());
+    this->keySize = params.getKeySize();
+    this->offsetMgr.setKeySize(this->keySize);
     this->offsetMgr.setChunkSize(params.getChunkSize());
 
+    if (params.hasKeyRange()) {
+        uint64_t rangeStart = params.getKeyRangeOffset();
+        uint64_t rangeEnd = std::min(rangeStart + params.getKeyRangeLength(), this->keySize);
+
+        S3_CHECK_OR_DIE(rangeStart < this->keySize, S3RuntimeError,
+                        "key range must start before the end of key");
+
+        if (rangeStart > 0) {
+            this->fetchStart = rangeStart - 1;
+            this->lineSkipPending = true;
+        }
+
+        this->offsetMgr.setCurPos(this->fetchStart);
+        this->offsetMgr.setKeySize(rangeEnd);
+
+        this->s3Url = params.getS3Url();
+        this->tailOffset = rangeEnd;
+        this->tailPending = rangeEnd < this->keySize;
+    }
+
     S3_CHECK_OR_DIE(params.getChunkSize() > 0, S3RuntimeError,
                     "chunk size must be greater than zero");
 
@@ -210,22 +231,19 @@ void S3KeyReader::open(const S3Params& params) {
     }
 }
 
-uint64_t S3KeyReader::read(char* buf, uint64_t count) {
-    uint64_t fileLen = this->offsetMgr.getKeySize();
+// Lines of a key range are split at the last char of line terminator.
+static char LineDelimiter() {
+    return eolString[strlen(eolString) - 1];
+}
+
+// Read data of the chunks, return 0 when all data of the key or key range is read.
+uint64_t S3KeyReader::readChunks(char* buf, uint64_t count) {
+    uint64_t fileLen = this->offsetMgr.getKeySize() - this->fetchStart;
     uint64_t readLen = 0;
 
     do {
         // confirm there is no more available data, done with this file
         if (this->transferredKeyLen >= fileLen) {
-            if (!this->hasEol && !this->eolAppended) {
-                uint64_t eolLen = strlen(eolString);
-                memcpy(buf, eolString, eolLen);
-
-                this->eolAppended = true;
-
-                return eolLen;
-            }
-
             return 0;
         }
 
@@ -246,6 +264,11 @@ uint64_t S3KeyReader::read(char* buf, uint64_t count) {
             if (buf[readLen - 1] == '\r' || buf[readLen - 1] == '\n') {
                 this->hasEol = true;
             }
+
+            // the last line ends right at the end of range.
+            if (buf[readLen - 1] == LineDelimiter()) {
+                this->tailPending = false;
+            }
         }
 
         if (readLen < count) {
@@ -259,6 +282,80 @@ uint64_t S3KeyReader::read(char* buf, uint64_t count) {
     return readLen;
 }
 
+// Read the last line of key range beyond the end of range, until the line ends.
+uint64_t S3KeyReader::readPastRangeEnd(char* buf, uint64_t count) {
+    uint64_t len = std::min(count, (uint64_t)S3_KEY_RANGE_TAIL_SIZE);
+    len = std::min(len, this->keySize - this->tailOffset);
+
+    S3VectorUInt8 data;
+    uint64_t readLen = this->s3Interface->fetchData(this->tailOffset, data, len, this->s3Url);
+    S3_CHECK_OR_DIE(readLen == len, S3PartialResponseError, len, readLen);
+
+    const uint8_t* lineEnd = (const uint8_t*)memchr(data.data(), LineDelimiter(), len);
+    if (lineEnd != NULL) {
+        readLen = lineEnd - data.data() + 1;
+        this->tailPending = false;
+        this->hasEol = true;
+    }
+
+    memcpy(buf, data.data(), readLen);
+    this->tailOffset += readLen;
+
+    if (this->tailOffset >= this->keySize) {
+        this->tailPending = false;
+        this->hasEol = (buf[readLen - 1] == '\r' || buf[readLen - 1] == '\n');
+    }
+
+    return readLen;
+}
+
+uint64_t S3KeyReader::read(char* buf, uint64_t count) {
+    uint64_t readLen = 0;
+
+    // the range starts in the middle of a line read by previous range, skip it.
+    while (this->lineSkipPending) {
+        readLen = this->readChunks(buf, count);
+        if (readLen == 0) {
+            // no line starts in this range, nothing to read.
+            this->lineSkipPending = false;
+            this->tailPending = false;
+            this->hasEol = true;
+            return 0;
+        }
+
+        char* lineEnd = (char*)memchr(buf, LineDelimiter(), readLen);
+        if (lineEnd != NULL) {
+            this->lineSkipPending = false;
+
+            readLen = buf + readLen - (lineEnd + 1);
+            memmove(buf, lineEnd + 1, readLen);
+            if (readLen != 0) {
+                return readLen;
+            }
+        }
+    }
+
+    readLen = this->readChunks(buf, count);
+    if (readLen != 0) {
+        return readLen;
+    }
+
+    if (this->tailPending) {
+        return this->readPastRangeEnd(buf, count);
+    }
+
+    if (!this->hasEol && !this->eolAppended) {
+        uint64_t eolLen = strlen(eolString);
+        memcpy(buf, eolString, eolLen);
+
+        this->eolAppended = true;
+
+        return eolLen;
+    }
+
+    return 0;
+}
+
 // reset marks before reading next key
 void S3KeyReader::reset() {
     this->sharedError = false;
@@ -272,6 +369,12 @@ void S3KeyReader::reset() {
 
     this->hasEol = false;
     this->eolAppended = false;
+
+    this->keySize = 0;
+    this->fetchStart = 0;
+    this->tailOffset = 0;
+    this->lineSkipPending = false;
+    this->tailPending = false;
 }
 
 void S3KeyReader::close() {
@@ -1,8 +1,99 @@
 #include "s3restful_service.h"
 
+S3CurlHandlePool &S3CurlHandlePool::getInstance() {
+    static S3CurlHandlePool pool;
+    return pool;
+}
+
+S3CurlHandlePool::S3CurlHandlePool() : createdNum(0), reusedNum(0) {
+    pthread_mutex_init(&this->mutex, NULL);
+
+    // Pooled handles may outlive the S3RESTfulService that created them, so the
+    // pool holds its own reference to curl's global state.
+    curl_global_init(CURL_GLOBAL_ALL);
+}
+
+S3CurlHandlePool::~S3CurlHandlePool() {
+    this->clear();
+    curl_global_cleanup();
+    pthread_mutex_destroy(&this->mutex);
+}
+
+CURL *S3CurlHandlePool::acquire(uint64_t idleTime) {
+    UniqueLock lock(&this->mutex);
+    time_t now = time(NULL);
+
+    // the most recently released handles are at the end
+    while (!this->idleHandles.empty()) {
+        IdleHandle handle = this->idleHandles.back();
+        this->idleHandles.pop_back();
+
+        if ((uint64_t)(now - handle.releasedAt) < idleTime) {
+            this->reusedNum++;
+            S3DEBUG("Reused curl handle %p, %" PRIu64 " reused and %" PRIu64 " created so far",
+                    handle.curl, this->reusedNum, this->createdNum);
+            return handle.curl;
+        }
+
+        // all the remaining ones are older, clean them up as well
+        curl_easy_cleanup(handle.curl);
+        while (!this->idleHandles.empty()) {
+            curl_easy_cleanup(this->idleHandles.back().curl);
+            this->idleHandles.pop_back();
+        }
+    }
+
+    this->createdNum++;
+    S3DEBUG("Created curl handle, %" PRIu64 " reused and %" PRIu64 " created so far",
+            this->reusedNum, this->createdNum);
+    return curl_easy_init();
+}
+
+void S3CurlHandlePool::release(CURL *curl) {
+    if (curl == NULL) {
+        return;
+    }
+
+    // curl_easy_reset() clears the options but keeps the live connections.
+    curl_easy_reset(curl);
+
+    UniqueLock lock(&this->mutex);
+    if (this->idleHandles.size() >= S3_CURL_POOL_MAX_IDLE) {
+        curl_easy_cleanup(curl);
+        return;
+    }
+
+    IdleHandle handle = {curl, time(NULL)};
+    this->idleHandles.push_back(handle);
+}
+
+void S3CurlHandlePool::clear() {
+    UniqueLock lock(&this->mutex);
+    for (size_t i = 0; i < this->idleHandles.size(); i++) {
+        curl_easy_cleanup(this->idleHandles[i].curl);
+    }
+    this->idleHandles.clear();
+}
+
+uint64_t S3CurlHandlePool::getIdleNum() {
+    UniqueLock lock(&this->mutex);
+    return this->idleHandles.size();
+}
+
+uint64_t S3CurlHandlePool::getCreatedNum() {
+    UniqueLock lock(&this->mutex);
+    return this->createdNum;
+}
+
+uint64_t S3CurlHandlePool::getReusedNum() {
+    UniqueLock lock(&this->mutex);
+    return this->reusedNum;
+}
+
 S3RESTfulService::S3RESTfulService()
     : lowSpeedLimit(0),
       lowSpeedTime(0),
+      keepAliveIdleTime(0),
       proxy(""),
       debugCurl(false),
       verifyCert(true),
@@ -12,6 +103,7 @@ S3RESTfulService::S3RESTfulService()
 S3RESTfulService::S3RESTfulService(const string &proxy)
     : lowSpeedLimit(0),
       lowSpeedTime(0),
+      keepAliveIdleTime(0),
       proxy(proxy),
       debugCurl(false),
       verifyCert(true),
@@ -26,6 +118,12 @@ S3RESTfulService::S3RESTfulService(const S3Params &params)
 
     this->lowSpeedLimit = params.getLowSpeedLimit();
     this->lowSpeedTime = params.getLowSpeedTime();
+    this->keepAliveIdleTime = params.getKeepAliveIdleTime();
+    if (this->keepAliveIdleTime > 0) {
+        // Create the pool here rather than in the downloading threads, since
+        // its constructor calls curl_global_init().
+        S3CurlHandlePool::getInstance();
+    }
     this->debugCurl = params.isDebugCurl();
     this->chunkBufferSize = params.getChunkSize();
     this->verifyCert = params.isVerifyCert();
@@ -96,10 +194,15 @@ static size_t RESTfulServiceReadFuncCallback(char *ptr, size_t size, size_t nmem
 
 struct CURLWrapper {
     CURLWrapper(const string &url, curl_slist *headers, uint64_t lowSpeedLimit,
-                uint64_t lowSpeedTime, bool debugCurl, string proxy) {
-        curl = curl_easy_init();
+                uint64_t lowSpeedTime, uint64_t keepAliveIdleTime, bool debugCurl, string proxy)
+        : pooled(keepAliveIdleTime > 0) {
+        if (pooled) {
+            curl = S3CurlHandlePool::getInstance().acquire(keepAliveIdleTime);
+        } else {
+            curl = curl_easy_init();
+            curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+        }
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
         curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
         curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, lowSpeedLimit);
@@ -114,9 +217,14 @@ struct CURLWrapper {
         }
     }
     ~CURLWrapper() {
-        curl_easy_cleanup(curl);
+        if (pooled) {
+            S3CurlHandlePool::getInstance().release(curl);
+        } else {
+            curl_easy_cleanup(curl);
+        }
     }
     CURL *curl;
+    bool pooled;
 };
 
 void S3RESTfulService::performCurl(CURL *curl, Response &response) {
@@ -149,7 +257,7 @@ Response S3RESTfulService::get(const string &url, HTTPHeaders &headers) {
 
     headers.CreateList();
     CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+                        this->keepAliveIdleTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
@@ -182,7 +290,7 @@ Response S3RESTfulService::put(const string &url, HTTPHeaders &headers, const S3
 
     headers.CreateList();
     CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+                        this->keepAliveIdleTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
@@ -225,7 +333,7 @@ Response S3RESTfulService::post(const string &url, HTTPHeaders &headers,
 
     headers.CreateList();
     CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+                        this->keepAliveIdleTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
@@ -270,7 +378,7 @@ ResponseCode S3RESTfulService::head(const string &url, HTTPHeaders &headers) {
 
     headers.CreateList();
     CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+                        this->keepAliveIdleTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "HEAD");
@@ -303,7 +411,7 @@ Response S3RESTfulService::deleteRequest(const string &url, HTTPHeaders &headers
 
     headers.CreateList();
     CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
-                        this->debugCurl, this->proxy);
+                        this->keepAliveIdleTime, this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
@@ -176,6 +176,58 @@ TEST_F(CompressWriterTest, AbleToWriteLargerThanCompressChunkSize) {
     delete[] result;
 }
 
+TEST_F(CompressWriterTest, AbleToWriteMultipleMembers) {
+    const char pangram[] = "The quick brown fox jumps over the lazy dog\n";
+    string input;
+    for (uint64_t i = 0; i < 1000; i++) input.append(pangram);
+
+    // reopen with member size, dropping the empty member written by close().
+    compressWriter.close();
+    writer.getRawDataVector().clear();
+
+    S3Params params("s3://abc/def");
+    params.setCompressMemberSize(10000);
+    compressWriter.open(params);
+    compressWriter.write(input.c_str(), input.length());
+    compressWriter.close();
+
+    // every member is a complete gzip stream of at most 10000 bytes of data, with its compressed
+    // size in the size subfield of its header.
+    Byte *compressed = (Byte *)writer.getRawData();
+    uint64_t compressedLen = writer.getDataSize();
+    string result;
+    uint64_t members = 0;
+    while (compressedLen > 0) {
+        z_stream zstream;
+        memset(&zstream, 0, sizeof(zstream));
+        ASSERT_EQ(Z_OK, inflateInit2(&zstream, S3_DEFLATE_WINDOWSBITS));
+
+        zstream.next_in = compressed;
+        zstream.avail_in = compressedLen;
+        zstream.next_out = this->out;
+        zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
+        ASSERT_EQ(Z_STREAM_END, inflate(&zstream, Z_FINISH));
+        EXPECT_GE((uint64_t)10000, zstream.total_out);
+
+        ASSERT_LT((uint64_t)20, zstream.total_in);
+        EXPECT_TRUE(compressed[3] & 0x04);  // FEXTRA
+        EXPECT_EQ(S3_GZIP_SIZE_SUBFIELD_ID1, compressed[12]);
+        EXPECT_EQ(S3_GZIP_SIZE_SUBFIELD_ID2, compressed[13]);
+        EXPECT_EQ(S3_GZIP_SIZE_SUBFIELD_LEN, compressed[14] | (compressed[15] << 8));
+        EXPECT_EQ(zstream.total_in, (uint64_t)compressed[16] | (compressed[17] << 8) |
+                                        (compressed[18] << 16) | ((uint64_t)compressed[19] << 24));
+
+        result.append((const char *)this->out, zstream.total_out);
+        compressed += zstream.total_in;
+        compressedLen -= zstream.total_in;
+        members++;
+        inflateEnd(&zstream);
+    }
+
+    EXPECT_EQ((uint64_t)5, members);
+    EXPECT_EQ(input, result);
+}
+
 // Compress compressed data may generate larger output than input after GZIP compression.
 TEST_F(CompressWriterTest, CompressCompressedData) {
     std::random_device rd;
@@ -311,3 +311,36 @@ TEST_F(DecompressReaderTest, AbleToDecompressWithIncorrectEncodedStream) {
 
     EXPECT_THROW(decompressReader.read(outputBuffer, sizeof(outputBuffer)), S3RuntimeError);
 }
+
+TEST_F(DecompressReaderTest, AbleToDecompressConcatenatedGzipMembers) {
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+
+    // 'cat a.gz b.gz' produces a valid gzip file of two members.
+    string data;
+    for (int i = 0; i < 2; i++) {
+        z_stream zstream;
+        memset(&zstream, 0, sizeof(zstream));
+        deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, S3_DEFLATE_WINDOWSBITS, 8,
+                     Z_DEFAULT_STRATEGY);
+
+        zstream.next_in = (Byte *)hello;
+        zstream.avail_in = sizeof(hello);
+        zstream.next_out = compressionBuff;
+        zstream.avail_out = sizeof(compressionBuff);
+        deflate(&zstream, Z_FINISH);
+        data.append((const char *)compressionBuff, zstream.total_out);
+        deflateEnd(&zstream);
+    }
+    data.append("trailing garbage");
+    bufReader.setData(data.data(), data.size());
+
+    char buf[10000];
+    uint64_t offset = 0, count;
+    while ((count = decompressReader.read(buf + offset, sizeof(buf) - offset)) > 0) {
+        offset += count;
+    }
+
+    EXPECT_EQ(sizeof(hello) * 2, offset);
+    EXPECT_EQ(0, memcmp(hello, buf, sizeof(hello)));
+    EXPECT_EQ(0, memcmp(hello, buf + sizeof(hello), sizeof(hello)));
+}
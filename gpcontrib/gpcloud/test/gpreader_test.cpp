@@ -96,6 +96,42 @@ TEST_F(GPReaderTest, Close) {
     EXPECT_TRUE(keyList.contents.empty());
 }
 
+TEST_F(GPReaderTest, KeysAreSplitOnlyForText) {
+    string url = "s3://s3-us-west-2.amazonaws.com/s3test.pivotal.io/dataset1/normal";
+    S3Params p(url);
+
+    MockS3RESTfulService mockRESTfulService(p);
+
+    XMLGenerator generator;
+    XMLGenerator* gen = &generator;
+    gen->setName("s3test.pivotal.io")
+        ->setPrefix("big/")
+        ->setIsTruncated(false)
+        ->pushBuckentContent(BucketContent("big/", 0))
+        ->pushBuckentContent(BucketContent("big/big", 400 * 1024 * 1024));
+
+    Response response(RESPONSE_OK, gen->toXML());
+
+    EXPECT_CALL(mockRESTfulService, get(_, _)).Times(2).WillRepeatedly(Return(response));
+
+    s3ext_segid = 0;
+    s3ext_segnum = 4;
+
+    // CSV and custom formats are read whole
+    MockGPReader csvReader(p, &mockRESTfulService);
+    csvReader.open(p);
+    ASSERT_EQ((uint64_t)1, csvReader.getBucketReader().getReadItems().size());
+    EXPECT_FALSE(csvReader.getBucketReader().getReadItems()[0].isRange);
+
+    MockGPReader textReader(p, &mockRESTfulService);
+    textReader.setSplitKeys(true);
+    textReader.open(p);
+    ASSERT_EQ((uint64_t)1, textReader.getBucketReader().getReadItems().size());
+    EXPECT_TRUE(textReader.getBucketReader().getReadItems()[0].isRange);
+
+    s3ext_segnum = 1;
+}
+
 TEST_F(GPReaderTest, ReadSmallData) {
     string url = "s3://s3-us-west-2.amazonaws.com/s3test.pivotal.io/dataset1/normal";
     S3Params p = InitConfig(url + " config=data/s3test.conf");
@@ -0,0 +1,537 @@
+#include "parallel_decompress_reader.cpp"
+#include <random>
+#include "gtest/gtest.h"
+
+class MockGzipDataReader : public Reader {
+   public:
+    MockGzipDataReader() : offset(0), chunkSize(1024 * 1024) {
+    }
+
+    void open(const S3Params &params) {
+        this->offset = 0;
+    }
+    void close() {
+    }
+
+    uint64_t read(char *buf, uint64_t count) {
+        uint64_t size = std::min(std::min(this->data.size() - this->offset, count), chunkSize);
+        memcpy(buf, this->data.data() + this->offset, size);
+        this->offset += size;
+        return size;
+    }
+
+    void setChunkSize(uint64_t size) {
+        this->chunkSize = size;
+    }
+
+    string data;
+
+   private:
+    uint64_t offset;
+    uint64_t chunkSize;
+};
+
+// Compress data as a gzip member, with extra as the extra field of its header if not empty.
+static string GzipData(const string &data, int level = Z_DEFAULT_COMPRESSION,
+                       const string &extra = "") {
+    z_stream zstream;
+    memset(&zstream, 0, sizeof(zstream));
+    deflateInit2(&zstream, level, Z_DEFLATED, S3_DEFLATE_WINDOWSBITS, 8, Z_DEFAULT_STRATEGY);
+
+    gz_header header;
+    memset(&header, 0, sizeof(header));
+    if (!extra.empty()) {
+        header.extra = (Byte *)extra.data();
+        header.extra_len = extra.size();
+        deflateSetHeader(&zstream, &header);
+    }
+
+    string out(deflateBound(&zstream, data.size()) + extra.size() + 2, '\0');
+    zstream.next_in = (Byte *)data.data();
+    zstream.avail_in = data.size();
+    zstream.next_out = (Byte *)&out[0];
+    zstream.avail_out = out.size();
+    deflate(&zstream, Z_FINISH);
+    out.resize(zstream.total_out);
+    deflateEnd(&zstream);
+
+    return out;
+}
+
+static void PutLittleEndian(string &data, uint64_t offset, uint64_t value, uint64_t len) {
+    for (uint64_t i = 0; i < len; i++) {
+        data[offset + i] = (char)(value >> (8 * i));
+    }
+}
+
+// Compress data as a gzip member with the size subfield, as CompressWriter writes.
+static string SizedGzipData(const string &data, int level = Z_DEFAULT_COMPRESSION) {
+    string member = GzipData(data, level, string("SZ\x04\x00\x00\x00\x00\x00", 8));
+    PutLittleEndian(member, 16, member.size(), 4);
+    return member;
+}
+
+// Compress data as a BGZF block, as bgzip writes.
+static string BgzfData(const string &data) {
+    string member = GzipData(data, Z_DEFAULT_COMPRESSION, string("BC\x02\x00\x00\x00", 6));
+    PutLittleEndian(member, 16, member.size() - 1, 2);
+    return member;
+}
+
+static string RandomText(uint64_t len, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist('a', 'h');
+
+    string text(len, '\0');
+    for (uint64_t i = 0; i < len; i++) {
+        text[i] = (i % 64 == 63) ? '\n' : (char)dist(gen);
+    }
+    return text;
+}
+
+TEST(GetGzipMemberSize, SizeSubfields) {
+    string text = RandomText(1000, 1);
+
+    string sized = SizedGzipData(text);
+    EXPECT_EQ(sized.size(), GetGzipMemberSize((const Byte *)sized.data(), sized.size()));
+
+    string bgzf = BgzfData(text);
+    EXPECT_EQ(bgzf.size(), GetGzipMemberSize((const Byte *)bgzf.data(), bgzf.size()));
+
+    // other subfields are skipped.
+    string other = GzipData(text, Z_DEFAULT_COMPRESSION,
+                            string("AB\x01\x00\x00SZ\x04\x00\x00\x00\x00\x00", 13));
+    PutLittleEndian(other, 21, 12345, 4);
+    EXPECT_EQ((uint64_t)12345, GetGzipMemberSize((const Byte *)other.data(), other.size()));
+}
+
+TEST(GetGzipMemberSize, NoSize) {
+    string text = RandomText(1000, 1);
+
+    string plain = GzipData(text);
+    EXPECT_EQ((uint64_t)0, GetGzipMemberSize((const Byte *)plain.data(), plain.size()));
+
+    string other = GzipData(text, Z_DEFAULT_COMPRESSION, string("AB\x01\x00\x00", 5));
+    EXPECT_EQ((uint64_t)0, GetGzipMemberSize((const Byte *)other.data(), other.size()));
+
+    // the header is incomplete.
+    string sized = SizedGzipData(text);
+    EXPECT_EQ((uint64_t)0, GetGzipMemberSize((const Byte *)sized.data(), 18));
+}
+
+class ParallelDecompressReaderTest : public testing::Test {
+   protected:
+    virtual void SetUp() {
+        S3_ZIP_DECOMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
+        reader.setReader(&gzipReader);
+    }
+
+    virtual void TearDown() {
+        reader.close();
+        S3_ZIP_DECOMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
+    }
+
+    void open(uint64_t numOfThreads) {
+        S3Params params("s3://abc/def");
+        params.setNumOfChunks(numOfThreads);
+        reader.open(params);
+    }
+
+    string readAll(uint64_t bufSize = 4096) {
+        string result;
+        vector<char> buf(bufSize);
+
+        uint64_t len;
+        while ((len = reader.read(buf.data(), bufSize)) > 0) {
+            result.append(buf.data(), len);
+        }
+        return result;
+    }
+
+    MockGzipDataReader gzipReader;
+    ParallelDecompressReader reader;
+};
+
+TEST_F(ParallelDecompressReaderTest, SingleMemberIsReadSequentially) {
+    string text = RandomText(100000, 1);
+    gzipReader.data = GzipData(text);
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_EQ((uint64_t)0, this->readAll().size());
+    EXPECT_TRUE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, UnsizedMembersAreReadSequentially) {
+    // members written by 'cat' or pigz have no size, they are found only by decompressing.
+    string text;
+    for (unsigned int i = 0; i < 50; i++) {
+        string part = RandomText(10000 + i * 100, i);
+        text += part;
+        gzipReader.data += GzipData(part);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_TRUE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, SizedMembers) {
+    string text;
+    for (unsigned int i = 0; i < 50; i++) {
+        string part = RandomText(10000 + i * 100, i);
+        text += part;
+        gzipReader.data += SizedGzipData(part);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, SizedMembersWithOneThread) {
+    string text;
+    for (unsigned int i = 0; i < 20; i++) {
+        string part = RandomText(10000, i);
+        text += part;
+        gzipReader.data += SizedGzipData(part);
+    }
+
+    this->open(1);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, BgzfMembers) {
+    // bgzip ends a file with an empty block.
+    string text;
+    for (unsigned int i = 0; i < 50; i++) {
+        string part = RandomText(60000, i);
+        text += part;
+        gzipReader.data += BgzfData(part);
+    }
+    gzipReader.data += BgzfData("");
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, MembersAcrossBatches) {
+    // a batch is 4 * 2 * 4KB, members of about 3KB span batch boundaries.
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+    gzipReader.setChunkSize(1000);
+
+    string text;
+    for (unsigned int i = 0; i < 100; i++) {
+        string part = RandomText(5000 + i, i);
+        text += part;
+        gzipReader.data += SizedGzipData(part);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll(333));
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, MemberLargerThanBatch) {
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+
+    string small1 = RandomText(2000, 1);
+    string large = RandomText(500000, 2);
+    string small2 = RandomText(3000, 3);
+    gzipReader.data = SizedGzipData(small1) + SizedGzipData(large) + SizedGzipData(small2);
+
+    this->open(2);
+    EXPECT_EQ(small1 + large + small2, this->readAll());
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, MemberOutputOverLimit) {
+    // a member has at most 4 * 4KB of output for a worker, a larger one is decompressed as a
+    // stream though it is small enough for a batch.
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+
+    string small1 = RandomText(2000, 1);
+    string large(1000000, 'a');
+    string small2 = RandomText(3000, 3);
+    gzipReader.data = SizedGzipData(small1) + SizedGzipData(large) + SizedGzipData(small2);
+    ASSERT_GT((uint64_t)4 * 2 * 4 * 1024, gzipReader.data.size());
+
+    this->open(4);
+    EXPECT_EQ(small1 + large + small2, this->readAll());
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, UnsizedMembersAfterSizedMembers) {
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+
+    string text;
+    for (unsigned int i = 0; i < 20; i++) {
+        string part = RandomText(3000, i);
+        text += part;
+        gzipReader.data += (i < 10) ? SizedGzipData(part) : GzipData(part);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_TRUE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, HeaderLikeBytesInCompressedData) {
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+
+    // stored blocks keep the data as it is, so members contain many gzip header look-alikes.
+    string fake("\x1f\x8b\x08\x04\x00\x00\x00\x00\x00\x03\x08\x00SZ\x04\x00\x01\x00\x00\x00", 20);
+    string text;
+    for (unsigned int i = 0; i < 20; i++) {
+        string part;
+        for (unsigned int j = 0; j < 300; j++) {
+            part += fake + RandomText(i + 1, i * 1000 + j);
+        }
+        text += part;
+        gzipReader.data += SizedGzipData(part, Z_NO_COMPRESSION);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, EmptyMembers) {
+    string text = RandomText(1000, 1);
+    gzipReader.data =
+        SizedGzipData("") + SizedGzipData(text) + SizedGzipData("") + SizedGzipData("");
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderTest, EmptyUnsizedMembers) {
+    string text = RandomText(1000, 1);
+    gzipReader.data = GzipData("") + GzipData(text) + GzipData("") + GzipData("");
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderTest, TrailingGarbageIsIgnored) {
+    string text = RandomText(10000, 1);
+    gzipReader.data = SizedGzipData(text) + SizedGzipData(text) + string(100, '\0');
+
+    this->open(4);
+    EXPECT_EQ(text + text, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderTest, TruncatedMember) {
+    string text = RandomText(100000, 1);
+    string compressed = GzipData(text);
+    gzipReader.data = compressed.substr(0, compressed.size() / 2);
+
+    this->open(4);
+    string result = this->readAll();
+    EXPECT_LT(result.size(), text.size());
+    EXPECT_EQ(text.substr(0, result.size()), result);
+}
+
+TEST_F(ParallelDecompressReaderTest, TruncatedSizedMember) {
+    string text = RandomText(100000, 1);
+    string compressed = SizedGzipData(text);
+    gzipReader.data = SizedGzipData(text) + compressed.substr(0, compressed.size() / 2);
+
+    this->open(4);
+    string result = this->readAll();
+    EXPECT_LT(result.size(), text.size() * 2);
+    EXPECT_EQ((text + text).substr(0, result.size()), result);
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderTest, CorruptedMember) {
+    string text = RandomText(10000, 1);
+    string corrupted = GzipData(text);
+    corrupted[corrupted.size() / 2] ^= 0xff;
+    corrupted[corrupted.size() / 2 + 1] ^= 0xff;
+    corrupted[corrupted.size() - 8] ^= 0xff;  // CRC32 in the trailer
+    gzipReader.data = GzipData(text) + corrupted;
+
+    this->open(4);
+    EXPECT_THROW(this->readAll(), S3RuntimeError);
+}
+
+TEST_F(ParallelDecompressReaderTest, CorruptedSizedMember) {
+    string text = RandomText(10000, 1);
+    string corrupted = SizedGzipData(text);
+    corrupted[corrupted.size() - 8] ^= 0xff;  // CRC32 in the trailer
+    gzipReader.data = SizedGzipData(text) + corrupted + SizedGzipData(text);
+
+    this->open(4);
+    EXPECT_THROW(this->readAll(), S3RuntimeError);
+}
+
+TEST_F(ParallelDecompressReaderTest, ReopenWithSameWorkers) {
+    string text;
+    for (unsigned int i = 0; i < 10; i++) {
+        string part = RandomText(10000, i);
+        text += part;
+        gzipReader.data += SizedGzipData(part);
+    }
+
+    for (unsigned int i = 0; i < 3; i++) {
+        this->open(4);
+        EXPECT_EQ(text, this->readAll());
+        reader.close();
+    }
+}
+
+#ifdef HAVE_LIBZSTD
+
+// Compress data as a zstd frame, with its content size in the frame header if hasContentSize.
+static string ZstdData(const string &data, bool hasContentSize = true) {
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_contentSizeFlag, hasContentSize ? 1 : 0);
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+
+    string out(ZSTD_compressBound(data.size()), '\0');
+    size_t len = ZSTD_compress2(cctx, &out[0], out.size(), data.data(), data.size());
+    out.resize(ZSTD_isError(len) ? 0 : len);
+    ZSTD_freeCCtx(cctx);
+
+    return out;
+}
+
+// A skippable frame, like the seek table of zstd seekable format.
+static string ZstdSkippableData(const string &data) {
+    string frame(8, '\0');
+    PutLittleEndian(frame, 0, ZSTD_MAGIC_SKIPPABLE_START, 4);
+    PutLittleEndian(frame, 4, data.size(), 4);
+    return frame + data;
+}
+
+class ParallelDecompressReaderZstdTest : public ParallelDecompressReaderTest {
+   protected:
+    virtual void SetUp() {
+        ParallelDecompressReaderTest::SetUp();
+        reader.setCompressionType(S3_COMPRESSION_ZSTD);
+    }
+};
+
+TEST_F(ParallelDecompressReaderZstdTest, Frames) {
+    string text;
+    for (unsigned int i = 0; i < 50; i++) {
+        string part = RandomText(10000 + i * 100, i);
+        text += part;
+        gzipReader.data += ZstdData(part);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+    EXPECT_FALSE(reader.isSequential());
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, FramesWithOneThread) {
+    string text;
+    for (unsigned int i = 0; i < 20; i++) {
+        string part = RandomText(10000, i);
+        text += part;
+        gzipReader.data += ZstdData(part);
+    }
+
+    this->open(1);
+    EXPECT_EQ(text, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, FramesAcrossBatches) {
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+    gzipReader.setChunkSize(1000);
+
+    string text;
+    for (unsigned int i = 0; i < 100; i++) {
+        string part = RandomText(5000 + i, i);
+        text += part;
+        gzipReader.data += ZstdData(part);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll(333));
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, FramesWithoutContentSize) {
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+
+    string text;
+    for (unsigned int i = 0; i < 20; i++) {
+        string part = RandomText(3000, i);
+        text += part;
+        gzipReader.data += ZstdData(part, i % 3 != 0);
+    }
+
+    this->open(4);
+    EXPECT_EQ(text, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, FrameLargerThanBatch) {
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+
+    string small1 = RandomText(2000, 1);
+    string large = RandomText(500000, 2);
+    string small2 = RandomText(3000, 3);
+    gzipReader.data = ZstdData(small1) + ZstdData(large) + ZstdData(small2);
+
+    this->open(2);
+    EXPECT_EQ(small1 + large + small2, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, FrameOutputOverLimit) {
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 4 * 1024;
+
+    string small1 = RandomText(2000, 1);
+    string large(1000000, 'a');
+    string small2 = RandomText(3000, 3);
+    gzipReader.data = ZstdData(small1) + ZstdData(large) + ZstdData(small2);
+    ASSERT_GT((uint64_t)4 * 2 * 4 * 1024, gzipReader.data.size());
+
+    this->open(4);
+    EXPECT_EQ(small1 + large + small2, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, SkippableFrames) {
+    string text1 = RandomText(10000, 1);
+    string text2 = RandomText(10000, 2);
+    gzipReader.data = ZstdSkippableData("abc") + ZstdData(text1) + ZstdSkippableData("") +
+                      ZstdData(text2) + ZstdSkippableData(string(100, 'x'));
+
+    this->open(4);
+    EXPECT_EQ(text1 + text2, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, TrailingGarbageIsIgnored) {
+    string text = RandomText(10000, 1);
+    gzipReader.data = ZstdData(text) + ZstdData(text) + string(100, '\0');
+
+    this->open(4);
+    EXPECT_EQ(text + text, this->readAll());
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, TruncatedFrame) {
+    string text = RandomText(100000, 1);
+    string compressed = ZstdData(text);
+    gzipReader.data = ZstdData(text) + compressed.substr(0, compressed.size() / 2);
+
+    this->open(4);
+    string result = this->readAll();
+    EXPECT_LT(result.size(), text.size() * 2);
+    EXPECT_EQ((text + text).substr(0, result.size()), result);
+}
+
+TEST_F(ParallelDecompressReaderZstdTest, CorruptedFrame) {
+    string text = RandomText(10000, 1);
+    string corrupted = ZstdData(text);
+    corrupted[corrupted.size() / 2] ^= 0xff;
+    corrupted[corrupted.size() / 2 + 1] ^= 0xff;
+    gzipReader.data = ZstdData(text) + corrupted;
+
+    this->open(4);
+    EXPECT_THROW(this->readAll(), S3RuntimeError);
+}
+
+#endif
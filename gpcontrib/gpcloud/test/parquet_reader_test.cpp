@@ -0,0 +1,312 @@
+#include "parquet_reader.cpp"
+#include <fstream>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mock_classes.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+
+// Files in data/parquet are written by pyarrow, 5 rows in row groups of 3 rows:
+//   id int64, small int16, name string, score double, flag bool, day date32, ts timestamp[us]
+// plain.parquet is uncompressed without dictionaries. dict_snappy_v2.parquet has dictionaries,
+// snappy and data pages v2. gzip.parquet is gzip compressed, ts is in nanoseconds and there is
+// ts_ms in milliseconds.
+
+static string ReadTestFile(const string &path) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+class MockFetchParquetFile {
+   public:
+    MockFetchParquetFile(const string &content) : content(content) {
+    }
+
+    uint64_t operator()(uint64_t offset, S3VectorUInt8 &data, uint64_t len,
+                        const S3Url &sourceUrl) {
+        data.assign(content.begin() + offset, content.begin() + offset + len);
+        return len;
+    }
+
+   private:
+    string content;
+};
+
+template <typename T>
+static T DecodeValue(const char *&p) {
+    T value;
+    memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return value;
+}
+
+// Rows of ParquetReader as "value|value|...", with NULL for NULLs.
+static vector<string> DecodeRows(const string &data, const ParquetScanDesc &scanDesc) {
+    vector<string> rows;
+    const char *p = data.data();
+
+    while (p < data.data() + data.size()) {
+        const char *end = p + sizeof(uint32_t) + DecodeValue<uint32_t>(p);
+        std::stringstream row;
+
+        for (uint64_t i = 0; i < scanDesc.columns.size(); i++) {
+            if (i > 0) {
+                row << "|";
+            }
+
+            if (*p++ != 0) {
+                row << "NULL";
+                continue;
+            }
+
+            switch (scanDesc.columns[i].kind) {
+                case PARQUET_KIND_BOOL:
+                    row << ((*p++ != 0) ? "t" : "f");
+                    break;
+                case PARQUET_KIND_INT16:
+                    row << DecodeValue<int16_t>(p);
+                    break;
+                case PARQUET_KIND_INT32:
+                case PARQUET_KIND_DATE:
+                    row << DecodeValue<int32_t>(p);
+                    break;
+                case PARQUET_KIND_FLOAT4:
+                    row << DecodeValue<float>(p);
+                    break;
+                case PARQUET_KIND_FLOAT8:
+                    row << DecodeValue<double>(p);
+                    break;
+                case PARQUET_KIND_TEXT: {
+                    uint32_t len = DecodeValue<uint32_t>(p);
+                    row << string(p, len);
+                    p += len;
+                    break;
+                }
+                default:
+                    row << DecodeValue<int64_t>(p);
+                    break;
+            }
+        }
+
+        EXPECT_EQ(end, p);
+        rows.push_back(row.str());
+    }
+
+    return rows;
+}
+
+static ParquetScanDesc AllColumns() {
+    ParquetScanDesc scanDesc;
+    scanDesc.columns.push_back(ParquetTableColumn("id", PARQUET_KIND_INT64));
+    scanDesc.columns.push_back(ParquetTableColumn("small", PARQUET_KIND_INT16));
+    scanDesc.columns.push_back(ParquetTableColumn("name", PARQUET_KIND_TEXT));
+    scanDesc.columns.push_back(ParquetTableColumn("score", PARQUET_KIND_FLOAT8));
+    scanDesc.columns.push_back(ParquetTableColumn("flag", PARQUET_KIND_BOOL));
+    scanDesc.columns.push_back(ParquetTableColumn("day", PARQUET_KIND_DATE));
+    scanDesc.columns.push_back(ParquetTableColumn("ts", PARQUET_KIND_TIMESTAMP));
+    return scanDesc;
+}
+
+static vector<string> AllRows() {
+    vector<string> rows;
+    rows.push_back("1|-1|apple|1.5|t|0|1");
+    rows.push_back("2|2|banana|NULL|f|-1|NULL");
+    rows.push_back("3|NULL|NULL|3.25|NULL|8825|-946684800000001");
+    rows.push_back("4|4|cherry|-4|t|NULL|643033800000000");
+    rows.push_back("5|5|apple|5|f|-10957|0");
+    return rows;
+}
+
+static ParquetQual MakeQual(uint64_t column, ParquetQualOp op, int64_t value) {
+    ParquetQual qual;
+    qual.column = column;
+    qual.op = op;
+    qual.intValue = value;
+    return qual;
+}
+
+// ================== ParquetReaderTest ===================
+class ParquetReaderTest : public testing::Test {
+   protected:
+    virtual void SetUp() {
+        reader.setS3InterfaceService(&s3Interface);
+    }
+
+    void openFile(const string &name, const ParquetScanDesc &scanDesc) {
+        content = ReadTestFile("data/parquet/" + name);
+        ASSERT_FALSE(content.empty());
+        openContent(content, scanDesc);
+    }
+
+    void openContent(const string &content, const ParquetScanDesc &scanDesc) {
+        EXPECT_CALL(s3Interface, fetchData(_, _, _, _))
+            .WillRepeatedly(Invoke(MockFetchParquetFile(content)));
+
+        S3Params params("s3://abc/def.parquet");
+        params.setKeySize(content.size());
+
+        reader.setScanDesc(scanDesc);
+        reader.open(params);
+    }
+
+    vector<string> readFile(const string &name, const ParquetScanDesc &scanDesc) {
+        openFile(name, scanDesc);
+
+        string data;
+        char buf[16];
+        uint64_t len;
+        while ((len = reader.read(buf, sizeof(buf))) != 0) {
+            data.append(buf, len);
+        }
+
+        return DecodeRows(data, scanDesc);
+    }
+
+    ParquetReader reader;
+    MockS3Interface s3Interface;
+    string content;
+};
+
+TEST_F(ParquetReaderTest, ParseFileMetaData) {
+    openFile("plain.parquet", AllColumns());
+
+    const ParquetFileMetaData &metaData = reader.getMetaData();
+    EXPECT_EQ(5, metaData.numRows);
+    ASSERT_EQ(2, metaData.rowGroups.size());
+    EXPECT_EQ(3, metaData.rowGroups[0].numRows);
+    EXPECT_EQ(2, metaData.rowGroups[1].numRows);
+
+    ASSERT_EQ(7, metaData.columns.size());
+    EXPECT_EQ("small", metaData.columns[1].name);
+    EXPECT_EQ(PARQUET_INT32, metaData.columns[1].type);
+    EXPECT_EQ(PARQUET_LOGICAL_NONE, metaData.columns[1].logicalType);
+    EXPECT_EQ(PARQUET_BYTE_ARRAY, metaData.columns[2].type);
+    EXPECT_EQ(PARQUET_LOGICAL_STRING, metaData.columns[2].logicalType);
+    EXPECT_EQ(PARQUET_LOGICAL_DATE, metaData.columns[5].logicalType);
+    EXPECT_EQ(PARQUET_LOGICAL_TIMESTAMP_MICROS, metaData.columns[6].logicalType);
+    EXPECT_EQ(1, metaData.columns[6].maxDefinitionLevel);
+    EXPECT_TRUE(metaData.columns[6].isTopLevel);
+
+    const ParquetStatistics &stats = metaData.rowGroups[0].columns[0].stats;
+    EXPECT_TRUE(stats.hasMinMax);
+    EXPECT_EQ(1, ReadLE64((const uint8_t *)stats.min.data()));
+    EXPECT_EQ(3, ReadLE64((const uint8_t *)stats.max.data()));
+}
+
+TEST_F(ParquetReaderTest, ParseTruncatedFileMetaData) {
+    uint8_t data[] = {0x19, 0x1c};  // a list of 1 struct, then nothing
+    EXPECT_THROW(ParseParquetFileMetaData(data, sizeof(data)), S3ParquetError);
+}
+
+TEST_F(ParquetReaderTest, ReadPlainFile) {
+    EXPECT_EQ(AllRows(), readFile("plain.parquet", AllColumns()));
+}
+
+TEST_F(ParquetReaderTest, ReadDictionarySnappyV2File) {
+    EXPECT_EQ(AllRows(), readFile("dict_snappy_v2.parquet", AllColumns()));
+}
+
+TEST_F(ParquetReaderTest, ReadGzipFileWithTimestampUnits) {
+    ParquetScanDesc scanDesc;
+    scanDesc.columns.push_back(ParquetTableColumn("ts", PARQUET_KIND_TIMESTAMP));
+    scanDesc.columns.push_back(ParquetTableColumn("ts_ms", PARQUET_KIND_TIMESTAMP));
+
+    vector<string> rows = readFile("gzip.parquet", scanDesc);
+
+    ASSERT_EQ(5, rows.size());
+    EXPECT_EQ("1|0", rows[0]);
+    EXPECT_EQ("NULL|NULL", rows[1]);
+    EXPECT_EQ("-946684800000001|-946684800000000", rows[2]);
+    EXPECT_EQ("643033800000000|643033800000000", rows[3]);
+}
+
+TEST_F(ParquetReaderTest, SkippedColumnsAreNull) {
+    ParquetScanDesc scanDesc = AllColumns();
+    for (uint64_t i = 0; i < scanDesc.columns.size(); i++) {
+        if (scanDesc.columns[i].name != "name") {
+            scanDesc.columns[i].kind = PARQUET_KIND_SKIP;
+        }
+    }
+
+    vector<string> rows = readFile("plain.parquet", scanDesc);
+
+    ASSERT_EQ(5, rows.size());
+    EXPECT_EQ("NULL|NULL|banana|NULL|NULL|NULL|NULL", rows[1]);
+    EXPECT_EQ("NULL|NULL|NULL|NULL|NULL|NULL|NULL", rows[2]);
+}
+
+TEST_F(ParquetReaderTest, MatchColumnNamesCaseInsensitively) {
+    ParquetScanDesc scanDesc;
+    scanDesc.columns.push_back(ParquetTableColumn("ID", PARQUET_KIND_INT32));
+
+    vector<string> rows = readFile("plain.parquet", scanDesc);
+
+    ASSERT_EQ(5, rows.size());
+    EXPECT_EQ("5", rows[4]);
+}
+
+TEST_F(ParquetReaderTest, SkipRowGroupsByStatistics) {
+    ParquetScanDesc scanDesc = AllColumns();
+    scanDesc.quals.push_back(MakeQual(0, PARQUET_QUAL_GT, 3));
+
+    vector<string> rows = readFile("dict_snappy_v2.parquet", scanDesc);
+
+    ASSERT_EQ(2, rows.size());
+    EXPECT_EQ(AllRows()[3], rows[0]);
+    EXPECT_EQ(1, reader.getSkippedRowGroups());
+}
+
+TEST_F(ParquetReaderTest, SkipRowGroupsByDateStatistics) {
+    ParquetScanDesc scanDesc = AllColumns();
+    scanDesc.quals.push_back(MakeQual(5, PARQUET_QUAL_LT, -1));
+
+    vector<string> rows = readFile("plain.parquet", scanDesc);
+
+    ASSERT_EQ(2, rows.size());
+    EXPECT_EQ(1, reader.getSkippedRowGroups());
+}
+
+TEST_F(ParquetReaderTest, SkipRowGroupsByTextEquality) {
+    ParquetScanDesc scanDesc = AllColumns();
+    ParquetQual qual;
+    qual.column = 2;
+    qual.op = PARQUET_QUAL_EQ;
+    qual.textValue = "zebra";
+    scanDesc.quals.push_back(qual);
+
+    EXPECT_EQ(0, readFile("plain.parquet", scanDesc).size());
+    EXPECT_EQ(2, reader.getSkippedRowGroups());
+}
+
+TEST_F(ParquetReaderTest, TextQualsOtherThanEqualityDontSkip) {
+    ParquetScanDesc scanDesc = AllColumns();
+    ParquetQual qual;
+    qual.column = 2;
+    qual.op = PARQUET_QUAL_LT;
+    qual.textValue = "a";
+    scanDesc.quals.push_back(qual);
+
+    EXPECT_EQ(5, readFile("plain.parquet", scanDesc).size());
+    EXPECT_EQ(0, reader.getSkippedRowGroups());
+}
+
+TEST_F(ParquetReaderTest, MissingColumnIsAnError) {
+    ParquetScanDesc scanDesc;
+    scanDesc.columns.push_back(ParquetTableColumn("nope", PARQUET_KIND_INT32));
+
+    EXPECT_THROW(openFile("plain.parquet", scanDesc), S3ParquetError);
+}
+
+TEST_F(ParquetReaderTest, MismatchedTypeIsAnError) {
+    ParquetScanDesc scanDesc;
+    scanDesc.columns.push_back(ParquetTableColumn("name", PARQUET_KIND_INT32));
+
+    EXPECT_THROW(openFile("plain.parquet", scanDesc), S3ParquetError);
+}
+
+TEST_F(ParquetReaderTest, NotParquetFileIsAnError) {
+    EXPECT_THROW(openContent("this is not a parquet file", AllColumns()), S3ParquetError);
+}
@@ -136,7 +136,8 @@ TEST_F(S3BucketReaderTest, ReaderShouldSkipIfFileIsNotForThisSegment) {
 
     S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
 
-    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    // listed again after reading, to check the listing is unchanged
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(2).WillRepeatedly(Return(result));
 
     s3ext_segid = 10;
     s3ext_segnum = 16;
@@ -146,6 +147,49 @@ TEST_F(S3BucketReaderTest, ReaderShouldSkipIfFileIsNotForThisSegment) {
     bucketReader->open(params);
 
     EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+}
+
+TEST_F(S3BucketReaderTest, ReaderThrowExceptionWhenBucketChanged) {
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 456);
+    result.contents.emplace_back("bar", 100);
+
+    // "bar" grew after this segment listed the bucket, another segment may have another plan.
+    ListBucketResult changed;
+    changed.contents.emplace_back("foo", 456);
+    changed.contents.emplace_back("bar", 200);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).WillOnce(Return(result)).WillOnce(Return(changed));
+
+    s3ext_segid = 10;
+    s3ext_segnum = 16;
+
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->setUpstreamReader(&s3Reader);
+    bucketReader->open(params);
+
+    EXPECT_THROW(bucketReader->read(buf, sizeof(buf)), S3RuntimeError);
+}
+
+TEST_F(S3BucketReaderTest, ReaderThrowExceptionWhenKeyAdded) {
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 456);
+
+    ListBucketResult changed;
+    changed.contents.emplace_back("bar", 100);
+    changed.contents.emplace_back("foo", 456);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).WillOnce(Return(result)).WillOnce(Return(changed));
+
+    s3ext_segid = 10;
+    s3ext_segnum = 16;
+
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->setUpstreamReader(&s3Reader);
+    bucketReader->open(params);
+
+    EXPECT_THROW(bucketReader->read(buf, sizeof(buf)), S3RuntimeError);
 }
 
 TEST_F(S3BucketReaderTest, UpstreamReaderThrowException) {
@@ -169,6 +213,84 @@ TEST_F(S3BucketReaderTest, UpstreamReaderThrowException) {
     EXPECT_THROW(bucketReader->read(buf, sizeof(buf)), S3RuntimeError);
 }
 
+TEST_F(S3BucketReaderTest, LargeKeyIsSplitIntoRanges) {
+    const uint64_t MB = 1024 * 1024;
+
+    ListBucketResult result;
+    result.contents.emplace_back("big", 400 * MB);
+    result.contents.emplace_back("foo", 10 * MB);
+    result.contents.emplace_back("bar", 10 * MB);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    EXPECT_CALL(s3Interface, checkCompressionType(_)).Times(0);
+
+    s3ext_segid = 1;
+    s3ext_segnum = 4;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+
+    // "big" is split into 4 ranges of 100MB, one for each segment, then "foo" goes to segment 0
+    // and "bar" to segment 1.
+    const vector<BucketReadItem>& items = bucketReader->getReadItems();
+    ASSERT_EQ((uint64_t)2, items.size());
+    EXPECT_EQ((uint64_t)0, items[0].keyIndex);
+    EXPECT_EQ(100 * MB, items[0].offset);
+    EXPECT_EQ(100 * MB, items[0].length);
+    EXPECT_TRUE(items[0].isRange);
+    EXPECT_EQ((uint64_t)2, items[1].keyIndex);
+    EXPECT_FALSE(items[1].isRange);
+}
+
+TEST_F(S3BucketReaderTest, CompressedKeyIsNotSplit) {
+    const uint64_t MB = 1024 * 1024;
+
+    ListBucketResult result;
+    result.contents.emplace_back("big.gz", 400 * MB);
+    result.contents.emplace_back("foo", 10 * MB);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+    EXPECT_CALL(s3Interface, checkCompressionType(_)).Times(0);
+
+    s3ext_segid = 0;
+    s3ext_segnum = 4;
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+
+    const vector<BucketReadItem>& items = bucketReader->getReadItems();
+    ASSERT_EQ((uint64_t)1, items.size());
+    EXPECT_EQ((uint64_t)0, items[0].keyIndex);
+    EXPECT_FALSE(items[0].isRange);
+}
+
+TEST_F(S3BucketReaderTest, SmallKeysArePackedBySize) {
+    ListBucketResult result;
+    result.contents.emplace_back("a", 100);
+    result.contents.emplace_back("b", 1);
+    result.contents.emplace_back("c", 1);
+    result.contents.emplace_back("d", 1);
+    result.contents.emplace_back("e", 97);
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(2).WillRepeatedly(Return(result));
+
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    s3ext_segnum = 2;
+
+    s3ext_segid = 0;
+    bucketReader->open(params);
+    ASSERT_EQ((uint64_t)1, bucketReader->getReadItems().size());
+    EXPECT_EQ((uint64_t)0, bucketReader->getReadItems()[0].keyIndex);
+
+    // the 4 other keys together are as large as "a", and are read in listing order.
+    s3ext_segid = 1;
+    bucketReader->open(params);
+    const vector<BucketReadItem>& items = bucketReader->getReadItems();
+    ASSERT_EQ((uint64_t)4, items.size());
+    EXPECT_EQ((uint64_t)1, items[0].keyIndex);
+    EXPECT_EQ((uint64_t)2, items[1].keyIndex);
+    EXPECT_EQ((uint64_t)3, items[2].keyIndex);
+    EXPECT_EQ((uint64_t)4, items[3].keyIndex);
+}
+
 class MockRead {
    public:
     MockRead(const char* ptr) : p(ptr) {
@@ -49,6 +49,33 @@ TEST_F(S3CommonReaderTest, OpenGZip) {
     ASSERT_TRUE(NULL != dynamic_cast<DecompressReader *>(this->upstreamReader));
 }
 
+TEST_F(S3CommonReaderTest, OpenGZipWithMultipleThreads) {
+    // test case for: the file format is gzip with threads, then parallelDecompressReader is used
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_GZIP));
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(4);
+    params.setChunkSize(1024 * 1024 * 2);
+    this->open(params);
+
+    ASSERT_EQ(this->upstreamReader, &this->parallelDecompressReader);
+}
+
+TEST_F(S3CommonReaderTest, OpenZstd) {
+    // test case for: the file format is zstd, then parallelDecompressReader is used even with one
+    // thread, if built with libzstd
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_ZSTD));
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+
+#ifdef HAVE_LIBZSTD
+    this->open(params);
+    ASSERT_EQ(this->upstreamReader, &this->parallelDecompressReader);
+#else
+    EXPECT_THROW(this->open(params), S3RuntimeError);
+#endif
+}
+
 TEST_F(S3CommonReaderTest, OpenPlain) {
     // test case for: the file format is gzip, then S3keyReader should be called
     EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_PLAIN));
@@ -86,3 +113,45 @@ TEST_F(S3CommonReaderTest, ReadGZip) {
     EXPECT_EQ((uint64_t)0, this->upstreamReader->read(result, sizeof(result)));
     EXPECT_EQ(0, memcmp(result, hello, sizeof(hello)));
 }
+
+TEST_F(S3CommonReaderTest, ReadGZipFirstRangeReadsWholeKey) {
+    Byte compressionBuff[0x100];
+    uLong compressedLen = sizeof(compressionBuff);
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+
+    compress(compressionBuff, &compressedLen, (const Bytef *)hello, sizeof(hello));
+
+    mockS3Interface.setData(compressionBuff, compressedLen);
+
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_GZIP));
+
+    EXPECT_CALL(mockS3Interface, fetchData(_, _, _, _))
+        .WillOnce(Invoke(&mockS3Interface, &MockS3InterfaceForCompressionRead::mockFetchData));
+
+    char result[0x100];
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+    params.setKeySize(compressedLen);
+    params.setKeyRange(0, compressedLen / 2);
+    this->open(params);
+
+    EXPECT_EQ(sizeof(hello), this->read(result, sizeof(result)));
+    EXPECT_EQ((uint64_t)0, this->read(result, sizeof(result)));
+    EXPECT_EQ(0, memcmp(result, hello, sizeof(hello)));
+}
+
+TEST_F(S3CommonReaderTest, ReadGZipOtherRangesAreSkipped) {
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_GZIP));
+    EXPECT_CALL(mockS3Interface, fetchData(_, _, _, _)).Times(0);
+
+    char result[0x100];
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+    params.setKeySize(200);
+    params.setKeyRange(100, 100);
+    this->open(params);
+
+    EXPECT_EQ((uint64_t)0, this->read(result, sizeof(result)));
+}
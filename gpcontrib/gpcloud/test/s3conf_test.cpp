@@ -28,12 +28,14 @@ TEST(Config, Basic) {
 
     EXPECT_EQ((uint64_t)1024, params.getLowSpeedLimit());
     EXPECT_EQ((uint64_t)600, params.getLowSpeedTime());
+    EXPECT_EQ((uint64_t)30, params.getKeepAliveIdleTime());
 
     EXPECT_FALSE(params.isDebugCurl());
 
     EXPECT_EQ("", params.getProxy());
 
     EXPECT_TRUE(params.isAutoCompress());
+    EXPECT_EQ((uint64_t)0, params.getCompressMemberSize());
     EXPECT_TRUE(params.isVerifyCert());
 
     EXPECT_EQ(SSE_S3, params.getSSEType());
@@ -49,6 +51,7 @@ TEST(Config, SpecialSectionValues) {
 
     EXPECT_EQ((uint64_t)10240, params.getLowSpeedLimit());
     EXPECT_EQ((uint64_t)60, params.getLowSpeedTime());
+    EXPECT_EQ((uint64_t)60, params.getKeepAliveIdleTime());
 
     EXPECT_FALSE(params.isDebugCurl());
     EXPECT_EQ(SSE_NONE, params.getSSEType());
@@ -73,6 +76,7 @@ TEST(Config, SpecialSwitches) {
 
     EXPECT_TRUE(params.isDebugCurl());
     EXPECT_FALSE(params.isAutoCompress());
+    EXPECT_EQ((uint64_t)(8 * 1024 * 1024), params.getCompressMemberSize());
 }
 
 TEST(Config, SectionExist) {
@@ -833,6 +833,109 @@ TEST_F(S3KeyReaderTest, MTReadWithHundredsOfThreadsAndSignalCancel) {
     EXPECT_THROW(this->read(buffer, 31), S3QueryAbort);
 }
 
+// Serve the requested bytes of content, like a ranged GET.
+class MockFetchContent {
+   public:
+    MockFetchContent(const string &content) : content(content) {
+    }
+
+    uint64_t operator()(uint64_t offset, S3VectorUInt8 &data, uint64_t len,
+                        const S3Url &sourceUrl) {
+        data.assign(content.begin() + offset, content.begin() + offset + len);
+        return len;
+    }
+
+   private:
+    string content;
+};
+
+static string ReadKeyRange(S3KeyReader &reader, S3Params &params, uint64_t offset,
+                           uint64_t length) {
+    char buf[256];
+    string result;
+
+    params.setKeyRange(offset, length);
+    reader.open(params);
+
+    uint64_t readLen;
+    while ((readLen = reader.read(buf, sizeof(buf))) != 0) {
+        result.append(buf, readLen);
+    }
+
+    reader.close();
+    return result;
+}
+
+TEST_F(S3KeyReaderTest, ReadKeyRangesAlignedToLines) {
+    string content = "aaaa\nbbbb\ncccc\ndddd";
+
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(2);
+    params.setKeySize(content.size());
+    params.setChunkSize(4);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _))
+        .WillRepeatedly(Invoke(MockFetchContent(content)));
+
+    // the range ends in the middle of "bbbb\n", which is read up to its end.
+    EXPECT_EQ("aaaa\nbbbb\n", ReadKeyRange(*this, params, 0, 7));
+    // "bb\n" before "cccc\n" belongs to the previous range.
+    EXPECT_EQ("cccc\n", ReadKeyRange(*this, params, 7, 7));
+    // line terminator is appended to the last line of key.
+    EXPECT_EQ("dddd\n", ReadKeyRange(*this, params, 14, 5));
+}
+
+TEST_F(S3KeyReaderTest, ReadKeyRangeEndingWithLine) {
+    string content = "aaaa\nbbbb\n";
+
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setKeySize(content.size());
+    params.setChunkSize(4);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _))
+        .WillRepeatedly(Invoke(MockFetchContent(content)));
+
+    EXPECT_EQ("aaaa\n", ReadKeyRange(*this, params, 0, 5));
+    EXPECT_EQ("bbbb\n", ReadKeyRange(*this, params, 5, 5));
+}
+
+TEST_F(S3KeyReaderTest, ReadKeyRangeWithoutLineStart) {
+    string content = "aaaaaaaaaa\nbbbb\n";
+
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setKeySize(content.size());
+    params.setChunkSize(4);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _))
+        .WillRepeatedly(Invoke(MockFetchContent(content)));
+
+    EXPECT_EQ("aaaaaaaaaa\n", ReadKeyRange(*this, params, 0, 2));
+    EXPECT_EQ("", ReadKeyRange(*this, params, 2, 8));
+    EXPECT_EQ("bbbb\n", ReadKeyRange(*this, params, 10, 7));
+}
+
+TEST_F(S3KeyReaderTest, ReadKeyRangesWithCRLF) {
+    eolString[0] = '\r';
+    eolString[1] = '\n';
+    eolString[2] = '\0';
+
+    string content = "aaaa\r\nbbbb\r\ncccc";
+
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setKeySize(content.size());
+    params.setChunkSize(4);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _))
+        .WillRepeatedly(Invoke(MockFetchContent(content)));
+
+    // the range ends between '\r' and '\n'.
+    EXPECT_EQ("aaaa\r\n", ReadKeyRange(*this, params, 0, 5));
+    EXPECT_EQ("bbbb\r\ncccc\r\n", ReadKeyRange(*this, params, 5, 12));
+}
+
 TEST(ChunkBuffer, ChunkBufferOperatorEqual) {
     S3Url s3Url("s3://whatever");
     S3KeyReader reader;
@@ -338,3 +338,55 @@ TEST(S3RESTfulService, GetWithWrongProxyUrl) {
 
     EXPECT_THROW(service.get(url, headers), S3ResolveError);
 }
+
+TEST(S3CurlHandlePool, ReuseReleasedHandle) {
+    S3CurlHandlePool &pool = S3CurlHandlePool::getInstance();
+    pool.clear();
+
+    CURL *curl = pool.acquire(60);
+    pool.release(curl);
+    EXPECT_EQ((uint64_t)1, pool.getIdleNum());
+
+    uint64_t reusedNum = pool.getReusedNum();
+    EXPECT_EQ(curl, pool.acquire(60));
+    EXPECT_EQ(reusedNum + 1, pool.getReusedNum());
+    EXPECT_EQ((uint64_t)0, pool.getIdleNum());
+
+    pool.release(curl);
+    pool.clear();
+}
+
+TEST(S3CurlHandlePool, ExpiredHandleIsNotReused) {
+    S3CurlHandlePool &pool = S3CurlHandlePool::getInstance();
+    pool.clear();
+
+    pool.release(pool.acquire(60));
+    pool.release(pool.acquire(60));
+
+    uint64_t reusedNum = pool.getReusedNum();
+    uint64_t createdNum = pool.getCreatedNum();
+    CURL *curl = pool.acquire(0);
+    EXPECT_EQ(reusedNum, pool.getReusedNum());
+    EXPECT_EQ(createdNum + 1, pool.getCreatedNum());
+    EXPECT_EQ((uint64_t)0, pool.getIdleNum());
+
+    pool.release(curl);
+    pool.clear();
+}
+
+TEST(S3CurlHandlePool, KeepAtMostMaxIdleHandles) {
+    S3CurlHandlePool &pool = S3CurlHandlePool::getInstance();
+    pool.clear();
+
+    vector<CURL *> handles;
+    for (int i = 0; i < S3_CURL_POOL_MAX_IDLE + 2; i++) {
+        handles.push_back(pool.acquire(60));
+    }
+    for (size_t i = 0; i < handles.size(); i++) {
+        pool.release(handles[i]);
+    }
+    EXPECT_EQ((uint64_t)S3_CURL_POOL_MAX_IDLE, pool.getIdleNum());
+
+    pool.clear();
+    EXPECT_EQ((uint64_t)0, pool.getIdleNum());
+}
@@ -0,0 +1,51 @@
+-- Test zstd dictionaries of append-optimized column tables
+SET gp_appendonly_zstd_dictionary TO on;
+
+CREATE TABLE zstd_dict_table (a int,
+    status text ENCODING (compresstype=zstd, compresslevel=3))
+    WITH (appendonly=true, orientation=column) DISTRIBUTED BY (a);
+
+-- The first insert trains a dictionary for the column on every segment,
+-- once it has seen enough data
+INSERT INTO zstd_dict_table SELECT i,
+    (ARRAY['shipped', 'pending', 'cancelled', 'returned'])[i % 4 + 1] ||
+    ' order status code ' || (i % 50)
+    FROM generate_series(1, 200000) i;
+SELECT count(DISTINCT gp_segment_id) = (SELECT count(*) FROM gp_segment_configuration WHERE role = 'p' AND content >= 0)
+    FROM gp_dist_random('gp_zstd_dictionary')
+    WHERE relid = 'zstd_dict_table'::regclass AND attnum = 2;
+
+-- Later inserts use it; blocks with and without dictionary decode alike
+INSERT INTO zstd_dict_table SELECT * FROM zstd_dict_table;
+SELECT count(*) FROM zstd_dict_table;
+SELECT count(*) FROM zstd_dict_table WHERE status = 'pending order status code 1';
+SELECT count(DISTINCT status) FROM zstd_dict_table;
+
+-- Reading does not depend on the setting
+SET gp_appendonly_zstd_dictionary TO off;
+SELECT count(*) FROM zstd_dict_table WHERE status = 'pending order status code 1';
+
+-- Rewriting the table keeps the dictionaries its new data files were
+-- compressed with
+SET gp_appendonly_zstd_dictionary TO on;
+VACUUM FULL zstd_dict_table;
+SELECT count(*), count(DISTINCT status) FROM zstd_dict_table;
+SELECT count(*) FROM zstd_dict_table WHERE status = 'pending order status code 1';
+
+CREATE INDEX zstd_dict_table_a ON zstd_dict_table (a);
+CLUSTER zstd_dict_table USING zstd_dict_table_a;
+SELECT count(*), count(DISTINCT status) FROM zstd_dict_table;
+SELECT count(*) FROM zstd_dict_table WHERE status = 'pending order status code 1';
+
+ALTER TABLE zstd_dict_table SET WITH (reorganize=true);
+SELECT count(*), count(DISTINCT status) FROM zstd_dict_table;
+SELECT count(*) FROM zstd_dict_table WHERE status = 'pending order status code 1';
+SELECT count(DISTINCT gp_segment_id) = (SELECT count(*) FROM gp_segment_configuration WHERE role = 'p' AND content >= 0)
+    FROM gp_dist_random('gp_zstd_dictionary')
+    WHERE relid = 'zstd_dict_table'::regclass AND attnum = 2;
+
+-- The dictionaries are dropped with the table
+DROP TABLE zstd_dict_table;
+SELECT count(*) FROM gp_dist_random('gp_zstd_dictionary');
+
+RESET gp_appendonly_zstd_dictionary;
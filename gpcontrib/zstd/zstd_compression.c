@@ -11,13 +11,16 @@
 #include "postgres.h"
 
 #include "access/genam.h"
+#include "catalog/gp_zstd_dictionary.h"
 #include "catalog/pg_compression.h"
 #include "fmgr.h"
 #include "storage/gp_compress.h"
 #include "utils/builtins.h"
+#include "utils/guc.h"
 
 #include <zstd.h>
 #include <zstd_errors.h>
+#include <zdict.h>
 
 Datum		zstd_constructor(PG_FUNCTION_ARGS);
 Datum		zstd_destructor(PG_FUNCTION_ARGS);
@@ -35,6 +38,19 @@ PG_FUNCTION_INFO_V1(zstd_validator);
 PG_MODULE_MAGIC;
 #endif
 
+/*
+ * Dictionary training. The first blocks that an insert writes to a column
+ * without a dictionary are compressed without one and sampled, until
+ * ZSTD_DICT_SAMPLE_BYTES have been seen. The dictionary trained from them
+ * is handed to the caller through the CompressionState, to store it in
+ * gp_zstd_dictionary once the block is written, and compresses the blocks
+ * after that. An insert that writes less than that leaves the column without
+ * a dictionary.
+ */
+#define ZSTD_DICT_CAPACITY			(32 * 1024)
+#define ZSTD_DICT_SAMPLE_BYTES		(1024 * 1024)
+#define ZSTD_DICT_MAX_SAMPLES		1024
+
 /* Internal state for zstd */
 typedef struct zstd_state
 {
@@ -42,8 +58,29 @@ typedef struct zstd_state
 	bool		compress;		/* Compress if true, decompress otherwise */
 
 	zstd_context *ctx;			/* ZSTD compression/decompresion contexts */
+
+	/* The column compressed, for its dictionaries; relid may be invalid */
+	Oid			relid;
+	AttrNumber	attnum;
+
+	/* ID of the dictionary in ctx->ddict, when decompressing */
+	unsigned	ddict_id;
+
+	/* Samples collected to train a dictionary, when compressing */
+	bool		training;
+	char	   *samples;
+	size_t	   *sample_sizes;
+	int			nsamples;
+	size_t		sample_bytes;
+	MemoryContext mcxt;
+
+	/* Trained dictionary, until the caller has stored it */
+	char	   *trained_dict;
+	ZSTD_CDict *trained_cdict;
 } zstd_state;
 
+static void zstd_train_dictionary(CompressionState *cs, zstd_state *state);
+
 Datum
 zstd_constructor(PG_FUNCTION_ARGS)
 {
@@ -75,6 +112,31 @@ zstd_constructor(PG_FUNCTION_ARGS)
 	if (!state->ctx->dctx)
 		elog(ERROR, "out of memory");
 
+	state->relid = sa->relid;
+	state->attnum = sa->attnum;
+	state->mcxt = CurrentMemoryContext;
+
+	/*
+	 * Compress with the latest dictionary of the column, or train one if it
+	 * has none yet.
+	 */
+	if (compress && gp_appendonly_zstd_dictionary && OidIsValid(sa->relid))
+	{
+		bytea	   *dict = GetLatestZstdDictionary(sa->relid, sa->attnum);
+
+		if (dict)
+		{
+			state->ctx->cdict = ZSTD_createCDict(VARDATA_ANY(dict),
+												 VARSIZE_ANY_EXHDR(dict),
+												 state->level);
+			if (!state->ctx->cdict)
+				elog(ERROR, "out of memory");
+			pfree(dict);
+		}
+		else
+			state->training = true;
+	}
+
 	PG_RETURN_POINTER(cs);
 }
 
@@ -87,6 +149,8 @@ zstd_destructor(PG_FUNCTION_ARGS)
 	{
 		zstd_state *state = (zstd_state *) cs->opaque;
 
+		if (state->trained_cdict)
+			ZSTD_freeCDict(state->trained_cdict);
 		zstd_free_context(state->ctx);
 		pfree(state);
 	}
@@ -114,10 +178,45 @@ zstd_compress(PG_FUNCTION_ARGS)
 
 	unsigned long dst_length_used;
 
-	dst_length_used = ZSTD_compressCCtx(state->ctx->cctx,
-										dst, dst_sz,
-										src, src_sz,
-										state->level);
+	/* Use the trained dictionary once the caller has stored it */
+	if (state->trained_cdict && cs->dictionary == NULL)
+	{
+		state->ctx->cdict = state->trained_cdict;
+		state->trained_cdict = NULL;
+		pfree(state->trained_dict);
+		state->trained_dict = NULL;
+	}
+
+	if (state->training)
+	{
+		if (state->sample_bytes + src_sz > ZSTD_DICT_SAMPLE_BYTES ||
+			state->nsamples == ZSTD_DICT_MAX_SAMPLES)
+			zstd_train_dictionary(cs, state);
+		else
+		{
+			if (state->samples == NULL)
+			{
+				state->samples = MemoryContextAlloc(state->mcxt,
+													ZSTD_DICT_SAMPLE_BYTES);
+				state->sample_sizes = MemoryContextAlloc(state->mcxt,
+														 ZSTD_DICT_MAX_SAMPLES * sizeof(size_t));
+			}
+			memcpy(state->samples + state->sample_bytes, src, src_sz);
+			state->sample_sizes[state->nsamples++] = src_sz;
+			state->sample_bytes += src_sz;
+		}
+	}
+
+	if (state->ctx->cdict)
+		dst_length_used = ZSTD_compress_usingCDict(state->ctx->cctx,
+												   dst, dst_sz,
+												   src, src_sz,
+												   state->ctx->cdict);
+	else
+		dst_length_used = ZSTD_compressCCtx(state->ctx->cctx,
+											dst, dst_sz,
+											src, src_sz,
+											state->level);
 
 	if (ZSTD_isError(dst_length_used))
 	{
@@ -152,15 +251,49 @@ zstd_decompress(PG_FUNCTION_ARGS)
 	zstd_state *state = (zstd_state *) cs->opaque;
 
 	unsigned long dst_length_used;
+	unsigned	dict_id;
 
 	if (src_sz <= 0)
 		elog(ERROR, "invalid source buffer size %d", src_sz);
 	if (dst_sz <= 0)
 		elog(ERROR, "invalid destination buffer size %d", dst_sz);
 
-	dst_length_used = ZSTD_decompressDCtx(state->ctx->dctx,
-										  dst, dst_sz,
-										  src, src_sz);
+	/* Frames compressed with a dictionary record its ID */
+	dict_id = ZSTD_getDictID_fromFrame(src, src_sz);
+	if (dict_id != 0)
+	{
+		if (state->ctx->ddict == NULL || state->ddict_id != dict_id)
+		{
+			bytea	   *dict = NULL;
+
+			if (OidIsValid(state->relid))
+				dict = GetZstdDictionary(state->relid, state->attnum,
+										 (int32) dict_id);
+			if (dict == NULL)
+				ereport(ERROR,
+						(errcode(ERRCODE_DATA_CORRUPTED),
+						 errmsg("zstd dictionary %u of column %d of relation %u does not exist",
+								dict_id, state->attnum, state->relid)));
+
+			if (state->ctx->ddict)
+				ZSTD_freeDDict(state->ctx->ddict);
+			state->ctx->ddict = ZSTD_createDDict(VARDATA_ANY(dict),
+												 VARSIZE_ANY_EXHDR(dict));
+			pfree(dict);
+			if (!state->ctx->ddict)
+				elog(ERROR, "out of memory");
+			state->ddict_id = dict_id;
+		}
+
+		dst_length_used = ZSTD_decompress_usingDDict(state->ctx->dctx,
+													 dst, dst_sz,
+													 src, src_sz,
+													 state->ctx->ddict);
+	}
+	else
+		dst_length_used = ZSTD_decompressDCtx(state->ctx->dctx,
+											  dst, dst_sz,
+											  src, src_sz);
 
 	if (ZSTD_isError(dst_length_used))
 	{
@@ -172,6 +305,54 @@ zstd_decompress(PG_FUNCTION_ARGS)
 	PG_RETURN_VOID();
 }
 
+/*
+ * Train a dictionary from the samples collected, and hand it to the caller
+ * to store as the latest dictionary of the column. No catalog access happens
+ * here, compression is called in the middle of writing a block.
+ *
+ * Training is attempted once per compression state; if the samples are not
+ * suitable, the column is left without a dictionary and the next insert
+ * tries again.
+ */
+static void
+zstd_train_dictionary(CompressionState *cs, zstd_state *state)
+{
+	char	   *dict;
+	size_t		dict_size;
+
+	state->training = false;
+	if (state->nsamples == 0)
+		return;
+
+	dict = MemoryContextAlloc(state->mcxt, ZSTD_DICT_CAPACITY);
+	dict_size = ZDICT_trainFromBuffer(dict, ZSTD_DICT_CAPACITY,
+									  state->samples, state->sample_sizes,
+									  state->nsamples);
+
+	if (ZDICT_isError(dict_size))
+	{
+		elog(DEBUG1, "could not train zstd dictionary for column %d of relation %u: %s",
+			 state->attnum, state->relid, ZDICT_getErrorName(dict_size));
+		pfree(dict);
+	}
+	else
+	{
+		state->trained_cdict = ZSTD_createCDict(dict, dict_size, state->level);
+		if (!state->trained_cdict)
+			elog(ERROR, "out of memory");
+		state->trained_dict = dict;
+
+		cs->dictionary = dict;
+		cs->dictionary_len = dict_size;
+		cs->dictionary_id = (int32) ZDICT_getDictID(dict, dict_size);
+	}
+
+	pfree(state->samples);
+	pfree(state->sample_sizes);
+	state->samples = NULL;
+	state->sample_sizes = NULL;
+}
+
 Datum
 zstd_validator(PG_FUNCTION_ARGS)
 {
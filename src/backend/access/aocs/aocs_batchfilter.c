@@ -0,0 +1,634 @@
+/*-------------------------------------------------------------------------
+ *
+ * aocs_batchfilter.c
+ *	  Block-at-a-time evaluation of simple pushed down quals on AOCS columns.
+ *
+ * The regular AOCS scan fetches one datum per column per row and evaluates
+ * the pushed down quals of a column with ExecQual, row by row.  For the
+ * fixed-width integer, floating point and date/time columns most of that
+ * time is per-datum overhead.  When every pushed down qual of the first
+ * projected column is one of
+ *
+ *		column op constant			(op one of < <= = >= >, BETWEEN included)
+ *		column IN (constant, ...)	(short lists only)
+ *		column IS [NOT] NULL
+ *
+ * the scan instead decodes the whole block of that column at once, RLE and
+ * delta compressed blocks included, into a value array and a null array,
+ * and evaluates the quals over the arrays into a selection vector.  The
+ * scan then only positions the other columns on the selected rows.
+ *
+ * The evaluation loops are written without branches over plain arrays, and
+ * this file is compiled with the vectorizing flags, so that the compiler
+ * turns them into SIMD code.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/access/aocs/aocs_batchfilter.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+
+#include "access/aocs_batchfilter.h"
+#include "access/nbtree.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbaocsam.h"
+#include "nodes/nodeFuncs.h"
+#include "nodes/primnodes.h"
+#include "utils/array.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/typcache.h"
+
+typedef enum AOCSBatchCondKind
+{
+	AOCSBATCH_COND_CMP,
+	AOCSBATCH_COND_IN,
+	AOCSBATCH_COND_ISNULL,
+	AOCSBATCH_COND_NOTNULL
+} AOCSBatchCondKind;
+
+typedef struct AOCSBatchCond
+{
+	AOCSBatchCondKind kind;
+	int			strategy;		/* btree strategy, for AOCSBATCH_COND_CMP */
+	int			nconsts;
+	int64		iconsts[AOCS_BATCHFILTER_MAX_IN_ITEMS];
+	double		fconsts[AOCS_BATCHFILTER_MAX_IN_ITEMS];
+} AOCSBatchCond;
+
+/* How the values of a type are compared */
+typedef enum AOCSBatchTypeKind
+{
+	AOCSBATCH_TYPE_NONE,
+	AOCSBATCH_TYPE_INT,			/* int2, int4, int8: compared as int64 */
+	AOCSBATCH_TYPE_FLOAT,		/* float4, float8: compared as double */
+	AOCSBATCH_TYPE_DATETIME		/* date, timestamp[tz]: int64, same type only */
+} AOCSBatchTypeKind;
+
+struct AOCSBatchFilter
+{
+	AttrNumber	attno;			/* the column all the quals are on */
+	Oid			typid;
+	bool		isfloat;
+	bool		strict;			/* any condition rejects NULLs */
+	List	   *conds;			/* AOCSBatchCond, implicitly ANDed */
+
+	/* The block evaluated last, firstRowNum is -1 if none */
+	int64		firstRowNum;
+	int			nrows;
+
+	/* Work arrays, of allocated length size */
+	int			size;
+	Datum	   *values;
+	bool	   *isnull;
+	int64	   *ivalues;
+	double	   *fvalues;
+	bool	   *match;
+	bool	   *selected;
+
+	MemoryContext mcxt;
+};
+
+static AOCSBatchTypeKind
+batch_type_kind(Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+			return AOCSBATCH_TYPE_INT;
+		case FLOAT4OID:
+		case FLOAT8OID:
+			return AOCSBATCH_TYPE_FLOAT;
+		case DATEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			return AOCSBATCH_TYPE_DATETIME;
+		default:
+			return AOCSBATCH_TYPE_NONE;
+	}
+}
+
+static inline int64
+batch_datum_int64(Oid typid, Datum value)
+{
+	switch (typid)
+	{
+		case INT2OID:
+			return (int64) DatumGetInt16(value);
+		case INT4OID:
+		case DATEOID:
+			return (int64) DatumGetInt32(value);
+		default:
+			return DatumGetInt64(value);
+	}
+}
+
+static inline double
+batch_datum_double(Oid typid, Datum value)
+{
+	if (typid == FLOAT4OID)
+		return (double) DatumGetFloat4(value);
+	return DatumGetFloat8(value);
+}
+
+/*
+ * Convert a constant of type typid into cond->[if]consts[n]. Returns false if
+ * the comparison cannot be done in batch, i.e. for NaN constants whose
+ * ordering the plain C comparisons do not follow.
+ */
+static bool
+batch_set_const(AOCSBatchFilter *filter, AOCSBatchCond *cond, int n,
+				Oid typid, Datum value)
+{
+	if (filter->isfloat)
+	{
+		double		d = batch_datum_double(typid, value);
+
+		if (isnan(d))
+			return false;
+		cond->fconsts[n] = d;
+	}
+	else
+		cond->iconsts[n] = batch_datum_int64(typid, value);
+
+	return true;
+}
+
+/*
+ * Check that var is a column that can be filtered in batch, and that it is
+ * the same column as the other conditions are on.
+ */
+static bool
+batch_check_var(AOCSBatchFilter *filter, Var *var)
+{
+	if (var->varattno <= 0 || var->varlevelsup != 0 ||
+		batch_type_kind(var->vartype) == AOCSBATCH_TYPE_NONE)
+		return false;
+
+	if (filter->attno == InvalidAttrNumber)
+	{
+		filter->attno = var->varattno;
+		filter->typid = var->vartype;
+		filter->isfloat = (batch_type_kind(var->vartype) == AOCSBATCH_TYPE_FLOAT);
+	}
+
+	return filter->attno == var->varattno;
+}
+
+/*
+ * Add the condition for one qual clause. Returns false if it has a form
+ * that cannot be evaluated in batch.
+ */
+static bool
+batch_add_clause(AOCSBatchFilter *filter, Expr *clause)
+{
+	AOCSBatchCond *cond;
+	Var		   *var;
+	Const	   *con;
+	Oid			opno;
+	bool		commuted = false;
+	TypeCacheEntry *typentry;
+	int			strategy;
+	Oid			lefttype;
+	Oid			righttype;
+
+	if (is_andclause(clause))
+	{
+		ListCell   *lc;
+
+		foreach(lc, ((BoolExpr *) clause)->args)
+		{
+			if (!batch_add_clause(filter, (Expr *) lfirst(lc)))
+				return false;
+		}
+		return true;
+	}
+
+	if (IsA(clause, NullTest))
+	{
+		NullTest   *ntest = (NullTest *) clause;
+
+		if (ntest->argisrow || !IsA(ntest->arg, Var) ||
+			!batch_check_var(filter, (Var *) ntest->arg))
+			return false;
+
+		cond = palloc0(sizeof(AOCSBatchCond));
+		cond->kind = (ntest->nulltesttype == IS_NULL) ?
+			AOCSBATCH_COND_ISNULL : AOCSBATCH_COND_NOTNULL;
+		filter->conds = lappend(filter->conds, cond);
+		return true;
+	}
+
+	if (IsA(clause, OpExpr))
+	{
+		OpExpr	   *op = (OpExpr *) clause;
+		Expr	   *leftop;
+		Expr	   *rightop;
+
+		if (list_length(op->args) != 2)
+			return false;
+
+		leftop = (Expr *) linitial(op->args);
+		rightop = (Expr *) lsecond(op->args);
+
+		if (IsA(leftop, Var) && IsA(rightop, Const))
+		{
+			var = (Var *) leftop;
+			con = (Const *) rightop;
+		}
+		else if (IsA(leftop, Const) && IsA(rightop, Var))
+		{
+			var = (Var *) rightop;
+			con = (Const *) leftop;
+			commuted = true;
+		}
+		else
+			return false;
+
+		opno = op->opno;
+	}
+	else if (IsA(clause, ScalarArrayOpExpr))
+	{
+		ScalarArrayOpExpr *saop = (ScalarArrayOpExpr *) clause;
+
+		if (!saop->useOr || list_length(saop->args) != 2 ||
+			!IsA(linitial(saop->args), Var) ||
+			!IsA(lsecond(saop->args), Const))
+			return false;
+
+		var = (Var *) linitial(saop->args);
+		con = (Const *) lsecond(saop->args);
+		opno = saop->opno;
+	}
+	else
+		return false;
+
+	if (con->constisnull || !batch_check_var(filter, var))
+		return false;
+
+	/*
+	 * The operator must be a btree comparison of the column type, so that
+	 * its meaning is known.
+	 */
+	typentry = lookup_type_cache(var->vartype, TYPECACHE_BTREE_OPFAMILY);
+	if (!OidIsValid(typentry->btree_opf) ||
+		get_op_opfamily_strategy(opno, typentry->btree_opf) == 0)
+		return false;
+
+	get_op_opfamily_properties(opno, typentry->btree_opf, false,
+							   &strategy, &lefttype, &righttype);
+
+	if (commuted)
+	{
+		Oid			tmp = lefttype;
+
+		lefttype = righttype;
+		righttype = tmp;
+		strategy = BTCommuteStrategyNumber(strategy);
+	}
+
+	/*
+	 * Cross-type integer and floating point comparisons compare the widened
+	 * values; the date/time families would need a conversion, so only their
+	 * same-type operators are handled.
+	 */
+	if (lefttype != var->vartype ||
+		batch_type_kind(lefttype) != batch_type_kind(righttype) ||
+		(batch_type_kind(lefttype) == AOCSBATCH_TYPE_DATETIME &&
+		 lefttype != righttype))
+		return false;
+
+	cond = palloc0(sizeof(AOCSBatchCond));
+	cond->strategy = strategy;
+
+	if (IsA(clause, ScalarArrayOpExpr))
+	{
+		ArrayType  *arr = DatumGetArrayTypeP(con->constvalue);
+		int16		elmlen;
+		bool		elmbyval;
+		char		elmalign;
+		Datum	   *elems;
+		bool	   *nulls;
+		int			nelems;
+		int			i;
+
+		if (strategy != BTEqualStrategyNumber || ARR_ELEMTYPE(arr) != righttype)
+			return false;
+
+		get_typlenbyvalalign(ARR_ELEMTYPE(arr), &elmlen, &elmbyval, &elmalign);
+		deconstruct_array(arr, ARR_ELEMTYPE(arr), elmlen, elmbyval, elmalign,
+						  &elems, &nulls, &nelems);
+
+		/* NULL elements never match, in a WHERE clause they can be ignored */
+		cond->kind = AOCSBATCH_COND_IN;
+		for (i = 0; i < nelems; i++)
+		{
+			if (nulls[i])
+				continue;
+			if (cond->nconsts == AOCS_BATCHFILTER_MAX_IN_ITEMS ||
+				!batch_set_const(filter, cond, cond->nconsts, righttype, elems[i]))
+				return false;
+			cond->nconsts++;
+		}
+
+		if (cond->nconsts == 0)
+			return false;
+	}
+	else
+	{
+		if (con->consttype != righttype)
+			return false;
+
+		cond->kind = AOCSBATCH_COND_CMP;
+		if (!batch_set_const(filter, cond, 0, righttype, con->constvalue))
+			return false;
+		cond->nconsts = 1;
+	}
+
+	filter->strict = true;
+	filter->conds = lappend(filter->conds, cond);
+	return true;
+}
+
+/*
+ * aocs_batchfilter_create
+ *
+ * Build a batch filter for the implicitly ANDed pushed down quals of one
+ * column. Returns NULL unless all of them can be evaluated in batch.
+ *
+ * The filter lives in the current memory context.
+ */
+AOCSBatchFilter *
+aocs_batchfilter_create(List *quals)
+{
+	AOCSBatchFilter *filter;
+	ListCell   *lc;
+
+	filter = palloc0(sizeof(AOCSBatchFilter));
+	filter->attno = InvalidAttrNumber;
+	filter->firstRowNum = -1;
+	filter->mcxt = CurrentMemoryContext;
+
+	foreach(lc, quals)
+	{
+		if (!batch_add_clause(filter, (Expr *) lfirst(lc)))
+		{
+			list_free_deep(filter->conds);
+			pfree(filter);
+			return NULL;
+		}
+	}
+
+	if (filter->conds == NIL)
+	{
+		pfree(filter);
+		return NULL;
+	}
+
+	return filter;
+}
+
+/*
+ * aocs_batchfilter_reset
+ *
+ * Forget the evaluated block, e.g. when the scan moves to another segment
+ * file where row numbers start over.
+ */
+void
+aocs_batchfilter_reset(AOCSBatchFilter *filter)
+{
+	filter->firstRowNum = -1;
+	filter->nrows = 0;
+}
+
+/*
+ * Evaluation kernels. They must stay free of branches in the loop bodies so
+ * that they are vectorized.
+ */
+#define BATCH_CMP_LOOP(v, c, op) \
+	do { \
+		for (i = 0; i < n; i++) \
+			sel[i] &= ((v)[i] op (c)); \
+	} while (0)
+
+static void
+batch_eval_cmp_int(const int64 *v, bool *sel, int n, int strategy, int64 c)
+{
+	int			i;
+
+	switch (strategy)
+	{
+		case BTLessStrategyNumber:
+			BATCH_CMP_LOOP(v, c, <);
+			break;
+		case BTLessEqualStrategyNumber:
+			BATCH_CMP_LOOP(v, c, <=);
+			break;
+		case BTEqualStrategyNumber:
+			BATCH_CMP_LOOP(v, c, ==);
+			break;
+		case BTGreaterEqualStrategyNumber:
+			BATCH_CMP_LOOP(v, c, >=);
+			break;
+		case BTGreaterStrategyNumber:
+			BATCH_CMP_LOOP(v, c, >);
+			break;
+		default:
+			elog(ERROR, "unexpected btree strategy %d", strategy);
+	}
+}
+
+/*
+ * NaN sorts above every other value in PostgreSQL, while every C comparison
+ * involving NaN is false. The constant is never NaN, so only > and >= need
+ * to let NaN values through explicitly.
+ */
+static void
+batch_eval_cmp_float(const double *v, bool *sel, int n, int strategy, double c)
+{
+	int			i;
+
+	switch (strategy)
+	{
+		case BTLessStrategyNumber:
+			BATCH_CMP_LOOP(v, c, <);
+			break;
+		case BTLessEqualStrategyNumber:
+			BATCH_CMP_LOOP(v, c, <=);
+			break;
+		case BTEqualStrategyNumber:
+			BATCH_CMP_LOOP(v, c, ==);
+			break;
+		case BTGreaterEqualStrategyNumber:
+			for (i = 0; i < n; i++)
+				sel[i] &= ((v[i] >= c) | (v[i] != v[i]));
+			break;
+		case BTGreaterStrategyNumber:
+			for (i = 0; i < n; i++)
+				sel[i] &= ((v[i] > c) | (v[i] != v[i]));
+			break;
+		default:
+			elog(ERROR, "unexpected btree strategy %d", strategy);
+	}
+}
+
+static void
+batch_evaluate(AOCSBatchFilter *filter, int n)
+{
+	bool	   *sel = filter->selected;
+	bool	   *isnull = filter->isnull;
+	bool	   *match = filter->match;
+	int64	   *iv = filter->ivalues;
+	double	   *fv = filter->fvalues;
+	ListCell   *lc;
+	int			i;
+	int			k;
+
+	memset(sel, true, n * sizeof(bool));
+
+	/* Widen the values once, the conditions then work on plain arrays */
+	if (filter->isfloat)
+	{
+		for (i = 0; i < n; i++)
+			fv[i] = batch_datum_double(filter->typid, filter->values[i]);
+	}
+	else
+	{
+		for (i = 0; i < n; i++)
+			iv[i] = batch_datum_int64(filter->typid, filter->values[i]);
+	}
+
+	foreach(lc, filter->conds)
+	{
+		AOCSBatchCond *cond = (AOCSBatchCond *) lfirst(lc);
+
+		switch (cond->kind)
+		{
+			case AOCSBATCH_COND_ISNULL:
+				for (i = 0; i < n; i++)
+					sel[i] &= isnull[i];
+				break;
+
+			case AOCSBATCH_COND_NOTNULL:
+				for (i = 0; i < n; i++)
+					sel[i] &= !isnull[i];
+				break;
+
+			case AOCSBATCH_COND_CMP:
+				if (filter->isfloat)
+					batch_eval_cmp_float(fv, sel, n, cond->strategy,
+										 cond->fconsts[0]);
+				else
+					batch_eval_cmp_int(iv, sel, n, cond->strategy,
+									   cond->iconsts[0]);
+				break;
+
+			case AOCSBATCH_COND_IN:
+				memset(match, false, n * sizeof(bool));
+				for (k = 0; k < cond->nconsts; k++)
+				{
+					if (filter->isfloat)
+					{
+						double		c = cond->fconsts[k];
+
+						for (i = 0; i < n; i++)
+							match[i] |= (fv[i] == c);
+					}
+					else
+					{
+						int64		c = cond->iconsts[k];
+
+						for (i = 0; i < n; i++)
+							match[i] |= (iv[i] == c);
+					}
+				}
+				for (i = 0; i < n; i++)
+					sel[i] &= match[i];
+				break;
+		}
+	}
+
+	/* The comparison operators are strict */
+	if (filter->strict)
+	{
+		for (i = 0; i < n; i++)
+			sel[i] &= !isnull[i];
+	}
+}
+
+/*
+ * Decode and evaluate the block that the datum stream has just read.
+ */
+static void
+batch_load_block(AOCSBatchFilter *filter, DatumStreamRead *ds)
+{
+	int			nrows = ds->blockRead.logical_row_count;
+
+	if (nrows > filter->size)
+	{
+		int			newsize = Max(nrows, 2 * filter->size);
+
+		if (filter->values)
+		{
+			pfree(filter->values);
+			pfree(filter->isnull);
+			pfree(filter->ivalues);
+			pfree(filter->fvalues);
+			pfree(filter->match);
+			pfree(filter->selected);
+		}
+
+		filter->values = MemoryContextAlloc(filter->mcxt, newsize * sizeof(Datum));
+		filter->isnull = MemoryContextAlloc(filter->mcxt, newsize * sizeof(bool));
+		filter->ivalues = MemoryContextAlloc(filter->mcxt, newsize * sizeof(int64));
+		filter->fvalues = MemoryContextAlloc(filter->mcxt, newsize * sizeof(double));
+		filter->match = MemoryContextAlloc(filter->mcxt, newsize * sizeof(bool));
+		filter->selected = MemoryContextAlloc(filter->mcxt, newsize * sizeof(bool));
+		filter->size = newsize;
+	}
+
+	filter->nrows = datumstreamread_block_decode(ds, filter->values,
+												 filter->isnull);
+	Assert(filter->nrows <= filter->size);
+
+	batch_evaluate(filter, filter->nrows);
+	filter->firstRowNum = ds->blockFirstRowNum;
+}
+
+/*
+ * aocs_batchfilter_next
+ *
+ * Return the first row at or after rowNum, in the block the datum stream of
+ * the filtered column is on, that satisfies the quals. Returns the row
+ * number just past the block if there is none. The block is decoded and
+ * evaluated the first time it is asked about.
+ */
+int64
+aocs_batchfilter_next(AOCSBatchFilter *filter, DatumStreamRead *ds,
+					  int64 rowNum)
+{
+	int64		offset = rowNum - ds->blockFirstRowNum;
+	bool	   *found;
+
+	Assert(offset >= 0);
+
+	if (filter->firstRowNum != ds->blockFirstRowNum)
+		batch_load_block(filter, ds);
+
+	if (offset < filter->nrows)
+	{
+		found = memchr(&filter->selected[offset], true, filter->nrows - offset);
+		if (found)
+			return ds->blockFirstRowNum + (found - filter->selected);
+	}
+
+	return ds->blockFirstRowNum + Max(filter->nrows, ds->blockRowCount);
+}
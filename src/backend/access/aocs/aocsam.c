@@ -19,7 +19,9 @@
 #include "common/relpath.h"
 #include "access/amapi.h"
 #include "access/aocssegfiles.h"
+#include "access/aocs_batchfilter.h"
 #include "access/aomd.h"
+#include "access/appendonly_zonemap.h"
 #include "access/appendonlytid.h"
 #include "access/appendonlywriter.h"
 #include "access/heapam.h"
@@ -342,6 +344,50 @@ initscan_with_colinfo(AOCSScanDesc scan)
 	pgstat_count_heap_scan(scan->rs_base.rs_rd);
 }
 
+/*
+ * Decide whether the columns of the current segment file are moved by row
+ * number, which is needed to skip rows with the zone map or the batch
+ * filter. Blocks of older formats do not carry their first row number, so
+ * they are always read one datum at a time.
+ *
+ * newSeg tells that no row of the segment file has been read yet; otherwise
+ * all the projected columns are on the current row.
+ */
+static void
+begin_positioned_scan_seg(AOCSScanDesc scan, bool newSeg)
+{
+	AOCSFileSegInfo *curSegInfo = scan->seginfo[scan->cur_seg];
+
+	scan->aos_positioned = false;
+
+	if (!scan->aos_zonemap_active && scan->aos_batch_filter == NULL)
+		return;
+
+	if (curSegInfo->formatversion != AOSegfileFormatVersion_GetLatest())
+		return;
+
+	if (newSeg)
+	{
+		AttrNumber	i;
+
+		/* Forget the blocks of the previous segment file */
+		for (i = 0; i < scan->columnScanInfo.num_proj_atts; i++)
+			scan->columnScanInfo.ds[scan->columnScanInfo.proj_atts[i]]->blockRowCount = 0;
+		scan->aos_cur_row = 0;
+	}
+	else
+	{
+		DatumStreamRead *ds = scan->columnScanInfo.ds[scan->columnScanInfo.proj_atts[0]];
+
+		scan->aos_cur_row = ds->blockFirstRowNum + datumstreamread_nth(ds);
+	}
+
+	if (scan->aos_batch_filter)
+		aocs_batchfilter_reset(scan->aos_batch_filter);
+
+	scan->aos_positioned = true;
+}
+
 static int
 open_next_scan_seg(AOCSScanDesc scan)
 {
@@ -417,7 +463,8 @@ open_next_scan_seg(AOCSScanDesc scan)
 															scan->rs_base.rs_rd,
 															curSegInfo->segno,
 															scan->columnScanInfo.relationTupleDesc->natts,
-															true);
+															true,
+															false);
 				}
 
 				open_all_datumstreamread_segfiles(scan->rs_base.rs_rd,
@@ -427,6 +474,19 @@ open_next_scan_seg(AOCSScanDesc scan)
 												  scan->columnScanInfo.num_proj_atts,
 												  scan->blockDirectory);
 
+				/*
+				 * Load the zone map of the segment file, unless this scan
+				 * builds the block directory itself.
+				 */
+				scan->aos_zonemap_active = false;
+				if (scan->aos_zonemap && !scan->blockDirectory)
+					scan->aos_zonemap_active =
+						AOZoneMap_LoadSegmentFile(scan->aos_zonemap,
+												  scan->appendOnlyMetaDataSnapshot,
+												  curSegInfo->segno);
+
+				begin_positioned_scan_seg(scan, true);
+
 				return scan->cur_seg;
 			}
 		}
@@ -741,6 +801,84 @@ static void upgrade_datum_fetch(AOCSFetchDesc fetch, int attno, Datum values[],
 					   values, isnull, formatversion);
 }
 
+/*
+ * Position the datum stream of the i'th projected column on the next row to
+ * return, skipping the rows that the zone map or the batch filter rule out.
+ *
+ * The first projected column picks the next candidate row: blocks that the
+ * zone map excludes are skipped by their header without reading their
+ * content, and the batch filter evaluates the quals of the column on whole
+ * blocks. The other columns then seek to that same row. Returns false at
+ * the end of the segment file.
+ */
+static bool
+aocs_positioned_advance(AOCSScanDesc scan, int i, AttrNumber attno)
+{
+	DatumStreamRead *ds = scan->columnScanInfo.ds[attno];
+	AOZoneMapScanState *zonemap = NULL;
+	AOCSBatchFilter *filter = NULL;
+	int64		rowNum;
+
+	if (i == 0)
+	{
+		if (scan->aos_zonemap_active)
+			zonemap = scan->aos_zonemap;
+		filter = scan->aos_batch_filter;
+		rowNum = scan->aos_cur_row + 1;
+	}
+	else
+		rowNum = scan->aos_cur_row;
+
+	for (;;)
+	{
+		if (zonemap)
+			rowNum = AOZoneMap_NextCandidateRow(zonemap, rowNum);
+
+		if (rowNum < ds->blockFirstRowNum ||
+			rowNum >= ds->blockFirstRowNum + ds->blockRowCount)
+		{
+			int64		endRowNum;
+
+			if (datumstreamread_block_header(ds) < 0)
+				return false;
+
+			endRowNum = ds->blockFirstRowNum + ds->blockRowCount;
+			if (endRowNum <= rowNum ||
+				(zonemap && AOZoneMap_CanSkipRows(zonemap, ds->blockFirstRowNum,
+												  ds->blockRowCount)))
+			{
+				if (zonemap)
+					AOZoneMap_CountBlock(zonemap, true);
+				datumstreamread_skip_block(ds);
+				rowNum = Max(rowNum, endRowNum);
+				continue;
+			}
+
+			datumstreamread_block_content(ds);
+			if (zonemap)
+				AOZoneMap_CountBlock(zonemap, false);
+			rowNum = Max(rowNum, ds->blockFirstRowNum);
+			continue;
+		}
+
+		if (filter)
+		{
+			rowNum = aocs_batchfilter_next(filter, ds, rowNum);
+			if (rowNum >= ds->blockFirstRowNum + ds->blockRowCount)
+				continue;
+		}
+
+		break;
+	}
+
+	datumstreamread_find(ds, rowNum - ds->blockFirstRowNum);
+
+	if (i == 0)
+		scan->aos_cur_row = rowNum;
+
+	return true;
+}
+
 bool
 aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 {
@@ -761,6 +899,18 @@ aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 		Assert(scan->aos_scaned_rows >= scan->aos_sample_rows);
 	}
 
+	/*
+	 * The pushed down quals are in their final order now; evaluate the ones
+	 * of the first column in batch if possible.
+	 */
+	if (scan->aos_batch_filter == NULL && scan->aos_batch_filters &&
+		scan->aos_batch_filters[0])
+	{
+		scan->aos_batch_filter = scan->aos_batch_filters[0];
+		if (scan->cur_seg >= 0)
+			begin_positioned_scan_seg(scan, scan->cur_seg_row == 0);
+	}
+
 	Datum	   *d = slot->tts_values;
 	bool	   *null = slot->tts_isnull;
 
@@ -813,22 +963,34 @@ ReadNext:
 		{
 			AttrNumber	attno = scan->columnScanInfo.proj_atts[i];
 
-			err = datumstreamread_advance(scan->columnScanInfo.ds[attno]);
-			Assert(err >= 0);
-			if (err == 0)
+			if (scan->aos_positioned)
 			{
-				err = datumstreamread_block(scan->columnScanInfo.ds[attno], scan->blockDirectory, attno);
-				if (err < 0)
+				if (!aocs_positioned_advance(scan, i, attno))
 				{
-					/*
-					 * Ha, cannot read next block, we need to go to next seg
-					 */
 					close_cur_scan_seg(scan);
+					err = -1;
 					goto ReadNext;
 				}
-
+			}
+			else
+			{
 				err = datumstreamread_advance(scan->columnScanInfo.ds[attno]);
-				Assert(err > 0);
+				Assert(err >= 0);
+				if (err == 0)
+				{
+					err = datumstreamread_block(scan->columnScanInfo.ds[attno], scan->blockDirectory, attno);
+					if (err < 0)
+					{
+						/*
+						 * Ha, cannot read next block, we need to go to next seg
+						 */
+						close_cur_scan_seg(scan);
+						goto ReadNext;
+					}
+
+					err = datumstreamread_advance(scan->columnScanInfo.ds[attno]);
+					Assert(err > 0);
+				}
 			}
 			if (!visible_pass || !predicate_pass)
 				continue; /* not break, need advance for other cols */
@@ -881,6 +1043,9 @@ ReadNext:
 					continue; /* not break, need advance for other cols */
 				}
 			}
+			/* The batch filter has already checked the quals of column 0 */
+			if (i == 0 && scan->aos_positioned && scan->aos_batch_filter)
+				continue;
 			if (scan->aos_pushdown_qual && scan->aos_pushdown_qual[i])
 				predicate_pass &= aocs_col_predicate_test(scan, slot, i, true);
 		}
@@ -1045,7 +1210,8 @@ aocs_insert_init(Relation rel, int segno)
 																				 * by same exclusive
 																				 * lock. */
 											(FileSegInfo *) desc->fsInfo, desc->lastSequence,
-											rel, segno, tupleDesc->natts, true);
+											rel, segno, tupleDesc->natts, true,
+											gp_appendonly_zonemap);
 
 	/* Should not enable insertMultiFiles if the table is created by own transaction or in utility mode */
 	if (Gp_role != GP_ROLE_UTILITY)
@@ -1059,6 +1225,7 @@ aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool *null, AOTupleId *aoTupl
 {
 	Relation	rel = idesc->aoi_rel;
 	int			i;
+	AOZoneMapGroup *zonemap;
 
 #ifdef FAULT_INJECTOR
 	FaultInjector_InjectFaultIfSet(
@@ -1123,6 +1290,11 @@ aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool *null, AOTupleId *aoTupl
 			}
 		}
 
+		/* The value is in the current block now, account it */
+		zonemap = AppendOnlyBlockDirectory_GetZoneMap(&idesc->blockDirectory, i);
+		if (zonemap)
+			AOZoneMap_AddValues(zonemap, &d[i], &null[i]);
+
 		if (toFree1 != NULL)
 			pfree(toFree1);
 	}
@@ -2352,6 +2524,7 @@ aocs_predicate_pushdown_prepare(AOCSScanDesc scan,
 	scan->aos_sample_rows       = gp_predicate_pushdown_sample_rows;
 	scan->aos_scaned_rows       = 0;
 	scan->aos_qual_rows         = (int *)palloc0(sizeof(int) * ncol);
+	scan->aos_batch_filters     = (AOCSBatchFilter **)palloc0(sizeof(AOCSBatchFilter *) * ncol);
 
 	if (!qual)
 		return state;
@@ -2374,6 +2547,7 @@ aocs_predicate_pushdown_prepare(AOCSScanDesc scan,
 
 		Assert(scan->aos_pushdown_qual[0] == NULL);
 		scan->aos_pushdown_qual[0] = state;
+		scan->aos_batch_filters[0] = aocs_batchfilter_create(qual);
 		scan->aos_qual_col_num = 1;
 
 		/* The whole qual can be pushed down, so no left qual with seqscan node. */
@@ -2447,6 +2621,7 @@ aocs_predicate_pushdown_prepare(AOCSScanDesc scan,
 	{
 		Assert(qual_list[i]);
 		scan->aos_pushdown_qual[i] = ExecInitQual(qual_list[i], ps);
+		scan->aos_batch_filters[i] = aocs_batchfilter_create(qual_list[i]);
 	}
 	scan->aos_qual_col_num = qual_attr_num;
 	return ExecInitQual(quals_in_scan, ps);
@@ -2456,6 +2631,7 @@ struct qual_sort_item {
 	int aos_qual_rows;
 	int proj_atts;
 	ExprState *aos_pushdown_qual;
+	AOCSBatchFilter *aos_batch_filter;
 };
 static int
 compare_qual_item(const void *a, const void *b)
@@ -2481,6 +2657,7 @@ reorder_qual_col(AOCSScanDesc scan)
 		items[i].aos_qual_rows = scan->aos_qual_rows[i];
 		items[i].proj_atts = scan->columnScanInfo.proj_atts[i];
 		items[i].aos_pushdown_qual = scan->aos_pushdown_qual[i];
+		items[i].aos_batch_filter = scan->aos_batch_filters[i];
 	}
 	qsort(items, n, sizeof(struct qual_sort_item), compare_qual_item);
 	for (i = 0; i < n; i++)
@@ -2488,6 +2665,7 @@ reorder_qual_col(AOCSScanDesc scan)
 		scan->aos_qual_rows[i] = items[i].aos_qual_rows;
 		scan->columnScanInfo.proj_atts[i] = items[i].proj_atts;
 		scan->aos_pushdown_qual[i] = items[i].aos_pushdown_qual;
+		scan->aos_batch_filters[i] = items[i].aos_batch_filter;
 	}
 	pfree(items);
 }
@@ -2548,22 +2726,34 @@ ReadNext:
 		{
 			AttrNumber	attno = scan->columnScanInfo.proj_atts[i];
 
-			err = datumstreamread_advance(scan->columnScanInfo.ds[attno]);
-			Assert(err >= 0);
-			if (err == 0)
+			if (scan->aos_positioned)
 			{
-				err = datumstreamread_block(scan->columnScanInfo.ds[attno], scan->blockDirectory, attno);
-				if (err < 0)
+				if (!aocs_positioned_advance(scan, i, attno))
 				{
-					/*
-					 * Ha, cannot read next block, we need to go to next seg
-					 */
 					close_cur_scan_seg(scan);
+					err = -1;
 					goto ReadNext;
 				}
-
+			}
+			else
+			{
 				err = datumstreamread_advance(scan->columnScanInfo.ds[attno]);
-				Assert(err > 0);
+				Assert(err >= 0);
+				if (err == 0)
+				{
+					err = datumstreamread_block(scan->columnScanInfo.ds[attno], scan->blockDirectory, attno);
+					if (err < 0)
+					{
+						/*
+						 * Ha, cannot read next block, we need to go to next seg
+						 */
+						close_cur_scan_seg(scan);
+						goto ReadNext;
+					}
+
+					err = datumstreamread_advance(scan->columnScanInfo.ds[attno]);
+					Assert(err > 0);
+				}
 			}
 			/* test all qual cols whatever predicate_pass is true or false */
 			if (!visible_pass || (!predicate_pass && i >= scan->aos_qual_col_num))
@@ -0,0 +1,1168 @@
+/*-------------------------------------------------------------------------
+ *
+ * appendonly_zonemap.c
+ *	  Per-block min/max summaries ("zone maps") for append-optimized tables.
+ *
+ * For every block directory entry, i.e. every varblock of an AO row table or
+ * every block of an AOCS column, we remember the minimum and maximum value
+ * and the number of NULLs of the pass-by-value columns.  A sequential scan
+ * compares these summaries against the simple quals of the scan and skips
+ * blocks that cannot contain a matching row, without reading or
+ * decompressing them.
+ *
+ * The summaries are stored in the block directory itself, as a trailer that
+ * follows the entries of a minipage:
+ *
+ *		Minipage header and entry[nEntry]	(unchanged)
+ *		AOZoneMapTrailer					(MAXALIGN'ed)
+ *		AOZoneMapSummary[nEntry][nAtts]
+ *
+ * Such minipages are marked with MINIPAGE_VERSION_ZONEMAP.  Readers that are
+ * not interested in zone maps only look at the first nEntry entries, so the
+ * trailer is invisible to them.  A summary is only trusted when it covers
+ * every row of its entry (AOZONEMAP_HAS_SUMMARY); anything else makes the
+ * block a candidate, so old minipages and entries written while the zone map
+ * was not maintained are always read.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/access/appendonly/appendonly_zonemap.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/appendonly_zonemap.h"
+#include "access/genam.h"
+#include "access/htup_details.h"
+#include "access/nbtree.h"
+#include "access/stratnum.h"
+#include "access/table.h"
+#include "catalog/aoblkdir.h"
+#include "catalog/pg_appendonly.h"
+#include "cdb/cdbappendonlyblockdirectory.h"
+#include "nodes/nodeFuncs.h"
+#include "nodes/primnodes.h"
+#include "utils/array.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/typcache.h"
+
+/*
+ * Zone map trailers make a minipage bigger; keep the block directory tuple
+ * well below the heap tuple limit as the minipage is stored inline.
+ */
+#define AOZONEMAP_MINIPAGE_BUDGET	(MaxHeapTupleSize / 2)
+
+typedef enum AOZoneMapKeyKind
+{
+	AOZONEMAP_KEY_CMP,			/* var op const */
+	AOZONEMAP_KEY_IN,			/* var = ANY(const array) */
+	AOZONEMAP_KEY_ISNULL,		/* var IS NULL */
+	AOZONEMAP_KEY_NOTNULL		/* var IS NOT NULL */
+} AOZoneMapKeyKind;
+
+typedef struct AOZoneMapScanKey
+{
+	AOZoneMapKeyKind kind;
+	AttrNumber	attnum;
+	int			groupIdx;		/* index into AOZoneMapScanState.groups */
+
+	/* for AOZONEMAP_KEY_CMP and AOZONEMAP_KEY_IN */
+	StrategyNumber strategy;
+	FmgrInfo	cmpProc;		/* btree support 1, column type on the left */
+	Oid			collation;
+	int			nargs;
+	Datum	   *args;
+} AOZoneMapScanKey;
+
+/* A column group whose block directory rows are consulted by the scan */
+typedef struct AOZoneMapScanGroup
+{
+	int			columnGroupNo;
+	int			nAtts;
+	AttrNumber	attnums[AO_ZONEMAP_MAX_ATTS];
+} AOZoneMapScanGroup;
+
+typedef struct AOZoneMapEntry
+{
+	int64		firstRowNum;
+	int64		fileOffset;
+	int64		rowCount;
+	bool		skip;
+} AOZoneMapEntry;
+
+/* Row range [firstRowNum, endRowNum) that cannot satisfy the quals */
+typedef struct AOZoneMapRange
+{
+	int64		firstRowNum;
+	int64		endRowNum;
+} AOZoneMapRange;
+
+struct AOZoneMapScanState
+{
+	Relation	rel;
+	bool		isAOCol;
+	Oid			blkdirrelid;
+	Oid			blkdiridxid;
+
+	int			nkeys;
+	AOZoneMapScanKey *keys;
+
+	int			ngroups;
+	AOZoneMapScanGroup *groups;
+
+	/* Loaded for the current segment file, allocated in segcxt */
+	MemoryContext segcxt;
+	int			nentries;
+	int			maxentries;
+	AOZoneMapEntry *entries;	/* AO row tables only */
+	int			nranges;
+	int			maxranges;
+	AOZoneMapRange *ranges;
+
+	/* Statistics for EXPLAIN ANALYZE */
+	int64		blocksChecked;
+	int64		blocksSkipped;
+};
+
+static bool zonemap_column_eligible(Form_pg_attribute att);
+static List *zonemap_flatten_quals(List *quals, List *clauses);
+static void zonemap_add_clause(AOZoneMapScanState *state, Expr *clause);
+static int	zonemap_group_for_attnum(AOZoneMapScanState *state, AttrNumber attnum);
+static bool zonemap_key_excludes(AOZoneMapScanKey *key, AOZoneMapSummary *summary,
+								 int64 rowCount);
+static void zonemap_load_minipage(AOZoneMapScanState *state, int groupIdx,
+								  struct varlena *value);
+static void zonemap_add_range(AOZoneMapScanState *state, int64 firstRowNum,
+							  int64 rowCount);
+static int	zonemap_range_cmp(const void *a, const void *b);
+static int	zonemap_entry_cmp(const void *a, const void *b);
+
+/*
+ * Can the column be summarized?  Only pass-by-value types with a default
+ * btree operator class qualify, so that a summary is two Datums.
+ */
+static bool
+zonemap_column_eligible(Form_pg_attribute att)
+{
+	TypeCacheEntry *typentry;
+
+	if (att->attisdropped || !att->attbyval ||
+		att->attlen <= 0 || att->attlen > sizeof(Datum))
+		return false;
+
+	typentry = lookup_type_cache(att->atttypid, TYPECACHE_CMP_PROC);
+
+	return OidIsValid(typentry->cmp_proc);
+}
+
+/* ----------------------------------------------------------------
+ *		Insert side
+ * ----------------------------------------------------------------
+ */
+
+/*
+ * AOZoneMap_CreateGroup
+ *
+ * Set up the zone map of one column group for inserts.  For AO row tables
+ * the first AO_ZONEMAP_MAX_ATTS eligible columns are summarized; for AOCS
+ * tables column group N is column N + 1.  Returns NULL when there is nothing
+ * to summarize.
+ *
+ * Allocations are made in the current memory context, which is expected to
+ * be the memory context of the block directory.
+ */
+AOZoneMapGroup *
+AOZoneMap_CreateGroup(Relation rel, int columnGroupNo, bool isAOCol)
+{
+	TupleDesc	tupdesc = RelationGetDescr(rel);
+	AOZoneMapGroup *group;
+	AttrNumber	attno;
+	Size		perEntry;
+	uint32		maxEntries;
+
+	group = palloc0(sizeof(AOZoneMapGroup));
+
+	for (attno = 0; attno < tupdesc->natts; attno++)
+	{
+		Form_pg_attribute att = TupleDescAttr(tupdesc, attno);
+		TypeCacheEntry *typentry;
+		int			i = group->nAtts;
+
+		if (isAOCol && attno != columnGroupNo)
+			continue;
+
+		if (!zonemap_column_eligible(att))
+			continue;
+
+		typentry = lookup_type_cache(att->atttypid, TYPECACHE_CMP_PROC);
+
+		group->attnums[i] = att->attnum;
+		group->collations[i] = att->attcollation;
+		fmgr_info(typentry->cmp_proc, &group->cmpProcs[i]);
+		group->nAtts++;
+
+		if (group->nAtts == AO_ZONEMAP_MAX_ATTS)
+			break;
+	}
+
+	if (group->nAtts == 0)
+	{
+		pfree(group);
+		return NULL;
+	}
+
+	perEntry = sizeof(MinipageEntry) + group->nAtts * sizeof(AOZoneMapSummary);
+	maxEntries = (AOZONEMAP_MINIPAGE_BUDGET - offsetof(Minipage, entry) -
+				  AOZONEMAP_TRAILER_SIZE) / perEntry;
+	group->maxEntries = Max(Min(maxEntries, NUM_MINIPAGE_ENTRIES), 1);
+	group->summaries = palloc0(group->maxEntries * group->nAtts *
+							   sizeof(AOZoneMapSummary));
+
+	return group;
+}
+
+/*
+ * AOZoneMap_AddValues
+ *
+ * Account one row, whose summarized columns are given in values/isnull in
+ * the order of group->attnums, to the block being filled.
+ */
+void
+AOZoneMap_AddValues(AOZoneMapGroup *group, Datum *values, bool *isnull)
+{
+	int			i;
+
+	for (i = 0; i < group->nAtts; i++)
+	{
+		AOZoneMapSummary *summary = &group->pending[i];
+		Datum		value = values[i];
+
+		if (isnull[i])
+		{
+			summary->nullCount++;
+			continue;
+		}
+
+		if ((summary->flags & AOZONEMAP_HAS_VALUES) == 0)
+		{
+			summary->minValue = (int64) value;
+			summary->maxValue = (int64) value;
+			summary->flags |= AOZONEMAP_HAS_VALUES;
+			continue;
+		}
+
+		if (DatumGetInt32(FunctionCall2Coll(&group->cmpProcs[i],
+											group->collations[i],
+											value,
+											(Datum) summary->minValue)) < 0)
+			summary->minValue = (int64) value;
+		else if (DatumGetInt32(FunctionCall2Coll(&group->cmpProcs[i],
+												 group->collations[i],
+												 value,
+												 (Datum) summary->maxValue)) > 0)
+			summary->maxValue = (int64) value;
+	}
+
+	group->pendingRows++;
+}
+
+/*
+ * AOZoneMap_ResetEntry
+ *
+ * Forget the summaries of minipage entry entryNo.
+ */
+void
+AOZoneMap_ResetEntry(AOZoneMapGroup *group, int entryNo)
+{
+	Assert(entryNo < group->maxEntries);
+
+	MemSet(&group->summaries[entryNo * group->nAtts], 0,
+		   group->nAtts * sizeof(AOZoneMapSummary));
+}
+
+/*
+ * AOZoneMap_FinishEntry
+ *
+ * A block directory entry covering rowCount rows was added at entryNo; move
+ * the pending summaries into it.  If the rows added do not match the entry
+ * (e.g. a large row that was written on its own), the entry is left without
+ * a summary so that scans never skip it.
+ */
+void
+AOZoneMap_FinishEntry(AOZoneMapGroup *group, int entryNo, int64 rowCount)
+{
+	AOZoneMapSummary *summaries = &group->summaries[entryNo * group->nAtts];
+	int			i;
+
+	Assert(entryNo < group->maxEntries);
+
+	if (group->pendingRows == rowCount)
+	{
+		for (i = 0; i < group->nAtts; i++)
+		{
+			summaries[i] = group->pending[i];
+			summaries[i].flags |= AOZONEMAP_HAS_SUMMARY;
+		}
+	}
+	else
+		MemSet(summaries, 0, group->nAtts * sizeof(AOZoneMapSummary));
+
+	MemSet(group->pending, 0, sizeof(group->pending));
+	group->pendingRows = 0;
+}
+
+/*
+ * AOZoneMap_TrailerSize
+ *
+ * Size of the trailer for a minipage with nEntry entries, or 0 if the
+ * minipage is to be written without one.
+ */
+Size
+AOZoneMap_TrailerSize(AOZoneMapGroup *group, uint32 nEntry)
+{
+	if (group == NULL || nEntry > group->maxEntries)
+		return 0;
+
+	return AOZONEMAP_TRAILER_SIZE +
+		nEntry * group->nAtts * sizeof(AOZoneMapSummary);
+}
+
+/*
+ * AOZoneMap_WriteTrailer
+ *
+ * Write the trailer for a minipage with nEntry entries to dest, which must
+ * have room for AOZoneMap_TrailerSize() bytes.
+ */
+void
+AOZoneMap_WriteTrailer(AOZoneMapGroup *group, uint32 nEntry, char *dest)
+{
+	AOZoneMapTrailer trailer;
+	int			i;
+
+	Assert(nEntry <= group->maxEntries);
+
+	MemSet(dest, 0, AOZONEMAP_TRAILER_SIZE);
+	MemSet(&trailer, 0, sizeof(trailer));
+	trailer.nAtts = group->nAtts;
+	for (i = 0; i < group->nAtts; i++)
+		trailer.attnums[i] = group->attnums[i];
+	memcpy(dest, &trailer, sizeof(trailer));
+
+	memcpy(dest + AOZONEMAP_TRAILER_SIZE, group->summaries,
+		   nEntry * group->nAtts * sizeof(AOZoneMapSummary));
+}
+
+/*
+ * AOZoneMap_ReadTrailer
+ *
+ * Load the summaries of an existing minipage with nEntry entries, so that
+ * appending to it keeps them.  src/len is the trailer as found on disk, len
+ * is 0 if the minipage has none.  Summaries for columns the trailer does not
+ * know about are cleared.
+ */
+void
+AOZoneMap_ReadTrailer(AOZoneMapGroup *group, uint32 nEntry,
+					  const char *src, Size len)
+{
+	AOZoneMapTrailer trailer;
+	int			map[AO_ZONEMAP_MAX_ATTS];
+	uint32		entryNo;
+	int			i,
+				j;
+
+	if (nEntry > group->maxEntries)
+		return;
+
+	MemSet(group->summaries, 0,
+		   group->maxEntries * group->nAtts * sizeof(AOZoneMapSummary));
+
+	if (len < AOZONEMAP_TRAILER_SIZE)
+		return;
+
+	memcpy(&trailer, src, sizeof(trailer));
+	if (trailer.nAtts <= 0 || trailer.nAtts > AO_ZONEMAP_MAX_ATTS ||
+		len < AOZONEMAP_TRAILER_SIZE + nEntry * trailer.nAtts * sizeof(AOZoneMapSummary))
+		return;
+
+	for (i = 0; i < group->nAtts; i++)
+	{
+		map[i] = -1;
+		for (j = 0; j < trailer.nAtts; j++)
+		{
+			if (trailer.attnums[j] == group->attnums[i])
+				map[i] = j;
+		}
+	}
+
+	for (entryNo = 0; entryNo < nEntry; entryNo++)
+	{
+		const char *entrySummaries = src + AOZONEMAP_TRAILER_SIZE +
+			entryNo * trailer.nAtts * sizeof(AOZoneMapSummary);
+
+		for (i = 0; i < group->nAtts; i++)
+		{
+			if (map[i] < 0)
+				continue;
+			memcpy(&group->summaries[entryNo * group->nAtts + i],
+				   entrySummaries + map[i] * sizeof(AOZoneMapSummary),
+				   sizeof(AOZoneMapSummary));
+		}
+	}
+}
+
+/* ----------------------------------------------------------------
+ *		Scan side
+ * ----------------------------------------------------------------
+ */
+
+/*
+ * AOZoneMap_BeginScan
+ *
+ * Extract the quals that zone maps can evaluate from the implicitly-ANDed
+ * list 'qual' of a scan on 'rel'.  Returns NULL if the relation has no block
+ * directory or none of the quals is usable.
+ */
+AOZoneMapScanState *
+AOZoneMap_BeginScan(Relation rel, List *qual)
+{
+	AOZoneMapScanState *state;
+	List	   *clauses;
+	ListCell   *lc;
+	Oid			blkdirrelid;
+	Oid			blkdiridxid;
+
+	if (qual == NIL)
+		return NULL;
+
+	GetAppendOnlyEntryAuxOids(rel->rd_id, NULL, NULL,
+							  &blkdirrelid, &blkdiridxid, NULL, NULL);
+	if (!OidIsValid(blkdirrelid) || !OidIsValid(blkdiridxid))
+		return NULL;
+
+	state = palloc0(sizeof(AOZoneMapScanState));
+	state->rel = rel;
+	state->isAOCol = RelationIsAoCols(rel);
+	state->blkdirrelid = blkdirrelid;
+	state->blkdiridxid = blkdiridxid;
+
+	/*
+	 * ORCA hands us the quals as a single AND clause, so flatten them first.
+	 * Every clause adds at most one key and one group.
+	 */
+	clauses = zonemap_flatten_quals(qual, NIL);
+	state->keys = palloc0(list_length(clauses) * sizeof(AOZoneMapScanKey));
+	state->groups = palloc0(list_length(clauses) * sizeof(AOZoneMapScanGroup));
+
+	foreach(lc, clauses)
+		zonemap_add_clause(state, (Expr *) lfirst(lc));
+
+	list_free(clauses);
+
+	if (state->nkeys == 0)
+	{
+		pfree(state->keys);
+		pfree(state->groups);
+		pfree(state);
+		return NULL;
+	}
+
+	state->segcxt = AllocSetContextCreate(CurrentMemoryContext,
+										  "AO zone map",
+										  ALLOCSET_SMALL_SIZES);
+
+	return state;
+}
+
+/*
+ * Find or add the column group holding the summaries of attnum.  Returns -1
+ * if the group is full.
+ */
+static int
+zonemap_group_for_attnum(AOZoneMapScanState *state, AttrNumber attnum)
+{
+	int			columnGroupNo = state->isAOCol ? attnum - 1 : 0;
+	AOZoneMapScanGroup *group = NULL;
+	int			groupIdx;
+	int			i;
+
+	for (groupIdx = 0; groupIdx < state->ngroups; groupIdx++)
+	{
+		if (state->groups[groupIdx].columnGroupNo == columnGroupNo)
+		{
+			group = &state->groups[groupIdx];
+			break;
+		}
+	}
+
+	if (group == NULL)
+	{
+		groupIdx = state->ngroups++;
+		group = &state->groups[groupIdx];
+		group->columnGroupNo = columnGroupNo;
+		group->nAtts = 0;
+	}
+
+	for (i = 0; i < group->nAtts; i++)
+	{
+		if (group->attnums[i] == attnum)
+			return groupIdx;
+	}
+
+	if (group->nAtts == AO_ZONEMAP_MAX_ATTS)
+		return -1;
+
+	group->attnums[group->nAtts++] = attnum;
+
+	return groupIdx;
+}
+
+/*
+ * Append the clauses of quals to the clauses list, descending into AND
+ * clauses.
+ */
+static List *
+zonemap_flatten_quals(List *quals, List *clauses)
+{
+	ListCell   *lc;
+
+	foreach(lc, quals)
+	{
+		Expr	   *clause = (Expr *) lfirst(lc);
+
+		if (is_andclause(clause))
+			clauses = zonemap_flatten_quals(((BoolExpr *) clause)->args, clauses);
+		else
+			clauses = lappend(clauses, clause);
+	}
+
+	return clauses;
+}
+
+/*
+ * Turn one qual clause into a zone map key, if it has a form we can
+ * evaluate against a min/max summary.  Anything else is simply left to the
+ * regular qual evaluation.
+ */
+static void
+zonemap_add_clause(AOZoneMapScanState *state, Expr *clause)
+{
+	TupleDesc	tupdesc = RelationGetDescr(state->rel);
+	AOZoneMapScanKey *key;
+	Var		   *var;
+	Const	   *con;
+	Oid			opno;
+	Oid			collation;
+	bool		commuted = false;
+	Form_pg_attribute att;
+	TypeCacheEntry *typentry;
+	int			strategy;
+	Oid			lefttype;
+	Oid			righttype;
+	Oid			cmpproc;
+	int			groupIdx;
+
+	if (IsA(clause, NullTest))
+	{
+		NullTest   *ntest = (NullTest *) clause;
+
+		if (ntest->argisrow || !IsA(ntest->arg, Var))
+			return;
+
+		var = (Var *) ntest->arg;
+		if (var->varattno <= 0 || var->varlevelsup != 0 ||
+			var->varattno > tupdesc->natts ||
+			!zonemap_column_eligible(TupleDescAttr(tupdesc, var->varattno - 1)))
+			return;
+
+		groupIdx = zonemap_group_for_attnum(state, var->varattno);
+		if (groupIdx < 0)
+			return;
+
+		key = &state->keys[state->nkeys++];
+		key->kind = (ntest->nulltesttype == IS_NULL) ?
+			AOZONEMAP_KEY_ISNULL : AOZONEMAP_KEY_NOTNULL;
+		key->attnum = var->varattno;
+		key->groupIdx = groupIdx;
+		return;
+	}
+
+	if (IsA(clause, OpExpr))
+	{
+		OpExpr	   *op = (OpExpr *) clause;
+		Expr	   *leftop;
+		Expr	   *rightop;
+
+		if (list_length(op->args) != 2)
+			return;
+
+		leftop = (Expr *) linitial(op->args);
+		rightop = (Expr *) lsecond(op->args);
+
+		if (IsA(leftop, Var) && IsA(rightop, Const))
+		{
+			var = (Var *) leftop;
+			con = (Const *) rightop;
+		}
+		else if (IsA(leftop, Const) && IsA(rightop, Var))
+		{
+			var = (Var *) rightop;
+			con = (Const *) leftop;
+			commuted = true;
+		}
+		else
+			return;
+
+		opno = op->opno;
+		collation = op->inputcollid;
+	}
+	else if (IsA(clause, ScalarArrayOpExpr))
+	{
+		ScalarArrayOpExpr *saop = (ScalarArrayOpExpr *) clause;
+
+		if (!saop->useOr || list_length(saop->args) != 2 ||
+			!IsA(linitial(saop->args), Var) ||
+			!IsA(lsecond(saop->args), Const))
+			return;
+
+		var = (Var *) linitial(saop->args);
+		con = (Const *) lsecond(saop->args);
+		opno = saop->opno;
+		collation = saop->inputcollid;
+	}
+	else
+		return;
+
+	if (con->constisnull)
+		return;
+
+	if (var->varattno <= 0 || var->varlevelsup != 0 ||
+		var->varattno > tupdesc->natts)
+		return;
+
+	att = TupleDescAttr(tupdesc, var->varattno - 1);
+	if (!zonemap_column_eligible(att))
+		return;
+
+	/*
+	 * The summaries are ordered by the default btree opclass of the column
+	 * type, so the operator must belong to its family.
+	 */
+	typentry = lookup_type_cache(att->atttypid, TYPECACHE_BTREE_OPFAMILY);
+	if (!OidIsValid(typentry->btree_opf) ||
+		get_op_opfamily_strategy(opno, typentry->btree_opf) == 0)
+		return;
+
+	get_op_opfamily_properties(opno, typentry->btree_opf, false,
+							   &strategy, &lefttype, &righttype);
+
+	if (commuted)
+	{
+		Oid			tmp = lefttype;
+
+		lefttype = righttype;
+		righttype = tmp;
+		strategy = BTCommuteStrategyNumber(strategy);
+	}
+
+	cmpproc = get_opfamily_proc(typentry->btree_opf, lefttype, righttype,
+								BTORDER_PROC);
+	if (!RegProcedureIsValid(cmpproc))
+		return;
+
+	if (IsA(clause, ScalarArrayOpExpr))
+	{
+		ArrayType  *arr = DatumGetArrayTypeP(con->constvalue);
+		int16		elmlen;
+		bool		elmbyval;
+		char		elmalign;
+		Datum	   *elems;
+		bool	   *nulls;
+		int			nelems;
+		int			i;
+		int			nargs = 0;
+
+		if (strategy != BTEqualStrategyNumber)
+			return;
+
+		get_typlenbyvalalign(ARR_ELEMTYPE(arr), &elmlen, &elmbyval, &elmalign);
+		deconstruct_array(arr, ARR_ELEMTYPE(arr), elmlen, elmbyval, elmalign,
+						  &elems, &nulls, &nelems);
+
+		for (i = 0; i < nelems; i++)
+		{
+			if (!nulls[i])
+				elems[nargs++] = elems[i];
+		}
+		pfree(nulls);
+
+		if (nargs == 0)
+		{
+			pfree(elems);
+			return;
+		}
+
+		groupIdx = zonemap_group_for_attnum(state, var->varattno);
+		if (groupIdx < 0)
+			return;
+
+		key = &state->keys[state->nkeys++];
+		key->kind = AOZONEMAP_KEY_IN;
+		key->args = elems;
+		key->nargs = nargs;
+	}
+	else
+	{
+		groupIdx = zonemap_group_for_attnum(state, var->varattno);
+		if (groupIdx < 0)
+			return;
+
+		key = &state->keys[state->nkeys++];
+		key->kind = AOZONEMAP_KEY_CMP;
+		key->args = palloc(sizeof(Datum));
+		key->args[0] = con->constvalue;
+		key->nargs = 1;
+	}
+
+	key->attnum = var->varattno;
+	key->groupIdx = groupIdx;
+	key->strategy = strategy;
+	key->collation = collation;
+	fmgr_info(cmpproc, &key->cmpProc);
+}
+
+/*
+ * Does the summary prove that no row of the entry satisfies the key?
+ */
+static bool
+zonemap_key_excludes(AOZoneMapScanKey *key, AOZoneMapSummary *summary,
+					 int64 rowCount)
+{
+	Datum		minValue;
+	Datum		maxValue;
+	int			i;
+
+	if ((summary->flags & AOZONEMAP_HAS_SUMMARY) == 0)
+		return false;
+
+	switch (key->kind)
+	{
+		case AOZONEMAP_KEY_ISNULL:
+			return summary->nullCount == 0;
+
+		case AOZONEMAP_KEY_NOTNULL:
+			return summary->nullCount >= rowCount;
+
+		case AOZONEMAP_KEY_CMP:
+		case AOZONEMAP_KEY_IN:
+			/* Strict operators never match a block of NULLs */
+			if ((summary->flags & AOZONEMAP_HAS_VALUES) == 0)
+				return true;
+			break;
+	}
+
+	minValue = (Datum) summary->minValue;
+	maxValue = (Datum) summary->maxValue;
+
+	for (i = 0; i < key->nargs; i++)
+	{
+		Datum		arg = key->args[i];
+		bool		match;
+
+#define ZONEMAP_CMP(value) \
+		DatumGetInt32(FunctionCall2Coll(&key->cmpProc, key->collation, (value), arg))
+
+		switch (key->strategy)
+		{
+			case BTLessStrategyNumber:
+				match = ZONEMAP_CMP(minValue) < 0;
+				break;
+			case BTLessEqualStrategyNumber:
+				match = ZONEMAP_CMP(minValue) <= 0;
+				break;
+			case BTEqualStrategyNumber:
+				match = ZONEMAP_CMP(minValue) <= 0 && ZONEMAP_CMP(maxValue) >= 0;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				match = ZONEMAP_CMP(maxValue) >= 0;
+				break;
+			case BTGreaterStrategyNumber:
+				match = ZONEMAP_CMP(maxValue) > 0;
+				break;
+			default:
+				match = true;
+				break;
+		}
+
+#undef ZONEMAP_CMP
+
+		if (match)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Evaluate the keys against every entry of one block directory minipage of
+ * the given column group, remembering the row ranges that can be skipped.
+ */
+static void
+zonemap_load_minipage(AOZoneMapScanState *state, int groupIdx,
+					  struct varlena *value)
+{
+	AOZoneMapScanGroup *group = &state->groups[groupIdx];
+	Minipage	header;
+	AOZoneMapTrailer trailer;
+	const char *data = (const char *) value;
+	const char *summaries = NULL;
+	int			map[AO_ZONEMAP_MAX_ATTS];
+	uint32		entryNo;
+	int			i,
+				j;
+
+	memcpy(&header, data, offsetof(Minipage, entry));
+	if (VARSIZE(value) < minipage_size(header.nEntry))
+		elog(ERROR, "corrupted block directory minipage of relation \"%s\"",
+			 RelationGetRelationName(state->rel));
+
+	/* Locate the summaries of the attributes of this group, if any */
+	for (i = 0; i < group->nAtts; i++)
+		map[i] = -1;
+
+	if (header.version == MINIPAGE_VERSION_ZONEMAP &&
+		VARSIZE(value) >= minipage_size(header.nEntry) + AOZONEMAP_TRAILER_SIZE)
+	{
+		memcpy(&trailer, data + minipage_size(header.nEntry), sizeof(trailer));
+		if (trailer.nAtts > 0 && trailer.nAtts <= AO_ZONEMAP_MAX_ATTS &&
+			VARSIZE(value) >= minipage_size(header.nEntry) + AOZONEMAP_TRAILER_SIZE +
+			header.nEntry * trailer.nAtts * sizeof(AOZoneMapSummary))
+		{
+			summaries = data + minipage_size(header.nEntry) + AOZONEMAP_TRAILER_SIZE;
+			for (i = 0; i < group->nAtts; i++)
+			{
+				for (j = 0; j < trailer.nAtts; j++)
+				{
+					if (trailer.attnums[j] == group->attnums[i])
+						map[i] = j;
+				}
+			}
+		}
+	}
+
+	for (entryNo = 0; entryNo < header.nEntry; entryNo++)
+	{
+		MinipageEntry entry;
+		bool		skip = false;
+		int			k;
+
+		memcpy(&entry,
+			   data + offsetof(Minipage, entry) + entryNo * sizeof(MinipageEntry),
+			   sizeof(MinipageEntry));
+
+		for (k = 0; summaries != NULL && k < state->nkeys && !skip; k++)
+		{
+			AOZoneMapScanKey *key = &state->keys[k];
+			AOZoneMapSummary summary;
+
+			if (key->groupIdx != groupIdx)
+				continue;
+
+			for (i = 0; i < group->nAtts; i++)
+			{
+				if (group->attnums[i] == key->attnum)
+					break;
+			}
+			if (i == group->nAtts || map[i] < 0)
+				continue;
+
+			memcpy(&summary,
+				   summaries + (entryNo * trailer.nAtts + map[i]) * sizeof(AOZoneMapSummary),
+				   sizeof(AOZoneMapSummary));
+
+			skip = zonemap_key_excludes(key, &summary, entry.rowCount);
+		}
+
+		if (skip)
+			zonemap_add_range(state, entry.firstRowNum, entry.rowCount);
+
+		if (!state->isAOCol)
+		{
+			if (state->nentries == state->maxentries)
+			{
+				state->maxentries = Max(state->maxentries * 2, 64);
+				if (state->entries == NULL)
+					state->entries = MemoryContextAlloc(state->segcxt,
+														state->maxentries * sizeof(AOZoneMapEntry));
+				else
+					state->entries = repalloc(state->entries,
+											  state->maxentries * sizeof(AOZoneMapEntry));
+			}
+			state->entries[state->nentries].firstRowNum = entry.firstRowNum;
+			state->entries[state->nentries].fileOffset = entry.fileOffset;
+			state->entries[state->nentries].rowCount = entry.rowCount;
+			state->entries[state->nentries].skip = skip;
+			state->nentries++;
+		}
+	}
+}
+
+static void
+zonemap_add_range(AOZoneMapScanState *state, int64 firstRowNum, int64 rowCount)
+{
+	if (state->nranges == state->maxranges)
+	{
+		state->maxranges = Max(state->maxranges * 2, 64);
+		if (state->ranges == NULL)
+			state->ranges = MemoryContextAlloc(state->segcxt,
+											   state->maxranges * sizeof(AOZoneMapRange));
+		else
+			state->ranges = repalloc(state->ranges,
+									 state->maxranges * sizeof(AOZoneMapRange));
+	}
+
+	state->ranges[state->nranges].firstRowNum = firstRowNum;
+	state->ranges[state->nranges].endRowNum = firstRowNum + rowCount;
+	state->nranges++;
+}
+
+static int
+zonemap_range_cmp(const void *a, const void *b)
+{
+	const AOZoneMapRange *ra = (const AOZoneMapRange *) a;
+	const AOZoneMapRange *rb = (const AOZoneMapRange *) b;
+
+	if (ra->firstRowNum < rb->firstRowNum)
+		return -1;
+	if (ra->firstRowNum > rb->firstRowNum)
+		return 1;
+	return 0;
+}
+
+static int
+zonemap_entry_cmp(const void *a, const void *b)
+{
+	const AOZoneMapEntry *ea = (const AOZoneMapEntry *) a;
+	const AOZoneMapEntry *eb = (const AOZoneMapEntry *) b;
+
+	if (ea->fileOffset < eb->fileOffset)
+		return -1;
+	if (ea->fileOffset > eb->fileOffset)
+		return 1;
+	return 0;
+}
+
+/*
+ * AOZoneMap_LoadSegmentFile
+ *
+ * Read the block directory rows of segment file 'segno' for the column
+ * groups the keys refer to, and work out which blocks cannot match.
+ * Returns true if at least one block can be skipped.
+ */
+bool
+AOZoneMap_LoadSegmentFile(AOZoneMapScanState *state, Snapshot snapshot,
+						  int segno)
+{
+	Relation	blkdirRel;
+	Relation	blkdirIdx;
+	TupleDesc	blkdirTupDesc;
+	int			groupIdx;
+	int			i,
+				n;
+
+	MemoryContextReset(state->segcxt);
+	state->entries = NULL;
+	state->nentries = state->maxentries = 0;
+	state->ranges = NULL;
+	state->nranges = state->maxranges = 0;
+
+	blkdirRel = table_open(state->blkdirrelid, AccessShareLock);
+	blkdirIdx = index_open(state->blkdiridxid, AccessShareLock);
+	blkdirTupDesc = RelationGetDescr(blkdirRel);
+
+	for (groupIdx = 0; groupIdx < state->ngroups; groupIdx++)
+	{
+		ScanKeyData scanKeys[2];
+		SysScanDesc idxScanDesc;
+		HeapTuple	tuple;
+
+		ScanKeyInit(&scanKeys[0],
+					1,			/* segno */
+					BTEqualStrategyNumber,
+					F_INT4EQ,
+					Int32GetDatum(segno));
+		ScanKeyInit(&scanKeys[1],
+					2,			/* columngroup_no */
+					BTEqualStrategyNumber,
+					F_INT4EQ,
+					Int32GetDatum(state->groups[groupIdx].columnGroupNo));
+
+		idxScanDesc = systable_beginscan_ordered(blkdirRel, blkdirIdx,
+												 snapshot, 2, scanKeys);
+
+		while ((tuple = systable_getnext_ordered(idxScanDesc, ForwardScanDirection)) != NULL)
+		{
+			struct varlena *value;
+			struct varlena *detoasted;
+			bool		isnull;
+
+			value = (struct varlena *)
+				DatumGetPointer(heap_getattr(tuple, Anum_pg_aoblkdir_minipage,
+											 blkdirTupDesc, &isnull));
+			if (isnull)
+				continue;
+
+			detoasted = pg_detoast_datum(value);
+			zonemap_load_minipage(state, groupIdx, detoasted);
+			if (detoasted != value)
+				pfree(detoasted);
+		}
+
+		systable_endscan_ordered(idxScanDesc);
+	}
+
+	index_close(blkdirIdx, AccessShareLock);
+	table_close(blkdirRel, AccessShareLock);
+
+	if (state->nentries > 1)
+		qsort(state->entries, state->nentries, sizeof(AOZoneMapEntry),
+			  zonemap_entry_cmp);
+
+	/* Merge overlapping and adjacent ranges */
+	if (state->nranges > 1)
+	{
+		qsort(state->ranges, state->nranges, sizeof(AOZoneMapRange),
+			  zonemap_range_cmp);
+
+		n = 0;
+		for (i = 1; i < state->nranges; i++)
+		{
+			if (state->ranges[i].firstRowNum <= state->ranges[n].endRowNum)
+				state->ranges[n].endRowNum = Max(state->ranges[n].endRowNum,
+												 state->ranges[i].endRowNum);
+			else
+				state->ranges[++n] = state->ranges[i];
+		}
+		state->nranges = n + 1;
+	}
+
+	return state->nranges > 0;
+}
+
+/*
+ * Return the skippable range starting at or before rowNum with the largest
+ * start, or NULL.
+ */
+static AOZoneMapRange *
+zonemap_find_range(AOZoneMapScanState *state, int64 rowNum)
+{
+	int			low = 0;
+	int			high = state->nranges - 1;
+	AOZoneMapRange *result = NULL;
+
+	while (low <= high)
+	{
+		int			mid = low + (high - low) / 2;
+
+		if (state->ranges[mid].firstRowNum <= rowNum)
+		{
+			result = &state->ranges[mid];
+			low = mid + 1;
+		}
+		else
+			high = mid - 1;
+	}
+
+	return result;
+}
+
+/*
+ * AOZoneMap_CanSkipBlock
+ *
+ * Can the AO row block at fileOffset be skipped?  The block must match a
+ * block directory entry exactly, otherwise it is read.
+ */
+bool
+AOZoneMap_CanSkipBlock(AOZoneMapScanState *state, int64 fileOffset,
+					   int64 firstRowNum, int64 rowCount)
+{
+	int			low = 0;
+	int			high = state->nentries - 1;
+
+	while (low <= high)
+	{
+		int			mid = low + (high - low) / 2;
+		AOZoneMapEntry *entry = &state->entries[mid];
+
+		if (entry->fileOffset == fileOffset)
+			return entry->skip &&
+				entry->firstRowNum == firstRowNum &&
+				entry->rowCount == rowCount;
+		else if (entry->fileOffset < fileOffset)
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+
+	return false;
+}
+
+/*
+ * AOZoneMap_CanSkipRows
+ *
+ * Are all rows in [firstRowNum, firstRowNum + rowCount) known not to match?
+ */
+bool
+AOZoneMap_CanSkipRows(AOZoneMapScanState *state, int64 firstRowNum,
+					  int64 rowCount)
+{
+	AOZoneMapRange *range = zonemap_find_range(state, firstRowNum);
+
+	return range != NULL && firstRowNum + rowCount <= range->endRowNum;
+}
+
+/*
+ * AOZoneMap_NextCandidateRow
+ *
+ * Return the first row number >= rowNum that may match the quals.
+ */
+int64
+AOZoneMap_NextCandidateRow(AOZoneMapScanState *state, int64 rowNum)
+{
+	AOZoneMapRange *range = zonemap_find_range(state, rowNum);
+
+	if (range != NULL && rowNum < range->endRowNum)
+		return range->endRowNum;
+
+	return rowNum;
+}
+
+/*
+ * AOZoneMap_CountBlock
+ *
+ * Account a block the scan came across, for EXPLAIN ANALYZE.
+ */
+void
+AOZoneMap_CountBlock(AOZoneMapScanState *state, bool skipped)
+{
+	state->blocksChecked++;
+	if (skipped)
+		state->blocksSkipped++;
+}
+
+/*
+ * AOZoneMap_ExplainScan
+ *
+ * Append the zone map statistics of the scan to buf.
+ */
+void
+AOZoneMap_ExplainScan(AOZoneMapScanState *state, StringInfo buf)
+{
+	appendStringInfo(buf, "Zone map skipped " INT64_FORMAT " of " INT64_FORMAT " blocks",
+					 state->blocksSkipped, state->blocksChecked);
+}
@@ -38,6 +38,7 @@
 
 #include "access/amapi.h"
 #include "access/aosegfiles.h"
+#include "access/appendonly_zonemap.h"
 #include "access/appendonlytid.h"
 #include "access/appendonlywriter.h"
 #include "access/aomd.h"
@@ -196,6 +197,8 @@ SetNextFileSegForRead(AppendOnlyScanDesc scan)
 			sa.comptype = scan->storageAttributes.compressType;
 			sa.complevel = scan->storageAttributes.compressLevel;
 			sa.blocksize = scan->usableBlockSize;
+			sa.relid = InvalidOid;
+			sa.attnum = InvalidAttrNumber;
 
 			/*
 			 * The relation's tuple descriptor allows the compression
@@ -265,9 +268,20 @@ SetNextFileSegForRead(AppendOnlyScanDesc scan)
 														scan->aos_rd,
 														segno,	/* segno */
 														1,	/* columnGroupNo */
+														false,
 														false);
 			}
 
+			/*
+			 * Load the zone map of the segment file, unless this scan builds
+			 * the block directory itself.
+			 */
+			if (scan->aos_zonemap)
+				scan->aos_zonemap_active = !scan->blockDirectory &&
+					AOZoneMap_LoadSegmentFile(scan->aos_zonemap,
+											  scan->appendOnlyMetaDataSnapshot,
+											  segno);
+
 			finished_all_files = false;
 			break;
 		}
@@ -1220,19 +1234,44 @@ getNextBlock(AppendOnlyScanDesc scan)
 			return false;
 	}
 
-	if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
-												  &scan->storageRead,
-												  &scan->executorReadBlock))
+	for (;;)
 	{
-		if (scan->blockDirectory)
+		if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
+													  &scan->storageRead,
+													  &scan->executorReadBlock))
 		{
-			AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			if (scan->blockDirectory)
+			{
+				AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			}
+
+			/* done reading the file */
+			CloseScannedFileSeg(scan);
+
+			return false;
 		}
 
-		/* done reading the file */
-		CloseScannedFileSeg(scan);
+		if (!scan->aos_zonemap_active)
+			break;
 
-		return false;
+		/*
+		 * Skip the whole block without reading its content if the zone map
+		 * proves that none of its rows can satisfy the scan quals.
+		 */
+		if (!scan->executorReadBlock.isLarge &&
+			AOZoneMap_CanSkipBlock(scan->aos_zonemap,
+								   scan->executorReadBlock.headerOffsetInFile,
+								   scan->executorReadBlock.blockFirstRowNum,
+								   scan->executorReadBlock.rowCount))
+		{
+			AOZoneMap_CountBlock(scan->aos_zonemap, true);
+			AppendOnlyExecutionReadBlock_FinishedScanBlock(&scan->executorReadBlock);
+			AppendOnlyStorageRead_SkipCurrentBlock(&scan->storageRead);
+			continue;
+		}
+
+		AOZoneMap_CountBlock(scan->aos_zonemap, false);
+		break;
 	}
 
 	if (scan->blockDirectory)
@@ -2221,6 +2260,8 @@ appendonly_fetch_init(Relation relation,
 		sa.comptype = NameStr(aoFormData.compresstype);
 		sa.complevel = aoFormData.compresslevel;
 		sa.blocksize = aoFormData.blocksize;
+		sa.relid = InvalidOid;
+		sa.attnum = InvalidAttrNumber;
 
 
 		cs = callCompressionConstructor(cons, RelationGetDescr(relation),
@@ -2707,6 +2748,8 @@ appendonly_insert_init(Relation rel, int segno)
 		sa.comptype = NameStr(compresstype);
 		sa.complevel = compresslevel;
 		sa.blocksize = blocksize;
+		sa.relid = InvalidOid;
+		sa.attnum = InvalidAttrNumber;
 
 		cs = callCompressionConstructor(cons, RelationGetDescr(rel),
 										&sa,
@@ -2820,7 +2863,8 @@ appendonly_insert_init(Relation rel, int segno)
 											&(aoInsertDesc->blockDirectory),
 aoInsertDesc->appendOnlyMetaDataSnapshot, //CONCERN:Safe to assume all block directory entries for segment are "covered" by same exclusive lock.
 											aoInsertDesc->fsInfo, aoInsertDesc->lastSequence,
-											rel, segno, 1, false);
+											rel, segno, 1, false,
+											gp_appendonly_zonemap);
 
 	/* Should not enable insertMultiFiles if the table is created by own transaction or in utility mode */
 	if (Gp_role != GP_ROLE_UTILITY)
@@ -2854,6 +2898,7 @@ appendonly_insert(AppendOnlyInsertDesc aoInsertDesc,
 	MemTuple	tup = NULL;
 	bool		need_toast;
 	bool		isLargeContent;
+	AOZoneMapGroup *zonemap;
 
 	Assert(aoInsertDesc->usableBlockSize > 0 && aoInsertDesc->tempSpaceLen > 0);
 	Assert(aoInsertDesc->toast_tuple_threshold > 0 && aoInsertDesc->toast_tuple_target > 0);
@@ -2989,6 +3034,19 @@ appendonly_insert(AppendOnlyInsertDesc aoInsertDesc,
 
 		if (itemLen > 0)
 			memcpy(itemPtr, tup, itemLen);
+
+		zonemap = AppendOnlyBlockDirectory_GetZoneMap(&aoInsertDesc->blockDirectory, 0);
+		if (zonemap)
+		{
+			Datum		values[AO_ZONEMAP_MAX_ATTS];
+			bool		isnull[AO_ZONEMAP_MAX_ATTS];
+			int			i;
+
+			for (i = 0; i < zonemap->nAtts; i++)
+				values[i] = memtuple_getattr(instup, aoInsertDesc->mt_bind,
+											 zonemap->attnums[i], &isnull[i]);
+			AOZoneMap_AddValues(zonemap, values, isnull);
+		}
 	}
 	else
 	{
@@ -301,7 +301,8 @@ AppendOnlyBlockDirectory_Init_forInsert(
 										Relation aoRel,
 										int segno,
 										int numColumnGroups,
-										bool isAOCol)
+										bool isAOCol,
+										bool buildZoneMaps)
 {
 	int			groupNo;
 	Oid blkdirrelid;
@@ -344,6 +345,21 @@ AppendOnlyBlockDirectory_Init_forInsert(
 
 	init_internal(blockDirectory);
 
+	/*
+	 * Set up the zone maps before loading the last minipages, so that the
+	 * summaries already stored in them are kept.
+	 */
+	if (buildZoneMaps)
+	{
+		MemoryContext oldcxt;
+
+		oldcxt = MemoryContextSwitchTo(blockDirectory->memoryContext);
+		for (groupNo = 0; groupNo < blockDirectory->numColumnGroups; groupNo++)
+			blockDirectory->minipages[groupNo].zonemap =
+				AOZoneMap_CreateGroup(aoRel, groupNo, isAOCol);
+		MemoryContextSwitchTo(oldcxt);
+	}
+
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
 			  (errmsg("Append-only block directory init for insert: "
 					  "(segno, numColumnGroups, isAOCol, lastSequence)="
@@ -929,8 +945,23 @@ AppendOnlyBlockDirectory_InsertEntry(
 									 int64 rowCount,
 									 bool addColAction)
 {
-	return insert_new_entry(blockDirectory, columnGroupNo, firstRowNum,
-							fileOffset, rowCount, addColAction);
+	MinipagePerColumnGroup *minipageInfo;
+
+	if (!insert_new_entry(blockDirectory, columnGroupNo, firstRowNum,
+						  fileOffset, rowCount, addColAction))
+		return false;
+
+	/* Attach the summaries of the rows just written to the new entry */
+	if (!addColAction)
+	{
+		minipageInfo = &blockDirectory->minipages[columnGroupNo];
+		if (minipageInfo->zonemap)
+			AOZoneMap_FinishEntry(minipageInfo->zonemap,
+								  minipageInfo->numMinipageEntries - 1,
+								  rowCount);
+	}
+
+	return true;
 }
 
 /*
@@ -1008,6 +1039,10 @@ insert_new_entry(
 	entry->fileOffset = fileOffset;
 	entry->rowCount = rowCount;
 
+	if (minipageInfo->zonemap)
+		AOZoneMap_ResetEntry(minipageInfo->zonemap,
+							 minipageInfo->numMinipageEntries);
+
 	minipageInfo->numMinipageEntries++;
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -1165,6 +1200,28 @@ extract_minipage(AppendOnlyBlockDirectory *blockDirectory,
 					  values[Anum_pg_aoblkdir_minipage - 1],
 					  nulls[Anum_pg_aoblkdir_minipage - 1]);
 
+	/* Pick up the zone map summaries of the entries, if any */
+	if (minipageInfo->zonemap)
+	{
+		struct varlena *value;
+		struct varlena *detoast_value;
+		uint32		nEntry = minipageInfo->numMinipageEntries;
+		Size		len = 0;
+
+		value = (struct varlena *)
+			DatumGetPointer(values[Anum_pg_aoblkdir_minipage - 1]);
+		detoast_value = pg_detoast_datum(value);
+
+		if (minipageInfo->minipage->version == MINIPAGE_VERSION_ZONEMAP)
+			len = VARSIZE(detoast_value) - minipage_size(nEntry);
+
+		AOZoneMap_ReadTrailer(minipageInfo->zonemap, nEntry,
+							  (char *) detoast_value + minipage_size(nEntry),
+							  len);
+		if (detoast_value != value)
+			pfree(detoast_value);
+	}
+
 	ItemPointerCopy(&tuple->t_self, &minipageInfo->tupleTid);
 }
 
@@ -1307,6 +1364,8 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 	Relation	blkdirRel = blockDirectory->blkdirRel;
 	CatalogIndexState indinfo = blockDirectory->indinfo;
 	TupleDesc	heapTupleDesc = RelationGetDescr(blkdirRel);
+	Minipage   *minipage;
+	Size		trailerSize;
 
 	Assert(minipageInfo->numMinipageEntries > 0);
 
@@ -1329,8 +1388,30 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 	SET_VARSIZE(minipageInfo->minipage,
 				minipage_size(minipageInfo->numMinipageEntries));
 	minipageInfo->minipage->nEntry = minipageInfo->numMinipageEntries;
-	values[Anum_pg_aoblkdir_minipage - 1] =
-		PointerGetDatum(minipageInfo->minipage);
+	minipageInfo->minipage->version = MINIPAGE_VERSION_ORIGINAL;
+
+	/*
+	 * Append the zone map trailer, if the column group has one and the
+	 * minipage is small enough to carry it.
+	 */
+	trailerSize = AOZoneMap_TrailerSize(minipageInfo->zonemap,
+										minipageInfo->numMinipageEntries);
+	if (trailerSize > 0)
+	{
+		Size		entriesSize = minipage_size(minipageInfo->numMinipageEntries);
+
+		minipage = palloc(entriesSize + trailerSize);
+		memcpy(minipage, minipageInfo->minipage, entriesSize);
+		SET_VARSIZE(minipage, entriesSize + trailerSize);
+		minipage->version = MINIPAGE_VERSION_ZONEMAP;
+		AOZoneMap_WriteTrailer(minipageInfo->zonemap,
+							   minipageInfo->numMinipageEntries,
+							   (char *) minipage + entriesSize);
+	}
+	else
+		minipage = minipageInfo->minipage;
+
+	values[Anum_pg_aoblkdir_minipage - 1] = PointerGetDatum(minipage);
 	nulls[Anum_pg_aoblkdir_minipage - 1] = false;
 
 	tuple = heaptuple_form_to(heapTupleDesc,
@@ -1339,6 +1420,9 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 							  NULL,
 							  NULL);
 
+	if (minipage != minipageInfo->minipage)
+		pfree(minipage);
+
 	/*
 	 * Write out the minipage to the block directory relation. If this
 	 * minipage is already in the relation, we update the row. Otherwise, a
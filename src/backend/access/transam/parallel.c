@@ -28,6 +28,7 @@
 #include "cdb/cdbutil.h"
 #include "cdb/cdbvars.h"
 #include "commands/async.h"
+#include "commands/copy.h"
 #include "executor/execParallel.h"
 #include "executor/executor.h"
 #include "executor/hashjoin.h"
@@ -180,6 +181,9 @@ static const struct
 	},
 	{
 		"parallel_vacuum_main", parallel_vacuum_main
+	},
+	{
+		"CopyFromParallelMain", CopyFromParallelMain
 	}
 };
 
@@ -0,0 +1,322 @@
+/*-------------------------------------------------------------------------
+ *
+ * gp_zstd_dictionary.c
+ *	  routines to support manipulation of the gp_zstd_dictionary relation
+ *
+ * The dictionaries are looked up with SnapshotSelf. A block compressed with
+ * a dictionary is visible only once the transaction that trained the
+ * dictionary has committed, or within that transaction, possibly in the
+ * same command, e.g. to verify the blocks written.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/catalog/gp_zstd_dictionary.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/genam.h"
+#include "access/htup_details.h"
+#include "access/table.h"
+#include "catalog/indexing.h"
+#include "catalog/gp_zstd_dictionary.h"
+#include "utils/fmgroids.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+
+#include "catalog/gp_indexing.h"
+
+static bytea *
+zstd_dictionary_copy(Relation rel, HeapTuple tuple)
+{
+	Datum		datum;
+	bool		isnull;
+
+	datum = heap_getattr(tuple, Anum_gp_zstd_dictionary_dictionary,
+						 RelationGetDescr(rel), &isnull);
+	Assert(!isnull);
+
+	return DatumGetByteaPCopy(datum);
+}
+
+/*
+ * GetZstdDictionary
+ *
+ * Return a copy of the dictionary with the given zstd dictionary ID of a
+ * column, or NULL if there is none.
+ */
+bytea *
+GetZstdDictionary(Oid relid, AttrNumber attnum, int32 dictid)
+{
+	Relation	rel;
+	ScanKeyData key[3];
+	SysScanDesc scan;
+	HeapTuple	tuple;
+	bytea	   *dict = NULL;
+
+	rel = table_open(ZstdDictionaryRelationId, AccessShareLock);
+	ScanKeyInit(&key[0],
+				Anum_gp_zstd_dictionary_relid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(relid));
+	ScanKeyInit(&key[1],
+				Anum_gp_zstd_dictionary_attnum,
+				BTEqualStrategyNumber, F_INT2EQ,
+				Int16GetDatum(attnum));
+	ScanKeyInit(&key[2],
+				Anum_gp_zstd_dictionary_dictid,
+				BTEqualStrategyNumber, F_INT4EQ,
+				Int32GetDatum(dictid));
+
+	scan = systable_beginscan(rel, ZstdDictionaryRelidAttnumDictidIndexId,
+							  true, SnapshotSelf, 3, key);
+
+	tuple = systable_getnext(scan);
+	if (HeapTupleIsValid(tuple))
+		dict = zstd_dictionary_copy(rel, tuple);
+
+	systable_endscan(scan);
+	table_close(rel, AccessShareLock);
+
+	return dict;
+}
+
+/*
+ * GetLatestZstdDictionary
+ *
+ * Return a copy of the dictionary of the highest version of a column, or
+ * NULL if the column has no dictionary.
+ */
+bytea *
+GetLatestZstdDictionary(Oid relid, AttrNumber attnum)
+{
+	Relation	rel;
+	ScanKeyData key[2];
+	SysScanDesc scan;
+	HeapTuple	tuple;
+	HeapTuple	latest = NULL;
+	int32		latestVersion = 0;
+	bytea	   *dict = NULL;
+
+	rel = table_open(ZstdDictionaryRelationId, AccessShareLock);
+	ScanKeyInit(&key[0],
+				Anum_gp_zstd_dictionary_relid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(relid));
+	ScanKeyInit(&key[1],
+				Anum_gp_zstd_dictionary_attnum,
+				BTEqualStrategyNumber, F_INT2EQ,
+				Int16GetDatum(attnum));
+
+	scan = systable_beginscan(rel, ZstdDictionaryRelidAttnumDictidIndexId,
+							  true, SnapshotSelf, 2, key);
+
+	while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+	{
+		Form_gp_zstd_dictionary form = (Form_gp_zstd_dictionary) GETSTRUCT(tuple);
+
+		if (latest == NULL || form->version > latestVersion)
+		{
+			if (latest)
+				heap_freetuple(latest);
+			latest = heap_copytuple(tuple);
+			latestVersion = form->version;
+		}
+	}
+
+	if (latest)
+	{
+		dict = zstd_dictionary_copy(rel, latest);
+		heap_freetuple(latest);
+	}
+
+	systable_endscan(scan);
+	table_close(rel, AccessShareLock);
+
+	return dict;
+}
+
+/*
+ * StoreZstdDictionary
+ *
+ * Add a dictionary to a column, as its new highest version. Nothing is done
+ * if the column already has a dictionary with the same ID.
+ */
+void
+StoreZstdDictionary(Oid relid, AttrNumber attnum, int32 dictid,
+					const char *dict, Size len)
+{
+	Relation	rel;
+	ScanKeyData key[2];
+	SysScanDesc scan;
+	HeapTuple	tuple;
+	int32		version = 0;
+	bytea	   *dictValue;
+	Datum		values[Natts_gp_zstd_dictionary];
+	bool		nulls[Natts_gp_zstd_dictionary];
+
+	rel = table_open(ZstdDictionaryRelationId, RowExclusiveLock);
+	ScanKeyInit(&key[0],
+				Anum_gp_zstd_dictionary_relid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(relid));
+	ScanKeyInit(&key[1],
+				Anum_gp_zstd_dictionary_attnum,
+				BTEqualStrategyNumber, F_INT2EQ,
+				Int16GetDatum(attnum));
+
+	scan = systable_beginscan(rel, ZstdDictionaryRelidAttnumDictidIndexId,
+							  true, SnapshotSelf, 2, key);
+
+	while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+	{
+		Form_gp_zstd_dictionary form = (Form_gp_zstd_dictionary) GETSTRUCT(tuple);
+
+		if (form->dictid == dictid)
+			break;
+		version = Max(version, form->version);
+	}
+
+	if (HeapTupleIsValid(tuple))
+	{
+		/* Dictionary IDs are random, a duplicate is very unlikely */
+		systable_endscan(scan);
+		table_close(rel, RowExclusiveLock);
+		return;
+	}
+	systable_endscan(scan);
+
+	dictValue = (bytea *) palloc(VARHDRSZ + len);
+	SET_VARSIZE(dictValue, VARHDRSZ + len);
+	memcpy(VARDATA(dictValue), dict, len);
+
+	memset(nulls, 0, sizeof(nulls));
+	values[Anum_gp_zstd_dictionary_relid - 1] = ObjectIdGetDatum(relid);
+	values[Anum_gp_zstd_dictionary_attnum - 1] = Int16GetDatum(attnum);
+	values[Anum_gp_zstd_dictionary_dictid - 1] = Int32GetDatum(dictid);
+	values[Anum_gp_zstd_dictionary_version - 1] = Int32GetDatum(version + 1);
+	values[Anum_gp_zstd_dictionary_dictionary - 1] = PointerGetDatum(dictValue);
+
+	tuple = heap_form_tuple(RelationGetDescr(rel), values, nulls);
+	CatalogTupleInsert(rel, tuple);
+	heap_freetuple(tuple);
+	pfree(dictValue);
+
+	table_close(rel, RowExclusiveLock);
+}
+
+/*
+ * RemoveZstdDictionaries
+ *
+ * Remove all the dictionaries of a relation.
+ */
+void
+RemoveZstdDictionaries(Oid relid)
+{
+	Relation	rel;
+	ScanKeyData key;
+	SysScanDesc scan;
+	HeapTuple	tuple;
+
+	rel = table_open(ZstdDictionaryRelationId, RowExclusiveLock);
+	ScanKeyInit(&key,
+				Anum_gp_zstd_dictionary_relid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(relid));
+	scan = systable_beginscan(rel, ZstdDictionaryRelidAttnumDictidIndexId,
+							  true, NULL, 1, &key);
+
+	while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+		CatalogTupleDelete(rel, &tuple->t_self);
+
+	systable_endscan(scan);
+	table_close(rel, RowExclusiveLock);
+}
+
+/*
+ * SwapZstdDictionaries
+ *
+ * Swap the dictionaries of two relations, along with their data files, when
+ * a table is rewritten (VACUUM FULL, CLUSTER, or a rewriting ALTER TABLE).
+ * The blocks of the new data files were compressed with the dictionaries of
+ * the transient table, which is dropped afterwards.
+ */
+void
+SwapZstdDictionaries(Oid relid1, Oid relid2)
+{
+	Relation	rel;
+	TupleDesc	desc;
+	ScanKeyData key;
+	SysScanDesc scan;
+	HeapTuple	tuple;
+	List	   *tuples1 = NIL;
+	List	   *tuples2 = NIL;
+	ListCell   *lc;
+	Datum		newValues[Natts_gp_zstd_dictionary];
+	bool		newNulls[Natts_gp_zstd_dictionary];
+	bool		replace[Natts_gp_zstd_dictionary];
+
+	rel = table_open(ZstdDictionaryRelationId, RowExclusiveLock);
+	desc = RelationGetDescr(rel);
+
+	/* Delete the entries of both relations first, then reinsert them */
+	for (int i = 0; i < 2; i++)
+	{
+		Oid			relid = (i == 0) ? relid1 : relid2;
+
+		ScanKeyInit(&key,
+					Anum_gp_zstd_dictionary_relid,
+					BTEqualStrategyNumber, F_OIDEQ,
+					ObjectIdGetDatum(relid));
+		scan = systable_beginscan(rel, ZstdDictionaryRelidAttnumDictidIndexId,
+								  true, NULL, 1, &key);
+
+		while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+		{
+			if (i == 0)
+				tuples1 = lappend(tuples1, heap_copytuple(tuple));
+			else
+				tuples2 = lappend(tuples2, heap_copytuple(tuple));
+			CatalogTupleDelete(rel, &tuple->t_self);
+		}
+
+		systable_endscan(scan);
+	}
+
+	if (tuples1 == NIL && tuples2 == NIL)
+	{
+		table_close(rel, RowExclusiveLock);
+		return;
+	}
+
+	memset(newValues, 0, sizeof(newValues));
+	memset(newNulls, 0, sizeof(newNulls));
+	memset(replace, 0, sizeof(replace));
+	replace[Anum_gp_zstd_dictionary_relid - 1] = true;
+
+	newValues[Anum_gp_zstd_dictionary_relid - 1] = ObjectIdGetDatum(relid2);
+	foreach(lc, tuples1)
+	{
+		tuple = heap_modify_tuple((HeapTuple) lfirst(lc), desc,
+								  newValues, newNulls, replace);
+		CatalogTupleInsert(rel, tuple);
+		heap_freetuple(tuple);
+	}
+
+	newValues[Anum_gp_zstd_dictionary_relid - 1] = ObjectIdGetDatum(relid1);
+	foreach(lc, tuples2)
+	{
+		tuple = heap_modify_tuple((HeapTuple) lfirst(lc), desc,
+								  newValues, newNulls, replace);
+		CatalogTupleInsert(rel, tuple);
+		heap_freetuple(tuple);
+	}
+
+	list_free_deep(tuples1);
+	list_free_deep(tuples2);
+
+	table_close(rel, RowExclusiveLock);
+}
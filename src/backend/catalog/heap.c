@@ -102,6 +102,7 @@
 #include "catalog/pg_stat_last_operation.h"
 #include "catalog/pg_stat_last_shoperation.h"
 #include "catalog/gp_partition_template.h"
+#include "catalog/gp_zstd_dictionary.h"
 #include "cdb/cdbsreh.h"
 #include "cdb/cdbvars.h"
 #include "foreign/foreign.h"
@@ -2482,6 +2483,7 @@ heap_drop_with_catalog(Oid relid)
 		rel->rd_rel->relkind == RELKIND_PARTITIONED_TABLE)
 	{
 		RemoveAttributeEncodingsByRelid(relid);
+		RemoveZstdDictionaries(relid);
 	}
 
 	/*
@@ -232,6 +232,8 @@ callCompressionValidator(PGFunction func, char *comptype, int32 complevel,
 	sa.complevel = complevel;
 	sa.blocksize = blocksize;
 	sa.typid = typid;
+	sa.relid = InvalidOid;
+	sa.attnum = InvalidAttrNumber;
 	(void)DirectFunctionCall1(func, PointerGetDatum(&sa));
 }
 
@@ -1490,6 +1490,9 @@ LANGUAGE SQL EXECUTE ON COORDINATOR;
 
 COMMENT ON FUNCTION pg_catalog.gp_session_endpoints() IS 'All endpoints in this session that are visible to the current user.';
 
+CREATE VIEW gp_cardinality_feedback AS
+    SELECT * FROM pg_catalog.gp_cardinality_feedback();
+
 CREATE VIEW pg_stat_bgwriter AS
     SELECT
         pg_stat_get_bgwriter_timed_checkpoints() AS checkpoints_timed,
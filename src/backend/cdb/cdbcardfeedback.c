@@ -0,0 +1,415 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbcardfeedback.c
+ *	  Actual row counts of executed plans, fed back to ORCA.
+ *
+ * With optimizer_enable_cardinality_feedback, ORCA annotates the nodes of
+ * its plans with a fingerprint of the logical expression each of them
+ * computes (Plan.feedback_key).  After an instrumented execution, that is
+ * EXPLAIN ANALYZE or auto_explain with analyze, the actual number of rows
+ * of every annotated node, summed over all the processes that ran it, is
+ * remembered in a shared hash table under the fingerprint.  When ORCA later
+ * derives the statistics of an expression with the same fingerprint, it
+ * scales them to the remembered row count.
+ *
+ * A row count is only trusted if every process ran the node exactly once,
+ * and the node was not below a Limit, which may have stopped it early.
+ *
+ * The table holds at most CARD_FEEDBACK_MAX_ENTRIES entries; the least
+ * recently updated one makes room for a new one.  An entry is thrown away
+ * when any of the relations scanned below its node is analyzed.  The
+ * gp_cardinality_feedback view shows the entries of the table.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/cdbcardfeedback.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbcardfeedback.h"
+#include "cdb/cdbexplain.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
+#include "parser/parsetree.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/timestamp.h"
+
+/* maximum number of remembered row counts */
+#define CARD_FEEDBACK_MAX_ENTRIES	4096
+
+/* maximum number of relations below a node */
+#define CARD_FEEDBACK_MAX_RELS		8
+
+typedef struct CardFeedbackEntry
+{
+	uint64		key;			/* hash key of entry - MUST BE FIRST */
+	double		rows;			/* actual rows */
+	double		est_rows;		/* rows estimated by the plan */
+	int64		executions;		/* number of times the rows were observed */
+	TimestampTz last_updated;
+	int			nrelids;
+	Oid			relids[CARD_FEEDBACK_MAX_RELS];	/* relations scanned */
+} CardFeedbackEntry;
+
+/* actual rows of a node of an executed plan */
+typedef struct CardFeedbackObservation
+{
+	uint64		key;
+	double		rows;
+	double		est_rows;
+	List	   *relids;
+} CardFeedbackObservation;
+
+typedef struct CardFeedbackContext
+{
+	PlannedStmt *stmt;
+	List	   *relids;			/* relations scanned below the current node */
+	bool		below_limit;
+	List	   *observations;	/* CardFeedbackObservations of the plan */
+} CardFeedbackContext;
+
+static HTAB *CardFeedbackHash = NULL;
+
+Size
+CardFeedbackShmemSize(void)
+{
+	return hash_estimate_size(CARD_FEEDBACK_MAX_ENTRIES,
+							  sizeof(CardFeedbackEntry));
+}
+
+void
+CardFeedbackShmemInit(void)
+{
+	HASHCTL		info;
+
+	info.keysize = sizeof(uint64);
+	info.entrysize = sizeof(CardFeedbackEntry);
+
+	CardFeedbackHash = ShmemInitHash("Cardinality feedback",
+									 CARD_FEEDBACK_MAX_ENTRIES,
+									 CARD_FEEDBACK_MAX_ENTRIES,
+									 &info,
+									 HASH_ELEM | HASH_BLOBS);
+}
+
+/*
+ * Remember the rows of a node.  Caller holds CardFeedbackLock exclusively.
+ */
+static void
+card_feedback_store(uint64 key, double rows, double est_rows, List *relids)
+{
+	CardFeedbackEntry *entry;
+	bool		found;
+	ListCell   *lc;
+
+	entry = hash_search(CardFeedbackHash, &key, HASH_FIND, NULL);
+	if (entry == NULL &&
+		hash_get_num_entries(CardFeedbackHash) >= CARD_FEEDBACK_MAX_ENTRIES)
+	{
+		HASH_SEQ_STATUS status;
+		CardFeedbackEntry *e;
+		CardFeedbackEntry *oldest = NULL;
+
+		hash_seq_init(&status, CardFeedbackHash);
+		while ((e = hash_seq_search(&status)) != NULL)
+		{
+			if (oldest == NULL || e->last_updated < oldest->last_updated)
+				oldest = e;
+		}
+		hash_search(CardFeedbackHash, &oldest->key, HASH_REMOVE, NULL);
+	}
+
+	entry = hash_search(CardFeedbackHash, &key, HASH_ENTER, &found);
+	if (!found)
+		entry->executions = 0;
+	entry->rows = rows;
+	entry->est_rows = est_rows;
+	entry->executions++;
+	entry->last_updated = GetCurrentTimestamp();
+	entry->nrelids = 0;
+	foreach(lc, relids)
+		entry->relids[entry->nrelids++] = lfirst_oid(lc);
+}
+
+/*
+ * Add the rows of a node to the observations of the plan.  The nodes of a
+ * plan are visited bottom up, so where several nodes compute the same
+ * expression, like a Gather Motion and the scan below it, the topmost one
+ * replaces the others.
+ */
+static void
+card_feedback_observe(CardFeedbackContext *ctx, uint64 key, double rows,
+					  double est_rows, List *relids)
+{
+	CardFeedbackObservation *obs = NULL;
+	ListCell   *lc;
+
+	foreach(lc, ctx->observations)
+	{
+		CardFeedbackObservation *o = (CardFeedbackObservation *) lfirst(lc);
+
+		if (o->key == key)
+		{
+			obs = o;
+			break;
+		}
+	}
+
+	if (obs == NULL)
+	{
+		obs = palloc(sizeof(CardFeedbackObservation));
+		obs->key = key;
+		ctx->observations = lappend(ctx->observations, obs);
+	}
+	obs->rows = rows;
+	obs->est_rows = est_rows;
+	obs->relids = list_copy(relids);
+}
+
+static bool
+card_feedback_walker(PlanState *planstate, CardFeedbackContext *ctx)
+{
+	Plan	   *plan = planstate->plan;
+	List	   *outer_relids = ctx->relids;
+	bool		outer_below_limit = ctx->below_limit;
+	Index		scanrelid = 0;
+	double		rows;
+	int			nworkers;
+
+	switch (nodeTag(plan))
+	{
+		case T_SeqScan:
+		case T_SampleScan:
+		case T_IndexScan:
+		case T_IndexOnlyScan:
+		case T_BitmapHeapScan:
+		case T_TidScan:
+		case T_TidRangeScan:
+		case T_ForeignScan:
+			scanrelid = ((Scan *) plan)->scanrelid;
+			break;
+		case T_Limit:
+			ctx->below_limit = true;
+			break;
+		default:
+			break;
+	}
+
+	ctx->relids = NIL;
+	if (scanrelid > 0)
+	{
+		RangeTblEntry *rte = rt_fetch(scanrelid, ctx->stmt->rtable);
+
+		if (rte->rtekind == RTE_RELATION)
+			ctx->relids = list_make1_oid(rte->relid);
+	}
+
+	planstate_tree_walker(planstate, card_feedback_walker, ctx);
+
+	if (plan->feedback_key != 0 && !ctx->below_limit &&
+		ctx->relids != NIL &&
+		list_length(ctx->relids) <= CARD_FEEDBACK_MAX_RELS &&
+		cdbexplain_getTotalRows(planstate, &rows, &nworkers))
+	{
+		card_feedback_observe(ctx, plan->feedback_key, rows,
+							  plan->plan_rows * nworkers, ctx->relids);
+	}
+
+	ctx->relids = list_concat_unique_oid(outer_relids, ctx->relids);
+	ctx->below_limit = outer_below_limit;
+
+	return false;
+}
+
+/*
+ * CardFeedbackRecordPlan
+ *
+ * Remember the actual rows of the annotated nodes of an executed plan,
+ * once the statistics of the executors have been collected.
+ */
+void
+CardFeedbackRecordPlan(QueryDesc *queryDesc)
+{
+	CardFeedbackContext ctx;
+	ListCell   *lc;
+
+	if (CardFeedbackHash == NULL || queryDesc->planstate == NULL)
+		return;
+
+	ctx.stmt = queryDesc->plannedstmt;
+	ctx.relids = NIL;
+	ctx.below_limit = false;
+	ctx.observations = NIL;
+
+	card_feedback_walker(queryDesc->planstate, &ctx);
+
+	if (ctx.observations == NIL)
+		return;
+
+	LWLockAcquire(CardFeedbackLock, LW_EXCLUSIVE);
+	foreach(lc, ctx.observations)
+	{
+		CardFeedbackObservation *obs = (CardFeedbackObservation *) lfirst(lc);
+
+		card_feedback_store(obs->key, obs->rows, obs->est_rows, obs->relids);
+	}
+	LWLockRelease(CardFeedbackLock);
+
+	list_free_deep(ctx.observations);
+}
+
+/*
+ * CardFeedbackLookup
+ *
+ * Return the remembered rows of the expression with the given fingerprint,
+ * if any.
+ */
+bool
+CardFeedbackLookup(uint64 key, double *rows)
+{
+	CardFeedbackEntry *entry;
+	bool		found = false;
+
+	if (CardFeedbackHash == NULL)
+		return false;
+
+	LWLockAcquire(CardFeedbackLock, LW_SHARED);
+	entry = hash_search(CardFeedbackHash, &key, HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		*rows = entry->rows;
+		found = true;
+	}
+	LWLockRelease(CardFeedbackLock);
+
+	return found;
+}
+
+/*
+ * CardFeedbackInvalidateRel
+ *
+ * Forget the rows of all expressions on a relation whose statistics have
+ * been updated, or of all expressions if relid is InvalidOid.
+ */
+void
+CardFeedbackInvalidateRel(Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+
+	if (CardFeedbackHash == NULL)
+		return;
+
+	LWLockAcquire(CardFeedbackLock, LW_EXCLUSIVE);
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		bool		match = !OidIsValid(relid);
+		int			i;
+
+		for (i = 0; i < entry->nrelids && !match; i++)
+			match = (entry->relids[i] == relid);
+
+		if (match)
+			hash_search(CardFeedbackHash, &entry->key, HASH_REMOVE, NULL);
+	}
+	LWLockRelease(CardFeedbackLock);
+}
+
+/*
+ * gp_cardinality_feedback
+ *
+ * Show the remembered row counts.
+ */
+Datum
+gp_cardinality_feedback(PG_FUNCTION_ARGS)
+{
+#define GP_CARDINALITY_FEEDBACK_COLS 6
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	if (CardFeedbackHash == NULL)
+		return (Datum) 0;
+
+	LWLockAcquire(CardFeedbackLock, LW_SHARED);
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		Datum		values[GP_CARDINALITY_FEEDBACK_COLS];
+		bool		nulls[GP_CARDINALITY_FEEDBACK_COLS];
+		Datum		relids[CARD_FEEDBACK_MAX_RELS];
+		int			i;
+
+		memset(nulls, 0, sizeof(nulls));
+
+		for (i = 0; i < entry->nrelids; i++)
+			relids[i] = ObjectIdGetDatum(entry->relids[i]);
+
+		values[0] = Int64GetDatum((int64) entry->key);
+		values[1] = PointerGetDatum(construct_array(relids, entry->nrelids,
+													OIDOID, sizeof(Oid),
+													true, TYPALIGN_INT));
+		values[2] = Float8GetDatum(entry->est_rows);
+		values[3] = Float8GetDatum(entry->rows);
+		values[4] = Int64GetDatum(entry->executions);
+		values[5] = TimestampTzGetDatum(entry->last_updated);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+	LWLockRelease(CardFeedbackLock);
+
+	return (Datum) 0;
+}
+
+/*
+ * gp_cardinality_feedback_reset
+ *
+ * Forget all remembered row counts.
+ */
+Datum
+gp_cardinality_feedback_reset(PG_FUNCTION_ARGS)
+{
+	CardFeedbackInvalidateRel(InvalidOid);
+
+	PG_RETURN_VOID();
+}
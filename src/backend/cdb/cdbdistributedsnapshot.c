@@ -23,6 +23,71 @@
 #include "utils/snapmgr.h"
 #include "storage/procarray.h"
 
+/*
+ * Binary search the local xids of the distributed snapshot's in-progress
+ * transactions that we have mapped so far, which are kept sorted. They are
+ * all in-progress at the same time, so TransactionIdPrecedes() orders them
+ * consistently. Return the position of localXid, or the position where it
+ * should be inserted.
+ */
+static int32
+LocalMappingSearch(DistributedSnapshotWithLocalMapping *dslm,
+				   TransactionId localXid, bool *found)
+{
+	int32		low = 0;
+	int32		high = dslm->currentLocalXidsCount;
+
+	while (low < high)
+	{
+		int32		mid = low + (high - low) / 2;
+		TransactionId midXid = dslm->inProgressMappedLocalXids[mid];
+
+		if (TransactionIdEquals(localXid, midXid))
+		{
+			*found = true;
+			return mid;
+		}
+		if (TransactionIdPrecedes(localXid, midXid))
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	*found = false;
+	return low;
+}
+
+/*
+ * DistributedSnapshot_XidInProgress
+ *		Is the given distributed xid in the in-progress array of the
+ *		distributed snapshot?
+ *
+ * The array is sorted in ascending order while creating the snapshot in
+ * CreateDistributedSnapshot(), so we can binary search it.
+ */
+bool
+DistributedSnapshot_XidInProgress(DistributedSnapshot *ds,
+								  DistributedTransactionId distribXid)
+{
+	const DistributedTransactionId *xids = ds->inProgressXidArray;
+	int32		low = 0;
+	int32		high = ds->count;
+
+	if (high == 0 || distribXid < xids[0] || distribXid > xids[high - 1])
+		return false;
+
+	/* branch-free halving, which doesn't stall on mispredictions */
+	while (high > 1)
+	{
+		int32		half = high / 2;
+
+		low = (xids[low + half] <= distribXid) ? low + half : low;
+		high -= half;
+	}
+
+	return xids[low] == distribXid;
+}
+
 /*
  * DistributedSnapshotWithLocalMapping_CommittedTest
  *		Is the given XID still-in-progress according to the
@@ -36,8 +101,8 @@ DistributedSnapshotWithLocalMapping_CommittedTest(
 												  bool isVacuumCheck)
 {
 	DistributedSnapshot *ds = &dslm->ds;
-	uint32		i;
 	DistributedTransactionId distribXid = InvalidDistributedTransactionId;
+	bool		found;
 
 	Assert(!IS_QUERY_DISPATCHER());
 
@@ -67,14 +132,11 @@ DistributedSnapshotWithLocalMapping_CommittedTest(
 		if (TransactionIdFollows(localXid, dslm->minCachedLocalXid) &&
 			TransactionIdPrecedes(localXid, dslm->maxCachedLocalXid))
 		{
-			for (i = 0; i < dslm->currentLocalXidsCount; i++)
-			{
-				Assert(dslm->inProgressMappedLocalXids != NULL);
-				Assert(TransactionIdIsValid(dslm->inProgressMappedLocalXids[i]));
+			Assert(dslm->inProgressMappedLocalXids != NULL);
 
-				if (TransactionIdEquals(localXid, dslm->inProgressMappedLocalXids[i]))
-					return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
-			}
+			(void) LocalMappingSearch(dslm, localXid, &found);
+			if (found)
+				return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
 		}
 	}
 
@@ -148,45 +210,35 @@ DistributedSnapshotWithLocalMapping_CommittedTest(
 		return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
 	}
 
-	for (i = 0; i < ds->count; i++)
+	if (DistributedSnapshot_XidInProgress(ds, distribXid))
 	{
-		if (distribXid == ds->inProgressXidArray[i])
+		/*
+		 * Save the relationship to the local xid so we may avoid checking
+		 * the distributed committed log in a subsequent check. We can only
+		 * record local xids till cache size permits.
+		 */
+		if (dslm->currentLocalXidsCount < ds->count)
 		{
-			/*
-			 * Save the relationship to the local xid so we may avoid checking
-			 * the distributed committed log in a subsequent check. We can
-			 * only record local xids till cache size permits.
-			 */
-			if (dslm->currentLocalXidsCount < ds->count)
+			int32		pos;
+
+			Assert(dslm->inProgressMappedLocalXids != NULL);
+
+			pos = LocalMappingSearch(dslm, localXid, &found);
+			if (!found)
 			{
-				Assert(dslm->inProgressMappedLocalXids != NULL);
-				dslm->inProgressMappedLocalXids[dslm->currentLocalXidsCount++] =
-					localXid;
-
-				if (!TransactionIdIsValid(dslm->minCachedLocalXid) ||
-					TransactionIdPrecedes(localXid, dslm->minCachedLocalXid))
-				{
-					dslm->minCachedLocalXid = localXid;
-				}
-
-				if (!TransactionIdIsValid(dslm->maxCachedLocalXid) ||
-					TransactionIdFollows(localXid, dslm->maxCachedLocalXid))
-				{
-					dslm->maxCachedLocalXid = localXid;
-				}
+				memmove(&dslm->inProgressMappedLocalXids[pos + 1],
+						&dslm->inProgressMappedLocalXids[pos],
+						(dslm->currentLocalXidsCount - pos) * sizeof(TransactionId));
+				dslm->inProgressMappedLocalXids[pos] = localXid;
+				dslm->currentLocalXidsCount++;
+
+				dslm->minCachedLocalXid = dslm->inProgressMappedLocalXids[0];
+				dslm->maxCachedLocalXid =
+					dslm->inProgressMappedLocalXids[dslm->currentLocalXidsCount - 1];
 			}
-
-			return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
 		}
 
-		/*
-		 * Leverage the fact that ds->inProgressXidArray is sorted in
-		 * ascending order based on distribXid while creating the snapshot in
-		 * CreateDistributedSnapshot(). So, can fail fast once known are
-		 * lower than rest of them.
-		 */
-		if (distribXid < ds->inProgressXidArray[i])
-			break;
+		return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
 	}
 
 	/*
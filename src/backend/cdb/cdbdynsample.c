@@ -0,0 +1,286 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbdynsample.c
+ *	  Dynamic sampling of predicates whose selectivity cannot be estimated
+ *	  from the statistics.
+ *
+ * ORCA uses a fixed default selectivity for predicates its statistics
+ * framework doesn't support, like calls to user-defined functions or
+ * expressions on columns.  With optimizer_enable_dynamic_sampling, it asks
+ * us to evaluate such a predicate on a block sample of the relation
+ * instead, by running
+ *
+ *	SELECT count(*), count(*) FILTER (WHERE <qual>)
+ *	FROM <rel> TABLESAMPLE SYSTEM (<pct>) REPEATABLE (0)
+ *
+ * through SPI, in a subtransaction so that an error in the predicate doesn't
+ * abort the query being planned.  The observed selectivities are cached for
+ * the session, keyed on the relation and a fingerprint of the predicate.
+ * An invalidation of the relation's relcache entry, which ANALYZE causes by
+ * updating its pg_class row, throws away the cached selectivities of the
+ * relation, along with the statistics they were taken next to.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/cdbdynsample.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/xact.h"
+#include "catalog/pg_class.h"
+#include "cdb/cdbdynsample.h"
+#include "common/hashfn.h"
+#include "executor/spi.h"
+#include "lib/stringinfo.h"
+#include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "optimizer/optimizer.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/ruleutils.h"
+#include "utils/snapmgr.h"
+
+/* number of blocks to sample, across all segments */
+#define DYNAMIC_SAMPLE_BLOCKS		256
+
+/* a partial sample with fewer rows than this is not trusted */
+#define DYNAMIC_SAMPLE_MIN_ROWS		100
+
+/* maximum number of cached selectivities */
+#define DYNAMIC_SAMPLE_CACHE_SIZE	1024
+
+typedef struct DynSampleKey
+{
+	Oid			relid;
+	uint64		fingerprint;	/* hash of the deparsed predicate */
+} DynSampleKey;
+
+typedef struct DynSampleEntry
+{
+	DynSampleKey key;
+	double		selectivity;
+} DynSampleEntry;
+
+static HTAB *DynSampleCache = NULL;
+
+/* is a sample query running? */
+static bool dynamic_sample_active = false;
+
+static void
+DynSampleInvalCallback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	DynSampleEntry *entry;
+
+	if (DynSampleCache == NULL)
+		return;
+
+	hash_seq_init(&status, DynSampleCache);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (relid == InvalidOid || entry->key.relid == relid)
+			hash_search(DynSampleCache, &entry->key, HASH_REMOVE, NULL);
+	}
+}
+
+static void
+InitDynSampleCache(void)
+{
+	static bool callback_registered = false;
+	HASHCTL		ctl;
+
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(DynSampleKey);
+	ctl.entrysize = sizeof(DynSampleEntry);
+	DynSampleCache = hash_create("Dynamic sample cache", 64, &ctl,
+								 HASH_ELEM | HASH_BLOBS);
+
+	if (!callback_registered)
+	{
+		CacheRegisterRelcacheCallback(DynSampleInvalCallback, (Datum) 0);
+		callback_registered = true;
+	}
+}
+
+static bool
+contain_param_walker(Node *node, void *context)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Param))
+		return true;
+	return expression_tree_walker(node, contain_param_walker, context);
+}
+
+/*
+ * Run the sample query, and return the fraction of the sampled rows that
+ * satisfied the predicate, or -1 if the sample is too small to tell.
+ */
+static double
+run_sample_query(const char *sql, bool partial)
+{
+	bool		isnull;
+	int64		nrows;
+	int64		nmatched;
+	double		selectivity = -1;
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	if (SPI_execute(sql, true, 1) != SPI_OK_SELECT || SPI_processed != 1)
+		elog(ERROR, "dynamic sample query failed: %s", sql);
+
+	nrows = DatumGetInt64(SPI_getbinval(SPI_tuptable->vals[0],
+										SPI_tuptable->tupdesc, 1, &isnull));
+	nmatched = DatumGetInt64(SPI_getbinval(SPI_tuptable->vals[0],
+										   SPI_tuptable->tupdesc, 2, &isnull));
+
+	if (nrows > 0 && (!partial || nrows >= DYNAMIC_SAMPLE_MIN_ROWS))
+	{
+		/* credit the predicate with half a row if none passed */
+		selectivity = Max(nmatched, 0.5) / nrows;
+		selectivity = Min(selectivity, 1.0);
+	}
+
+	SPI_finish();
+
+	return selectivity;
+}
+
+/*
+ * cdbSampleQualSelectivity
+ *
+ * Estimate the selectivity of 'qual', whose Vars refer to relation 'relid'
+ * as varno 1, from a sample of the relation.  Cached estimates are always
+ * used; a new sample is only taken if *budget is positive, and decrements
+ * it.  Return false if there is no estimate.
+ */
+bool
+cdbSampleQualSelectivity(Oid relid, Node *qual, int *budget,
+						 double *selectivity)
+{
+	MemoryContext oldcontext = CurrentMemoryContext;
+	ResourceOwner oldowner = CurrentResourceOwner;
+	Relation	rel;
+	char		relkind;
+	BlockNumber relpages;
+	char	   *relname;
+	char	   *nspname;
+	char	   *qualstr;
+	DynSampleKey key;
+	DynSampleEntry *entry;
+	double		pct;
+	StringInfoData sql;
+	volatile double result = -1;
+
+	/* the sample query could be planned with dynamic sampling, too */
+	if (dynamic_sample_active || !ActiveSnapshotSet())
+		return false;
+
+	if (contain_volatile_functions(qual) || contain_subplans(qual) ||
+		contain_param_walker(qual, NULL))
+		return false;
+
+	rel = RelationIdGetRelation(relid);
+	if (!RelationIsValid(rel))
+		return false;
+	relkind = rel->rd_rel->relkind;
+	relpages = rel->rd_rel->relpages;
+	relname = pstrdup(RelationGetRelationName(rel));
+	nspname = get_namespace_name(RelationGetNamespace(rel));
+	RelationClose(rel);
+
+	if ((relkind != RELKIND_RELATION && relkind != RELKIND_MATVIEW &&
+		 relkind != RELKIND_PARTITIONED_TABLE) || relpages == 0)
+		return false;
+
+	qualstr = deparse_expression(qual, deparse_context_for(relname, relid),
+								 false, true);
+
+	if (DynSampleCache == NULL)
+		InitDynSampleCache();
+
+	key.relid = relid;
+	key.fingerprint = hash_bytes_extended((const unsigned char *) qualstr,
+										  strlen(qualstr), 0);
+	entry = hash_search(DynSampleCache, &key, HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		*selectivity = entry->selectivity;
+		return true;
+	}
+
+	if (*budget <= 0)
+		return false;
+	(*budget)--;
+
+	pct = Min(100.0, 100.0 * DYNAMIC_SAMPLE_BLOCKS / relpages);
+
+	initStringInfo(&sql);
+	appendStringInfo(&sql,
+					 "SELECT pg_catalog.count(*), pg_catalog.count(*) FILTER (WHERE %s) "
+					 "FROM %s TABLESAMPLE SYSTEM (%g) REPEATABLE (0)",
+					 qualstr, quote_qualified_identifier(nspname, relname), pct);
+
+	BeginInternalSubTransaction(NULL);
+	MemoryContextSwitchTo(oldcontext);
+
+	dynamic_sample_active = true;
+	PG_TRY();
+	{
+		result = run_sample_query(sql.data, pct < 100.0);
+
+		ReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldcontext);
+		CurrentResourceOwner = oldowner;
+	}
+	PG_CATCH();
+	{
+		ErrorData  *edata;
+
+		dynamic_sample_active = false;
+
+		MemoryContextSwitchTo(oldcontext);
+		edata = CopyErrorData();
+		FlushErrorState();
+
+		RollbackAndReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldcontext);
+		CurrentResourceOwner = oldowner;
+
+		/* a cancel must still cancel the query being planned */
+		if (edata->sqlerrcode == ERRCODE_QUERY_CANCELED)
+			ReThrowError(edata);
+
+		elog(DEBUG1, "dynamic sampling of \"%s\" failed: %s",
+			 relname, edata->message);
+		FreeErrorData(edata);
+	}
+	PG_END_TRY();
+	dynamic_sample_active = false;
+
+	pfree(sql.data);
+
+	if (result < 0)
+		return false;
+
+	if (hash_get_num_entries(DynSampleCache) >= DYNAMIC_SAMPLE_CACHE_SIZE)
+	{
+		hash_destroy(DynSampleCache);
+		InitDynSampleCache();
+	}
+	entry = hash_search(DynSampleCache, &key, HASH_ENTER, NULL);
+	entry->selectivity = result;
+
+	*selectivity = result;
+	return true;
+}
@@ -26,11 +26,10 @@
 #include "cdb/cdblocaldistribxact.h"
 #include "cdb/cdbvars.h"
 #include "common/hashfn.h"
-#include "lib/ilist.h"
 #include "miscadmin.h"
+#include "port/pg_bitutils.h"
 #include "storage/proc.h"
 #include "utils/guc.h"
-#include "utils/hsearch.h"
 #include "utils/memutils.h"
 
 /*  ***************************************************************************** */
@@ -149,191 +148,200 @@ LocalDistribXact_DisplayString(int pgprocno)
 
 /*  ***************************************************************************** */
 
-/* Memory context for long-lived local-distributed commit pairs. */
-static MemoryContext LocalDistribCacheMemCxt = NULL;
-
-/* Hash table for the long-lived local-distributed commit pairs. */
-static HTAB *LocalDistribCacheHtab;
-
 /*
- * A cached local-distributed transaction pair.
+ * Cache of long-lived local-distributed commit pairs.
  *
- * We also cache just local-only transactions, so in that case distribXid
- * will be InvalidDistributedTransactionId.
+ * The visibility checks look up the cache for every tuple whose xmin or xmax
+ * is a recently committed distributed transaction, so it is laid out for
+ * fast lookups: an array of sets of LOCALDISTRIB_CACHE_WAYS entries, each
+ * set filling a cache line. A local xid is looked up only in the set its
+ * hash maps to. When a set is full, its least recently used entry is
+ * evicted.
+ */
+#define LOCALDISTRIB_CACHE_WAYS 4
+
+/*
+ * A cached local-distributed transaction pair. An unused entry has an
+ * invalid localXid.
  */
 typedef struct LocalDistribXactCacheEntry
 {
-	/*
-	 * Distributed and local xids.
-	 */
 	TransactionId localXid;
-	/* MUST BE FIRST: Hash table key. */
-
+	uint32		lastUsed;		/* LocalDistribXactCache.clock when last
+								 * used */
 	DistributedTransactionId distribXid;
-
-	int64		visits;
-
-	dlist_node	lruDoubleLinks;
-	/* list link for LRU */
-
 } LocalDistribXactCacheEntry;
 
+typedef struct LocalDistribXactCacheSet
+{
+	LocalDistribXactCacheEntry entries[LOCALDISTRIB_CACHE_WAYS];
+} LocalDistribXactCacheSet;
+
 /*
  * Globals for local-distributed cache.
  */
 static struct LocalDistribXactCache
 {
-	int32		count;
-
-	dlist_head	lruDoublyLinkedHead;
+	LocalDistribXactCacheSet *sets;
+	uint32		setMask;		/* number of sets - 1 */
+	uint32		clock;			/* advanced at every use of an entry */
 
 	int64		hitCount;
-	int64		totalCount;
+	int64		missCount;
 	int64		addCount;
 	int64		removeCount;
 
-}			LocalDistribXactCache = {0, DLIST_STATIC_INIT(LocalDistribXactCache.lruDoublyLinkedHead), 0, 0, 0, 0};
+}			LocalDistribXactCache = {NULL, 0, 0, 0, 0, 0, 0};
+
+static inline LocalDistribXactCacheSet *
+LocalDistribXactCache_GetSet(TransactionId localXid)
+{
+	return &LocalDistribXactCache.sets[murmurhash32(localXid) &
+									   LocalDistribXactCache.setMask];
+}
+
+static void
+LocalDistribXactCache_Init(void)
+{
+	uint32		nsets;
+	char	   *mem;
+
+	StaticAssertStmt(PG_CACHE_LINE_SIZE % sizeof(LocalDistribXactCacheSet) == 0,
+					 "a set of the local-distributed cache must not straddle cache lines");
 
+	/*
+	 * Round the number of sets up to a power of 2, so that we can mask, but
+	 * stay within the allocation limit. gp_max_local_distributed_cache is
+	 * PGC_POSTMASTER, so the cache is sized once per backend.
+	 */
+	nsets = ((uint32) gp_max_local_distributed_cache + LOCALDISTRIB_CACHE_WAYS - 1) /
+		LOCALDISTRIB_CACHE_WAYS;
+	nsets = Min(nsets, MaxAllocSize / sizeof(LocalDistribXactCacheSet) / 2);
+	nsets = pg_nextpower2_32(Max(nsets, 1));
+
+	/* palloc only aligns to MAXALIGN, so align the sets by hand */
+	mem = MemoryContextAllocZero(TopMemoryContext,
+								 nsets * sizeof(LocalDistribXactCacheSet) +
+								 PG_CACHE_LINE_SIZE);
+	LocalDistribXactCache.sets = (LocalDistribXactCacheSet *) CACHELINEALIGN(mem);
+	LocalDistribXactCache.setMask = nsets - 1;
+}
 
 bool
 LocalDistribXactCache_CommittedFind(TransactionId localXid,
 									DistributedTransactionId *distribXid)
 {
-	LocalDistribXactCacheEntry *entry;
-	bool		found;
+	LocalDistribXactCacheSet *set;
 
 	/* Before doing anything, see if we are enabled. */
 	if (gp_max_local_distributed_cache == 0)
 		return false;
 
-	if (LocalDistribCacheMemCxt == NULL)
-	{
-		HASHCTL		hash_ctl;
-
-		/* Create the memory context where cross-transaction state is stored */
-		LocalDistribCacheMemCxt = AllocSetContextCreate(TopMemoryContext,
-														"Local-distributed commit cache context",
-														ALLOCSET_DEFAULT_MINSIZE,
-														ALLOCSET_DEFAULT_INITSIZE,
-														ALLOCSET_DEFAULT_MAXSIZE);
-
-		Assert(LocalDistribCacheHtab == NULL);
-
-		/* Create the hashtable proper */
-		MemSet(&hash_ctl, 0, sizeof(hash_ctl));
-		hash_ctl.keysize = sizeof(TransactionId);
-		hash_ctl.entrysize = sizeof(LocalDistribXactCacheEntry);
-		hash_ctl.hash = tag_hash;
-		hash_ctl.hcxt = LocalDistribCacheMemCxt;
-		LocalDistribCacheHtab = hash_create("Local-distributed commit cache",
-											25, /* start small and extend */
-											&hash_ctl,
-											HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
-
-		MemSet(&LocalDistribXactCache, 0, sizeof(LocalDistribXactCache));
-		dlist_init(&LocalDistribXactCache.lruDoublyLinkedHead);
+	if (LocalDistribXactCache.sets == NULL)
+		LocalDistribXactCache_Init();
 
-	}
-
-	entry = (LocalDistribXactCacheEntry *) hash_search(
-													   LocalDistribCacheHtab,
-													   &localXid,
-													   HASH_FIND,
-													   &found);
-
-	if (found)
+	set = LocalDistribXactCache_GetSet(localXid);
+	for (int i = 0; i < LOCALDISTRIB_CACHE_WAYS; i++)
 	{
-		/*
-		 * Maintain LRU ordering.
-		 */
-		dlist_delete(&entry->lruDoubleLinks);
-		dlist_push_head(&LocalDistribXactCache.lruDoublyLinkedHead, &entry->lruDoubleLinks);
+		LocalDistribXactCacheEntry *entry = &set->entries[i];
 
-		*distribXid = entry->distribXid;
+		if (entry->localXid == localXid)
+		{
+			/*
+			 * Maintain LRU ordering.
+			 */
+			entry->lastUsed = ++LocalDistribXactCache.clock;
 
-		entry->visits++;
+			*distribXid = entry->distribXid;
 
-		LocalDistribXactCache.hitCount++;
+			LocalDistribXactCache.hitCount++;
+			return true;
+		}
 	}
 
-	LocalDistribXactCache.totalCount++;
-
-	return found;
+	LocalDistribXactCache.missCount++;
+	return false;
 }
 
 void
 LocalDistribXactCache_AddCommitted(TransactionId localXid,
 								   DistributedTransactionId distribXid)
 {
-	LocalDistribXactCacheEntry *entry;
-	bool		found;
+	LocalDistribXactCacheSet *set;
+	LocalDistribXactCacheEntry *victim = NULL;
 
 	/* Before doing anything, see if we are enabled. */
 	if (gp_max_local_distributed_cache == 0)
 		return;
 
-	Assert(LocalDistribCacheMemCxt != NULL);
-	Assert(LocalDistribCacheHtab != NULL);
+	Assert(LocalDistribXactCache.sets != NULL);
+	Assert(TransactionIdIsNormal(localXid));
 
-	if (LocalDistribXactCache.count >= gp_max_local_distributed_cache)
+	/*
+	 * Use a free entry of the set, or else evict the least recently used
+	 * one. The clock may wrap around, which at worst evicts a recently used
+	 * entry.
+	 */
+	set = LocalDistribXactCache_GetSet(localXid);
+	for (int i = 0; i < LOCALDISTRIB_CACHE_WAYS; i++)
 	{
-		LocalDistribXactCacheEntry *lastEntry;
-		LocalDistribXactCacheEntry *removedEntry;
-
-		Assert(LocalDistribXactCache.count == gp_max_local_distributed_cache);
+		LocalDistribXactCacheEntry *entry = &set->entries[i];
 
-		/*
-		 * Remove oldest.
-		 */
-		lastEntry = (LocalDistribXactCacheEntry *)
-			dlist_container(LocalDistribXactCacheEntry,
-							lruDoubleLinks,
-							dlist_tail_node(&LocalDistribXactCache.lruDoublyLinkedHead));
-		Assert(lastEntry != NULL);
-		dlist_delete(&lastEntry->lruDoubleLinks);
+		if (entry->localXid == localXid)
+			elog(ERROR, "Add should not have found local xid = %x", localXid);
 
-		removedEntry = (LocalDistribXactCacheEntry *)
-			hash_search(LocalDistribCacheHtab, &lastEntry->localXid,
-						HASH_REMOVE, NULL);
-		Assert(lastEntry == removedEntry);
-
-		LocalDistribXactCache.count--;
-
-		LocalDistribXactCache.removeCount++;
-	}
-
-	/* Now we can add entry to hash table */
-	entry = (LocalDistribXactCacheEntry *) hash_search(
-													   LocalDistribCacheHtab,
-													   &localXid,
-													   HASH_ENTER,
-													   &found);
-	if (found)
-	{
-		elog(ERROR, "Add should not have found local xid = %x", localXid);
+		if (!TransactionIdIsValid(entry->localXid))
+		{
+			victim = entry;
+			break;
+		}
+		if (victim == NULL ||
+			(int32) (entry->lastUsed - victim->lastUsed) < 0)
+			victim = entry;
 	}
 
-	dlist_push_head(&LocalDistribXactCache.lruDoublyLinkedHead,
-					&entry->lruDoubleLinks);
-
-	entry->localXid = localXid;
-	entry->distribXid = distribXid;
-	entry->visits = 1;
+	if (TransactionIdIsValid(victim->localXid))
+		LocalDistribXactCache.removeCount++;
 
-	LocalDistribXactCache.count++;
+	victim->localXid = localXid;
+	victim->distribXid = distribXid;
+	victim->lastUsed = ++LocalDistribXactCache.clock;
 
 	LocalDistribXactCache.addCount++;
+}
+
+/*
+ * Forget all the cached pairs, and reset the statistics.
+ */
+void
+LocalDistribXactCache_Reset(void)
+{
+	if (LocalDistribXactCache.sets != NULL)
+		MemSet(LocalDistribXactCache.sets, 0,
+			   (LocalDistribXactCache.setMask + 1) * sizeof(LocalDistribXactCacheSet));
+
+	LocalDistribXactCache.clock = 0;
+	LocalDistribXactCache.hitCount = 0;
+	LocalDistribXactCache.missCount = 0;
+	LocalDistribXactCache.addCount = 0;
+	LocalDistribXactCache.removeCount = 0;
+}
 
+void
+LocalDistribXactCache_GetStats(int64 *hits, int64 *misses)
+{
+	*hits = LocalDistribXactCache.hitCount;
+	*misses = LocalDistribXactCache.missCount;
 }
 
 void
 LocalDistribXactCache_ShowStats(char *nameStr)
 {
 	elog(LOG, "%s: Local-distributed cache counts "
-		 "(hits " INT64_FORMAT ", total " INT64_FORMAT ", adds " INT64_FORMAT ", removes " INT64_FORMAT ")",
+		 "(hits " INT64_FORMAT ", misses " INT64_FORMAT ", adds " INT64_FORMAT ", removes " INT64_FORMAT ")",
 		 nameStr,
 		 LocalDistribXactCache.hitCount,
-		 LocalDistribXactCache.totalCount,
+		 LocalDistribXactCache.missCount,
 		 LocalDistribXactCache.addCount,
 		 LocalDistribXactCache.removeCount);
 }
@@ -54,6 +54,7 @@ typedef struct
 	EState	   *estate;
 	bool		single_row_insert;
 	List	   *cursorPositions;
+	bool		evaluated;		/* was any function evaluated? */
 } pre_dispatch_function_evaluation_context;
 
 /*
@@ -1441,7 +1442,7 @@ remove_unused_initplans(Plan *top_plan, PlannerInfo *root)
  */
 Node *
 exec_make_plan_constant(struct PlannedStmt *stmt, EState *estate, bool is_SRI,
-						List **cursorPositions)
+						List **cursorPositions, bool *evaluated)
 {
 	pre_dispatch_function_evaluation_context pcontext;
 	Node	   *result;
@@ -1451,10 +1452,12 @@ exec_make_plan_constant(struct PlannedStmt *stmt, EState *estate, bool is_SRI,
 	pcontext.single_row_insert = is_SRI;
 	pcontext.cursorPositions = NIL;
 	pcontext.estate = estate;
+	pcontext.evaluated = false;
 
 	result = pre_dispatch_function_evaluation_mutator((Node *) stmt->planTree, &pcontext);
 
 	*cursorPositions = pcontext.cursorPositions;
+	*evaluated = pcontext.evaluated;
 	return result;
 }
 
@@ -1690,7 +1693,10 @@ pre_dispatch_function_evaluation_mutator(Node *node,
 
 			/* successfully simplified it */
 			if (simple)
+			{
+				context->evaluated = true;
 				return (Node *) simple;
+			}
 		}
 
 		/*
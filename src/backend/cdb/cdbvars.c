@@ -202,6 +202,8 @@ int			Gp_interconnect_timer_checking_period = 20;
 int			Gp_interconnect_default_rtt = 20;
 int			Gp_interconnect_min_rto = 20;
 int			Gp_interconnect_fc_method = INTERCONNECT_FC_METHOD_LOSS;
+int			Gp_interconnect_compression = INTERCONNECT_COMPRESSION_NONE;
+double		Gp_interconnect_compression_ratio = 0.8;
 int			Gp_interconnect_transmit_timeout = 3600;
 int			Gp_interconnect_min_retries_before_timeout = 100;
 int			Gp_interconnect_debug_retry_interval = 10;
@@ -258,6 +260,7 @@ double		gp_motion_cost_per_row = 0;
 int			gp_segments_for_planner = 0;
 
 int			gp_hashagg_default_nbatches = 32;
+bool		gp_hashagg_streambottom = true;
 
 bool		gp_adjust_selectivity_for_outerjoins = true;
 bool		gp_selectivity_damping_for_scans = false;
@@ -290,6 +293,12 @@ int			gp_segworker_relative_priority = PRIO_MAX;
 /* Max size of dispatched plans; 0 if no limit */
 int			gp_max_plan_size = 0;
 
+/* Max number of plans cached by a QE for the QD; 0 to disable */
+int			gp_segment_plan_cache_size = 64;
+
+/* Number of QD workers routing the rows of COPY FROM; 0 to disable */
+int			gp_copy_from_parallel_workers = 0;
+
 /* Disable setting of tuple hints while reading */
 bool		gp_disable_tuple_hints = false;
 
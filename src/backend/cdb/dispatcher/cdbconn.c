@@ -115,6 +115,9 @@ cdbconn_termSegmentDescriptor(SegmentDatabaseDescriptor *segdbDesc)
 		segdbDesc->whoami = NULL;
 	}
 
+	if (segdbDesc->cachedPlans != NULL)
+		pfree(segdbDesc->cachedPlans);
+
 	pfree(segdbDesc);
 }								/* cdbconn_termSegmentDescriptor */
 
@@ -33,11 +33,13 @@
 #include "tcop/tcopprot.h"
 #include "cdb/cdbdisp.h"
 #include "cdb/cdbdisp_async.h"
+#include "cdb/cdbdisp_query.h"
 #include "cdb/cdbdispatchresult.h"
 #include "libpq-fe.h"
 #include "libpq-int.h"
 #include "cdb/cdbfts.h"
 #include "cdb/cdbgang.h"
+#include "cdb/cdbplancache.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbpq.h"
 #include "miscadmin.h"
@@ -139,7 +141,7 @@ static void
 			handlePollError(CdbDispatchCmdAsync *pParms);
 
 static void
-			handlePollSuccess(CdbDispatchCmdAsync *pParms, struct pollfd *fds);
+			handlePollSuccess(CdbDispatcherState *ds, struct pollfd *fds);
 
 static bool
 			checkAckMessage(CdbDispatchResult *dispatchResult, const char *message);
@@ -323,7 +325,21 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 		}
 		pParms->dispatchResultPtrArray[pParms->dispatchCount++] = qeResult;
 
-		dispatchCommand(qeResult, pParms->query_text, pParms->query_text_len);
+		if (ds->planCacheKey == 0)
+			dispatchCommand(qeResult, pParms->query_text, pParms->query_text_len);
+		else if (SegmentPlanCacheHasPlan(segdbDesc, ds->planCacheKey,
+										 ds->planCacheEpoch))
+			dispatchCommand(qeResult, ds->planRefText, ds->planRefTextLen);
+		else
+		{
+			char	   *planText;
+			int			planTextLen;
+
+			planText = cdbdisp_getPlanQueryText(ds, &planTextLen);
+			dispatchCommand(qeResult, planText, planTextLen);
+			SegmentPlanCacheRemember(segdbDesc, ds->planCacheKey,
+									 ds->planCacheEpoch);
+		}
 	}
 }
 
@@ -646,7 +662,7 @@ checkDispatchResult(CdbDispatcherState *ds, int timeout_sec)
 		}
 		/* We have data waiting on one or more of the connections. */
 		else
-			handlePollSuccess(pParms, fds);
+			handlePollSuccess(ds, fds);
 	}
 
 	pfree(fds);
@@ -788,9 +804,10 @@ handlePollError(CdbDispatchCmdAsync *pParms)
  * Receive and process results from QEs.
  */
 static void
-handlePollSuccess(CdbDispatchCmdAsync *pParms,
+handlePollSuccess(CdbDispatcherState *ds,
 				  struct pollfd *fds)
 {
+	CdbDispatchCmdAsync *pParms = (CdbDispatchCmdAsync *) ds->dispatchParams;
 	int			currentFdNumber = 0;
 	int			i = 0;
 
@@ -835,6 +852,34 @@ handlePollSuccess(CdbDispatchCmdAsync *pParms,
 		 */
 		finished = processResults(dispatchResult);
 
+		/*
+		 * If the QE did not have the cached plan it was sent, it has not run
+		 * anything. Send it the whole plan, unless we are no longer waiting
+		 * for the QEs to complete.
+		 */
+		if (finished && dispatchResult->planCacheMiss)
+		{
+			dispatchResult->planCacheMiss = false;
+			SegmentPlanCacheForget(segdbDesc);
+
+			if (pParms->waitMode == DISPATCH_WAIT_NONE ||
+				pParms->waitMode == DISPATCH_WAIT_ACK_ROOT)
+			{
+				char	   *planText;
+				int			planTextLen;
+
+				ELOG_DISPATCHER_DEBUG("plan cache miss on %d of %d (%s), sending the plan",
+									  i + 1, pParms->dispatchCount, segdbDesc->whoami);
+
+				planText = cdbdisp_getPlanQueryText(ds, &planTextLen);
+				dispatchCommand(dispatchResult, planText, planTextLen);
+				SegmentPlanCacheRemember(segdbDesc, ds->planCacheKey,
+										 ds->planCacheEpoch);
+				cdbdisp_waitDispatchFinish_async(ds);
+				continue;
+			}
+		}
+
 		/*
 		 * Are we through with this QE now?
 		 */
@@ -1067,6 +1112,18 @@ processResults(CdbDispatchResult *dispatchResult)
 			segdbDesc->conn->wrote_xlog = false;
 		}
 
+		/*
+		 * The QE did not have the cached plan it was sent, it is sent the
+		 * whole plan once it is done, see handlePollSuccess().
+		 */
+		if (pRes->extraType == PGExtraTypePlanCacheMiss)
+		{
+			ELOG_DISPATCHER_DEBUG("%s -> plan cache miss", segdbDesc->whoami);
+			dispatchResult->planCacheMiss = true;
+			PQclear(pRes);
+			continue;
+		}
+
 		/*
 		 * Attach the PGresult object to the CdbDispatchResult object.
 		 */
@@ -1143,6 +1200,9 @@ processResults(CdbDispatchResult *dispatchResult)
 			 * entry.
 			 */
 			cdbdisp_seterrcode(errcode, resultIndex, dispatchResult);
+
+			/* The QE might have failed before caching the plan */
+			SegmentPlanCacheForget(segdbDesc);
 		}
 	}
 
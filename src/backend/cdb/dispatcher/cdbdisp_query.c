@@ -46,6 +46,7 @@
 #include "cdb/cdbdisp_dtx.h"	/* for qdSerializeDtxContextInfo() */
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbcopy.h"
+#include "cdb/cdbplancache.h"
 #include "executor/execUtils.h"
 
 #define QUERY_STRING_TRUNCATE_SIZE (1024)
@@ -85,6 +86,17 @@ typedef struct DispatchCommandQueryParms
 	char	   *serializedQueryDispatchDesc;
 	int			serializedQueryDispatchDesclen;
 
+	/*
+	 * Identifies the plan in the QEs' plan cache, 0 if it is not cached. See
+	 * cdbplancache.c. The plan is only serialized for the QEs that do not
+	 * have it, query_mem is sent on its own as it may change between runs
+	 * of a cached plan.
+	 */
+	struct PlannedStmt *plannedstmt;
+	uint64		planCacheKey;
+	uint32		planCacheEpoch;
+	uint64		planQueryMem;
+
 	/*
 	 * Additional information.
 	 */
@@ -106,7 +118,9 @@ static int fillSliceVector(SliceTable *sliceTable,
 static char *buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 				   int *finalLen);
 
-static DispatchCommandQueryParms *cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc, bool planRequiresTxn);
+static DispatchCommandQueryParms *cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc, uint64 planCacheKey, bool planRequiresTxn);
+static void cdbdisp_serializePlan(DispatchCommandQueryParms *pQueryParms);
+static bool planCachedOnAllQEs(CdbDispatcherState *ds, SliceVec *sliceVector, int nSlices);
 static DispatchCommandQueryParms *cdbdisp_buildUtilityQueryParms(struct Node *stmt, int flags, List *oid_assignments);
 static DispatchCommandQueryParms *cdbdisp_buildCommandQueryParms(const char *strCommand, int flags);
 
@@ -116,6 +130,7 @@ static void cdbdisp_dispatchCommandInternal(DispatchCommandQueryParms *pQueryPar
 
 static void
 cdbdisp_dispatchX(QueryDesc *queryDesc,
+			uint64 planCacheKey,
 			bool planRequiresTxn,
 			bool cancelOnError);
 
@@ -185,6 +200,7 @@ CdbDispatchPlan(struct QueryDesc *queryDesc,
 	bool		is_SRI = false;
 	List	   *paramExecTypes;
 	Bitmapset  *sendParams;
+	uint64		planCacheKey;
 
 	Assert(Gp_role == GP_ROLE_DISPATCH);
 	Assert(queryDesc != NULL && queryDesc->estate != NULL);
@@ -195,6 +211,9 @@ CdbDispatchPlan(struct QueryDesc *queryDesc,
 	stmt = queryDesc->plannedstmt;
 	Assert(stmt);
 
+	/* Must be done while the plan is still the one of the CachedPlan */
+	planCacheKey = SegmentPlanCacheKey(stmt);
+
 	/*
 	 * Let's evaluate STABLE functions now, so we get consistent values on the
 	 * QEs
@@ -220,6 +239,7 @@ CdbDispatchPlan(struct QueryDesc *queryDesc,
 		queryDesc->operation == CMD_DELETE)
 	{
 		List	   *cursors;
+		bool		evaluated;
 
 		/*
 		 * Need to be careful not to modify the original PlannedStmt, because
@@ -230,9 +250,14 @@ CdbDispatchPlan(struct QueryDesc *queryDesc,
 		memcpy(stmt, queryDesc->plannedstmt, sizeof(PlannedStmt));
 		stmt->subplans = list_copy(stmt->subplans);
 
-		stmt->planTree = (Plan *) exec_make_plan_constant(stmt, queryDesc->estate, is_SRI, &cursors);
+		stmt->planTree = (Plan *) exec_make_plan_constant(stmt, queryDesc->estate, is_SRI,
+														  &cursors, &evaluated);
 		queryDesc->plannedstmt = stmt;
 
+		/* The values are only good for this run, don't cache them on the QEs */
+		if (evaluated)
+			planCacheKey = 0;
+
 		queryDesc->ddesc->cursorPositions = (List *) copyObject(cursors);
 	}
 
@@ -265,7 +290,7 @@ CdbDispatchPlan(struct QueryDesc *queryDesc,
 		verify_shared_snapshot_ready(gp_command_count);
 	}
 
-	cdbdisp_dispatchX(queryDesc, planRequiresTxn, cancelOnError);
+	cdbdisp_dispatchX(queryDesc, planCacheKey, planRequiresTxn, cancelOnError);
 }
 
 /*
@@ -618,24 +643,55 @@ cdbdisp_buildUtilityQueryParms(struct Node *stmt,
 
 static DispatchCommandQueryParms *
 cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
+							uint64 planCacheKey,
 							bool planRequiresTxn)
 {
-	char	   *splan,
-			   *sddesc;
-
-	int			splan_len,
-				splan_len_uncompressed,
-				sddesc_len;
+	char	   *sddesc;
+	int			sddesc_len;
 	Oid			save_userid;
 
 	DispatchCommandQueryParms *pQueryParms = (DispatchCommandQueryParms *) palloc0(sizeof(*pQueryParms));
 
+	GetUserIdAndSecContext(&save_userid, &queryDesc->ddesc->secContext);
+	sddesc = serializeNode((Node *) queryDesc->ddesc, &sddesc_len, NULL /* uncompressed_size */ );
+
+	pQueryParms->strCommand = queryDesc->sourceText;
+	pQueryParms->serializedQueryDispatchDesc = sddesc;
+	pQueryParms->serializedQueryDispatchDesclen = sddesc_len;
+	pQueryParms->plannedstmt = queryDesc->plannedstmt;
+	pQueryParms->planCacheKey = planCacheKey;
+	pQueryParms->planCacheEpoch = SegmentPlanCacheEpoch();
+	pQueryParms->planQueryMem = queryDesc->plannedstmt->query_mem;
+
 	/*
-	 * serialized plan tree. Note that we're called for a single slice tree
-	 * (corresponding to an initPlan or the main plan), so the parameters are
-	 * fixed and we can include them in the prefix.
+	 * Serialize a version of our snapshot, and generate our transction
+	 * isolations. We generally want Plan based dispatch to be in a global
+	 * transaction. The executor gets to decide if the special circumstances
+	 * exist which allow us to dispatch without starting a global xact.
 	 */
-	splan = serializeNode((Node *) queryDesc->plannedstmt, &splan_len, &splan_len_uncompressed);
+	pQueryParms->serializedDtxContextInfo =
+		qdSerializeDtxContextInfo(&pQueryParms->serializedDtxContextInfolen,
+								  true /* wantSnapshot */ ,
+								  queryDesc->extended_query,
+								  mppTxnOptions(planRequiresTxn),
+								  "cdbdisp_buildPlanQueryParms");
+
+	return pQueryParms;
+}
+
+/*
+ * Serialize the plan tree of a plan dispatch. Note that we're called for a
+ * single slice tree (corresponding to an initPlan or the main plan), so the
+ * parameters are fixed and we can include them in the prefix.
+ */
+static void
+cdbdisp_serializePlan(DispatchCommandQueryParms *pQueryParms)
+{
+	char	   *splan;
+	int			splan_len,
+				splan_len_uncompressed;
+
+	splan = serializeNode((Node *) pQueryParms->plannedstmt, &splan_len, &splan_len_uncompressed);
 
 	uint64		plan_size_in_kb = ((uint64) splan_len_uncompressed) / (uint64) 1024;
 
@@ -654,29 +710,64 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 
 	Assert(splan != NULL && splan_len > 0 && splan_len_uncompressed > 0);
 
-	GetUserIdAndSecContext(&save_userid, &queryDesc->ddesc->secContext);
-	sddesc = serializeNode((Node *) queryDesc->ddesc, &sddesc_len, NULL /* uncompressed_size */ );
-
-	pQueryParms->strCommand = queryDesc->sourceText;
 	pQueryParms->serializedPlantree = splan;
 	pQueryParms->serializedPlantreelen = splan_len;
-	pQueryParms->serializedQueryDispatchDesc = sddesc;
-	pQueryParms->serializedQueryDispatchDesclen = sddesc_len;
+}
 
-	/*
-	 * Serialize a version of our snapshot, and generate our transction
-	 * isolations. We generally want Plan based dispatch to be in a global
-	 * transaction. The executor gets to decide if the special circumstances
-	 * exist which allow us to dispatch without starting a global xact.
-	 */
-	pQueryParms->serializedDtxContextInfo =
-		qdSerializeDtxContextInfo(&pQueryParms->serializedDtxContextInfolen,
-								  true /* wantSnapshot */ ,
-								  queryDesc->extended_query,
-								  mppTxnOptions(planRequiresTxn),
-								  "cdbdisp_buildPlanQueryParms");
+/*
+ * cdbdisp_getPlanQueryText
+ *
+ * Return the plan dispatch message with the plan in it. When the plan is
+ * cached on the QEs, it is only built for the QEs that do not have the plan.
+ */
+char *
+cdbdisp_getPlanQueryText(CdbDispatcherState *ds, int *len)
+{
+	DispatchCommandQueryParms *pQueryParms = ds->planQueryParms;
 
-	return pQueryParms;
+	Assert(pQueryParms != NULL);
+
+	if (ds->planText == NULL)
+	{
+		cdbdisp_serializePlan(pQueryParms);
+		ds->planText = buildGpQueryString(pQueryParms, &ds->planTextLen);
+
+		pfree(pQueryParms->serializedPlantree);
+		pQueryParms->serializedPlantree = NULL;
+		pQueryParms->serializedPlantreelen = 0;
+	}
+
+	*len = ds->planTextLen;
+	return ds->planText;
+}
+
+/*
+ * Do all the QEs the plan is dispatched to have it in their plan cache?
+ */
+static bool
+planCachedOnAllQEs(CdbDispatcherState *ds, SliceVec *sliceVector, int nSlices)
+{
+	int			iSlice;
+	int			i;
+
+	for (iSlice = 0; iSlice < nSlices; iSlice++)
+	{
+		ExecSlice  *slice = sliceVector[iSlice].slice;
+		Gang	   *gang = slice->primaryGang;
+
+		if (slice->gangType == GANGTYPE_UNALLOCATED)
+			continue;
+
+		Assert(gang != NULL);
+		for (i = 0; i < gang->size; i++)
+		{
+			if (!SegmentPlanCacheHasPlan(gang->db_descriptors[i],
+										 ds->planCacheKey, ds->planCacheEpoch))
+				return false;
+		}
+	}
+
+	return true;
 }
 
 /*
@@ -858,6 +949,9 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	int			sddesc_len = pQueryParms->serializedQueryDispatchDesclen;
 	const char *dtxContextInfo = pQueryParms->serializedDtxContextInfo;
 	int			dtxContextInfo_len = pQueryParms->serializedDtxContextInfolen;
+	uint64		planCacheKey = pQueryParms->planCacheKey;
+	uint32		planCacheEpoch = pQueryParms->planCacheEpoch;
+	uint64		planQueryMem = pQueryParms->planQueryMem;
 	int64		currentStatementStartTimestamp = GetCurrentStatementStartTimestamp();
 	Oid			sessionUserId = GetSessionUserId();
 	Oid			outerUserId = GetOuterUserId();
@@ -890,7 +984,7 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	 * character.
 	 */
 	command_len = strlen(command) + 1;
-	if (plantree && command_len > QUERY_STRING_TRUNCATE_SIZE)
+	if ((plantree || planCacheKey) && command_len > QUERY_STRING_TRUNCATE_SIZE)
 		command_len = pg_mbcliplen(command, command_len,
 								   QUERY_STRING_TRUNCATE_SIZE-1) + 1;
 
@@ -909,6 +1003,9 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 		sizeof(plantree_len) +
 		sizeof(sddesc_len) +
 		sizeof(dtxContextInfo_len) +
+		sizeof(n32) * 2 /* planCacheKey */ +
+		sizeof(planCacheEpoch) +
+		sizeof(n32) * 2 /* planQueryMem */ +
 		dtxContextInfo_len +
 		command_len +
 		plantree_len +
@@ -973,6 +1070,26 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	memcpy(pos, &tmp, sizeof(tmp));
 	pos += sizeof(tmp);
 
+	n32 = htonl((uint32) (planCacheKey >> 32));
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
+	n32 = htonl((uint32) planCacheKey);
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
+	n32 = htonl(planCacheEpoch);
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
+	n32 = htonl((uint32) (planQueryMem >> 32));
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
+	n32 = htonl((uint32) planQueryMem);
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
 	if (dtxContextInfo_len > 0)
 	{
 		memcpy(pos, dtxContextInfo, dtxContextInfo_len);
@@ -1033,6 +1150,7 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
  */
 static void
 cdbdisp_dispatchX(QueryDesc* queryDesc,
+					uint64 planCacheKey,
 					bool planRequiresTxn,
 					bool cancelOnError)
 {
@@ -1082,8 +1200,28 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	/* Each slice table has a unique-id. */
 	sliceTbl->ic_instance_id = ++gp_interconnect_id;
 
-	pQueryParms = cdbdisp_buildPlanQueryParms(queryDesc, planRequiresTxn);
-	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	pQueryParms = cdbdisp_buildPlanQueryParms(queryDesc, planCacheKey, planRequiresTxn);
+	ds->planQueryParms = pQueryParms;
+
+	/*
+	 * If the plan is cached on the QEs, build the message that refers to it
+	 * by its key, for the QEs known to have it. The plan itself is not even
+	 * serialized if all the QEs have it.
+	 */
+	if (pQueryParms->planCacheKey != 0)
+	{
+		ds->planRefText = buildGpQueryString(pQueryParms, &ds->planRefTextLen);
+		ds->planCacheKey = pQueryParms->planCacheKey;
+		ds->planCacheEpoch = pQueryParms->planCacheEpoch;
+	}
+
+	if (ds->planCacheKey != 0 && planCachedOnAllQEs(ds, sliceVector, nSlices))
+	{
+		queryText = ds->planRefText;
+		queryTextLength = ds->planRefTextLen;
+	}
+	else
+		queryText = cdbdisp_getPlanQueryText(ds, &queryTextLength);
 
 	/*
 	 * Allocate result array with enough slots for QEs of primary gangs.
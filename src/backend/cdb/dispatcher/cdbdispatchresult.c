@@ -210,6 +210,7 @@ cdbdisp_resetResult(CdbDispatchResult *dispatchResult)
 	dispatchResult->hasDispatched = false;
 	dispatchResult->stillRunning = false;
 	dispatchResult->receivedAckMsg = false;
+	dispatchResult->planCacheMiss = false;
 	dispatchResult->sentSignal = DISPATCH_WAIT_NONE;
 	dispatchResult->wasCanceled = false;
 
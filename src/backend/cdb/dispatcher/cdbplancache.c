@@ -0,0 +1,405 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbplancache.c
+ *	  Session-level cache of dispatched plans on the QEs.
+ *
+ * A plan of a CachedPlan, the plan of a prepared statement, is identified by
+ * a key made of the CachedPlan's dispatchId and the position of the
+ * statement in it. The dispatchId is unique in the session, and a CachedPlan
+ * gets a new one whenever it is rebuilt, so the key never refers to a stale
+ * plan. When the QD dispatches a plan it has dispatched recently, it sends
+ * the key along with the plan, and the QEs keep the deserialized plan. From
+ * then on, the QEs known to have the plan only get the key and the
+ * QueryDispatchDesc, which holds the parameters and the slice table. If all
+ * the QEs of a statement have the plan, the QD does not even serialize it.
+ * That saves the serialization, the transfer, the decompression and the
+ * deserialization of the plan on every execution of a prepared statement.
+ *
+ * Apart from query_mem, which is sent in the message, a plan must be sent
+ * exactly as it is in the CachedPlan. CdbDispatchPlan() does not cache the
+ * plans in which it evaluated functions for this execution.
+ *
+ * The QD keeps track of the plans each QE has in its
+ * SegmentDatabaseDescriptor. The QEs never evict a plan on their own:
+ * every message carries the QD's cache epoch, and a QE drops all of its
+ * plans when the epoch changes. The QD advances the epoch on the same
+ * invalidation events that invalidate its own cached plans, and when a QE
+ * has been sent gp_segment_plan_cache_size plans.
+ *
+ * If a QE reports an error, the QD forgets the plans of that QE, as the
+ * error might have been raised before the plan was stored. If a QE is sent
+ * a key it does not have all the same, it answers with a plan cache miss
+ * instead of running the statement, and the QD sends it the whole plan, see
+ * QEPlanCacheReportMiss().
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/dispatcher/cdbplancache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "libpq-fe.h"
+#include "libpq-int.h"
+#include "cdb/cdbconn.h"
+#include "cdb/cdbplancache.h"
+#include "cdb/cdbvars.h"
+#include "libpq/pqformat.h"
+#include "tcop/pquery.h"
+#include "utils/faultinjector.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/memutils.h"
+#include "utils/plancache.h"
+#include "utils/syscache.h"
+
+/*
+ * Keys of the plans dispatched recently, a plan is only cached on the QEs
+ * when it is dispatched again.
+ */
+#define RECENT_PLANS_SIZE	256
+
+static uint64 recentPlans[RECENT_PLANS_SIZE];
+
+/* QD side, epoch 0 is never used so that new QEs always start afresh */
+static uint32 planCacheEpoch = 1;
+static List *cachedPlanRelids = NIL;
+static List *cachedPlanInvalItems = NIL;
+
+/* QE side */
+typedef struct QEPlanCacheEntry
+{
+	uint64		key;			/* hash key, must be first */
+	PlannedStmt *plan;
+} QEPlanCacheEntry;
+
+static MemoryContext QEPlanCacheContext = NULL;
+static HTAB *QEPlanCache = NULL;
+static uint32 QEPlanCacheEpoch = 0;
+
+static void SegmentPlanCacheRelCallback(Datum arg, Oid relid);
+static void SegmentPlanCacheObjectCallback(Datum arg, int cacheid, uint32 hashvalue);
+static void SegmentPlanCacheSysCallback(Datum arg, int cacheid, uint32 hashvalue);
+
+/*
+ * InitSegmentPlanCache: register the invalidation callbacks, mirroring
+ * InitPlanCache().
+ */
+void
+InitSegmentPlanCache(void)
+{
+	CacheRegisterRelcacheCallback(SegmentPlanCacheRelCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(PROCOID, SegmentPlanCacheObjectCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(TYPEOID, SegmentPlanCacheObjectCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(NAMESPACEOID, SegmentPlanCacheSysCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(OPEROID, SegmentPlanCacheSysCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(AMOPOPID, SegmentPlanCacheSysCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(FOREIGNSERVEROID, SegmentPlanCacheSysCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(FOREIGNDATAWRAPPEROID, SegmentPlanCacheSysCallback, (Datum) 0);
+}
+
+/*
+ * Make all QEs drop their cached plans at the next dispatch.
+ */
+static void
+advance_epoch(void)
+{
+	if (++planCacheEpoch == 0)
+		planCacheEpoch = 1;
+
+	list_free(cachedPlanRelids);
+	cachedPlanRelids = NIL;
+	list_free_deep(cachedPlanInvalItems);
+	cachedPlanInvalItems = NIL;
+}
+
+static void
+SegmentPlanCacheRelCallback(Datum arg, Oid relid)
+{
+	if (!OidIsValid(relid) || list_member_oid(cachedPlanRelids, relid))
+		advance_epoch();
+}
+
+static void
+SegmentPlanCacheObjectCallback(Datum arg, int cacheid, uint32 hashvalue)
+{
+	ListCell   *lc;
+
+	foreach(lc, cachedPlanInvalItems)
+	{
+		PlanInvalItem *item = (PlanInvalItem *) lfirst(lc);
+
+		if (item->cacheId == cacheid &&
+			(hashvalue == 0 || item->hashValue == hashvalue))
+		{
+			advance_epoch();
+			return;
+		}
+	}
+}
+
+static void
+SegmentPlanCacheSysCallback(Datum arg, int cacheid, uint32 hashvalue)
+{
+	advance_epoch();
+}
+
+/*
+ * SegmentPlanCacheKey
+ *
+ * Return the key of a plan to dispatch, or 0 if the plan should not be
+ * cached on the QEs. Only the plans of the CachedPlan of the active portal
+ * are cached.
+ */
+uint64
+SegmentPlanCacheKey(PlannedStmt *stmt)
+{
+	CachedPlan *cplan;
+	uint64		key;
+	uint64	   *slot;
+	int			stmtno = 0;
+	MemoryContext oldcontext;
+	ListCell   *lc;
+
+	if (gp_segment_plan_cache_size <= 0 ||
+		ActivePortal == NULL || ActivePortal->cplan == NULL)
+		return 0;
+
+	cplan = ActivePortal->cplan;
+	foreach(lc, cplan->stmt_list)
+	{
+		if (lfirst(lc) == stmt)
+			break;
+		stmtno++;
+	}
+	if (lc == NULL || stmtno > PG_UINT8_MAX)
+		return 0;
+
+	key = (cplan->dispatchId << 8) | (uint64) stmtno;
+
+	/* Only cache the plans seen twice */
+	slot = &recentPlans[key % RECENT_PLANS_SIZE];
+	if (*slot != key)
+	{
+		*slot = key;
+		return 0;
+	}
+
+	/* Remember what the plan depends on, for the invalidation callbacks */
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	foreach(lc, stmt->relationOids)
+		cachedPlanRelids = list_append_unique_oid(cachedPlanRelids, lfirst_oid(lc));
+	foreach(lc, stmt->invalItems)
+	{
+		PlanInvalItem *item = (PlanInvalItem *) lfirst(lc);
+		ListCell   *lc2;
+
+		foreach(lc2, cachedPlanInvalItems)
+		{
+			PlanInvalItem *other = (PlanInvalItem *) lfirst(lc2);
+
+			if (other->cacheId == item->cacheId &&
+				other->hashValue == item->hashValue)
+				break;
+		}
+		if (lc2 == NULL)
+			cachedPlanInvalItems = lappend(cachedPlanInvalItems,
+										   copyObject(item));
+	}
+	MemoryContextSwitchTo(oldcontext);
+
+	return key;
+}
+
+uint32
+SegmentPlanCacheEpoch(void)
+{
+	return planCacheEpoch;
+}
+
+/*
+ * SegmentPlanCacheHasPlan
+ *
+ * Is the plan cached on the QE, as of the epoch of the message about to be
+ * dispatched?
+ */
+bool
+SegmentPlanCacheHasPlan(SegmentDatabaseDescriptor *segdbDesc,
+						uint64 key, uint32 epoch)
+{
+	int			i;
+
+	if (segdbDesc->planCacheEpoch != epoch)
+		return false;
+
+	for (i = 0; i < segdbDesc->numCachedPlans; i++)
+	{
+		if (segdbDesc->cachedPlans[i] == key)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * SegmentPlanCacheRemember
+ *
+ * Note that a plan has been sent to the QE, which will keep it.
+ */
+void
+SegmentPlanCacheRemember(SegmentDatabaseDescriptor *segdbDesc,
+						 uint64 key, uint32 epoch)
+{
+	if (segdbDesc->planCacheEpoch != epoch)
+	{
+		/* The QE drops its plans upon receiving the new epoch */
+		if (segdbDesc->maxCachedPlans != gp_segment_plan_cache_size)
+		{
+			if (segdbDesc->cachedPlans)
+				pfree(segdbDesc->cachedPlans);
+			segdbDesc->maxCachedPlans = Max(gp_segment_plan_cache_size, 1);
+			segdbDesc->cachedPlans = (uint64 *)
+				MemoryContextAlloc(GetMemoryChunkContext(segdbDesc),
+								   segdbDesc->maxCachedPlans * sizeof(uint64));
+		}
+		segdbDesc->planCacheEpoch = epoch;
+		segdbDesc->numCachedPlans = 0;
+		segdbDesc->numPlansSent = 0;
+	}
+
+	if (segdbDesc->numCachedPlans < segdbDesc->maxCachedPlans)
+		segdbDesc->cachedPlans[segdbDesc->numCachedPlans++] = key;
+
+	/* Once the QE is full, have all QEs start over at the next dispatch */
+	if (++segdbDesc->numPlansSent >= segdbDesc->maxCachedPlans &&
+		epoch == planCacheEpoch)
+		advance_epoch();
+}
+
+/*
+ * SegmentPlanCacheForget
+ *
+ * Forget the plans of a QE which reported an error or a plan cache miss. The
+ * QE may still have them, they are simply sent again.
+ */
+void
+SegmentPlanCacheForget(SegmentDatabaseDescriptor *segdbDesc)
+{
+	segdbDesc->numCachedPlans = 0;
+}
+
+static void
+qe_plancache_check_epoch(uint32 epoch)
+{
+	HASHCTL		ctl;
+
+	if (QEPlanCache != NULL && epoch == QEPlanCacheEpoch)
+		return;
+
+	if (QEPlanCacheContext == NULL)
+		QEPlanCacheContext = AllocSetContextCreate(TopMemoryContext,
+												   "QE plan cache",
+												   ALLOCSET_DEFAULT_SIZES);
+	else
+		MemoryContextReset(QEPlanCacheContext);
+	QEPlanCache = NULL;
+
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(uint64);
+	ctl.entrysize = sizeof(QEPlanCacheEntry);
+	ctl.hcxt = QEPlanCacheContext;
+	QEPlanCache = hash_create("QE plan cache", 64, &ctl,
+							  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	QEPlanCacheEpoch = epoch;
+}
+
+/*
+ * QEPlanCacheHasPlan
+ *
+ * Does the QE have the plan, as of the epoch of the message received?
+ */
+bool
+QEPlanCacheHasPlan(uint64 key, uint32 epoch)
+{
+#ifdef FAULT_INJECTOR
+	/* Lose the plans, to test the misses */
+	if (SIMPLE_FAULT_INJECTOR("qe_plan_cache_lost") == FaultInjectorTypeSkip)
+		QEPlanCache = NULL;
+#endif
+
+	qe_plancache_check_epoch(epoch);
+
+	return hash_search(QEPlanCache, &key, HASH_FIND, NULL) != NULL;
+}
+
+/*
+ * QEPlanCacheReportMiss
+ *
+ * Tell the QD that the QE does not have a plan it was sent the key of. The
+ * QE then returns to the QD without running anything, and the QD sends the
+ * whole plan in the same statement, see cdbdisp_async.c.
+ */
+void
+QEPlanCacheReportMiss(uint64 key)
+{
+	StringInfoData buf;
+
+	pq_beginmessage(&buf, 'y');
+	pq_sendstring(&buf, "PLANCACHE");
+	pq_sendbyte(&buf, true);	/* Mark the result ready when receive this message */
+	pq_sendint(&buf, PGExtraTypePlanCacheMiss, sizeof(PGExtraType));
+	pq_sendint(&buf, sizeof(key), sizeof(int));
+	pq_sendbytes(&buf, (char *) &key, sizeof(key));
+	pq_endmessage(&buf);
+}
+
+/*
+ * QEPlanCacheLookup
+ *
+ * Return a copy of a cached plan, in the current memory context, or NULL if
+ * the QE does not have it.
+ */
+PlannedStmt *
+QEPlanCacheLookup(uint64 key, uint32 epoch)
+{
+	QEPlanCacheEntry *entry;
+
+	qe_plancache_check_epoch(epoch);
+
+	entry = (QEPlanCacheEntry *) hash_search(QEPlanCache, &key,
+											 HASH_FIND, NULL);
+	if (entry == NULL)
+		return NULL;
+
+	return copyObject(entry->plan);
+}
+
+/*
+ * QEPlanCacheStore
+ *
+ * Keep a copy of a plan received from the QD.
+ */
+void
+QEPlanCacheStore(uint64 key, uint32 epoch, PlannedStmt *plan)
+{
+	QEPlanCacheEntry *entry;
+	PlannedStmt *copy;
+	MemoryContext oldcontext;
+	bool		found;
+
+	qe_plancache_check_epoch(epoch);
+
+	if (hash_search(QEPlanCache, &key, HASH_FIND, NULL) != NULL)
+		return;
+
+	oldcontext = MemoryContextSwitchTo(QEPlanCacheContext);
+	copy = copyObject(plan);
+	MemoryContextSwitchTo(oldcontext);
+
+	entry = (QEPlanCacheEntry *) hash_search(QEPlanCache, &key,
+											 HASH_ENTER, &found);
+	entry->plan = copy;
+}
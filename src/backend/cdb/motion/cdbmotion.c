@@ -348,6 +348,27 @@ SendStopMessage(MotionLayerState *mlStates,
 		CurrentMotionIPCLayer->SendStopMessage(transportStates, motNodeID);
 }
 
+/*
+ * Report the compressed tuples a motion node received so far, for EXPLAIN
+ * ANALYZE.
+ */
+void
+ExplainMotionCompression(MotionLayerState *mlStates, int16 motNodeID,
+						 struct StringInfoData *buf)
+{
+	MotionNodeEntry *pEntry = getMotionNodeEntry(mlStates, motNodeID);
+	SerTupInfo *pSerInfo = &pEntry->ser_tup_info;
+
+	if (pSerInfo->stat_decompressed_tuples == 0)
+		return;
+
+	appendStringInfo(buf, "Decompressed " UINT64_FORMAT " tuples received, "
+					 "from " UINT64_FORMAT " to " UINT64_FORMAT " bytes.",
+					 pSerInfo->stat_decompressed_tuples,
+					 pSerInfo->stat_decompress_bytes,
+					 pSerInfo->stat_decompressed_raw_bytes);
+}
+
 void
 CheckAndSendRecordCache(MotionLayerState *mlStates,
 						ChunkTransportState *transportStates,
@@ -828,6 +849,17 @@ EndMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool flushCommLa
 				 pMNEntry->stat_total_chunks_sent
 				);
 		}
+		if (pMNEntry->ser_tup_info.stat_compressed_tuples > 0)
+		{
+			elog(LOG, "Interconnect seg%d slice%d compressed " UINT64_FORMAT " tuples, "
+				 "from " UINT64_FORMAT " to " UINT64_FORMAT " tuple bytes.",
+				 GpIdentity.segindex,
+				 currentSliceId,
+				 pMNEntry->ser_tup_info.stat_compressed_tuples,
+				 pMNEntry->ser_tup_info.stat_compress_raw_bytes,
+				 pMNEntry->ser_tup_info.stat_compressed_bytes
+				);
+		}
 		if (pMNEntry->stat_total_bytes_recvd > 0)
 		{
 			elog(LOG, "Interconnect seg%d slice%d received from slice%d: " UINT64_FORMAT " tuples, "
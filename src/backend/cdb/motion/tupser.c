@@ -24,6 +24,7 @@
 #include "cdb/cdbsrlz.h"
 #include "cdb/tupser.h"
 #include "cdb/cdbvars.h"
+#include "common/pg_lzcompress.h"
 #include "libpq/pqformat.h"
 #include "storage/smgr.h"
 #include "utils/acl.h"
@@ -34,12 +35,46 @@
 #include "utils/syscache.h"
 #include "utils/typcache.h"
 
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
 /*
  * Transient record types table is sent to upsteam via a specially constructed
  * chunk, with a special "tuple length".
  */
 #define RECORD_CACHE_MAGIC_TUPLEN	-1
 
+/*
+ * A compressed tuple body is sent with a special "tuple length" too. It is
+ * followed by the compression method and the uncompressed length, and then
+ * the compressed data. So the receiver can decompress the tuples of any
+ * motion, whatever its own setting of gp_interconnect_compression.
+ */
+#define COMPRESSED_TUPLE_MAGIC_TUPLEN	-2
+#define COMPRESSED_TUPLE_HEADER_LEN		(3 * sizeof(int32))
+
+/* Tuples shorter than this are not worth compressing */
+#define COMPRESS_MIN_TUPLE_LEN		128
+
+/*
+ * A motion tries to compress COMPRESS_PROBE_TUPLES tuples at a time. If they
+ * don't shrink to gp_interconnect_compression_ratio of their size together,
+ * it sends the next tuples as is, for twice as many tuples each time, up to
+ * COMPRESS_MAX_BACKOFF.
+ */
+#define COMPRESS_PROBE_TUPLES		64
+#define COMPRESS_MAX_BACKOFF		8192
+
+#ifdef USE_ZSTD
+/* zstd contexts, kept for the life of the backend */
+static ZSTD_CCtx *s_zstdCCtx = NULL;
+static ZSTD_DCtx *s_zstdDCtx = NULL;
+#endif
+
 /* A MemoryContext used within the tuple serialize code, so that freeing of
  * space is SUPAFAST.  It is initialized in the first call to InitSerTupInfo()
  * since that must be called before any tuple serialization or deserialization
@@ -105,6 +140,9 @@ InitSerTupInfo(TupleDesc tupdesc, SerTupInfo *pSerInfo)
 
 	pSerInfo->has_record_types = false;
 
+	pSerInfo->compress_method = Gp_interconnect_compression;
+	pSerInfo->compress_ratio = Gp_interconnect_compression_ratio;
+
 	/*
 	 * If we have some attributes, go ahead and prepare the information for
 	 * each attribute in the descriptor.  Otherwise, we can return right away.
@@ -188,6 +226,10 @@ CleanupSerTupInfo(SerTupInfo *pSerInfo)
 		pfree(pSerInfo->nulls);
 	pSerInfo->nulls = NULL;
 
+	if (pSerInfo->compress_buf != NULL)
+		pfree(pSerInfo->compress_buf);
+	pSerInfo->compress_buf = NULL;
+
 	pSerInfo->tupdesc = NULL;
 
 	while (pSerInfo->chunkCache.items != NULL)
@@ -350,6 +392,170 @@ SerializeRecordCacheIntoChunks(SerTupInfo *pSerInfo,
 	return;
 }
 
+/*
+ * Try to compress a tuple body into pSerInfo->compress_buf.
+ *
+ * Returns the compressed length, or 0 if the tuple is better sent as is.
+ */
+static int
+compressTupleBody(SerTupInfo *pSerInfo, const char *body, int len)
+{
+	int			clen = 0;
+	int			maxlen;
+
+	if (len < COMPRESS_MIN_TUPLE_LEN)
+		return 0;
+
+	if (pSerInfo->compress_skip > 0)
+	{
+		pSerInfo->compress_skip--;
+		return 0;
+	}
+
+	/* The result must make up for the longer header */
+	maxlen = len - (COMPRESSED_TUPLE_HEADER_LEN - sizeof(int32)) - 1;
+
+	/*
+	 * pglz needs room for its worst case. The buffer lives in the motion
+	 * layer memory context, like the rest of the SerTupInfo.
+	 */
+	if (pSerInfo->compress_buf_size < PGLZ_MAX_OUTPUT(len))
+	{
+		if (pSerInfo->compress_buf != NULL)
+			pfree(pSerInfo->compress_buf);
+		pSerInfo->compress_buf_size = Max(PGLZ_MAX_OUTPUT(len), BLCKSZ);
+		pSerInfo->compress_buf = palloc(pSerInfo->compress_buf_size);
+	}
+
+	switch (pSerInfo->compress_method)
+	{
+		case INTERCONNECT_COMPRESSION_PGLZ:
+			clen = pglz_compress(body, len, pSerInfo->compress_buf,
+								 PGLZ_strategy_default);
+			break;
+
+		case INTERCONNECT_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			clen = LZ4_compress_default(body, pSerInfo->compress_buf,
+										len, maxlen);
+#endif
+			break;
+
+		case INTERCONNECT_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			{
+				size_t		ret;
+
+				if (s_zstdCCtx == NULL)
+				{
+					s_zstdCCtx = ZSTD_createCCtx();
+					if (s_zstdCCtx == NULL)
+						ereport(ERROR,
+								(errcode(ERRCODE_OUT_OF_MEMORY),
+								 errmsg("out of memory"),
+								 errdetail("Failed to create zstd compression context.")));
+				}
+
+				ret = ZSTD_compressCCtx(s_zstdCCtx, pSerInfo->compress_buf,
+										maxlen, body, len, 1);
+				clen = ZSTD_isError(ret) ? 0 : (int) ret;
+			}
+#endif
+			break;
+	}
+
+	if (clen <= 0 || clen > maxlen)
+		clen = 0;
+
+	/* Keep compressing only if it pays off */
+	pSerInfo->compress_probes++;
+	pSerInfo->compress_probe_raw_bytes += len;
+	pSerInfo->compress_probe_bytes += (clen > 0 ? clen : len);
+
+	if (pSerInfo->compress_probes >= COMPRESS_PROBE_TUPLES)
+	{
+		if (pSerInfo->compress_probe_bytes >
+			pSerInfo->compress_probe_raw_bytes * pSerInfo->compress_ratio)
+		{
+			if (pSerInfo->compress_backoff == 0)
+				pSerInfo->compress_backoff = COMPRESS_PROBE_TUPLES;
+			else
+				pSerInfo->compress_backoff = Min(pSerInfo->compress_backoff * 2,
+												 COMPRESS_MAX_BACKOFF);
+			pSerInfo->compress_skip = pSerInfo->compress_backoff;
+		}
+		else
+			pSerInfo->compress_backoff = 0;
+
+		pSerInfo->compress_probes = 0;
+		pSerInfo->compress_probe_raw_bytes = 0;
+		pSerInfo->compress_probe_bytes = 0;
+	}
+
+	if (clen > 0)
+	{
+		pSerInfo->stat_compressed_tuples++;
+		pSerInfo->stat_compress_raw_bytes += len;
+		pSerInfo->stat_compressed_bytes += clen;
+	}
+
+	return clen;
+}
+
+/*
+ * Decompress a tuple body compressed by compressTupleBody().
+ */
+static void
+decompressTupleBody(int method, const char *src, int srclen, char *dst, int rawlen)
+{
+	int			len = -1;
+
+	switch (method)
+	{
+		case INTERCONNECT_COMPRESSION_PGLZ:
+			len = pglz_decompress(src, srclen, dst, rawlen, true);
+			break;
+
+#ifdef USE_LZ4
+		case INTERCONNECT_COMPRESSION_LZ4:
+			len = LZ4_decompress_safe(src, dst, srclen, rawlen);
+			break;
+#endif
+
+#ifdef USE_ZSTD
+		case INTERCONNECT_COMPRESSION_ZSTD:
+			{
+				size_t		ret;
+
+				if (s_zstdDCtx == NULL)
+				{
+					s_zstdDCtx = ZSTD_createDCtx();
+					if (s_zstdDCtx == NULL)
+						ereport(ERROR,
+								(errcode(ERRCODE_OUT_OF_MEMORY),
+								 errmsg("out of memory"),
+								 errdetail("Failed to create zstd decompression context.")));
+				}
+
+				ret = ZSTD_decompressDCtx(s_zstdDCtx, dst, rawlen, src, srclen);
+				len = ZSTD_isError(ret) ? -1 : (int) ret;
+			}
+			break;
+#endif
+
+		default:
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("unsupported compression method %d in tuple received from motion",
+							method)));
+	}
+
+	if (len != rawlen)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("could not decompress tuple received from motion")));
+}
+
 static bool
 CandidateForSerializeDirect(int16 targetRoute, struct directTransportBuffer *b)
 {
@@ -380,6 +586,10 @@ SerializeTuple(TupleTableSlot *slot, SerTupInfo *pSerInfo, struct directTranspor
 	unsigned int       tupbodylen;
 	unsigned int       tuplen;
 	bool               hasExternalAttr = false;
+	int32              header[3];
+	int                headerlen;
+	char               *payload;
+	int                payloadlen;
 
 	AssertArg(pSerInfo != NULL);
 	AssertArg(b != NULL);
@@ -462,8 +672,28 @@ SerializeTuple(TupleTableSlot *slot, SerTupInfo *pSerInfo, struct directTranspor
 	tupbody = (char *) mintuple + MINIMAL_TUPLE_DATA_OFFSET;
 	tupbodylen = mintuple->t_len - MINIMAL_TUPLE_DATA_OFFSET;
 
+	header[0] = tupbodylen;
+	headerlen = sizeof(int32);
+	payload = tupbody;
+	payloadlen = tupbodylen;
+
+	if (pSerInfo->compress_method != INTERCONNECT_COMPRESSION_NONE)
+	{
+		int			clen = compressTupleBody(pSerInfo, tupbody, tupbodylen);
+
+		if (clen > 0)
+		{
+			header[0] = COMPRESSED_TUPLE_MAGIC_TUPLEN;
+			header[1] = pSerInfo->compress_method;
+			header[2] = tupbodylen;
+			headerlen = COMPRESSED_TUPLE_HEADER_LEN;
+			payload = pSerInfo->compress_buf;
+			payloadlen = clen;
+		}
+	}
+
 	/* total on-wire footprint: */
-	tuplen = tupbodylen + sizeof(int);
+	tuplen = payloadlen + headerlen;
 
 	if (CandidateForSerializeDirect(targetRoute, b) &&
 		tuplen + TUPLE_CHUNK_HEADER_SIZE <= b->prilen)
@@ -471,8 +701,8 @@ SerializeTuple(TupleTableSlot *slot, SerTupInfo *pSerInfo, struct directTranspor
 		/*
 		 * The tuple fits in the direct transport buffer.
 		 */
-		memcpy(b->pri + TUPLE_CHUNK_HEADER_SIZE, &tupbodylen, sizeof(tupbodylen));
-		memcpy(b->pri + TUPLE_CHUNK_HEADER_SIZE + sizeof(int), tupbody, tupbodylen);
+		memcpy(b->pri + TUPLE_CHUNK_HEADER_SIZE, header, headerlen);
+		memcpy(b->pri + TUPLE_CHUNK_HEADER_SIZE + headerlen, payload, payloadlen);
 
 		dataSize += tuplen;
 
@@ -495,8 +725,8 @@ SerializeTuple(TupleTableSlot *slot, SerTupInfo *pSerInfo, struct directTranspor
 
 	AssertState(s_tupSerMemCtxt != NULL);
 
-	addByteStringToChunkList(tcList, (char *) &tupbodylen, sizeof(tupbodylen), &pSerInfo->chunkCache);
-	addByteStringToChunkList(tcList, tupbody, tupbodylen, &pSerInfo->chunkCache);
+	addByteStringToChunkList(tcList, (char *) header, headerlen, &pSerInfo->chunkCache);
+	addByteStringToChunkList(tcList, payload, payloadlen, &pSerInfo->chunkCache);
 
 	/*
 	 * GPDB_12_MERGE_FIXME: This function does not use this context. This context
@@ -695,6 +925,34 @@ CvtChunksToTup(TupleChunkList tcList, SerTupInfo *pSerInfo, TupleRemapper *remap
 
 			return NULL;
 		}
+		else if (tupbodylen == COMPRESSED_TUPLE_MAGIC_TUPLEN)
+		{
+			/* A compressed MinimalTuple */
+			int32		method;
+			int32		rawlen;
+			int			clen = serData.len - COMPRESSED_TUPLE_HEADER_LEN;
+
+			memcpy(&method, pos, sizeof(method));
+			pos += sizeof(method);
+			memcpy(&rawlen, pos, sizeof(rawlen));
+			pos += sizeof(rawlen);
+
+			if (rawlen < 0 || rawlen > MaxAllocSize - MINIMAL_TUPLE_DATA_OFFSET ||
+				clen <= 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_PROTOCOL_VIOLATION),
+						 errmsg("invalid compressed tuple received from motion")));
+
+			tup = palloc(rawlen + MINIMAL_TUPLE_DATA_OFFSET);
+			tup->t_len = rawlen + MINIMAL_TUPLE_DATA_OFFSET;
+
+			decompressTupleBody(method, pos, clen,
+								(char *) tup + MINIMAL_TUPLE_DATA_OFFSET, rawlen);
+
+			pSerInfo->stat_decompressed_tuples++;
+			pSerInfo->stat_decompress_bytes += clen;
+			pSerInfo->stat_decompressed_raw_bytes += rawlen;
+		}
 		else
 		{
 			/* A normal MinimalTuple */
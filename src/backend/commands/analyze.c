@@ -125,6 +125,7 @@
 #include "catalog/pg_am.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbaocsam.h"
+#include "cdb/cdbcardfeedback.h"
 #include "cdb/cdbdisp_query.h"
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbtm.h"
@@ -1111,6 +1112,9 @@ do_analyze_rel(Relation onerel, VacuumParams *params,
 							false /* isVacuum */);
 	}
 
+	/* The actual rows observed for plans on the relation may be stale now. */
+	CardFeedbackInvalidateRel(RelationGetRelid(onerel));
+
 	/*
 	 * Now report ANALYZE to the stats collector.  For regular tables, we do
 	 * it only if not doing inherited stats.  For partitioned tables, we only
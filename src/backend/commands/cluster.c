@@ -65,6 +65,7 @@
 #include "utils/tuplesort.h"
 
 #include "catalog/aocatalog.h"
+#include "catalog/gp_zstd_dictionary.h"
 #include "catalog/oid_dispatch.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbdisp_query.h"
@@ -1305,6 +1306,7 @@ swap_relation_files(Oid r1, Oid r2, bool target_is_pg_class,
 	}
 
 	SwapAppendonlyEntries(r1, r2);
+	SwapZstdDictionaries(r1, r2);
 
 	/*
 	 * Update the tuples in pg_class --- unless the target relation of the
@@ -27,10 +27,12 @@
 
 #include "access/heapam.h"
 #include "access/htup_details.h"
+#include "access/parallel.h"
 #include "access/tableam.h"
 #include "access/xact.h"
 #include "access/xlog.h"
 #include "catalog/namespace.h"
+#include "catalog/pg_proc.h"
 #include "cdb/cdbaocsam.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbvars.h"
@@ -46,11 +48,14 @@
 #include "libpq/libpq.h"
 #include "libpq/pqformat.h"
 #include "miscadmin.h"
+#include "nodes/makefuncs.h"
 #include "optimizer/optimizer.h"
 #include "pgstat.h"
 #include "rewrite/rewriteHandler.h"
 #include "storage/fd.h"
+#include "storage/shm_mq.h"
 #include "tcop/tcopprot.h"
+#include "utils/faultinjector.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/portal.h"
@@ -173,6 +178,68 @@ typedef struct
 */
 #define SizeOfCopyFromDispatchError (offsetof(copy_from_dispatch_error, line_len) + sizeof(uint32))
 
+/*
+ * With gp_copy_from_parallel_workers set, the QD backend (the leader) only
+ * reads the input lines, and hands them out in batches to parallel workers.
+ * The workers parse the fields needed to find the target segment of each
+ * row, and pass the 'copy_from_dispatch_*' frames built for it back to the
+ * leader, which forwards them to the QEs. The frames are forwarded in the
+ * order the batches were handed out, so the QEs see the same stream as when
+ * the leader routes the rows itself.
+ */
+#define PARALLEL_KEY_COPY_SHARED		UINT64CONST(0xC000000000000001)
+#define PARALLEL_KEY_COPY_OPTIONS		UINT64CONST(0xC000000000000002)
+#define PARALLEL_KEY_COPY_ATTNAMES		UINT64CONST(0xC000000000000003)
+#define PARALLEL_KEY_COPY_LINE_QUEUE	UINT64CONST(0xC000000000000004)
+#define PARALLEL_KEY_COPY_ROW_QUEUE		UINT64CONST(0xC000000000000005)
+#define PARALLEL_KEY_QUERY_TEXT			UINT64CONST(0xC000000000000006)
+
+/* Size of a batch of lines, and of the queues to and from each worker */
+#define COPY_ROUTE_BATCH_SIZE	(64 * 1024)
+#define COPY_ROUTE_QUEUE_SIZE	(4 * COPY_ROUTE_BATCH_SIZE)
+
+typedef struct CopyFromParallelShared
+{
+	Oid			relid;
+	int			first_qe_processed_field;
+} CopyFromParallelShared;
+
+/*
+ * Each line in a batch. If reading the line failed in the leader, the
+ * error is thrown in the worker instead, so that it is handled in the order
+ * of the input. The message of that error follows the line.
+ */
+typedef struct CopyRouteLine
+{
+	int64		lineno;			/* cur_lineno after reading the line */
+	uint32		len;			/* length of the line that follows */
+	int32		sqlerrcode;		/* error reading the line, or 0 */
+} CopyRouteLine;
+
+/* Messages from a worker to the leader */
+typedef enum CopyRouteMsgKind
+{
+	COPY_ROUTE_ROW,				/* a copy_from_dispatch_row follows */
+	COPY_ROUTE_ERROR,			/* a copy_from_dispatch_error follows */
+	COPY_ROUTE_BATCH_DONE		/* all lines of the batch were processed */
+} CopyRouteMsgKind;
+
+typedef struct CopyRouteMsgHeader
+{
+	int32		kind;
+	int32		target_seg;		/* -1 to send the row to all segments */
+} CopyRouteMsgHeader;
+
+/* State of a parallel COPY worker */
+typedef struct CopyFromRouteState
+{
+	shm_mq_handle *line_mqh;	/* batches of lines from the leader */
+	shm_mq_handle *row_mqh;		/* messages to the leader */
+	char	   *batch;			/* current batch */
+	Size		batch_len;
+	Size		batch_off;		/* next line in the batch */
+} CopyFromRouteState;
+
 /* Low-level communications functions */
 static void
 SendCopyFromForwardedTuple(CopyFromState cstate,
@@ -187,6 +254,8 @@ SendCopyFromForwardedTuple(CopyFromState cstate,
 						   bool *nulls);
 static void SendCopyFromForwardedHeader(CopyFromState cstate, CdbCopy *cdbCopy);
 static void SendCopyFromForwardedError(CopyFromState cstate, CdbCopy *cdbCopy, char *errmsg);
+static void SendCopyFromForwardedErrorFrame(CopyFromState cstate, CdbCopy *cdbCopy,
+											char *frame, int len);
 
 static bool NextCopyFromDispatch(CopyFromState cstate, ExprContext *econtext,
 								 Datum *values, bool *nulls);
@@ -203,8 +272,15 @@ static void CopyInitDataParser(CopyFromState cstate);
 static GpDistributionData *InitDistributionData(CopyFromState cstate, EState *estate);
 static void FreeDistributionData(GpDistributionData *distData);
 static void InitCopyFromDispatchSplit(CopyFromState cstate, GpDistributionData *distData, EState *estate);
+static void SplitCopyFromAttnumList(CopyFromState cstate);
 static unsigned int GetTargetSeg(GpDistributionData *distData, TupleTableSlot *slot);
 
+static bool CopyFromDispatchParallel(CopyFromState cstate, CdbCopy *cdbCopy,
+									 int64 *processed);
+static bool CopyRouteNextLine(CopyFromState cstate);
+static void CopyRouteSendMessage(CopyFromState cstate, int kind, int target_seg,
+								 StringInfo msgbuf);
+
 /*
  * No more than this many tuples per CopyMultiInsertBuffer
  *
@@ -696,6 +772,7 @@ CopyFrom(CopyFromState cstate)
 
 	CdbCopy	   *cdbCopy = NULL;
 	bool		is_check_distkey;
+	bool		routed_in_parallel = false;
 	GpDistributionData *distData = NULL; /* distribution data used to compute target seg */
 
 	Assert(cstate->rel);
@@ -999,32 +1076,7 @@ CopyFrom(CopyFromState cstate)
 
 	if (cstate->dispatch_mode == COPY_DISPATCH ||
 		cstate->dispatch_mode == COPY_EXECUTOR)
-	{
-		/*
-		 * Now split the attnumlist into the parts that are parsed in the QD, and
-		 * in QE.
-		 */
-		ListCell   *lc;
-		int			i = 0;
-		List	   *qd_attnumlist = NIL;
-		List	   *qe_attnumlist = NIL;
-		int			first_qe_processed_field;
-
-		first_qe_processed_field = cstate->first_qe_processed_field;
-
-		foreach(lc, cstate->attnumlist)
-		{
-			int			attnum = lfirst_int(lc);
-
-			if (i < first_qe_processed_field)
-				qd_attnumlist = lappend_int(qd_attnumlist, attnum);
-			else
-				qe_attnumlist = lappend_int(qe_attnumlist, attnum);
-			i++;
-		}
-		cstate->qd_attnumlist = qd_attnumlist;
-		cstate->qe_attnumlist = qe_attnumlist;
-	}
+		SplitCopyFromAttnumList(cstate);
 
 	if (cstate->dispatch_mode == COPY_DISPATCH)
 	{
@@ -1094,7 +1146,14 @@ CopyFrom(CopyFromState cstate)
 	else if (RelationIsAoCols(resultRelInfo->ri_RelationDesc))
 		aoco_dml_init(resultRelInfo->ri_RelationDesc, CMD_INSERT);
 
-	for (;;)
+	/*
+	 * In the QD, hand the routing of the rows to parallel workers if we
+	 * can. Otherwise, or if no workers could be launched, route them here.
+	 */
+	if (cstate->dispatch_mode == COPY_DISPATCH)
+		routed_in_parallel = CopyFromDispatchParallel(cstate, cdbCopy, &processed);
+
+	while (!routed_in_parallel)
 	{
 		TupleTableSlot *myslot;
 		bool		skip_tuple;
@@ -2138,26 +2197,35 @@ NextCopyFromRawFieldsX(CopyFromState cstate, char ***fields, int *nfields,
 	/* only available for text or csv input */
 	Assert(!cstate->opts.binary);
 
-	/* on input just throw the header line away */
-	if (cstate->cur_lineno == 0 && cstate->opts.header_line)
+	/* In a parallel COPY worker, the leader has read the lines already. */
+	if (cstate->route)
 	{
-		cstate->cur_lineno++;
-		if (CopyReadLine(cstate))
-			return false;		/* done */
+		if (!CopyRouteNextLine(cstate))
+			return false;
 	}
+	else
+	{
+		/* on input just throw the header line away */
+		if (cstate->cur_lineno == 0 && cstate->opts.header_line)
+		{
+			cstate->cur_lineno++;
+			if (CopyReadLine(cstate))
+				return false;		/* done */
+		}
 
-	cstate->cur_lineno++;
+		cstate->cur_lineno++;
 
-	/* Actually read the line into memory here */
-	done = CopyReadLine(cstate);
+		/* Actually read the line into memory here */
+		done = CopyReadLine(cstate);
 
-	/*
-	 * EOF at start of line means we're done.  If we see EOF after some
-	 * characters, we act as though it was newline followed by EOF, ie,
-	 * process the line and then exit loop on next iteration.
-	 */
-	if (done && cstate->line_buf.len == 0)
-		return false;
+		/*
+		 * EOF at start of line means we're done.  If we see EOF after some
+		 * characters, we act as though it was newline followed by EOF, ie,
+		 * process the line and then exit loop on next iteration.
+		 */
+		if (done && cstate->line_buf.len == 0)
+			return false;
+	}
 
 	/* Parse the line into de-escaped field values */
 	if (cstate->opts.csv_mode)
@@ -2270,7 +2338,12 @@ HandleCopyError(CopyFromState cstate)
 		}
 		cstate->cdbsreh->errmsg = errormsg;
 
-		if (IS_LOG_TO_FILE(cstate->cdbsreh->logerrors))
+		if (cstate->route)
+		{
+			/* in a parallel COPY worker, the leader counts and logs it */
+			SendCopyFromForwardedError(cstate, NULL, errormsg);
+		}
+		else if (IS_LOG_TO_FILE(cstate->cdbsreh->logerrors))
 		{
 			if (Gp_role == GP_ROLE_DISPATCH && !cstate->opts.on_segment)
 			{
@@ -2294,7 +2367,8 @@ HandleCopyError(CopyFromState cstate)
 		else
 			cstate->cdbsreh->rejectcount++;
 
-		ErrorIfRejectLimitReached(cstate->cdbsreh);
+		if (!cstate->route)
+			ErrorIfRejectLimitReached(cstate->cdbsreh);
 
 		MemoryContextSwitchTo(oldcontext);
 		MemoryContextReset(cstate->cdbsreh->badrowcontext);
@@ -3048,7 +3122,10 @@ SendCopyFromForwardedTuple(CopyFromState cstate,
 	frame->fld_count = num_sent_fields;
 	frame->delim_seen_at_end = cstate->stopped_processing_at_delim;
 
-	if (toAll)
+	if (cstate->route)
+		CopyRouteSendMessage(cstate, COPY_ROUTE_ROW, toAll ? -1 : target_seg,
+							 msgbuf);
+	else if (toAll)
 		cdbCopySendDataToAll(cdbCopy, msgbuf->data, msgbuf->len);
 	else
 		cdbCopySendData(cdbCopy, target_seg, msgbuf->data, msgbuf->len);
@@ -3072,7 +3149,6 @@ SendCopyFromForwardedError(CopyFromState cstate, CdbCopy *cdbCopy, char *errorms
 {
 	copy_from_dispatch_error *errframe;
 	StringInfo	msgbuf;
-	int			target_seg;
 	int			errormsg_len = strlen(errormsg);
 
 	msgbuf = cstate->dispatch_msgbuf;
@@ -3091,13 +3167,25 @@ SendCopyFromForwardedError(CopyFromState cstate, CdbCopy *cdbCopy, char *errorms
 	errframe->line_len = cstate->line_buf.len;
 	errframe->errmsg_len = errormsg_len;
 
+	if (cstate->route)
+		CopyRouteSendMessage(cstate, COPY_ROUTE_ERROR, -1, msgbuf);
+	else
+		SendCopyFromForwardedErrorFrame(cstate, cdbCopy, msgbuf->data, msgbuf->len);
+}
+
+static void
+SendCopyFromForwardedErrorFrame(CopyFromState cstate, CdbCopy *cdbCopy,
+								char *frame, int len)
+{
+	int			target_seg;
+
 	/* send the bad data row to a random QE (via roundrobin) */
 	if (cstate->lastsegid == cdbCopy->total_segs)
 		cstate->lastsegid = 0; /* start over from first segid */
 
 	target_seg = (cstate->lastsegid++ % cdbCopy->total_segs);
 
-	cdbCopySendData(cdbCopy, target_seg, msgbuf->data, msgbuf->len);
+	cdbCopySendData(cdbCopy, target_seg, frame, len);
 }
 
 /*
@@ -3269,6 +3357,34 @@ InitCopyFromDispatchSplit(CopyFromState cstate, GpDistributionData *distData,
 	}
 }
 
+/*
+ * Split the attnumlist into the parts that are parsed in the QD, and in QE.
+ */
+static void
+SplitCopyFromAttnumList(CopyFromState cstate)
+{
+	ListCell   *lc;
+	int			i = 0;
+	List	   *qd_attnumlist = NIL;
+	List	   *qe_attnumlist = NIL;
+	int			first_qe_processed_field;
+
+	first_qe_processed_field = cstate->first_qe_processed_field;
+
+	foreach(lc, cstate->attnumlist)
+	{
+		int			attnum = lfirst_int(lc);
+
+		if (i < first_qe_processed_field)
+			qd_attnumlist = lappend_int(qd_attnumlist, attnum);
+		else
+			qe_attnumlist = lappend_int(qe_attnumlist, attnum);
+		i++;
+	}
+	cstate->qd_attnumlist = qd_attnumlist;
+	cstate->qe_attnumlist = qe_attnumlist;
+}
+
 static unsigned int
 GetTargetSeg(GpDistributionData *distData, TupleTableSlot *slot)
 {
@@ -3325,3 +3441,656 @@ GetTargetSeg(GpDistributionData *distData, TupleTableSlot *slot)
 
 	return target_seg;
 }
+
+/*
+ * Parallel routing of the rows in the QD. See the comment at
+ * CopyRouteLine for how the leader and the workers talk.
+ */
+
+/* State of the leader */
+typedef struct CopyRouteLeader
+{
+	ParallelContext *pcxt;
+	int			nworkers;		/* number of workers launched */
+	shm_mq_handle **line_mqh;	/* batches of lines to each worker */
+	shm_mq_handle **row_mqh;	/* messages from each worker */
+	StringInfoData batch;		/* batch being filled */
+	uint64		nsent;			/* number of batches handed out */
+	uint64		ndone;			/* number of batches forwarded */
+} CopyRouteLeader;
+
+/*
+ * Can the rows of this COPY be routed by parallel workers?
+ */
+static bool
+CopyFromCanRouteInParallel(CopyFromState cstate)
+{
+	ListCell   *lc;
+	int			i;
+
+	/* the workers get whole lines */
+	if (cstate->opts.binary)
+		return false;
+
+	/* the workers set up their COPY from the statement */
+	if (glob_copystmt == NULL || !glob_copystmt->is_from)
+		return false;
+
+	if (cstate->whereClause)
+		return false;
+
+	/*
+	 * The defaults are evaluated in the QD. Volatile ones, like nextval(),
+	 * must be evaluated in one process, in the order of the input.
+	 */
+	for (i = 0; i < cstate->num_defaults; i++)
+	{
+		if (contain_volatile_functions((Node *) cstate->defexprs[i]->expr))
+			return false;
+	}
+
+	/* Nor can the input functions run in a worker if they are unsafe. */
+	foreach(lc, cstate->qd_attnumlist)
+	{
+		int			attnum = lfirst_int(lc);
+
+		if (func_parallel(cstate->in_functions[attnum - 1].fn_oid) == PROPARALLEL_UNSAFE)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * A worker has detached from its queue before it was done. Wait for the
+ * error it exited with to be reported, and throw it.
+ */
+static void
+CopyRouteWorkerExited(CopyRouteLeader *leader)
+{
+	WaitForParallelWorkersToFinish(leader->pcxt);
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INTERNAL_ERROR),
+			 errmsg("parallel COPY worker exited unexpectedly")));
+}
+
+/*
+ * Read the next input line, like NextCopyFromRawFieldsX() does, and add it to
+ * the batch. Returns false if there is no more input after it.
+ *
+ * A data error reading the line is not thrown here, but added to the batch
+ * with the line, for the worker to throw in its place in the input.
+ */
+static bool
+CopyRouteReadLine(CopyFromState cstate, StringInfo batch)
+{
+	MemoryContext oldcontext = CurrentMemoryContext;
+	ErrorData  *edata = NULL;
+	volatile bool done = false;
+	volatile bool at_eof = false;
+	CopyRouteLine line;
+
+	PG_TRY();
+	{
+		/* on input just throw the header line away */
+		if (cstate->cur_lineno == 0 && cstate->opts.header_line)
+		{
+			cstate->cur_lineno++;
+			at_eof = CopyReadLine(cstate);
+		}
+
+		if (!at_eof)
+		{
+			cstate->cur_lineno++;
+			done = CopyReadLine(cstate);
+			at_eof = (done && cstate->line_buf.len == 0);
+		}
+	}
+	PG_CATCH();
+	{
+		/* SREH must only handle data errors, see HandleCopyError() */
+		if (ERRCODE_TO_CATEGORY(elog_geterrcode()) != ERRCODE_DATA_EXCEPTION)
+			PG_RE_THROW();
+
+		MemoryContextSwitchTo(oldcontext);
+		edata = CopyErrorData();
+		FlushErrorState();
+	}
+	PG_END_TRY();
+
+	if (edata == NULL && at_eof)
+		return false;
+
+	line.lineno = cstate->cur_lineno;
+	line.len = cstate->line_buf.len;
+	line.sqlerrcode = edata ? edata->sqlerrcode : 0;
+	appendBinaryStringInfo(batch, (char *) &line, sizeof(line));
+	appendBinaryStringInfo(batch, cstate->line_buf.data, cstate->line_buf.len);
+	if (edata)
+	{
+		appendBinaryStringInfo(batch, edata->message, strlen(edata->message) + 1);
+		FreeErrorData(edata);
+	}
+
+	return !done;
+}
+
+/*
+ * Count a row rejected by a worker, and send it to be logged, like
+ * HandleCopyError() does for the rows rejected in the QD.
+ */
+static void
+CopyRouteHandleError(CopyFromState cstate, CdbCopy *cdbCopy, char *frame, int len)
+{
+	CdbSreh    *cdbsreh = cstate->cdbsreh;
+	copy_from_dispatch_error errframe;
+	MemoryContext oldcontext;
+	uint64		save_lineno = cstate->cur_lineno;
+	bool		save_line_buf_valid = cstate->line_buf_valid;
+
+	Assert(cdbsreh != NULL);
+	memcpy(&errframe, frame, SizeOfCopyFromDispatchError);
+
+	cdbsreh->processed++;
+	cdbsreh->rejectcount++;
+
+	if (IS_LOG_TO_FILE(cdbsreh->logerrors))
+		SendCopyFromForwardedErrorFrame(cstate, cdbCopy, frame, len);
+
+	oldcontext = MemoryContextSwitchTo(cdbsreh->badrowcontext);
+	cdbsreh->errmsg = pnstrdup(frame + SizeOfCopyFromDispatchError,
+							   errframe.errmsg_len);
+
+	/* should the limit be reached, report the line of the rejected row */
+	cstate->cur_lineno = errframe.lineno;
+	cstate->line_buf_valid = false;
+	ErrorIfRejectLimitReached(cdbsreh);
+	cstate->cur_lineno = save_lineno;
+	cstate->line_buf_valid = save_line_buf_valid;
+
+	MemoryContextSwitchTo(oldcontext);
+	MemoryContextReset(cdbsreh->badrowcontext);
+}
+
+/*
+ * Forward the rows routed by the workers to the QEs, in the order of the
+ * batches. With 'nowait', stop when the next one is not there yet. Returns
+ * true if anything was received.
+ */
+static bool
+CopyRouteForward(CopyFromState cstate, CdbCopy *cdbCopy,
+				 CopyRouteLeader *leader, bool nowait, int64 *processed)
+{
+	bool		received = false;
+
+	while (leader->ndone < leader->nsent)
+	{
+		shm_mq_handle *mqh = leader->row_mqh[leader->ndone % leader->nworkers];
+		shm_mq_result res;
+		Size		nbytes;
+		void	   *data;
+		CopyRouteMsgHeader hdr;
+		char	   *frame;
+		int			len;
+
+		res = shm_mq_receive(mqh, &nbytes, &data, nowait);
+		if (res == SHM_MQ_WOULD_BLOCK)
+			break;
+		if (res == SHM_MQ_DETACHED)
+			CopyRouteWorkerExited(leader);
+		received = true;
+
+		Assert(nbytes >= sizeof(hdr));
+		memcpy(&hdr, data, sizeof(hdr));
+		frame = (char *) data + sizeof(hdr);
+		len = nbytes - sizeof(hdr);
+
+		switch (hdr.kind)
+		{
+			case COPY_ROUTE_ROW:
+				if (hdr.target_seg < 0)
+					cdbCopySendDataToAll(cdbCopy, frame, len);
+				else
+					cdbCopySendData(cdbCopy, hdr.target_seg, frame, len);
+				if (cstate->cdbsreh)
+					cstate->cdbsreh->processed++;
+				(*processed)++;
+				break;
+
+			case COPY_ROUTE_ERROR:
+				CopyRouteHandleError(cstate, cdbCopy, frame, len);
+				break;
+
+			case COPY_ROUTE_BATCH_DONE:
+				leader->ndone++;
+				break;
+
+			default:
+				elog(ERROR, "unexpected message %d from parallel COPY worker",
+					 hdr.kind);
+		}
+	}
+
+	return received;
+}
+
+/*
+ * Hand the current batch to the next worker.
+ */
+static void
+CopyRouteSendBatch(CopyFromState cstate, CdbCopy *cdbCopy,
+				   CopyRouteLeader *leader, int64 *processed)
+{
+	shm_mq_handle *mqh = leader->line_mqh[leader->nsent % leader->nworkers];
+
+	for (;;)
+	{
+		shm_mq_result res;
+
+		res = shm_mq_send(mqh, leader->batch.len, leader->batch.data, true);
+		if (res == SHM_MQ_SUCCESS)
+			break;
+		if (res == SHM_MQ_DETACHED)
+			CopyRouteWorkerExited(leader);
+
+		/*
+		 * The worker is behind. Forward what has been routed meanwhile, it
+		 * may be waiting for room to send more.
+		 */
+		if (!CopyRouteForward(cstate, cdbCopy, leader, true, processed))
+		{
+			(void) WaitLatch(MyLatch, WL_LATCH_SET | WL_EXIT_ON_PM_DEATH, 0,
+							 WAIT_EVENT_COPY_FROM_ROUTE);
+			ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
+		}
+	}
+
+	leader->nsent++;
+	resetStringInfo(&leader->batch);
+
+	(void) CopyRouteForward(cstate, cdbCopy, leader, true, processed);
+}
+
+/*
+ * Route the rows of the COPY in parallel workers, and forward them to the
+ * QEs. Returns false, before reading any input, if no workers can be used.
+ */
+static bool
+CopyFromDispatchParallel(CopyFromState cstate, CdbCopy *cdbCopy,
+						 int64 *processed)
+{
+	ParallelContext *pcxt;
+	CopyRouteLeader leader;
+	CopyFromParallelShared *shared;
+	List	   *options;
+	char	   *options_str;
+	char	   *attnames_str;
+	char	   *ptr;
+	char	   *lineq;
+	char	   *rowq;
+	Size		querylen = 0;
+	int			nworkers = gp_copy_from_parallel_workers;
+	int			nkeys = 5;
+	int			i;
+	bool		more;
+
+	if (nworkers <= 0 || !CopyFromCanRouteInParallel(cstate))
+		return false;
+
+	/* the options as DoCopy() passed them to BeginCopyFrom() */
+	options = list_copy(glob_copystmt->options);
+	if (glob_copystmt->sreh)
+		options = lappend(options, makeDefElem("sreh", glob_copystmt->sreh, -1));
+	options_str = nodeToString(options);
+	attnames_str = nodeToString(glob_copystmt->attlist);
+
+	EnterParallelMode();
+	pcxt = CreateParallelContext("postgres", "CopyFromParallelMain", nworkers);
+
+	shm_toc_estimate_chunk(&pcxt->estimator, sizeof(CopyFromParallelShared));
+	shm_toc_estimate_chunk(&pcxt->estimator, strlen(options_str) + 1);
+	shm_toc_estimate_chunk(&pcxt->estimator, strlen(attnames_str) + 1);
+	shm_toc_estimate_chunk(&pcxt->estimator, mul_size(COPY_ROUTE_QUEUE_SIZE, nworkers));
+	shm_toc_estimate_chunk(&pcxt->estimator, mul_size(COPY_ROUTE_QUEUE_SIZE, nworkers));
+	if (debug_query_string)
+	{
+		querylen = strlen(debug_query_string);
+		shm_toc_estimate_chunk(&pcxt->estimator, querylen + 1);
+		nkeys++;
+	}
+	shm_toc_estimate_keys(&pcxt->estimator, nkeys);
+
+	InitializeParallelDSM(pcxt);
+
+	/* If no DSM segment was available, route the rows here. */
+	if (pcxt->seg == NULL)
+	{
+		DestroyParallelContext(pcxt);
+		ExitParallelMode();
+		return false;
+	}
+
+	shared = shm_toc_allocate(pcxt->toc, sizeof(CopyFromParallelShared));
+	shared->relid = RelationGetRelid(cstate->rel);
+	shared->first_qe_processed_field = cstate->first_qe_processed_field;
+	shm_toc_insert(pcxt->toc, PARALLEL_KEY_COPY_SHARED, shared);
+
+	ptr = shm_toc_allocate(pcxt->toc, strlen(options_str) + 1);
+	strcpy(ptr, options_str);
+	shm_toc_insert(pcxt->toc, PARALLEL_KEY_COPY_OPTIONS, ptr);
+
+	ptr = shm_toc_allocate(pcxt->toc, strlen(attnames_str) + 1);
+	strcpy(ptr, attnames_str);
+	shm_toc_insert(pcxt->toc, PARALLEL_KEY_COPY_ATTNAMES, ptr);
+
+	if (debug_query_string)
+	{
+		ptr = shm_toc_allocate(pcxt->toc, querylen + 1);
+		memcpy(ptr, debug_query_string, querylen + 1);
+		shm_toc_insert(pcxt->toc, PARALLEL_KEY_QUERY_TEXT, ptr);
+	}
+
+	/* A queue of batches to each worker, and one of messages back */
+	lineq = shm_toc_allocate(pcxt->toc, mul_size(COPY_ROUTE_QUEUE_SIZE, nworkers));
+	rowq = shm_toc_allocate(pcxt->toc, mul_size(COPY_ROUTE_QUEUE_SIZE, nworkers));
+	leader.line_mqh = palloc(sizeof(shm_mq_handle *) * nworkers);
+	leader.row_mqh = palloc(sizeof(shm_mq_handle *) * nworkers);
+	for (i = 0; i < nworkers; i++)
+	{
+		shm_mq	   *mq;
+
+		mq = shm_mq_create(lineq + i * COPY_ROUTE_QUEUE_SIZE, COPY_ROUTE_QUEUE_SIZE);
+		shm_mq_set_sender(mq, MyProc);
+		leader.line_mqh[i] = shm_mq_attach(mq, pcxt->seg, NULL);
+
+		mq = shm_mq_create(rowq + i * COPY_ROUTE_QUEUE_SIZE, COPY_ROUTE_QUEUE_SIZE);
+		shm_mq_set_receiver(mq, MyProc);
+		leader.row_mqh[i] = shm_mq_attach(mq, pcxt->seg, NULL);
+	}
+	shm_toc_insert(pcxt->toc, PARALLEL_KEY_COPY_LINE_QUEUE, lineq);
+	shm_toc_insert(pcxt->toc, PARALLEL_KEY_COPY_ROW_QUEUE, rowq);
+
+	LaunchParallelWorkers(pcxt);
+
+	/* If no workers were launched, route the rows here. */
+	if (pcxt->nworkers_launched == 0)
+	{
+		DestroyParallelContext(pcxt);
+		ExitParallelMode();
+		return false;
+	}
+
+	for (i = 0; i < pcxt->nworkers_launched; i++)
+	{
+		shm_mq_set_handle(leader.line_mqh[i], pcxt->worker[i].bgwhandle);
+		shm_mq_set_handle(leader.row_mqh[i], pcxt->worker[i].bgwhandle);
+	}
+
+	elog(DEBUG1, "routing rows of COPY with %d parallel workers",
+		 pcxt->nworkers_launched);
+
+	leader.pcxt = pcxt;
+	leader.nworkers = pcxt->nworkers_launched;
+	leader.nsent = 0;
+	leader.ndone = 0;
+	initStringInfo(&leader.batch);
+
+	do
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		more = CopyRouteReadLine(cstate, &leader.batch);
+
+		if (leader.batch.len >= COPY_ROUTE_BATCH_SIZE ||
+			(!more && leader.batch.len > 0))
+			CopyRouteSendBatch(cstate, cdbCopy, &leader, processed);
+	} while (more);
+
+	/* No more batches. The workers exit once they are done with theirs. */
+	for (i = 0; i < leader.nworkers; i++)
+		shm_mq_detach(leader.line_mqh[i]);
+
+	(void) CopyRouteForward(cstate, cdbCopy, &leader, false, processed);
+
+	WaitForParallelWorkersToFinish(pcxt);
+	DestroyParallelContext(pcxt);
+	ExitParallelMode();
+
+	pfree(leader.batch.data);
+
+	return true;
+}
+
+/*
+ * Get the next line of the current batch into line_buf, in a parallel COPY
+ * worker. Returns false at the end of the batch.
+ */
+static bool
+CopyRouteNextLine(CopyFromState cstate)
+{
+	CopyFromRouteState *route = cstate->route;
+	CopyRouteLine line;
+	char	   *p;
+
+	if (route->batch_off >= route->batch_len)
+		return false;
+
+	p = route->batch + route->batch_off;
+	memcpy(&line, p, sizeof(line));
+	p += sizeof(line);
+
+	resetStringInfo(&cstate->line_buf);
+	appendBinaryStringInfo(&cstate->line_buf, p, line.len);
+	p += line.len;
+	cstate->cur_lineno = line.lineno;
+	route->batch_off = p - route->batch;
+
+	if (line.sqlerrcode != 0)
+	{
+		/* reading the line failed in the leader, throw the error here */
+		cstate->line_buf_valid = false;
+		route->batch_off += strlen(p) + 1;
+		ereport(ERROR,
+				(errcode(line.sqlerrcode),
+				 errmsg_internal("%s", p)));
+	}
+
+	cstate->line_buf_valid = true;
+
+	return true;
+}
+
+/*
+ * Send a message to the leader, in a parallel COPY worker.
+ */
+static void
+CopyRouteSendMessage(CopyFromState cstate, int kind, int target_seg,
+					 StringInfo msgbuf)
+{
+	CopyRouteMsgHeader hdr;
+	shm_mq_iovec iov[2];
+	int			iovcnt = 1;
+	shm_mq_result res;
+
+	hdr.kind = kind;
+	hdr.target_seg = target_seg;
+	iov[0].data = (char *) &hdr;
+	iov[0].len = sizeof(hdr);
+	if (msgbuf)
+	{
+		iov[1].data = msgbuf->data;
+		iov[1].len = msgbuf->len;
+		iovcnt++;
+	}
+
+	res = shm_mq_sendv(cstate->route->row_mqh, iov, iovcnt, false);
+	if (res != SHM_MQ_SUCCESS)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("could not send rows to parallel COPY leader")));
+}
+
+/*
+ * The worker's COPY never reads input itself.
+ */
+static int
+CopyRouteNoData(void *outbuf, int minread, int maxread, void *extra)
+{
+	elog(ERROR, "unexpected read of COPY input in parallel worker");
+	return 0;
+}
+
+/*
+ * Main entry point of a parallel COPY worker.
+ */
+void
+CopyFromParallelMain(dsm_segment *seg, shm_toc *toc)
+{
+	CopyFromParallelShared *shared;
+	CopyFromRouteState route;
+	CopyFromState cstate;
+	Relation	rel;
+	List	   *options;
+	List	   *attnamelist;
+	EState	   *estate;
+	ExprContext *econtext;
+	TupleTableSlot *slot;
+	GpDistributionData *distData;
+	ErrorContextCallback errcallback;
+	MemoryContext oldcontext;
+	char	   *mqspace;
+	shm_mq	   *mq;
+	bool		send_to_all;
+
+	/* Report the leader's query, for pg_stat_activity */
+	debug_query_string = shm_toc_lookup(toc, PARALLEL_KEY_QUERY_TEXT, true);
+	pgstat_report_activity(STATE_RUNNING, debug_query_string);
+
+	shared = shm_toc_lookup(toc, PARALLEL_KEY_COPY_SHARED, false);
+
+	mqspace = shm_toc_lookup(toc, PARALLEL_KEY_COPY_LINE_QUEUE, false);
+	mq = (shm_mq *) (mqspace + ParallelWorkerNumber * COPY_ROUTE_QUEUE_SIZE);
+	shm_mq_set_receiver(mq, MyProc);
+	route.line_mqh = shm_mq_attach(mq, seg, NULL);
+
+	mqspace = shm_toc_lookup(toc, PARALLEL_KEY_COPY_ROW_QUEUE, false);
+	mq = (shm_mq *) (mqspace + ParallelWorkerNumber * COPY_ROUTE_QUEUE_SIZE);
+	shm_mq_set_sender(mq, MyProc);
+	route.row_mqh = shm_mq_attach(mq, seg, NULL);
+
+	route.batch = NULL;
+	route.batch_len = 0;
+	route.batch_off = 0;
+
+	/*
+	 * Set up a COPY like the leader's, which parses just the fields the
+	 * leader would parse, and sends the rows back to it.
+	 */
+	rel = table_open(shared->relid, AccessShareLock);
+	options = (List *) stringToNode(shm_toc_lookup(toc, PARALLEL_KEY_COPY_OPTIONS, false));
+	attnamelist = (List *) stringToNode(shm_toc_lookup(toc, PARALLEL_KEY_COPY_ATTNAMES, false));
+
+	cstate = BeginCopyFrom(NULL, rel, NULL, NULL, false, CopyRouteNoData, NULL,
+						   attnamelist, options);
+	cstate->dispatch_mode = COPY_DISPATCH;
+	cstate->first_qe_processed_field = shared->first_qe_processed_field;
+	SplitCopyFromAttnumList(cstate);
+
+	cstate->dispatch_msgbuf = makeStringInfo();
+	enlargeStringInfo(cstate->dispatch_msgbuf, SizeOfCopyFromDispatchRow);
+
+	if (cstate->opts.sreh)
+	{
+		SingleRowErrorDesc *sreh = cstate->opts.sreh;
+		bool		log_to_file = IS_LOG_TO_FILE(sreh->log_error_type);
+
+		/* the leader enforces the limit, and logs the rejected rows */
+		cstate->errMode = log_to_file ? SREH_LOG : SREH_IGNORE;
+		cstate->cdbsreh = makeCdbSreh(sreh->rejectlimit,
+									  sreh->is_limit_in_rows,
+									  NULL,
+									  RelationGetRelationName(rel),
+									  log_to_file ? LOG_ERRORS_ENABLE : LOG_ERRORS_DISABLE);
+		cstate->cdbsreh->relid = RelationGetRelid(rel);
+	}
+	else
+		cstate->errMode = ALL_OR_NOTHING;
+
+	cstate->route = &route;
+	CopyInitDataParser(cstate);
+
+	estate = CreateExecutorState();
+	econtext = GetPerTupleExprContext(estate);
+	distData = InitDistributionData(cstate, estate);
+	send_to_all = GpPolicyIsReplicated(distData->policy);
+	slot = MakeSingleTupleTableSlot(RelationGetDescr(rel), &TTSOpsVirtual);
+
+	/* Set up callback to identify error line number */
+	errcallback.callback = CopyFromErrorCallback;
+	errcallback.arg = (void *) cstate;
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	oldcontext = CurrentMemoryContext;
+
+	for (;;)
+	{
+		shm_mq_result res;
+		Size		nbytes;
+		void	   *data;
+
+		/* The leader detaches from the queue when there are no more. */
+		res = shm_mq_receive(route.line_mqh, &nbytes, &data, false);
+		if (res == SHM_MQ_DETACHED)
+			break;
+		Assert(res == SHM_MQ_SUCCESS);
+
+		SIMPLE_FAULT_INJECTOR("copy_from_parallel_worker_batch");
+
+		route.batch = data;
+		route.batch_len = nbytes;
+		route.batch_off = 0;
+
+		for (;;)
+		{
+			unsigned int target_seg;
+
+			CHECK_FOR_INTERRUPTS();
+
+			ResetPerTupleExprContext(estate);
+			MemoryContextSwitchTo(GetPerTupleMemoryContext(estate));
+
+			ExecClearTuple(slot);
+			if (!NextCopyFromDispatch(cstate, econtext, slot->tts_values, slot->tts_isnull))
+				break;
+			ExecStoreVirtualTuple(slot);
+
+			MemoryContextSwitchTo(oldcontext);
+
+			target_seg = GetTargetSeg(distData, slot);
+			SendCopyFromForwardedTuple(cstate, NULL, send_to_all,
+									   send_to_all ? 0 : target_seg,
+									   rel,
+									   cstate->cur_lineno,
+									   cstate->line_buf.data,
+									   cstate->line_buf.len,
+									   slot->tts_values,
+									   slot->tts_isnull);
+		}
+		MemoryContextSwitchTo(oldcontext);
+
+		CopyRouteSendMessage(cstate, COPY_ROUTE_BATCH_DONE, -1, NULL);
+	}
+
+	error_context_stack = errcallback.previous;
+
+	ExecDropSingleTupleTableSlot(slot);
+	FreeDistributionData(distData);
+	FreeExecutorState(estate);
+	EndCopyFrom(cstate);
+	table_close(rel, AccessShareLock);
+
+	shm_mq_detach(route.row_mqh);
+}
@@ -73,6 +73,7 @@
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "port/pg_bswap.h"
+#include "port/pg_lfind.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
 
@@ -806,6 +807,10 @@ CopyReadLineText(CopyFromState cstate)
 	char		quotec = '\0';
 	char		escapec = '\0';
 
+	/* characters that may end the line or change the CSV state */
+	char		special[5];
+	int			nspecial = 0;
+
 	if (cstate->opts.csv_mode)
 	{
 		quotec = cstate->opts.quote[0];
@@ -815,6 +820,15 @@ CopyReadLineText(CopyFromState cstate)
 			escapec = '\0';
 	}
 
+	special[nspecial++] = '\r';
+	special[nspecial++] = '\n';
+	special[nspecial++] = '\\';
+	if (cstate->opts.csv_mode)
+	{
+		special[nspecial++] = quotec;
+		special[nspecial++] = escapec;
+	}
+
 	/*
 	 * The objective of this loop is to transfer the entire next input line
 	 * into line_buf.  Hence, we only care for detecting newlines (\r and/or
@@ -878,6 +892,28 @@ CopyReadLineText(CopyFromState cstate)
 			need_data = false;
 		}
 
+		/*
+		 * Skip over a run of characters that are none of the special ones.
+		 * They can neither end the line nor change the CSV state, so they
+		 * are just part of the line, and the code below would do nothing
+		 * for them but clear last_was_esc and first_char_in_line.
+		 */
+		{
+			int			skip;
+
+			skip = pg_lfind8_any(special, nspecial,
+								 copy_input_buf + input_buf_ptr,
+								 copy_buf_len - input_buf_ptr);
+			if (skip > 0)
+			{
+				input_buf_ptr += skip;
+				last_was_esc = false;
+				first_char_in_line = false;
+				if (input_buf_ptr >= copy_buf_len)
+					continue;
+			}
+		}
+
 		/* OK to fetch a character */
 		prev_raw_ptr = input_buf_ptr;
 		c = copy_input_buf[input_buf_ptr++];
@@ -1263,6 +1299,8 @@ CopyReadAttributesText(CopyFromState cstate, int stop_processing_at_field)
 	char	   *output_ptr;
 	char	   *cur_ptr;
 	char	   *line_end_ptr;
+	char		special[2];
+	int			nspecial = 0;
 
 	/*
 	 * We need a special case for zero-column tables: check that the input
@@ -1277,6 +1315,12 @@ CopyReadAttributesText(CopyFromState cstate, int stop_processing_at_field)
 		return 0;
 	}
 
+	/* the characters that end a run of plain data in a field */
+	if (!delim_off)
+		special[nspecial++] = delimc;
+	if (!cstate->escape_off)
+		special[nspecial++] = escapec;
+
 	resetStringInfo(&cstate->attribute_buf);
 
 	/*
@@ -1339,6 +1383,17 @@ CopyReadAttributesText(CopyFromState cstate, int stop_processing_at_field)
 		for (;;)
 		{
 			char		c;
+			int			run;
+
+			/* Copy a run of plain data to the output string at once */
+			if (nspecial > 0)
+				run = pg_lfind8_any(special, nspecial, cur_ptr,
+									line_end_ptr - cur_ptr);
+			else
+				run = line_end_ptr - cur_ptr;
+			memcpy(output_ptr, cur_ptr, run);
+			output_ptr += run;
+			cur_ptr += run;
 
 			end_ptr = cur_ptr;
 			if (cur_ptr >= line_end_ptr)
@@ -1512,6 +1567,9 @@ CopyReadAttributesCSV(CopyFromState cstate, int stop_processing_at_field)
 	char	   *output_ptr;
 	char	   *cur_ptr;
 	char	   *line_end_ptr;
+	char		unquoted_special[2];
+	int			nunquoted_special = 0;
+	char		quoted_special[2];
 
 	/*
 	 * We need a special case for zero-column tables: check that the input
@@ -1526,6 +1584,13 @@ CopyReadAttributesCSV(CopyFromState cstate, int stop_processing_at_field)
 		return 0;
 	}
 
+	/* the characters that end a run of plain data, outside and in quotes */
+	if (!delim_off)
+		unquoted_special[nunquoted_special++] = delimc;
+	unquoted_special[nunquoted_special++] = quotec;
+	quoted_special[0] = escapec;
+	quoted_special[1] = quotec;
+
 	resetStringInfo(&cstate->attribute_buf);
 
 	/*
@@ -1584,10 +1649,18 @@ CopyReadAttributesCSV(CopyFromState cstate, int stop_processing_at_field)
 		for (;;)
 		{
 			char		c;
+			int			run;
 
 			/* Not in quote */
 			for (;;)
 			{
+				/* Copy a run of plain data to the output string at once */
+				run = pg_lfind8_any(unquoted_special, nunquoted_special,
+									cur_ptr, line_end_ptr - cur_ptr);
+				memcpy(output_ptr, cur_ptr, run);
+				output_ptr += run;
+				cur_ptr += run;
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					goto endfield;
@@ -1611,6 +1684,12 @@ CopyReadAttributesCSV(CopyFromState cstate, int stop_processing_at_field)
 			/* In quote */
 			for (;;)
 			{
+				run = pg_lfind8_any(quoted_special, 2,
+									cur_ptr, line_end_ptr - cur_ptr);
+				memcpy(output_ptr, cur_ptr, run);
+				output_ptr += run;
+				cur_ptr += run;
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					ereport(ERROR,
@@ -47,6 +47,7 @@
 #include "utils/typcache.h"
 #include "utils/xml.h"
 
+#include "cdb/cdbcardfeedback.h"
 #include "cdb/cdbgang.h"
 #include "optimizer/tlist.h"
 #include "optimizer/optimizer.h"
@@ -943,6 +944,11 @@ ExplainPrintPlan(ExplainState *es, QueryDesc *queryDesc)
                                      estate->dispatcherState->primaryResults,
                                      LocallyExecutingSliceIndex(estate),
                                      es->showstatctx);
+
+		/* Remember the actual rows of the plan's nodes for ORCA. */
+		if (optimizer_enable_cardinality_feedback &&
+			Gp_role == GP_ROLE_DISPATCH)
+			CardFeedbackRecordPlan(queryDesc);
 	}
 
 	ExplainPreScanNode(queryDesc->planstate, &rels_used);
@@ -1259,6 +1259,52 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 }								/* cdbexplain_depositStatsToNode */
 
 
+/*
+ * cdbexplain_getTotalRows
+ *	  Total number of rows a node returned, summed over all the workers that
+ *	  ran it, after the statistics have been deposited in its Instrument
+ *	  node.  Returns false if some worker didn't run the node exactly once,
+ *	  in which case the sum is not the node's cardinality.  *nworkers_out is
+ *	  set to the number of workers.
+ */
+bool
+cdbexplain_getTotalRows(PlanState *planstate, double *rows_out,
+						int *nworkers_out)
+{
+	Instrumentation *instr = planstate->instrument;
+	CdbExplain_NodeSummary *ns;
+	double		rows = 0;
+	int			nworkers = 0;
+	int			i;
+
+	if (instr == NULL || instr->cdbNodeSummary == NULL)
+		return false;
+
+	ns = instr->cdbNodeSummary;
+	for (i = 0; i < ns->ninst; i++)
+	{
+		CdbExplain_StatInst *nsi = &ns->insts[i];
+
+		/* no stats from this segment */
+		if (nsi->pstype == T_Invalid)
+			continue;
+
+		if (nsi->nloops != 1)
+			return false;
+
+		rows += nsi->ntuples;
+		nworkers++;
+	}
+
+	if (nworkers == 0)
+		return false;
+
+	*rows_out = rows;
+	*nworkers_out = nworkers;
+	return true;
+}
+
+
 /*
  * cdbexplain_collectExtraText
  *	  Allow a node to supply additional text for its EXPLAIN ANALYZE report.
@@ -111,6 +111,7 @@
 #include "utils/builtins.h"
 #include "utils/datum.h"
 #include "utils/fmgroids.h"
+#include "utils/guc.h"
 #include "utils/inval.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
@@ -1142,10 +1143,13 @@ DefineRelation(CreateStmt *stmt, char relkind, Oid ownerId,
 	rel = relation_open(relationId, AccessExclusiveLock);
 
 	/*
-	 * If this is an append-only relation, create the auxliary tables necessary
+	 * If this is an append-only relation, create the auxliary tables necessary.
+	 * Zone maps live in the block directory, so create it up front when they
+	 * are enabled.
 	 */
 	if (RelationIsAppendOptimized(rel))
-		NewRelationCreateAOAuxTables(RelationGetRelid(rel), stmt->buildAoBlkdir);
+		NewRelationCreateAOAuxTables(RelationGetRelid(rel),
+									 stmt->buildAoBlkdir || gp_appendonly_zonemap);
 
 	/*
 	 * Now add any newly specified column default and generation expressions
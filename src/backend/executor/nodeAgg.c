@@ -217,6 +217,18 @@
  *	  imposing a limit on the number of groups separately from the amount of
  *	  memory consumed.
  *
+ *	  GPDB: Streaming Partial Aggregation
+ *
+ *	  The partial aggregate of a multi-stage aggregation, below a Motion,
+ *	  feeds a final aggregate that combines the transition states of the
+ *	  same group anyway; so do the deduplicating aggregates the planner marks
+ *	  "streaming". Rather than spill, such an aggregate can emit all the
+ *	  groups in its hash table, and start over with an empty one. We do that
+ *	  when the hash table memory exceeds the limit, and when the hash table
+ *	  doesn't reduce the input much (see hash_agg_stream_now()); aggregating
+ *	  a near-unique key would otherwise just fill the memory, and spill
+ *	  almost all of the input to disk.
+ *
  *    Transition / Combine function invocation:
  *
  *    For performance reasons transition functions, including combine
@@ -245,9 +257,8 @@
  */
 
 /*
- * GPDB_12_MERGE_FIXME: we lost the "streaming bottom" feature in the merge.
- *
- * And the detailed cdb executor instruments to print by explain.
+ * GPDB_12_MERGE_FIXME: we lost the detailed cdb executor instruments to print
+ * by explain.
  *
  * They were in execHHashagg.c
  */
@@ -284,6 +295,7 @@
 #include "utils/tuplesort.h"
 
 #include "cdb/cdbexplain.h"
+#include "cdb/cdbvars.h"
 #include "lib/stringinfo.h"             /* StringInfo */
 #include "optimizer/walkers.h"
 
@@ -325,6 +337,15 @@
  */
 #define HASHAGG_HLL_BIT_WIDTH 5
 
+/*
+ * GPDB: a streaming partial aggregate checks the reduction of its input
+ * every HASHAGG_STREAM_CHECK_TUPLES input tuples. If the hash table holds
+ * more than HASHAGG_STREAM_MAX_GROUPS_RATIO groups per input tuple by then,
+ * the groups are emitted, and the aggregation starts over.
+ */
+#define HASHAGG_STREAM_CHECK_TUPLES 65536
+#define HASHAGG_STREAM_MAX_GROUPS_RATIO 0.5
+
 /*
  * Estimate chunk overhead as a constant 16 bytes. XXX: should this be
  * improved?
@@ -459,6 +480,8 @@ static TupleTableSlot *agg_retrieve_hash_table(AggState *aggstate);
 static TupleTableSlot *agg_retrieve_hash_table_in_memory(AggState *aggstate);
 static void hash_agg_check_limits(AggState *aggstate);
 static void hash_agg_enter_spill_mode(AggState *aggstate);
+static bool hash_agg_stream_now(AggState *aggstate);
+static void agg_stream_refill_hash_table(AggState *aggstate);
 static void hash_agg_update_metrics(AggState *aggstate, bool from_tape,
 									int npartitions);
 static void hashagg_finish_initial_spills(AggState *aggstate);
@@ -489,6 +512,7 @@ static void build_pertrans_for_aggref(AggStatePerTrans pertrans,
 									  Oid *inputTypes, int numArguments);
 
 static void ExecEagerFreeAgg(AggState *node);
+static void ExecAggExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 
 /*
  * Select the current grouping set; affects current_set and
@@ -1934,10 +1958,42 @@ hash_agg_check_limits(AggState *aggstate)
 		(meta_mem + hashkey_mem > aggstate->hash_mem_limit ||
 		 ngroups > aggstate->hash_ngroups_limit))
 	{
-		hash_agg_enter_spill_mode(aggstate);
+		/* GPDB: a streaming aggregate emits its groups instead */
+		if (aggstate->hash_streaming)
+			aggstate->hash_stream_full = true;
+		else
+			hash_agg_enter_spill_mode(aggstate);
 	}
 }
 
+/*
+ * GPDB: called by a streaming aggregate after each input tuple, to decide
+ * whether to stop filling the hash table, and emit its groups. That's when
+ * the hash table is full, or when it reduces the input poorly.
+ */
+static bool
+hash_agg_stream_now(AggState *aggstate)
+{
+	aggstate->hash_stream_ntuples++;
+
+	if (!aggstate->hash_stream_full)
+	{
+		if (aggstate->hash_stream_ntuples % HASHAGG_STREAM_CHECK_TUPLES != 0)
+			return false;
+		if (aggstate->hash_ngroups_current <=
+			aggstate->hash_stream_ntuples * HASHAGG_STREAM_MAX_GROUPS_RATIO)
+			return false;
+	}
+
+	if (aggstate->hash_stream_count++ == 0)
+	{
+		aggstate->hash_stream_first = aggstate->hash_stream_ntuples;
+		aggstate->hash_stream_first_full = aggstate->hash_stream_full;
+	}
+
+	return true;
+}
+
 /*
  * Enter "spill mode", meaning that no new groups are added to any of the hash
  * tables. Tuples that would create a new group are instead spilled, and
@@ -2651,7 +2707,10 @@ agg_fill_hash_table(AggState *aggstate)
 	{
 		outerslot = fetch_input_tuple(aggstate);
 		if (TupIsNull(outerslot))
+		{
+			aggstate->hash_input_done = true;
 			break;
+		}
 
 		/* set up for lookup_hash_entries and advance_aggregates */
 		tmpcontext->ecxt_outertuple = outerslot;
@@ -2667,6 +2726,10 @@ agg_fill_hash_table(AggState *aggstate)
 		 * hash lookups do this too
 		 */
 		ResetExprContext(aggstate->tmpcontext);
+
+		/* GPDB: emit the groups early, if streaming */
+		if (aggstate->hash_streaming && hash_agg_stream_now(aggstate))
+			break;
 	}
 
 	/* finalize spills, if any */
@@ -2679,6 +2742,25 @@ agg_fill_hash_table(AggState *aggstate)
 						   &aggstate->perhash[0].hashiter);
 }
 
+/*
+ * GPDB: once a streaming aggregate has emitted the groups in its hash table,
+ * reset the hash table, and fill it again from the rest of the input.
+ */
+static void
+agg_stream_refill_hash_table(AggState *aggstate)
+{
+	/* free memory and reset hash tables */
+	ReScanExprContext(aggstate->hashcontext);
+	for (int setno = 0; setno < aggstate->num_hashes; setno++)
+		ResetTupleHashTable(aggstate->perhash[setno].hashtable);
+
+	aggstate->hash_ngroups_current = 0;
+	aggstate->hash_stream_full = false;
+	aggstate->hash_stream_ntuples = 0;
+
+	agg_fill_hash_table(aggstate);
+}
+
 /*
  * If any data was spilled during hash aggregation, reset the hash table and
  * reprocess one batch of spilled data. After reprocessing a batch, the hash
@@ -2853,6 +2935,12 @@ agg_retrieve_hash_table(AggState *aggstate)
 		result = agg_retrieve_hash_table_in_memory(aggstate);
 		if (result == NULL)
 		{
+			/* GPDB: a streaming aggregate may have input left */
+			if (aggstate->hash_streaming && !aggstate->hash_input_done)
+			{
+				agg_stream_refill_hash_table(aggstate);
+				continue;
+			}
 			if (!agg_refill_hash_table(aggstate))
 			{
 				aggstate->agg_done = true;
@@ -3816,6 +3904,23 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 													  outerplan->plan_width,
 													  node->transitionSpace);
 
+		/*
+		 * GPDB: a streaming aggregate emits its groups early rather than
+		 * spill; the aggregate above it combines the groups it emits more
+		 * than once. Besides the aggregates the planner marked streaming,
+		 * that holds for any partial aggregate. Grouping sets processed by
+		 * sorting in the same Agg rule it out, as they must see all the
+		 * input.
+		 */
+		aggstate->hash_streaming = gp_hashagg_streambottom &&
+			node->aggstrategy == AGG_HASHED &&
+			(node->streaming || DO_AGGSPLIT_SKIPFINAL(node->aggsplit));
+
+		/* Report whether it did in EXPLAIN ANALYZE. */
+		if (aggstate->hash_streaming && estate->es_instrument &&
+			(estate->es_instrument & INSTRUMENT_CDB))
+			aggstate->ss.ps.cdbexplainfun = ExecAggExplainEnd;
+
 		/*
 		 * Consider all of the grouping sets together when setting the limits
 		 * and estimating the number of partitions. This can be inaccurate
@@ -4687,6 +4792,10 @@ ExecReScanAgg(AggState *node)
 		node->hash_ever_spilled = false;
 		node->hash_spill_mode = false;
 		node->hash_ngroups_current = 0;
+		node->hash_input_done = false;
+		node->hash_stream_full = false;
+		node->hash_stream_ntuples = 0;
+		node->hash_stream_count = 0;
 
 		ReScanExprContext(node->hashcontext);
 		/* Rebuild an empty hash table */
@@ -5081,5 +5190,26 @@ ReuseHashTable(AggState *node)
 	PlanState  *outerPlan = outerPlanState(node);
 	Agg     *aggnode = (Agg *) node->ss.ps.plan;
 	return (outerPlan->chgParam == NULL && !node->hash_ever_spilled &&
+			node->hash_stream_count == 0 &&
 			!bms_overlap(node->ss.ps.chgParam, aggnode->aggParams));
 }
+
+/*
+ * ExecAggExplainEnd
+ *		Called before ExecutorEnd to finish EXPLAIN ANALYZE reporting of a
+ *		streaming aggregate.
+ */
+static void
+ExecAggExplainEnd(PlanState *planstate, struct StringInfoData *buf)
+{
+	AggState   *aggstate = (AggState *) planstate;
+
+	if (aggstate->hash_stream_count == 0)
+		return;
+
+	appendStringInfo(buf,
+					 "Streamed the groups %d times, first after " UINT64_FORMAT " input rows (%s).",
+					 aggstate->hash_stream_count,
+					 aggstate->hash_stream_first,
+					 aggstate->hash_stream_first_full ? "memory full" : "poor reduction");
+}
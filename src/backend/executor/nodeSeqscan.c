@@ -28,6 +28,7 @@
  */
 #include "postgres.h"
 
+#include "access/appendonly_zonemap.h"
 #include "access/heapam.h"
 #include "access/relscan.h"
 #include "access/session.h"
@@ -36,6 +37,7 @@
 #include "executor/nodeSeqscan.h"
 #include "utils/rel.h"
 #include "utils/builtins.h"
+#include "utils/guc.h"
 #include "nodes/nodeFuncs.h"
 
 #include "cdb/cdbaocsam.h"
@@ -43,6 +45,7 @@
 #include "cdb/cdbvars.h"
 
 static TupleTableSlot *SeqNext(SeqScanState *node);
+static void ExecSeqScanExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 
 /* ----------------------------------------------------------------
  *						Scan Support
@@ -145,6 +148,22 @@ SeqNext(SeqScanState *node)
 													&node->ss.ps);
 			}
 		}
+
+		/*
+		 * Use the block zone maps of append-optimized tables to skip blocks
+		 * that cannot satisfy the quals.
+		 */
+		if (gp_appendonly_zonemap && node->ss.ps.plan->qual)
+		{
+			if (RelationIsAoRows(node->ss.ss_currentRelation))
+				((AppendOnlyScanDesc) scandesc)->aos_zonemap =
+					AOZoneMap_BeginScan(node->ss.ss_currentRelation,
+										node->ss.ps.plan->qual);
+			else if (RelationIsAoCols(node->ss.ss_currentRelation))
+				((AOCSScanDesc) scandesc)->aos_zonemap =
+					AOZoneMap_BeginScan(node->ss.ss_currentRelation,
+										node->ss.ps.plan->qual);
+		}
 	}
 
 	/*
@@ -255,9 +274,43 @@ ExecInitSeqScanForPartition(SeqScan *node, EState *estate,
 	scanstate->ss.ps.qual =
 		ExecInitQual(node->plan.qual, (PlanState *) scanstate);
 
+	/* CDB: Offer zone map statistics for EXPLAIN ANALYZE. */
+	if (estate->es_instrument && (estate->es_instrument & INSTRUMENT_CDB) &&
+		RelationIsAppendOptimized(currentRelation))
+	{
+		/* Allocate string buffer. */
+		scanstate->ss.ps.cdbexplainbuf = makeStringInfo();
+
+		/* Request a callback at end of query. */
+		scanstate->ss.ps.cdbexplainfun = ExecSeqScanExplainEnd;
+	}
+
 	return scanstate;
 }
 
+/*
+ * ExecSeqScanExplainEnd
+ *		Called before ExecutorEnd to finish EXPLAIN ANALYZE reporting.
+ */
+static void
+ExecSeqScanExplainEnd(PlanState *planstate, struct StringInfoData *buf)
+{
+	SeqScanState *node = (SeqScanState *) planstate;
+	TableScanDesc scandesc = node->ss.ss_currentScanDesc;
+	AOZoneMapScanState *zonemap = NULL;
+
+	if (scandesc == NULL)
+		return;
+
+	if (RelationIsAoRows(node->ss.ss_currentRelation))
+		zonemap = ((AppendOnlyScanDesc) scandesc)->aos_zonemap;
+	else if (RelationIsAoCols(node->ss.ss_currentRelation))
+		zonemap = ((AOCSScanDesc) scandesc)->aos_zonemap;
+
+	if (zonemap)
+		AOZoneMap_ExplainScan(zonemap, buf);
+}
+
 /* ----------------------------------------------------------------
  *		ExecEndSeqScan
  *
@@ -29,19 +29,27 @@
  * ------------------
  *
  * A cross-slice share works basically the same as a local one, except
- * that the producing slice makes the underlying tuplestore available to
- * other processes, by forcing it to be written to a file on disk. The
- * first ExecShareInputScan() call in the producing slice materializes
- * the whole tuplestore, and advertises that it's ready in shared memory.
- * Consumer slices wait for that before trying to read the store.
+ * that the producing slice makes the result available to other processes.
+ * The first ExecShareInputScan() call in the producing slice materializes
+ * the whole result into a shared store, which consumers read while it is
+ * being written.
+ *
+ * The shared store keeps the tuples in chunks of dynamic shared memory, as
+ * long as they fit in the producer's operator memory. Beyond that, the rest
+ * of the tuples overflow to shared tuplestore files on disk, which are
+ * frozen and handed to the consumers every SHAREINPUT_SEGMENT_SIZE bytes.
+ * A consumer reads the tuples of a chunk as soon as the producer has
+ * published them, and those of an overflow file once it is frozen, so it
+ * doesn't need to wait for the whole result.
  *
  * The producer and the consumers communicate the status of the scan using
  * shared memory. There's a hash table in shared memory, containing a
  * 'shareinput_Xslice_state' struct for each shared scan. The producer uses
- * a condition variable to wake up consumers, when the tuplestore is fully
- * materialized, and the consumers use the same condition variable to inform
- * the producer when they're done reading it. The producer slice keeps the
- * underlying tuplestore open, until all the consumers have finished.
+ * a condition variable to wake up consumers, when it has published more
+ * tuples and when the result is complete, and the consumers use the same
+ * condition variable to inform the producer when they're done reading it.
+ * The producer slice keeps the shared store, until all the consumers have
+ * finished.
  *
  *
  * Portions Copyright (c) 2023, HashData Technology Limited.
@@ -72,6 +80,19 @@
 #include "utils/resowner.h"
 #include "utils/tuplestore.h"
 #include "port/atomics.h"
+#include "storage/dsm.h"
+
+/* maximum number of shared memory chunks of a cross-slice share */
+#define SHAREINPUT_MAX_CHUNKS		16
+
+/* size of the first chunk, each next one is twice the size of the last */
+#define SHAREINPUT_FIRST_CHUNK_SIZE	(64 * 1024)
+
+/* wake up the consumers after this many bytes of new tuples */
+#define SHAREINPUT_NOTIFY_SIZE		(64 * 1024)
+
+/* size at which an overflow file is frozen and handed to the consumers */
+#define SHAREINPUT_SEGMENT_SIZE		(8 * 1024 * 1024)
 
 /*
  * In a cross-slice ShareinputScan, the producer and consumer processes
@@ -103,13 +124,25 @@ typedef struct shareinput_Xslice_state
 	shareinput_tag tag;			/* hash key */
 
 	int			refcount;		/* reference count of this entry */
-	pg_atomic_uint32	ready;	/* is the input fully materialized and ready to be read? */
+	pg_atomic_uint32	ready;	/* is the input fully materialized? */
 	pg_atomic_uint32	ndone;	/* # of consumers that have finished the scan */
 
 	/*
-	 * ready_done_cv is used for signaling when the scan becomes "ready", and
-	 * when it becomes "done". The producer wakes up everyone waiting on this
-	 * condition variable when it sets ready = true. Also, when the last
+	 * The shared memory chunks holding the first tuples, and the number of
+	 * chunks and overflow files published so far. 'overflowed' is set once
+	 * the rest of the tuples go to overflow files; no more chunks are
+	 * published after that.
+	 */
+	dsm_handle	chunks[SHAREINPUT_MAX_CHUNKS];
+	pg_atomic_uint32	nchunks;
+	pg_atomic_uint32	overflowed;
+	pg_atomic_uint32	nsegments;
+
+	/*
+	 * ready_done_cv is used for signaling when more tuples are published,
+	 * when the scan becomes "ready", and when it becomes "done". The
+	 * producer wakes up everyone waiting on this condition variable when it
+	 * publishes tuples, and when it sets ready = true. Also, when the last
 	 * consumer finishes the scan (ndone reaches nconsumers), it wakes up the
 	 * producer using this same condition variable.
 	 */
@@ -117,6 +150,21 @@ typedef struct shareinput_Xslice_state
 
 } shareinput_Xslice_state;
 
+/*
+ * Header of a shared memory chunk. The tuples follow the header, each one
+ * MAXALIGNed. The producer publishes the tuples it has written by advancing
+ * 'used', and sets 'sealed' once it won't write into the chunk anymore.
+ */
+typedef struct shareinput_chunk
+{
+	pg_atomic_uint64	used;
+	pg_atomic_uint32	sealed;
+} shareinput_chunk;
+
+#define SHAREINPUT_CHUNK_HEADER_SIZE	MAXALIGN(sizeof(shareinput_chunk))
+#define SHAREINPUT_CHUNK_DATA(chunk) \
+	((char *) (chunk) + SHAREINPUT_CHUNK_HEADER_SIZE)
+
 /* shared memory hash table holding 'shareinput_Xslice_state' entries */
 static HTAB *shareinput_Xslice_hash = NULL;
 
@@ -180,8 +228,38 @@ typedef struct shareinput_local_state
 
 	/* Tuplestore that holds the result */
 	Tuplestorestate *ts_state;
+
+	/*
+	 * The shared store of a cross-slice share, as mapped in this process.
+	 * The chunks are shared by all the scans of the share in this slice, as
+	 * a process cannot attach to a DSM segment more than once.
+	 */
+	dsm_segment *chunk_segs[SHAREINPUT_MAX_CHUNKS];
+
+	/* the producer's position in the shared store */
+	int			nchunks;		/* # of chunks created */
+	Size		mem_allocated;	/* total size of the chunks */
+	Size		mem_used;		/* bytes written into the last chunk */
+	Size		mem_unnotified;	/* bytes not yet published */
+	bool		overflowed;		/* are we writing overflow files? */
+	int			nsegments;		/* # of overflow files frozen */
+	Tuplestorestate *segment_ts; /* overflow file being written */
+	Size		segment_size;	/* bytes written into it */
+	List	   *segments;		/* frozen overflow files */
 } shareinput_local_state;
 
+/*
+ * A consumer's position in the shared store of a cross-slice share.
+ */
+typedef struct shareinput_Xslice_reader
+{
+	int			chunkno;		/* chunk being read */
+	Size		offset;			/* offset of the next tuple in the chunk */
+	bool		in_segments;	/* done with the chunks? */
+	int			segno;			/* overflow file being read */
+	Tuplestorestate *segment_ts; /* and its reader */
+} shareinput_Xslice_reader;
+
 static shareinput_Xslice_reference *get_shareinput_reference(int share_id);
 static void release_shareinput_reference(shareinput_Xslice_reference *ref);
 static void shareinput_release_callback(ResourceReleasePhase phase,
@@ -189,14 +267,58 @@ static void shareinput_release_callback(ResourceReleasePhase phase,
 										bool isTopLevel,
 										void *arg);
 
+static void shareinput_writer_puttuple(ShareInputScanState *node, TupleTableSlot *slot);
+static void shareinput_writer_finish(ShareInputScanState *node);
 static void shareinput_writer_notifyready(shareinput_Xslice_reference *ref);
-static void shareinput_reader_waitready(shareinput_Xslice_reference *ref);
+static bool shareinput_reader_gettuple(ShareInputScanState *node, TupleTableSlot *slot);
+static void shareinput_reader_rescan(ShareInputScanState *node);
+static void shareinput_release_store(shareinput_local_state *local_state);
 static void shareinput_reader_notifydone(shareinput_Xslice_reference *ref, int nconsumers);
 static void shareinput_writer_waitdone(shareinput_Xslice_reference *ref, int nconsumers);
 
 static void ExecShareInputScanExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 
 
+/*
+ * init_xslice_state
+ *    Initialize the state of a cross-slice scan. The producer materializes
+ *    the result into the shared store first; the consumers read it while
+ *    it is being written.
+ */
+static void
+init_xslice_state(ShareInputScanState *node)
+{
+	EState	   *estate = node->ss.ps.state;
+	ShareInputScan *sisc = (ShareInputScan *) node->ss.ps.plan;
+	shareinput_local_state *local_state = node->local_state;
+	TupleTableSlot *outerslot;
+
+	if (!node->ref)
+		elog(ERROR, "cannot execute ShareInputScan that was not initialized");
+
+	if (!local_state->ready &&
+		(currentSliceId == sisc->producer_slice_id || estate->es_plannedstmt->numSlices == 1))
+	{
+		/* We are the producer */
+		elog(DEBUG1, "SISC writer (shareid=%d, slice=%d): No shared store yet, creating it",
+			 sisc->share_id, currentSliceId);
+
+		for (;;)
+		{
+			outerslot = ExecProcNode(local_state->childState);
+			if (TupIsNull(outerslot))
+				break;
+			shareinput_writer_puttuple(node, outerslot);
+		}
+		shareinput_writer_finish(node);
+
+		local_state->ready = true;
+	}
+
+	node->xslice_reader = palloc0(sizeof(shareinput_Xslice_reader));
+	node->isready = true;
+}
+
 /*
  * init_tuplestore_state
  *    Initialize the tuplestore state for the Shared node if the state
@@ -205,7 +327,7 @@ static void ExecShareInputScanExplainEnd(PlanState *planstate, struct StringInfo
 static void
 init_tuplestore_state(ShareInputScanState *node)
 {
-	EState	   *estate = node->ss.ps.state;
+	EState	   *estate PG_USED_FOR_ASSERTS_ONLY = node->ss.ps.state;
 	ShareInputScan *sisc = (ShareInputScan *) node->ss.ps.plan;
 	shareinput_local_state *local_state = node->local_state;
 	Tuplestorestate *ts;
@@ -218,105 +340,38 @@ init_tuplestore_state(ShareInputScanState *node)
 
 	if (sisc->cross_slice)
 	{
-		if (!node->ref)
-			elog(ERROR, "cannot execute ShareInputScan that was not initialized");
+		init_xslice_state(node);
+		return;
 	}
 
 	if (!local_state->ready)
 	{
-		if (currentSliceId == sisc->producer_slice_id || estate->es_plannedstmt->numSlices == 1)
-		{
-			/* We are the producer */
-			if (sisc->cross_slice)
-			{
-				char		rwfile_prefix[100];
-
-				elog(DEBUG1, "SISC writer (shareid=%d, slice=%d): No tuplestore yet, creating tuplestore",
-					 sisc->share_id, currentSliceId);
+		Assert(currentSliceId == sisc->producer_slice_id || estate->es_plannedstmt->numSlices == 1);
 
-				ts = tuplestore_begin_heap(true, /* randomAccess */
-										   false, /* interXact */
-										   10); /* maxKBytes FIXME */
+		ts = tuplestore_begin_heap(true, /* randomAccess */
+								   false, /* interXact */
+								   PlanStateOperatorMemKB((PlanState *) node));
 
-				shareinput_create_bufname_prefix(rwfile_prefix, sizeof(rwfile_prefix), sisc->share_id);
-				tuplestore_make_shared(ts,
-									   get_shareinput_fileset(),
-									   rwfile_prefix);
-#ifdef FAULT_INJECTOR
-				if (SIMPLE_FAULT_INJECTOR("sisc_xslice_temp_files") == FaultInjectorTypeSkip)
-				{
-					const char *filename = tuplestore_get_buffilename(ts);
-					if (!filename)
-						ereport(NOTICE, (errmsg("sisc_xslice: buffilename is null")));
-					else if (strstr(filename, "base/" PG_TEMP_FILES_DIR) == filename)
-						ereport(NOTICE, (errmsg("sisc_xslice: Use default tablespace")));
-					else if (strstr(filename, "pg_tblspc/") == filename)
-						ereport(NOTICE, (errmsg("sisc_xslice: Use temp tablespace")));
-					else
-						ereport(NOTICE, (errmsg("sisc_xslice: Unexpected prefix of the tablespace path")));
-				}
-#endif
-			}
-			else
-			{
-				/* intra-slice */
-				ts = tuplestore_begin_heap(true, /* randomAccess */
-										   false, /* interXact */
-										   PlanStateOperatorMemKB((PlanState *) node));
-
-				/*
-				 * Offer extra memory usage info for EXPLAIN ANALYZE.
-				 *
-				 * If this is a cross-slice share, the tuplestore uses very
-				 * little memory, because it has to materialize the result on
-				 * a file anyway, so that it can be shared across processes.
-				 * In that case, reporting memory usage doesn't make much
-				 * sense. The "work_mem wanted" value would particularly
-				 * non-sensical, as we we would write to a file regardless of
-				 * work_mem. So only track memory usage in the non-cross-slice
-				 * case.
-				 */
-				if (node->ss.ps.instrument && node->ss.ps.instrument->need_cdb)
-				{
-					/* Let the tuplestore share our Instrumentation object. */
-					tuplestore_set_instrument(ts, node->ss.ps.instrument);
-
-					/* Request a callback at end of query. */
-					node->ss.ps.cdbexplainfun = ExecShareInputScanExplainEnd;
-				}
-			}
-
-			for (;;)
-			{
-				outerslot = ExecProcNode(local_state->childState);
-				if (TupIsNull(outerslot))
-					break;
-				tuplestore_puttupleslot(ts, outerslot);
-			}
-
-			if (sisc->cross_slice)
-			{
-				tuplestore_freeze(ts);
-				shareinput_writer_notifyready(node->ref);
-			}
+		/* Offer extra memory usage info for EXPLAIN ANALYZE. */
+		if (node->ss.ps.instrument && node->ss.ps.instrument->need_cdb)
+		{
+			/* Let the tuplestore share our Instrumentation object. */
+			tuplestore_set_instrument(ts, node->ss.ps.instrument);
 
-			tuplestore_rescan(ts);
+			/* Request a callback at end of query. */
+			node->ss.ps.cdbexplainfun = ExecShareInputScanExplainEnd;
 		}
-		else
-		{
-			/*
-			 * We are a consumer slice. Wait for the producer to create the
-			 * tuplestore.
-			 */
-			char		rwfile_prefix[100];
 
-			Assert(sisc->cross_slice);
+		for (;;)
+		{
+			outerslot = ExecProcNode(local_state->childState);
+			if (TupIsNull(outerslot))
+				break;
+			tuplestore_puttupleslot(ts, outerslot);
+		}
 
-			shareinput_reader_waitready(node->ref);
+		tuplestore_rescan(ts);
 
-			shareinput_create_bufname_prefix(rwfile_prefix, sizeof(rwfile_prefix), sisc->share_id);
-			ts = tuplestore_open_shared(get_shareinput_fileset(), rwfile_prefix);
-		}
 		local_state->ts_state = ts;
 		local_state->ready = true;
 		tsptrno = 0;
@@ -371,23 +426,25 @@ ExecShareInputScan(PlanState *pstate)
 
 	Assert(!node->local_state->closed);
 
-	tuplestore_select_read_pointer(node->ts_state, node->ts_pos);
-	while(1)
+	if (sisc->cross_slice)
 	{
-		bool		gotOK;
+		/* the shared store is only read forward, GPDB has no backward scans */
+		if (!forward)
+			elog(ERROR, "backward scan of a cross-slice ShareInputScan is not supported");
 
-		gotOK = tuplestore_gettupleslot(node->ts_state, forward, false, slot);
-
-		if (!gotOK)
+		if (!shareinput_reader_gettuple(node, slot))
+			return NULL;
+	}
+	else
+	{
+		tuplestore_select_read_pointer(node->ts_state, node->ts_pos);
+		if (!tuplestore_gettupleslot(node->ts_state, forward, false, slot))
 			return NULL;
-
-		SIMPLE_FAULT_INJECTOR("execshare_input_next");
-
-		return slot;
 	}
 
-	Assert(!"should not be here");
-	return NULL;
+	SIMPLE_FAULT_INJECTOR("execshare_input_next");
+
+	return slot;
 }
 
 /*  ------------------------------------------------------------------
@@ -411,6 +468,7 @@ ExecInitShareInputScan(ShareInputScan *node, EState *estate, int eflags)
 
 	sisstate->ts_state = NULL;
 	sisstate->ts_pos = -1;
+	sisstate->xslice_reader = NULL;
 
 	/*
 	 * init child node.
@@ -561,6 +619,23 @@ ExecEndShareInputScan(ShareInputScanState *node)
 		node->ref = NULL;
 	}
 
+	if (node->xslice_reader)
+	{
+		if (node->xslice_reader->segment_ts)
+			tuplestore_end(node->xslice_reader->segment_ts);
+		pfree(node->xslice_reader);
+		node->xslice_reader = NULL;
+	}
+
+	/*
+	 * Release the shared store of a cross-slice share, unless this is an
+	 * alien node. In the producer slice, every scan has waited for the
+	 * consumers to finish above.
+	 */
+	if (local_state && sisc->cross_slice &&
+		(sisc->this_slice_id == currentSliceId || estate->es_plannedstmt->numSlices == 1))
+		shareinput_release_store(local_state);
+
 	if (local_state && local_state->ts_state)
 	{
 		tuplestore_end(local_state->ts_state);
@@ -587,6 +662,13 @@ ExecReScanShareInputScan(ShareInputScanState *node)
 		init_tuplestore_state(node);
 
 	ExecClearTuple(node->ss.ps.ps_ResultTupleSlot);
+
+	if (node->xslice_reader)
+	{
+		shareinput_reader_rescan(node);
+		return;
+	}
+
 	Assert(node->ts_pos != -1);
 
 	tuplestore_select_read_pointer(node->ts_state, node->ts_pos);
@@ -814,6 +896,9 @@ get_shareinput_reference(int share_id)
 		xslice_state->refcount = 0;
 		pg_atomic_init_u32(&xslice_state->ready, 0);
 		pg_atomic_init_u32(&xslice_state->ndone, 0);
+		pg_atomic_init_u32(&xslice_state->nchunks, 0);
+		pg_atomic_init_u32(&xslice_state->overflowed, 0);
+		pg_atomic_init_u32(&xslice_state->nsegments, 0);
 
 		ConditionVariableInit(&xslice_state->ready_done_cv);
 	}
@@ -894,50 +979,418 @@ shareinput_release_callback(ResourceReleasePhase phase,
 }
 
 /*
- * shareinput_reader_waitready
+ * Construct the name of an overflow file of a cross-slice share.
+ */
+static void
+shareinput_create_segment_name(char *p, int size, int share_id, int segno)
+{
+	char		prefix[100];
+
+	shareinput_create_bufname_prefix(prefix, sizeof(prefix), share_id);
+	snprintf(p, size, "%s_%d", prefix, segno);
+}
+
+/*
+ * Get the shared memory chunk 'chunkno' of a cross-slice share, attaching
+ * to it if this process hasn't yet.
+ */
+static shareinput_chunk *
+shareinput_get_chunk(shareinput_local_state *local_state,
+					 shareinput_Xslice_state *state, int chunkno)
+{
+	dsm_segment *seg = local_state->chunk_segs[chunkno];
+
+	if (seg == NULL)
+	{
+		seg = dsm_attach(state->chunks[chunkno]);
+		if (seg == NULL)
+			elog(ERROR, "could not attach to ShareInputScan chunk %d", chunkno);
+		local_state->chunk_segs[chunkno] = seg;
+	}
+
+	return (shareinput_chunk *) dsm_segment_address(seg);
+}
+
+/*
+ * Publish the tuples the producer has written into the current chunk, and
+ * wake up the consumers waiting for them.
+ */
+static void
+shareinput_writer_publish(shareinput_local_state *local_state,
+						  shareinput_Xslice_state *state, bool seal)
+{
+	if (local_state->nchunks > 0)
+	{
+		shareinput_chunk *chunk = (shareinput_chunk *)
+			dsm_segment_address(local_state->chunk_segs[local_state->nchunks - 1]);
+
+		/* the tuples must be visible before their space is published */
+		pg_write_barrier();
+		pg_atomic_write_u64(&chunk->used, local_state->mem_used);
+		if (seal)
+		{
+			pg_write_barrier();
+			pg_atomic_write_u32(&chunk->sealed, 1);
+		}
+	}
+	local_state->mem_unnotified = 0;
+
+	ConditionVariableBroadcast(&state->ready_done_cv);
+}
+
+/*
+ * Start a new shared memory chunk with room for at least 'len' bytes of
+ * tuples, sealing the current one. Returns false if there is no room for it
+ * in the producer's memory budget.
+ */
+static bool
+shareinput_writer_newchunk(ShareInputScanState *node, Size len)
+{
+	shareinput_local_state *local_state = node->local_state;
+	shareinput_Xslice_state *state = node->ref->xslice_state;
+	Size		budget = (Size) PlanStateOperatorMemKB((PlanState *) node) * 1024;
+	Size		size;
+	dsm_segment *seg;
+	shareinput_chunk *chunk;
+
+	if (local_state->nchunks == SHAREINPUT_MAX_CHUNKS)
+		return false;
+
+#ifdef FAULT_INJECTOR
+	/* tests force the overflow to files with this */
+	if (SIMPLE_FAULT_INJECTOR("sisc_xslice_new_chunk") == FaultInjectorTypeSkip)
+		return false;
+#endif
+
+	size = SHAREINPUT_FIRST_CHUNK_SIZE << local_state->nchunks;
+	size = Max(size, SHAREINPUT_CHUNK_HEADER_SIZE + len);
+	if (local_state->mem_allocated + size > budget)
+	{
+		size = budget - Min(budget, local_state->mem_allocated);
+		if (size < SHAREINPUT_CHUNK_HEADER_SIZE + len)
+			return false;
+	}
+
+	seg = dsm_create(size, DSM_CREATE_NULL_IF_MAXSEGMENTS);
+	if (seg == NULL)
+		return false;
+
+	chunk = (shareinput_chunk *) dsm_segment_address(seg);
+	pg_atomic_init_u64(&chunk->used, 0);
+	pg_atomic_init_u32(&chunk->sealed, 0);
+
+	/* seal the current chunk */
+	shareinput_writer_publish(local_state, state, true);
+
+	local_state->chunk_segs[local_state->nchunks] = seg;
+	local_state->mem_allocated += size;
+	local_state->mem_used = 0;
+
+	state->chunks[local_state->nchunks] = dsm_segment_handle(seg);
+	pg_write_barrier();
+	pg_atomic_write_u32(&state->nchunks, ++local_state->nchunks);
+
+	return true;
+}
+
+/*
+ * Freeze the overflow file being written, and hand it to the consumers.
+ */
+static void
+shareinput_writer_freeze_segment(shareinput_local_state *local_state,
+								 shareinput_Xslice_state *state)
+{
+	tuplestore_freeze(local_state->segment_ts);
+	local_state->segments = lappend(local_state->segments, local_state->segment_ts);
+	local_state->segment_ts = NULL;
+	local_state->segment_size = 0;
+
+	pg_write_barrier();
+	pg_atomic_write_u32(&state->nsegments, ++local_state->nsegments);
+
+	ConditionVariableBroadcast(&state->ready_done_cv);
+}
+
+/*
+ * shareinput_writer_puttuple
  *
- *  Called by the reader (consumer) to wait for the writer (producer) to produce
- *  all the tuples and write them to disk.
+ *  Called by the writer (producer) to add a tuple to the shared store. The
+ *  tuple goes to shared memory if there is room for it in the operator
+ *  memory, or to an overflow file otherwise.
+ */
+static void
+shareinput_writer_puttuple(ShareInputScanState *node, TupleTableSlot *slot)
+{
+	ShareInputScan *sisc = (ShareInputScan *) node->ss.ps.plan;
+	shareinput_local_state *local_state = node->local_state;
+	shareinput_Xslice_state *state = node->ref->xslice_state;
+	bool		shouldFree;
+	MinimalTuple tuple;
+	Size		len;
+
+	tuple = ExecFetchSlotMinimalTuple(slot, &shouldFree);
+	len = MAXALIGN(tuple->t_len);
+
+	if (!local_state->overflowed)
+	{
+		Size		chunk_size = 0;
+
+		if (local_state->nchunks > 0)
+			chunk_size = dsm_segment_map_length(local_state->chunk_segs[local_state->nchunks - 1]) -
+				SHAREINPUT_CHUNK_HEADER_SIZE;
+
+		if (local_state->mem_used + len <= chunk_size ||
+			shareinput_writer_newchunk(node, len))
+		{
+			shareinput_chunk *chunk = (shareinput_chunk *)
+				dsm_segment_address(local_state->chunk_segs[local_state->nchunks - 1]);
+
+			memcpy(SHAREINPUT_CHUNK_DATA(chunk) + local_state->mem_used, tuple, tuple->t_len);
+			local_state->mem_used += len;
+			local_state->mem_unnotified += len;
+
+			if (local_state->mem_unnotified >= SHAREINPUT_NOTIFY_SIZE)
+				shareinput_writer_publish(local_state, state, false);
+
+			if (shouldFree)
+				pfree(tuple);
+			return;
+		}
+
+		/* the rest of the tuples go to overflow files */
+		elog(DEBUG1, "SISC writer (shareid=%d, slice=%d): shared memory is full, overflowing to files",
+			 sisc->share_id, currentSliceId);
+
+		shareinput_writer_publish(local_state, state, true);
+		local_state->overflowed = true;
+		pg_write_barrier();
+		pg_atomic_write_u32(&state->overflowed, 1);
+	}
+
+	if (local_state->segment_ts == NULL)
+	{
+		char		segment_name[MAXPGPATH];
+
+		shareinput_create_segment_name(segment_name, sizeof(segment_name),
+									   sisc->share_id, local_state->nsegments);
+
+		local_state->segment_ts = tuplestore_begin_heap(true, /* randomAccess */
+														false, /* interXact */
+														10); /* maxKBytes, written to the file anyway */
+		tuplestore_make_shared(local_state->segment_ts,
+							   get_shareinput_fileset(),
+							   segment_name);
+#ifdef FAULT_INJECTOR
+		if (SIMPLE_FAULT_INJECTOR("sisc_xslice_temp_files") == FaultInjectorTypeSkip)
+		{
+			const char *filename = tuplestore_get_buffilename(local_state->segment_ts);
+			if (!filename)
+				ereport(NOTICE, (errmsg("sisc_xslice: buffilename is null")));
+			else if (strstr(filename, "base/" PG_TEMP_FILES_DIR) == filename)
+				ereport(NOTICE, (errmsg("sisc_xslice: Use default tablespace")));
+			else if (strstr(filename, "pg_tblspc/") == filename)
+				ereport(NOTICE, (errmsg("sisc_xslice: Use temp tablespace")));
+			else
+				ereport(NOTICE, (errmsg("sisc_xslice: Unexpected prefix of the tablespace path")));
+		}
+#endif
+	}
+
+	tuplestore_puttupleslot(local_state->segment_ts, slot);
+	local_state->segment_size += len;
+
+	if (local_state->segment_size >= SHAREINPUT_SEGMENT_SIZE)
+		shareinput_writer_freeze_segment(local_state, state);
+#ifdef FAULT_INJECTOR
+	/* tests hand over smaller files with this */
+	else if (SIMPLE_FAULT_INJECTOR("sisc_xslice_freeze_file") == FaultInjectorTypeSkip)
+		shareinput_writer_freeze_segment(local_state, state);
+#endif
+
+	if (shouldFree)
+		pfree(tuple);
+}
+
+/*
+ * shareinput_writer_finish
  *
- *  This is a blocking operation.
+ *  Called by the writer (producer) once it has added all the tuples to the
+ *  shared store.
  */
 static void
-shareinput_reader_waitready(shareinput_Xslice_reference *ref)
+shareinput_writer_finish(ShareInputScanState *node)
 {
-	shareinput_Xslice_state *state = ref->xslice_state;
+	shareinput_local_state *local_state = node->local_state;
+	shareinput_Xslice_state *state = node->ref->xslice_state;
 
-	elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Waiting for producer",
-		 ref->share_id, currentSliceId);
+	if (local_state->overflowed)
+	{
+		if (local_state->segment_ts)
+			shareinput_writer_freeze_segment(local_state, state);
+	}
+	else
+		shareinput_writer_publish(local_state, state, true);
+
+	shareinput_writer_notifyready(node->ref);
+}
+
+/*
+ * shareinput_reader_gettuple
+ *
+ *  Called by the readers (consumers, and the producer itself) to get the
+ *  next tuple from the shared store, waiting for the producer to publish
+ *  it if needed. Returns false at the end of the store.
+ */
+static bool
+shareinput_reader_gettuple(ShareInputScanState *node, TupleTableSlot *slot)
+{
+	shareinput_Xslice_reader *reader = node->xslice_reader;
+	shareinput_local_state *local_state = node->local_state;
+	shareinput_Xslice_state *state = node->ref->xslice_state;
 
-	/*
-	 * Wait until the the producer sets 'ready' to true. The producer will
-	 * use the condition variable to wake us up.
-	 */
 	for (;;)
 	{
+		uint32		ready;
+		uint32		overflowed;
+
 		/*
-		 * set state->ready via pg_atomic_exchange_u32() in shareinput_writer_notifyready()
-		 * it acts as a memory barrier, so always get the latest value here
+		 * Read the flags before the counts; whatever was published before
+		 * the flags were set is then included in the counts.
 		 */
-		int ready = pg_atomic_read_u32(&state->ready);
-		if (ready)
-			break;
+		ready = pg_atomic_read_u32(&state->ready);
+		overflowed = pg_atomic_read_u32(&state->overflowed);
+		pg_read_barrier();
+
+		if (!reader->in_segments)
+		{
+			if (reader->chunkno < (int) pg_atomic_read_u32(&state->nchunks))
+			{
+				shareinput_chunk *chunk;
+				uint32		sealed;
+				Size		used;
+
+				pg_read_barrier();
+				chunk = shareinput_get_chunk(local_state, state, reader->chunkno);
+				sealed = pg_atomic_read_u32(&chunk->sealed);
+				pg_read_barrier();
+				used = pg_atomic_read_u64(&chunk->used);
+				pg_read_barrier();
+
+				if (reader->offset < used)
+				{
+					MinimalTuple tuple = (MinimalTuple)
+						(SHAREINPUT_CHUNK_DATA(chunk) + reader->offset);
 
+					reader->offset += MAXALIGN(tuple->t_len);
+					ExecStoreMinimalTuple(tuple, slot, false);
+					ConditionVariableCancelSleep();
+					return true;
+				}
+				if (sealed)
+				{
+					reader->chunkno++;
+					reader->offset = 0;
+					continue;
+				}
+			}
+			else if (overflowed)
+			{
+				reader->in_segments = true;
+				continue;
+			}
+			else if (ready)
+				break;
+		}
+		else
+		{
+			if (reader->segment_ts)
+			{
+				if (tuplestore_gettupleslot(reader->segment_ts, true, false, slot))
+				{
+					ConditionVariableCancelSleep();
+					return true;
+				}
+				tuplestore_end(reader->segment_ts);
+				reader->segment_ts = NULL;
+				reader->segno++;
+				continue;
+			}
+			if (reader->segno < (int) pg_atomic_read_u32(&state->nsegments))
+			{
+				char		segment_name[MAXPGPATH];
+
+				shareinput_create_segment_name(segment_name, sizeof(segment_name),
+											   ((ShareInputScan *) node->ss.ps.plan)->share_id,
+											   reader->segno);
+				reader->segment_ts = tuplestore_open_shared(get_shareinput_fileset(),
+															segment_name);
+				continue;
+			}
+			if (ready)
+				break;
+		}
+
+		/* wait for the producer to publish more tuples */
 		ConditionVariableSleep(&state->ready_done_cv, WAIT_EVENT_SHAREINPUT_SCAN);
 	}
 	ConditionVariableCancelSleep();
 
-	/* it's ready now */
-	elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Wait ready got writer's handshake",
-		 ref->share_id, currentSliceId);
+	return false;
+}
+
+/*
+ * shareinput_reader_rescan
+ *
+ *  Rewind a reader to the beginning of the shared store.
+ */
+static void
+shareinput_reader_rescan(ShareInputScanState *node)
+{
+	shareinput_Xslice_reader *reader = node->xslice_reader;
+
+	if (reader->segment_ts)
+		tuplestore_end(reader->segment_ts);
+	memset(reader, 0, sizeof(shareinput_Xslice_reader));
+}
+
+/*
+ * shareinput_release_store
+ *
+ *  Release this process's part of the shared store of a cross-slice share:
+ *  the mappings of the shared memory chunks, and in the producer, the
+ *  overflow files.
+ */
+static void
+shareinput_release_store(shareinput_local_state *local_state)
+{
+	ListCell   *lc;
+
+	for (int i = 0; i < SHAREINPUT_MAX_CHUNKS; i++)
+	{
+		if (local_state->chunk_segs[i])
+		{
+			dsm_detach(local_state->chunk_segs[i]);
+			local_state->chunk_segs[i] = NULL;
+		}
+	}
+
+	if (local_state->segment_ts)
+	{
+		tuplestore_end(local_state->segment_ts);
+		local_state->segment_ts = NULL;
+	}
+	foreach(lc, local_state->segments)
+		tuplestore_end((Tuplestorestate *) lfirst(lc));
+	list_free(local_state->segments);
+	local_state->segments = NIL;
 }
 
 /*
  * shareinput_writer_notifyready
  *
- *  Called by the writer (producer) once it is done producing all tuples and
- *  writing them to disk. It notifies all the readers (consumers) that tuples
- *  are ready to be read from disk.
+ *  Called by the writer (producer) once it is done producing all tuples.
+ *  It notifies all the readers (consumers) that the shared store is
+ *  complete.
  */
 static void
 shareinput_writer_notifyready(shareinput_Xslice_reference *ref)
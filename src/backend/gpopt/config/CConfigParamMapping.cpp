@@ -172,6 +172,21 @@ CConfigParamMapping::SConfigMappingElem CConfigParamMapping::m_elements[] = {
 	 GPOS_WSZ_LIT(
 		 "Enable stats derivation of partitioned tables with dynamic partition elimination.")},
 
+	{EopttraceTextRangeStats, &optimizer_enable_text_range_stats,
+	 false,	 // m_negate_param
+	 GPOS_WSZ_LIT(
+		 "Use histograms of string columns for range predicates.")},
+
+	{EopttraceDynamicSampling, &optimizer_enable_dynamic_sampling,
+	 false,	 // m_negate_param
+	 GPOS_WSZ_LIT(
+		 "Estimate unsupported predicates on a sample of the table.")},
+
+	{EopttraceCardinalityFeedback, &optimizer_enable_cardinality_feedback,
+	 false,	 // m_negate_param
+	 GPOS_WSZ_LIT(
+		 "Correct cardinality estimates with the actual rows of executed plans.")},
+
 	{EopttraceEnumeratePlans, &optimizer_enumerate_plans,
 	 false,	 // m_negate_param
 	 GPOS_WSZ_LIT("Enable plan enumeration.")},
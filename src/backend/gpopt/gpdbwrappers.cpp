@@ -504,6 +504,17 @@ gpdb::ExtractNodesExpression(Node *node, int node_tag,
 	return NIL;
 }
 
+bool
+gpdb::ContainVarsOfLevel(Node *node, int levelsup)
+{
+	GP_WRAP_START;
+	{
+		return contain_vars_of_level(node, levelsup);
+	}
+	GP_WRAP_END;
+	return false;
+}
+
 void
 gpdb::FreeAttrStatsSlot(AttStatsSlot *sslot)
 {
@@ -2014,6 +2025,29 @@ gpdb::CdbEstimatePartitionedNumTuples(Relation rel)
 	GP_WRAP_END;
 }
 
+bool
+gpdb::SampleQualSelectivity(Oid relid, Node *qual, int *budget,
+							double *selectivity)
+{
+	GP_WRAP_START;
+	{
+		return cdbSampleQualSelectivity(relid, qual, budget, selectivity);
+	}
+	GP_WRAP_END;
+	return false;
+}
+
+bool
+gpdb::CardinalityFeedback(uint64 key, double *rows)
+{
+	GP_WRAP_START;
+	{
+		return CardFeedbackLookup(key, rows);
+	}
+	GP_WRAP_END;
+	return false;
+}
+
 void
 gpdb::CloseRelation(Relation rel)
 {
@@ -2739,6 +2773,17 @@ gpdb::UUIDHash(Datum d)
 	GP_WRAP_END;
 }
 
+bool
+gpdb::GetSortKeyPrefix(Oid typid, Datum d, uint64 *prefix)
+{
+	GP_WRAP_START;
+	{
+		return SortSupportKeyPrefix(typid, d, prefix);
+	}
+	GP_WRAP_END;
+	return false;
+}
+
 void *
 gpdb::GPDBMemoryContextAlloc(MemoryContext context, Size size)
 {
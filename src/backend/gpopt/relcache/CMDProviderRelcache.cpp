@@ -17,16 +17,23 @@
 extern "C" {
 #include "postgres.h"
 }
+#include "gpopt/gpdbwrappers.h"
 #include "gpopt/mdcache/CMDAccessor.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
+#include "gpopt/translate/CDXLTranslateContextBaseTable.h"
+#include "gpopt/translate/CMappingColIdVarPlStmt.h"
+#include "gpopt/translate/CTranslatorDXLToScalar.h"
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
 #include "naucrates/dxl/CDXLUtils.h"
 #include "naucrates/exception.h"
+#include "naucrates/md/CMDIdGPDB.h"
 
 using namespace gpos;
 using namespace gpdxl;
 using namespace gpmd;
 
+extern int optimizer_dynamic_sampling_budget;
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMDProviderRelcache::CMDProviderRelcache
@@ -35,7 +42,8 @@ using namespace gpmd;
 //		Constructs a file-based metadata provider
 //
 //---------------------------------------------------------------------------
-CMDProviderRelcache::CMDProviderRelcache(CMemoryPool *mp) : m_mp(mp)
+CMDProviderRelcache::CMDProviderRelcache(CMemoryPool *mp)
+	: m_mp(mp), m_sampling_budget(optimizer_dynamic_sampling_budget)
 {
 	GPOS_ASSERT(nullptr != m_mp);
 }
@@ -78,4 +86,65 @@ CMDProviderRelcache::GetMDObj(CMemoryPool *mp, CMDAccessor *md_accessor,
 	return md_obj;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDProviderRelcache::SampleSelectivity
+//
+//	@doc:
+//		Translate the predicate into an expression on the relation, and
+//		evaluate it on a sample of the relation
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDProviderRelcache::SampleSelectivity(CMemoryPool *mp,
+									   CMDAccessor *md_accessor,
+									   IMDId *rel_mdid, const CDXLNode *pred_dxl,
+									   UlongToIntMap *colid_to_attno,
+									   CDouble *selectivity)
+{
+	// the predicate refers to the relation as the only range table entry
+	CDXLTranslateContextBaseTable base_table_context(mp);
+	base_table_context.SetRelIndex(1);
+
+	UlongToIntMapIter colid_to_attno_iter(colid_to_attno);
+	while (colid_to_attno_iter.Advance())
+	{
+		base_table_context.InsertMapping(*colid_to_attno_iter.Key(),
+										 *colid_to_attno_iter.Value());
+	}
+
+	CMappingColIdVarPlStmt colid_var_mapping(mp, &base_table_context,
+											 nullptr /*child_contexts*/,
+											 nullptr /*output_context*/,
+											 nullptr /*dxl_to_plstmt_context*/);
+	CTranslatorDXLToScalar dxl_to_scalar_translator(mp, md_accessor,
+													0 /*num_segments*/);
+	Expr *qual = dxl_to_scalar_translator.TranslateDXLToScalar(
+		pred_dxl, &colid_var_mapping);
+
+	double sampled_selectivity;
+	if (!gpdb::SampleQualSelectivity(CMDIdGPDB::CastMdid(rel_mdid)->Oid(),
+									 (Node *) qual, &m_sampling_budget,
+									 &sampled_selectivity))
+	{
+		return false;
+	}
+
+	*selectivity = CDouble(sampled_selectivity);
+	return true;
+}
+
+BOOL
+CMDProviderRelcache::CardinalityFeedback(ULLONG key, CDouble *rows)
+{
+	double feedback_rows;
+	if (!gpdb::CardinalityFeedback(key, &feedback_rows))
+	{
+		return false;
+	}
+
+	*rows = CDouble(feedback_rows);
+	return true;
+}
+
 // EOF
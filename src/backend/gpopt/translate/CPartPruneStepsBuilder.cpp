@@ -31,34 +31,43 @@ using namespace gpdxl;
 
 // ctor
 CPartPruneStepsBuilder::CPartPruneStepsBuilder(
-	Relation relation, Index rtindex, ULongPtrArray *part_indexes,
+	ULongPtrArray *part_indexes, CDXLNode *filterNode, ULONG num_levels,
 	CMappingColIdVarPlStmt *colid_var_mapping,
-	CTranslatorDXLToScalar *translator_dxl_to_scalar)
-	: m_relation(relation),
-	  m_rtindex(rtindex),
-	  m_part_indexes(part_indexes),
+	CTranslatorDXLToScalar *translator_dxl_to_scalar,
+	CContextDXLToPlStmt *dxl_to_plstmt_context)
+	: m_part_indexes(part_indexes),
+	  m_filter_node(filterNode),
+	  m_num_levels(num_levels),
 	  m_colid_var_mapping(colid_var_mapping),
-	  m_translator_dxl_to_scalar(translator_dxl_to_scalar)
+	  m_translator_dxl_to_scalar(translator_dxl_to_scalar),
+	  m_dxl_to_plstmt_context(dxl_to_plstmt_context)
 {
 }
 
 List *
 CPartPruneStepsBuilder::CreatePartPruneInfos(
 	CDXLNode *filterNode, Relation relation, Index rtindex,
-	ULongPtrArray *part_indexes, CMappingColIdVarPlStmt *colid_var_mapping,
-	CTranslatorDXLToScalar *translator_dxl_to_scalar)
+	ULongPtrArray *part_indexes, ULONG num_levels,
+	CMappingColIdVarPlStmt *colid_var_mapping,
+	CTranslatorDXLToScalar *translator_dxl_to_scalar,
+	CContextDXLToPlStmt *dxl_to_plstmt_context)
 {
-	CPartPruneStepsBuilder builder(relation, rtindex, part_indexes,
-								   colid_var_mapping, translator_dxl_to_scalar);
+	CPartPruneStepsBuilder builder(part_indexes, filterNode, num_levels,
+								   colid_var_mapping, translator_dxl_to_scalar,
+								   dxl_to_plstmt_context);
 
 	// See comments over PartitionPruneInfo::prune_infos for more details.
 
-	// ORCA only supports single-level partitioned tables for which only one
-	// list of pruning steps is needed.
-	// So, size of 2nd dimension of (prune_infos) = 1
-	PartitionedRelPruneInfo *pinfo =
-		builder.CreatePartPruneInfoForOneLevel(filterNode);
-	List *prune_info_per_hierarchy = ListMake1(pinfo);
+	// There is one list of pruning steps for each partitioned table of the
+	// hierarchy that has unpruned partitions, a parent before its
+	// sub-partitioned tables. So, size of 2nd dimension of (prune_infos) =
+	// number of those partitioned tables
+	List *prune_info_per_hierarchy = NIL;
+	ULONG leaf_idx = 0;
+	ULONG part_ptr = 0;
+	builder.CreatePartPruneInfosForLevel(relation, rtindex, 0 /* level */,
+										 &prune_info_per_hierarchy, &leaf_idx,
+										 &part_ptr);
 
 	// Since ORCA translates each DynamicTableScan to a different Append node,
 	// there is always only one partition hierarchy per Append/ PartitionSelector
@@ -66,57 +75,140 @@ CPartPruneStepsBuilder::CreatePartPruneInfos(
 	return ListMake1(prune_info_per_hierarchy);
 }
 
-PartitionedRelPruneInfo *
-CPartPruneStepsBuilder::CreatePartPruneInfoForOneLevel(CDXLNode *filterNode)
+// Append the PartitionedRelPruneInfo of a partitioned table at the given
+// level, followed by those of its sub-partitioned tables, to pinfos. Returns
+// whether any partition below it survived static partition pruning.
+BOOL
+CPartPruneStepsBuilder::CreatePartPruneInfosForLevel(Relation relation,
+													 Index rtindex, ULONG level,
+													 List **pinfos,
+													 ULONG *leaf_idx,
+													 ULONG *part_ptr)
 {
+	PartitionDesc partdesc = RelationGetPartitionDesc(relation, true);
+
 	PartitionedRelPruneInfo *pinfo = MakeNode(PartitionedRelPruneInfo);
-	pinfo->rtindex = m_rtindex;
+	pinfo->rtindex = rtindex;
 
-	pinfo->nparts = RelationGetPartitionDesc(m_relation, true)->nparts;
+	pinfo->nparts = partdesc->nparts;
 
 	pinfo->subpart_map = (int *) palloc(sizeof(int) * pinfo->nparts);
 	pinfo->subplan_map = (int *) palloc(sizeof(int) * pinfo->nparts);
-	pinfo->relid_map = (Oid *) palloc(sizeof(int) * pinfo->nparts);
+	pinfo->relid_map = (Oid *) palloc(sizeof(Oid) * pinfo->nparts);
 
-	// m_part_indexes contains the indexes (into m_relation->rd_pardesc) of the
-	// partitions that survived static partition pruning; iterate over this list
-	// to populate pinfo->subplan_map, pinfo->relid_map & pinfo->present_parts
-	ULONG part_ptr = 0;
+	*pinfos = gpdb::LAppend(*pinfos, pinfo);
+
+	// m_part_indexes contains the indexes (into the leaf partitions of the
+	// hierarchy, depth first, see CTranslatorRelcacheToDXL::RetrieveLeafPartitions)
+	// of the partitions that survived static partition pruning; walk the
+	// hierarchy in the same order to populate pinfo->subplan_map,
+	// pinfo->subpart_map, pinfo->relid_map & pinfo->present_parts
 	for (int i = 0; i < pinfo->nparts; ++i)
 	{
+		pinfo->subplan_map[i] = -1;
 		pinfo->subpart_map[i] = -1;
-		if (part_ptr < m_part_indexes->Size() &&
-			i == (int)(*(*m_part_indexes)[part_ptr]))
+		pinfo->relid_map[i] = InvalidOid;
+
+		if (!partdesc->is_leaf[i])
 		{
-			// partition did survive pruning
-			pinfo->subplan_map[i] = part_ptr;
-			pinfo->relid_map[i] = RelationGetPartitionDesc(m_relation, true)->oids[i];
-			pinfo->present_parts = bms_add_member(pinfo->present_parts, i);
-			++part_ptr;
+			// the sub-partitioned table gets the next PartitionedRelPruneInfo,
+			// unless all its partitions were pruned
+			gpdb::RelationWrapper child_rel =
+				gpdb::GetRelation(partdesc->oids[i]);
+			int subpart_idx = gpdb::ListLength(*pinfos);
+
+			if (CreatePartPruneInfosForLevel(
+					child_rel.get(), GetRTIndexForSubPartition(child_rel.get()),
+					level + 1, pinfos, leaf_idx, part_ptr))
+			{
+				pinfo->subpart_map[i] = subpart_idx;
+				pinfo->relid_map[i] = partdesc->oids[i];
+				pinfo->present_parts = bms_add_member(pinfo->present_parts, i);
+			}
+			else
+			{
+				*pinfos = list_truncate(*pinfos, subpart_idx);
+			}
+			continue;
 		}
-		else
+
+		if (*part_ptr < m_part_indexes->Size() &&
+			*leaf_idx == *(*m_part_indexes)[*part_ptr])
 		{
-			// partition did not survive pruning
-			pinfo->subplan_map[i] = part_ptr;
-			pinfo->subplan_map[i] = -1;
-			pinfo->relid_map[i] = 0;
+			// partition did survive pruning
+			pinfo->subplan_map[i] = *part_ptr;
+			pinfo->relid_map[i] = partdesc->oids[i];
+			pinfo->present_parts = bms_add_member(pinfo->present_parts, i);
+			++(*part_ptr);
 		}
+		++(*leaf_idx);
+	}
+
+	// a multi-level filter has a conjunct for each level, see
+	// CTranslatorExprToDXL::PdxlnPartSelectorFilterPerLevel(); a level without
+	// predicates has a true constant, and keeps all its partitions
+	CDXLNode *filterNode =
+		(1 == m_num_levels) ? m_filter_node : (*m_filter_node)[level];
+	if (EdxlopScalarConstValue != filterNode->GetOperator()->GetDXLOperator())
+	{
+		INT step_id = 0;
+		pinfo->exec_pruning_steps = PartPruneStepsFromFilter(
+			filterNode, RelationGetPartitionKey(relation), &step_id,
+			pinfo->exec_pruning_steps);
 	}
 
-	INT step_id = 0;
-	pinfo->exec_pruning_steps = PartPruneStepsFromFilter(
-		filterNode, &step_id, pinfo->exec_pruning_steps);
-	return pinfo;
+	return !bms_is_empty(pinfo->present_parts);
+}
+
+// The executor opens the sub-partitioned tables to prune their partitions,
+// so they need range table entries, and locks, like the root table.
+Index
+CPartPruneStepsBuilder::GetRTIndexForSubPartition(Relation relation)
+{
+	Oid oid = RelationGetRelid(relation);
+	Index rtindex = m_dxl_to_plstmt_context->FindRTE(oid);
+	if (0 < (INT) rtindex)
+	{
+		return rtindex;
+	}
+
+	gpdb::GPDBLockRelationOid(oid, AccessShareLock);
+
+	RangeTblEntry *rte = MakeNode(RangeTblEntry);
+	rte->rtekind = RTE_RELATION;
+	rte->relid = oid;
+	rte->requiredPerms |= ACL_NO_RIGHTS;
+	rte->rellockmode = AccessShareLock;
+
+	Alias *alias = MakeNode(Alias);
+	alias->aliasname = PStrDup(RelationGetRelationName(relation));
+	alias->colnames = NIL;
+	for (int att = 0; att < relation->rd_att->natts; att++)
+	{
+		Form_pg_attribute attr = TupleDescAttr(relation->rd_att, att);
+
+		// dropped columns get empty names, as in the root's entry
+		Value *val_colname = gpdb::MakeStringValue(
+			PStrDup(attr->attisdropped ? "" : NameStr(attr->attname)));
+		alias->colnames = gpdb::LAppend(alias->colnames, val_colname);
+	}
+	rte->eref = alias;
+
+	m_dxl_to_plstmt_context->AddRTE(rte);
+
+	return gpdb::ListLength(m_dxl_to_plstmt_context->GetRTableEntriesList());
 }
 
 List *
-CPartPruneStepsBuilder::PartPruneStepFromScalarCmp(CDXLNode *node, int *step_id,
+CPartPruneStepsBuilder::PartPruneStepFromScalarCmp(CDXLNode *node,
+												   PartitionKey partkey,
+												   INT *step_id,
 												   List *steps_list)
 {
 	GPOS_ASSERT(nullptr != node);
 	CDXLScalarComp *dxlop = CDXLScalarComp::Cast(node->GetOperator());
 	Oid opno = CMDIdGPDB::CastMdid(dxlop->MDId())->Oid();
-	Oid opfamily = RelationGetPartitionKey(m_relation)->partopfamily[0 /* col */];
+	Oid opfamily = partkey->partopfamily[0 /* col */];
 
 	// GPDB_12_MERGE_FIXME: This *should* be StrategyNumber, but IndexOpProperties takes an INT
 	INT strategy;
@@ -146,7 +238,7 @@ CPartPruneStepsBuilder::PartPruneStepFromScalarCmp(CDXLNode *node, int *step_id,
 	// to be part of partitioning column opfamily above.
 	// ORCA doesn't support multi-key (a.k.a composite) partition keys. So these
 	// lists will be of size 1.
-	step->cmpfns = ListMake1Oid(RelationGetPartitionKey(m_relation)->partsupfunc[0].fn_oid);
+	step->cmpfns = ListMake1Oid(partkey->partsupfunc[0].fn_oid);
 	step->exprs = ListMake1(expr);
 
 	return gpdb::LAppend(steps_list, (PartitionPruneStep *) step);
@@ -154,7 +246,8 @@ CPartPruneStepsBuilder::PartPruneStepFromScalarCmp(CDXLNode *node, int *step_id,
 
 List *
 CPartPruneStepsBuilder::PartPruneStepFromScalarBoolExpr(CDXLNode *node,
-														int *step_id,
+														PartitionKey partkey,
+														INT *step_id,
 														List *steps_list)
 {
 	GPOS_ASSERT(nullptr != node);
@@ -192,7 +285,8 @@ CPartPruneStepsBuilder::PartPruneStepFromScalarBoolExpr(CDXLNode *node,
 	for (ULONG ul = 0; ul < node->Arity(); ul++)
 	{
 		CDXLNode *child_node = (*node)[ul];
-		steps_list = PartPruneStepsFromFilter(child_node, step_id, steps_list);
+		steps_list =
+			PartPruneStepsFromFilter(child_node, partkey, step_id, steps_list);
 
 		PartitionPruneStep *last_step =
 			(PartitionPruneStep *) lfirst(gpdb::ListTail(steps_list));
@@ -208,8 +302,9 @@ CPartPruneStepsBuilder::PartPruneStepFromScalarBoolExpr(CDXLNode *node,
 }
 
 List *
-CPartPruneStepsBuilder::PartPruneStepsFromFilter(CDXLNode *node, INT *step_id,
-												 List *steps_list)
+CPartPruneStepsBuilder::PartPruneStepsFromFilter(CDXLNode *node,
+												 PartitionKey partkey,
+												 INT *step_id, List *steps_list)
 {
 	GPOS_ASSERT(nullptr != node);
 	Edxlopid eopid = node->GetOperator()->GetDXLOperator();
@@ -218,13 +313,14 @@ CPartPruneStepsBuilder::PartPruneStepsFromFilter(CDXLNode *node, INT *step_id,
 	{
 		case EdxlopScalarCmp:
 		{
-			steps_list = PartPruneStepFromScalarCmp(node, step_id, steps_list);
+			steps_list =
+				PartPruneStepFromScalarCmp(node, partkey, step_id, steps_list);
 			break;
 		}
 		case EdxlopScalarBoolExpr:
 		{
-			steps_list =
-				PartPruneStepFromScalarBoolExpr(node, step_id, steps_list);
+			steps_list = PartPruneStepFromScalarBoolExpr(node, partkey, step_id,
+														 steps_list);
 			break;
 		}
 		default:
@@ -411,6 +411,13 @@ CQueryMutators::RunGroupingColMutator(Node *node,
 					0  // flags -- mutate into cte-lists
 					));
 		}
+		// the filter is fixed like the arguments
+		aggref->aggfilter = (Expr *) gpdb::MutateQueryOrExpressionTree(
+			(Node *) gpdb::CopyObject(old_aggref->aggfilter),
+			(MutatorWalkerFn) CQueryMutators::RunGroupingColMutator,
+			(void *) context,
+			0  // flags -- mutate into cte-lists
+		);
 		context->m_is_mutating_agg_arg = is_agg;
 		aggref->args = new_args;
 
@@ -648,6 +655,11 @@ CQueryMutators::RunExtractAggregatesMutator(Node *node,
 						));
 			}
 			new_aggref->args = new_args;
+			new_aggref->aggfilter = (Expr *) gpdb::MutateQueryOrExpressionTree(
+				(Node *) old_aggref->aggfilter,
+				(MutatorWalkerFn) RunExtractAggregatesMutator, (void *) context,
+				0  // mutate into cte-lists
+			);
 			context->m_is_mutating_agg_arg = is_agg_old;
 			context->m_agg_levels_up = agg_levels_up;
 
@@ -1008,8 +1008,11 @@ CTranslatorDXLToPlStmt::TranslateIndexConditions(
 					 IsA(index_cond_expr, ScalarArrayOpExpr)) &&
 					"expected OpExpr or ScalarArrayOpExpr in index qual");
 
+		// ScalarArrayOpExpr conditions are supported by the array keys of
+		// btree and bitmap indexes
 		if (!is_bitmap_index_probe && IsA(index_cond_expr, ScalarArrayOpExpr) &&
-			IMDIndex::EmdindBitmap != index->IndexType())
+			IMDIndex::EmdindBitmap != index->IndexType() &&
+			IMDIndex::EmdindBtree != index->IndexType())
 		{
 			GPOS_RAISE(
 				gpdxl::ExmaDXL, gpdxl::ExmiDXL2PlStmtConversion,
@@ -1716,20 +1719,42 @@ CTranslatorDXLToPlStmt::TranslateDXLValueScanToRangeTblEntry(
 		CMappingColIdVarPlStmt(m_mp, base_table_context, nullptr,
 							   output_context, m_dxl_to_plstmt_context);
 	const ULONG num_of_child = value_scan_dxlnode->Arity();
+	const CDXLDatum2dArray *values = phy_values_scan_dxlop->GetValues();
 	List *values_lists = NIL;
 	List *values_collations = NIL;
 
-	for (ULONG ulValue = EdxlValIndexConstStart; ulValue < num_of_child;
-		 ulValue++)
+	// the tuples are either given by the operator, or as value list children
+	const ULONG num_of_tuples =
+		(nullptr != values) ? values->Size()
+							: num_of_child - EdxlValIndexConstStart;
+	for (ULONG ulValue = 0; ulValue < num_of_tuples; ulValue++)
 	{
-		CDXLNode *value_list_dxlnode = (*value_scan_dxlnode)[ulValue];
-		const ULONG num_of_cols = value_list_dxlnode->Arity();
 		List *value = NIL;
-		for (ULONG ulCol = 0; ulCol < num_of_cols; ulCol++)
+		ULONG num_of_cols = 0;
+		if (nullptr != values)
 		{
-			Expr *const_expr = m_translator_dxl_to_scalar->TranslateDXLToScalar(
-				(*value_list_dxlnode)[ulCol], &colid_var_mapping);
-			value = gpdb::LAppend(value, const_expr);
+			CDXLDatumArray *datum_array = (*values)[ulValue];
+			num_of_cols = datum_array->Size();
+			for (ULONG ulCol = 0; ulCol < num_of_cols; ulCol++)
+			{
+				Expr *const_expr =
+					m_translator_dxl_to_scalar->TranslateDXLDatumToScalar(
+						(*datum_array)[ulCol]);
+				value = gpdb::LAppend(value, const_expr);
+			}
+		}
+		else
+		{
+			CDXLNode *value_list_dxlnode =
+				(*value_scan_dxlnode)[EdxlValIndexConstStart + ulValue];
+			num_of_cols = value_list_dxlnode->Arity();
+			for (ULONG ulCol = 0; ulCol < num_of_cols; ulCol++)
+			{
+				Expr *const_expr =
+					m_translator_dxl_to_scalar->TranslateDXLToScalar(
+						(*value_list_dxlnode)[ulCol], &colid_var_mapping);
+				value = gpdb::LAppend(value, const_expr);
+			}
 		}
 		values_lists = gpdb::LAppend(values_lists, value);
 
@@ -3458,9 +3483,11 @@ CTranslatorDXLToPlStmt::TranslateDXLPartSelector(
 	CDXLNode *filterNode = (*partition_selector_dxlnode)[1];
 
 	ULongPtrArray *part_indexes = partition_selector_dxlop->Partitions();
+	ULONG num_levels = m_md_accessor->RetrieveRel(mdid)->PartColumnCount();
 	List *prune_infos = CPartPruneStepsBuilder::CreatePartPruneInfos(
-		filterNode, relation.get(), rtindex, part_indexes, &colid_var_mapping,
-		m_translator_dxl_to_scalar);
+		filterNode, relation.get(), rtindex, part_indexes, num_levels,
+		&colid_var_mapping, m_translator_dxl_to_scalar,
+		m_dxl_to_plstmt_context);
 
 	partition_selector->part_prune_info = MakeNode(PartitionPruneInfo);
 	partition_selector->part_prune_info->prune_infos = prune_infos;
@@ -4819,9 +4846,9 @@ CTranslatorDXLToPlStmt::TranslateDXLScCondToQual(
 void
 CTranslatorDXLToPlStmt::TranslatePlanCosts(const CDXLNode *dxlnode, Plan *plan)
 {
-	CDXLOperatorCost *costs =
-		CDXLPhysicalProperties::PdxlpropConvert(dxlnode->GetProperties())
-			->GetDXLOperatorCost();
+	CDXLPhysicalProperties *properties =
+		CDXLPhysicalProperties::PdxlpropConvert(dxlnode->GetProperties());
+	CDXLOperatorCost *costs = properties->GetDXLOperatorCost();
 
 	plan->startup_cost = CostFromStr(costs->GetStartUpCostStr());
 	plan->total_cost = CostFromStr(costs->GetTotalCostStr());
@@ -4834,6 +4861,8 @@ CTranslatorDXLToPlStmt::TranslatePlanCosts(const CDXLNode *dxlnode, Plan *plan)
 	plan->plan_rows =
 		ceil(CostFromStr(costs->GetRowsOutStr()) /
 			 m_dxl_to_plstmt_context->GetCurrentSlice()->numsegments);
+
+	plan->feedback_key = properties->GetFeedbackKey();
 }
 
 //---------------------------------------------------------------------------
@@ -5666,8 +5695,13 @@ CTranslatorDXLToPlStmt::TranslateDXLValueScan(
 	// translate operator costs
 	TranslatePlanCosts(value_scan_dxlnode, plan);
 
-	// a table scan node must have at least 2 children: projection list and at least 1 value list
-	GPOS_ASSERT(2 <= value_scan_dxlnode->Arity());
+	// a values scan node must have a projection list, and at least 1 value
+	// list unless the operator carries the values
+	GPOS_ASSERT(
+		2 <= value_scan_dxlnode->Arity() ||
+		nullptr !=
+			CDXLPhysicalValuesScan::Cast(value_scan_dxlnode->GetOperator())
+				->GetValues());
 
 	CDXLNode *project_list_dxlnode = (*value_scan_dxlnode)[EdxltsIndexProjList];
 
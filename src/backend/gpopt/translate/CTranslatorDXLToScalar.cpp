@@ -614,6 +614,15 @@ CTranslatorDXLToScalar::TranslateDXLScalarAggrefToScalar(
 
 	aggref->aggkind = CTranslatorUtils::GetAggKind(dxlop->GetAggKind());
 
+	if (EdxlscalaraggrefIndexAggFilter < aggref_node->Arity())
+	{
+		CDXLNode *filter_list_dxlnode =
+			(*aggref_node)[EdxlscalaraggrefIndexAggFilter];
+		GPOS_ASSERT(1 == filter_list_dxlnode->Arity());
+		aggref->aggfilter =
+			TranslateDXLToScalar((*filter_list_dxlnode)[0], colid_var);
+	}
+
 	// 'indexes' stores the position of the TargetEntry which is referenced by
 	// a SortGroupClause.
 	std::vector<int> indexes(gpdb::ListLength(args) + 1, -1);
@@ -716,6 +716,64 @@ CTranslatorQueryToDXL::TranslateQueryToDXL()
 	}
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorQueryToDXL::IsTrivialQuery
+//
+//	@doc:
+//		Is the query a select from a single table, an insert of values
+//		into one, or an update or delete of a single table, with no joins,
+//		subqueries, aggregates, window functions, set operations or CTEs?
+//		The optimizer needs none of its exploration beyond access paths
+//		and DML for such a query
+//
+//---------------------------------------------------------------------------
+BOOL
+CTranslatorQueryToDXL::IsTrivialQuery() const
+{
+	if (m_query->parentStmtType != PARENTSTMTTYPE_NONE ||
+		nullptr != m_query->cteList || nullptr != m_query->setOperations ||
+		m_query->hasAggs || m_query->hasWindowFuncs || m_query->hasSubLinks ||
+		m_query->hasTargetSRFs || nullptr != m_query->groupClause ||
+		nullptr != m_query->groupingSets || nullptr != m_query->havingQual ||
+		nullptr != m_query->distinctClause || nullptr != m_query->returningList)
+	{
+		return false;
+	}
+
+	ULONG num_relations = 0;
+	int rt_index = 0;
+	ListCell *lc;
+	ForEach(lc, m_query->rtable)
+	{
+		RangeTblEntry *rte = (RangeTblEntry *) lfirst(lc);
+		rt_index++;
+
+		if (RTE_VALUES == rte->rtekind && CMD_INSERT == m_query->commandType)
+		{
+			continue;
+		}
+
+		// partitioned and foreign tables need more than the access paths
+		if (RTE_RELATION != rte->rtekind ||
+			(RELKIND_RELATION != rte->relkind &&
+			 RELKIND_MATVIEW != rte->relkind))
+		{
+			return false;
+		}
+
+		// the source of an insert must be values
+		if (CMD_INSERT == m_query->commandType &&
+			rt_index != m_query->resultRelation)
+		{
+			return false;
+		}
+		num_relations++;
+	}
+
+	return 1 == num_relations;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorQueryToDXL::TranslateInsertQueryToDXL
@@ -3092,12 +3150,32 @@ CTranslatorQueryToDXL::TranslateFromClauseToDXL(Node *node)
 					   GPOS_WSZ_LIT("gp_dist_random"));
 		}
 
-		if (rte->lateral)
+		// the references of a LATERAL subquery or function to the FROM items
+		// before it are translated as outer references, which the join
+		// translation turns into an apply
+		if (rte->lateral && RTE_SUBQUERY != rte->rtekind &&
+			RTE_FUNCTION != rte->rtekind)
 		{
 			GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiQuery2DXLUnsupportedFeature,
 					   GPOS_WSZ_LIT("LATERAL"));
 		}
 
+		// an apply over a correlated LIMIT or aggregation cannot be
+		// decorrelated into a join, and there is no correlated execution
+		// of a subquery in the FROM clause
+		if (rte->lateral && RTE_SUBQUERY == rte->rtekind &&
+			(nullptr != rte->subquery->limitCount ||
+			 nullptr != rte->subquery->limitOffset ||
+			 rte->subquery->hasAggs || rte->subquery->hasWindowFuncs ||
+			 nullptr != rte->subquery->groupClause ||
+			 nullptr != rte->subquery->distinctClause) &&
+			gpdb::ContainVarsOfLevel((Node *) rte->subquery, 1))
+		{
+			GPOS_RAISE(
+				gpdxl::ExmaDXL, gpdxl::ExmiQuery2DXLUnsupportedFeature,
+				GPOS_WSZ_LIT("LATERAL subquery with LIMIT or aggregation"));
+		}
+
 		switch (rte->rtekind)
 		{
 			default:
@@ -3384,13 +3462,14 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 	const ULONG num_of_tuples = gpdb::ListLength(tuples_list);
 	GPOS_ASSERT(0 < num_of_tuples);
 
+	if (IsConstValuesList(tuples_list))
+	{
+		return TranslateConstValueScanRTEToDXL(rte, rt_index);
+	}
+
 	// children of the UNION ALL
 	CDXLNodeArray *dxlnodes = GPOS_NEW(m_mp) CDXLNodeArray(m_mp);
 
-	// array of datum arrays for Values
-	CDXLDatum2dArray *dxl_values_datum_array =
-		GPOS_NEW(m_mp) CDXLDatum2dArray(m_mp);
-
 	// array of input colid arrays
 	ULongPtr2dArray *input_colids = GPOS_NEW(m_mp) ULongPtr2dArray(m_mp);
 
@@ -3403,8 +3482,6 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 	ListCell *lc_tuple = nullptr;
 	GPOS_ASSERT(nullptr != rte->eref);
 
-	// flag for checking value list has only constants. For all constants --> VALUESCAN operator else retain UnionAll
-	BOOL fAllConstant = true;
 	ForEach(lc_tuple, tuples_list)
 	{
 		List *tuple_list = (List *) lfirst(lc_tuple);
@@ -3470,7 +3547,6 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 			}
 			else
 			{
-				fAllConstant = false;
 				// translate the scalar expression into a project element
 				CDXLNode *project_elem_dxlnode = TranslateExprToDXLProject(
 					expr, col_name_char_array, true /* insist_new_colids */);
@@ -3505,12 +3581,6 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 		dxlnodes->Append(
 			TranslateColumnValuesToDXL(dxl_datum_array, dxl_column_descriptors,
 									   project_elem_dxlnode_array));
-		if (fAllConstant)
-		{
-			dxl_datum_array->AddRef();
-			dxl_values_datum_array->Append(dxl_datum_array);
-		}
-
 		input_colids->Append(colid_array);
 		tuple_pos++;
 
@@ -3522,24 +3592,7 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 
 	GPOS_ASSERT(nullptr != dxl_col_descr_array);
 
-	if (fAllConstant)
-	{
-		// create Const Table DXL Node
-		CDXLLogicalConstTable *dxlop = GPOS_NEW(m_mp) CDXLLogicalConstTable(
-			m_mp, dxl_col_descr_array, dxl_values_datum_array);
-		CDXLNode *dxlnode = GPOS_NEW(m_mp) CDXLNode(m_mp, dxlop);
-
-		// make note of new columns from Value Scan
-		m_var_to_colid_map->LoadColumns(m_query_level, rt_index,
-										dxlop->GetDXLColumnDescrArray());
-
-		// cleanup
-		dxlnodes->Release();
-		input_colids->Release();
-
-		return dxlnode;
-	}
-	else if (1 < num_of_tuples)
+	if (1 < num_of_tuples)
 	{
 		// create a UNION ALL operator
 		CDXLLogicalSetOp *dxlop = GPOS_NEW(m_mp) CDXLLogicalSetOp(
@@ -3549,7 +3602,6 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 		// make note of new columns from UNION ALL
 		m_var_to_colid_map->LoadColumns(m_query_level, rt_index,
 										dxlop->GetDXLColumnDescrArray());
-		dxl_values_datum_array->Release();
 
 		return dxlnode;
 	}
@@ -3564,7 +3616,6 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 									dxl_col_descr_array);
 
 	//cleanup
-	dxl_values_datum_array->Release();
 	dxlnodes->Release();
 	input_colids->Release();
 	dxl_col_descr_array->Release();
@@ -3572,6 +3623,112 @@ CTranslatorQueryToDXL::TranslateValueScanRTEToDXL(const RangeTblEntry *rte,
 	return dxlnode;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorQueryToDXL::IsConstValuesList
+//
+//	@doc:
+//		Are all the values of the given tuples constants?
+//
+//---------------------------------------------------------------------------
+BOOL
+CTranslatorQueryToDXL::IsConstValuesList(List *tuples_list)
+{
+	ListCell *lc_tuple = nullptr;
+	ForEach(lc_tuple, tuples_list)
+	{
+		ListCell *lc_column = nullptr;
+		ForEach(lc_column, (List *) lfirst(lc_tuple))
+		{
+			if (!IsA(lfirst(lc_column), Const))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorQueryToDXL::TranslateConstValueScanRTEToDXL
+//
+//	@doc:
+//		Returns a const table CDXLNode representing a range table entry of
+//		values that are all constants. Only the datums are translated per
+//		tuple, as such a list may have a great many tuples
+//
+//---------------------------------------------------------------------------
+CDXLNode *
+CTranslatorQueryToDXL::TranslateConstValueScanRTEToDXL(const RangeTblEntry *rte,
+													   ULONG rt_index)
+{
+	List *tuples_list = rte->values_lists;
+	List *col_names = rte->eref->colnames;
+	GPOS_ASSERT(nullptr != col_names);
+
+	// the column descriptors are those of the first tuple
+	CDXLColDescrArray *dxl_col_descr_array =
+		GPOS_NEW(m_mp) CDXLColDescrArray(m_mp);
+	List *first_tuple_list = (List *) gpdb::ListNth(tuples_list, 0);
+	GPOS_ASSERT(gpdb::ListLength(first_tuple_list) ==
+				gpdb::ListLength(col_names));
+
+	ULONG col_pos_idx = 0;
+	ListCell *lc_column = nullptr;
+	ForEach(lc_column, first_tuple_list)
+	{
+		Const *const_expr = (Const *) lfirst(lc_column);
+		CHAR *col_name_char_array =
+			(CHAR *) strVal(gpdb::ListNth(col_names, col_pos_idx));
+
+		CWStringDynamic *alias_str =
+			CDXLUtils::CreateDynamicStringFromCharArray(m_mp,
+														col_name_char_array);
+		CMDName *mdname = GPOS_NEW(m_mp) CMDName(m_mp, alias_str);
+		GPOS_DELETE(alias_str);
+
+		CDXLColDescr *dxl_col_descr = GPOS_NEW(m_mp) CDXLColDescr(
+			mdname, m_context->m_colid_counter->next_id(),
+			col_pos_idx + 1 /* attno */,
+			GPOS_NEW(m_mp) CMDIdGPDB(const_expr->consttype),
+			const_expr->consttypmod, false /* is_dropped */
+		);
+		dxl_col_descr_array->Append(dxl_col_descr);
+		col_pos_idx++;
+	}
+
+	// translate the datums of the tuples
+	CDXLDatum2dArray *dxl_values_datum_array =
+		GPOS_NEW(m_mp) CDXLDatum2dArray(m_mp);
+	ListCell *lc_tuple = nullptr;
+	ForEach(lc_tuple, tuples_list)
+	{
+		List *tuple_list = (List *) lfirst(lc_tuple);
+		GPOS_ASSERT(gpdb::ListLength(tuple_list) ==
+					gpdb::ListLength(col_names));
+
+		CDXLDatumArray *dxl_datum_array = GPOS_NEW(m_mp) CDXLDatumArray(m_mp);
+		ForEach(lc_column, tuple_list)
+		{
+			dxl_datum_array->Append(m_scalar_translator->TranslateConstToDXL(
+				(Const *) lfirst(lc_column)));
+		}
+		dxl_values_datum_array->Append(dxl_datum_array);
+	}
+
+	CDXLLogicalConstTable *dxlop = GPOS_NEW(m_mp) CDXLLogicalConstTable(
+		m_mp, dxl_col_descr_array, dxl_values_datum_array);
+	CDXLNode *dxlnode = GPOS_NEW(m_mp) CDXLNode(m_mp, dxlop);
+
+	// make note of new columns from Value Scan
+	m_var_to_colid_map->LoadColumns(m_query_level, rt_index,
+									dxlop->GetDXLColumnDescrArray());
+
+	return dxlnode;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorQueryToDXL::TranslateColumnValuesToDXL
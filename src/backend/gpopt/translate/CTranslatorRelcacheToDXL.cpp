@@ -73,6 +73,7 @@ extern "C" {
 using namespace gpdxl;
 using namespace gpopt;
 
+extern bool optimizer_enable_text_range_stats;
 
 static const ULONG cmp_type_mappings[][2] = {
 	{IMDType::EcmptEq, CmptEq},	  {IMDType::EcmptNEq, CmptNEq},
@@ -406,25 +407,12 @@ CTranslatorRelcacheToDXL::RetrieveRel(CMemoryPool *mp, CMDAccessor *md_accessor,
 	}
 	is_partitioned = (nullptr != part_keys && 0 < part_keys->Size());
 
-	// get number of leaf partitions
+	// get the leaf partitions, from all levels of the partition hierarchy
 	if (gpdb::RelIsPartitioned(oid))
 	{
-		// FIXME_GPDB_12_MERGE_FIXME: misestimate (most likely underestimate) the number of leaf partitions
-		// ORCA doesn't really care, except to determine whether to sort before inserting
-		num_leaf_partitions = RelationGetPartitionDesc(rel.get(), true)->nparts;
 		partition_oids = GPOS_NEW(mp) IMdIdArray(mp);
-
-		for (int i = 0; i < RelationGetPartitionDesc(rel.get(), true)->nparts; ++i)
-		{
-			Oid oid = RelationGetPartitionDesc(rel.get(), true)->oids[i];
-			partition_oids->Append(GPOS_NEW(mp) CMDIdGPDB(oid));
-			if (gpdb::RelIsPartitioned(oid))
-			{
-				// Multi-level partitioned tables are unsupported - fall back
-				GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
-						   GPOS_WSZ_LIT("Multi-level partitioned tables"));
-			}
-		}
+		RetrieveLeafPartitions(mp, rel.get(), partition_oids);
+		num_leaf_partitions = partition_oids->Size();
 	}
 
 	// get key sets
@@ -2194,10 +2182,12 @@ CTranslatorRelcacheToDXL::TransformStatsToDXLBucketArray(
 		hist_freq = CDouble(1.0) - null_freq - mcv_freq;
 	}
 
+	// text datums are mapped to hashes, unless their order is preserved
 	BOOL is_text_type = mdid_atttype->Equals(&CMDIdGPDB::m_mdid_varchar) ||
 						mdid_atttype->Equals(&CMDIdGPDB::m_mdid_bpchar) ||
 						mdid_atttype->Equals(&CMDIdGPDB::m_mdid_text);
-	BOOL has_hist = !is_text_type && 1 < num_hist_values &&
+	BOOL has_hist = (!is_text_type || optimizer_enable_text_range_stats) &&
+					1 < num_hist_values &&
 					CStatistics::Epsilon < hist_freq;
 
 	CHistogram *histogram = nullptr;
@@ -2460,6 +2450,43 @@ CTranslatorRelcacheToDXL::RetrieveRelStorageType(Relation rel)
 	return rel_storage_type;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorRelcacheToDXL::RetrievePartKeyAndType
+//
+//	@doc:
+//		Get the partition key and the partitioning strategy of a partitioned
+//		table, raising an exception if ORCA doesn't support them.
+//
+//---------------------------------------------------------------------------
+void
+CTranslatorRelcacheToDXL::RetrievePartKeyAndType(Relation rel,
+												 AttrNumber *attno,
+												 CHAR *part_type)
+{
+	PartitionKeyData *partkey = rel->rd_partkey;
+
+	if (1 < partkey->partnatts)
+	{
+		GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
+				   GPOS_WSZ_LIT("Composite part key"));
+	}
+
+	*attno = partkey->partattrs[0];
+	*part_type = (CHAR) partkey->strategy;
+	if (*attno == 0)
+	{
+		GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
+				   GPOS_WSZ_LIT("partitioning by expression"));
+	}
+
+	if (PARTITION_STRATEGY_HASH == *part_type)
+	{
+		GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
+				   GPOS_WSZ_LIT("hash partitioning"));
+	}
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorRelcacheToDXL::RetrievePartKeysAndTypes
@@ -2468,6 +2495,10 @@ CTranslatorRelcacheToDXL::RetrieveRelStorageType(Relation rel)
 //		Get partition keys and types for relation or NULL if relation not partitioned.
 //		Caller responsible for closing the relation if an exception is raised
 //
+//		A multi-level partitioned table has one key per level, the first
+//		one being the key of the root. The sub-partitions of a level must
+//		all be partitioned the same way.
+//
 //---------------------------------------------------------------------------
 void
 CTranslatorRelcacheToDXL::RetrievePartKeysAndTypes(CMemoryPool *mp,
@@ -2489,30 +2520,114 @@ CTranslatorRelcacheToDXL::RetrievePartKeysAndTypes(CMemoryPool *mp,
 	*part_keys = GPOS_NEW(mp) ULongPtrArray(mp);
 	*part_types = GPOS_NEW(mp) CharPtrArray(mp);
 
-	PartitionKeyData *partkey = rel->rd_partkey;
+	AttrNumber attno;
+	CHAR part_type;
+	RetrievePartKeyAndType(rel, &attno, &part_type);
 
-	if (1 < partkey->partnatts)
-	{
-		GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
-				   GPOS_WSZ_LIT("Composite part key"));
-	}
+	(*part_keys)->Append(GPOS_NEW(mp) ULONG(attno - 1));
+	(*part_types)->Append(GPOS_NEW(mp) CHAR(part_type));
+
+	RetrieveSubPartKeysAndTypes(mp, rel, rel, 1 /* level */, *part_keys,
+								*part_types);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorRelcacheToDXL::RetrieveSubPartKeysAndTypes
+//
+//	@doc:
+//		Add the partition keys and types of the sub-partitions of rel, at the
+//		given level of the hierarchy of root, and of the levels below it.
+//		The keys are positions of root's columns, as the sub-partitions may
+//		have a different column layout.
+//
+//---------------------------------------------------------------------------
+void
+CTranslatorRelcacheToDXL::RetrieveSubPartKeysAndTypes(
+	CMemoryPool *mp, Relation root, Relation rel, ULONG level,
+	ULongPtrArray *part_keys, CharPtrArray *part_types)
+{
+	PartitionDesc partdesc = RelationGetPartitionDesc(rel, true);
 
-	AttrNumber attno = partkey->partattrs[0];
-	CHAR part_type = (CHAR) partkey->strategy;
-	if (attno == 0)
+	for (int i = 0; i < partdesc->nparts; ++i)
 	{
-		GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
-				   GPOS_WSZ_LIT("partitioning by expression"));
+		if (partdesc->is_leaf[i])
+		{
+			continue;
+		}
+
+		gpdb::RelationWrapper child_rel = gpdb::GetRelation(partdesc->oids[i]);
+
+		AttrNumber child_attno;
+		CHAR part_type;
+		RetrievePartKeyAndType(child_rel.get(), &child_attno, &part_type);
+
+		// find the root's column of the partition key, by name
+		const char *attname =
+			NameStr(TupleDescAttr(child_rel->rd_att, child_attno - 1)->attname);
+		AttrNumber attno = InvalidAttrNumber;
+		for (int att = 0; att < root->rd_att->natts; att++)
+		{
+			Form_pg_attribute root_att = TupleDescAttr(root->rd_att, att);
+			if (!root_att->attisdropped &&
+				0 == strcmp(NameStr(root_att->attname), attname))
+			{
+				attno = root_att->attnum;
+				break;
+			}
+		}
+		GPOS_ASSERT(InvalidAttrNumber != attno);
+
+		if (level == part_keys->Size())
+		{
+			part_keys->Append(GPOS_NEW(mp) ULONG(attno - 1));
+			part_types->Append(GPOS_NEW(mp) CHAR(part_type));
+		}
+		else if (*(*part_keys)[level] != (ULONG)(attno - 1) ||
+				 *(*part_types)[level] != part_type)
+		{
+			GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
+					   GPOS_WSZ_LIT("Multi-level partitioned tables with "
+									"different partition keys on a level"));
+		}
+
+		RetrieveSubPartKeysAndTypes(mp, root, child_rel.get(), level + 1,
+									part_keys, part_types);
 	}
+}
 
-	if (PARTITION_STRATEGY_HASH == part_type)
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorRelcacheToDXL::RetrieveLeafPartitions
+//
+//	@doc:
+//		Append the leaf partitions of a partitioned table, from all levels of
+//		the hierarchy, depth first in the order of the partition bounds. The
+//		executor-side partition pruning of ORCA plans relies on this order,
+//		see CPartPruneStepsBuilder.
+//
+//---------------------------------------------------------------------------
+void
+CTranslatorRelcacheToDXL::RetrieveLeafPartitions(CMemoryPool *mp,
+												 Relation rel,
+												 IMdIdArray *leaf_oids)
+{
+	PartitionDesc partdesc = RelationGetPartitionDesc(rel, true);
+
+	for (int i = 0; i < partdesc->nparts; ++i)
 	{
-		GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
-				   GPOS_WSZ_LIT("hash partitioning"));
-	}
+		Oid oid = partdesc->oids[i];
 
-	(*part_keys)->Append(GPOS_NEW(mp) ULONG(attno - 1));
-	(*part_types)->Append(GPOS_NEW(mp) CHAR(part_type));
+		if (partdesc->is_leaf[i])
+		{
+			leaf_oids->Append(GPOS_NEW(mp) CMDIdGPDB(oid));
+		}
+		else
+		{
+			gpdb::RelationWrapper child_rel = gpdb::GetRelation(oid);
+			RetrieveLeafPartitions(mp, child_rel.get(), leaf_oids);
+		}
+	}
 }
 
 
@@ -2964,6 +3079,16 @@ CTranslatorRelcacheToDXL::RetrieveIndexPartitions(CMemoryPool *mp, OID rel_oid)
 	foreach (lc, partition_oid_list)
 	{
 		OID oid = lfirst_oid(lc);
+
+		// the indexes of sub-partitioned tables are partitioned as well;
+		// collect their leaf indexes, which match the leaf partitions
+		if (gpdb::IndexIsPartitioned(oid))
+		{
+			IMdIdArray *sub_partition_oids = RetrieveIndexPartitions(mp, oid);
+			CUtils::AddRefAppend(partition_oids, sub_partition_oids);
+			sub_partition_oids->Release();
+			continue;
+		}
 		partition_oids->Append(GPOS_NEW(mp) CMDIdGPDB(oid));
 	}
 
@@ -86,6 +86,8 @@ extern "C" {
 using namespace gpdxl;
 using namespace gpopt;
 
+extern bool optimizer_enable_text_range_stats;
+
 
 //---------------------------------------------------------------------------
 //	@function:
@@ -1374,11 +1376,17 @@ CTranslatorScalarToDXL::TranslateAggrefToDXL(
 				   GPOS_WSZ_LIT("Aggregate functions with outer references"));
 	}
 
-	// ORCA doesn't support the FILTER clause yet.
-	if (aggref->aggfilter)
+	// The FILTER clause is only supported on plain aggregates. A DISTINCT
+	// aggregate is split on its arguments alone, which would lose the rows
+	// the filter needs.
+	if (aggref->aggfilter &&
+		(aggref->aggdistinct ||
+		 EdxlaggkindNormal != CTranslatorUtils::GetAggKind(aggref->aggkind)))
 	{
-		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiQuery2DXLUnsupportedFeature,
-				   GPOS_WSZ_LIT("Aggregate functions with FILTER"));
+		GPOS_RAISE(
+			gpdxl::ExmaDXL, gpdxl::ExmiQuery2DXLUnsupportedFeature,
+			GPOS_WSZ_LIT(
+				"Aggregate functions with FILTER and DISTINCT or WITHIN GROUP"));
 	}
 
 	IMDId *mdid_return_type = CScalarAggFunc::PmdidLookupReturnType(
@@ -1490,6 +1498,16 @@ CTranslatorScalarToDXL::TranslateAggrefToDXL(
 	}
 	dxlnode->AddChild(aggdistinct_value_list_dxlnode);
 
+	// translate filter, it is an optional child
+	if (aggref->aggfilter)
+	{
+		CDXLNode *aggfilter_value_list_dxlnode = GPOS_NEW(m_mp)
+			CDXLNode(m_mp, GPOS_NEW(m_mp) CDXLScalarValuesList(m_mp));
+		aggfilter_value_list_dxlnode->AddChild(TranslateScalarToDXL(
+			(Expr *) aggref->aggfilter, var_colid_mapping));
+		dxlnode->AddChild(aggfilter_value_list_dxlnode);
+	}
+
 	return dxlnode;
 }
 
@@ -2525,6 +2543,19 @@ CTranslatorScalarToDXL::ExtractLintValueFromDatum(const IMDType *md_type,
 		}
 
 		lint_value = (LINT) hash;
+
+		// Map the datum to the leading bytes of its sort key instead, so that
+		// the mapping preserves the order of the values and histograms can be
+		// used for range predicates. The low 14 bits of the hash tell apart
+		// the values that share the 6-byte prefix, so they collide once in 16K
+		// rather than practically never; see optimizer_enable_text_range_stats.
+		uint64 prefix;
+		if (optimizer_enable_text_range_stats &&
+			gpdb::GetSortKeyPrefix(CMDIdGPDB::CastMdid(mdid)->Oid(),
+								   (Datum) bytes, &prefix))
+		{
+			lint_value = (LINT)(((prefix >> 16) << 14) | (hash & 0x3FFF));
+		}
 	}
 
 	return lint_value;
@@ -45,6 +45,7 @@ extern "C" {
 #include "gpopt/optimizer/COptimizer.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
+#include "gpopt/search/CSearchStage.h"
 #include "gpopt/translate/CContextDXLToPlStmt.h"
 #include "gpopt/translate/CTranslatorDXLToExpr.h"
 #include "gpopt/translate/CTranslatorDXLToPlStmt.h"
@@ -430,6 +431,19 @@ COptTasks::SetCostModelParams(ICostModel *cost_model)
 			cost_param->GetLowerBoundVal() * optimizer_sort_factor,
 			cost_param->GetUpperBoundVal() * optimizer_sort_factor);
 	}
+
+	if (Gp_interconnect_compression != INTERCONNECT_COMPRESSION_NONE)
+	{
+		// motions keep compressing their tuples only while they shrink to at
+		// most this ratio, so it is an upper bound of the compressed size
+		ICostModelParams::SCostParam *cost_param =
+			cost_model->GetCostModelParams()->PcpLookup(
+				CCostModelParamsGPDB::EcpMotionCompressionRatio);
+		CDouble compression_ratio(Gp_interconnect_compression_ratio);
+		cost_model->GetCostModelParams()->SetParam(
+			cost_param->Id(), compression_ratio, cost_param->GetLowerBoundVal(),
+			cost_param->GetUpperBoundVal());
+	}
 }
 
 
@@ -480,6 +494,15 @@ COptTasks::OptimizeTask(void *ptr)
 	// the invalidation mechanism.
 	bool reset_mdcache = gpdb::MDCacheNeedsReset();
 
+	// The statistics of the string columns in the cache depend on how their
+	// datums are mapped, see CTranslatorScalarToDXL::ExtractLintValueFromDatum
+	static bool mdcache_text_range_stats = false;
+	if (mdcache_text_range_stats != optimizer_enable_text_range_stats)
+	{
+		mdcache_text_range_stats = optimizer_enable_text_range_stats;
+		reset_mdcache = true;
+	}
+
 	// initialize metadata cache, or purge if needed, or change size if requested
 	if (!CMDCache::FInitialized())
 	{
@@ -553,6 +576,16 @@ COptTasks::OptimizeTask(void *ptr)
 				query_to_dxl_translator->GetCTEs();
 			GPOS_ASSERT(nullptr != query_output_dxlnode_array);
 
+			// a trivial query only needs the access paths and DML explored,
+			// unless a search strategy has been configured
+			if (nullptr == search_strategy_arr &&
+				optimizer_enable_trivial_fast_path &&
+				query_to_dxl_translator->IsTrivialQuery())
+			{
+				search_strategy_arr = CSearchStage::PdrgpssTrivial(mp);
+				elog(DEBUG1, "[OPT]: Using trivial search strategy");
+			}
+
 			BOOL is_master_only =
 				!optimizer_enable_motions ||
 				(!optimizer_enable_motions_masteronly_queries &&
@@ -90,6 +90,9 @@ private:
 							   const CCostModelGPDB *pcmgpdb,
 							   const SCostingInfo *pci);
 
+	// number of index probes done by an index scan with the given index condition
+	static CDouble DIndexProbes(CExpression *pexprIndexCond);
+
 	// cost of index only scan
 	static CCost CostIndexOnlyScan(CMemoryPool *mp, CExpressionHandle &exprhdl,
 								   const CCostModelGPDB *pcmgpdb,
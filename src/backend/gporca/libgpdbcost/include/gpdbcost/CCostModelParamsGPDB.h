@@ -104,6 +104,8 @@ public:
 		EcpBitmapScanRebindCost,	// cost of rebind operation in a bitmap scan
 		EcpPenalizeHJSkewUpperLimit,  // upper limit for penalizing a skewed hashjoin operator
 
+		EcpMotionCompressionRatio,	// size of compressed motion tuples relative to their width
+
 		EcpSentinel
 	};
 
@@ -274,6 +276,9 @@ private:
 	// upper limit for penalizing a skewed hash operator
 	static const CDouble DPenalizeHJSkewUpperLimit;
 
+	// default size of compressed motion tuples relative to their width
+	static const CDouble DMotionCompressionRatio;
+
 public:
 	CCostModelParamsGPDB(CCostModelParamsGPDB &) = delete;
 
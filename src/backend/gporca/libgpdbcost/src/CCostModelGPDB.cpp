@@ -1376,6 +1376,18 @@ CCostModelGPDB::CostMotion(CMemoryPool *mp, CExpressionHandle &exprhdl,
 	GPOS_ASSERT(0 <= dSendCostUnit);
 	GPOS_ASSERT(0 <= dRecvCostUnit);
 
+	// the executor may compress the tuples of a motion, which reduces the
+	// interconnect part of the cost; tuples narrower than 128 bytes are
+	// always sent as is
+	CDouble dCompressionRatio =
+		pcmgpdb->GetCostModelParams()
+			->PcpLookup(CCostModelParamsGPDB::EcpMotionCompressionRatio)
+			->Get();
+	if (dCompressionRatio < 1.0 && dWidthOuter >= 128.0)
+	{
+		recvCost = recvCost * dCompressionRatio;
+	}
+
 	costLocal =
 		CCost(pci->NumRebinds() *
 			  (num_rows_outer * dWidthOuter * dSendCostUnit + recvCost));
@@ -1451,6 +1463,48 @@ CCostModelGPDB::CostSequenceProject(CMemoryPool *mp, CExpressionHandle &exprhdl,
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CCostModelGPDB::DIndexProbes
+//
+//	@doc:
+//		Number of index probes done by an index scan with the given index
+//		condition. The executor descends the index once for each element of
+//		the array of an array comparison, and for each combination of the
+//		elements when there are several of them.
+//
+//---------------------------------------------------------------------------
+CDouble
+CCostModelGPDB::DIndexProbes(CExpression *pexprIndexCond)
+{
+	GPOS_ASSERT(nullptr != pexprIndexCond);
+
+	CDouble dProbes(1.0);
+	if (CPredicateUtils::FAnd(pexprIndexCond))
+	{
+		const ULONG arity = pexprIndexCond->Arity();
+		for (ULONG ul = 0; ul < arity; ul++)
+		{
+			dProbes = dProbes * DIndexProbes((*pexprIndexCond)[ul]);
+		}
+	}
+	else if (CUtils::FScalarArrayCmp(pexprIndexCond))
+	{
+		CExpression *pexprArray =
+			CUtils::PexprScalarArrayChild(pexprIndexCond);
+		if (CUtils::FScalarArray(pexprArray))
+		{
+			// an empty array is not probed at all, but still has the
+			// startup cost of the scan
+			dProbes = std::max(
+				1.0, (DOUBLE) CUtils::UlScalarArrayArity(pexprArray));
+		}
+	}
+
+	return dProbes;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CCostModelGPDB::CostIndexScan
@@ -1515,10 +1569,14 @@ CCostModelGPDB::CostIndexScan(CMemoryPool *,  // mp
 	// 2. output tuple cost: this is handled by the Filter on top of IndexScan, if no Filter exists, we add output cost
 	// when we sum-up children cost
 
+	// the random IO of descending the index is paid for each array element
+	// of the index condition
+	const CDouble dProbes = DIndexProbes(exprhdl.PexprScalarRepChild(0));
+
 	CDouble dCostPerIndexRow = ulIndexKeys * dIndexFilterCostUnit +
 							   dTableWidth * dIndexScanTupCostUnit;
-	return CCost(pci->NumRebinds() *
-				 (dRowsIndex * dCostPerIndexRow + dIndexScanTupRandomFactor));
+	return CCost(pci->NumRebinds() * (dRowsIndex * dCostPerIndexRow +
+									  dIndexScanTupRandomFactor * dProbes));
 }
 
 
@@ -1566,6 +1624,8 @@ CCostModelGPDB::CostIndexOnlyScan(CMemoryPool *mp GPOS_UNUSED,	  // mp
 	// currently marked as all-visible. Planner has similar logic inside
 	// `cost_index()` to calculate pages fetched from index-only-scan.
 
+	const CDouble dProbes = DIndexProbes(exprhdl.PexprScalarRepChild(0));
+
 	CDouble dCostPerIndexRow = ulIndexKeys * dIndexFilterCostUnit +
 							   dTableWidth * dIndexScanTupCostUnit;
 	CDouble dPartialVisFrac(1);
@@ -1576,7 +1636,7 @@ CCostModelGPDB::CostIndexOnlyScan(CMemoryPool *mp GPOS_UNUSED,	  // mp
 	}
 	return CCost(pci->NumRebinds() *
 				 (dRowsIndex * dCostPerIndexRow +
-				  dIndexScanTupRandomFactor * dPartialVisFrac));
+				  dIndexScanTupRandomFactor * dPartialVisFrac * dProbes));
 }
 
 CCost
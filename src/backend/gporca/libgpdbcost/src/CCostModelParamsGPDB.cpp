@@ -183,6 +183,9 @@ const CDouble CCostModelParamsGPDB::DBitmapScanRebindCost(0.06);
 // see CCostModelGPDB::CostHashJoin() for why this is needed
 const CDouble CCostModelParamsGPDB::DPenalizeHJSkewUpperLimit(10.0);
 
+// motion tuples are not compressed by default
+const CDouble CCostModelParamsGPDB::DMotionCompressionRatio(1.0);
+
 #define GPOPT_COSTPARAM_NAME_MAX_LENGTH 80
 
 // parameter names in the same order of param enumeration
@@ -238,6 +241,9 @@ const CHAR rgszCostParamNames[CCostModelParamsGPDB::EcpSentinel]
 								 "BitmapPageCostLargerNDV",
 								 "BitmapPageCostSmallerNDV",
 								 "BitmapNDVThreshold",
+								 "BitmapScanRebindCost",
+								 "PenalizeHJSkewUpperLimit",
+								 "MotionCompressionRatio",
 };
 
 //---------------------------------------------------------------------------
@@ -428,6 +434,8 @@ CCostModelParamsGPDB::CCostModelParamsGPDB(CMemoryPool *mp) : m_mp(mp)
 	m_rgpcp[EcpPenalizeHJSkewUpperLimit] = GPOS_NEW(mp) SCostParam(
 		EcpPenalizeHJSkewUpperLimit, DPenalizeHJSkewUpperLimit,
 		DPenalizeHJSkewUpperLimit - 1.0, DPenalizeHJSkewUpperLimit + 1.0);
+	m_rgpcp[EcpMotionCompressionRatio] = GPOS_NEW(mp)
+		SCostParam(EcpMotionCompressionRatio, DMotionCompressionRatio, 0.0, 1.0);
 }
 
 
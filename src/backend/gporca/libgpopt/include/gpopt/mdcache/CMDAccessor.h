@@ -31,6 +31,7 @@
 namespace gpdxl
 {
 class CDXLDatum;
+class CDXLNode;
 }
 
 namespace gpmd
@@ -363,6 +364,13 @@ public:
 			pcrsWidth,	// set of column references for which the widths are needed
 		CStatisticsConfig *stats_config = nullptr);
 
+	// selectivity of a predicate observed on a sample of the given relation
+	BOOL SampleSelectivity(IMDId *rel_mdid, const CDXLNode *pred_dxl,
+						   UlongToIntMap *colid_to_attno, CDouble *selectivity);
+
+	// actual rows observed for an expression on the given relation
+	BOOL CardinalityFeedback(IMDId *rel_mdid, ULLONG key, CDouble *rows);
+
 	// serialize object to passed stream
 	void Serialize(COstream &oos);
 
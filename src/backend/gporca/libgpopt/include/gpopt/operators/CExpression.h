@@ -95,6 +95,10 @@ private:
 	// id of origin group expression, used for debugging expressions extracted from memo
 	ULONG m_ulOriginGrpExprId;
 
+	// fingerprint of the logical expression of the origin group, used for
+	// cardinality feedback
+	ULLONG m_ullFeedbackKey;
+
 	// get expression's derived property given its type
 	CDrvdProp *Pdp(const CDrvdProp::EPropType ept) const;
 
@@ -187,6 +191,13 @@ public:
 		return m_pgexpr;
 	}
 
+	// fingerprint of the logical expression of the origin group, or 0
+	ULLONG
+	FeedbackKey() const
+	{
+		return m_ullFeedbackKey;
+	}
+
 	// accessor for computed required plan props
 	CReqdPropPlan *
 	Prpp() const
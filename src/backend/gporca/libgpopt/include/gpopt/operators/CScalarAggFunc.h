@@ -44,6 +44,7 @@ enum EAggfuncChildIndices
 	EaggfuncIndexDirectArgs,
 	EaggfuncIndexOrder,
 	EaggfuncIndexDistinct,
+	EaggfuncIndexFilter,  // optional, only present with a FILTER
 	EaggfuncIndexSentinel
 };
 
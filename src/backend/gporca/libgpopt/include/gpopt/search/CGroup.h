@@ -233,6 +233,15 @@ private:
 	// does the group have any CTE consumer
 	BOOL m_fCTEConsumer;
 
+	// was the cardinality feedback key of the group derived?
+	BOOL m_fFeedbackKeyDerived;
+
+	// fingerprint of the logical expression of the group, 0 if it has none
+	ULLONG m_ullFeedbackKey;
+
+	// a relation that the expression of the group is on
+	IMDId *m_pmdidFeedbackRel;
+
 	// exploration job queue
 	CJobQueue m_jqExploration;
 
@@ -316,6 +325,12 @@ private:
 	// initialize and return empty stats for this group
 	IStatistics *PstatsInitEmpty(CMemoryPool *pmpGlobal);
 
+	// derive the fingerprint of the logical expression of the group
+	ULLONG UllDeriveFeedbackKey();
+
+	// scale stats to the actual rows observed for the group in executed plans
+	IStatistics *PstatsApplyFeedback(CMemoryPool *mp, IStatistics *stats);
+
 	// find the group expression having the best stats promise
 	CGroupExpression *PgexprBestPromise(CMemoryPool *pmpLocal,
 										CMemoryPool *pmpGlobal,
@@ -540,6 +555,10 @@ public:
 	// materialize a dummy cost context attached to the first group expression
 	void CreateDummyCostContext();
 
+	// fingerprint of the logical expression of the group, used as its key for
+	// cardinality feedback; 0 if it has none
+	ULLONG FeedbackKey();
+
 	// return the CTE producer ID in the group (if any)
 	ULONG
 	UlCTEProducerId() const
@@ -143,6 +143,9 @@ public:
 
 	// generate default search strategy
 	static CSearchStageArray *PdrgpssDefault(CMemoryPool *mp);
+
+	// generate search strategy for trivial single-table queries
+	static CSearchStageArray *PdrgpssTrivial(CMemoryPool *mp);
 };
 
 // shorthand for printing
@@ -179,6 +179,20 @@ private:
 	// translate a DXL right outer join
 	CExpression *PexprRightOuterJoin(const CDXLNode *dxlnode);
 
+	// does a child of a join reference the columns of the children before it
+	static BOOL FHasLateralReferences(CMemoryPool *mp,
+									  CExpressionArray *pdrgpexprChildren);
+
+	// translate a DXL join with LATERAL children into applies
+	CExpression *PexprLateralJoin(const CDXLNode *dxlnode,
+								  EdxlJoinType join_type,
+								  CExpressionArray *pdrgpexprChildren);
+
+	// translate a LATERAL set-returning function into a project
+	CExpression *PexprProjectLateralTVF(CExpression *pexprLeft,
+										CExpression *pexprTVF,
+										const CDXLNode *pdxlnTVF);
+
 	// translate a DXL logical CTE anchor into an expr logical CTE anchor
 	CExpression *PexprLogicalCTEAnchor(const CDXLNode *pdxlnLgCTEAnchor);
 
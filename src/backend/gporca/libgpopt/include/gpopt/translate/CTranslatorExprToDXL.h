@@ -387,6 +387,10 @@ private:
 									 CDistributionSpecArray *pdrgpdsBaseTables,
 									 ULONG *pulNonGatherMotions, BOOL *pfDML);
 
+	// translate the filter of a partition selector, per partitioning level
+	CDXLNode *PdxlnPartSelectorFilterPerLevel(const IMDRelation *root_rel,
+											  CExpression *pexprFilter);
+
 	// translate a DML operator
 	CDXLNode *PdxlnDML(CExpression *pexpr, CColRefArray *colref_array,
 					   CDistributionSpecArray *pdrgpdsBaseTables,
@@ -178,6 +178,12 @@ private:
 									   CColRefSet *pcrsGrpByUsed,
 									   CColRefSet *pcrsFKey);
 
+	// move the array comparisons on non-leading btree keys to the residual
+	static void MoveLowerArrayCmpsToResidual(
+		CMemoryPool *mp, CColRefArray *pdrgpcrIndexCols,
+		CExpressionArray **ppdrgpexprIndex,
+		CExpressionArray *pdrgpexprResidual);
+
 	// construct an expression representing a new access path using the given functors for
 	// operator constructors and rewritten access path
 	static CExpression *PexprBuildBtreeIndexPlan(
@@ -1120,6 +1120,49 @@ CMDAccessor::Pstats(CMemoryPool *mp, IMDId *rel_mdid, CColRefSet *pcrsHist,
 		pmdRelStats->RelPages(), pmdRelStats->RelAllVisible());
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDAccessor::SampleSelectivity
+//
+//	@doc:
+//		Ask the MD provider of the given relation for the selectivity of a
+//		predicate on a sample of the relation
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDAccessor::SampleSelectivity(IMDId *rel_mdid, const CDXLNode *pred_dxl,
+							   UlongToIntMap *colid_to_attno, CDouble *selectivity)
+{
+	GPOS_ASSERT(nullptr != rel_mdid);
+	GPOS_ASSERT(nullptr != pred_dxl);
+	GPOS_ASSERT(nullptr != selectivity);
+
+	IMDProvider *pmdp = Pmdp(rel_mdid->Sysid());
+
+	return pmdp->SampleSelectivity(m_mp, this, rel_mdid, pred_dxl,
+								   colid_to_attno, selectivity);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDAccessor::CardinalityFeedback
+//
+//	@doc:
+//		Ask the MD provider of the given relation for the actual rows of
+//		an expression on it, observed in executed plans
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDAccessor::CardinalityFeedback(IMDId *rel_mdid, ULLONG key, CDouble *rows)
+{
+	GPOS_ASSERT(nullptr != rel_mdid);
+	GPOS_ASSERT(nullptr != rows);
+
+	IMDProvider *pmdp = Pmdp(rel_mdid->Sysid());
+
+	return pmdp->CardinalityFeedback(key, rows);
+}
+
 
 //---------------------------------------------------------------------------
 //	@function:
@@ -67,7 +67,8 @@ CExpression::CExpression(CMemoryPool *mp, COperator *pop,
 	  m_pgexpr(pgexpr),
 	  m_cost(GPOPT_INVALID_COST),
 	  m_ulOriginGrpId(gpos::ulong_max),
-	  m_ulOriginGrpExprId(gpos::ulong_max)
+	  m_ulOriginGrpExprId(gpos::ulong_max),
+	  m_ullFeedbackKey(0)
 {
 	GPOS_ASSERT(nullptr != mp);
 	GPOS_ASSERT(nullptr != pop);
@@ -102,7 +103,8 @@ CExpression::CExpression(CMemoryPool *mp, COperator *pop, CExpression *pexpr)
 	  m_pgexpr(nullptr),
 	  m_cost(GPOPT_INVALID_COST),
 	  m_ulOriginGrpId(gpos::ulong_max),
-	  m_ulOriginGrpExprId(gpos::ulong_max)
+	  m_ulOriginGrpExprId(gpos::ulong_max),
+	  m_ullFeedbackKey(0)
 {
 	GPOS_ASSERT(nullptr != mp);
 	GPOS_ASSERT(nullptr != pop);
@@ -139,7 +141,8 @@ CExpression::CExpression(CMemoryPool *mp, COperator *pop,
 	  m_pgexpr(nullptr),
 	  m_cost(GPOPT_INVALID_COST),
 	  m_ulOriginGrpId(gpos::ulong_max),
-	  m_ulOriginGrpExprId(gpos::ulong_max)
+	  m_ulOriginGrpExprId(gpos::ulong_max),
+	  m_ullFeedbackKey(0)
 {
 	GPOS_ASSERT(nullptr != mp);
 	GPOS_ASSERT(nullptr != pop);
@@ -180,7 +183,8 @@ CExpression::CExpression(CMemoryPool *mp, COperator *pop,
 	  m_pgexpr(nullptr),
 	  m_cost(GPOPT_INVALID_COST),
 	  m_ulOriginGrpId(gpos::ulong_max),
-	  m_ulOriginGrpExprId(gpos::ulong_max)
+	  m_ulOriginGrpExprId(gpos::ulong_max),
+	  m_ullFeedbackKey(0)
 {
 	GPOS_ASSERT(nullptr != mp);
 	GPOS_ASSERT(nullptr != pop);
@@ -221,7 +225,8 @@ CExpression::CExpression(CMemoryPool *mp, COperator *pop,
 	  m_pgexpr(nullptr),
 	  m_cost(GPOPT_INVALID_COST),
 	  m_ulOriginGrpId(gpos::ulong_max),
-	  m_ulOriginGrpExprId(gpos::ulong_max)
+	  m_ulOriginGrpExprId(gpos::ulong_max),
+	  m_ullFeedbackKey(0)
 {
 	GPOS_ASSERT(nullptr != mp);
 	GPOS_ASSERT(nullptr != pop);
@@ -255,7 +260,8 @@ CExpression::CExpression(CMemoryPool *mp, COperator *pop,
 	  m_pgexpr(pgexpr),
 	  m_cost(cost),
 	  m_ulOriginGrpId(gpos::ulong_max),
-	  m_ulOriginGrpExprId(gpos::ulong_max)
+	  m_ulOriginGrpExprId(gpos::ulong_max),
+	  m_ullFeedbackKey(0)
 {
 	GPOS_ASSERT(nullptr != mp);
 	GPOS_ASSERT(nullptr != pop);
@@ -344,6 +350,7 @@ CExpression::CopyGroupPropsAndStats(IStatistics *input_stats)
 
 	m_ulOriginGrpExprId = m_pgexpr->Id();
 	m_ulOriginGrpId = m_pgexpr->Pgroup()->Id();
+	m_ullFeedbackKey = m_pgexpr->Pgroup()->FeedbackKey();
 }
 
 
@@ -158,9 +158,11 @@ CLogicalConstTableGet::Matches(COperator *pop) const
 
 	CLogicalConstTableGet *popCTG = CLogicalConstTableGet::PopConvert(pop);
 
-	// match if column descriptors, const values and output columns are identical
+	// match if column descriptors, const values and output columns are identical;
+	// copies of the operator share the const values
 	return m_pdrgpcoldesc->Equals(popCTG->Pdrgpcoldesc()) &&
-		   m_pdrgpdrgpdatum->Equals(popCTG->Pdrgpdrgpdatum()) &&
+		   (m_pdrgpdrgpdatum == popCTG->Pdrgpdrgpdatum() ||
+			m_pdrgpdrgpdatum->Equals(popCTG->Pdrgpdrgpdatum())) &&
 		   m_pdrgpcrOutput->Equals(popCTG->PdrgpcrOutput());
 }
 
@@ -17,17 +17,22 @@
 #include "gpos/task/CAutoTraceFlag.h"
 #include "gpos/task/CWorker.h"
 
+#include "gpopt/base/CColRefTable.h"
 #include "gpopt/base/CDrvdProp.h"
 #include "gpopt/base/CDrvdPropCtxtPlan.h"
 #include "gpopt/base/CDrvdPropCtxtRelational.h"
+#include "gpopt/base/COptCtxt.h"
 #include "gpopt/base/COptimizationContext.h"
 #include "gpopt/exception.h"
+#include "gpopt/mdcache/CMDAccessor.h"
 #include "gpopt/operators/CExpressionHandle.h"
 #include "gpopt/operators/CLogicalCTEConsumer.h"
 #include "gpopt/operators/CLogicalCTEProducer.h"
 #include "gpopt/operators/CLogicalInnerJoin.h"
+#include "gpopt/operators/CLogicalNAryJoin.h"
 #include "gpopt/operators/COperator.h"
 #include "gpopt/operators/CPhysicalMotionGather.h"
+#include "gpopt/operators/CScalarIdent.h"
 #include "gpopt/operators/CScalarSubquery.h"
 #include "gpopt/search/CGroupProxy.h"
 #include "gpopt/search/CJobGroup.h"
@@ -172,7 +177,10 @@ CGroup::CGroup(CMemoryPool *mp, BOOL fScalar)
 	  m_eolMax(EolLow),
 	  m_fHasNewLogicalOperators(false),
 	  m_ulCTEProducerId(gpos::ulong_max),
-	  m_fCTEConsumer(false)
+	  m_fCTEConsumer(false),
+	  m_fFeedbackKeyDerived(false),
+	  m_ullFeedbackKey(0),
+	  m_pmdidFeedbackRel(nullptr)
 {
 	GPOS_ASSERT(nullptr != mp);
 
@@ -1503,6 +1511,10 @@ CGroup::PstatsRecursiveDerive(CMemoryPool *pmpLocal, CMemoryPool *pmpGlobal,
 	// derive stats on group expression and copy them to group
 	stats = pgexprBest->PstatsRecursiveDerive(pmpLocal, pmpGlobal, prprelInput,
 											  stats_ctxt);
+	if (nullptr == Pstats())
+	{
+		stats = PstatsApplyFeedback(pmpGlobal, stats);
+	}
 	if (!FInitStats(stats))
 	{
 		// a group stat object already exists, we append derived stats to that object
@@ -1622,6 +1634,246 @@ CGroup::PgexprBestPromise(CMemoryPool *pmpLocal, CMemoryPool *pmpGlobal,
 	return pgexprBest;
 }
 
+// combine a fingerprint with the fingerprint of a part of the expression
+static ULLONG
+UllCombineFeedbackKeys(ULLONG key, ULLONG value)
+{
+	return (key ^ value) * 0x100000001b3ULL;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		UllScalarFeedbackKey
+//
+//	@doc:
+//		Fingerprint of a scalar expression, made of the operators, functions
+//		and constants in it, and of the table and attribute number of the
+//		columns it references. 0 if it has operators whose identity is not
+//		stable across queries
+//
+//---------------------------------------------------------------------------
+static ULLONG
+UllScalarFeedbackKey(CExpression *pexpr)
+{
+	COperator *pop = pexpr->Pop();
+	ULLONG key = 0;
+
+	switch (pop->Eopid())
+	{
+		case COperator::EopScalarIdent:
+		{
+			CColRef *colref =
+				const_cast<CColRef *>(CScalarIdent::PopConvert(pop)->Pcr());
+			if (CColRef::EcrtTable != colref->Ecrt())
+			{
+				return 0;
+			}
+			CColRefTable *pcrTable = CColRefTable::PcrConvert(colref);
+			return UllCombineFeedbackKeys(pcrTable->GetMdidTable()->HashValue(),
+										  (ULLONG) pcrTable->AttrNum());
+		}
+		case COperator::EopScalarConst:
+		case COperator::EopScalarCmp:
+		case COperator::EopScalarIsDistinctFrom:
+		case COperator::EopScalarBoolOp:
+		case COperator::EopScalarOp:
+		case COperator::EopScalarFunc:
+		case COperator::EopScalarNullTest:
+		case COperator::EopScalarBooleanTest:
+		case COperator::EopScalarNullIf:
+		case COperator::EopScalarCast:
+		case COperator::EopScalarCoerceViaIO:
+		case COperator::EopScalarCoalesce:
+		case COperator::EopScalarSwitch:
+		case COperator::EopScalarSwitchCase:
+		case COperator::EopScalarArray:
+		case COperator::EopScalarArrayCmp:
+			key = pop->HashValue();
+			break;
+		default:
+			return 0;
+	}
+
+	// the arguments of AND and OR may come in any order
+	BOOL fCommutative = COperator::EopScalarBoolOp == pop->Eopid();
+	ULLONG ullArgs = 0;
+	const ULONG arity = pexpr->Arity();
+	for (ULONG ul = 0; ul < arity; ul++)
+	{
+		ULLONG ullArg = UllScalarFeedbackKey((*pexpr)[ul]);
+		if (0 == ullArg)
+		{
+			return 0;
+		}
+
+		if (fCommutative)
+		{
+			ullArgs += ullArg;
+		}
+		else
+		{
+			key = UllCombineFeedbackKeys(key, ullArg);
+		}
+	}
+
+	return UllCombineFeedbackKeys(key, ullArgs);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CGroup::FeedbackKey
+//
+//	@doc:
+//		Fingerprint of the logical expression of the group, under which the
+//		actual rows of the operators that implement it are remembered by
+//		the executor. Only gets, selects and joins have one, so that the
+//		fingerprint of an expression doesn't depend on the column ids of
+//		the query it appears in
+//
+//---------------------------------------------------------------------------
+ULLONG
+CGroup::FeedbackKey()
+{
+	if (!m_fFeedbackKeyDerived)
+	{
+		m_ullFeedbackKey = UllDeriveFeedbackKey();
+		m_fFeedbackKeyDerived = true;
+	}
+
+	return m_ullFeedbackKey;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CGroup::UllDeriveFeedbackKey
+//
+//	@doc:
+//		Derive the fingerprint of the first logical expression of the group
+//
+//---------------------------------------------------------------------------
+ULLONG
+CGroup::UllDeriveFeedbackKey()
+{
+	if (FScalar() || !GPOS_FTRACE(EopttraceCardinalityFeedback))
+	{
+		return 0;
+	}
+
+	CGroupExpression *pgexprFirst = nullptr;
+	{
+		CGroupProxy gp(this);
+		pgexprFirst = gp.PgexprFirst();
+	}
+	GPOS_ASSERT(nullptr != pgexprFirst);
+	COperator *pop = pgexprFirst->Pop();
+	ULLONG key = pop->Eopid() + 1;
+
+	// the children of inner joins may come in any order
+	BOOL fCommutative = false;
+	switch (pop->Eopid())
+	{
+		case COperator::EopLogicalGet:
+		case COperator::EopLogicalDynamicGet:
+		{
+			IMDId *rel_mdid = CLogical::PtabdescFromTableGet(pop)->MDId();
+			m_pmdidFeedbackRel = rel_mdid;
+			return UllCombineFeedbackKeys(key, rel_mdid->HashValue());
+		}
+		case COperator::EopLogicalSelect:
+		case COperator::EopLogicalLeftOuterJoin:
+		case COperator::EopLogicalLeftSemiJoin:
+		case COperator::EopLogicalLeftAntiSemiJoin:
+			break;
+		case COperator::EopLogicalInnerJoin:
+			fCommutative = true;
+			break;
+		case COperator::EopLogicalNAryJoin:
+			if (CLogicalNAryJoin::PopConvert(pop)->HasOuterJoinChildren())
+			{
+				return 0;
+			}
+			fCommutative = true;
+			break;
+		default:
+			return 0;
+	}
+
+	ULLONG ullChildren = 0;
+	const ULONG arity = pgexprFirst->Arity();
+	for (ULONG ul = 0; ul < arity; ul++)
+	{
+		CGroup *pgroupChild = (*pgexprFirst)[ul];
+		ULLONG ullChild = 0;
+		if (pgroupChild->FScalar())
+		{
+			if (nullptr != pgroupChild->PexprScalarRep() &&
+				pgroupChild->FScalarRepIsExact())
+			{
+				ullChild = UllScalarFeedbackKey(pgroupChild->PexprScalarRep());
+			}
+		}
+		else
+		{
+			ullChild = pgroupChild->FeedbackKey();
+			if (nullptr == m_pmdidFeedbackRel)
+			{
+				m_pmdidFeedbackRel = pgroupChild->m_pmdidFeedbackRel;
+			}
+		}
+
+		if (0 == ullChild)
+		{
+			return 0;
+		}
+
+		if (fCommutative && !pgroupChild->FScalar())
+		{
+			ullChildren += ullChild;
+		}
+		else
+		{
+			key = UllCombineFeedbackKeys(key, ullChild);
+		}
+	}
+
+	return UllCombineFeedbackKeys(key, ullChildren);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CGroup::PstatsApplyFeedback
+//
+//	@doc:
+//		Scale the given stats of the group to the actual rows that executed
+//		plans returned for the expression of the group, if any. Takes over
+//		the reference to the given stats
+//
+//---------------------------------------------------------------------------
+IStatistics *
+CGroup::PstatsApplyFeedback(CMemoryPool *mp, IStatistics *stats)
+{
+	ULLONG key = FeedbackKey();
+	if (0 == key || nullptr == m_pmdidFeedbackRel)
+	{
+		return stats;
+	}
+
+	CDouble rows(0.0);
+	CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
+	if (!md_accessor->CardinalityFeedback(m_pmdidFeedbackRel, key, &rows) ||
+		stats->Rows() <= CDouble(0.0))
+	{
+		return stats;
+	}
+
+	// like the estimates, the feedback is never less than one row
+	rows = std::max(rows, CDouble(1.0));
+	IStatistics *scaled_stats = stats->ScaleStats(mp, rows / stats->Rows());
+	stats->Release();
+
+	return scaled_stats;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CGroup::PstatsInitEmpty
@@ -1992,6 +2244,7 @@ CGroup::PstatsCompute(COptimizationContext *poc, CExpressionHandle &exprhdl,
 	stats = CLogical::PopConvert(pgexpr->Pop())
 				->PstatsDerive(m_mp, exprhdl, poc->Pdrgpstat());
 	GPOS_ASSERT(nullptr != stats);
+	stats = PstatsApplyFeedback(m_mp, stats);
 
 	// add computed stats to local map
 	poc->AddRef();
@@ -128,4 +128,33 @@ CSearchStage::PdrgpssDefault(CMemoryPool *mp)
 	return search_stage_array;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CSearchStage::PdrgpssTrivial
+//
+//	@doc:
+//		Generate search strategy for single-table queries without joins,
+//		subqueries, aggregates or CTEs; one stage with the exploration
+//		xforms for index access paths, limits and DML only, as none of
+//		the others applies to such a query
+//
+//---------------------------------------------------------------------------
+CSearchStageArray *
+CSearchStage::PdrgpssTrivial(CMemoryPool *mp)
+{
+	CXformSet *xform_set = GPOS_NEW(mp) CXformSet(mp);
+	(void) xform_set->ExchangeSet(CXform::ExfSelect2IndexGet);
+	(void) xform_set->ExchangeSet(CXform::ExfSelect2BitmapBoolOp);
+	(void) xform_set->ExchangeSet(CXform::ExfSplitLimit);
+	(void) xform_set->ExchangeSet(CXform::ExfCollapseProject);
+	(void) xform_set->ExchangeSet(CXform::ExfInsert2DML);
+	(void) xform_set->ExchangeSet(CXform::ExfDelete2DML);
+	(void) xform_set->ExchangeSet(CXform::ExfUpdate2DML);
+	CSearchStageArray *search_stage_array = GPOS_NEW(mp) CSearchStageArray(mp);
+
+	search_stage_array->Append(GPOS_NEW(mp) CSearchStage(xform_set));
+
+	return search_stage_array;
+}
+
 // EOF
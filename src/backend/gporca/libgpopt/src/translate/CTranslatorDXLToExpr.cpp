@@ -37,9 +37,12 @@
 #include "gpopt/operators/CLogicalExternalGet.h"
 #include "gpopt/operators/CLogicalGbAgg.h"
 #include "gpopt/operators/CLogicalGet.h"
+#include "gpopt/operators/CLogicalInnerApply.h"
+#include "gpopt/operators/CLogicalInnerJoin.h"
 #include "gpopt/operators/CLogicalInsert.h"
 #include "gpopt/operators/CLogicalIntersect.h"
 #include "gpopt/operators/CLogicalIntersectAll.h"
+#include "gpopt/operators/CLogicalLeftOuterApply.h"
 #include "gpopt/operators/CLogicalLimit.h"
 #include "gpopt/operators/CLogicalProject.h"
 #include "gpopt/operators/CLogicalSelect.h"
@@ -58,6 +61,7 @@
 #include "gpopt/operators/CScalarCoalesce.h"
 #include "gpopt/operators/CScalarCoerceToDomain.h"
 #include "gpopt/operators/CScalarCoerceViaIO.h"
+#include "gpopt/operators/CScalarFunc.h"
 #include "gpopt/operators/CScalarIdent.h"
 #include "gpopt/operators/CScalarIf.h"
 #include "gpopt/operators/CScalarIsDistinctFrom.h"
@@ -590,19 +594,8 @@ CTranslatorDXLToExpr::PexprLogicalGet(const CDXLNode *dxlnode)
 	{
 		GPOS_ASSERT(EdxlopLogicalGet == edxlopid);
 
+		// the child partitions are the leaves of all levels of the hierarchy
 		IMdIdArray *partition_mdids = pmdrel->ChildPartitionMdids();
-		for (ULONG ul = 0; ul < partition_mdids->Size(); ++ul)
-		{
-			IMDId *part_mdid = (*partition_mdids)[ul];
-			const IMDRelation *partrel = m_pmda->RetrieveRel(part_mdid);
-
-			if (partrel->IsPartitioned())
-			{
-				// Multi-level partitioned tables are unsupported - fall back
-				GPOS_RAISE(gpdxl::ExmaMD, gpdxl::ExmiMDObjUnsupported,
-						   GPOS_WSZ_LIT("Multi-level partitioned tables"));
-			}
-		}
 
 		// generate a part index id
 		ULONG part_idx_id = COptCtxt::PoctxtFromTLS()->UlPartIndexNextVal();
@@ -2004,6 +1997,12 @@ CTranslatorDXLToExpr::PexprLogicalJoin(const CDXLNode *dxlnode)
 		pdrgpexprChildren->Append(pexprNxtChild);
 	}
 
+	if (EdxljtFull != join_type &&
+		FHasLateralReferences(m_mp, pdrgpexprChildren))
+	{
+		return PexprLateralJoin(dxlnode, join_type, pdrgpexprChildren);
+	}
+
 	// get the scalar condition and then translate it
 	CDXLNode *pdxlnCond = (*dxlnode)[ulChildCount - 1];
 	CExpression *pexprCond = PexprScalar(pdxlnCond);
@@ -2038,6 +2037,191 @@ CTranslatorDXLToExpr::PexprRightOuterJoin(const CDXLNode *dxlnode)
 	return CUtils::PexprLogicalJoin(m_mp, EdxljtLeft, pdrgpexprChildren);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorDXLToExpr::FHasLateralReferences
+//
+//	@doc:
+// 		Does a child of a join reference the columns of the children before
+//		it, i.e. is it a LATERAL subquery or function
+//
+//---------------------------------------------------------------------------
+BOOL
+CTranslatorDXLToExpr::FHasLateralReferences(CMemoryPool *mp,
+											CExpressionArray *pdrgpexprChildren)
+{
+	CColRefSet *pcrsLeft = GPOS_NEW(mp) CColRefSet(mp);
+	BOOL fLateral = false;
+
+	const ULONG ulChildren = pdrgpexprChildren->Size();
+	for (ULONG ul = 0; ul < ulChildren && !fLateral; ul++)
+	{
+		CExpression *pexprChild = (*pdrgpexprChildren)[ul];
+		fLateral = !pexprChild->DeriveOuterReferences()->IsDisjoint(pcrsLeft);
+		pcrsLeft->Include(pexprChild->DeriveOutputColumns());
+	}
+	pcrsLeft->Release();
+
+	return fLateral;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorDXLToExpr::PexprLateralJoin
+//
+//	@doc:
+// 		Translate a DXL inner or left join with LATERAL children. The children
+//		are joined left-deep, and a child that references the columns of the
+//		children before it is joined to them with an apply. The decorrelation
+//		xforms turn the applies into joins where the references allow it.
+//
+//---------------------------------------------------------------------------
+CExpression *
+CTranslatorDXLToExpr::PexprLateralJoin(const CDXLNode *dxlnode,
+									   EdxlJoinType join_type,
+									   CExpressionArray *pdrgpexprChildren)
+{
+	GPOS_ASSERT(EdxljtInner == join_type || EdxljtLeft == join_type);
+
+	const ULONG ulChildren = pdrgpexprChildren->Size();
+	GPOS_ASSERT_IMP(EdxljtLeft == join_type, 2 == ulChildren);
+
+	CExpression *pexprLeft = (*pdrgpexprChildren)[0];
+	pexprLeft->AddRef();
+
+	if (EdxljtLeft == join_type)
+	{
+		CExpression *pexprRight = (*pdrgpexprChildren)[1];
+		pexprRight->AddRef();
+		pdrgpexprChildren->Release();
+
+		CColRefArray *pdrgpcrInner =
+			pexprRight->DeriveOutputColumns()->Pdrgpcr(m_mp);
+		CExpression *pexprCond = PexprScalar((*dxlnode)[ulChildren]);
+
+		return CUtils::PexprLogicalApply<CLogicalLeftOuterApply>(
+			m_mp, pexprLeft, pexprRight, pdrgpcrInner,
+			COperator::EopScalarSubquery, pexprCond);
+	}
+
+	for (ULONG ul = 1; ul < ulChildren; ul++)
+	{
+		CExpression *pexprRight = (*pdrgpexprChildren)[ul];
+		pexprRight->AddRef();
+
+		if (pexprRight->DeriveOuterReferences()->IsDisjoint(
+				pexprLeft->DeriveOutputColumns()))
+		{
+			pexprLeft = CUtils::PexprLogicalJoin<CLogicalInnerJoin>(
+				m_mp, pexprLeft, pexprRight,
+				CUtils::PexprScalarConstBool(m_mp, true /*value*/));
+			continue;
+		}
+
+		CExpression *pexprProject =
+			PexprProjectLateralTVF(pexprLeft, pexprRight, (*dxlnode)[ul]);
+		if (nullptr != pexprProject)
+		{
+			pexprLeft = pexprProject;
+			continue;
+		}
+
+		CColRefArray *pdrgpcrInner =
+			pexprRight->DeriveOutputColumns()->Pdrgpcr(m_mp);
+		pexprLeft = CUtils::PexprLogicalApply<CLogicalInnerApply>(
+			m_mp, pexprLeft, pexprRight, pdrgpcrInner,
+			COperator::EopScalarSubquery);
+	}
+	pdrgpexprChildren->Release();
+
+	// the join condition goes on top, the normalizer pushes its conjuncts
+	// down to the children producing their columns
+	CExpression *pexprCond = PexprScalar((*dxlnode)[ulChildren]);
+
+	return CUtils::PexprSafeSelect(m_mp, pexprLeft, pexprCond);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorDXLToExpr::PexprProjectLateralTVF
+//
+//	@doc:
+// 		An inner join with a LATERAL set-returning function returning a single
+//		column is the same as calling the function in a project over the
+//		outer side, which needs no correlated execution. Return the project,
+//		or NULL if the function is not such a function. On success, the
+//		references to the column of the function are remapped to the
+//		projected column, and the TVF expression is released.
+//
+//---------------------------------------------------------------------------
+CExpression *
+CTranslatorDXLToExpr::PexprProjectLateralTVF(CExpression *pexprLeft,
+											 CExpression *pexprTVF,
+											 const CDXLNode *pdxlnTVF)
+{
+	if (COperator::EopLogicalTVF != pexprTVF->Pop()->Eopid())
+	{
+		return nullptr;
+	}
+
+	CLogicalTVF *popTVF = CLogicalTVF::PopConvert(pexprTVF->Pop());
+	CColRefArray *pdrgpcrOutput = popTVF->PdrgpcrOutput();
+	const IMDFunction *pmdfunc = m_pmda->RetrieveFunc(popTVF->FuncMdId());
+
+	// functions returning a composite type would need a field select for
+	// each of their columns
+	if (1 != pdrgpcrOutput->Size() || !pmdfunc->ReturnsSet() ||
+		!(*pdrgpcrOutput)[0]->RetrieveType()->MDId()->Equals(
+			popTVF->ReturnTypeMdId()))
+	{
+		return nullptr;
+	}
+
+	CColRef *pcrTVF = (*pdrgpcrOutput)[0];
+	CColumnFactory *col_factory = COptCtxt::PoctxtFromTLS()->Pcf();
+	CColRef *colref = col_factory->PcrCreate(
+		pcrTVF->RetrieveType(), pcrTVF->TypeModifier(), pcrTVF->Name());
+
+	IMDId *mdid_func = popTVF->FuncMdId();
+	mdid_func->AddRef();
+	IMDId *mdid_return_type = popTVF->ReturnTypeMdId();
+	mdid_return_type->AddRef();
+	CScalarFunc *popFunc = GPOS_NEW(m_mp) CScalarFunc(
+		m_mp, mdid_func, mdid_return_type, pcrTVF->TypeModifier(),
+		GPOS_NEW(m_mp)
+			CWStringConst(m_mp, pmdfunc->Mdname().GetMDName()->GetBuffer()),
+		COperator::EcfExplicitCall);
+
+	CExpression *pexprFunc = nullptr;
+	if (0 < pexprTVF->Arity())
+	{
+		CExpressionArray *pdrgpexprArgs = pexprTVF->PdrgPexpr();
+		pdrgpexprArgs->AddRef();
+		pexprFunc = GPOS_NEW(m_mp) CExpression(m_mp, popFunc, pdrgpexprArgs);
+	}
+	else
+	{
+		pexprFunc = GPOS_NEW(m_mp) CExpression(m_mp, popFunc);
+	}
+	pexprTVF->Release();
+
+	CExpression *pexprPrjList = GPOS_NEW(m_mp) CExpression(
+		m_mp, GPOS_NEW(m_mp) CScalarProjectList(m_mp),
+		CUtils::PexprScalarProjectElement(m_mp, colref, pexprFunc));
+
+	// the join condition and the operators above the join are translated
+	// after this, so their references to the column of the function
+	// resolve to the projected column
+	ULONG colid = CDXLLogicalTVF::Cast(pdxlnTVF->GetOperator())
+					  ->GetColumnDescrAt(0)
+					  ->Id();
+	BOOL fReplaced GPOS_ASSERTS_ONLY = m_phmulcr->Replace(&colid, colref);
+	GPOS_ASSERT(fReplaced);
+
+	return CUtils::PexprLogicalProject(m_mp, pexprLeft, pexprPrjList,
+									   true /*fNewComputedCol*/);
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorDXLToExpr::Ptabdesc
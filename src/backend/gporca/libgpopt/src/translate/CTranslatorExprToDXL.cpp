@@ -23,6 +23,7 @@
 
 #include "gpopt/base/CCastUtils.h"
 #include "gpopt/base/CColRefSetIter.h"
+#include "gpopt/base/CColRefTable.h"
 #include "gpopt/base/CConstraintInterval.h"
 #include "gpopt/base/COptCtxt.h"
 #include "gpopt/base/CUtils.h"
@@ -4923,7 +4924,17 @@ CTranslatorExprToDXL::PdxlnPartitionSelector(
 						   m_mp, popSelector->MDId(), popSelector->SelectorId(),
 						   popSelector->ScanId(), parts));
 
-	CDXLNode *pdxlnFilter = PdxlnScalar(popSelector->FilterExpr());
+	CDXLNode *pdxlnFilter = nullptr;
+	const IMDRelation *root_rel = m_pmda->RetrieveRel(popSelector->MDId());
+	if (1 < root_rel->PartColumnCount())
+	{
+		pdxlnFilter =
+			PdxlnPartSelectorFilterPerLevel(root_rel, popSelector->FilterExpr());
+	}
+	else
+	{
+		pdxlnFilter = PdxlnScalar(popSelector->FilterExpr());
+	}
 	CDXLPhysicalProperties *dxl_properties = GetProperties(pexprChild);
 
 	pdxlnSelector->SetProperties(dxl_properties);
@@ -4934,6 +4945,93 @@ CTranslatorExprToDXL::PdxlnPartitionSelector(
 	return pdxlnSelector;
 }
 
+// Is the expression a comparison of the partition key with the given attno,
+// or an AND/OR of such comparisons? CPredicateUtils::ValidatePartPruningExpr()
+// puts the partition key on the LHS of the comparisons.
+static BOOL
+FPartPruningExprOnKey(CExpression *pexpr, INT attno)
+{
+	if (CPredicateUtils::FAnd(pexpr) || CPredicateUtils::FOr(pexpr))
+	{
+		for (ULONG ul = 0; ul < pexpr->Arity(); ul++)
+		{
+			if (!FPartPruningExprOnKey((*pexpr)[ul], attno))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	if (COperator::EopScalarCmp != pexpr->Pop()->Eopid())
+	{
+		return false;
+	}
+
+	const CColRef *colref =
+		CCastUtils::PcrExtractFromScIdOrCastScId((*pexpr)[0]);
+
+	return nullptr != colref && CColRef::EcrtTable == colref->Ecrt() &&
+		   attno == CColRefTable::PcrConvert(const_cast<CColRef *>(colref))
+						->AttrNum();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CTranslatorExprToDXL::PdxlnPartSelectorFilterPerLevel
+//
+//	@doc:
+//		Translate the filter of a partition selector of a multi-level
+//		partitioned table. Each level of the hierarchy is pruned with the
+//		predicates on its own key, so the filter is translated into a
+//		conjunction with one child per level, in the order of the levels.
+//		A level without predicates gets a true constant.
+//
+//		CPartPruneStepsBuilder only turns comparisons and AND/OR trees of
+//		them into pruning steps, so other conjuncts, like IS NULL or array
+//		comparisons, are left out. Pruning on fewer predicates keeps more
+//		partitions, and the scan still applies the whole predicate.
+//
+//---------------------------------------------------------------------------
+CDXLNode *
+CTranslatorExprToDXL::PdxlnPartSelectorFilterPerLevel(
+	const IMDRelation *root_rel, CExpression *pexprFilter)
+{
+	CExpressionArray *pdrgpexprConjuncts =
+		CPredicateUtils::PdrgpexprConjuncts(m_mp, pexprFilter);
+
+	CDXLNode *pdxlnFilter = GPOS_NEW(m_mp)
+		CDXLNode(m_mp, GPOS_NEW(m_mp) CDXLScalarBoolExpr(m_mp, Edxland));
+
+	const ULONG num_levels = root_rel->PartColumnCount();
+	for (ULONG level = 0; level < num_levels; level++)
+	{
+		const INT attno = root_rel->PartColAt(level)->AttrNum();
+		CExpressionArray *pdrgpexprLevel = GPOS_NEW(m_mp) CExpressionArray(m_mp);
+
+		for (ULONG ul = 0; ul < pdrgpexprConjuncts->Size(); ul++)
+		{
+			CExpression *pexprConjunct = (*pdrgpexprConjuncts)[ul];
+
+			if (FPartPruningExprOnKey(pexprConjunct, attno))
+			{
+				pexprConjunct->AddRef();
+				pdrgpexprLevel->Append(pexprConjunct);
+			}
+		}
+
+		// a conjunction of no predicates is a true constant
+		CExpression *pexprLevel =
+			CPredicateUtils::PexprConjunction(m_mp, pdrgpexprLevel);
+		pdxlnFilter->AddChild(PdxlnScalar(pexprLevel));
+		pexprLevel->Release();
+	}
+
+	pdrgpexprConjuncts->Release();
+
+	return pdxlnFilter;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CTranslatorExprToDXL::PdxlnDML
@@ -5830,6 +5928,12 @@ CTranslatorExprToDXL::PdxlnScAggref(CExpression *pexprAggFunc)
 	pdxlnAggref->AddChild(
 		PdxlnValuesList((*pexprAggFunc)[EdxlscalaraggrefIndexAggDistinct]));
 
+	if (EdxlscalaraggrefIndexAggFilter < pexprAggFunc->Arity())
+	{
+		pdxlnAggref->AddChild(
+			PdxlnValuesList((*pexprAggFunc)[EdxlscalaraggrefIndexAggFilter]));
+	}
+
 	return pdxlnAggref;
 }
 
@@ -6849,10 +6953,11 @@ CTranslatorExprToDXL::GetProperties(const CExpression *pexpr)
 		rows = stats->Rows();
 	}
 
-	if (CDistributionSpec::EdtStrictReplicated ==
-			pexpr->GetDrvdPropPlan()->Pds()->Edt() ||
-		CDistributionSpec::EdtTaintedReplicated ==
-			pexpr->GetDrvdPropPlan()->Pds()->Edt())
+	BOOL fReplicated = CDistributionSpec::EdtStrictReplicated ==
+						   pexpr->GetDrvdPropPlan()->Pds()->Edt() ||
+					   CDistributionSpec::EdtTaintedReplicated ==
+						   pexpr->GetDrvdPropPlan()->Pds()->Edt();
+	if (fReplicated)
 	{
 		// if distribution is replicated, multiply number of rows by number of segments
 		ULONG ulSegments = COptCtxt::PoctxtFromTLS()->GetCostModel()->UlHosts();
@@ -6891,6 +6996,13 @@ CTranslatorExprToDXL::GetProperties(const CExpression *pexpr)
 	CDXLPhysicalProperties *dxl_properties =
 		GPOS_NEW(m_mp) CDXLPhysicalProperties(cost);
 
+	// the actual rows of the operator can be fed back to the statistics of
+	// its group, unless it returns a copy of them on every segment
+	if (!fReplicated)
+	{
+		dxl_properties->SetFeedbackKey(pexpr->FeedbackKey());
+	}
+
 	return dxl_properties;
 }
 
@@ -1100,41 +1100,51 @@ CTranslatorExprToDXLUtils::PdxlnResult(CMemoryPool *mp,
 	return pdxlnResult;
 }
 
-// create a DXL Value Scan node
+// create a DXL Value Scan node; the values are carried by the operator
+// rather than as value list children of scalar constants, as a VALUES list
+// may have a great many tuples
 CDXLNode *
 CTranslatorExprToDXLUtils::PdxlnValuesScan(
 	CMemoryPool *mp, CDXLPhysicalProperties *dxl_properties, CDXLNode *pdxlnPrL,
 	IDatum2dArray *pdrgpdrgdatum)
 {
-	CDXLPhysicalValuesScan *dxl_op = GPOS_NEW(mp) CDXLPhysicalValuesScan(mp);
-	CDXLNode *pdxlnValuesScan = GPOS_NEW(mp) CDXLNode(mp, dxl_op);
-	pdxlnValuesScan->SetProperties(dxl_properties);
-
-	pdxlnValuesScan->AddChild(pdxlnPrL);
-
+	CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
 	const ULONG ulTuples = pdrgpdrgdatum->Size();
+	GPOS_ASSERT(0 < ulTuples);
+
+	// all datums of a column have the same type
+	IDatumArray *pdrgpdatumFirst = (*pdrgpdrgdatum)[0];
+	const ULONG num_cols = pdrgpdatumFirst->Size();
+	const IMDType **rgpmdtype = GPOS_NEW_ARRAY(mp, const IMDType *, num_cols);
+	for (ULONG ulColPos = 0; ulColPos < num_cols; ulColPos++)
+	{
+		rgpmdtype[ulColPos] =
+			md_accessor->RetrieveType((*pdrgpdatumFirst)[ulColPos]->MDId());
+	}
 
+	CDXLDatum2dArray *pdrgpdrgpdxldatum = GPOS_NEW(mp) CDXLDatum2dArray(mp);
 	for (ULONG ulTuplePos = 0; ulTuplePos < ulTuples; ulTuplePos++)
 	{
 		IDatumArray *pdrgpdatum = (*pdrgpdrgdatum)[ulTuplePos];
-		pdrgpdatum->AddRef();
-		const ULONG num_cols = pdrgpdatum->Size();
-		CDXLScalarValuesList *values = GPOS_NEW(mp) CDXLScalarValuesList(mp);
-		CDXLNode *value_list_dxlnode = GPOS_NEW(mp) CDXLNode(mp, values);
+		GPOS_ASSERT(num_cols == pdrgpdatum->Size());
+		CDXLDatumArray *pdrgpdxldatum = GPOS_NEW(mp) CDXLDatumArray(mp);
 
 		for (ULONG ulColPos = 0; ulColPos < num_cols; ulColPos++)
 		{
 			IDatum *datum = (*pdrgpdatum)[ulColPos];
-			CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
-			const IMDType *pmdtype = md_accessor->RetrieveType(datum->MDId());
-
-			CDXLNode *pdxlnValue =
-				GPOS_NEW(mp) CDXLNode(mp, pmdtype->GetDXLOpScConst(mp, datum));
-			value_list_dxlnode->AddChild(pdxlnValue);
+			GPOS_ASSERT(datum->MDId()->Equals(rgpmdtype[ulColPos]->MDId()));
+			pdrgpdxldatum->Append(rgpmdtype[ulColPos]->GetDatumVal(mp, datum));
 		}
-		pdrgpdatum->Release();
-		pdxlnValuesScan->AddChild(value_list_dxlnode);
+		pdrgpdrgpdxldatum->Append(pdrgpdxldatum);
 	}
+	GPOS_DELETE_ARRAY(rgpmdtype);
+
+	CDXLPhysicalValuesScan *dxl_op =
+		GPOS_NEW(mp) CDXLPhysicalValuesScan(mp, pdrgpdrgpdxldatum);
+	CDXLNode *pdxlnValuesScan = GPOS_NEW(mp) CDXLNode(mp, dxl_op);
+	pdxlnValuesScan->SetProperties(dxl_properties);
+
+	pdxlnValuesScan->AddChild(pdxlnPrL);
 
 #ifdef GPOS_DEBUG
 	dxl_op->AssertValid(pdxlnValuesScan, true /* validate_children */);
@@ -176,6 +176,12 @@ CXformEagerAgg::CanPushAggBelowJoin(CExpression *scalar_agg_func_expr)
 		return false;
 	}
 
+	// not supporting FILTER, it may reference the other side of the join
+	if (EaggfuncIndexFilter < scalar_agg_func_expr->Arity())
+	{
+		return false;
+	}
+
 	COptCtxt *poctxt = COptCtxt::PoctxtFromTLS();
 	CMDAccessor *md_accessor = poctxt->Pmda();
 	IMDId *agg_mdid =
@@ -2600,6 +2600,51 @@ CXformUtils::FProcessGPDBAntiSemiHashJoin(
 	return true;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformUtils::MoveLowerArrayCmpsToResidual
+//
+//	@doc:
+//		A btree scan with an array comparison on a key other than the first
+//		one does not return its rows in index order, so evaluate such
+//		comparisons as a filter instead, like the planner does for ordered
+//		index paths. An array comparison on the first key is done by one
+//		index probe per array element.
+//
+//---------------------------------------------------------------------------
+void
+CXformUtils::MoveLowerArrayCmpsToResidual(CMemoryPool *mp,
+										  CColRefArray *pdrgpcrIndexCols,
+										  CExpressionArray **ppdrgpexprIndex,
+										  CExpressionArray *pdrgpexprResidual)
+{
+	CExpressionArray *pdrgpexprIndex = *ppdrgpexprIndex;
+	CExpressionArray *pdrgpexprIndexNew = GPOS_NEW(mp) CExpressionArray(mp);
+
+	const ULONG size = pdrgpexprIndex->Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		CExpression *pexprPred = (*pdrgpexprIndex)[ul];
+		pexprPred->AddRef();
+
+		if (CUtils::FScalarArrayCmp(pexprPred))
+		{
+			CColRef *pcrIndexKey =
+				(*pexprPred)[0]->DeriveUsedColumns()->PcrFirst();
+			if (0 != pdrgpcrIndexCols->IndexOf(pcrIndexKey))
+			{
+				pdrgpexprResidual->Append(pexprPred);
+				continue;
+			}
+		}
+
+		pdrgpexprIndexNew->Append(pexprPred);
+	}
+
+	pdrgpexprIndex->Release();
+	*ppdrgpexprIndex = pdrgpexprIndexNew;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CXformUtils::PexprBuildIndexPlan
@@ -2680,7 +2725,13 @@ CXformUtils::PexprBuildBtreeIndexPlan(
 	CExpressionArray *pdrgpexprResidual = GPOS_NEW(mp) CExpressionArray(mp);
 	CPredicateUtils::ExtractIndexPredicates(
 		mp, md_accessor, pdrgpexprConds, pmdindex, pdrgppcrIndexCols,
-		pdrgpexprIndex, pdrgpexprResidual, outer_refs);
+		pdrgpexprIndex, pdrgpexprResidual, outer_refs,
+		true /*allowArrayCmpForBTreeIndexes*/);
+	if (IMDIndex::EmdindBtree == pmdindex->IndexType())
+	{
+		MoveLowerArrayCmpsToResidual(mp, pdrgppcrIndexCols, &pdrgpexprIndex,
+									 pdrgpexprResidual);
+	}
 	CColRefSet *outer_refs_in_index_get =
 		CUtils::PcrsExtractColumns(mp, pdrgpexprIndex);
 	outer_refs_in_index_get->Intersection(outer_refs);
@@ -3304,7 +3355,7 @@ CXformUtils::CreateBitmapIndexProbesWithOrWithoutPredBreakdown(
 			if (!isAPartialPredicateOrArrayCmp)
 			{
 				// consider a bitmap index scan on a btree index if we find any array comparisons,
-				// since we currently don't support those for regular index scans
+				// as an alternative to the regular index scans with array keys
 				CExpressionArray *conjuncts =
 					CPredicateUtils::PdrgpexprConjuncts(pmp, pexprPred);
 				ULONG size = conjuncts->Size();
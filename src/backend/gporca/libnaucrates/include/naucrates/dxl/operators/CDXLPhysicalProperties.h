@@ -35,6 +35,10 @@ private:
 	// cost estimate
 	CDXLOperatorCost *m_operator_cost_dxl;
 
+	// fingerprint of the logical expression computed by the operator, for
+	// cardinality feedback; not serialized
+	ULLONG m_feedback_key;
+
 public:
 	CDXLPhysicalProperties(const CDXLPhysicalProperties &) = delete;
 
@@ -52,6 +56,19 @@ public:
 	// the cost estimates for the operator node
 	CDXLOperatorCost *GetDXLOperatorCost() const;
 
+	// fingerprint of the logical expression computed by the operator
+	ULLONG
+	GetFeedbackKey() const
+	{
+		return m_feedback_key;
+	}
+
+	void
+	SetFeedbackKey(ULLONG key)
+	{
+		m_feedback_key = key;
+	}
+
 	Edxlproperty
 	GetDXLPropertyType() const override
 	{
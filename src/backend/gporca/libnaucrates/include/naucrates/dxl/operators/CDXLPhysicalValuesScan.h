@@ -14,6 +14,7 @@
 
 #include "gpos/base.h"
 
+#include "naucrates/dxl/operators/CDXLDatum.h"
 #include "naucrates/dxl/operators/CDXLPhysical.h"
 
 namespace gpdxl
@@ -29,12 +30,18 @@ enum EdxlnVal
 class CDXLPhysicalValuesScan : public CDXLPhysical
 {
 private:
+	// values of the tuples, if they are not given as value list children
+	CDXLDatum2dArray *m_values;
+
 public:
 	CDXLPhysicalValuesScan(CDXLPhysicalValuesScan &) = delete;
 
 	// ctor
 	CDXLPhysicalValuesScan(CMemoryPool *mp);
 
+	// ctor for a values scan of constant tuples, without value list children
+	CDXLPhysicalValuesScan(CMemoryPool *mp, CDXLDatum2dArray *values);
+
 	// dtor
 	~CDXLPhysicalValuesScan() override;
 
@@ -44,6 +51,13 @@ public:
 	// get operator name
 	const CWStringConst *GetOpNameStr() const override;
 
+	// values of the tuples, or null if they are value list children
+	const CDXLDatum2dArray *
+	GetValues() const
+	{
+		return m_values;
+	}
+
 	// serialize operator in DXL format
 	void SerializeToDXL(CXMLSerializer *xml_serializer,
 						const CDXLNode *dxlnode) const override;
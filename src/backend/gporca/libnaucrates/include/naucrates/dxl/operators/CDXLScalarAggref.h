@@ -27,6 +27,7 @@ enum Edxlascalarggref
 	EdxlscalaraggrefIndexDirectArgs,
 	EdxlscalaraggrefIndexAggOrder,
 	EdxlscalaraggrefIndexAggDistinct,
+	EdxlscalaraggrefIndexAggFilter,	 // optional, only present with a FILTER
 };
 
 enum EdxlAggrefStage
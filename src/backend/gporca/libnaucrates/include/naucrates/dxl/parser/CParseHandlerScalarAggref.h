@@ -29,6 +29,7 @@ enum EAggrefChildIndices
 	EdxlParseHandlerAggrefIndexDirectArgs,
 	EdxlParseHandlerAggrefIndexOrder,
 	EdxlParseHandlerAggrefIndexDistinct,
+	EdxlParseHandlerAggrefIndexFilter,
 	EdxlParseHandlerAggrefIndexSentinel
 };
 
@@ -15,7 +15,9 @@
 #define GPMD_IMDProvider_H
 
 #include "gpos/base.h"
+#include "gpos/common/CDouble.h"
 #include "gpos/common/CHashMap.h"
+#include "gpos/common/CHashMapIter.h"
 #include "gpos/string/CWStringBase.h"
 #include "gpos/string/CWStringConst.h"
 
@@ -23,10 +25,25 @@
 #include "naucrates/md/IMDId.h"
 #include "naucrates/md/IMDType.h"
 
+// fwd decl
+namespace gpdxl
+{
+class CDXLNode;
+}
+
 namespace gpmd
 {
 using namespace gpos;
 
+// hash map from column id to attribute number
+using UlongToIntMap =
+	CHashMap<ULONG, INT, gpos::HashValue<ULONG>, gpos::Equals<ULONG>,
+			 CleanupDelete<ULONG>, CleanupDelete<INT>>;
+
+using UlongToIntMapIter =
+	CHashMapIter<ULONG, INT, gpos::HashValue<ULONG>, gpos::Equals<ULONG>,
+				 CleanupDelete<ULONG>, CleanupDelete<INT>>;
+
 //---------------------------------------------------------------------------
 //	@class:
 //		IMDProvider
@@ -57,6 +74,32 @@ public:
 	// return the mdid for the specified system id and type
 	virtual IMDId *MDId(CMemoryPool *mp, CSystemId sysid,
 						IMDType::ETypeInfo type_info) const = 0;
+
+	// estimate the selectivity of a predicate on the given relation by
+	// evaluating it on a sample of the relation; the columns of the predicate
+	// are mapped to the attributes of the relation by 'colid_to_attno'.
+	// return false if no estimate is available
+	virtual BOOL
+	SampleSelectivity(CMemoryPool *,			// mp
+					  CMDAccessor *,			// md_accessor
+					  IMDId *,					// rel_mdid
+					  const gpdxl::CDXLNode *,	// pred_dxl
+					  UlongToIntMap *,			// colid_to_attno
+					  CDouble *					// selectivity
+	)
+	{
+		return false;
+	}
+
+	// actual rows observed in executed plans for the expression with the
+	// given fingerprint; return false if there are none
+	virtual BOOL
+	CardinalityFeedback(ULLONG,	   // key
+						CDouble *  // rows
+	)
+	{
+		return false;
+	}
 };
 
 // arrays of MD providers
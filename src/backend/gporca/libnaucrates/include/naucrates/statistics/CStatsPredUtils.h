@@ -123,6 +123,15 @@ private:
 												  CExpression *predicate_expr,
 												  CColRefSet *outer_refs);
 
+	// can the predicate be evaluated on a sample of a base table
+	static BOOL IsPredSampleable(CExpression *predicate_expr);
+
+	// replace the default scale factor of an unsupported statistics
+	// predicate with the one observed on a sample of the base table
+	static CStatsPred *SampleStatsPredUnsupported(CMemoryPool *mp,
+												  CExpression *predicate_expr,
+												  CStatsPred *pred_stats);
+
 	// generate a point predicate for expressions of the form colid CMP constant for which we support stats calculation;
 	// else return an unsupported stats predicate
 	static CStatsPred *GetPredStats(CMemoryPool *mp, CExpression *expr);
@@ -245,6 +245,18 @@ enum EOptTraceFlag
 
 	// Use experimental cost model
 	EopttraceExperimentalCostModel = 104009,
+
+	// string datums are mapped to LINTs in their sort order, so their
+	// histograms support range predicates
+	EopttraceTextRangeStats = 104010,
+
+	// estimate predicates unsupported by the statistics framework by
+	// evaluating them on a sample of the relation
+	EopttraceDynamicSampling = 104011,
+
+	// correct the statistics of expressions with the actual rows of
+	// executed plans that computed them
+	EopttraceCardinalityFeedback = 104012,
 	///////////////////////////////////////////////////////
 	/////////// constant expression evaluator flags ///////
 	///////////////////////////////////////////////////////
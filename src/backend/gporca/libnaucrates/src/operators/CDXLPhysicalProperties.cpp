@@ -24,7 +24,7 @@ using namespace gpdxl;
 //
 //---------------------------------------------------------------------------
 CDXLPhysicalProperties::CDXLPhysicalProperties(CDXLOperatorCost *cost)
-	: CDXLProperties(), m_operator_cost_dxl(cost)
+	: CDXLProperties(), m_operator_cost_dxl(cost), m_feedback_key(0)
 {
 }
 
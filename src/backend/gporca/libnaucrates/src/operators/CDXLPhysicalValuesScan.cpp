@@ -19,12 +19,23 @@ using namespace gpdxl;
 
 // ctor
 CDXLPhysicalValuesScan::CDXLPhysicalValuesScan(CMemoryPool *mp)
-	: CDXLPhysical(mp)
+	: CDXLPhysical(mp), m_values(nullptr)
 {
 }
 
+// ctor
+CDXLPhysicalValuesScan::CDXLPhysicalValuesScan(CMemoryPool *mp,
+											   CDXLDatum2dArray *values)
+	: CDXLPhysical(mp), m_values(values)
+{
+	GPOS_ASSERT(nullptr != values);
+}
+
 // dtor
-CDXLPhysicalValuesScan::~CDXLPhysicalValuesScan() = default;
+CDXLPhysicalValuesScan::~CDXLPhysicalValuesScan()
+{
+	CRefCount::SafeRelease(m_values);
+}
 
 // operator type
 Edxlopid
@@ -62,6 +73,33 @@ CDXLPhysicalValuesScan::SerializeToDXL(CXMLSerializer *xml_serializer,
 
 	// serialize children
 	dxlnode->SerializeChildrenToDXL(xml_serializer);
+
+	// serialize the values as value lists, the way they are parsed
+	const ULONG num_tuples = (nullptr == m_values) ? 0 : m_values->Size();
+	for (ULONG ul = 0; ul < num_tuples; ul++)
+	{
+		GPOS_CHECK_ABORT;
+
+		const CWStringConst *values_list_name =
+			CDXLTokens::GetDXLTokenStr(EdxltokenScalarValuesList);
+		xml_serializer->OpenElement(
+			CDXLTokens::GetDXLTokenStr(EdxltokenNamespacePrefix),
+			values_list_name);
+
+		CDXLDatumArray *datum_array = (*m_values)[ul];
+		const ULONG num_cols = datum_array->Size();
+		for (ULONG ulCol = 0; ulCol < num_cols; ulCol++)
+		{
+			(*datum_array)[ulCol]->Serialize(
+				xml_serializer,
+				CDXLTokens::GetDXLTokenStr(EdxltokenScalarConstValue));
+		}
+
+		xml_serializer->CloseElement(
+			CDXLTokens::GetDXLTokenStr(EdxltokenNamespacePrefix),
+			values_list_name);
+	}
+
 	xml_serializer->CloseElement(
 		CDXLTokens::GetDXLTokenStr(EdxltokenNamespacePrefix), element_name);
 }
@@ -77,7 +115,8 @@ CDXLPhysicalValuesScan::AssertValid(const CDXLNode *dxlnode,
 				dxlnode->GetOperator()->GetDXLOperatorType());
 
 	const ULONG arity = dxlnode->Arity();
-	GPOS_ASSERT(EdxlValIndexSentinel <= arity);
+	GPOS_ASSERT_IMP(nullptr == m_values, EdxlValIndexSentinel <= arity);
+	GPOS_ASSERT_IMP(nullptr != m_values, EdxlValIndexConstStart == arity);
 
 	for (ULONG ul = 0; ul < arity; ul++)
 	{
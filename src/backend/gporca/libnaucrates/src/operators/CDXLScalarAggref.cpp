@@ -254,6 +254,10 @@ CDXLScalarAggref::SerializeToDXL(CXMLSerializer *xml_serializer,
 	SerializeValuesListChildToDXL(xml_serializer, dxlnode, 1, "aggdirectargs");
 	SerializeValuesListChildToDXL(xml_serializer, dxlnode, 2, "aggorder");
 	SerializeValuesListChildToDXL(xml_serializer, dxlnode, 3, "aggdistinct");
+	if (EdxlscalaraggrefIndexAggFilter < dxlnode->Arity())
+	{
+		SerializeValuesListChildToDXL(xml_serializer, dxlnode, 4, "aggfilter");
+	}
 
 	xml_serializer->CloseElement(
 		CDXLTokens::GetDXLTokenStr(EdxltokenNamespacePrefix), element_name);
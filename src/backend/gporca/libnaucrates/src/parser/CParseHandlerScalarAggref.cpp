@@ -137,6 +137,13 @@ CParseHandlerScalarAggref::EndElement(const XMLCh *const,  // element_uri,
 	AddChildFromParseHandler(dynamic_cast<CParseHandlerScalarValuesList *>(
 		(*this)[EdxlParseHandlerAggrefIndexDistinct]));
 
+	// the filter is only present if the aggregate has a FILTER clause
+	if (EdxlParseHandlerAggrefIndexFilter < Length())
+	{
+		AddChildFromParseHandler(dynamic_cast<CParseHandlerScalarValuesList *>(
+			(*this)[EdxlParseHandlerAggrefIndexFilter]));
+	}
+
 	// deactivate handler
 	m_parse_handler_mgr->DeactivateHandler();
 }
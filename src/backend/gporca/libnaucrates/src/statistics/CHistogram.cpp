@@ -571,7 +571,10 @@ CHistogram::IsValid() const
 		return false;
 	}
 
-	if (IsHistogramForTextRelatedTypes())
+	// unless their order is preserved, text datums are mapped to hashes, and
+	// their histograms only hold singleton buckets of MCVs
+	if (IsHistogramForTextRelatedTypes() &&
+		!GPOS_FTRACE(EopttraceTextRangeStats))
 	{
 		return m_histogram_buckets->Size() == 0 ||
 			   this->ContainsOnlySingletonBuckets();
@@ -1028,6 +1031,13 @@ CHistogram::CopyHistogram() const
 BOOL
 CHistogram::IsOpSupportedForTextFilter(CStatsPred::EStatsCmpType stats_cmp_type)
 {
+	// text datums mapped in their sort order support the same comparisons as
+	// other types
+	if (GPOS_FTRACE(EopttraceTextRangeStats))
+	{
+		return IsOpSupportedForFilter(stats_cmp_type);
+	}
+
 	// is the scalar comparison type one of =, <>
 	switch (stats_cmp_type)
 	{
@@ -14,6 +14,8 @@
 #include "gpos/base.h"
 
 #include "gpopt/base/CCastUtils.h"
+#include "gpopt/base/CColRefSetIter.h"
+#include "gpopt/base/CColRefTable.h"
 #include "gpopt/base/COptCtxt.h"
 #include "gpopt/base/CUtils.h"
 #include "gpopt/exception.h"
@@ -23,7 +25,9 @@
 #include "gpopt/operators/CPredicateUtils.h"
 #include "gpopt/operators/CScalarCmp.h"
 #include "gpopt/operators/CScalarIdent.h"
+#include "gpopt/translate/CTranslatorExprToDXL.h"
 #include "naucrates/base/IDatumBool.h"
+#include "naucrates/dxl/operators/CDXLNode.h"
 #include "naucrates/md/IMDScalarOp.h"
 #include "naucrates/md/IMDType.h"
 #include "naucrates/md/IMDTypeBool.h"
@@ -130,6 +134,143 @@ CStatsPredUtils::CreateStatsPredUnsupported(CMemoryPool *mp,
 		CStatsPredUnsupported(gpos::ulong_max, CStatsPred::EstatscmptOther);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CStatsPredUtils::IsPredSampleable
+//
+//	@doc:
+//		Is the predicate made of scalar operators that can be translated to
+//		DXL on their own, and so be evaluated on a sample of a base table
+//---------------------------------------------------------------------------
+BOOL
+CStatsPredUtils::IsPredSampleable(CExpression *predicate_expr)
+{
+	GPOS_ASSERT(nullptr != predicate_expr);
+
+	switch (predicate_expr->Pop()->Eopid())
+	{
+		case COperator::EopScalarCmp:
+		case COperator::EopScalarIsDistinctFrom:
+		case COperator::EopScalarIdent:
+		case COperator::EopScalarConst:
+		case COperator::EopScalarBoolOp:
+		case COperator::EopScalarFunc:
+		case COperator::EopScalarOp:
+		case COperator::EopScalarNullIf:
+		case COperator::EopScalarNullTest:
+		case COperator::EopScalarBooleanTest:
+		case COperator::EopScalarSwitch:
+		case COperator::EopScalarSwitchCase:
+		case COperator::EopScalarCast:
+		case COperator::EopScalarCoerceViaIO:
+		case COperator::EopScalarCoalesce:
+		case COperator::EopScalarArray:
+		case COperator::EopScalarArrayCmp:
+			break;
+		default:
+			return false;
+	}
+
+	const ULONG arity = predicate_expr->Arity();
+	for (ULONG ul = 0; ul < arity; ul++)
+	{
+		if (!IsPredSampleable((*predicate_expr)[ul]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CStatsPredUtils::SampleStatsPredUnsupported
+//
+//	@doc:
+//		The default selectivity of unsupported predicates is a guess. If the
+//		predicate only refers to the columns of one base table, ask the MD
+//		provider to evaluate it on a sample of the table instead, and return
+//		an unsupported predicate with the observed scale factor. Takes
+//		ownership of 'pred_stats'
+//---------------------------------------------------------------------------
+CStatsPred *
+CStatsPredUtils::SampleStatsPredUnsupported(CMemoryPool *mp,
+											CExpression *predicate_expr,
+											CStatsPred *pred_stats)
+{
+	GPOS_ASSERT(nullptr != predicate_expr);
+
+	if (!GPOS_FTRACE(EopttraceDynamicSampling) || nullptr == pred_stats ||
+		CStatsPred::EsptUnsupported != pred_stats->GetPredStatsType() ||
+		!IsPredSampleable(predicate_expr))
+	{
+		return pred_stats;
+	}
+
+	// all columns must come from the same instance of a base table
+	CColRefSet *col_refset_used = predicate_expr->DeriveUsedColumns();
+	if (0 == col_refset_used->Size())
+	{
+		return pred_stats;
+	}
+
+	IMDId *rel_mdid = nullptr;
+	ULONG source_op_id = gpos::ulong_max;
+	UlongToIntMap *colid_to_attno = GPOS_NEW(mp) UlongToIntMap(mp);
+	CColRefSetIter crsi(*col_refset_used);
+	while (crsi.Advance())
+	{
+		CColRef *colref = crsi.Pcr();
+		if (CColRef::EcrtTable != colref->Ecrt() ||
+			nullptr == colref->GetMdidTable() || colref->IsSystemCol())
+		{
+			colid_to_attno->Release();
+			return pred_stats;
+		}
+
+		CColRefTable *colref_table = CColRefTable::PcrConvert(colref);
+		if (nullptr != rel_mdid &&
+			(!rel_mdid->Equals(colref->GetMdidTable()) ||
+			 source_op_id != colref_table->UlSourceOpId()))
+		{
+			colid_to_attno->Release();
+			return pred_stats;
+		}
+		rel_mdid = colref->GetMdidTable();
+		source_op_id = colref_table->UlSourceOpId();
+
+		colid_to_attno->Insert(GPOS_NEW(mp) ULONG(colref->Id()),
+							   GPOS_NEW(mp) INT(colref_table->AttrNum()));
+	}
+
+	CMDAccessor *md_accessor = COptCtxt::PoctxtFromTLS()->Pmda();
+	CTranslatorExprToDXL expr_to_dxl_translator(mp, md_accessor,
+												nullptr /*pdrgpiSegments*/,
+												false /*fInitColumnFactory*/);
+	CDXLNode *pred_dxl = expr_to_dxl_translator.PdxlnScalar(predicate_expr);
+
+	CDouble selectivity(1.0);
+	BOOL sampled = md_accessor->SampleSelectivity(rel_mdid, pred_dxl,
+												  colid_to_attno, &selectivity);
+	pred_dxl->Release();
+	colid_to_attno->Release();
+
+	if (!sampled || selectivity <= CStatistics::Epsilon || selectivity > 1.0)
+	{
+		return pred_stats;
+	}
+
+	CStatsPredUnsupported *pred_stats_unsupported =
+		CStatsPredUnsupported::ConvertPredStats(pred_stats);
+	CStatsPred *pred_stats_sampled = GPOS_NEW(mp) CStatsPredUnsupported(
+		pred_stats_unsupported->GetColId(),
+		pred_stats_unsupported->GetStatsCmpType(), 1.0 / selectivity);
+	pred_stats->Release();
+
+	return pred_stats_sampled;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CStatsPredUtils::GetStatsPredNullTest
@@ -775,6 +916,8 @@ CStatsPredUtils::AddSupportedStatsFilters(CMemoryPool *mp,
 				break;
 		}
 
+		pred_stats = SampleStatsPredUnsupported(mp, predicate_expr, pred_stats);
+
 		if (nullptr != pred_stats)
 		{
 			pred_stats_array->Append(pred_stats);
@@ -1071,8 +1214,10 @@ CStatsPredUtils::ProcessArrayCmp(CMemoryPool *mp, CExpression *predicate_expr,
 	if (!is_supported_array_cmp)
 	{
 		// unsupported predicate for stats calculations
-		result_pred_stats->Append(GPOS_NEW(mp) CStatsPredUnsupported(
-			gpos::ulong_max, CStatsPred::EstatscmptOther));
+		result_pred_stats->Append(SampleStatsPredUnsupported(
+			mp, predicate_expr,
+			GPOS_NEW(mp) CStatsPredUnsupported(gpos::ulong_max,
+											   CStatsPred::EstatscmptOther)));
 		return;
 	}
 
@@ -1097,8 +1242,9 @@ CStatsPredUtils::ProcessArrayCmp(CMemoryPool *mp, CExpression *predicate_expr,
 	if (!CHistogram::IsOpSupportedForFilter(stats_cmp_type))
 	{
 		// unsupported predicate for stats calculations
-		result_pred_stats->Append(
-			GPOS_NEW(mp) CStatsPredUnsupported(col_ref->Id(), stats_cmp_type));
+		result_pred_stats->Append(SampleStatsPredUnsupported(
+			mp, predicate_expr,
+			GPOS_NEW(mp) CStatsPredUnsupported(col_ref->Id(), stats_cmp_type)));
 		return;
 	}
 
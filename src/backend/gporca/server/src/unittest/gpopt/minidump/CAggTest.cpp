@@ -51,6 +51,7 @@ const CHAR *rgszAggFileNames[] = {
 	"../data/dxl/minidump/SortOverStreamAgg.mdp",
 	"../data/dxl/minidump/NoHashAggWithoutPrelimFunc.mdp",
 	"../data/dxl/minidump/AggWithSubqArgs.mdp",
+	"../data/dxl/minidump/AggWithFilter.mdp",
 	"../data/dxl/minidump/Agg-Limit.mdp",
 	"../data/dxl/minidump/GroupByEmptySetNoAgg.mdp",
 	"../data/dxl/minidump/CollapseGb-With-Agg-Funcs.mdp",
@@ -255,6 +255,7 @@ CopyPlanFields(const Plan *from, Plan *newnode)
 	COPY_NODE_FIELD(flow);
 
 	COPY_SCALAR_FIELD(operatorMemKB);
+	COPY_SCALAR_FIELD(feedback_key);
 }
 
 /*
@@ -1693,6 +1693,7 @@ ReadCommonPlan(Plan *local_node)
 #endif /* COMPILING_BINARY_FUNCS */
 
 	READ_UINT64_FIELD(operatorMemKB);
+	READ_UINT64_FIELD(feedback_key);
 }
 
 /*
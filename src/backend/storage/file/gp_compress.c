@@ -143,6 +143,8 @@ zstd_alloc_context(void)
 	ctx = MemoryContextAlloc(TopMemoryContext, sizeof(zstd_context));
 	ctx->cctx = NULL;
 	ctx->dctx = NULL;
+	ctx->cdict = NULL;
+	ctx->ddict = NULL;
 	ctx->owner = CurrentResourceOwner;
 	dlist_push_head(&open_zstd_handles, &ctx->node);
 
@@ -156,6 +158,10 @@ zstd_free_context(zstd_context *context)
 		ZSTD_freeCCtx(context->cctx);
 	if (context->dctx)
 		ZSTD_freeDCtx(context->dctx);
+	if (context->cdict)
+		ZSTD_freeCDict(context->cdict);
+	if (context->ddict)
+		ZSTD_freeDDict(context->ddict);
 
 	dlist_delete(&context->node);
 
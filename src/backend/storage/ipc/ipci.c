@@ -75,6 +75,7 @@
 #include "utils/workfile_mgr.h"
 #include "utils/session_state.h"
 #include "cdb/cdbendpoint.h"
+#include "cdb/cdbcardfeedback.h"
 #include "replication/gp_replication.h"
 
 /* GUCs */
@@ -236,6 +237,9 @@ CreateSharedMemoryAndSemaphores(void)
 
 		/* size of token and endpoint shared memory */
 		size = add_size(size, EndpointShmemSize());
+
+		/* size of cardinality feedback table */
+		size = add_size(size, CardFeedbackShmemSize());
 #ifndef USE_INTERNAL_FTS
 		/* size of cdb etcd result cache */
 		if (Gp_role != GP_ROLE_EXECUTE)
@@ -420,6 +424,9 @@ CreateSharedMemoryAndSemaphores(void)
 	/* Initialize shared memory for parallel retrieve cursor */
 	if (!IsUnderPostmaster)
 		EndpointShmemInit();
+
+	/* Initialize shared memory for cardinality feedback */
+	CardFeedbackShmemInit();
 #ifndef USE_INTERNAL_FTS
 	/* Initialize shared memory for cdb etcd cache */
 	if (Gp_role != GP_ROLE_EXECUTE)
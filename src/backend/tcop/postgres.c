@@ -95,6 +95,7 @@
 #include "cdb/cdbutil.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbsrlz.h"
+#include "cdb/cdbplancache.h"
 #include "cdb/cdbtm.h"
 #include "cdb/cdbdtxcontextinfo.h"
 #include "cdb/cdbdisp_query.h"
@@ -1098,6 +1099,10 @@ pg_plan_queries(List *querytrees, const char *query_string, int cursorOptions,
  * query_string -- optional query text (C string).
  * serializedPlantree[len] -- PlannedStmt node, or (NULL,0) if query provided.
  * serializedQueryDispatchDesc[len] -- QueryDispatchDesc node, or (NULL,0) if query provided.
+ * planCacheKey, planCacheEpoch -- identify the plan in the plan cache, see
+ *		cdbplancache.c. The plan is looked up if serializedPlantree is not
+ *		provided, and stored otherwise. planCacheKey is 0 if not cached.
+ * planQueryMem -- query_mem of the plan, for a plan looked up.
  *
  * Caller may supply either a Query (representing utility command) or
  * a PlannedStmt (representing a planned DML command), but not both.
@@ -1105,7 +1110,8 @@ pg_plan_queries(List *querytrees, const char *query_string, int cursorOptions,
 static void
 exec_mpp_query(const char *query_string,
 			   const char * serializedPlantree, int serializedPlantreelen,
-			   const char * serializedQueryDispatchDesc, int serializedQueryDispatchDesclen)
+			   const char * serializedQueryDispatchDesc, int serializedQueryDispatchDesclen,
+			   uint64 planCacheKey, uint32 planCacheEpoch, uint64 planQueryMem)
 {
 	CommandDest dest = whereToSendOutput;
 	MemoryContext oldcontext;
@@ -1173,7 +1179,19 @@ exec_mpp_query(const char *query_string,
 		plan = (PlannedStmt *) deserializeNode(serializedPlantree,serializedPlantreelen);
 		if (!plan || !IsA(plan, PlannedStmt))
 			elog(ERROR, "MPPEXEC: receive invalid planned statement");
+
+		if (planCacheKey != 0)
+			QEPlanCacheStore(planCacheKey, planCacheEpoch, plan);
     }
+	else if (planCacheKey != 0)
+	{
+		/* A miss is reported to the QD before we get here */
+		plan = QEPlanCacheLookup(planCacheKey, planCacheEpoch);
+		if (!plan)
+			elog(ERROR, "MPPEXEC: planned statement " UINT64_FORMAT " not found in plan cache",
+				 planCacheKey);
+		plan->query_mem = planQueryMem;
+	}
 
 	/*
      * Deserialize the extra execution information (a QueryDispatchDesc node), if there is one.
@@ -5597,6 +5615,9 @@ PostgresMain(int argc, char *argv[],
 					int serializedPlantreelen = 0;
 					int serializedQueryDispatchDesclen = 0;
 					int resgroupInfoLen = 0;
+					uint64 planCacheKey;
+					uint32 planCacheEpoch;
+					uint64 planQueryMem;
 					TimestampTz statementStart;
 					Oid suid;
 					Oid ouid;
@@ -5632,6 +5653,9 @@ PostgresMain(int argc, char *argv[],
 					serializedPlantreelen = pq_getmsgint(&input_message, 4);
 					serializedQueryDispatchDesclen = pq_getmsgint(&input_message, 4);
 					serializedDtxContextInfolen = pq_getmsgint(&input_message, 4);
+					planCacheKey = (uint64) pq_getmsgint64(&input_message);
+					planCacheEpoch = pq_getmsgint(&input_message, 4);
+					planQueryMem = (uint64) pq_getmsgint64(&input_message);
 
 					/* read in the DTX context info */
 					if (serializedDtxContextInfolen == 0)
@@ -5684,6 +5708,19 @@ PostgresMain(int argc, char *argv[],
 
 					elog((Debug_print_full_dtm ? LOG : DEBUG5), "MPP dispatched stmt from QD: %s.",query_string);
 
+					/*
+					 * If we were sent the key of a plan we don't have cached,
+					 * tell the QD, which then sends us the whole plan. Nothing
+					 * has been set up for the statement yet.
+					 */
+					if (serializedPlantreelen == 0 && planCacheKey != 0 &&
+						!QEPlanCacheHasPlan(planCacheKey, planCacheEpoch))
+					{
+						QEPlanCacheReportMiss(planCacheKey);
+						send_ready_for_query = true;
+						break;
+					}
+
 					if (IsResGroupActivated() && resgroupInfoLen > 0)
 						SwitchResGroupOnSegment(resgroupInfoBuf, resgroupInfoLen);
 
@@ -5704,7 +5741,7 @@ PostgresMain(int argc, char *argv[],
 					if (cuid > 0)
 						SetUserIdAndContext(cuid, false); /* Set current userid */
 
-					if (serializedPlantreelen==0)
+					if (serializedPlantreelen==0 && planCacheKey==0)
 					{
 						if (strncmp(query_string, "BEGIN", 5) == 0)
 						{
@@ -5736,7 +5773,8 @@ PostgresMain(int argc, char *argv[],
 					else
 						exec_mpp_query(query_string,
 									   serializedPlantree, serializedPlantreelen,
-									   serializedQueryDispatchDesc, serializedQueryDispatchDesclen);
+									   serializedQueryDispatchDesc, serializedQueryDispatchDesclen,
+									   planCacheKey, planCacheEpoch, planQueryMem);
 
 					SetUserIdAndSecContext(GetOuterUserId(), 0);
 
@@ -494,6 +494,9 @@ pgstat_get_wait_ipc(WaitEventIPC w)
 		case WAIT_EVENT_LOGINMONITOR_FINISH:
 			event_name = "LoginMonitorFinish";
 			break;
+		case WAIT_EVENT_COPY_FROM_ROUTE:
+			event_name = "CopyFromRoute";
+			break;
 		case WAIT_EVENT_DTX_RECOVERY:
 			event_name = "DtxRecovery";
 			/* no default case, so that compiler will warn */
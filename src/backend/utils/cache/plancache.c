@@ -98,6 +98,9 @@ static dlist_head saved_plan_list = DLIST_STATIC_INIT(saved_plan_list);
  */
 static dlist_head cached_expression_list = DLIST_STATIC_INIT(cached_expression_list);
 
+/* GPDB: the last CachedPlan.dispatchId assigned */
+static uint64 lastPlanDispatchId = 0;
+
 static void ReleaseGenericPlan(CachedPlanSource *plansource);
 static List *RevalidateCachedQuery(CachedPlanSource *plansource,
 								   QueryEnvironment *queryEnv,
@@ -1048,6 +1051,7 @@ BuildCachedPlan(CachedPlanSource *plansource, List *qlist,
 
 	/* assign generation number to new plan */
 	plan->generation = ++(plansource->generation);
+	plan->dispatchId = ++lastPlanDispatchId;
 
 	MemoryContextSwitchTo(oldcxt);
 
@@ -25,6 +25,7 @@
 #include "access/heaptoast.h"
 #include "access/tupmacs.h"
 #include "access/xlog.h"
+#include "catalog/gp_zstd_dictionary.h"
 #include "catalog/pg_attribute_encoding.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbappendonlyblockdirectory.h"
@@ -543,6 +544,9 @@ create_datumstreamwrite(
 			sa.comptype = acc->ao_attr.compressType;
 			sa.complevel = acc->ao_attr.compressLevel;
 			sa.blocksize = acc->maxAoBlockSize;
+			sa.typid = attr->atttypid;
+			sa.relid = attr->attrelid;
+			sa.attnum = attr->attnum;
 
 			compressionState =
 				callCompressionConstructor(
@@ -575,6 +579,8 @@ create_datumstreamwrite(
 	acc->ao_write.compressionState = compressionState;
 	acc->ao_write.verifyWriteCompressionState = verifyBlockCompressionState;
 	acc->title = title;
+	acc->relid = attr->attrelid;
+	acc->attnum = attr->attnum;
 	acc->ao_write.relFileNode = *rnode;
 
 	/*
@@ -683,6 +689,9 @@ create_datumstreamread(
 			sa.comptype = acc->ao_attr.compressType;
 			sa.complevel = acc->ao_attr.compressLevel;
 			sa.blocksize = acc->maxAoBlockSize;
+			sa.typid = attr->atttypid;
+			sa.relid = attr->attrelid;
+			sa.attnum = attr->attnum;
 
 			compressionState =
 				callCompressionConstructor(
@@ -873,6 +882,24 @@ datumstreamread_close_file(DatumStreamRead * ds)
 	ds->need_close_file = false;
 }
 
+/*
+ * Store the dictionary the compressor trained while compressing the block
+ * just written, if any. The compressor compresses the following blocks with
+ * it, which can only be read once it is in gp_zstd_dictionary.
+ */
+static void
+datumstreamwrite_store_dictionary(DatumStreamWrite * acc)
+{
+	CompressionState *cs = acc->ao_write.compressionState;
+
+	if (cs == NULL || cs->dictionary == NULL)
+		return;
+
+	StoreZstdDictionary(acc->relid, acc->attnum, cs->dictionary_id,
+						cs->dictionary, cs->dictionary_len);
+	cs->dictionary = NULL;
+}
+
 static int64
 datumstreamwrite_block_orig(DatumStreamWrite * acc)
 {
@@ -1003,6 +1030,8 @@ datumstreamwrite_block(DatumStreamWrite *acc,
 			/* Never reaches here. */
 	}
 
+	datumstreamwrite_store_dictionary(acc);
+
 	/* Insert an entry to the block directory */
 	AppendOnlyBlockDirectory_InsertEntry(
 		blockDirectory,
@@ -1107,6 +1136,8 @@ datumstreamwrite_lob(DatumStreamWrite * acc,
 								   AOCSBK_BLOB,
 									/* rowCount */ 1);
 
+	datumstreamwrite_store_dictionary(acc);
+
 	/* Insert an entry to the block directory */
 	AppendOnlyBlockDirectory_InsertEntry(
 		blockDirectory,
@@ -1353,10 +1384,14 @@ datumstreamread_block_content(DatumStreamRead * acc)
 }
 
 
+/*
+ * Read the header of the next block, without reading its content.
+ *
+ * The caller must follow up with either datumstreamread_block_content() or
+ * datumstreamread_skip_block(). Returns -1 at the end of the segment file.
+ */
 int
-datumstreamread_block(DatumStreamRead * acc,
-					  AppendOnlyBlockDirectory *blockDirectory,
-					  int colGroupNo)
+datumstreamread_block_header(DatumStreamRead * acc)
 {
 	bool		readOK = false;
 
@@ -1414,6 +1449,27 @@ datumstreamread_block(DatumStreamRead * acc,
 			 acc->blockFileOffset,
 			 acc->blockRowCount);
 
+	return 0;
+}
+
+/*
+ * Skip the content of the block whose header was just read with
+ * datumstreamread_block_header().
+ */
+void
+datumstreamread_skip_block(DatumStreamRead * acc)
+{
+	AppendOnlyStorageRead_SkipCurrentBlock(&acc->ao_read);
+}
+
+int
+datumstreamread_block(DatumStreamRead * acc,
+					  AppendOnlyBlockDirectory *blockDirectory,
+					  int colGroupNo)
+{
+	if (datumstreamread_block_header(acc) < 0)
+		return -1;
+
 	datumstreamread_block_content(acc);
 
 	if (blockDirectory)
@@ -1437,6 +1493,39 @@ datumstreamread_rewind_block(DatumStreamRead * datumStream)
 	datumstreamread_block_get_ready(datumStream);
 }
 
+/*
+ * Decode all the rows of the current block at once.
+ *
+ * values and isnull must have room for blockRead.logical_row_count entries.
+ * Only for fixed-length pass-by-value columns, whose blocks never hold
+ * large objects; the value of a NULL is set to 0. RLE and delta compressed
+ * blocks are expanded. The block is rewound afterwards, so that the caller
+ * can position it with datumstreamread_find(). Returns the number of rows.
+ */
+int
+datumstreamread_block_decode(DatumStreamRead * acc, Datum *values, bool *isnull)
+{
+	DatumStreamBlockRead *dsr = &acc->blockRead;
+	int			n = 0;
+
+	Assert(acc->typeInfo.byval && acc->typeInfo.datumlen > 0);
+	Assert(acc->getBlockInfo.execBlockKind == AOCSBK_BLOCK);
+
+	datumstreamread_rewind_block(acc);
+
+	while (DatumStreamBlockRead_Advance(dsr))
+	{
+		DatumStreamBlockRead_Get(dsr, &values[n], &isnull[n]);
+		if (isnull[n])
+			values[n] = (Datum) 0;
+		n++;
+	}
+
+	datumstreamread_rewind_block(acc);
+
+	return n;
+}
+
 /*
  * Find the specified row in the current block.
  *
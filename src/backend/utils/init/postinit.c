@@ -45,6 +45,7 @@
 #include "libpq/hba.h"
 #include "libpq/libpq-be.h"
 #include "cdb/cdbendpoint.h"
+#include "cdb/cdbplancache.h"
 #include "cdb/cdbtm.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbutil.h"
@@ -764,6 +765,7 @@ InitPostgres(const char *in_dbname, Oid dboid, const char *username,
 	RelationCacheInitialize();
 	InitCatalogCache();
 	InitPlanCache();
+	InitSegmentPlanCache();
 
 	/* Initialize portal manager */
 	EnablePortalManager();
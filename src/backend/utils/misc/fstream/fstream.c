@@ -22,6 +22,7 @@
 #include <postgres.h>
 #include <commands/copy.h>
 #include <fstream/fstream.h>
+#include <fstream/csvscan.h>
 #include <assert.h>
 #include <glob.h>
 #include <stdio.h>
@@ -166,104 +167,30 @@ fstream_get_error(fstream_t*fs)
  * We need this function for gpfdist because until 'text' format we can't just
  * peek at the line newline in the buffer and send the whole data chunk to the
  * server. That is because it may be inside a quote. We have to carefully parse
- * the data from the start in order to find the last unquoted newline.
+ * the data from the start in order to find the last unquoted newline. This is
+ * done a vector at a time where possible, see csvscan.h.
  *
  */
-
-static char*
-scan_csv_records_crlf(char *p, char* q, int one, fstream_t* fs)
-{
-	int 	in_quote = 0;
-	int 	last_was_esc = 0;
-	int 	qc = fs->options.quote;
-	int 	xc = fs->options.escape;
-	char*	last_record_loc = 0;
-	int 	ch = 0;
-	int 	lastch = 0;
-
-	while (p < q)
-	{
-		lastch = ch;
-		ch = *p++;
-
-		if (in_quote)
-		{
-			if (!last_was_esc)
-			{
-				if (ch == qc)
-					in_quote = 0;
-				else if (ch == xc)
-					last_was_esc = 1;
-			}
-			else
-				last_was_esc = 0;
-		}
-		else if (ch == '\n' && lastch == '\r')
-		{
-			last_record_loc = p;
-			fs->line_number++;
-			if (one)
-				break;
-		}
-		else if (ch == qc)
-			in_quote = 1;
-	}
-
-	return last_record_loc;
-}
-
-static char*
-scan_csv_records_cr_or_lf(char *p, char *q, int one, fstream_t *fs, int nc)
-{
-	int 	in_quote = 0;
-	int 	last_was_esc = 0;
-	int 	qc = fs->options.quote;
-	int 	xc = fs->options.escape;
-	char*	last_record_loc = 0;
-
-	while (p < q)
-	{
-		int ch = *p++;
-
-		if (in_quote)
-		{
-			if (!last_was_esc)
-			{
-				if (ch == qc)
-					in_quote = 0;
-				else if (ch == xc)
-					last_was_esc = 1;
-			}
-			else
-				last_was_esc = 0;
-		}
-		else if (ch == nc)
-		{
-			last_record_loc = p;
-			fs->line_number++;
-			if (one)
-				break;
-		}
-		else if (ch == qc)
-			in_quote = 1;
-	}
-
-	return last_record_loc;
-}
-
 static char*
 scan_csv_records(char *p, char *q, int one, fstream_t *fs)
 {
+	csv_scan_state st;
+
 	switch(fs->options.eol_type)
 	{
 		case EOL_CRNL:
-		   return scan_csv_records_crlf(p, q, one, fs);
+		   csv_scan_init(&st, fs->options.quote, fs->options.escape, '\n', 1);
+		   break;
 		case EOL_CR:
-		   return scan_csv_records_cr_or_lf(p, q, one, fs, '\r');
+		   csv_scan_init(&st, fs->options.quote, fs->options.escape, '\r', 0);
+		   break;
 		case EOL_NL:
 		default:
-		   return scan_csv_records_cr_or_lf(p, q, one, fs, '\n');
+		   csv_scan_init(&st, fs->options.quote, fs->options.escape, '\n', 0);
+		   break;
 	}
+
+	return csv_scan_records(&st, p, q, one, &fs->line_number);
 }
 
 #ifdef GPFXDIST
@@ -42,6 +42,7 @@
 #include "optimizer/planmain.h"
 #include "pgstat.h"
 #include "parser/scansup.h"
+#include "postmaster/bgworker_internals.h"
 #include "postmaster/syslogger.h"
 #include "postmaster/fts.h"
 #include "postmaster/postmaster.h"
@@ -137,11 +138,13 @@ bool		Test_print_direct_dispatch_info = false;
 bool        Test_print_prefetch_joinqual = false;
 bool		Test_copy_qd_qe_split = false;
 bool		gp_permit_relation_node_change = false;
-int			gp_max_local_distributed_cache = 1024;
+int			gp_max_local_distributed_cache = 8192;
 bool		gp_appendonly_verify_block_checksums = true;
 bool		gp_appendonly_verify_write_block = false;
 bool		gp_appendonly_compaction = true;
 int			gp_appendonly_compaction_threshold = 0;
+bool		gp_appendonly_zonemap = false;
+bool		gp_appendonly_zstd_dictionary = false;
 bool		enable_parallel = false;
 int			gp_appendonly_insert_files = 0;
 int			gp_appendonly_insert_files_tuples_range = 0;
@@ -354,6 +357,11 @@ double		optimizer_damping_factor_join;
 double		optimizer_damping_factor_groupby;
 bool		optimizer_dpe_stats;
 bool		optimizer_enable_derive_stats_all_groups;
+bool		optimizer_enable_text_range_stats;
+bool		optimizer_enable_dynamic_sampling;
+bool		optimizer_enable_cardinality_feedback;
+bool		optimizer_enable_trivial_fast_path;
+int			optimizer_dynamic_sampling_budget;
 
 /* Costing related GUCs used by the Optimizer */
 int			optimizer_segments;
@@ -510,6 +518,18 @@ static const struct config_enum_entry gp_interconnect_fc_methods[] = {
 	{NULL, 0}
 };
 
+static const struct config_enum_entry gp_interconnect_compressions[] = {
+	{"none", INTERCONNECT_COMPRESSION_NONE},
+	{"pglz", INTERCONNECT_COMPRESSION_PGLZ},
+#ifdef USE_LZ4
+	{"lz4", INTERCONNECT_COMPRESSION_LZ4},
+#endif
+#ifdef USE_ZSTD
+	{"zstd", INTERCONNECT_COMPRESSION_ZSTD},
+#endif
+	{NULL, 0}
+};
+
 static const struct config_enum_entry gp_interconnect_types[] = {
 	{"udpifc", INTERCONNECT_TYPE_UDPIFC},
 	{"tcp", INTERCONNECT_TYPE_TCP},
@@ -711,6 +731,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_hashagg_streambottom", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Stream the groups of the partial stage of a multi-stage hash aggregate, rather than spill them."),
+			NULL,
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_hashagg_streambottom,
+		true,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_enable_agg_distinct", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable 2-phase aggregation to compute a single distinct-qualified aggregate."),
@@ -914,6 +945,30 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_zonemap", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Maintain and use per-block min/max summaries for append-optimized tables."),
+			gettext_noop("When enabled, new append-optimized tables get a block directory, inserts "
+						 "record the min/max value and null count of fixed-width columns for every "
+						 "block, and sequential scans skip blocks that cannot satisfy the quals.")
+		},
+		&gp_appendonly_zonemap,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_appendonly_zstd_dictionary", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Compress zstd columns of append-optimized column tables with trained dictionaries."),
+			gettext_noop("When enabled, inserts into a zstd compressed column that has no dictionary yet "
+						 "train one from the first blocks written, and later blocks of the column are "
+						 "compressed with the latest dictionary of the column.")
+		},
+		&gp_appendonly_zstd_dictionary,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_heap_require_relhasoids_match", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Issue an error on discovery of a mismatch between relhasoids and a tuple header."),
@@ -2321,6 +2376,63 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	/*
+	 * The 64-bit value a string is mapped to for statistics holds 48 bits of
+	 * its sort key prefix and only 14 bits of its hash, instead of a full
+	 * hash. Distinct values are then told apart by the prefix, or, when they
+	 * share it, with a 1 in 16384 chance of colliding, so equality estimates
+	 * on columns of values with long common prefixes, like URLs or codes,
+	 * can get worse in exchange for usable range estimates.
+	 */
+	{
+		{"optimizer_enable_text_range_stats", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable histograms on string and uuid columns for range predicates in the optimizer."),
+			gettext_noop("String values are mapped to a prefix of their sort key for statistics, "
+						 "instead of a hash that only supports equality. Values sharing the "
+						 "first six bytes of their sort key are then only partly told apart, "
+						 "which can worsen equality estimates."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_enable_text_range_stats,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_enable_dynamic_sampling", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Estimate predicates unsupported by the optimizer's statistics on a sample of the table."),
+			gettext_noop("The observed selectivities are cached for the session, until the table is analyzed."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_enable_dynamic_sampling,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_enable_cardinality_feedback", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Correct the optimizer's cardinality estimates with the actual rows of executed plans."),
+			gettext_noop("The actual rows of plans run with EXPLAIN ANALYZE are remembered until "
+						 "the tables they scan are analyzed."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_enable_cardinality_feedback,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_enable_trivial_fast_path", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable the optimizer's reduced search for trivial queries."),
+			gettext_noop("Single-table queries without joins, subqueries, aggregates or CTEs "
+						 "only consider access paths and DML, skipping the other exploration rules."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_enable_trivial_fast_path,
+		true,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_force_multistage_agg", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Force optimizer to always pick multistage aggregates when such a plan alternative is generated."),
@@ -3019,7 +3131,7 @@ struct config_int ConfigureNamesInt_gp[] =
 			NULL
 		},
 		&gp_max_local_distributed_cache,
-		1024, 0, INT_MAX,
+		8192, 0, INT_MAX,
 		NULL, NULL, NULL
 	},
 
@@ -3148,6 +3260,28 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_segment_plan_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the maximum number of dispatched plans each segment process keeps for reuse."),
+			gettext_noop("The plans of prepared statements dispatched repeatedly are sent once "
+						 "and then referred to by a key. 0 disables it.")
+		},
+		&gp_segment_plan_cache_size,
+		64, 0, 1024,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_copy_from_parallel_workers", PGC_USERSET, RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Sets the number of parallel workers the coordinator uses to route the rows of COPY FROM."),
+			gettext_noop("The workers parse the distribution key of each row and compute its target segment. "
+						 "0 routes all rows in the coordinator backend itself.")
+		},
+		&gp_copy_from_parallel_workers,
+		0, 0, MAX_PARALLEL_WORKER_LIMIT,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_appendonly_compaction_threshold", PGC_USERSET, APPENDONLY_TABLES,
 			gettext_noop("Threshold of the ratio of dirty data in a segment file over which the file"
@@ -4089,6 +4223,17 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_dynamic_sampling_budget", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the maximum number of predicates sampled while optimizing a query."),
+			gettext_noop("Selectivities cached by earlier queries don't count against it."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_dynamic_sampling_budget,
+		8, 0, 1000,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_mdcache_size", PGC_USERSET, RESOURCES_MEM,
 			gettext_noop("Sets the size of MDCache."),
@@ -4259,6 +4404,17 @@ struct config_real ConfigureNamesReal_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_compression_ratio", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the compression ratio a motion must achieve to keep compressing its tuples."),
+			gettext_noop("Compressed tuples must shrink to at most this fraction of their size, "
+						 "otherwise the motion sends them uncompressed for a while.")
+		},
+		&Gp_interconnect_compression_ratio,
+		0.8, 0.0, 1.0,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_motion_cost_per_row", PGC_USERSET, QUERY_TUNING_COST,
 			gettext_noop("Sets the planner's estimate of the cost of "
@@ -4777,6 +4933,23 @@ struct config_enum ConfigureNamesEnum_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_compression", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the compression method for the tuples sent through motions."),
+			gettext_noop("Valid values are \"none\", \"pglz\""
+#ifdef USE_LZ4
+						 ", \"lz4\""
+#endif
+#ifdef USE_ZSTD
+						 ", \"zstd\""
+#endif
+						 ".")
+		},
+		&Gp_interconnect_compression,
+		INTERCONNECT_COMPRESSION_NONE, gp_interconnect_compressions,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_type", PGC_BACKEND, GP_ARRAY_TUNING,
 			gettext_noop("Sets the protocol used for inter-node communication."),
@@ -18,10 +18,17 @@
 #include "access/gist.h"
 #include "access/nbtree.h"
 #include "catalog/pg_am.h"
+#include "catalog/pg_collation.h"
+#include "catalog/pg_type.h"
 #include "fmgr.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/pg_locale.h"
 #include "utils/rel.h"
 #include "utils/sortsupport.h"
+#include "utils/typcache.h"
 
 
 /* Info needed to use an old-style comparison function as a sort comparator */
@@ -33,6 +40,17 @@ typedef struct
 
 #define SizeForSortShimExtra(nargs) (offsetof(SortShimExtra, fcinfo) + SizeForFunctionCallInfo(nargs))
 
+/* Per-type state of SortSupportKeyPrefix(), kept for the whole session */
+typedef struct KeyPrefixEntry
+{
+	Oid			typid;			/* hash key */
+	bool		use_strxfrm;	/* take the prefix from strxfrm() */
+	SortSupportData ssup;		/* abbreviates the keys, if it can */
+} KeyPrefixEntry;
+
+static HTAB *KeyPrefixCache = NULL;
+static MemoryContext KeyPrefixContext = NULL;
+
 /*
  * Shim function for calling an old-style comparator
  *
@@ -209,3 +227,117 @@ PrepareSortSupportFromGistIndexRel(Relation indexRel, SortSupport ssup)
 			 GIST_SORTSUPPORT_PROC, opcintype, opcintype, opfamily);
 	OidFunctionCall1(sortSupportFunction, PointerGetDatum(ssup));
 }
+
+/*
+ * SortSupportKeyPrefix
+ *
+ * Map a datum to the leading bytes of its sort key under the type's default
+ * btree ordering and the database's default collation, as an unsigned
+ * integer.  Datums that compare differently in the prefix map to integers
+ * that compare the same way.  This is meant for statistics on types that
+ * cannot otherwise be mapped to numbers in an order-preserving way, like the
+ * string types.
+ *
+ * The prefix is the abbreviated key of the type's sort support.  The string
+ * types don't abbreviate under libc collations other than C, as strxfrm() is
+ * not trusted to agree with strcoll() (see varstr_sortsupport()); for them
+ * the prefix is taken from strxfrm() anyway, as an occasional disagreement
+ * only makes for worse estimates.
+ *
+ * Returns false if the type has no such mapping.
+ */
+bool
+SortSupportKeyPrefix(Oid typid, Datum datum, uint64 *prefix)
+{
+	KeyPrefixEntry *entry;
+	bool		found;
+
+	if (KeyPrefixCache == NULL)
+	{
+		HASHCTL		ctl;
+
+		KeyPrefixContext = AllocSetContextCreate(TopMemoryContext,
+												 "Sort key prefix cache",
+												 ALLOCSET_SMALL_SIZES);
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(KeyPrefixEntry);
+		ctl.hcxt = KeyPrefixContext;
+		KeyPrefixCache = hash_create("Sort key prefix cache", 16, &ctl,
+									 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
+
+	entry = (KeyPrefixEntry *) hash_search(KeyPrefixCache, &typid,
+										   HASH_FIND, NULL);
+	if (entry == NULL)
+	{
+		TypeCacheEntry *typentry;
+		SortSupportData ssup;
+		bool		use_strxfrm = false;
+
+		/* set up the sort support before entering it, in case it fails */
+		memset(&ssup, 0, sizeof(ssup));
+		typentry = lookup_type_cache(typid, TYPECACHE_LT_OPR);
+		if (OidIsValid(typentry->lt_opr))
+		{
+			ssup.ssup_cxt = KeyPrefixContext;
+			ssup.ssup_collation = type_is_collatable(typid) ?
+				DEFAULT_COLLATION_OID : InvalidOid;
+			ssup.abbreviate = true;
+			PrepareSortSupportFromOrderingOp(typentry->lt_opr, &ssup);
+
+			use_strxfrm = (ssup.abbrev_converter == NULL &&
+						   (typid == TEXTOID || typid == VARCHAROID ||
+							typid == BPCHAROID) &&
+						   !lc_collate_is_c(DEFAULT_COLLATION_OID));
+		}
+
+		entry = (KeyPrefixEntry *) hash_search(KeyPrefixCache, &typid,
+											   HASH_ENTER, &found);
+		Assert(!found);
+		entry->use_strxfrm = use_strxfrm;
+		entry->ssup = ssup;
+	}
+
+	if (entry->ssup.abbrev_converter != NULL)
+	{
+		/* abbreviated keys compare as unsigned integers */
+		*prefix = (uint64) entry->ssup.abbrev_converter(datum, &entry->ssup);
+		return true;
+	}
+
+	if (entry->use_strxfrm)
+	{
+		text	   *t = DatumGetTextPP(datum);
+		char	   *str = VARDATA_ANY(t);
+		int			len = VARSIZE_ANY_EXHDR(t);
+		char	   *cstr;
+		char	   *xfrm;
+		size_t		xfrmlen;
+		int			i;
+
+		/* trailing blanks are insignificant in bpchar */
+		if (typid == BPCHAROID)
+			len = bpchartruelen(str, len);
+
+		cstr = pnstrdup(str, len);
+		xfrmlen = strxfrm(NULL, cstr, 0);
+		xfrm = palloc(xfrmlen + 1);
+		strxfrm(xfrm, cstr, xfrmlen + 1);
+
+		*prefix = 0;
+		for (i = 0; i < sizeof(uint64); i++)
+		{
+			*prefix <<= 8;
+			if (i < xfrmlen)
+				*prefix |= (unsigned char) xfrm[i];
+		}
+
+		pfree(xfrm);
+		pfree(cstr);
+		if ((Pointer) t != DatumGetPointer(datum))
+			pfree(t);
+		return true;
+	}
+
+	return false;
+}
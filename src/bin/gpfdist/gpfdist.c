@@ -183,7 +183,8 @@ static struct
 	struct transform* trlist; /* transforms from config file */
 	const char* ssl; /* path to certificates in case we use gpfdist with ssl */
 	int			w; /* The time used for session timeout in seconds */
-} opt = { 8080, 8080, 0, 0, 0, ".", 0, 0, -1, 5, 0, 32768, 0, 256, 0, 0, 0, 0 };
+	int			threads; /* # worker threads serving GET requests, 0 to serve all from the main loop */
+} opt = { 8080, 8080, 0, 0, 0, ".", 0, 0, -1, 5, 0, 32768, 0, 256, 0, 0, 0, 0, 0 };
 
 
 typedef union address
@@ -195,6 +196,69 @@ typedef union address
 }
 address_t;
 
+#ifndef WIN32
+/*
+ * A worker thread, running an event loop of its own. All the GET requests
+ * of a session are served by the worker the session is assigned to.
+ */
+typedef struct worker_t worker_t;
+struct worker_t
+{
+	int					id;
+	pthread_t			thread;
+	struct event_base*	base;
+	int					notify_fd[2];	/* pipe to hand requests over to the worker */
+	struct event		notify_ev;
+};
+
+/* A message sent to a worker through its notify pipe */
+typedef struct worker_msg_t worker_msg_t;
+struct worker_msg_t
+{
+	struct request_t*	r;
+	int					resume;	/* resume a request waiting for a block, rather than start serving it */
+};
+
+/* # blocks a session reader reads ahead of the requests */
+#define READER_NBLOCKS 4
+
+typedef struct reader_block_t reader_block_t;
+struct reader_block_t
+{
+	char*		data;
+	int			size;
+	struct fstream_filename_and_offset fos;
+};
+
+/*
+ * The reader thread of a GET session. It reads (and decompresses) the data
+ * of the session ahead of the requests, into a ring of blocks handed out in
+ * the order they were read, so the rows keep the order they would have with
+ * a single reader. Once started, the reader owns the fstream, until the
+ * session stops it and takes the fstream back to close it.
+ */
+typedef struct session_reader_t session_reader_t;
+struct session_reader_t
+{
+	pthread_t			thread;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+	fstream_t*			fstream;
+	char*				line_delim_str;
+	int					line_delim_length;
+	worker_t*			worker;		/* the worker serving the session */
+	reader_block_t		blocks[READER_NBLOCKS];
+	int					head;		/* next block to hand out */
+	int					count;		/* # blocks read ahead */
+	apr_int64_t			read_bytes;	/* compressed bytes read, not yet counted in gcb */
+	int					eof;
+	int					error;
+	char				ferror[FILE_ERROR_SZ];
+	int					stop;		/* set when the session ends */
+	struct request_t*	waiting;	/* requests waiting for a block */
+};
+#endif
+
 /*  Global control block */
 
 static struct
@@ -217,8 +281,28 @@ static struct
 	SSL_CTX 		*server_ctx;/* for SSL */
 #endif
 	int 			wdtimer; /* Kill gpfdist after k seconds of inactivity. 0 to disable. */
+#ifndef WIN32
+	pthread_mutex_t	lock;		/* protects all but the socket I/O of the worker threads */
+	worker_t*		workers;	/* opt.threads workers */
+	int				next_worker;
+#endif
 } gcb;
 
+/*
+ * With worker threads, the state of gpfdist is protected by one recursive
+ * lock, held by the event callbacks. Only the data sent to the clients and
+ * the reading of the files happen concurrently.
+ */
+#ifndef WIN32
+#define GCB_LOCK() \
+	do { if (opt.threads) pthread_mutex_lock(&gcb.lock); } while (0)
+#define GCB_UNLOCK() \
+	do { if (opt.threads) pthread_mutex_unlock(&gcb.lock); } while (0)
+#else
+#define GCB_LOCK() ((void) 0)
+#define GCB_UNLOCK() ((void) 0)
+#endif
+
 /*  A session */
 typedef struct session_t session_t;
 struct session_t
@@ -242,6 +326,10 @@ struct session_t
 	struct timeval 	tm;             /* timeout for struct event */
 	struct event   	ev;             /* event we are watching for this session*/
 	apr_hash_t		*requests;
+#ifndef WIN32
+	worker_t*		worker;			/* worker serving the GET requests, if threaded */
+	session_reader_t* reader;		/* reader thread, until the session ends */
+#endif
 };
 
 typedef struct session_free_res session_free_res;
@@ -308,6 +396,11 @@ struct request_t
 	char*           line_delim_str;
 	int             line_delim_length;
 
+#ifndef WIN32
+	worker_t*		worker;			/* worker serving the request, NULL for the main loop */
+	request_t*		next_waiting;	/* next request waiting for the session reader */
+#endif
+
 #ifdef USE_SSL
 	/* SSL related */
 	BIO			*io;		/* for the i.o. */
@@ -404,8 +497,21 @@ int gpfdist_run(void);
 static void delay_watchdog_timer(void);
 #ifndef WIN32
 static apr_time_t shutdown_time;
+/* shutdown_time is moved by the event loops and the session readers */
+static pthread_mutex_t shutdown_time_lock = PTHREAD_MUTEX_INITIALIZER;
 static void* watchdog_thread(void*);
+
+/* returned by session_get_block when the session reader has no block yet */
+static const char session_block_pending[] = "block pending";
+
+static void workers_start(void);
+static void worker_send(worker_t* w, request_t* r, int resume);
+static void worker_resume_requests(worker_t* w, request_t* r);
+static void session_start_reader(session_t* session, const request_t* r);
+static void session_stop_reader(session_t* session);
+static const char* session_get_prefetched_block(request_t* r, block_t* retblock);
 #endif
+static void request_event_base_set(request_t* r);
 
 /*
  * block_fill_header
@@ -522,7 +628,7 @@ static void usage_error(const char* msg, int print_usage)
 		{
 			fprintf(stderr,
 					"gpfdist -- file distribution web server\n\n"
-						"usage: gpfdist [--ssl <certificates_directory>] [-d <directory>] [-p <http(s)_port>] [-l <log_file>] [-t <timeout>] [-v | -V | -s] [-m <maxlen>] [-w <timeout>]"
+						"usage: gpfdist [--ssl <certificates_directory>] [-d <directory>] [-p <http(s)_port>] [-l <log_file>] [-t <timeout>] [-v | -V | -s] [-m <maxlen>] [-w <timeout>] [--threads <n>]"
 #ifdef GPFXDIST
 					    "[-c file]"
 #endif
@@ -548,7 +654,8 @@ static void usage_error(const char* msg, int print_usage)
 					    "        -c file    : configuration file for transformations\n"
 #endif
 						"        --version  : print version information\n"
-						"        -w timeout : timeout in seconds before close target file\n\n");
+						"        -w timeout : timeout in seconds before close target file\n"
+						"        --threads n: serve reads from n worker threads, default is 0 (none)\n\n");
 		}
 	}
 
@@ -611,6 +718,7 @@ static void parse_command_line(int argc, const char* const argv[],
 #endif
 	{ "version", 256, 0, "print version number" },
 	{ NULL, 'w', 1, "wait for session timeout in seconds" },
+	{ "threads", 258, 1, "number of worker threads serving the reads" },
 	{ 0 } };
 
 	status = apr_getopt_init(&os, pool, argc, argv);
@@ -695,6 +803,15 @@ static void parse_command_line(int argc, const char* const argv[],
 		case 'w':
 			opt.w = atoi(arg);
 			break;
+#ifndef WIN32
+		case 258:
+			opt.threads = atoi(arg);
+			break;
+#else
+		case 258:
+			usage_error("Error: --threads is not supported on this platform", 0);
+			break;
+#endif
 		}
 	}
 
@@ -723,6 +840,9 @@ static void parse_command_line(int argc, const char* const argv[],
     if (!is_valid_listen_queue_size(opt.z))
 		usage_error("Error: -z listen queue size must be between 16 and 512 (default is 256)", 0);
 
+	if (!is_valid_thread_count(opt.threads))
+		usage_error("Error: --threads must be between 1 and 256, or 0 for no worker threads", 0);
+
     /* get current directory, for ssl directory validation */
     if (0 != apr_filepath_get(&current_directory, APR_FILEPATH_NATIVE, pool))
 		usage_error(apr_psprintf(pool, "Error: cannot access directory '.'\n"
@@ -1202,6 +1322,8 @@ static int local_send(request_t *r, const char* buf, int buflen)
 		int e = errno;
 		int ok = (e == EINTR || e == EAGAIN);
 #endif
+		/* the worker threads send without holding the lock */
+		GCB_LOCK();
 		if ( e == EPIPE || e == ECONNRESET )
 		{
 			gwarning(r, "gpfdist_send failed - the connection was terminated by the client (%d: %s)", e, strerror(e));
@@ -1222,12 +1344,37 @@ static int local_send(request_t *r, const char* buf, int buflen)
 				gdebug(r, "gpfdist_send failed - due to (%d: %s), should try again", e, strerror(e));
 			}
 		}
+		GCB_UNLOCK();
+#ifndef WIN32
+		errno = e;
+#endif
 		return ok ? 0 : -1;
 	}
 
 	return n;
 }
 
+/*
+ * local_send_unlocked
+ *
+ * local_send, releasing the lock of the global control block meanwhile, so
+ * that the worker threads send their blocks in parallel. Only the request
+ * itself may be used while the lock is released.
+ */
+static int local_send_unlocked(request_t *r, const char* buf, int buflen)
+{
+	int n;
+	int e;
+
+	GCB_UNLOCK();
+	n = local_send(r, buf, buflen);
+	e = errno;
+	GCB_LOCK();
+	errno = e;
+
+	return n;
+}
+
 static int local_sendall(request_t* r, const char* buf, int buflen)
 {
 	int oldlen = buflen;
@@ -1331,9 +1478,12 @@ static void gp1_send_errfile(request_t* r, apr_file_t* errfile)
  *
  * Get a block out of the session. return error string. This includes a block
  * header (metadata for client such as filename, etc) and the data itself.
+ *
+ * With a session reader, session_block_pending is returned if no block has
+ * been read ahead yet. The request is then resumed by the reader.
  */
 static const char*
-session_get_block(const request_t* r, block_t* retblock, char* line_delim_str, int line_delim_length)
+session_get_block(request_t* r, block_t* retblock, char* line_delim_str, int line_delim_length)
 {
 	int 		size;
 	const int 	whole_rows = 1; /* gpfdist must not read data with partial rows */
@@ -1350,6 +1500,11 @@ session_get_block(const request_t* r, block_t* retblock, char* line_delim_str, i
 		return 0;
 	}
 
+#ifndef WIN32
+	if (session->reader)
+		return session_get_prefetched_block(r, retblock);
+#endif
+
 	gcb.read_bytes -= fstream_get_compressed_position(session->fstream);
 
 	/* read data from our filestream as a chunk with whole data rows */
@@ -1391,6 +1546,14 @@ static void session_end(session_t* session, int error)
 	if (error)
 		session->is_error = error;
 
+#ifndef WIN32
+	if (session->reader)
+	{
+		gprintln(NULL, "stop session reader");
+		session_stop_reader(session);
+	}
+#endif
+
 	if (session->fstream)
 	{
 		gprintln(NULL, "close fstream");
@@ -1418,6 +1581,11 @@ static void session_free(session_t* session, session_free_res* res)
 {
 	gprintln(NULL, "free session %s", session->key);
 
+#ifndef WIN32
+	if (session->reader)
+		session_stop_reader(session);
+#endif
+
 	if (session->fstream)
 	{
 #ifdef GPFXDIST
@@ -1722,6 +1890,12 @@ static int session_attach(request_t* r)
 		if (session->tid == 0 || session->path == 0 || session->key == 0)
 			gfatal(r, "out of memory in session_attach");
 
+#ifndef WIN32
+		/* read the data ahead in a thread of its own */
+		if (opt.threads && session->is_get)
+			session_start_reader(session, r);
+#endif
+
 		/* insert into hashtable */
 		apr_hash_set(gcb.session.tab, session->key, APR_HASH_KEY_STRING, session);
 
@@ -1815,17 +1989,16 @@ static int session_active_segs_isempty(session_t* session)
 	return 1; /* empty */
 }
 
-/*
- * do_write
- *
- * Callback when the socket is ready to be written
- */
 void gfile_printf_then_putc_newline(const char *format, ...)
 pg_attribute_printf(1, 2);
 
-static void do_write(int fd, short event, void* arg)
+/*
+ * write_blocks
+ *
+ * Send up to 3 blocks of the session to the socket of a GET request.
+ */
+static void write_blocks(int fd, request_t* r)
 {
-	request_t* 	r = (request_t*) arg;
 	int 		n, i;
 	block_t* 	datablock;
 
@@ -1841,6 +2014,11 @@ static void do_write(int fd, short event, void* arg)
 		{
 			const char* ferror = session_get_block(r, &r->outblock, r->line_delim_str, r->line_delim_length);
 
+#ifndef WIN32
+			/* the session reader resumes us once it has read a block */
+			if (ferror == session_block_pending)
+				return;
+#endif
 			if (ferror)
 			{
 				request_end(r, 1, ferror, 0);
@@ -1865,7 +2043,7 @@ static void do_write(int fd, short event, void* arg)
 
 			if (n > 0)
 			{
-				n = local_send(r, datablock->hdr.hbyte + datablock->hdr.hbot, n);
+				n = local_send_unlocked(r, datablock->hdr.hbyte + datablock->hdr.hbot, n);
 				if (n < 0)
 				{
 					/*
@@ -1892,7 +2070,7 @@ static void do_write(int fd, short event, void* arg)
 		 * write out the block data
 		 */
 		n = datablock->top - datablock->bot;
-		n = local_send(r, datablock->data + datablock->bot, n);
+		n = local_send_unlocked(r, datablock->data + datablock->bot, n);
 		if (n < 0)
 		{
 			/*
@@ -1929,6 +2107,18 @@ static void do_write(int fd, short event, void* arg)
 		request_end(r, 1, 0, 0);
 }
 
+/*
+ * do_write
+ *
+ * Callback when the socket is ready to be written
+ */
+static void do_write(int fd, short event, void* arg)
+{
+	GCB_LOCK();
+	write_blocks(fd, (request_t*) arg);
+	GCB_UNLOCK();
+}
+
 /*
  * Log request header
  */
@@ -1956,14 +2146,12 @@ static void log_request_header(const request_t *r)
 }
 
 /*
- * do_read_request
+ * read_request
  *
- * Callback when a socket is ready to be read. Read the
- * socket for a complete HTTP request.
+ * Read the socket for a complete HTTP request, and start serving it.
  */
-static void do_read_request(int fd, short event, void* arg)
+static void read_request(request_t* r, short event)
 {
-	request_t* 	r = (request_t*) arg;
 	char*		p = NULL;
 	char*		pp = NULL;
 	char*		path = NULL;
@@ -2128,6 +2316,15 @@ static void do_read_request(int fd, short event, void* arg)
 
 	if (r->is_get)
 	{
+#ifndef WIN32
+		/* hand the request over to the worker serving the session */
+		if (r->session->worker)
+		{
+			event_del(&r->ev);
+			worker_send(r->session->worker, r, 0);
+			return;
+		}
+#endif
 		/* handle GET */
 		handle_get_request(r);
 	}
@@ -2138,9 +2335,22 @@ static void do_read_request(int fd, short event, void* arg)
 	}
 }
 
+/*
+ * do_read_request
+ *
+ * Callback when a socket is ready to be read. Read the
+ * socket for a complete HTTP request.
+ */
+static void do_read_request(int fd, short event, void* arg)
+{
+	GCB_LOCK();
+	read_request((request_t*) arg, event);
+	GCB_UNLOCK();
+}
 
-/* Callback when the listen socket is ready to accept connections. */
-static void do_accept(int fd, short event, void* arg)
+
+/* Accept a connection on a listen socket, and set up reading its request. */
+static void accept_request(int fd)
 {
 	address_t           a;
 	socklen_t 			len = sizeof(a);
@@ -2292,6 +2502,14 @@ failure:
 	return;
 }
 
+/* Callback when the listen socket is ready to accept connections. */
+static void do_accept(int fd, short event, void* arg)
+{
+	GCB_LOCK();
+	accept_request(fd);
+	GCB_UNLOCK();
+}
+
 /*
  * setup_write
  *
@@ -2304,6 +2522,7 @@ static int setup_write(request_t* r)
 		gwarning(r, "internal error in setup_write - no socket to use");
 	event_del(&r->ev);
 	event_set(&r->ev, r->sock, EV_WRITE, do_write, r);
+	request_event_base_set(r);
 	return (event_add(&r->ev, 0));
 }
 
@@ -2328,6 +2547,7 @@ static int setup_read(request_t* r)
 
 	event_del(&r->ev);
 	event_set(&r->ev, r->sock, EV_READ, do_read_request, r);
+	request_event_base_set(r);
 
 	if(opt.t == 0)
 	{
@@ -2697,6 +2917,7 @@ http_setup(void)
 void
 process_term_signal(int sig,short event,void* arg)
 {
+		GCB_LOCK();
 		gwarning(NULL, "signal %d received. gpfdist exits", sig);
 		log_gpfdist_status();
 		fflush(stdout);
@@ -2951,10 +3172,17 @@ void gfile_printf_then_putc_newline(const char *format, ...)
 {
 	va_list va;
 
+#ifndef WIN32
+	/* may be called from the session readers */
+	flockfile(stdout);
+#endif
 	va_start(va,format);
 	vprintf(format, va);
 	va_end(va);
 	putchar('\n');
+#ifndef WIN32
+	funlockfile(stdout);
+#endif
 }
 
 void *gfile_malloc(size_t size)
@@ -3749,6 +3977,11 @@ int gpfdist_init(int argc, const char* const argv[])
 #endif
 	}
 
+#ifndef WIN32
+	if (opt.threads)
+		workers_start();
+#endif
+
 	/*
 	 * must identify errors in calls above and return non-zero for them
 	 * behaviour required for the Windows service case
@@ -4333,6 +4566,7 @@ static void flush_ssl_buffer(int fd, short event, void* arg)
 {
 	request_t* r = (request_t*)arg;
 
+	GCB_LOCK();
 	(void)BIO_flush(r->io);
 
 	if ( event & EV_TIMEOUT )
@@ -4349,6 +4583,7 @@ static void flush_ssl_buffer(int fd, short event, void* arg)
 		// Do ssl cleanup immediately.
 		request_cleanup_and_free_SSL_resources(r);
 	}
+	GCB_UNLOCK();
 }
 
 
@@ -4361,6 +4596,7 @@ static void setup_flush_ssl_buffer(request_t* r)
 {
 	event_del(&r->ev);
 	event_set(&r->ev, r->sock, EV_WRITE, flush_ssl_buffer, r);
+	request_event_base_set(r);
 	r->tm.tv_sec  = 5;
 	r->tm.tv_usec = 0;
 	(void)event_add(&r->ev, &r->tm);
@@ -4397,6 +4633,7 @@ static void do_close(int fd, short event, void *arg)
 	request_t *r		= (request_t *) arg;
 	char buffer[256]	= {0};
 
+	GCB_LOCK();
 	if (event & EV_TIMEOUT)
 	{
 		gwarning(r, "gpfdist shutdown the connection, while have not received response from segment");
@@ -4417,6 +4654,7 @@ static void do_close(int fd, short event, void *arg)
 		if (should_retry)
 		{
 			setup_do_close(r);
+			GCB_UNLOCK();
 			return;
 		}
 	}
@@ -4446,6 +4684,7 @@ static void do_close(int fd, short event, void *arg)
 	apr_pool_destroy(r->pool);
 
 	fflush(stdout);
+	GCB_UNLOCK();
 }
 
 /*
@@ -4463,6 +4702,7 @@ static void setup_do_close(request_t* r)
 {
 	event_del(&r->ev);
 	event_set(&r->ev, r->sock, EV_READ, do_close, r);
+	request_event_base_set(r);
 
 	r->tm.tv_sec = 60;
 	r->tm.tv_usec = 0;
@@ -4473,6 +4713,20 @@ static void setup_do_close(request_t* r)
 }
 
 
+/*
+ * request_event_base_set
+ *
+ * Bind the event of a request to the event loop of the worker serving the
+ * request, if any. Must follow every event_set() of r->ev.
+ */
+static void request_event_base_set(request_t* r)
+{
+#ifndef WIN32
+	if (r->worker)
+		event_base_set(r->worker->base, &r->ev);
+#endif
+}
+
 #ifdef USE_SSL
 /*
  * request_cleanup_and_free_SSL_resources
@@ -4499,6 +4753,8 @@ static void free_session_cb(int fd, short event, void* arg)
 {
 	session_t* session = (session_t *)arg;
 	session_free_res* res = malloc(sizeof(session_free_res));
+
+	GCB_LOCK();
 	/*
 	 * free the session if there's no POST request from other
 	 * segments since the timer get started.
@@ -4509,6 +4765,7 @@ static void free_session_cb(int fd, short event, void* arg)
 	{
 		session_free(session, res);
 	}
+	GCB_UNLOCK();
 	free(res);
 }
 
@@ -4548,14 +4805,19 @@ pcalloc_safe(request_t *r, apr_pool_t *pool, apr_size_t size, const char *fmt, .
 static void* watchdog_thread(void* p)
 {
 	apr_time_t		duration;
+	apr_time_t		deadline;
 
 	do
 	{
+		pthread_mutex_lock(&shutdown_time_lock);
+		deadline = shutdown_time;
+		pthread_mutex_unlock(&shutdown_time_lock);
+
 		/* apr_time_now is defined in microseconds since epoch */
-		duration = apr_time_sec(shutdown_time - apr_time_now());
+		duration = apr_time_sec(deadline - apr_time_now());
 		if (duration > 0)
 			(void)sleep(duration);
-	} while(apr_time_now() < shutdown_time);
+	} while(apr_time_now() < deadline);
 	gprintln(NULL, "Watchdog timer expired, abort gpfdist");
 	abort();
 }
@@ -4564,8 +4826,346 @@ static void delay_watchdog_timer()
 {
 	if (gcb.wdtimer > 0)
 	{
+		pthread_mutex_lock(&shutdown_time_lock);
 		shutdown_time = apr_time_now() + gcb.wdtimer * APR_USEC_PER_SEC;
+		pthread_mutex_unlock(&shutdown_time_lock);
+	}
+}
+
+/*
+ * worker_notify_cb
+ *
+ * Callback when requests are handed over to a worker, either new GET
+ * requests to serve or requests resumed by their session reader.
+ */
+static void worker_notify_cb(int fd, short event, void* arg)
+{
+	worker_t*		w = (worker_t*) arg;
+	worker_msg_t	msg[64];
+	int				n, i;
+
+	/*
+	 * Drain the pipe before taking the lock, the thread handing requests
+	 * over may be blocked writing to a full pipe while holding it.
+	 */
+	while ((n = read(fd, msg, sizeof(msg))) > 0)
+	{
+		GCB_LOCK();
+		for (i = 0; i < n / (int) sizeof(worker_msg_t); i++)
+		{
+			request_t* r = msg[i].r;
+
+			if (msg[i].resume)
+			{
+				if (setup_write(r))
+					request_end(r, 1, 0, 0);
+			}
+			else
+			{
+				r->worker = w;
+				handle_get_request(r);
+			}
+		}
+		GCB_UNLOCK();
+	}
+}
+
+static void* worker_thread(void* arg)
+{
+	worker_t* w = (worker_t*) arg;
+
+	event_base_dispatch(w->base);
+	gfatal(NULL, "event loop of worker thread %d exited", w->id);
+	return NULL;
+}
+
+/*
+ * workers_start
+ *
+ * Start the worker threads, each one with its own event loop.
+ */
+static void workers_start(void)
+{
+	pthread_mutexattr_t attr;
+	int					i;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&gcb.lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	gcb.workers = pcalloc_safe(NULL, gcb.pool, sizeof(worker_t) * opt.threads,
+							   "out of memory in workers_start");
+
+	for (i = 0; i < opt.threads; i++)
+	{
+		worker_t* w = &gcb.workers[i];
+
+		w->id = i;
+		if (!(w->base = event_base_new()))
+			gfatal(NULL, "cannot create the event loop of worker thread %d", i);
+
+		if (pipe(w->notify_fd) == -1 ||
+			fcntl(w->notify_fd[0], F_SETFL, O_NONBLOCK) == -1 ||
+			fcntl(w->notify_fd[0], F_SETFD, 1) == -1 ||
+			fcntl(w->notify_fd[1], F_SETFD, 1) == -1)
+			gfatal(NULL, "cannot create the notify pipe of worker thread %d: %s",
+				   i, strerror(errno));
+
+		event_set(&w->notify_ev, w->notify_fd[0], EV_READ | EV_PERSIST,
+				  worker_notify_cb, w);
+		event_base_set(w->base, &w->notify_ev);
+		if (event_add(&w->notify_ev, 0))
+			gfatal(NULL, "cannot set up event on the notify pipe of worker thread %d", i);
+
+		if (pthread_create(&w->thread, 0, worker_thread, w))
+			gfatal(NULL, "cannot create worker thread %d", i);
 	}
+
+	gprintln(NULL, "Started %d worker threads", opt.threads);
+}
+
+/* Hand a request over to a worker */
+static void worker_send(worker_t* w, request_t* r, int resume)
+{
+	worker_msg_t	msg;
+	int				n;
+
+	msg.r = r;
+	msg.resume = resume;
+
+	/* messages are smaller than PIPE_BUF, so they are written atomically */
+	while ((n = write(w->notify_fd[1], &msg, sizeof(msg))) < 0 && errno == EINTR)
+		;
+	if (n != sizeof(msg))
+		gfatal(r, "cannot hand request over to worker thread %d: %s",
+			   w->id, strerror(errno));
+}
+
+/*
+ * worker_resume_requests
+ *
+ * Resume a list of requests waiting for their session reader. They are
+ * always handed over through the notify pipe, even when we are the worker
+ * serving them: the caller may be in the middle of ending their session.
+ */
+static void worker_resume_requests(worker_t* w, request_t* r)
+{
+	while (r)
+	{
+		request_t* next = r->next_waiting;
+
+		r->next_waiting = NULL;
+		worker_send(w, r, 1);
+		r = next;
+	}
+}
+
+static void session_reader_free(session_reader_t* rd)
+{
+	int i;
+
+	for (i = 0; i < READER_NBLOCKS; i++)
+		free(rd->blocks[i].data);
+	free(rd->line_delim_str);
+	pthread_mutex_destroy(&rd->lock);
+	pthread_cond_destroy(&rd->cond);
+	free(rd);
+}
+
+/*
+ * session_reader_thread
+ *
+ * Read the session data ahead, until the session stops us. The blocks are
+ * read in the free slot following the blocks read ahead, which no request
+ * uses, so the lock is released while reading.
+ */
+static void* session_reader_thread(void* arg)
+{
+	session_reader_t*	rd = (session_reader_t*) arg;
+	const int			whole_rows = 1; /* gpfdist must not read data with partial rows */
+
+	pthread_mutex_lock(&rd->lock);
+	while (!rd->stop)
+	{
+		reader_block_t*	b;
+		request_t*		waiting;
+		apr_int64_t		pos;
+		int				size;
+
+		if (rd->eof || rd->error || rd->count == READER_NBLOCKS)
+		{
+			pthread_cond_wait(&rd->cond, &rd->lock);
+			continue;
+		}
+
+		b = &rd->blocks[(rd->head + rd->count) % READER_NBLOCKS];
+		pthread_mutex_unlock(&rd->lock);
+
+		pos = fstream_get_compressed_position(rd->fstream);
+		size = fstream_read(rd->fstream, b->data, opt.m, &b->fos, whole_rows,
+							rd->line_delim_str, rd->line_delim_length);
+		delay_watchdog_timer();
+
+		pthread_mutex_lock(&rd->lock);
+		if (size == 0)
+		{
+			rd->read_bytes += fstream_get_compressed_size(rd->fstream) - pos;
+			rd->eof = 1;
+		}
+		else
+		{
+			rd->read_bytes += fstream_get_compressed_position(rd->fstream) - pos;
+			if (size < 0)
+			{
+				apr_cpystrn(rd->ferror, fstream_get_error(rd->fstream), sizeof(rd->ferror));
+				rd->error = 1;
+			}
+			else
+			{
+				b->size = size;
+				rd->count++;
+			}
+		}
+
+		/* wake up the requests waiting for this block */
+		waiting = rd->waiting;
+		rd->waiting = NULL;
+		pthread_mutex_unlock(&rd->lock);
+
+		worker_resume_requests(rd->worker, waiting);
+
+		pthread_mutex_lock(&rd->lock);
+	}
+	pthread_mutex_unlock(&rd->lock);
+
+	return NULL;
+}
+
+/*
+ * session_start_reader
+ *
+ * Assign a new GET session to a worker, and start reading its data ahead.
+ */
+static void session_start_reader(session_t* session, const request_t* r)
+{
+	session_reader_t*	rd;
+	int					i;
+
+	if (!(rd = calloc(1, sizeof(session_reader_t))))
+		gfatal(r, "out of memory in session_start_reader");
+	for (i = 0; i < READER_NBLOCKS; i++)
+	{
+		if (!(rd->blocks[i].data = malloc(opt.m)))
+			gfatal(r, "out of memory when allocating buffer: %d bytes", opt.m);
+	}
+	if (!(rd->line_delim_str = strdup(r->line_delim_str)))
+		gfatal(r, "out of memory in session_start_reader");
+	rd->line_delim_length = r->line_delim_length;
+	rd->fstream = session->fstream;
+	rd->worker = &gcb.workers[gcb.next_worker++ % opt.threads];
+	pthread_mutex_init(&rd->lock, 0);
+	pthread_cond_init(&rd->cond, 0);
+
+	if (pthread_create(&rd->thread, 0, session_reader_thread, rd))
+		gfatal(r, "cannot create session reader thread");
+
+	session->worker = rd->worker;
+	session->reader = rd;
+}
+
+/*
+ * session_stop_reader
+ *
+ * Stop the reader of a session and give the fstream back to the session, for
+ * the caller to close it. The requests waiting for the reader are resumed
+ * once the caller returns to the event loop, and find the session ended.
+ *
+ * The reader is waited for, it may be in the middle of reading a block.
+ */
+static void session_stop_reader(session_t* session)
+{
+	session_reader_t*	rd = session->reader;
+	request_t*			waiting;
+
+	pthread_mutex_lock(&rd->lock);
+	rd->stop = 1;
+	waiting = rd->waiting;
+	rd->waiting = NULL;
+	pthread_cond_signal(&rd->cond);
+	pthread_mutex_unlock(&rd->lock);
+
+	pthread_join(rd->thread, NULL);
+
+	gcb.read_bytes += rd->read_bytes;
+	session->fstream = rd->fstream;
+	session->reader = NULL;
+
+	worker_resume_requests(rd->worker, waiting);
+	session_reader_free(rd);
+}
+
+/*
+ * session_get_prefetched_block
+ *
+ * session_get_block of a session with a reader: copy the next block read
+ * ahead, or return session_block_pending after putting the request on the
+ * waiting list if there is none yet.
+ */
+static const char*
+session_get_prefetched_block(request_t* r, block_t* retblock)
+{
+	session_t*			session = r->session;
+	session_reader_t*	rd = session->reader;
+	reader_block_t*		b;
+	int					error;
+
+	pthread_mutex_lock(&rd->lock);
+
+	gcb.read_bytes += rd->read_bytes;
+	rd->read_bytes = 0;
+
+	if (rd->count == 0)
+	{
+		if (!rd->eof && !rd->error)
+		{
+			r->next_waiting = rd->waiting;
+			rd->waiting = r;
+			pthread_mutex_unlock(&rd->lock);
+			return session_block_pending;
+		}
+
+		/* the error is copied, the reader goes away with the session */
+		error = rd->error;
+		if (error)
+			apr_cpystrn(r->ferror, rd->ferror, sizeof(r->ferror));
+		pthread_mutex_unlock(&rd->lock);
+
+		if (error)
+		{
+			gwarning(NULL, "session_get_block end session due to %s", r->ferror);
+			session_end(session, 1);
+			return r->ferror;
+		}
+
+		gprintln(NULL, "session_get_block: end session due to EOF");
+		session_end(session, 0);
+		return 0;
+	}
+
+	b = &rd->blocks[rd->head];
+	memcpy(retblock->data, b->data, b->size);
+	retblock->top = b->size;
+
+	/* fill the block header with meta data for the client to parse and use */
+	block_fill_header(r, retblock, &b->fos);
+
+	rd->head = (rd->head + 1) % READER_NBLOCKS;
+	rd->count--;
+	pthread_cond_signal(&rd->cond);
+	pthread_mutex_unlock(&rd->lock);
+
+	return 0;
 }
 #else
 static void delay_watchdog_timer()
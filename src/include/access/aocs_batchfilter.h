@@ -0,0 +1,32 @@
+/*------------------------------------------------------------------------------
+ *
+ * aocs_batchfilter.h
+ *	  Block-at-a-time evaluation of simple pushed down quals on AOCS columns.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/access/aocs_batchfilter.h
+ *
+ *------------------------------------------------------------------------------
+ */
+#ifndef AOCS_BATCHFILTER_H
+#define AOCS_BATCHFILTER_H
+
+#include "nodes/pg_list.h"
+
+struct DatumStreamRead;
+
+/* Longest IN list evaluated in batch, longer ones are left to ExecQual */
+#define AOCS_BATCHFILTER_MAX_IN_ITEMS	16
+
+/* Opaque outside of aocs_batchfilter.c */
+typedef struct AOCSBatchFilter AOCSBatchFilter;
+
+extern AOCSBatchFilter *aocs_batchfilter_create(List *quals);
+extern void aocs_batchfilter_reset(AOCSBatchFilter *filter);
+extern int64 aocs_batchfilter_next(AOCSBatchFilter *filter,
+								   struct DatumStreamRead *ds, int64 rowNum);
+
+#endif							/* AOCS_BATCHFILTER_H */
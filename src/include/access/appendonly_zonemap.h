@@ -0,0 +1,117 @@
+/*------------------------------------------------------------------------------
+ *
+ * appendonly_zonemap.h
+ *   Per-block min/max summaries ("zone maps") for append-optimized tables.
+ *
+ * Zone maps are stored as a trailer of the block directory minipages, see
+ * appendonly_zonemap.c for the layout.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/access/appendonly_zonemap.h
+ *
+ *------------------------------------------------------------------------------
+ */
+#ifndef APPENDONLY_ZONEMAP_H
+#define APPENDONLY_ZONEMAP_H
+
+#include "access/attnum.h"
+#include "fmgr.h"
+#include "lib/stringinfo.h"
+#include "nodes/pg_list.h"
+#include "utils/relcache.h"
+#include "utils/snapshot.h"
+
+/*
+ * Maximum number of columns summarized in one column group. For AO row
+ * tables the whole row is one column group, so only the first few eligible
+ * columns get a zone map; AOCS tables have one column per group.
+ */
+#define AO_ZONEMAP_MAX_ATTS 8
+
+/*
+ * Summary of the values of one column within one block directory entry.
+ *
+ * Only pass-by-value columns are summarized, so min and max hold the Datum
+ * itself.
+ */
+typedef struct AOZoneMapSummary
+{
+	int64		minValue;
+	int64		maxValue;
+	int32		nullCount;
+	int32		flags;
+} AOZoneMapSummary;
+
+/* The summary covers every row of its entry */
+#define AOZONEMAP_HAS_SUMMARY	0x01
+/* At least one row is not null, so minValue and maxValue are valid */
+#define AOZONEMAP_HAS_VALUES	0x02
+
+/*
+ * On-disk header of the zone map trailer that follows the entries of a
+ * minipage. It is followed by nEntry * nAtts AOZoneMapSummary, entry major.
+ */
+typedef struct AOZoneMapTrailer
+{
+	int32		nAtts;
+	int16		attnums[AO_ZONEMAP_MAX_ATTS];
+} AOZoneMapTrailer;
+
+#define AOZONEMAP_TRAILER_SIZE MAXALIGN(sizeof(AOZoneMapTrailer))
+
+/*
+ * Zone map state of one column group while inserting. It lives next to the
+ * in-memory minipage of the block directory.
+ */
+typedef struct AOZoneMapGroup
+{
+	int			nAtts;
+	AttrNumber	attnums[AO_ZONEMAP_MAX_ATTS];
+	FmgrInfo	cmpProcs[AO_ZONEMAP_MAX_ATTS];
+	Oid			collations[AO_ZONEMAP_MAX_ATTS];
+
+	/* Number of minipage entries that fit in a block directory tuple */
+	uint32		maxEntries;
+
+	/* Summaries of the rows added since the last block directory entry */
+	AOZoneMapSummary pending[AO_ZONEMAP_MAX_ATTS];
+	int64		pendingRows;
+
+	/* maxEntries * nAtts summaries, one set per minipage entry */
+	AOZoneMapSummary *summaries;
+} AOZoneMapGroup;
+
+/* Scan side state, opaque outside of appendonly_zonemap.c */
+typedef struct AOZoneMapScanState AOZoneMapScanState;
+
+/* Insert side, used by the block directory */
+extern AOZoneMapGroup *AOZoneMap_CreateGroup(Relation rel, int columnGroupNo,
+											 bool isAOCol);
+extern void AOZoneMap_AddValues(AOZoneMapGroup *group, Datum *values,
+								bool *isnull);
+extern void AOZoneMap_ResetEntry(AOZoneMapGroup *group, int entryNo);
+extern void AOZoneMap_FinishEntry(AOZoneMapGroup *group, int entryNo,
+								  int64 rowCount);
+extern Size AOZoneMap_TrailerSize(AOZoneMapGroup *group, uint32 nEntry);
+extern void AOZoneMap_WriteTrailer(AOZoneMapGroup *group, uint32 nEntry,
+								   char *dest);
+extern void AOZoneMap_ReadTrailer(AOZoneMapGroup *group, uint32 nEntry,
+								  const char *src, Size len);
+
+/* Scan side */
+extern AOZoneMapScanState *AOZoneMap_BeginScan(Relation rel, List *qual);
+extern bool AOZoneMap_LoadSegmentFile(AOZoneMapScanState *state,
+									  Snapshot snapshot, int segno);
+extern bool AOZoneMap_CanSkipBlock(AOZoneMapScanState *state, int64 fileOffset,
+								   int64 firstRowNum, int64 rowCount);
+extern bool AOZoneMap_CanSkipRows(AOZoneMapScanState *state, int64 firstRowNum,
+								  int64 rowCount);
+extern int64 AOZoneMap_NextCandidateRow(AOZoneMapScanState *state, int64 rowNum);
+extern void AOZoneMap_CountBlock(AOZoneMapScanState *state, bool skipped);
+extern void AOZoneMap_ExplainScan(AOZoneMapScanState *state,
+								  StringInfo buf);
+
+#endif							/* APPENDONLY_ZONEMAP_H */
@@ -92,4 +92,7 @@ DECLARE_UNIQUE_INDEX(pg_compression_compname_index, 7059, on pg_compression usin
 DECLARE_UNIQUE_INDEX(gp_partition_template_relid_level_index, 7168, on gp_partition_template using btree(relid oid_ops, level int2_ops));
 #define GpPartitionTemplateRelidLevelIndexId  7168
 
+DECLARE_UNIQUE_INDEX(gp_zstd_dictionary_relid_attnum_dictid_index, 6018, on gp_zstd_dictionary using btree(relid oid_ops, attnum int2_ops, dictid int4_ops));
+#define ZstdDictionaryRelidAttnumDictidIndexId  6018
+
 #endif							/* GP_INDEXING_H */
@@ -0,0 +1,67 @@
+/*-------------------------------------------------------------------------
+ *
+ * gp_zstd_dictionary.h
+ *	  definition of the system catalog storing the trained zstd dictionaries
+ *	  of append-optimized column tables (gp_zstd_dictionary)
+ *
+ * A dictionary is trained by each segment from the data it stores, so the
+ * contents of this catalog differ between segments, like gp_fastsequence.
+ * Compressed blocks carry the ID of the dictionary they were compressed
+ * with, so all the dictionaries of a column are kept until the relation is
+ * dropped.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/catalog/gp_zstd_dictionary.h
+ *
+ * NOTES
+ *	  The Catalog.pm module reads this file and derives schema
+ *	  information.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef GP_ZSTD_DICTIONARY_H
+#define GP_ZSTD_DICTIONARY_H
+
+#include "access/attnum.h"
+#include "catalog/genbki.h"
+#include "catalog/gp_zstd_dictionary_d.h"
+
+/* ----------------
+ *		gp_zstd_dictionary definition.  cpp turns this into
+ *		typedef struct FormData_gp_zstd_dictionary
+ * ----------------
+ */
+CATALOG(gp_zstd_dictionary,6015,ZstdDictionaryRelationId)
+{
+	Oid			relid;			/* AOCS relation oid */
+	int16		attnum;			/* column number */
+	int32		dictid;			/* zstd dictionary ID */
+	int32		version;		/* the highest version is used to compress */
+
+#ifdef CATALOG_VARLEN
+	bytea		dictionary BKI_FORCE_NOT_NULL;
+#endif
+} FormData_gp_zstd_dictionary;
+
+/* GPDB added foreign key definitions for gpcheckcat. */
+FOREIGN_KEY(relid REFERENCES pg_class(oid));
+
+/* ----------------
+ *		Form_gp_zstd_dictionary corresponds to a pointer to a tuple with
+ *		the format of gp_zstd_dictionary relation.
+ * ----------------
+ */
+typedef FormData_gp_zstd_dictionary *Form_gp_zstd_dictionary;
+DECLARE_TOAST(gp_zstd_dictionary, 6016, 6017);
+
+extern bytea *GetZstdDictionary(Oid relid, AttrNumber attnum, int32 dictid);
+extern bytea *GetLatestZstdDictionary(Oid relid, AttrNumber attnum);
+extern void StoreZstdDictionary(Oid relid, AttrNumber attnum, int32 dictid,
+								const char *dict, Size len);
+extern void RemoveZstdDictionaries(Oid relid);
+extern void SwapZstdDictionaries(Oid relid1, Oid relid2);
+
+#endif							/* GP_ZSTD_DICTIONARY_H */
@@ -72,6 +72,15 @@ typedef struct CompressionState
 	size_t (*desired_sz)(size_t input);
 
 	void *opaque; /* algorithm specific stuff opaque to the caller */
+
+	/*
+	 * A dictionary trained by the compressor, for the caller to store in
+	 * gp_zstd_dictionary. The compressor uses it only after the caller has
+	 * stored it and reset dictionary to NULL.
+	 */
+	char	   *dictionary;
+	Size		dictionary_len;
+	int32		dictionary_id;
 } CompressionState;
 
 typedef struct StorageAttributes
@@ -80,6 +89,8 @@ typedef struct StorageAttributes
 	int complevel; /* compresslevel field */
 	size_t blocksize; /* blocksize field */
 	Oid	typid; /* Oid of the type being compressed */
+	Oid	relid; /* relation of the column being compressed, or InvalidOid */
+	AttrNumber	attnum; /* column being compressed, for AOCS only */
 } StorageAttributes;
 
 extern CompressionState *callCompressionConstructor(PGFunction constructor,
@@ -205,6 +205,31 @@ typedef struct AOCSScanDescData
 	int				aos_scaned_rows;
 	int				*aos_qual_rows;
 
+	/*
+	 * Batch filters of the pushed down quals, in the same order as
+	 * aos_pushdown_qual; an entry is NULL if its quals cannot be evaluated
+	 * in batch. aos_batch_filter is the one used, for the first projected
+	 * column, once the sampling of the pushed down quals is over.
+	 */
+	struct AOCSBatchFilter **aos_batch_filters;
+	struct AOCSBatchFilter *aos_batch_filter;
+
+	/*
+	 * Zone map of the scan quals, if any. aos_zonemap_active is set when the
+	 * current segment file has summaries to skip blocks with.
+	 */
+	AOZoneMapScanState *aos_zonemap;
+	bool			aos_zonemap_active;
+
+	/*
+	 * When the zone map or the batch filter is in use for the current
+	 * segment file, aos_positioned is set and the columns are moved by row
+	 * number instead of one datum at a time; aos_cur_row is then the row
+	 * number of the current tuple.
+	 */
+	bool			aos_positioned;
+	int64			aos_cur_row;
+
 } AOCSScanDescData;
 
 typedef AOCSScanDescData *AOCSScanDesc;
@@ -263,6 +263,13 @@ typedef struct AppendOnlyScanDescData
 	ExprContext		*aos_pushdown_econtext;
 	ExprState		*aos_pushdown_qual;
 
+	/*
+	 * Zone map of the scan quals, if any. aos_zonemap_active is set when the
+	 * current segment file has summaries to skip blocks with.
+	 */
+	AOZoneMapScanState *aos_zonemap;
+	bool			aos_zonemap_active;
+
 }	AppendOnlyScanDescData;
 
 typedef AppendOnlyScanDescData *AppendOnlyScanDesc;
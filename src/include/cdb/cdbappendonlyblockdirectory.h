@@ -16,6 +16,7 @@
 
 #include "access/aosegfiles.h"
 #include "access/aocssegfiles.h"
+#include "access/appendonly_zonemap.h"
 #include "access/appendonlytid.h"
 #include "access/skey.h"
 #include "catalog/indexing.h"
@@ -74,6 +75,13 @@ typedef struct Minipage
 	MinipageEntry entry[1];
 } Minipage;
 
+/*
+ * Minipage versions. A MINIPAGE_VERSION_ZONEMAP minipage carries zone map
+ * summaries after its entries, see appendonly_zonemap.c.
+ */
+#define MINIPAGE_VERSION_ORIGINAL	0
+#define MINIPAGE_VERSION_ZONEMAP	1
+
 /*
  * Define the relevant info for a minipage for each
  * column group.
@@ -83,6 +91,9 @@ typedef struct MinipagePerColumnGroup
 	Minipage *minipage;
 	uint32 numMinipageEntries;
 	ItemPointerData tupleTid;
+
+	/* Zone map of the column group, only set up for inserts */
+	AOZoneMapGroup *zonemap;
 } MinipagePerColumnGroup;
 
 /*
@@ -93,7 +104,9 @@ typedef struct MinipagePerColumnGroup
 							  / sizeof(MinipageEntry))
 
 #define IsMinipageFull(minipagePerColumnGroup) \
-	((minipagePerColumnGroup)->numMinipageEntries == (uint32) gp_blockdirectory_minipage_size)
+	((minipagePerColumnGroup)->numMinipageEntries >= (uint32) gp_blockdirectory_minipage_size || \
+	 ((minipagePerColumnGroup)->zonemap != NULL && \
+	  (minipagePerColumnGroup)->numMinipageEntries >= (minipagePerColumnGroup)->zonemap->maxEntries))
 
 /*
  * Define a structure for the append-only relation block directory.
@@ -204,7 +217,8 @@ extern void AppendOnlyBlockDirectory_Init_forInsert(
 	Relation aoRel,
 	int segno,
 	int numColumnGroups,
-	bool isAOCol);
+	bool isAOCol,
+	bool buildZoneMaps);
 extern void AppendOnlyBlockDirectory_Init_forSearch(
 	AppendOnlyBlockDirectory *blockDirectory,
 	Snapshot appendOnlyMetaDataSnapshot,
@@ -260,6 +274,20 @@ extern void AppendOnlyBlockDirectory_DeleteSegmentFile(
 extern void AppendOnlyBlockDirectory_End_forUniqueChecks(
 	AppendOnlyBlockDirectory *blockDirectory);
 
+/*
+ * Zone map of a column group of a block directory initialized for insert,
+ * or NULL if the column group is not summarized.
+ */
+static inline AOZoneMapGroup *
+AppendOnlyBlockDirectory_GetZoneMap(AppendOnlyBlockDirectory *blockDirectory,
+									int columnGroupNo)
+{
+	if (blockDirectory->blkdirRel == NULL || blockDirectory->minipages == NULL)
+		return NULL;
+
+	return blockDirectory->minipages[columnGroupNo].zonemap;
+}
+
 extern void AppendOnlyBlockDirectory_InsertPlaceholder(AppendOnlyBlockDirectory *blockDirectory,
 												  int64 firstRowNum,
 												  int64 fileOffset,
@@ -327,9 +355,12 @@ copy_out_minipage(MinipagePerColumnGroup *minipageInfo,
 	value = (struct varlena *)
 		DatumGetPointer(minipage_value);
 	detoast_value = pg_detoast_datum(value);
-	Assert(VARSIZE(detoast_value) <= minipage_size(NUM_MINIPAGE_ENTRIES));
+	Assert(((Minipage *) detoast_value)->nEntry <= NUM_MINIPAGE_ENTRIES);
+	Assert(VARSIZE(detoast_value) >= minipage_size(((Minipage *) detoast_value)->nEntry));
 
-	memcpy(minipageInfo->minipage, detoast_value, VARSIZE(detoast_value));
+	/* Copy the entries only, leaving out any zone map trailer */
+	memcpy(minipageInfo->minipage, detoast_value,
+		   minipage_size(((Minipage *) detoast_value)->nEntry));
 	if (detoast_value != value)
 		pfree(detoast_value);
 
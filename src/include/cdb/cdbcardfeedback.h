@@ -0,0 +1,26 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbcardfeedback.h
+ *	  Actual row counts of executed plans, fed back to ORCA.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbcardfeedback.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBCARDFEEDBACK_H
+#define CDBCARDFEEDBACK_H
+
+#include "executor/execdesc.h"
+
+extern Size CardFeedbackShmemSize(void);
+extern void CardFeedbackShmemInit(void);
+
+extern void CardFeedbackRecordPlan(QueryDesc *queryDesc);
+extern bool CardFeedbackLookup(uint64 key, double *rows);
+extern void CardFeedbackInvalidateRel(Oid relid);
+
+#endif							/* CDBCARDFEEDBACK_H */
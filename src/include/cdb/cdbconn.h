@@ -53,6 +53,13 @@ typedef struct SegmentDatabaseDescriptor
     char                   *whoami;         /* QE identifier for msgs */
 	bool					isWriter;
 	int						identifier;		/* unique identifier in the cdbcomponent segment pool */
+
+	/* Keys of the plans cached by the QE, see cdbplancache.c */
+	uint64				   *cachedPlans;
+	int						numCachedPlans;
+	int						maxCachedPlans;
+	int						numPlansSent;
+	uint32					planCacheEpoch;
 } SegmentDatabaseDescriptor;
 
 SegmentDatabaseDescriptor *
@@ -51,6 +51,19 @@ typedef struct CdbDispatcherState
 	bool isGangDestroying;
 #endif
 	bool destroyIdleReaderGang;
+
+	/*
+	 * The plan dispatch message with the plan left out, sent to the QEs that
+	 * have the plan in their cache, and the one with the plan, built when a
+	 * QE does not have it. See cdbplancache.c.
+	 */
+	char *planRefText;
+	int planRefTextLen;
+	char *planText;
+	int planTextLen;
+	struct DispatchCommandQueryParms *planQueryParms;
+	uint64 planCacheKey;
+	uint32 planCacheEpoch;
 } CdbDispatcherState;
 
 typedef struct DispatcherInternalFuncs
@@ -62,6 +62,12 @@ extern void CdbDispatchPlan(struct QueryDesc *queryDesc,
 							bool planRequiresTxn,
 							bool cancelOnError);
 
+/*
+ * Return the plan dispatch message with the plan in it, built on first use
+ * if the plan is cached on the QEs.
+ */
+extern char *cdbdisp_getPlanQueryText(struct CdbDispatcherState *ds, int *len);
+
 /*
  * Special for sending SET commands that change GUC variables, so they go to all
  * gangs, both reader and writer
@@ -103,6 +103,9 @@ typedef struct CdbDispatchResult
 	 */
 	bool receivedAckMsg;
 
+	/* true => QE did not have the cached plan it was sent, see cdbplancache.c */
+	bool planCacheMiss;
+
 	/* type of signal sent */
 	DispatchWaitMode sentSignal;
 
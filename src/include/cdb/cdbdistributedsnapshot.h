@@ -49,7 +49,8 @@ typedef struct DistributedSnapshotWithLocalMapping
 
 	/*
 	 * Cache to perform quick check for localXid, populated after reverse
-	 * mapping distributed xid to local xid.
+	 * mapping distributed xid to local xid. inProgressMappedLocalXids is
+	 * kept sorted, for binary search.
 	 */
 	TransactionId minCachedLocalXid;
 	TransactionId maxCachedLocalXid;
@@ -71,6 +72,10 @@ extern DistributedSnapshotCommitted DistributedSnapshotWithLocalMapping_Committe
 	TransactionId 							localXid,
 	bool isVacuumCheck);
 
+extern bool DistributedSnapshot_XidInProgress(
+	DistributedSnapshot *ds,
+	DistributedTransactionId distribXid);
+
 extern void DistributedSnapshot_Reset(
 	DistributedSnapshot *distributedSnapshot);
 
@@ -0,0 +1,22 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbdynsample.h
+ *	  Estimate the selectivity of predicates on a sample of the relation.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbdynsample.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBDYNSAMPLE_H
+#define CDBDYNSAMPLE_H
+
+#include "nodes/nodes.h"
+
+extern bool cdbSampleQualSelectivity(Oid relid, Node *qual, int *budget,
+									 double *selectivity);
+
+#endif							/* CDBDYNSAMPLE_H */
@@ -124,6 +124,11 @@ struct CdbExplain_ShowStatCtx *
 cdbexplain_showExecStatsBegin(struct QueryDesc *queryDesc,
                               instr_time        querystarttime);
 
+bool
+cdbexplain_getTotalRows(struct PlanState *planstate,
+                        double           *rows_out,
+                        int              *nworkers_out);
+
 
 
 #endif   /* CDBEXPLAIN_H */
@@ -54,6 +54,10 @@ extern void LocalDistribXactCache_AddCommitted(
 	TransactionId						localXid,
 	DistributedTransactionId			distribXid);
 
+extern void LocalDistribXactCache_Reset(void);
+
+extern void LocalDistribXactCache_GetStats(int64 *hits, int64 *misses);
+
 extern void LocalDistribXactCache_ShowStats(char *nameStr);
 
 #endif   /* CDBLOCALDISTRIBXACT_H */
@@ -121,6 +121,10 @@ extern void SendStopMessage(MotionLayerState *mlStates,
 							ChunkTransportState *transportStates,
 							int16 motNodeID);
 
+extern void ExplainMotionCompression(MotionLayerState *mlStates,
+									 int16 motNodeID,
+									 struct StringInfoData *buf);
+
 /* used by ml_ipc to set the number of receivers that the motion node is expecting.
  * This is used by cdbmotion to keep track of when its seen enough EndOfStream
  * messages.
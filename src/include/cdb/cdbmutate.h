@@ -50,7 +50,7 @@ extern int32 cdbhash_const_list(List *plConsts, int iSegments, Oid *hashfuncs);
 extern Node *makeSegmentFilterExpr(int segid);
 
 extern Node *exec_make_plan_constant(struct PlannedStmt *stmt, EState *estate,
-						bool is_SRI, List **cursorPositions);
+						bool is_SRI, List **cursorPositions, bool *evaluated);
 extern void remove_subquery_in_RTEs(Node *node);
 
 extern Plan *cdbpathtoplan_create_sri_plan(RangeTblEntry *rte, PlannerInfo *subroot, Path *subpath, int createplan_flags);
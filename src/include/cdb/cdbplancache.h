@@ -0,0 +1,38 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbplancache.h
+ *	  Session-level cache of dispatched plans on the QEs.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbplancache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBPLANCACHE_H
+#define CDBPLANCACHE_H
+
+#include "nodes/plannodes.h"
+
+struct SegmentDatabaseDescriptor;
+
+extern void InitSegmentPlanCache(void);
+
+/* QD side */
+extern uint64 SegmentPlanCacheKey(PlannedStmt *stmt);
+extern uint32 SegmentPlanCacheEpoch(void);
+extern bool SegmentPlanCacheHasPlan(struct SegmentDatabaseDescriptor *segdbDesc,
+									uint64 key, uint32 epoch);
+extern void SegmentPlanCacheRemember(struct SegmentDatabaseDescriptor *segdbDesc,
+									 uint64 key, uint32 epoch);
+extern void SegmentPlanCacheForget(struct SegmentDatabaseDescriptor *segdbDesc);
+
+/* QE side */
+extern bool QEPlanCacheHasPlan(uint64 key, uint32 epoch);
+extern void QEPlanCacheReportMiss(uint64 key);
+extern PlannedStmt *QEPlanCacheLookup(uint64 key, uint32 epoch);
+extern void QEPlanCacheStore(uint64 key, uint32 epoch, PlannedStmt *plan);
+
+#endif							/* CDBPLANCACHE_H */
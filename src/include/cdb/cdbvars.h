@@ -313,6 +313,30 @@ typedef enum GpVars_Interconnect_Method
 
 extern int Gp_interconnect_fc_method;
 
+/*
+ * Parameter gp_interconnect_compression
+ *
+ * Compression method for the tuples sent through motions. The tuples carry
+ * the method with them, so receivers need no setting.
+ */
+typedef enum GpVars_Interconnect_Compression
+{
+	INTERCONNECT_COMPRESSION_NONE = 0,
+	INTERCONNECT_COMPRESSION_PGLZ,
+	INTERCONNECT_COMPRESSION_LZ4,
+	INTERCONNECT_COMPRESSION_ZSTD,
+} GpVars_Interconnect_Compression;
+
+extern int Gp_interconnect_compression;
+
+/*
+ * Parameter gp_interconnect_compression_ratio
+ *
+ * A motion keeps compressing its tuples only while they shrink to at most
+ * this fraction of their size, see tupser.c.
+ */
+extern double Gp_interconnect_compression_ratio;
+
 /*
  * Parameter Gp_interconnect_queue_depth
  *
@@ -639,11 +663,23 @@ extern int gp_segworker_relative_priority;
 /*  Max size of dispatched plans; 0 if no limit */
 extern int gp_max_plan_size;
 
+/* Max number of plans cached by a QE for the QD; 0 to disable */
+extern int gp_segment_plan_cache_size;
+
+/* Number of QD workers routing the rows of COPY FROM; 0 to disable */
+extern int gp_copy_from_parallel_workers;
+
 /* The default number of batches to use when the hybrid hashed aggregation
  * algorithm (re-)spills in-memory groups to disk.
  */
 extern int gp_hashagg_default_nbatches;
 
+/*
+ * Let the partial stage of a multi-stage hash aggregate emit its groups
+ * early, instead of spilling them.
+ */
+extern bool gp_hashagg_streambottom;
+
 /* Get statistics for partitioned parent from a child */
 extern bool 	gp_statistics_pullup_from_child_partition;
 
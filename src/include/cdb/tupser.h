@@ -57,6 +57,30 @@ typedef struct SerTupInfo
 
 	/* true if tupdesc contains record types */
 	bool		has_record_types;
+
+	/*
+	 * Compression of the tuples sent, see SerializeTuple(). The method is
+	 * one of INTERCONNECT_COMPRESSION_*.
+	 */
+	int			compress_method;
+	double		compress_ratio;
+	int			compress_skip;		/* tuples to send before trying again */
+	int			compress_backoff;	/* current length of the pauses */
+	int			compress_probes;	/* tuples tried in the current round */
+	uint64		compress_probe_raw_bytes;
+	uint64		compress_probe_bytes;
+	char	   *compress_buf;
+	int			compress_buf_size;
+
+	/* Statistics of the compressed tuples sent */
+	uint64		stat_compressed_tuples;
+	uint64		stat_compress_raw_bytes;
+	uint64		stat_compressed_bytes;
+
+	/* Statistics of the compressed tuples received */
+	uint64		stat_decompressed_tuples;
+	uint64		stat_decompress_bytes;
+	uint64		stat_decompressed_raw_bytes;
 }	SerTupInfo;
 
 /*
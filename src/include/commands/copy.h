@@ -24,6 +24,8 @@
 #include "cdb/cdbhash.h"
 #include "cdb/cdbcopy.h"
 #include "cdb/cdbsreh.h"
+#include "storage/dsm.h"
+#include "storage/shm_toc.h"
 
 /*
  * The error handling mode for this data load.
@@ -162,6 +164,7 @@ extern bool NextCopyFromRawFields(CopyFromState cstate,
 extern void CopyFromErrorCallback(void *arg);
 
 extern uint64 CopyFrom(CopyFromState cstate);
+extern void CopyFromParallelMain(dsm_segment *seg, shm_toc *toc);
 
 extern DestReceiver *CreateCopyDestReceiver(void);
 
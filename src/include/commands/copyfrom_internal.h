@@ -190,6 +190,9 @@ typedef struct CopyFromStateData
 	/* Information on the connections to QEs. */
 	CdbCopy		*cdbCopy;
 	bool		delim_off;	/* delimiter is set to OFF? */
+
+	/* In a parallel COPY worker, where the lines come from and rows go to */
+	struct CopyFromRouteState *route;
 	/* end Cloudberry Database specific variables */
 } CopyFromStateData;
 
@@ -0,0 +1,210 @@
+/*-------------------------------------------------------------------------
+ *
+ * csvscan.h
+ *	  Scanning of csv data for record boundaries.
+ *
+ * The data is classified a vector at a time: the quote characters give the
+ * quoted regions with a prefix-xor of their bitmask, and the newlines outside
+ * of them are record boundaries.  A vector holding an escape character within
+ * quotes is scanned one byte at a time, since an escape changes the meaning
+ * of the next character.
+ *
+ * Portions Copyright (c) 2023, HashData Technology Limited.
+ *
+ * src/include/fstream/csvscan.h
+ *-------------------------------------------------------------------------
+ */
+#ifndef CSVSCAN_H
+#define CSVSCAN_H
+
+#include "port/pg_bitutils.h"
+#include "port/simd.h"
+
+typedef struct csv_scan_state
+{
+	int		qc;				/* quote char */
+	int		xc;				/* escape char */
+	int		nc;				/* newline char, '\n' for "\r\n" */
+	int		crlf;			/* records end with "\r\n" */
+	int		in_quote;
+	int		last_was_esc;
+	int		lastch;
+} csv_scan_state;
+
+static inline void
+csv_scan_init(csv_scan_state *st, int qc, int xc, int nc, int crlf)
+{
+	st->qc = qc;
+	st->xc = xc;
+	st->nc = crlf ? '\n' : nc;
+	st->crlf = crlf;
+	st->in_quote = 0;
+	st->last_was_esc = 0;
+	st->lastch = 0;
+}
+
+/*
+ * Scan one character. Return true if it ends a record.
+ */
+static inline bool
+csv_scan_char(csv_scan_state *st, int ch)
+{
+	int		lastch = st->lastch;
+
+	st->lastch = ch;
+
+	if (st->in_quote)
+	{
+		if (!st->last_was_esc)
+		{
+			if (ch == st->qc)
+				st->in_quote = 0;
+			else if (ch == st->xc)
+				st->last_was_esc = 1;
+		}
+		else
+			st->last_was_esc = 0;
+	}
+	else if (ch == st->nc && (!st->crlf || lastch == '\r'))
+		return true;
+	else if (ch == st->qc)
+		st->in_quote = 1;
+
+	return false;
+}
+
+#ifndef USE_NO_SIMD
+/*
+ * Parity of the bits up to and including each bit of a mask of a vector.
+ */
+static inline uint32
+csv_prefix_xor(uint32 mask)
+{
+	int		shift;
+
+	for (shift = 1; shift < (int) sizeof(Vector8); shift <<= 1)
+		mask ^= mask << shift;
+
+	return mask;
+}
+#endif
+
+/*
+ * csv_scan_records
+ *
+ * Scan the data in [p, q) according to the csv parsing rules. Return the end
+ * of the last complete record, or of the first one only if 'one' was passed
+ * in, or NULL if there is none.  *nrecords is incremented by the number of
+ * records found.
+ */
+static inline char *
+csv_scan_records(csv_scan_state *st, char *p, char *q, bool one,
+				 int64_t *nrecords)
+{
+	char   *last_record_loc = NULL;
+
+#ifndef USE_NO_SIMD
+	/*
+	 * A newline that is also the quote or escape char is left to the scalar
+	 * code, which gives it precedence outside of quotes.
+	 */
+	if (st->nc != st->qc && st->nc != st->xc &&
+		!(st->crlf && (st->qc == '\r' || st->xc == '\r')))
+	{
+		const uint32 all = (1U << sizeof(Vector8)) - 1;
+		Vector8		qv = vector8_broadcast((uint8) st->qc);
+		Vector8		xv = vector8_broadcast((uint8) st->xc);
+		Vector8		nv = vector8_broadcast((uint8) st->nc);
+		Vector8		rv = vector8_broadcast('\r');
+
+		while (q - p >= (int) sizeof(Vector8))
+		{
+			Vector8		chunk;
+			uint32		quotes;
+			uint32		newlines;
+			uint32		quoted;		/* in quotes before each char */
+			uint32		records;
+
+			vector8_load(&chunk, (const uint8 *) p);
+			quotes = vector8_highbit_mask(vector8_eq(chunk, qv));
+			newlines = vector8_highbit_mask(vector8_eq(chunk, nv));
+			if (st->crlf)
+			{
+				uint32		crs = vector8_highbit_mask(vector8_eq(chunk, rv));
+
+				newlines &= (crs << 1) | (st->lastch == '\r');
+			}
+
+			/*
+			 * Every quote toggles the quote state, since an escape within
+			 * quotes that are also the escape char ends them anyway.
+			 */
+			quoted = (csv_prefix_xor(quotes) ^ quotes) & all;
+			if (st->in_quote)
+				quoted ^= all;
+
+			if (st->last_was_esc ||
+				(st->xc != st->qc &&
+				 (vector8_highbit_mask(vector8_eq(chunk, xv)) & quoted) != 0))
+			{
+				/* an escape in quotes, scan this vector one char at a time */
+				char   *end = p + sizeof(Vector8);
+
+				while (p < end)
+				{
+					if (csv_scan_char(st, *p++))
+					{
+						last_record_loc = p;
+						(*nrecords)++;
+						if (one)
+							return last_record_loc;
+					}
+				}
+				continue;
+			}
+
+			records = newlines & ~quoted;
+			if (records != 0)
+			{
+				if (one)
+				{
+					char   *end = p + pg_rightmost_one_pos32(records) + 1;
+
+					/* update the state up to the end of the record */
+					while (p < end)
+						(void) csv_scan_char(st, *p++);
+					(*nrecords)++;
+					return end;
+				}
+
+				last_record_loc = p + pg_leftmost_one_pos32(records) + 1;
+				do
+				{
+					(*nrecords)++;
+					records &= records - 1;
+				} while (records != 0);
+			}
+
+			/* quote state after the last char */
+			st->in_quote = ((quoted ^ quotes) >> (sizeof(Vector8) - 1)) & 1;
+			st->lastch = p[sizeof(Vector8) - 1];
+			p += sizeof(Vector8);
+		}
+	}
+#endif
+
+	while (p < q)
+	{
+		if (csv_scan_char(st, *p++))
+		{
+			last_record_loc = p;
+			(*nrecords)++;
+			if (one)
+				break;
+		}
+	}
+
+	return last_record_loc;
+}
+
+#endif							/* CSVSCAN_H */
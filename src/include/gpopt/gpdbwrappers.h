@@ -170,6 +170,9 @@ List *ExtractNodesPlan(Plan *pl, int node_tag, bool descend_into_subqueries);
 List *ExtractNodesExpression(Node *node, int node_tag,
 							 bool descend_into_subqueries);
 
+// does the expression or query reference variables of the given query level
+bool ContainVarsOfLevel(Node *node, int levelsup);
+
 // intermediate result type of given aggregate
 Oid GetAggIntermediateResultType(Oid aggid);
 
@@ -582,6 +585,13 @@ void CdbEstimateRelationSize(RelOptInfo *relOptInfo, Relation rel,
 							 double *tuples, double *allvisfrac);
 double CdbEstimatePartitionedNumTuples(Relation rel);
 
+// selectivity of a predicate on a sample of the relation
+bool SampleQualSelectivity(Oid relid, Node *qual, int *budget,
+						   double *selectivity);
+
+// actual rows observed in executed plans for an expression
+bool CardinalityFeedback(uint64 key, double *rows);
+
 // close the given relation
 void CloseRelation(Relation rel);
 
@@ -740,6 +750,9 @@ uint32 HashName(Datum d);
 
 uint32 UUIDHash(Datum d);
 
+// order-preserving prefix of the sort key of a datum, for statistics
+bool GetSortKeyPrefix(Oid typid, Datum d, uint64 *prefix);
+
 void *GPDBMemoryContextAlloc(MemoryContext context, Size size);
 
 MemoryContext GPDBAllocSetContextCreate();
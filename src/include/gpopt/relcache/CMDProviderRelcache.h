@@ -49,6 +49,9 @@ private:
 	// memory pool
 	CMemoryPool *m_mp;
 
+	// number of predicates that may still be sampled for this query
+	INT m_sampling_budget;
+
 public:
 	CMDProviderRelcache(const CMDProviderRelcache &) = delete;
 
@@ -72,6 +75,15 @@ public:
 	{
 		return GetGPDBTypeMdid(mp, sysid, type_info);
 	}
+
+	// estimate the selectivity of a predicate on a sample of the relation
+	BOOL SampleSelectivity(CMemoryPool *mp, CMDAccessor *md_accessor,
+						   IMDId *rel_mdid, const gpdxl::CDXLNode *pred_dxl,
+						   UlongToIntMap *colid_to_attno,
+						   CDouble *selectivity) override;
+
+	// actual rows of an expression observed in executed plans
+	BOOL CardinalityFeedback(ULLONG key, CDouble *rows) override;
 };
 }  // namespace gpmd
 
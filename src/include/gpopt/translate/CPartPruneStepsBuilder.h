@@ -15,6 +15,7 @@
 
 #include "gpos/base.h"
 
+#include "gpopt/translate/CContextDXLToPlStmt.h"
 #include "gpopt/translate/CMappingColIdVarPlStmt.h"
 #include "gpopt/translate/CTranslatorDXLToScalar.h"
 #include "naucrates/dxl/operators/CDXLNode.h"
@@ -26,49 +27,60 @@ namespace gpdxl
 class CPartPruneStepsBuilder
 {
 private:
-	// root partitioned tabled
-	Relation m_relation;
-
-	// index in the rtable
-	Index m_rtindex;
-
 	// list of pruned scan nodes denoted as an index of the relation's partition_mdids
 	ULongPtrArray *m_part_indexes;
 
+	// partitioning filter, with a child for each level of a multi-level
+	// partitioned table
+	CDXLNode *m_filter_node;
+
+	// number of levels of the partition hierarchy
+	ULONG m_num_levels;
+
 	// colid -> var mapping from the subtree
 	CMappingColIdVarPlStmt *m_colid_var_mapping;
 
 	// dxl -> scalar translator
 	CTranslatorDXLToScalar *m_translator_dxl_to_scalar;
 
+	// context, for the range table entries of sub-partitioned tables
+	CContextDXLToPlStmt *m_dxl_to_plstmt_context;
+
 	// ctor
-	CPartPruneStepsBuilder(Relation relation, Index rtindex,
-						   ULongPtrArray *part_indexes,
+	CPartPruneStepsBuilder(ULongPtrArray *part_indexes, CDXLNode *filterNode,
+						   ULONG num_levels,
 						   CMappingColIdVarPlStmt *colid_var_mapping,
-						   CTranslatorDXLToScalar *translator_dxl_to_scalar);
+						   CTranslatorDXLToScalar *translator_dxl_to_scalar,
+						   CContextDXLToPlStmt *dxl_to_plstmt_context);
 
 	CPartPruneStepsBuilder(const CPartPruneStepsBuilder &) = default;
 
+	// range table index of a sub-partitioned table, adding it if needed
+	Index GetRTIndexForSubPartition(Relation relation);
+
 public:
 	// dtor
 	~CPartPruneStepsBuilder() = default;
 
 	static List *CreatePartPruneInfos(
 		CDXLNode *filterNode, Relation relation, Index rtindex,
-		ULongPtrArray *part_indexes, CMappingColIdVarPlStmt *colid_var_mapping,
-		CTranslatorDXLToScalar *translator_dxl_to_scalar);
+		ULongPtrArray *part_indexes, ULONG num_levels,
+		CMappingColIdVarPlStmt *colid_var_mapping,
+		CTranslatorDXLToScalar *translator_dxl_to_scalar,
+		CContextDXLToPlStmt *dxl_to_plstmt_context);
 
-	PartitionedRelPruneInfo *CreatePartPruneInfoForOneLevel(
-		CDXLNode *filterNode);
+	BOOL CreatePartPruneInfosForLevel(Relation relation, Index rtindex,
+									  ULONG level, List **pinfos,
+									  ULONG *leaf_idx, ULONG *part_ptr);
 
-	List *PartPruneStepsFromFilter(CDXLNode *filterNode, INT *step_id,
-								   List *steps_list);
+	List *PartPruneStepsFromFilter(CDXLNode *filterNode, PartitionKey partkey,
+								   INT *step_id, List *steps_list);
 
-	List *PartPruneStepFromScalarCmp(CDXLNode *node, INT *step_id,
-									 List *steps_list);
+	List *PartPruneStepFromScalarCmp(CDXLNode *node, PartitionKey partkey,
+									 INT *step_id, List *steps_list);
 
-	List *PartPruneStepFromScalarBoolExpr(CDXLNode *node, INT *step_id,
-										  List *steps_list);
+	List *PartPruneStepFromScalarBoolExpr(CDXLNode *node, PartitionKey partkey,
+										  INT *step_id, List *steps_list);
 };
 }  // namespace gpdxl
 
@@ -310,6 +310,13 @@ private:
 										 ULONG	//current_query_level
 	);
 
+	// are all the values of the given tuples constants
+	static BOOL IsConstValuesList(List *tuples_list);
+
+	// translate a range table entry of constant values into a const table
+	CDXLNode *TranslateConstValueScanRTEToDXL(const RangeTblEntry *rte,
+											  ULONG rt_index);
+
 	// create a dxl node from a array of datums and project elements
 	CDXLNode *TranslateTVFToDXL(const RangeTblEntry *rte, ULONG rti,
 								ULONG  //current_query_level
@@ -446,6 +453,9 @@ public:
 	// main driver
 	CDXLNode *TranslateQueryToDXL();
 
+	// is the query simple enough for the reduced search
+	BOOL IsTrivialQuery() const;
+
 	// return the list of output columns
 	CDXLNodeArray *GetQueryOutputCols() const;
 
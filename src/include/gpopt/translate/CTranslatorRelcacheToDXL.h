@@ -223,6 +223,20 @@ private:
 										 ULongPtrArray **part_keys,
 										 CharPtrArray **part_types);
 
+	// get the partition key and type of one partitioned table
+	static void RetrievePartKeyAndType(Relation rel, AttrNumber *attno,
+									   CHAR *part_type);
+
+	// get partition keys and types of the levels below a partitioned table
+	static void RetrieveSubPartKeysAndTypes(CMemoryPool *mp, Relation root,
+											Relation rel, ULONG level,
+											ULongPtrArray *part_keys,
+											CharPtrArray *part_types);
+
+	// get the leaf partitions of a partitioned table
+	static void RetrieveLeafPartitions(CMemoryPool *mp, Relation rel,
+									   IMdIdArray *leaf_oids);
+
 	// get keysets for relation
 	static ULongPtr2dArray *RetrieveRelKeysets(CMemoryPool *mp, OID oid,
 											   BOOL should_add_default_keys,
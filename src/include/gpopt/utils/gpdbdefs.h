@@ -41,6 +41,8 @@ extern "C" {
 #endif
 #include "catalog/pg_operator.h"
 #include "catalog/pg_proc.h"
+#include "cdb/cdbcardfeedback.h"
+#include "cdb/cdbdynsample.h"
 #include "cdb/cdbhash.h"
 #include "cdb/cdbmutate.h"
 #include "cdb/cdbutil.h"
@@ -58,6 +60,7 @@ extern "C" {
 #include "utils/numeric.h"
 #include "utils/rel.h"
 #include "utils/selfuncs.h"
+#include "utils/sortsupport.h"
 #include "utils/typcache.h"
 #include "utils/uri.h"
 
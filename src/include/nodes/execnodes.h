@@ -2364,6 +2364,7 @@ typedef struct PresortedKeyData
  */
 struct shareinput_local_state;
 struct shareinput_Xslice_reference;
+struct shareinput_Xslice_reader;
 struct NTupleStore;
 struct NTupleStoreAccessor;
 
@@ -2376,6 +2377,7 @@ typedef struct ShareInputScanState
 
 	struct shareinput_local_state *local_state;
 	struct shareinput_Xslice_reference *ref;
+	struct shareinput_Xslice_reader *xslice_reader;	/* cross-slice only */
 
 	bool		isready;
 } ShareInputScanState;
@@ -2620,6 +2622,15 @@ typedef struct AggState
 	SharedAggInfo *shared_info; /* one entry per worker */
 	Bitmapset	*aggs_used;	/* which aggs are used in this query */
 
+	/* GPDB: streaming partial aggregation, see hash_agg_stream_now() */
+	bool		hash_streaming;	/* emit the groups early, rather than spill? */
+	bool		hash_stream_full;	/* hash table hit the memory limit */
+	bool		hash_input_done;	/* outer plan exhausted */
+	uint64		hash_stream_ntuples;	/* input tuples since last emptied */
+	int			hash_stream_count;	/* # of times the groups were emitted
+									 * early */
+	uint64		hash_stream_first;	/* input tuples before the first time */
+	bool		hash_stream_first_full; /* first time was due to memory? */
 } AggState;
 
 typedef struct TupleSplitState
@@ -335,6 +335,13 @@ typedef struct Plan
 	 * How much memory (in KB) should be used to execute this plan node?
 	 */
 	uint64 operatorMemKB;
+
+	/*
+	 * Fingerprint of the logical expression that ORCA computes with this
+	 * node, under which the actual rows of the node are remembered for
+	 * cardinality feedback.  0 if none.
+	 */
+	uint64		feedback_key;
 } Plan;
 
 /* ----------------
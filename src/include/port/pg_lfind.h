@@ -0,0 +1,78 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_lfind.h
+ *	  Optimized linear search routines using SIMD intrinsics where
+ *	  available.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ * IDENTIFICATION
+ *	  src/include/port/pg_lfind.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_LFIND_H
+#define PG_LFIND_H
+
+#include "port/pg_bitutils.h"
+#include "port/simd.h"
+
+/* maximum number of characters pg_lfind8_any() looks for */
+#define PG_LFIND8_ANY_MAX	8
+
+/*
+ * pg_lfind8_any
+ *
+ * Return the index of the first element in 'base' equal to any of the 'nset'
+ * characters in 'set', or 'nelem' if there is none.  This is meant to skip
+ * runs of ordinary characters when parsing, so the set is expected to be
+ * small, and ideally a compile-time constant size.
+ */
+static inline int
+pg_lfind8_any(const char *set, int nset, const char *base, int nelem)
+{
+	int			i = 0;
+	int			j;
+
+	Assert(nset > 0 && nset <= PG_LFIND8_ANY_MAX);
+
+#ifndef USE_NO_SIMD
+	if (nelem >= (int) sizeof(Vector8))
+	{
+		Vector8		sets[PG_LFIND8_ANY_MAX];
+
+		for (j = 0; j < nset; j++)
+			sets[j] = vector8_broadcast((uint8) set[j]);
+
+		for (; i <= nelem - (int) sizeof(Vector8); i += sizeof(Vector8))
+		{
+			Vector8		chunk;
+			Vector8		match;
+			uint32		mask;
+
+			vector8_load(&chunk, (const uint8 *) base + i);
+			match = vector8_eq(chunk, sets[0]);
+			for (j = 1; j < nset; j++)
+				match = vector8_or(match, vector8_eq(chunk, sets[j]));
+
+			mask = vector8_highbit_mask(match);
+			if (mask != 0)
+				return i + pg_rightmost_one_pos32(mask);
+		}
+	}
+#endif
+
+	/* Process the remaining elements one at a time. */
+	for (; i < nelem; i++)
+	{
+		for (j = 0; j < nset; j++)
+		{
+			if (base[i] == set[j])
+				return i;
+		}
+	}
+
+	return nelem;
+}
+
+#endif							/* PG_LFIND_H */
@@ -63,6 +63,9 @@ extern void gp_decompress(
  *
  * zstd_free_context(ctx);
  *
+ * Dictionaries attached to the context, in cdict and ddict, are freed with
+ * it.
+ *
  * If the transaction is aborted, the handle will be automatically closed,
  * when the resource owner is destroyed.
  */
@@ -72,6 +75,8 @@ typedef struct
 {
 	ZSTD_CCtx  *cctx;
 	ZSTD_DCtx  *dctx;
+	ZSTD_CDict *cdict;
+	ZSTD_DDict *ddict;
 
 	ResourceOwner owner;
 	dlist_node	node;
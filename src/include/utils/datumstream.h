@@ -57,6 +57,10 @@ typedef struct DatumStreamWrite
 
 	char	   *title;
 
+	/* The column written, for its zstd dictionaries */
+	Oid			relid;
+	AttrNumber	attnum;
+
 	/* AO Storage */
 	bool		need_close_file;
 	AppendOnlyStorageAttributes ao_attr;
@@ -312,9 +316,13 @@ extern int64 datumstreamwrite_lob(DatumStreamWrite *ds,
 extern int	datumstreamread_block(DatumStreamRead * ds,
 								  AppendOnlyBlockDirectory *blockDirectory,
 								  int colGroupNo);
+extern int	datumstreamread_block_header(DatumStreamRead * ds);
+extern void datumstreamread_skip_block(DatumStreamRead * ds);
 extern void datumstreamread_find(DatumStreamRead * datumStream,
 					 int32 rowNumInBlock);
 extern void datumstreamread_rewind_block(DatumStreamRead * datumStream);
+extern int	datumstreamread_block_decode(DatumStreamRead * acc, Datum *values,
+										 bool *isnull);
 extern bool datumstreamread_find_block(DatumStreamRead * datumStream,
 						   DatumStreamFetchDesc datumStreamFetchDesc,
 						   int64 rowNum);
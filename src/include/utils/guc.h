@@ -296,6 +296,8 @@ extern bool gp_local_distributed_cache_stats;
 extern bool gp_appendonly_verify_block_checksums;
 extern bool gp_appendonly_verify_write_block;
 extern bool gp_appendonly_compaction;
+extern bool gp_appendonly_zonemap;
+extern bool gp_appendonly_zstd_dictionary;
 extern bool enable_parallel;
 extern int  gp_appendonly_insert_files;
 extern int  gp_appendonly_insert_files_tuples_range;
@@ -547,6 +549,11 @@ extern double optimizer_damping_factor_join;
 extern double optimizer_damping_factor_groupby;
 extern bool optimizer_dpe_stats;
 extern bool optimizer_enable_derive_stats_all_groups;
+extern bool optimizer_enable_text_range_stats;
+extern bool optimizer_enable_dynamic_sampling;
+extern bool optimizer_enable_cardinality_feedback;
+extern bool optimizer_enable_trivial_fast_path;
+extern int optimizer_dynamic_sampling_budget;
 
 /* Costing or tuning related GUCs used by the Optimizer */
 extern int optimizer_segments;
@@ -162,6 +162,8 @@ typedef struct CachedPlan
 	int			generation;		/* parent's generation number for this plan */
 	int			refcount;		/* count of live references to this struct */
 	MemoryContext context;		/* context containing this CachedPlan */
+	uint64		dispatchId;		/* GPDB: unique in the session, identifies
+								 * the plan in the QEs' plan cache */
 } CachedPlan;
 
 /*
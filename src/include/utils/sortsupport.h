@@ -273,5 +273,6 @@ extern void PrepareSortSupportFromOrderingOp(Oid orderingOp, SortSupport ssup);
 extern void PrepareSortSupportFromIndexRel(Relation indexRel, int16 strategy,
 										   SortSupport ssup);
 extern void PrepareSortSupportFromGistIndexRel(Relation indexRel, SortSupport ssup);
+extern bool SortSupportKeyPrefix(Oid typid, Datum datum, uint64 *prefix);
 
 #endif							/* SORTSUPPORT_H */
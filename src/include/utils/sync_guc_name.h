@@ -36,10 +36,13 @@
 		"gp_external_enable_filter_pushdown",
 		"gp_hashagg_default_nbatches",
 		"gp_hashagg_groups_per_bucket",
+		"gp_hashagg_streambottom",
 		"gp_hashjoin_tuples_per_bucket",
 		"gp_ignore_error_table",
 		"gp_indexcheck_insert",
 		"gp_initial_bad_row_limit",
+		"gp_interconnect_compression",
+		"gp_interconnect_compression_ratio",
 		"gp_interconnect_debug_retry_interval",
 		"gp_interconnect_default_rtt",
 		"gp_interconnect_fc_method",
@@ -151,3 +154,5 @@
 		"gp_resgroup_debug_wait_queue",
 		"gp_appendonly_insert_files",
 		"gp_appendonly_insert_files_tuples_range",
+		"gp_appendonly_zonemap",
+		"gp_appendonly_zstd_dictionary",
@@ -178,6 +178,7 @@
 		"gp_command_count",
 		"gp_connection_send_timeout",
 		"gp_contentid",
+		"gp_copy_from_parallel_workers",
 		"gp_cost_hashjoin_chainwalk",
 		"gp_create_table_random_default_distribution",
 		"gp_cte_sharing",
@@ -280,6 +281,7 @@
 		"gp_role",
 		"gp_safefswritesize",
 		"gp_segment_connect_timeout",
+		"gp_segment_plan_cache_size",
 		"gp_segments_for_planner",
 		"gp_segworker_relative_priority",
 		"gp_selectivity_damping_factor",
@@ -401,16 +403,19 @@
 		"optimizer_damping_factor_groupby",
 		"optimizer_damping_factor_join",
 		"optimizer_dpe_stats",
+		"optimizer_dynamic_sampling_budget",
 		"optimizer_enable_assert_maxonerow",
 		"optimizer_enable_associativity",
 		"optimizer_enable_bitmapscan",
 		"optimizer_enable_broadcast_nestloop_outer_child",
+		"optimizer_enable_cardinality_feedback",
 		"optimizer_enable_constant_expression_evaluation",
 		"optimizer_enable_ctas",
 		"optimizer_enable_derive_stats_all_groups",
 		"optimizer_enable_direct_dispatch",
 		"optimizer_enable_dml",
 		"optimizer_enable_dml_constraints",
+		"optimizer_enable_dynamic_sampling",
 		"optimizer_enable_dynamictablescan",
 		"optimizer_enable_eageragg",
 		"optimizer_enable_gather_on_segment_for_dml",
@@ -440,6 +445,8 @@
 		"optimizer_enable_space_pruning",
 		"optimizer_enable_streaming_material",
 		"optimizer_enable_tablescan",
+		"optimizer_enable_text_range_stats",
+		"optimizer_enable_trivial_fast_path",
 		"optimizer_enable_redistribute_nestloop_loj_inner_child",
 		"optimizer_force_comprehensive_join_implementation",
 		"optimizer_enforce_subplans",
@@ -147,7 +147,8 @@ typedef enum
 	WAIT_EVENT_DTX_RECOVERY,
 	WAIT_EVENT_SHAREINPUT_SCAN,
 	WAIT_EVENT_INTERCONNECT,
-	WAIT_EVENT_LOGINMONITOR_FINISH
+	WAIT_EVENT_LOGINMONITOR_FINISH,
+	WAIT_EVENT_COPY_FROM_ROUTE
 } WaitEventIPC;
 
 /* ----------
@@ -187,7 +187,8 @@ typedef struct pgCdbStatCell
 typedef enum PGExtraType {
 	PGExtraTypeNone,
 	PGExtraTypeVacuumStats,		/* Stats collected for vacuum and analyze from QEs */
-	PGExtraTypeTableStats		/* Table stats collected for statement from QEs */
+	PGExtraTypeTableStats,		/* Table stats collected for statement from QEs */
+	PGExtraTypePlanCacheMiss	/* QE does not have the cached plan it was sent */
 } PGExtraType;
 
 struct pg_result
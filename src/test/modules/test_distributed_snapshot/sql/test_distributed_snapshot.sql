@@ -0,0 +1,19 @@
+CREATE EXTENSION test_distributed_snapshot;
+
+-- the binary search must find the same xids as the linear scan
+SELECT structure, nlookups, nhits
+  FROM test_distributed_snapshot_bench(500, 100000)
+ WHERE structure LIKE 'in-progress array%';
+SELECT structure, nlookups, nhits
+  FROM test_distributed_snapshot_bench(0, 10)
+ WHERE structure LIKE 'in-progress array%';
+SELECT structure, nlookups, nhits
+  FROM test_distributed_snapshot_bench(1, 100)
+ WHERE structure LIKE 'in-progress array%';
+
+-- half of the looked up xids are cached, and few of them are evicted
+SELECT structure, nhits BETWEEN nlookups * 0.4 AND nlookups * 0.5 AS expected_hits
+  FROM test_distributed_snapshot_bench(500, 100000)
+ WHERE structure = 'local-distributed cache';
+
+SELECT test_distributed_snapshot_bench(10, -1);
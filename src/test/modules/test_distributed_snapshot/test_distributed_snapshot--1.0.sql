@@ -0,0 +1,13 @@
+/* src/test/modules/test_distributed_snapshot/test_distributed_snapshot--1.0.sql */
+
+-- complain if script is sourced in psql, rather than via CREATE EXTENSION
+\echo Use "CREATE EXTENSION test_distributed_snapshot" to load this file. \quit
+
+CREATE FUNCTION test_distributed_snapshot_bench(snapshot_size int,
+	lookups int,
+	OUT structure text,
+	OUT nlookups bigint,
+	OUT nhits bigint,
+	OUT nsec_per_lookup float8)
+RETURNS SETOF record STRICT
+AS 'MODULE_PATHNAME' LANGUAGE C;
@@ -0,0 +1,234 @@
+/*--------------------------------------------------------------------------
+ *
+ * test_distributed_snapshot.c
+ *		Micro-benchmark of the lookups of distributed snapshot visibility
+ *		checks.
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ * IDENTIFICATION
+ *		src/test/modules/test_distributed_snapshot/test_distributed_snapshot.c
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/transam.h"
+#include "cdb/cdbdistributedsnapshot.h"
+#include "cdb/cdblocaldistribxact.h"
+#include "fmgr.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "portability/instr_time.h"
+#include "storage/procarray.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/tuplestore.h"
+
+PG_MODULE_MAGIC;
+
+PG_FUNCTION_INFO_V1(test_distributed_snapshot_bench);
+
+/* a fixed seed, so that the hits are the same on every run */
+#define BENCH_SEED		UINT64CONST(0x9E3779B97F4A7C15)
+
+typedef struct BenchResult
+{
+	const char *structure;
+	int64		nlookups;
+	int64		nhits;
+	double		nsec_per_lookup;
+} BenchResult;
+
+static uint64
+bench_random(uint64 *state)
+{
+	/* xorshift64 */
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+/*
+ * The linear scan of the in-progress array that
+ * DistributedSnapshot_XidInProgress() replaced, for comparison.
+ */
+static bool
+linear_xid_in_progress(DistributedSnapshot *ds, DistributedTransactionId distribXid)
+{
+	for (int i = 0; i < ds->count; i++)
+	{
+		if (distribXid == ds->inProgressXidArray[i])
+			return true;
+		if (distribXid < ds->inProgressXidArray[i])
+			break;
+	}
+	return false;
+}
+
+static void
+bench_in_progress_array(int snapshot_size, int lookups, BenchResult *results)
+{
+	DistributedSnapshot ds;
+	DistributedTransactionId xmin = 1000000;
+	DistributedTransactionId xid;
+	uint64		range;
+	uint64		state;
+	instr_time	start;
+	instr_time	duration;
+
+	/* in-progress xids, 1 to 4 apart, like in a busy cluster */
+	ds.count = snapshot_size;
+	ds.inProgressXidArray = palloc(Max(snapshot_size, 1) * sizeof(DistributedTransactionId));
+	state = BENCH_SEED;
+	xid = xmin;
+	for (int i = 0; i < snapshot_size; i++)
+	{
+		ds.inProgressXidArray[i] = xid;
+		xid += 1 + bench_random(&state) % 4;
+	}
+	range = Max(xid - xmin, 1);
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		BenchResult *result = &results[pass];
+
+		result->structure = (pass == 0) ? "in-progress array, linear" :
+			"in-progress array, binary";
+		result->nlookups = lookups;
+		result->nhits = 0;
+
+		state = BENCH_SEED;
+		INSTR_TIME_SET_CURRENT(start);
+		for (int i = 0; i < lookups; i++)
+		{
+			DistributedTransactionId lookup = xmin + bench_random(&state) % range;
+			bool		found;
+
+			if (pass == 0)
+				found = linear_xid_in_progress(&ds, lookup);
+			else
+				found = DistributedSnapshot_XidInProgress(&ds, lookup);
+			if (found)
+				result->nhits++;
+		}
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, start);
+
+		result->nsec_per_lookup = INSTR_TIME_GET_DOUBLE(duration) * 1e9 / Max(lookups, 1);
+
+		CHECK_FOR_INTERRUPTS();
+	}
+
+	pfree(ds.inProgressXidArray);
+}
+
+/*
+ * Fill the local-distributed cache to half its size, and look up xids of
+ * which half are cached. The cache of this backend is reset before and
+ * after, to not mix the fake xids with real ones.
+ */
+static void
+bench_local_distrib_cache(int lookups, BenchResult *result)
+{
+	TransactionId first = FirstNormalTransactionId + 1000000;
+	int			ncached = gp_max_local_distributed_cache / 2;
+	DistributedTransactionId distribXid;
+	int64		hits;
+	int64		misses;
+	uint64		state;
+	instr_time	start;
+	instr_time	duration;
+
+	LocalDistribXactCache_Reset();
+
+	for (int i = 0; i < ncached; i++)
+	{
+		if (!LocalDistribXactCache_CommittedFind(first + i, &distribXid))
+			LocalDistribXactCache_AddCommitted(first + i, 2000000 + i);
+	}
+	LocalDistribXactCache_GetStats(&hits, &misses);
+
+	result->structure = "local-distributed cache";
+	result->nlookups = lookups;
+
+	state = BENCH_SEED;
+	INSTR_TIME_SET_CURRENT(start);
+	for (int i = 0; i < lookups; i++)
+	{
+		TransactionId lookup = first + bench_random(&state) % Max(2 * ncached, 1);
+
+		(void) LocalDistribXactCache_CommittedFind(lookup, &distribXid);
+	}
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+
+	result->nhits = -hits;
+	LocalDistribXactCache_GetStats(&hits, &misses);
+	result->nhits += hits;
+	result->nsec_per_lookup = INSTR_TIME_GET_DOUBLE(duration) * 1e9 / Max(lookups, 1);
+
+	LocalDistribXactCache_Reset();
+}
+
+/*
+ * SQL-callable entry point, returning a row for each structure.
+ */
+Datum
+test_distributed_snapshot_bench(PG_FUNCTION_ARGS)
+{
+	int32		snapshot_size = PG_GETARG_INT32(0);
+	int32		lookups = PG_GETARG_INT32(1);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+	BenchResult results[3];
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	if (snapshot_size < 0 || snapshot_size > GetMaxSnapshotXidCount())
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("snapshot size must be between 0 and %d",
+						GetMaxSnapshotXidCount())));
+	if (lookups < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("number of lookups must not be negative")));
+
+	bench_in_progress_array(snapshot_size, lookups, &results[0]);
+	bench_local_distrib_cache(lookups, &results[2]);
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	for (int i = 0; i < lengthof(results); i++)
+	{
+		Datum		values[4];
+		bool		nulls[4] = {false, false, false, false};
+
+		values[0] = CStringGetTextDatum(results[i].structure);
+		values[1] = Int64GetDatum(results[i].nlookups);
+		values[2] = Int64GetDatum(results[i].nhits);
+		values[3] = Float8GetDatum(results[i].nsec_per_lookup);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	return (Datum) 0;
+}
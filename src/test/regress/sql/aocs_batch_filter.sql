@@ -0,0 +1,53 @@
+-- Test block-at-a-time evaluation of pushed down quals on AOCS tables. The
+-- results must be the same as with the quals evaluated row by row.
+SET gp_enable_predicate_pushdown TO on;
+SET gp_predicate_pushdown_sample_rows TO 10;
+
+CREATE TABLE batchfilter_aocs (a int, b int ENCODING (compresstype=rle_type),
+    f float8, d date, c text)
+    WITH (appendonly=true, orientation=column) DISTRIBUTED BY (a);
+
+INSERT INTO batchfilter_aocs SELECT i, i % 100, i / 4.0,
+    '2020-01-01'::date + i % 365, 'row' || i FROM generate_series(1, 20000) i;
+INSERT INTO batchfilter_aocs VALUES (20001, NULL, NULL, NULL, NULL);
+INSERT INTO batchfilter_aocs VALUES (20002, NULL, 'NaN', NULL, 'nan');
+
+-- Integer column, RLE compressed
+SELECT count(*) FROM batchfilter_aocs WHERE b < 10;
+SELECT count(*) FROM batchfilter_aocs WHERE 10 > b;
+SELECT count(*) FROM batchfilter_aocs WHERE b < 10::bigint;
+SELECT count(*) FROM batchfilter_aocs WHERE b >= 99::smallint;
+SELECT count(*) FROM batchfilter_aocs WHERE b BETWEEN 20 AND 29;
+SELECT count(*) FROM batchfilter_aocs WHERE b IN (1, 2, 300, NULL);
+SELECT count(*) FROM batchfilter_aocs WHERE b IS NULL;
+SELECT count(*) FROM batchfilter_aocs WHERE b IS NOT NULL AND b > 97;
+SELECT sum(a) FROM batchfilter_aocs WHERE b = 7;
+
+-- Floating point column, NaN sorts above every other value
+SELECT count(*) FROM batchfilter_aocs WHERE f > 4999.5;
+SELECT count(*) FROM batchfilter_aocs WHERE f >= 5000;
+SELECT count(*) FROM batchfilter_aocs WHERE f < 1;
+SELECT count(*) FROM batchfilter_aocs WHERE f IN (0.25, 0.5, 1e9);
+SELECT c FROM batchfilter_aocs WHERE f = 2.5;
+
+-- Date column
+SELECT count(*) FROM batchfilter_aocs WHERE d = '2020-01-01';
+SELECT count(*) FROM batchfilter_aocs WHERE d BETWEEN '2020-01-01' AND '2020-01-10';
+SELECT count(*) FROM batchfilter_aocs WHERE d < '2020-01-01';
+
+-- Quals on several columns, and quals that are not evaluated in batch
+SELECT count(*) FROM batchfilter_aocs WHERE b = 0 AND f < 100;
+SELECT count(*) FROM batchfilter_aocs WHERE b <> 5;
+
+-- Deleted rows must stay invisible
+DELETE FROM batchfilter_aocs WHERE a = 5;
+SELECT count(*) FROM batchfilter_aocs WHERE b < 10;
+
+-- Same results with the quals evaluated row by row
+SET gp_enable_predicate_pushdown TO off;
+SELECT count(*) FROM batchfilter_aocs WHERE b < 10;
+SELECT count(*) FROM batchfilter_aocs WHERE f > 4999.5;
+
+RESET gp_predicate_pushdown_sample_rows;
+RESET gp_enable_predicate_pushdown;
+DROP TABLE batchfilter_aocs;
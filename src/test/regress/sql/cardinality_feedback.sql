@@ -0,0 +1,53 @@
+--
+-- With optimizer_enable_cardinality_feedback, the actual rows of the nodes
+-- of plans run with EXPLAIN ANALYZE are remembered, and ORCA corrects its
+-- estimates of the same expressions with them.  Plans of the Postgres
+-- planner are not annotated, so nothing is remembered for them.
+--
+create function cardinality_feedback_rows(query text) returns int
+language plpgsql as $$
+declare
+  line text;
+begin
+  for line in execute 'explain ' || query loop
+    return substring(line from 'rows=(\d+)')::int;
+  end loop;
+end;
+$$;
+
+create function cardinality_feedback_run(query text) returns void
+language plpgsql as $$
+declare
+  line text;
+begin
+  for line in execute 'explain analyze ' || query loop
+  end loop;
+end;
+$$;
+
+create table cardinality_feedback (a int, b int) distributed by (a);
+insert into cardinality_feedback select i, i % 10 from generate_series(1, 10000) i;
+analyze cardinality_feedback;
+
+select gp_cardinality_feedback_reset();
+set optimizer_enable_cardinality_feedback = on;
+
+-- 1000 rows, as both predicates select the same rows
+select cardinality_feedback_rows('select * from cardinality_feedback where b = 1 and a % 10 = 1') between 900 and 1100;
+select cardinality_feedback_run('select * from cardinality_feedback where b = 1 and a % 10 = 1');
+select cardinality_feedback_rows('select * from cardinality_feedback where b = 1 and a % 10 = 1') between 900 and 1100;
+select relids::regclass[], actual_rows, executions from gp_cardinality_feedback;
+
+-- the actual rows are forgotten when the table is analyzed
+analyze cardinality_feedback;
+select count(*) from gp_cardinality_feedback;
+select cardinality_feedback_rows('select * from cardinality_feedback where b = 1 and a % 10 = 1') between 900 and 1100;
+
+-- nothing is remembered below a Limit
+select cardinality_feedback_run('select * from cardinality_feedback where b = 1 and a % 10 = 1 limit 10');
+select count(*) from gp_cardinality_feedback;
+
+reset optimizer_enable_cardinality_feedback;
+drop table cardinality_feedback;
+drop function cardinality_feedback_run(text);
+drop function cardinality_feedback_rows(text);
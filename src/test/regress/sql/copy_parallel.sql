@@ -0,0 +1,84 @@
+--
+-- COPY FROM with the rows routed to the segments by parallel workers on the
+-- coordinator. The results must be the same as when the coordinator routes
+-- them itself.
+--
+set gp_copy_from_parallel_workers = 2;
+
+create table copy_par (a int, b text) distributed by (a);
+create table copy_ser (a int, b text) distributed by (a);
+
+-- Enough rows for several batches of lines
+copy (select i, repeat('x', i % 50) from generate_series(1, 20000) i) to '/tmp/copy_parallel.txt';
+-- Each worker hits the fault for every batch it routes, so that a silent
+-- fallback to routing on the coordinator is noticed
+select gp_inject_fault_infinite('copy_from_parallel_worker_batch', 'skip', dbid)
+  from gp_segment_configuration where role = 'p' and content = -1;
+copy copy_par from '/tmp/copy_parallel.txt';
+select count(*), sum(a), sum(length(b)) from copy_par;
+select (regexp_match(gp_inject_fault('copy_from_parallel_worker_batch', 'status', dbid),
+                     'num times hit:''(\d+)'''))[1]::int > 0 as workers_used
+  from gp_segment_configuration where role = 'p' and content = -1;
+select gp_inject_fault('copy_from_parallel_worker_batch', 'reset', dbid)
+  from gp_segment_configuration where role = 'p' and content = -1;
+
+-- Every row lands on the same segment as with serial routing, which does
+-- not use the workers
+select gp_inject_fault_infinite('copy_from_parallel_worker_batch', 'skip', dbid)
+  from gp_segment_configuration where role = 'p' and content = -1;
+set gp_copy_from_parallel_workers = 0;
+copy copy_ser from '/tmp/copy_parallel.txt';
+set gp_copy_from_parallel_workers = 2;
+select (regexp_match(gp_inject_fault('copy_from_parallel_worker_batch', 'status', dbid),
+                     'num times hit:''(\d+)'''))[1]::int = 0 as workers_unused
+  from gp_segment_configuration where role = 'p' and content = -1;
+select gp_inject_fault('copy_from_parallel_worker_batch', 'reset', dbid)
+  from gp_segment_configuration where role = 'p' and content = -1;
+select count(*) from
+  (select gp_segment_id, * from copy_par) p
+  full join (select gp_segment_id, * from copy_ser) s
+  on p.gp_segment_id = s.gp_segment_id and p.a = s.a and p.b = s.b
+  where p.a is null or s.a is null;
+
+-- CSV, with a header and quoted newlines
+create table copy_par_csv (a int, b text) distributed by (a);
+copy copy_par_csv from stdin csv header;
+a,b
+1,one
+2,"two
+lines"
+3,"a ""quoted"" word"
+\.
+select * from copy_par_csv order by a;
+
+-- Rows rejected by the workers are counted and logged by the coordinator
+copy copy_par_csv from stdin csv log errors segment reject limit 5;
+4,four
+bad,five
+6,six
+\.
+select * from copy_par_csv order by a;
+select linenum, errmsg, rawdata from gp_read_error_log('copy_par_csv');
+
+\set VERBOSITY terse
+copy copy_par_csv from stdin csv;
+7,seven
+x,eight
+\.
+\set VERBOSITY default
+select count(*) from copy_par_csv;
+
+-- Replicated tables get every row on every segment
+create table copy_par_rep (a int, b text) distributed replicatedly;
+copy copy_par_rep from '/tmp/copy_parallel.txt';
+select count(*), sum(a) from copy_par_rep;
+select count(*) = 20000 * (select count(*) from gp_segment_configuration
+                           where role = 'p' and content >= 0)
+  from gp_dist_random('copy_par_rep');
+
+reset gp_copy_from_parallel_workers;
+select gp_truncate_error_log('copy_par_csv');
+drop table copy_par;
+drop table copy_ser;
+drop table copy_par_csv;
+drop table copy_par_rep;
@@ -0,0 +1,54 @@
+--
+-- With optimizer_enable_dynamic_sampling, ORCA estimates predicates that its
+-- statistics don't support on a sample of the table.  The Postgres planner
+-- keeps using its default selectivities.
+--
+create function dynamic_sampling_rows(query text) returns int
+language plpgsql as $$
+declare
+  line text;
+begin
+  for line in execute 'explain ' || query loop
+    return substring(line from 'rows=(\d+)')::int;
+  end loop;
+end;
+$$;
+
+create function dynamic_sampling_small(int) returns bool
+language plpgsql immutable as $$
+begin
+  return $1 < 2;
+end;
+$$;
+
+create table dynamic_sampling (a int, b int) distributed by (a);
+insert into dynamic_sampling select i, i % 100 from generate_series(1, 100000) i;
+analyze dynamic_sampling;
+
+set optimizer_enable_dynamic_sampling = on;
+
+-- 2000 rows
+select dynamic_sampling_rows('select * from dynamic_sampling where dynamic_sampling_small(b)') between 1000 and 4000;
+
+-- the observed selectivity is cached until the table is analyzed again
+insert into dynamic_sampling select i, 0 from generate_series(1, 200000) i;
+select dynamic_sampling_rows('select * from dynamic_sampling where dynamic_sampling_small(b)') between 1000 and 4000;
+analyze dynamic_sampling;
+-- 202000 rows, two thirds of the table; the default selectivities of both
+-- optimizers estimate less than half
+select dynamic_sampling_rows('select * from dynamic_sampling where dynamic_sampling_small(b)') between 170000 and 240000;
+
+-- no new samples once the budget is spent
+set optimizer_dynamic_sampling_budget = 0;
+select dynamic_sampling_rows('select * from dynamic_sampling where dynamic_sampling_small(a % 100)') > 40000;
+reset optimizer_dynamic_sampling_budget;
+
+-- an error while sampling falls back to the default estimate
+select dynamic_sampling_rows('select * from dynamic_sampling where 100 / b > 50') > 0;
+
+select count(*) from dynamic_sampling where dynamic_sampling_small(b);
+
+reset optimizer_enable_dynamic_sampling;
+drop table dynamic_sampling;
+drop function dynamic_sampling_small(int);
+drop function dynamic_sampling_rows(text);
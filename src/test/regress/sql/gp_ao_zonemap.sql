@@ -0,0 +1,79 @@
+-- Test block-level zone maps of append-optimized tables. The results must be
+-- the same whether blocks are skipped or not.
+SET gp_appendonly_zonemap TO on;
+
+-- Sum up the "Zone map skipped N of M blocks" lines of EXPLAIN ANALYZE
+CREATE FUNCTION zonemap_skipped_blocks(query text) RETURNS bigint
+LANGUAGE plpgsql AS $$
+DECLARE
+  line text;
+  skipped bigint := 0;
+BEGIN
+  FOR line IN EXECUTE 'EXPLAIN (ANALYZE) ' || query LOOP
+    skipped := skipped + coalesce(substring(line FROM 'Zone map skipped (\d+) of')::bigint, 0);
+  END LOOP;
+  RETURN skipped;
+END;
+$$;
+
+CREATE TABLE zonemap_ao (a int, b int, c text)
+    WITH (appendonly=true) DISTRIBUTED BY (a);
+CREATE TABLE zonemap_aocs (a int, b int, c text)
+    WITH (appendonly=true, orientation=column) DISTRIBUTED BY (a);
+
+INSERT INTO zonemap_ao SELECT i, i, 'row' || i FROM generate_series(1, 100000) i;
+INSERT INTO zonemap_ao VALUES (100001, NULL, NULL);
+INSERT INTO zonemap_aocs SELECT i, i, 'row' || i FROM generate_series(1, 100000) i;
+INSERT INTO zonemap_aocs VALUES (100001, NULL, NULL);
+
+SELECT count(*) FROM zonemap_ao WHERE b < 100;
+SELECT count(*) FROM zonemap_ao WHERE b BETWEEN 5000 AND 5999;
+SELECT count(*) FROM zonemap_ao WHERE 50000 >= b AND b > 49000;
+SELECT count(*) FROM zonemap_ao WHERE b IN (1, 50000, 99999, 200000);
+SELECT count(*) FROM zonemap_ao WHERE b IS NULL;
+SELECT count(*) FROM zonemap_ao WHERE b IS NOT NULL AND b > 99990;
+SELECT count(c) FROM zonemap_ao WHERE b = 77777;
+
+SELECT count(*) FROM zonemap_aocs WHERE b < 100;
+SELECT count(*) FROM zonemap_aocs WHERE b BETWEEN 5000 AND 5999;
+SELECT count(*) FROM zonemap_aocs WHERE 50000 >= b AND b > 49000;
+SELECT count(*) FROM zonemap_aocs WHERE b IN (1, 50000, 99999, 200000);
+SELECT count(*) FROM zonemap_aocs WHERE b IS NULL;
+SELECT count(*) FROM zonemap_aocs WHERE b IS NOT NULL AND b > 99990;
+SELECT count(c) FROM zonemap_aocs WHERE b = 77777;
+
+-- Blocks are skipped, with both optimizers
+SET optimizer TO off;
+SELECT zonemap_skipped_blocks('SELECT * FROM zonemap_ao WHERE b BETWEEN 5000 AND 5999') > 0;
+SELECT zonemap_skipped_blocks('SELECT * FROM zonemap_aocs WHERE b BETWEEN 5000 AND 5999') > 0;
+SELECT zonemap_skipped_blocks('SELECT * FROM zonemap_ao WHERE b IS NULL') > 0;
+SELECT zonemap_skipped_blocks('SELECT * FROM zonemap_aocs WHERE a > 0') = 0;
+SET optimizer TO on;
+SELECT zonemap_skipped_blocks('SELECT * FROM zonemap_ao WHERE b BETWEEN 5000 AND 5999') > 0;
+SELECT zonemap_skipped_blocks('SELECT * FROM zonemap_aocs WHERE b BETWEEN 5000 AND 5999') > 0;
+SELECT zonemap_skipped_blocks('SELECT * FROM zonemap_ao WHERE b > 49000 AND b <= 50000 AND c IS NOT NULL') > 0;
+SELECT count(*) FROM zonemap_ao WHERE b BETWEEN 5000 AND 5999;
+SELECT count(*) FROM zonemap_aocs WHERE 50000 >= b AND b > 49000 AND c IS NOT NULL;
+RESET optimizer;
+
+-- Deleted rows in a block that is read must stay invisible
+DELETE FROM zonemap_ao WHERE b = 99995;
+DELETE FROM zonemap_aocs WHERE b = 99995;
+SELECT count(*) FROM zonemap_ao WHERE b > 99990;
+SELECT count(*) FROM zonemap_aocs WHERE b > 99990;
+
+-- Appending to a segment file keeps the summaries of the existing blocks
+INSERT INTO zonemap_ao SELECT i, i, 'row' || i FROM generate_series(1, 1000) i;
+INSERT INTO zonemap_aocs SELECT i, i, 'row' || i FROM generate_series(1, 1000) i;
+SELECT count(*) FROM zonemap_ao WHERE b < 100;
+SELECT count(*) FROM zonemap_aocs WHERE b < 100;
+
+-- Same results without zone maps
+SET gp_appendonly_zonemap TO off;
+SELECT count(*) FROM zonemap_ao WHERE b < 100;
+SELECT count(*) FROM zonemap_aocs WHERE b BETWEEN 5000 AND 5999;
+
+RESET gp_appendonly_zonemap;
+DROP TABLE zonemap_ao;
+DROP TABLE zonemap_aocs;
+DROP FUNCTION zonemap_skipped_blocks(text);
@@ -1602,9 +1602,86 @@ insert into orca.bm_dyn_test_multilvl_part select i, 2018 + (i%2), i%2 + 1, 'usa
 create index bm_multi_test_idx_part on orca.bm_dyn_test_multilvl_part using bitmap(year);
 analyze orca.bm_dyn_test_multilvl_part;
 -- print name of parent index
-explain select * from orca.bm_dyn_test_multilvl_part where year = 2019;
+explain (costs off) select * from orca.bm_dyn_test_multilvl_part where year = 2019;
 select count(*) from orca.bm_dyn_test_multilvl_part where year = 2019;
 
+-- Multi-level partitioned tables, pruned on the keys of every level. The
+-- partitions are created out of bound order, and some have another column
+-- layout than the root. mlp_2020 is a leaf on the first level.
+create table orca.mlp (id int, junk int, y int, d int, r text)
+distributed by (id) partition by range (y);
+alter table orca.mlp drop column junk;
+create table orca.mlp_2020 partition of orca.mlp for values from (2020) to (2021);
+create table orca.mlp_2019 partition of orca.mlp for values from (2019) to (2020) partition by list (d);
+create table orca.mlp_2018 (r text, d int, y int, id int) distributed by (id) partition by list (d);
+create table orca.mlp_2019_d2 partition of orca.mlp_2019 for values in (3, 4) partition by list (r);
+create table orca.mlp_2019_d1 partition of orca.mlp_2019 for values in (1, 2) partition by list (r);
+create table orca.mlp_2018_d1 partition of orca.mlp_2018 for values in (1, 2) partition by list (r);
+create table orca.mlp_2018_d2 partition of orca.mlp_2018 for values in (3, 4) partition by list (r);
+create table orca.mlp_2018_d1_other partition of orca.mlp_2018_d1 default;
+create table orca.mlp_2018_d1_usa partition of orca.mlp_2018_d1 for values in ('usa');
+create table orca.mlp_2018_d1_eu partition of orca.mlp_2018_d1 for values in ('eu');
+create table orca.mlp_2018_d2_other partition of orca.mlp_2018_d2 default;
+create table orca.mlp_2018_d2_usa partition of orca.mlp_2018_d2 for values in ('usa');
+create table orca.mlp_2018_d2_eu partition of orca.mlp_2018_d2 for values in ('eu');
+create table orca.mlp_2019_d1_other partition of orca.mlp_2019_d1 default;
+create table orca.mlp_2019_d1_usa partition of orca.mlp_2019_d1 for values in ('usa');
+create table orca.mlp_2019_d1_eu partition of orca.mlp_2019_d1 for values in ('eu');
+create table orca.mlp_2019_d2_other partition of orca.mlp_2019_d2 default;
+create table orca.mlp_2019_d2_usa partition of orca.mlp_2019_d2 for values in ('usa');
+create table orca.mlp_2019_d2_eu partition of orca.mlp_2019_d2 for values in ('eu');
+alter table orca.mlp attach partition orca.mlp_2018 for values from (2018) to (2019);
+insert into orca.mlp select i, 2018 + i % 3, 1 + (i / 3) % 4, (array['usa', 'eu', 'cn'])[1 + (i / 12) % 3] from generate_series(1, 360) i;
+insert into orca.mlp values (1000, 2019, 1, null), (1001, 2018, 3, null);
+create table orca.mlp_dim (d int, r text) distributed by (d);
+insert into orca.mlp_dim values (3, 'eu');
+analyze orca.mlp;
+analyze orca.mlp_dim;
+
+-- the leaf partitions a query scans
+create or replace function orca.mlp_scanned_parts(query text) returns setof text as $$
+declare
+  ln text;
+begin
+  for ln in execute 'explain (analyze, costs off, timing off, summary off) ' || query loop
+    if ln ~ ' on mlp_\d{4}\w*' and ln !~ 'never executed' then
+      return next substring(ln from ' on (mlp_\d{4}\w*)');
+    end if;
+  end loop;
+end;
+$$ language plpgsql;
+
+-- static pruning on the second and third level
+explain (costs off) select * from orca.mlp where d = 3 and r = 'usa';
+select count(*) from orca.mlp where d = 3 and r = 'usa';
+select * from orca.mlp_scanned_parts($$ select * from orca.mlp where d = 3 $$) p order by p;
+select count(*) from orca.mlp where d = 3;
+select * from orca.mlp_scanned_parts($$ select * from orca.mlp where r = 'usa' $$) p order by p;
+select count(*) from orca.mlp where r = 'usa';
+select * from orca.mlp_scanned_parts($$ select * from orca.mlp where y = 2019 and d in (1, 2) and r is null $$) p order by p;
+select * from orca.mlp where y = 2019 and d in (1, 2) and r is null;
+select * from orca.mlp_scanned_parts($$ select * from orca.mlp where (d = 1 or d = 4) and (r = 'eu' or r is null) $$) p order by p;
+select count(*) from orca.mlp where (d = 1 or d = 4) and (r = 'eu' or r is null);
+
+-- dynamic pruning on the second and third level, driven by a join
+explain (costs off) select * from orca.mlp join orca.mlp_dim using (d, r);
+select count(*) from orca.mlp join orca.mlp_dim using (d, r);
+select * from orca.mlp_scanned_parts($$ select * from orca.mlp join orca.mlp_dim using (d, r) $$) p order by p;
+select * from orca.mlp_scanned_parts($$ select * from orca.mlp m join orca.mlp_dim x on m.d = x.d and m.r in ('usa', 'eu') $$) p order by p;
+select count(*) from orca.mlp m join orca.mlp_dim x on m.d = x.d and m.r in ('usa', 'eu');
+-- join conditions that cannot prune the sub-partitions
+select count(*) from orca.mlp m join orca.mlp_dim x on m.d = x.d and (m.r = x.r or m.r is null);
+select count(*) from orca.mlp m join orca.mlp_dim x on m.d = x.d or m.r = x.r;
+
+-- sub-partitions of a level with different keys are not supported
+create table orca.mlp_mixed (a int, b int, c int) distributed by (a) partition by range (a);
+create table orca.mlp_mixed_1 partition of orca.mlp_mixed for values from (0) to (10) partition by list (b);
+create table orca.mlp_mixed_2 partition of orca.mlp_mixed for values from (10) to (20) partition by list (c);
+create table orca.mlp_mixed_1_1 partition of orca.mlp_mixed_1 default;
+create table orca.mlp_mixed_2_1 partition of orca.mlp_mixed_2 default;
+insert into orca.mlp_mixed select i, i, i from generate_series(0, 19) i;
+select count(*) from orca.mlp_mixed where b = 1;
+
 -- More BitmapTableScan & BitmapIndexScan tests
 
 set optimizer_enable_bitmapscan=on;
@@ -3435,6 +3512,59 @@ DROP TABLE IF EXISTS dist_tab_a;
 DROP TABLE IF EXISTS dist_tab_b;
 DROP TABLE IF EXISTS result_tab;
 
+--- Test that orca uses the array keys of a btree index for IN-lists
+CREATE TABLE saop_idx_tab (a int, b int) DISTRIBUTED BY (b);
+CREATE INDEX saop_idx_tab_a ON saop_idx_tab (a);
+INSERT INTO saop_idx_tab SELECT i, i FROM generate_series(1, 1000) i;
+ANALYZE saop_idx_tab;
+SET optimizer_enable_tablescan = off;
+SET optimizer_enable_bitmapscan = off;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+EXPLAIN (COSTS OFF) SELECT * FROM saop_idx_tab WHERE a IN (1, 10, 100);
+SELECT * FROM saop_idx_tab WHERE a IN (1, 10, 100);
+EXPLAIN (COSTS OFF) SELECT * FROM saop_idx_tab WHERE a = ANY ('{2, 20, 200}'::int[]) AND b > 10;
+SELECT * FROM saop_idx_tab WHERE a = ANY ('{2, 20, 200}'::int[]) AND b > 10;
+RESET optimizer_enable_tablescan;
+RESET optimizer_enable_bitmapscan;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+DROP TABLE saop_idx_tab;
+
+--- Test LATERAL subqueries and functions
+CREATE TABLE lateral_outer (a int, b int) DISTRIBUTED BY (a);
+CREATE TABLE lateral_inner (a int, c int) DISTRIBUTED BY (c);
+INSERT INTO lateral_outer VALUES (1, 10), (2, 20), (3, 30);
+INSERT INTO lateral_inner VALUES (1, 100), (1, 101), (2, 200), (4, 400);
+ANALYZE lateral_outer;
+ANALYZE lateral_inner;
+SET optimizer_trace_fallback = on;
+EXPLAIN (COSTS OFF) SELECT o.a, s.c FROM lateral_outer o, LATERAL (SELECT i.c FROM lateral_inner i WHERE i.a = o.a) s;
+SELECT o.a, s.c FROM lateral_outer o, LATERAL (SELECT i.c FROM lateral_inner i WHERE i.a = o.a) s ORDER BY 1, 2;
+EXPLAIN (COSTS OFF) SELECT o.a, s.c FROM lateral_outer o LEFT JOIN LATERAL (SELECT i.c FROM lateral_inner i WHERE i.a = o.a) s ON true;
+SELECT o.a, s.c FROM lateral_outer o LEFT JOIN LATERAL (SELECT i.c FROM lateral_inner i WHERE i.a = o.a) s ON true ORDER BY 1, 2;
+SELECT o.a, s.c FROM lateral_outer o, LATERAL (SELECT i.c + o.b AS c FROM lateral_inner i WHERE i.a = o.a) s ORDER BY 1, 2;
+EXPLAIN (COSTS OFF) SELECT o.a, x FROM lateral_outer o, LATERAL generate_series(1, o.a) x;
+SELECT o.a, x FROM lateral_outer o, LATERAL generate_series(1, o.a) x ORDER BY 1, 2;
+SELECT o.a, x FROM lateral_outer o, LATERAL unnest(ARRAY[o.a, o.b]) x WHERE x > 2 ORDER BY 1, 2;
+-- top-N per group, a correlated LIMIT, falls back to the planner
+SELECT o.a, s.c FROM lateral_outer o, LATERAL (SELECT i.c FROM lateral_inner i WHERE i.a = o.a ORDER BY i.c DESC LIMIT 1) s ORDER BY 1, 2;
+RESET optimizer_trace_fallback;
+DROP TABLE lateral_outer;
+DROP TABLE lateral_inner;
+
+--- Test aggregates with FILTER clauses
+CREATE TABLE agg_filter_tab (a int, b int) DISTRIBUTED BY (a);
+INSERT INTO agg_filter_tab SELECT i, i FROM generate_series(1, 100) i;
+ANALYZE agg_filter_tab;
+SET optimizer_trace_fallback = on;
+SELECT count(*) FILTER (WHERE b > 50), sum(a) FILTER (WHERE b % 2 = 0), max(a) FILTER (WHERE b > 1000), count(*) FROM agg_filter_tab;
+SELECT b % 3, count(*) FILTER (WHERE a > 50), max(a) FILTER (WHERE a < 10) FROM agg_filter_tab GROUP BY 1 ORDER BY 1;
+-- the filter references the other side of the join
+SELECT count(*) FILTER (WHERE t2.b > 90), sum(t1.a) FILTER (WHERE t2.b % 10 = 0) FROM agg_filter_tab t1 JOIN agg_filter_tab t2 ON t1.a = t2.a;
+RESET optimizer_trace_fallback;
+DROP TABLE agg_filter_tab;
+
 -- start_ignore
 DROP SCHEMA orca CASCADE;
 -- end_ignore
@@ -0,0 +1,44 @@
+--
+-- Motion packets of a connection are sent with sendmmsg(), up to a batch of
+-- 32 at a time. Force partial batches, and batches the kernel sends none of,
+-- on the sender of content 0, and check the motions still deliver every row.
+--
+CREATE EXTENSION IF NOT EXISTS gp_inject_fault;
+
+CREATE TABLE sendmmsg_batch (a int, b text) DISTRIBUTED BY (a);
+INSERT INTO sendmmsg_batch SELECT i, repeat('x', 500) FROM generate_series(1, 20000) i;
+ANALYZE sendmmsg_batch;
+
+-- Packets queue up on a sender while the receiver has no room for them, and
+-- are sent in a batch when the receiver acks what it consumed.
+SET gp_interconnect_queue_depth = 8;
+SET gp_interconnect_snd_queue_depth = 64;
+
+-- Every sendmmsg() call gets half of what is left of the batch.
+SELECT gp_inject_fault_infinite('interconnect_sendmmsg_partial', 'skip', dbid)
+FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+
+-- A redistribute motion and a gather motion.
+SELECT count(*), sum(length(t2.b)) FROM sendmmsg_batch t1 JOIN sendmmsg_batch t2 ON t1.a = t2.a - 1;
+SELECT count(*), sum(length(b)) FROM (SELECT b FROM sendmmsg_batch ORDER BY a LIMIT 20000) s;
+
+SELECT gp_wait_until_triggered_fault('interconnect_sendmmsg_partial', 1, dbid)
+FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+SELECT gp_inject_fault('interconnect_sendmmsg_partial', 'reset', dbid)
+FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+
+-- The first five batches are left to the retransmission.
+SELECT gp_inject_fault('interconnect_sendmmsg_none', 'skip', '', '', '', 1, 5, 0, dbid)
+FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+
+SELECT count(*), sum(length(t2.b)) FROM sendmmsg_batch t1 JOIN sendmmsg_batch t2 ON t1.a = t2.a - 1;
+SELECT count(*), sum(length(b)) FROM (SELECT b FROM sendmmsg_batch ORDER BY a LIMIT 20000) s;
+
+SELECT gp_wait_until_triggered_fault('interconnect_sendmmsg_none', 5, dbid)
+FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+SELECT gp_inject_fault('interconnect_sendmmsg_none', 'reset', dbid)
+FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+
+RESET gp_interconnect_queue_depth;
+RESET gp_interconnect_snd_queue_depth;
+DROP TABLE sendmmsg_batch;
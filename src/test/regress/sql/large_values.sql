@@ -0,0 +1,38 @@
+--
+-- Large VALUES lists of constants, which ORCA plans as a const table and
+-- translates into a Values scan without a node per value.
+--
+create function large_values_list(n int) returns text
+language sql immutable as $$
+  select 'values ' || string_agg(format('(%s, %L, %s)', i, 'v' || i,
+                                        case when i % 100 = 0 then 'null' else (i % 7)::text end),
+                                 ', ' order by i)
+  from generate_series(1, n) i
+$$;
+
+create function large_values_query(query text) returns table (r text)
+language plpgsql as $$
+begin
+  return query execute query;
+end;
+$$;
+
+create function large_values_exec(query text) returns void
+language plpgsql as $$
+begin
+  execute query;
+end;
+$$;
+
+create table large_values (a int, b text, c int) distributed by (a);
+
+select large_values_query('select count(*)::text || '' '' || sum(column1)::text || '' '' || count(column3)::text from (' || large_values_list(20000) || ') v');
+select large_values_exec('insert into large_values ' || large_values_list(20000));
+select count(*), count(distinct b), sum(c) from large_values;
+select large_values_query('select count(*)::text from large_values t join (' || large_values_list(20000) || ') v (a, b, c) on t.a = v.a and t.b = v.b');
+select large_values_query('select b from (' || large_values_list(5) || ') v (a, b, c) where c > 2 order by a');
+
+drop table large_values;
+drop function large_values_query(text);
+drop function large_values_exec(text);
+drop function large_values_list(int);
@@ -0,0 +1,53 @@
+-- Test compression of the tuples sent through motions. The results must be
+-- the same as without compression.
+CREATE TABLE motion_compress (a int, b int, t text) DISTRIBUTED BY (a);
+-- Rows that compress well
+INSERT INTO motion_compress SELECT i, i % 7, repeat('interconnect ' || (i % 10), 40)
+    FROM generate_series(1, 2000) i;
+-- Rows that don't
+INSERT INTO motion_compress SELECT i, i % 7, string_agg(md5((i * 100 + j)::text), '')
+    FROM generate_series(2001, 2100) i, generate_series(1, 10) j GROUP BY i;
+-- Rows larger than a tuple chunk
+INSERT INTO motion_compress SELECT i, i % 7, repeat('motion ', 4000)
+    FROM generate_series(2101, 2110) i;
+
+SET gp_interconnect_compression TO pglz;
+SET gp_interconnect_compression_ratio TO 0.9;
+
+-- Redistribute motion
+CREATE TABLE motion_compress_b AS SELECT * FROM motion_compress DISTRIBUTED BY (b);
+SELECT count(*), sum(length(t)) FROM motion_compress_b;
+SELECT count(*) FROM motion_compress_b WHERE a <= 2000 AND t = repeat('interconnect ' || (a % 10), 40);
+SELECT count(*) FROM (SELECT * FROM motion_compress_b EXCEPT ALL SELECT * FROM motion_compress) s;
+SELECT count(*) FROM (SELECT * FROM motion_compress EXCEPT ALL SELECT * FROM motion_compress_b) s;
+
+-- Gather motion
+SELECT sum(length(t)), count(DISTINCT t) FROM (SELECT t FROM motion_compress ORDER BY a LIMIT 3000) s;
+
+-- Motions of a join
+SELECT count(*) FROM motion_compress_b m1, motion_compress m2 WHERE m1.t = m2.t AND m1.a = m2.a;
+
+-- EXPLAIN ANALYZE reports the compressed tuples the receivers got
+CREATE FUNCTION motion_decompressed_tuples(query text) RETURNS bigint
+LANGUAGE plpgsql AS $$
+DECLARE
+  line text;
+  tuples bigint := 0;
+BEGIN
+  FOR line IN EXECUTE 'EXPLAIN (ANALYZE) ' || query LOOP
+    tuples := tuples + coalesce(substring(line FROM 'Decompressed (\d+) tuples received')::bigint, 0);
+  END LOOP;
+  RETURN tuples;
+END;
+$$;
+
+SELECT motion_decompressed_tuples('SELECT t FROM motion_compress ORDER BY a LIMIT 3000') > 0 AS compressed;
+SELECT motion_decompressed_tuples('SELECT count(*) FROM motion_compress_b m1, motion_compress m2 WHERE m1.t = m2.t AND m1.a = m2.a') > 0 AS compressed;
+
+SET gp_interconnect_compression TO none;
+SELECT motion_decompressed_tuples('SELECT t FROM motion_compress ORDER BY a LIMIT 3000') > 0 AS compressed;
+
+DROP FUNCTION motion_decompressed_tuples(text);
+RESET gp_interconnect_compression_ratio;
+RESET gp_interconnect_compression;
+DROP TABLE motion_compress, motion_compress_b;
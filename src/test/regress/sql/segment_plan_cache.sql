@@ -0,0 +1,64 @@
+--
+-- The plans of prepared statements dispatched repeatedly are cached on the
+-- QEs, and from then on only referred to by their key.
+--
+create table spc_t (a int, b int) distributed by (a);
+insert into spc_t select i, i % 10 from generate_series(1, 1000) i;
+
+prepare spc_q(int) as select count(*), sum(a) from spc_t where b = $1;
+execute spc_q(1);
+execute spc_q(2);
+execute spc_q(3);
+execute spc_q(3);
+
+-- A plan with a redistribute motion
+prepare spc_j as select count(*) from spc_t t1 join spc_t t2 on t1.a = t2.b;
+execute spc_j;
+execute spc_j;
+execute spc_j;
+
+-- A QE that lost the plan gets it again, in the same statement
+select gp_inject_fault('qe_plan_cache_lost', 'skip', dbid)
+  from gp_segment_configuration where role = 'p' and content = 0;
+execute spc_q(3);
+execute spc_j;
+select gp_wait_until_triggered_fault('qe_plan_cache_lost', 1, dbid)
+  from gp_segment_configuration where role = 'p' and content = 0;
+select gp_inject_fault('qe_plan_cache_lost', 'reset', dbid)
+  from gp_segment_configuration where role = 'p' and content = 0;
+execute spc_q(3);
+execute spc_j;
+
+-- Stable functions are evaluated on the QD, such plans are not cached
+prepare spc_s as select count(*) from spc_t where a < extract(year from now());
+execute spc_s;
+execute spc_s;
+execute spc_s;
+
+-- The cached plans are invalidated along with the plans on the QD
+alter table spc_t add column c int default 7;
+prepare spc_c as select sum(c) from spc_t;
+execute spc_q(4);
+execute spc_q(4);
+execute spc_c;
+execute spc_c;
+execute spc_c;
+
+-- The QEs start over once they hold as many plans as allowed
+set gp_segment_plan_cache_size = 1;
+execute spc_q(5);
+execute spc_c;
+execute spc_q(6);
+execute spc_c;
+execute spc_q(7);
+
+set gp_segment_plan_cache_size = 0;
+execute spc_q(8);
+execute spc_q(8);
+reset gp_segment_plan_cache_size;
+
+deallocate spc_q;
+deallocate spc_j;
+deallocate spc_s;
+deallocate spc_c;
+drop table spc_t;
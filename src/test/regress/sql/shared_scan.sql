@@ -120,3 +120,130 @@ where
 	(data_hour = date_trunc('day',data_hour) and stat.schema_name || '.' ||stat.table_name not in (select table_nm_23 from tbls_daily_report_23))
 	and (stat.schema_name || '.' ||stat.table_name not in (select table_nm_onl_act from tbls_w_onl_actl_data))
 	or (stat.schema_name || '.' ||stat.table_name in (select table_nm_onl_act from tbls_w_onl_actl_data));
+
+-- A cross-slice share streams its tuples to the consumers through chunks of
+-- shared memory, and overflows to files once the producer's memory is used
+-- up. The sisc_xslice_new_chunk fault counts the chunks, or refuses them
+-- from the given occurrence on; sisc_xslice_temp_files counts overflow files.
+-- The rows span several chunks, which the consumers read once sealed.
+CREATE TABLE sisc_stream (a int, b int, c text) DISTRIBUTED BY (a);
+INSERT INTO sisc_stream SELECT i, i % 1000, repeat('x', 100) FROM generate_series(1, 60000) i;
+ANALYZE sisc_stream;
+
+CREATE FUNCTION sisc_set_faults(new_chunk_from int) RETURNS void AS $$
+  SELECT gp_inject_fault('sisc_xslice_new_chunk', 'reset', dbid),
+         gp_inject_fault('sisc_xslice_temp_files', 'reset', dbid),
+         gp_inject_fault('sisc_xslice_new_chunk', 'skip', '', '', '', new_chunk_from, -1, 0,
+                         dbid, current_setting('gp_session_id')::int),
+         gp_inject_fault('sisc_xslice_temp_files', 'skip', '', '', '', 1000, -1, 0,
+                         dbid, current_setting('gp_session_id')::int)
+    FROM gp_segment_configuration WHERE role = 'p' AND content >= 0
+$$ LANGUAGE sql;
+
+CREATE FUNCTION sisc_fault_hits(fault text) RETURNS SETOF int AS $$
+  SELECT (regexp_match(gp_inject_fault(fault, 'status', dbid),
+                       'num times hit:''(\d+)'''))[1]::int
+    FROM gp_segment_configuration WHERE role = 'p' AND content >= 0
+$$ LANGUAGE sql;
+
+SET gp_cte_sharing = on;
+SET max_parallel_workers_per_gather = 0;
+
+-- all in shared memory
+SET statement_mem = '64MB';
+SELECT sisc_set_faults(1000);
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+SELECT min(h) > 1 FROM sisc_fault_hits('sisc_xslice_new_chunk') h;
+SELECT max(h) = 0 FROM sisc_fault_hits('sisc_xslice_temp_files') h;
+
+-- the first chunk in shared memory, the rest in files
+SELECT sisc_set_faults(2);
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+SELECT min(h) > 1 FROM sisc_fault_hits('sisc_xslice_new_chunk') h;
+SELECT min(h) > 0 FROM sisc_fault_hits('sisc_xslice_temp_files') h;
+
+-- all in files
+SELECT sisc_set_faults(1);
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+SELECT min(h) > 0 FROM sisc_fault_hits('sisc_xslice_temp_files') h;
+
+-- all in files, the first one handed over before the rest of the tuples
+-- are written, so that the consumers move on to a second file
+SELECT gp_inject_fault('sisc_xslice_freeze_file', 'skip', '', '', '', 1000, 1000, 0,
+                       dbid, current_setting('gp_session_id')::int)
+  FROM gp_segment_configuration WHERE role = 'p' AND content >= 0;
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+SELECT gp_wait_until_triggered_fault('sisc_xslice_freeze_file', 1, dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content >= 0;
+SELECT gp_inject_fault('sisc_xslice_freeze_file', 'reset', dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content >= 0;
+
+-- three consumers, in shared memory and in files
+SELECT sisc_set_faults(1000);
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(c3.a)
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b JOIN cte c3 ON c2.a = c3.b;
+SELECT max(h) = 0 FROM sisc_fault_hits('sisc_xslice_temp_files') h;
+SELECT sisc_set_faults(1);
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(c3.a)
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b JOIN cte c3 ON c2.a = c3.b;
+SELECT min(h) > 0 FROM sisc_fault_hits('sisc_xslice_temp_files') h;
+
+-- a consumer that stops reading early, while the share is in files
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*) FROM (SELECT a FROM cte LIMIT 100) c1 JOIN cte c2 ON c1.a = c2.a;
+
+-- errors while the share is written to shared memory, written to files, or
+-- read by a consumer; the next query must not be affected by them
+SELECT gp_inject_fault('sisc_xslice_new_chunk', 'reset', dbid),
+       gp_inject_fault('sisc_xslice_temp_files', 'reset', dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content >= 0;
+SELECT gp_inject_fault('sisc_xslice_new_chunk', 'error', '', '', '', 3, 3, 0,
+                       dbid, current_setting('gp_session_id')::int)
+  FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+SELECT gp_inject_fault('sisc_xslice_new_chunk', 'reset', dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+
+SELECT gp_inject_fault_infinite('sisc_xslice_new_chunk', 'skip', dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content >= 0;
+SELECT gp_inject_fault('sisc_xslice_freeze_file', 'error', '', '', '', 1000, 1000, 0,
+                       dbid, current_setting('gp_session_id')::int)
+  FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+SELECT gp_inject_fault('sisc_xslice_freeze_file', 'reset', dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+
+SELECT gp_inject_fault('execshare_input_next', 'error', '', '', '', 5000, 5000, 0,
+                       dbid, current_setting('gp_session_id')::int)
+  FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+SELECT gp_inject_fault('execshare_input_next', 'reset', dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content = 0;
+
+WITH cte AS (SELECT * FROM sisc_stream)
+SELECT count(*), sum(c1.a), sum(length(c1.c) + length(c2.c))
+  FROM cte c1 JOIN cte c2 ON c1.a = c2.b;
+
+RESET statement_mem;
+RESET max_parallel_workers_per_gather;
+RESET gp_cte_sharing;
+SELECT gp_inject_fault('sisc_xslice_new_chunk', 'reset', dbid)
+  FROM gp_segment_configuration WHERE role = 'p' AND content >= 0;
+DROP FUNCTION sisc_set_faults(int);
+DROP FUNCTION sisc_fault_hits(text);
@@ -0,0 +1,63 @@
+--
+-- With optimizer_enable_trivial_fast_path, ORCA only explores the access
+-- paths and DML of single-table queries without joins, subqueries,
+-- aggregates or CTEs.  The plans must be the same as with the full search.
+--
+create function trivial_fast_path_plan(query text, fast bool) returns text
+language plpgsql as $$
+declare
+  line text;
+  plan text := '';
+begin
+  perform set_config('optimizer_enable_trivial_fast_path', fast::text, true);
+  for line in execute 'explain (costs off) ' || query loop
+    plan := plan || line || E'\n';
+  end loop;
+  return plan;
+end;
+$$;
+
+create function trivial_fast_path_same(query text) returns bool
+language plpgsql as $$
+begin
+  return trivial_fast_path_plan(query, true) = trivial_fast_path_plan(query, false);
+end;
+$$;
+
+create table trivial_fast_path (a int, b int, c text) distributed by (a);
+create index trivial_fast_path_b on trivial_fast_path (b);
+insert into trivial_fast_path select i, i % 1000, 'c' || i from generate_series(1, 10000) i;
+analyze trivial_fast_path;
+
+select trivial_fast_path_same('select * from trivial_fast_path where a = 1');
+select trivial_fast_path_same('select * from trivial_fast_path where b = 1');
+select trivial_fast_path_same('select c from trivial_fast_path where b = 1 order by a limit 1');
+select trivial_fast_path_same('insert into trivial_fast_path values (1, 1, ''x'')');
+select trivial_fast_path_same('insert into trivial_fast_path values (1, 1, ''x''), (2, 2, ''y'')');
+select trivial_fast_path_same('update trivial_fast_path set c = ''x'' where a = 1');
+select trivial_fast_path_same('update trivial_fast_path set a = a + 1 where b = 1');
+select trivial_fast_path_same('delete from trivial_fast_path where a = 1');
+
+-- ORCA reports the fast path at DEBUG1.  Queries with a join, an aggregate,
+-- a subquery or a CTE, and any query with the GUC off, take the full search.
+-- start_matchignore
+-- m/^DEBUG1:  (?!\[OPT\]: Using trivial search strategy)/
+-- end_matchignore
+set client_min_messages = debug1;
+select trivial_fast_path_plan('select * from trivial_fast_path where b = 1', true) <> '' as planned;
+select trivial_fast_path_plan('delete from trivial_fast_path where a = 1', true) <> '' as planned;
+select trivial_fast_path_plan('select * from trivial_fast_path where b = 1', false) <> '' as planned;
+select trivial_fast_path_plan('select * from trivial_fast_path t1 join trivial_fast_path t2 using (a)', true) <> '' as planned;
+select trivial_fast_path_plan('select count(*) from trivial_fast_path', true) <> '' as planned;
+select trivial_fast_path_plan('select * from trivial_fast_path where a in (select b from trivial_fast_path)', true) <> '' as planned;
+select trivial_fast_path_plan('with t as (select * from trivial_fast_path) select * from t', true) <> '' as planned;
+reset client_min_messages;
+
+update trivial_fast_path set a = a + 10000 where b = 1;
+delete from trivial_fast_path where a = 2;
+insert into trivial_fast_path values (2, 1, 'y');
+select a, c from trivial_fast_path where b = 1 order by a limit 3;
+
+drop table trivial_fast_path;
+drop function trivial_fast_path_same(text);
+drop function trivial_fast_path_plan(text, bool);
@@ -13,6 +13,8 @@ create language plpython3u;
 
 -- force multistage to increase likelihood of spilling
 set optimizer_force_multistage_agg = on;
+-- the partial aggregate would emit its groups rather than spill
+set gp_hashagg_streambottom = off;
 
 -- set workfile is created to true if all segment did it.
 create or replace function hashagg_spill.is_workfile_created(explain_query text)
@@ -97,5 +99,48 @@ RESET temp_tablespaces;
 RESET statement_mem;
 RESET gp_workfile_compression;
 
+-- The partial stage of a multi-stage aggregate emits its groups early,
+-- rather than spill them, when its hash table is full or when it reduces
+-- the input poorly. EXPLAIN ANALYZE tells how often and why it did.
+create or replace function hashagg_spill.streamed(explain_query text)
+returns setof text as
+$$
+import re
+rv = plpy.execute(explain_query)
+result = []
+for r in rv:
+    m = re.search(r'Extra Text: \(seg\d+\)\s+(Streamed the groups .*)', r['QUERY PLAN'])
+    if m:
+        result.append(m.group(1))
+return result
+$$
+language plpython3u;
+
+create table streamagg (a int, b int) distributed by (a);
+insert into streamagg select i, i from generate_series(1, 300000) i;
+analyze streamagg;
+
+set optimizer_force_multistage_agg = on;
+set gp_eager_two_phase_agg = on;
+set enable_groupagg = off;
+-- each segment has about 100000 rows with distinct b: the groups are
+-- streamed once, at the first check of the reduction
+select * from hashagg_spill.streamed('explain analyze select b, count(*) from streamagg group by b;');
+select count(*), sum(c) from (select b, count(*) c from streamagg group by b) g;
+-- 100 groups reduce the input well
+select * from hashagg_spill.streamed('explain analyze select b % 100, count(*) from streamagg group by 1;');
+-- the hash table is full long before the first check of the reduction
+set statement_mem = '1800kB';
+select s ~ '\(memory full\)\.$' as memory_full
+  from hashagg_spill.streamed('explain analyze select b, count(*) from streamagg group by b;') s;
+select count(*), sum(c) from (select b, count(*) c from streamagg group by b) g;
+reset statement_mem;
+set gp_hashagg_streambottom = off;
+select * from hashagg_spill.streamed('explain analyze select b, count(*) from streamagg group by b;');
+reset gp_hashagg_streambottom;
+reset enable_groupagg;
+reset gp_eager_two_phase_agg;
+reset optimizer_force_multistage_agg;
+
 
 drop schema hashagg_spill cascade;
@@ -0,0 +1,330 @@
+/*-------------------------------------------------------------------------
+ *
+ * testcsvscan.c
+ *	  Testbed and microbenchmark for vectorized csv scanning.
+ *
+ * This is a standalone test program that compares the record boundaries
+ * found by csv_scan_records() in fstream/csvscan.h, and the characters found
+ * by pg_lfind8_any() in port/pg_lfind.h, to (assumed correct) byte at a time
+ * implementations, over synthetic csv corpora.  It then reports the
+ * throughput of both implementations.
+ *
+ * Build it from a configured tree with something like
+ *
+ *	cc -O2 -I src/include -o testcsvscan src/tools/testcsvscan.c \
+ *		-L src/port -lpgport
+ *
+ * and run it as "testcsvscan [megabytes]".
+ *
+ * Copyright (c) 2023, HashData Technology Limited.
+ *
+ *
+ * IDENTIFICATION
+ *	  src/tools/testcsvscan.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres_fe.h"
+
+#include "fstream/csvscan.h"
+#include "port/pg_lfind.h"
+#include "portability/instr_time.h"
+
+typedef struct corpus
+{
+	const char *name;
+	char		qc;
+	char		xc;
+	char		nc;
+	bool		crlf;
+	int			quote_pct;		/* % of fields that are quoted */
+	int			special_pct;	/* % of quoted chars that are special */
+} corpus;
+
+static const corpus corpora[] = {
+	{"plain", '"', '"', '\n', false, 0, 0},
+	{"quoted", '"', '"', '\n', false, 50, 5},
+	{"escaped", '"', '\\', '\n', false, 50, 5},
+	{"crlf", '"', '"', '\n', true, 50, 5},
+	{"cr", '\'', '\'', '\r', false, 30, 10},
+};
+
+/*
+ * Control version of the scanner, the byte at a time loop fstream used to
+ * have.
+ */
+static char *
+ref_scan_records(const corpus *c, char *p, char *q, bool one, int64 *nrecords)
+{
+	int			in_quote = 0;
+	int			last_was_esc = 0;
+	int			ch,
+				lastch = 0;
+	char	   *last_record_loc = NULL;
+
+	while (p < q)
+	{
+		ch = *p++;
+		if (in_quote)
+		{
+			if (!last_was_esc)
+			{
+				if (ch == c->qc)
+					in_quote = 0;
+				else if (ch == c->xc)
+					last_was_esc = 1;
+			}
+			else
+				last_was_esc = 0;
+		}
+		else if (c->crlf ? (ch == '\n' && lastch == '\r') : ch == c->nc)
+		{
+			last_record_loc = p;
+			(*nrecords)++;
+			if (one)
+				break;
+		}
+		else if (ch == c->qc)
+			in_quote = 1;
+		lastch = ch;
+	}
+
+	return last_record_loc;
+}
+
+/*
+ * Control version of pg_lfind8_any().
+ */
+static int
+ref_lfind8_any(const char *set, int nset, const char *base, int nelem)
+{
+	int			i;
+
+	for (i = 0; i < nelem; i++)
+	{
+		if (memchr(set, base[i], nset) != NULL)
+			return i;
+	}
+	return nelem;
+}
+
+/*
+ * Fill buf with csv records of a few fields each, quoting some of them with
+ * embedded newlines, quotes and escapes.
+ */
+static void
+make_corpus(const corpus *c, char *buf, size_t len)
+{
+	static const char plain[] = "abcdefghijklmnopqrstuvwxyz0123456789 ,.-";
+	size_t		i = 0;
+
+	while (i < len)
+	{
+		int			nfields = 1 + random() % 8;
+		int			f;
+
+		for (f = 0; f < nfields && i < len; f++)
+		{
+			int			flen = random() % 40;
+			bool		quoted = (random() % 100) < c->quote_pct;
+
+			if (f > 0)
+				buf[i++] = ',';
+			if (quoted && i < len)
+				buf[i++] = c->qc;
+			while (flen-- > 0 && i < len)
+			{
+				if (quoted && (random() % 100) < c->special_pct)
+				{
+					switch (random() % 3)
+					{
+						case 0:
+							buf[i++] = c->xc;
+							if (i < len)
+								buf[i++] = c->qc;
+							break;
+						case 1:
+							buf[i++] = '\r';
+							break;
+						default:
+							buf[i++] = '\n';
+							break;
+					}
+				}
+				else if (!quoted)
+					buf[i++] = plain[random() % (sizeof(plain) - 2)];
+				else
+					buf[i++] = plain[random() % (sizeof(plain) - 1)];
+			}
+			if (quoted && i < len)
+				buf[i++] = c->qc;
+		}
+		if (c->crlf && i < len)
+			buf[i++] = '\r';
+		if (i < len)
+			buf[i++] = c->crlf ? '\n' : c->nc;
+	}
+}
+
+static char *
+scan_records(const corpus *c, char *p, char *q, bool one, int64 *nrecords)
+{
+	csv_scan_state st;
+
+	csv_scan_init(&st, c->qc, c->xc, c->nc, c->crlf);
+	return csv_scan_records(&st, p, q, one, nrecords);
+}
+
+/*
+ * Check that both scanners agree on the records of every prefix of some
+ * random windows of the corpus, and when stepping through it one record at
+ * a time.  Return the number of mismatches.
+ */
+static int
+check_corpus(const corpus *c, char *buf, size_t len)
+{
+	int			nerrors = 0;
+	int			i;
+	char	   *p;
+
+	for (i = 0; i < 10000; i++)
+	{
+		size_t		start = random() % len;
+		size_t		wlen = random() % Min(len - start, 1000);
+		int64		n1 = 0,
+					n2 = 0;
+		char	   *r1,
+				   *r2;
+
+		r1 = ref_scan_records(c, buf + start, buf + start + wlen, false, &n1);
+		r2 = scan_records(c, buf + start, buf + start + wlen, false, &n2);
+		if (r1 != r2 || n1 != n2)
+		{
+			printf("%s: window %zu+%zu: expected %ld records ending at %ld, got %ld ending at %ld\n",
+				   c->name, start, wlen, (long) n1,
+				   r1 ? (long) (r1 - buf) : -1L, (long) n2,
+				   r2 ? (long) (r2 - buf) : -1L);
+			nerrors++;
+		}
+	}
+
+	p = buf;
+	for (;;)
+	{
+		int64		n1 = 0,
+					n2 = 0;
+		char	   *r1,
+				   *r2;
+
+		r1 = ref_scan_records(c, p, buf + len, true, &n1);
+		r2 = scan_records(c, p, buf + len, true, &n2);
+		if (r1 != r2 || n1 != n2)
+		{
+			printf("%s: record at %ld: expected end at %ld, got %ld\n",
+				   c->name, (long) (p - buf),
+				   r1 ? (long) (r1 - buf) : -1L,
+				   r2 ? (long) (r2 - buf) : -1L);
+			nerrors++;
+			break;
+		}
+		if (r1 == NULL)
+			break;
+		p = r1;
+	}
+
+	for (i = 0; i < 10000; i++)
+	{
+		static const char set[] = ",\"\\\r\n";
+		size_t		start = random() % len;
+		int			wlen = random() % Min(len - start, 200);
+		int			nset = 1 + random() % (sizeof(set) - 1);
+		int			r1,
+					r2;
+
+		r1 = ref_lfind8_any(set, nset, buf + start, wlen);
+		r2 = pg_lfind8_any(set, nset, buf + start, wlen);
+		if (r1 != r2)
+		{
+			printf("%s: pg_lfind8_any at %zu+%d: expected %d, got %d\n",
+				   c->name, start, wlen, r1, r2);
+			nerrors++;
+		}
+	}
+
+	return nerrors;
+}
+
+static void
+bench_corpus(const corpus *c, char *buf, size_t len)
+{
+	instr_time	start,
+				duration;
+	int64		n1 = 0,
+				n2 = 0;
+	double		ref_ms,
+				vec_ms;
+
+	INSTR_TIME_SET_CURRENT(start);
+	(void) ref_scan_records(c, buf, buf + len, false, &n1);
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+	ref_ms = INSTR_TIME_GET_MILLISEC(duration);
+
+	INSTR_TIME_SET_CURRENT(start);
+	(void) scan_records(c, buf, buf + len, false, &n2);
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+	vec_ms = INSTR_TIME_GET_MILLISEC(duration);
+
+	printf("%-8s %10ld records  bytewise %8.1f MB/s  vectorized %8.1f MB/s\n",
+		   c->name, (long) n2,
+		   len / 1048576.0 / (ref_ms / 1000.0),
+		   len / 1048576.0 / (vec_ms / 1000.0));
+}
+
+int
+main(int argc, char **argv)
+{
+	size_t		len = 64 * 1024 * 1024;
+	char	   *buf;
+	int			nerrors = 0;
+	size_t		i;
+
+	if (argc >= 2)
+		len = (size_t) atoi(argv[1]) * 1024 * 1024;
+	if (len == 0)
+	{
+		fprintf(stderr, "usage: %s [megabytes]\n", argv[0]);
+		return 1;
+	}
+
+#ifdef USE_NO_SIMD
+	printf("no vector instructions available, testing the scalar fallback\n");
+#endif
+
+	buf = malloc(len);
+	if (buf == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	for (i = 0; i < lengthof(corpora); i++)
+	{
+		srandom(i + 1);
+		make_corpus(&corpora[i], buf, len);
+		nerrors += check_corpus(&corpora[i], buf, len);
+		bench_corpus(&corpora[i], buf, len);
+	}
+
+	free(buf);
+
+	if (nerrors > 0)
+	{
+		printf("%d mismatches\n", nerrors);
+		return 1;
+	}
+	printf("all tests passed\n");
+	return 0;
+}